@@ -142,6 +142,45 @@ export interface AudioTurnResult {
   };
 }
 
+// ── Device Telemetry ──────────────────────────────────────────────────
+
+/**
+ * Log-bucketed latency histogram as reported by a device heartbeat.
+ * Each bucket is [upper_ms, count]: `count` samples were <= upper_ms and
+ * above the previous bucket's bound.
+ */
+export interface LatencyHistogram {
+  count: number;
+  sum_ms: number;
+  max_ms: number;
+  buckets: Array<[number, number]>;
+}
+
+/** Body of POST /v1/agents/:id/heartbeat. */
+export interface DeviceHeartbeatReport {
+  uptime_s?: number;
+  /** Live config version the device runs (services/runtime/deviceConfig.ts) */
+  config_version?: number;
+  latency?: Record<string, LatencyHistogram>;
+  memory?: Record<string, number>;
+}
+
+export interface LatencySummary {
+  count: number;
+  mean_ms: number;
+  p50_ms: number;
+  p90_ms: number;
+  p99_ms: number;
+  max_ms: number;
+}
+
+export interface DeviceTelemetrySummary {
+  reports: number;
+  last_report_at: string | null;
+  latency: Record<string, LatencySummary>;
+  memory: Record<string, number>;
+}
+
 // ── Provisioning ──────────────────────────────────────────────────────
 
 export interface ProvisionResult {
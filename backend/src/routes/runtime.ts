@@ -8,6 +8,10 @@
  *   POST   /v1/agents/:id/turn/text — Text conversation turn
  *   GET    /v1/agents/:id/history  — Conversation history
  *   GET    /v1/agents/:id/heartbeat — Agent health check
+ *   POST   /v1/agents/:id/heartbeat — Device heartbeat with latency/memory telemetry
+ *   GET    /v1/agents/:id/config    — Live device config and its version
+ *   PATCH  /v1/agents/:id/config    — Change live device config (sent with the next heartbeat)
+ *   GET    /v1/agents/:id/telemetry — Aggregated device telemetry
  *
  * Auth: All endpoints except POST /v1/agents require x-api-key header.
  */
@@ -20,6 +24,8 @@ import type { AudioPipeline } from '../services/runtime/audioPipeline.js';
 import type { KnowledgeBackpack } from '../services/runtime/knowledgeBackpack.js';
 import type { StudyMode } from '../services/runtime/studyMode.js';
 import type { GapDetector } from '../services/runtime/gapDetector.js';
+import { validateHeartbeatReport, type DeviceTelemetryStore } from '../services/runtime/deviceTelemetry.js';
+import { validateConfigUpdate, type DeviceConfigStore } from '../services/runtime/deviceConfig.js';
 import type { AudioInputFormat, AudioOutputFormat } from '../models/runtime.js';
 
 // ── Types ─────────────────────────────────────────────────────────────
@@ -32,6 +38,8 @@ export interface RuntimeRouterDeps {
   knowledgeBackpack?: KnowledgeBackpack;
   studyMode?: StudyMode;
   gapDetector?: GapDetector;
+  deviceTelemetry?: DeviceTelemetryStore;
+  deviceConfig?: DeviceConfigStore;
 }
 
 // ── Auth Middleware ────────────────────────────────────────────────────
@@ -67,7 +75,7 @@ function requireApiKey(agentStore: AgentStore) {
 // ── Router ────────────────────────────────────────────────────────────
 
 export function createRuntimeRouter(deps: RuntimeRouterDeps): Router {
-  const { agentStore, conversationManager, turnPipeline, audioPipeline, knowledgeBackpack, studyMode, gapDetector } = deps;
+  const { agentStore, conversationManager, turnPipeline, audioPipeline, knowledgeBackpack, studyMode, gapDetector, deviceTelemetry, deviceConfig } = deps;
   const router = Router();
 
   const authMiddleware = requireApiKey(agentStore);
@@ -133,6 +141,10 @@ export function createRuntimeRouter(deps: RuntimeRouterDeps): Router {
     // Clean up gap detection
     gapDetector?.deleteAgent(agentId);
 
+    // Clean up device telemetry and live config
+    deviceTelemetry?.deleteAgent(agentId);
+    deviceConfig?.deleteAgent(agentId);
+
     // Remove agent
     const deleted = agentStore.delete(agentId);
     if (!deleted) {
@@ -275,26 +287,116 @@ export function createRuntimeRouter(deps: RuntimeRouterDeps): Router {
   });
 
   // ── GET /v1/agents/:id/heartbeat — Agent health check ─────────────
-  router.get('/agents/:id/heartbeat', (req: Request, res: Response) => {
-    const agentId = req.params.id as string;
+  function heartbeatStatus(agentId: string): Record<string, unknown> | null {
     const agent = agentStore.get(agentId);
-
-    if (!agent) {
-      res.status(404).json({ status: 'not_found' });
-      return;
-    }
+    if (!agent) return null;
 
     const usage = turnPipeline.getUsageTracker().getTotals(agentId);
     const sessions = conversationManager.getSessions(agentId);
 
-    res.json({
+    return {
       status: 'online',
       agent_id: agentId,
       agent_name: agent.agent_name,
       session_count: sessions.length,
       total_input_tokens: usage.input_tokens,
       total_output_tokens: usage.output_tokens,
-    });
+    };
+  }
+
+  router.get('/agents/:id/heartbeat', (req: Request, res: Response) => {
+    const status = heartbeatStatus(req.params.id as string);
+    if (!status) {
+      res.status(404).json({ status: 'not_found' });
+      return;
+    }
+    res.json(status);
+  });
+
+  // ── POST /v1/agents/:id/heartbeat — Device telemetry report ─────────
+  // Periodic report from the device: latency histograms for the interval
+  // since its last accepted report, plus memory telemetry. Authenticated,
+  // since it feeds fleet statistics. When the device reports an older
+  // config_version than the agent's live config, the response carries the
+  // keys changed since as `config: { version, changes }`.
+  router.post('/agents/:id/heartbeat', authMiddleware, (req: Request, res: Response) => {
+    if (!deviceTelemetry) {
+      res.status(501).json({ detail: 'Device telemetry not available' });
+      return;
+    }
+
+    const agentId = req.params.id as string;
+    const status = heartbeatStatus(agentId);
+    if (!status) {
+      res.status(404).json({ status: 'not_found' });
+      return;
+    }
+
+    const error = validateHeartbeatReport(req.body);
+    if (error) {
+      res.status(400).json({ detail: error });
+      return;
+    }
+
+    deviceTelemetry.record(agentId, req.body);
+
+    const deviceVersion = req.body.config_version;
+    const delta = typeof deviceVersion === 'number' ? deviceConfig?.deltaSince(agentId, deviceVersion) : null;
+    res.json(delta ? { ...status, config: delta } : status);
+  });
+
+  // ── GET /v1/agents/:id/config — Live device config ──────────────────
+  router.get('/agents/:id/config', authMiddleware, (req: Request, res: Response) => {
+    if (!deviceConfig) {
+      res.status(501).json({ detail: 'Live device config not available' });
+      return;
+    }
+
+    const agentId = req.params.id as string;
+    if (!agentStore.has(agentId)) {
+      res.status(404).json({ detail: `Agent not found: ${agentId}` });
+      return;
+    }
+
+    const { version, changes } = deviceConfig.get(agentId);
+    res.json({ agent_id: agentId, version, config: changes });
+  });
+
+  // ── PATCH /v1/agents/:id/config — Change live device config ─────────
+  // Only keys the firmware applies live (face_descriptor, wake_cutoff).
+  // The device picks the change up with its next heartbeat, without a
+  // reflash or reboot.
+  router.patch('/agents/:id/config', authMiddleware, (req: Request, res: Response) => {
+    if (!deviceConfig) {
+      res.status(501).json({ detail: 'Live device config not available' });
+      return;
+    }
+
+    const agentId = req.params.id as string;
+    if (!agentStore.has(agentId)) {
+      res.status(404).json({ detail: `Agent not found: ${agentId}` });
+      return;
+    }
+
+    const error = validateConfigUpdate(req.body);
+    if (error) {
+      res.status(400).json({ detail: error });
+      return;
+    }
+
+    const version = deviceConfig.update(agentId, req.body);
+    res.json({ agent_id: agentId, version });
+  });
+
+  // ── GET /v1/agents/:id/telemetry — Aggregated device telemetry ──────
+  router.get('/agents/:id/telemetry', authMiddleware, (req: Request, res: Response) => {
+    if (!deviceTelemetry) {
+      res.status(501).json({ detail: 'Device telemetry not available' });
+      return;
+    }
+
+    const agentId = req.params.id as string;
+    res.json({ agent_id: agentId, ...deviceTelemetry.getSummary(agentId) });
   });
 
   // ── GET /v1/agents/:id/gaps — Knowledge gap list ─────────────────────
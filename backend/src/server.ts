@@ -28,6 +28,8 @@ import { AudioPipeline } from './services/runtime/audioPipeline.js';
 import { KnowledgeBackpack } from './services/runtime/knowledgeBackpack.js';
 import { StudyMode } from './services/runtime/studyMode.js';
 import { GapDetector } from './services/runtime/gapDetector.js';
+import { DeviceTelemetryStore } from './services/runtime/deviceTelemetry.js';
+import { DeviceConfigStore } from './services/runtime/deviceConfig.js';
 import { LocalRuntimeProvisioner } from './services/runtimeProvisioner.js';
 import { createRuntimeRouter } from './routes/runtime.js';
 import { SpecGraphService } from './services/specGraph.js';
@@ -124,6 +126,8 @@ const conversationManager = new ConversationManager(undefined, consentManager);
 const knowledgeBackpack = new KnowledgeBackpack();
 const studyMode = new StudyMode(knowledgeBackpack);
 const gapDetector = new GapDetector();
+const deviceTelemetry = new DeviceTelemetryStore();
+const deviceConfig = new DeviceConfigStore();
 const runtimeProvisioner = new LocalRuntimeProvisioner(agentStore);
 const turnPipeline = new TurnPipeline({
   agentStore,
@@ -403,7 +407,7 @@ function createApp(staticDir?: string, authToken?: string) {
   app.use('/api/spec-graph', createSpecGraphRouter({ specGraphService, compositionService, sendEvent }));
 
   // Agent Runtime (PRD-001) — mounted at /v1/* with its own api-key auth
-  app.use('/v1', createRuntimeRouter({ agentStore, conversationManager, turnPipeline, audioPipeline, knowledgeBackpack, studyMode, gapDetector }));
+  app.use('/v1', createRuntimeRouter({ agentStore, conversationManager, turnPipeline, audioPipeline, knowledgeBackpack, studyMode, gapDetector, deviceTelemetry, deviceConfig }));
 
   // Templates
   app.get('/api/templates', (_req, res) => {
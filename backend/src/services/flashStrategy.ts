@@ -18,6 +18,8 @@ import type { DeviceRegistry } from './deviceRegistry.js';
 import { sanitizeReplacements, escapePythonString } from '../utils/sanitizePythonValue.js';
 import type { FaceDescriptor } from '../models/display.js';
 import { DEFAULT_FACE } from '../models/display.js';
+import { buildConfigPartitionImage } from '../utils/runtimeConfigBinary.js';
+import { buildAssetImage, collectAssetFiles } from '../utils/runtimeAssetImage.js';
 
 const execFileAsync = promisify(execFile);
 
@@ -310,6 +312,12 @@ export function buildRuntimeConfig(
   };
 }
 
+function removeTempDirs(dirs: string[]): void {
+  for (const dir of dirs) {
+    try { fs.rmSync(dir, { recursive: true, force: true }); } catch { /* ignore */ }
+  }
+}
+
 /**
  * Flash strategy for binary firmware flash using esptool.
  * Flashes pre-built firmware images (.bin) to ESP32 devices.
@@ -390,7 +398,7 @@ export class EsptoolFlashStrategy implements FlashStrategy {
     flashPairs.push(offset, firmwarePath);
 
     // Generate SPIFFS image with runtime_config.json if spiffs config is present
-    let spiffsTempDir: string | null = null;
+    const tempDirs: string[] = [];
     const spiffsConfig = flashConfig.spiffs;
     if (spiffsConfig && config) {
       onProgress('Building config partition...', 15);
@@ -398,7 +406,7 @@ export class EsptoolFlashStrategy implements FlashStrategy {
         const spiffsResult = await this.generateSpiffsImage(pluginDir, config, spiffsConfig);
         if (spiffsResult) {
           flashPairs.push(spiffsConfig.offset, spiffsResult.imagePath);
-          spiffsTempDir = spiffsResult.tempDir;
+          tempDirs.push(spiffsResult.tempDir);
         }
       } catch (err) {
         console.warn('[esptool] SPIFFS generation failed, using pre-built storage.bin:', err);
@@ -410,6 +418,41 @@ export class EsptoolFlashStrategy implements FlashStrategy {
       }
     }
 
+    // Compiled config image: the firmware maps it from flash at boot and
+    // only mounts SPIFFS and parses runtime_config.json when it is missing
+    const configPartition = flashConfig.config_partition;
+    if (configPartition && config) {
+      const tempDir = fs.mkdtempSync(path.join(os.tmpdir(), 'elisa-config-'));
+      tempDirs.push(tempDir);
+      const imagePath = path.join(tempDir, 'elisa_cfg.bin');
+      fs.writeFileSync(imagePath, buildConfigPartitionImage(config));
+      flashPairs.push(configPartition.offset, imagePath);
+    }
+
+    // Asset image: runtime_config.json (the JSON fallback, parsed in place
+    // when there is no config image) and the plugin's firmware/assets
+    // files: cached TTS prompts, earcons, a wake word model
+    const assetsPartition = flashConfig.assets_partition;
+    if (assetsPartition && config) {
+      try {
+        const files = collectAssetFiles(path.join(pluginDir, 'firmware', 'assets'))
+          .filter((file) => file.name !== 'runtime_config.json');
+        files.unshift({ name: 'runtime_config.json', data: Buffer.from(JSON.stringify(config), 'utf-8') });
+        const image = buildAssetImage(files);
+        if (image.length > Number(assetsPartition.size)) {
+          console.warn(`[esptool] asset image (${image.length} bytes) exceeds its partition, not flashed`);
+        } else {
+          const tempDir = fs.mkdtempSync(path.join(os.tmpdir(), 'elisa-assets-'));
+          tempDirs.push(tempDir);
+          const imagePath = path.join(tempDir, 'elisa_assets.bin');
+          fs.writeFileSync(imagePath, image);
+          flashPairs.push(assetsPartition.offset, imagePath);
+        }
+      } catch (err) {
+        console.warn('[esptool] asset image generation failed, not flashed:', err);
+      }
+    }
+
     onProgress('Flashing firmware...', 20);
 
     // Build esptool args
@@ -487,19 +530,15 @@ export class EsptoolFlashStrategy implements FlashStrategy {
         child.stderr?.on('data', onData);
       });
 
-      // Clean up SPIFFS temp directory
-      if (spiffsTempDir) {
-        try { fs.rmSync(spiffsTempDir, { recursive: true, force: true }); } catch { /* ignore */ }
-      }
+      // Clean up SPIFFS, config and asset image temp directories
+      removeTempDirs(tempDirs);
 
       if (result.success) {
         onProgress('Flash complete!', 100);
       }
       return result;
     } catch (err: unknown) {
-      if (spiffsTempDir) {
-        try { fs.rmSync(spiffsTempDir, { recursive: true, force: true }); } catch { /* ignore */ }
-      }
+      removeTempDirs(tempDirs);
       const message = err instanceof Error ? err.message : String(err);
       return {
         success: false,
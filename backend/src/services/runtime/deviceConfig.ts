@@ -0,0 +1,251 @@
+/**
+ * Live device config for the Elisa Agent Runtime.
+ *
+ * A deployed BOX-3 runs the config compiled into its flash image at
+ * deploy time. Changes made afterwards (PATCH /v1/agents/:id/config) are
+ * versioned here: every update that changes something bumps the agent's
+ * config version and records the version at which each key last changed.
+ * The device reports the version it runs in each heartbeat, and the
+ * response carries only the keys changed since then. The firmware merges
+ * them into its double-buffered config image and notifies the modules
+ * that use them, without a reflash or reboot (elisa_config_apply_update).
+ *
+ * A fresh deploy runs version 0, so it is sent every change made so far.
+ *
+ * In-memory storage, consistent with existing patterns. A restarted
+ * runtime counts again from scratch, so versions carry a random epoch in
+ * their top 16 bits and count updates below it: a device reporting
+ * another epoch's version, however high, is sent every change.
+ */
+
+import { CONFIG_ENUMS } from '../../utils/runtimeConfigBinary.js';
+
+// ── Keys ─────────────────────────────────────────────────────────────
+
+/** Config keys the firmware can apply live (runtime_config.schema.json). */
+export const LIVE_CONFIG_KEYS = [
+  'face_descriptor',
+  'wake_cutoff',
+] as const;
+
+export type LiveConfigKey = (typeof LIVE_CONFIG_KEYS)[number];
+export type LiveConfigValues = Partial<Record<LiveConfigKey, unknown>>;
+
+/** Keys changed since the version a device reported. */
+export interface DeviceConfigDelta {
+  version: number;
+  changes: LiveConfigValues;
+}
+
+const HEX_COLOR = /^#[0-9a-fA-F]{6}$/;
+
+/** Versions per epoch; the firmware keeps a version in 32 bits. */
+const EPOCH_SIZE = 0x10000;
+
+// ── Helpers ──────────────────────────────────────────────────────────
+
+/** Config values are plain JSON; copies keep callers from aliasing stored state. */
+function cloneJson<T>(value: T): T {
+  return value === undefined ? value : JSON.parse(JSON.stringify(value));
+}
+
+function isObject(value: unknown): value is Record<string, unknown> {
+  return !!value && typeof value === 'object' && !Array.isArray(value);
+}
+
+/**
+ * Merge an update over a stored object value, recursing into objects,
+ * the way the firmware applies a partial face_descriptor to the face it
+ * shows. Two partial updates between heartbeats then both arrive.
+ */
+function mergeJson(base: unknown, update: unknown): unknown {
+  if (!isObject(base) || !isObject(update)) return cloneJson(update);
+  const merged: Record<string, unknown> = cloneJson(base);
+  for (const [key, value] of Object.entries(update)) {
+    merged[key] = mergeJson(merged[key], value);
+  }
+  return merged;
+}
+
+function checkChoice(value: unknown, names: readonly string[], key: string): string | null {
+  if (value === undefined) return null;
+  return typeof value === 'string' && names.includes(value)
+    ? null
+    : `${key} must be one of: ${names.join(', ')}`;
+}
+
+function checkColor(value: unknown, key: string): string | null {
+  if (value === undefined) return null;
+  return typeof value === 'string' && HEX_COLOR.test(value) ? null : `${key} must be a #rrggbb color`;
+}
+
+/** A face_descriptor may be partial: missing fields keep the device's current ones. */
+function validateFaceDescriptor(face: unknown): string | null {
+  if (!isObject(face)) return 'face_descriptor must be an object';
+  for (const part of ['eyes', 'mouth', 'colors']) {
+    if (face[part] !== undefined && !isObject(face[part])) {
+      return `face_descriptor.${part} must be an object`;
+    }
+  }
+  const eyes = face.eyes as Record<string, unknown> | undefined;
+  const mouth = face.mouth as Record<string, unknown> | undefined;
+  const colors = face.colors as Record<string, unknown> | undefined;
+
+  return checkChoice(face.base_shape, CONFIG_ENUMS.base_shape, 'face_descriptor.base_shape')
+    ?? checkChoice(eyes?.style, CONFIG_ENUMS.eye_style, 'face_descriptor.eyes.style')
+    ?? checkChoice(eyes?.size, CONFIG_ENUMS.eye_size, 'face_descriptor.eyes.size')
+    ?? checkColor(eyes?.color, 'face_descriptor.eyes.color')
+    ?? checkChoice(mouth?.style, CONFIG_ENUMS.mouth_style, 'face_descriptor.mouth.style')
+    ?? checkChoice(face.expression, CONFIG_ENUMS.expression, 'face_descriptor.expression')
+    ?? checkColor(colors?.face, 'face_descriptor.colors.face')
+    ?? checkColor(colors?.accent, 'face_descriptor.colors.accent');
+}
+
+// ── Validation ───────────────────────────────────────────────────────
+
+/**
+ * Validate a config update body. Returns an error message, or null if
+ * every key is live-updatable and well-formed. wake_cutoff may be null,
+ * which puts WakeNet's own threshold back.
+ */
+export function validateConfigUpdate(body: unknown): string | null {
+  if (!isObject(body)) {
+    return 'Request body must be a config object';
+  }
+  const keys = Object.keys(body);
+  if (keys.length === 0) {
+    return 'Config update is empty';
+  }
+
+  for (const key of keys) {
+    if (!(LIVE_CONFIG_KEYS as readonly string[]).includes(key)) {
+      return `${key} cannot be changed live (allowed: ${LIVE_CONFIG_KEYS.join(', ')})`;
+    }
+    const value = body[key];
+    let error: string | null = null;
+
+    switch (key as LiveConfigKey) {
+      case 'face_descriptor':
+        error = validateFaceDescriptor(value);
+        break;
+      case 'wake_cutoff':
+        if (value !== null && (typeof value !== 'number' || !(value >= 0 && value <= 1))) {
+          error = `${key} must be a probability between 0 and 1, or null`;
+        }
+        break;
+    }
+    if (error) return error;
+  }
+
+  return null;
+}
+
+// ── DeviceConfigStore ────────────────────────────────────────────────
+
+interface AgentConfigState {
+  /** Issued at random (1-0xffff) when the agent's first update arrives */
+  epoch: number;
+  version: number;
+  values: LiveConfigValues;
+  /** Version at which each key last changed */
+  changedAt: Map<LiveConfigKey, number>;
+}
+
+/** Epoch of a version: 0 for a fresh deploy. */
+function epochOf(version: number): number {
+  return Math.floor(version / EPOCH_SIZE);
+}
+
+export class DeviceConfigStore {
+  private agents = new Map<string, AgentConfigState>();
+
+  /** @param newEpoch Picks an agent's epoch; tests pass a fixed sequence */
+  constructor(private newEpoch: () => number = () => 1 + Math.floor(Math.random() * (EPOCH_SIZE - 1))) {}
+
+  /**
+   * Merge a config update into the agent's live config. Keys whose value
+   * does not change are dropped; the version only moves if something did.
+   * The update must have passed validateConfigUpdate().
+   *
+   * @returns The agent's config version after the update
+   */
+  update(agentId: string, changes: LiveConfigValues): number {
+    let state = this.agents.get(agentId);
+    if (!state) {
+      const epoch = this.newEpoch();
+      state = { epoch, version: epoch * EPOCH_SIZE, values: {}, changedAt: new Map() };
+      this.agents.set(agentId, state);
+    }
+
+    const merged = new Map<LiveConfigKey, unknown>();
+    for (const key of Object.keys(changes) as LiveConfigKey[]) {
+      const value = mergeJson(state.values[key], changes[key]);
+      if (JSON.stringify(value) !== JSON.stringify(state.values[key])) {
+        merged.set(key, value);
+      }
+    }
+    if (merged.size === 0) {
+      return state.version;
+    }
+
+    if (state.version + 1 === (state.epoch + 1) * EPOCH_SIZE) {
+      // Epoch used up: start another, in which every key is new
+      const used = state.epoch;
+      do {
+        state.epoch = this.newEpoch();
+      } while (state.epoch === used);
+      state.version = state.epoch * EPOCH_SIZE;
+      for (const key of state.changedAt.keys()) {
+        state.changedAt.set(key, state.version + 1);
+      }
+    }
+    state.version += 1;
+    for (const [key, value] of merged) {
+      state.values[key] = value;
+      state.changedAt.set(key, state.version);
+    }
+    return state.version;
+  }
+
+  /**
+   * The agent's live config: its version and every key changed since deploy.
+   */
+  get(agentId: string): DeviceConfigDelta {
+    const state = this.agents.get(agentId);
+    if (!state) {
+      return { version: 0, changes: {} };
+    }
+    return { version: state.version, changes: cloneJson(state.values) };
+  }
+
+  /**
+   * Keys changed since the version a device reported, or null if it is
+   * up to date. A version from another epoch (a fresh deploy, or one
+   * issued before the runtime restarted) gets every change.
+   */
+  deltaSince(agentId: string, deviceVersion: number): DeviceConfigDelta | null {
+    const state = this.agents.get(agentId);
+    if (!state) {
+      return null;
+    }
+    const current = epochOf(deviceVersion) === state.epoch;
+    if (current && deviceVersion >= state.version) {
+      return null;
+    }
+
+    const changes: LiveConfigValues = {};
+    for (const [key, version] of state.changedAt) {
+      if (!current || version > deviceVersion) {
+        changes[key] = cloneJson(state.values[key]);
+      }
+    }
+    return { version: state.version, changes };
+  }
+
+  /**
+   * Clean up live config when an agent is deleted.
+   */
+  deleteAgent(agentId: string): boolean {
+    return this.agents.delete(agentId);
+  }
+}
@@ -0,0 +1,194 @@
+/**
+ * Device telemetry aggregation for the Elisa Agent Runtime.
+ *
+ * ESP32 devices POST their turn latency histograms to
+ * /v1/agents/:id/heartbeat once a minute. Each report covers only the
+ * interval since the previous accepted one, so aggregation is a plain
+ * bucket-wise sum. Percentiles are read off the merged buckets and are
+ * reported as the bucket's upper bound (within ~12.5% of the true value).
+ *
+ * In-memory storage, consistent with existing patterns.
+ */
+
+import type {
+  DeviceHeartbeatReport,
+  DeviceTelemetrySummary,
+  LatencyHistogram,
+  LatencySummary,
+} from '../../models/runtime.js';
+
+// ── Internal State ────────────────────────────────────────────────────
+
+interface MergedHistogram {
+  count: number;
+  sum_ms: number;
+  max_ms: number;
+  /** upper_ms -> count */
+  buckets: Map<number, number>;
+}
+
+interface AgentTelemetryState {
+  reports: number;
+  last_report_at: Date | null;
+  latency: Map<string, MergedHistogram>;
+  memory: Record<string, number>;
+}
+
+/** Metric names are short identifiers; anything else is rejected. */
+const METRIC_NAME_PATTERN = /^[a-z0-9_]{1,32}$/;
+
+/** Upper bound on buckets per metric (the firmware sends at most 112). */
+const MAX_BUCKETS = 256;
+
+// ── Helpers ──────────────────────────────────────────────────────────
+
+function isNonNegativeNumber(value: unknown): value is number {
+  return typeof value === 'number' && Number.isFinite(value) && value >= 0;
+}
+
+/**
+ * Validate a heartbeat report body. Returns an error message, or null if
+ * the report is well-formed.
+ */
+export function validateHeartbeatReport(body: unknown): string | null {
+  if (!body || typeof body !== 'object' || Array.isArray(body)) {
+    return 'Request body must be a heartbeat report object';
+  }
+  const report = body as DeviceHeartbeatReport;
+
+  if (report.config_version !== undefined &&
+      (!Number.isInteger(report.config_version) || report.config_version < 0)) {
+    return 'config_version must be a non-negative integer';
+  }
+
+  if (report.latency !== undefined) {
+    if (!report.latency || typeof report.latency !== 'object' || Array.isArray(report.latency)) {
+      return 'latency must be an object';
+    }
+    for (const [name, hist] of Object.entries(report.latency)) {
+      if (!METRIC_NAME_PATTERN.test(name)) {
+        return `Invalid latency metric name: ${name}`;
+      }
+      const h = hist as LatencyHistogram;
+      if (!h || typeof h !== 'object' ||
+          !isNonNegativeNumber(h.count) || !isNonNegativeNumber(h.sum_ms) || !isNonNegativeNumber(h.max_ms) ||
+          !Array.isArray(h.buckets) || h.buckets.length > MAX_BUCKETS) {
+        return `Invalid histogram for ${name}`;
+      }
+      for (const bucket of h.buckets) {
+        if (!Array.isArray(bucket) || bucket.length !== 2 ||
+            !isNonNegativeNumber(bucket[0]) || !isNonNegativeNumber(bucket[1])) {
+          return `Invalid bucket in ${name}: expected [upper_ms, count]`;
+        }
+      }
+    }
+  }
+
+  if (report.memory !== undefined) {
+    if (!report.memory || typeof report.memory !== 'object' || Array.isArray(report.memory)) {
+      return 'memory must be an object';
+    }
+    for (const value of Object.values(report.memory)) {
+      if (typeof value !== 'number' || !Number.isFinite(value)) {
+        return 'memory values must be numbers';
+      }
+    }
+  }
+
+  return null;
+}
+
+/**
+ * Value at percentile `pct` (0-100) of a merged histogram: the upper bound
+ * of the bucket holding the ceil(count * pct / 100)-th sample, capped at max.
+ */
+function histogramPercentile(hist: MergedHistogram, pct: number): number {
+  if (hist.count === 0) return 0;
+  const rank = Math.max(1, Math.ceil((hist.count * pct) / 100));
+  const uppers = [...hist.buckets.keys()].sort((a, b) => a - b);
+
+  let seen = 0;
+  for (const upper of uppers) {
+    seen += hist.buckets.get(upper)!;
+    if (seen >= rank) {
+      return Math.min(upper, hist.max_ms);
+    }
+  }
+  return hist.max_ms;
+}
+
+// ── DeviceTelemetryStore ─────────────────────────────────────────────
+
+export class DeviceTelemetryStore {
+  private agents = new Map<string, AgentTelemetryState>();
+
+  /**
+   * Merge one heartbeat report into the agent's aggregates.
+   * The report must have passed validateHeartbeatReport().
+   */
+  record(agentId: string, report: DeviceHeartbeatReport): void {
+    let state = this.agents.get(agentId);
+    if (!state) {
+      state = { reports: 0, last_report_at: null, latency: new Map(), memory: {} };
+      this.agents.set(agentId, state);
+    }
+
+    state.reports += 1;
+    state.last_report_at = new Date();
+
+    for (const [name, hist] of Object.entries(report.latency ?? {})) {
+      let merged = state.latency.get(name);
+      if (!merged) {
+        merged = { count: 0, sum_ms: 0, max_ms: 0, buckets: new Map() };
+        state.latency.set(name, merged);
+      }
+      merged.count += hist.count;
+      merged.sum_ms += hist.sum_ms;
+      merged.max_ms = Math.max(merged.max_ms, hist.max_ms);
+      for (const [upper, count] of hist.buckets) {
+        merged.buckets.set(upper, (merged.buckets.get(upper) ?? 0) + count);
+      }
+    }
+
+    // Memory figures are device-lifetime values; keep the latest
+    if (report.memory) {
+      state.memory = { ...report.memory };
+    }
+  }
+
+  /**
+   * Aggregated latency percentiles and the latest memory figures.
+   */
+  getSummary(agentId: string): DeviceTelemetrySummary {
+    const state = this.agents.get(agentId);
+    if (!state) {
+      return { reports: 0, last_report_at: null, latency: {}, memory: {} };
+    }
+
+    const latency: Record<string, LatencySummary> = {};
+    for (const [name, hist] of state.latency) {
+      latency[name] = {
+        count: hist.count,
+        mean_ms: hist.count > 0 ? Math.round(hist.sum_ms / hist.count) : 0,
+        p50_ms: histogramPercentile(hist, 50),
+        p90_ms: histogramPercentile(hist, 90),
+        p99_ms: histogramPercentile(hist, 99),
+        max_ms: hist.max_ms,
+      };
+    }
+
+    return {
+      reports: state.reports,
+      last_report_at: state.last_report_at?.toISOString() ?? null,
+      latency,
+      memory: { ...state.memory },
+    };
+  }
+
+  /**
+   * Clean up telemetry when an agent is deleted.
+   */
+  deleteAgent(agentId: string): boolean {
+    return this.agents.delete(agentId);
+  }
+}
@@ -603,6 +603,95 @@ describe('EsptoolFlashStrategy.flash', () => {
     expect(fs.existsSync(configPath)).toBe(false);
   });
 
+  it('flashes the compiled config image when config_partition is present', async () => {
+    setupEsptoolAvailable();
+    const writeSpy = vi.spyOn(fs, 'writeFileSync');
+    const strategy = new EsptoolFlashStrategy();
+    const params = makeEsptoolFlashParams({
+      injections: { agent_id: 'agent-123', api_key: 'eart_key', runtime_url: 'http://10.0.0.2:8000' },
+      flashConfig: {
+        firmware_file: 'firmware.bin',
+        flash_offset: '0x10000',
+        baud_rate: 460800,
+        chip: 'esp32s3',
+        prompt_message: 'Plug in BOX-3',
+        config_partition: { offset: '0xaf0000', size: '0x10000' },
+      },
+    });
+
+    await strategy.flash(params);
+
+    const flashCall = mockExecFile.mock.calls.find(
+      (call: any[]) => Array.isArray(call[1]) && call[1].includes('write_flash'),
+    );
+    const args = flashCall![1] as string[];
+    const i = args.indexOf('0xaf0000');
+    expect(i).toBeGreaterThan(0);
+    expect(args[i + 1]).toMatch(/elisa_cfg\.bin$/);
+
+    const write = writeSpy.mock.calls.find((call) => String(call[0]).endsWith('elisa_cfg.bin'));
+    const image = write![1] as Buffer;
+    expect(image.subarray(0, 4).toString('ascii')).toBe('ELCF');
+    expect(image.subarray(20, 29).toString('ascii')).toBe('agent-123');
+    // Temp image is removed after flashing
+    expect(fs.existsSync(args[i + 1])).toBe(false);
+    writeSpy.mockRestore();
+  });
+
+  it('flashes an asset image holding runtime_config.json when assets_partition is present', async () => {
+    setupEsptoolAvailable();
+    const writeSpy = vi.spyOn(fs, 'writeFileSync');
+    const strategy = new EsptoolFlashStrategy();
+    const params = makeEsptoolFlashParams({
+      injections: { agent_id: 'agent-123', api_key: 'eart_key', runtime_url: 'http://10.0.0.2:8000' },
+      flashConfig: {
+        firmware_file: 'firmware.bin',
+        flash_offset: '0x10000',
+        prompt_message: 'Plug in BOX-3',
+        assets_partition: { offset: '0xa00000', size: '0xf0000' },
+      },
+    });
+
+    await strategy.flash(params);
+
+    const flashCall = mockExecFile.mock.calls.find(
+      (call: any[]) => Array.isArray(call[1]) && call[1].includes('write_flash'),
+    );
+    const args = flashCall![1] as string[];
+    const i = args.indexOf('0xa00000');
+    expect(i).toBeGreaterThan(0);
+    expect(args[i + 1]).toMatch(/elisa_assets\.bin$/);
+
+    const write = writeSpy.mock.calls.find((call) => String(call[0]).endsWith('elisa_assets.bin'));
+    const image = write![1] as Buffer;
+    expect(image.subarray(0, 4).toString('ascii')).toBe('ELAS');
+    expect(image.readUInt16LE(14)).toBe(1);
+    expect(image.includes(Buffer.from('runtime_config.json\0'))).toBe(true);
+    expect(image.includes(Buffer.from('"agent_id":"agent-123"'))).toBe(true);
+    expect(fs.existsSync(args[i + 1])).toBe(false);
+    writeSpy.mockRestore();
+  });
+
+  it('does not flash a config image without injections', async () => {
+    setupEsptoolAvailable();
+    const strategy = new EsptoolFlashStrategy();
+    const params = makeEsptoolFlashParams({
+      flashConfig: {
+        firmware_file: 'firmware.bin',
+        flash_offset: '0x10000',
+        prompt_message: 'Plug in BOX-3',
+        config_partition: { offset: '0xaf0000', size: '0x10000' },
+      },
+    });
+
+    await strategy.flash(params);
+
+    const flashCall = mockExecFile.mock.calls.find(
+      (call: any[]) => Array.isArray(call[1]) && call[1].includes('write_flash'),
+    );
+    expect(flashCall![1]).not.toContain('0xaf0000');
+  });
+
   it('uses explicit SERIAL_PORT from device fields', async () => {
     setupEsptoolAvailable();
     const strategy = new EsptoolFlashStrategy();
@@ -0,0 +1,174 @@
+import { describe, it, expect } from 'vitest';
+import { DeviceConfigStore, validateConfigUpdate } from '../../services/runtime/deviceConfig.js';
+
+/** Version n of epoch 1, the epoch makeStore() issues first. */
+const v = (n: number) => 0x10000 + n;
+
+/** A store issuing the given epochs in turn, then 0x7777. */
+function makeStore(...epochs: number[]) {
+  const queue = epochs.length > 0 ? epochs : [1];
+  return new DeviceConfigStore(() => queue.shift() ?? 0x7777);
+}
+
+describe('DeviceConfigStore', () => {
+  describe('update / get', () => {
+    it('starts an agent at version 0 with no changes', () => {
+      const store = makeStore();
+      expect(store.get('agent-1')).toEqual({ version: 0, changes: {} });
+    });
+
+    it('bumps the version once per update that changes something', () => {
+      const store = makeStore();
+      expect(store.update('agent-1', { face_descriptor: { expression: 'cool' }, wake_cutoff: 0.9 })).toBe(v(1));
+      expect(store.update('agent-1', { wake_cutoff: 0.8 })).toBe(v(2));
+      // Same value again: nothing to send
+      expect(store.update('agent-1', { wake_cutoff: 0.8 })).toBe(v(2));
+
+      expect(store.get('agent-1')).toEqual({
+        version: v(2),
+        changes: { face_descriptor: { expression: 'cool' }, wake_cutoff: 0.8 },
+      });
+    });
+
+    it('merges partial face descriptors', () => {
+      const store = makeStore();
+      store.update('agent-1', { face_descriptor: { eyes: { style: 'anime' } } });
+      store.update('agent-1', { face_descriptor: { eyes: { color: '#112233' }, mouth: { style: 'cat' } } });
+
+      expect(store.get('agent-1').changes.face_descriptor).toEqual({
+        eyes: { style: 'anime', color: '#112233' },
+        mouth: { style: 'cat' },
+      });
+    });
+
+    it('keeps agents separate and forgets deleted ones', () => {
+      const store = makeStore();
+      store.update('agent-1', { wake_cutoff: 0.9 });
+      store.update('agent-2', { wake_cutoff: 0.7 });
+      expect(store.deleteAgent('agent-1')).toBe(true);
+      expect(store.get('agent-1').version).toBe(0);
+      expect(store.get('agent-2').changes).toEqual({ wake_cutoff: 0.7 });
+    });
+  });
+
+  describe('deltaSince', () => {
+    it('returns only the keys changed after the device version', () => {
+      const store = makeStore();
+      store.update('agent-1', { wake_cutoff: 0.9, face_descriptor: { expression: 'cool' } });
+      store.update('agent-1', { face_descriptor: { mouth: { style: 'cat' } } });
+      store.update('agent-1', { wake_cutoff: 0.8 });
+
+      expect(store.deltaSince('agent-1', 0)).toEqual({
+        version: v(3),
+        changes: { wake_cutoff: 0.8, face_descriptor: { expression: 'cool', mouth: { style: 'cat' } } },
+      });
+      expect(store.deltaSince('agent-1', v(1))).toEqual({
+        version: v(3),
+        changes: { face_descriptor: { expression: 'cool', mouth: { style: 'cat' } }, wake_cutoff: 0.8 },
+      });
+      expect(store.deltaSince('agent-1', v(2))).toEqual({ version: v(3), changes: { wake_cutoff: 0.8 } });
+    });
+
+    it('returns null once the device is current', () => {
+      const store = makeStore();
+      expect(store.deltaSince('agent-1', 0)).toBeNull();
+      store.update('agent-1', { wake_cutoff: 0.8 });
+      expect(store.deltaSince('agent-1', v(1))).toBeNull();
+    });
+
+    it('resends everything to a device that ran versions from before a restart', () => {
+      const before = makeStore(9);
+      before.update('agent-1', { wake_cutoff: 0.9 });
+      before.update('agent-1', { wake_cutoff: 0.8 });
+      before.update('agent-1', { face_descriptor: { expression: 'cool' } });
+      const deviceVersion = before.get('agent-1').version;
+
+      // The restarted runtime counts from 0 again, in a lower epoch
+      const after = makeStore(2);
+      expect(after.deltaSince('agent-1', deviceVersion)).toBeNull();
+      const version = after.update('agent-1', { face_descriptor: { mouth: { style: 'cat' } } });
+      expect(version).toBeLessThan(deviceVersion);
+      after.update('agent-1', { wake_cutoff: 0.7 });
+
+      expect(after.deltaSince('agent-1', deviceVersion)).toEqual({
+        version: version + 1,
+        changes: { face_descriptor: { mouth: { style: 'cat' } }, wake_cutoff: 0.7 },
+      });
+      expect(after.deltaSince('agent-1', version + 1)).toBeNull();
+    });
+
+    it('moves to a new epoch when one runs out of versions', () => {
+      const store = makeStore(1, 1, 5);
+      store.update('agent-1', { face_descriptor: { expression: 'cool' } });
+      for (let i = 2; i <= 0xffff; i++) {
+        store.update('agent-1', { wake_cutoff: i / 0x10000 });
+      }
+      const last = store.get('agent-1').version;
+      expect(last).toBe(v(0xffff));
+
+      // The next epoch is never the one used up
+      expect(store.update('agent-1', { wake_cutoff: 0.5 })).toBe(5 * 0x10000 + 1);
+      expect(store.deltaSince('agent-1', last)).toEqual({
+        version: 5 * 0x10000 + 1,
+        changes: { face_descriptor: { expression: 'cool' }, wake_cutoff: 0.5 },
+      });
+    });
+
+    it('returns copies, not the stored values', () => {
+      const store = makeStore();
+      store.update('agent-1', { face_descriptor: { expression: 'cool' } });
+      const delta = store.deltaSince('agent-1', 0)!;
+      (delta.changes.face_descriptor as Record<string, unknown>).expression = 'shy';
+      expect(store.get('agent-1').changes.face_descriptor).toEqual({ expression: 'cool' });
+    });
+  });
+});
+
+describe('validateConfigUpdate', () => {
+  it('accepts every live key', () => {
+    expect(validateConfigUpdate({
+      face_descriptor: {
+        base_shape: 'oval',
+        eyes: { style: 'anime', size: 'large', color: '#112233' },
+        mouth: { style: 'cat' },
+        expression: 'cool',
+        colors: { face: '#abcdef', accent: '#010203' },
+      },
+      wake_cutoff: 0.9,
+    })).toBeNull();
+  });
+
+  it('accepts a null wake_cutoff to restore the model threshold', () => {
+    expect(validateConfigUpdate({ wake_cutoff: null })).toBeNull();
+  });
+
+  it('rejects keys that need a reflash', () => {
+    expect(validateConfigUpdate({ wifi_ssid: 'Other' })).toContain('wifi_ssid');
+    expect(validateConfigUpdate({ runtime_url: 'http://x' })).toContain('runtime_url');
+  });
+
+  it('rejects keys the device would not apply', () => {
+    expect(validateConfigUpdate({ system_prompt: 'Be brief.' })).toContain('cannot be changed live');
+    expect(validateConfigUpdate({ tts_voice: 'echo' })).toContain('cannot be changed live');
+    // Stored for the next boot only: nothing on screen shows them
+    expect(validateConfigUpdate({ agent_name: 'Robo' })).toContain('cannot be changed live');
+    expect(validateConfigUpdate({ wake_word: 'Hey Box' })).toContain('cannot be changed live');
+    expect(validateConfigUpdate({ display_theme: 'candy' })).toContain('cannot be changed live');
+    // WakeNet has a single threshold
+    expect(validateConfigUpdate({ wake_min_frames: 4 })).toContain('cannot be changed live');
+    expect(validateConfigUpdate({ wake_frame_threshold: 0.8 })).toContain('cannot be changed live');
+  });
+
+  it('rejects empty and non-object bodies', () => {
+    expect(validateConfigUpdate({})).toContain('empty');
+    expect(validateConfigUpdate([])).not.toBeNull();
+    expect(validateConfigUpdate('prompt')).not.toBeNull();
+  });
+
+  it('rejects unknown choices and malformed values', () => {
+    expect(validateConfigUpdate({ face_descriptor: { base_shape: 'star' } })).toContain('base_shape');
+    expect(validateConfigUpdate({ face_descriptor: { eyes: { size: 'huge' } } })).toContain('eyes.size');
+    expect(validateConfigUpdate({ face_descriptor: { colors: { face: 'red' } } })).toContain('colors.face');
+    expect(validateConfigUpdate({ wake_cutoff: 1.5 })).toContain('wake_cutoff');
+  });
+});
@@ -0,0 +1,99 @@
+import { describe, it, expect } from 'vitest';
+import { DeviceTelemetryStore, validateHeartbeatReport } from '../../services/runtime/deviceTelemetry.js';
+
+function hist(buckets: Array<[number, number]>, max_ms?: number) {
+  const count = buckets.reduce((n, [, c]) => n + c, 0);
+  const sum_ms = buckets.reduce((n, [upper, c]) => n + upper * c, 0);
+  return { count, sum_ms, max_ms: max_ms ?? Math.max(0, ...buckets.map(([u]) => u)), buckets };
+}
+
+describe('DeviceTelemetryStore', () => {
+  describe('record / getSummary', () => {
+    it('returns an empty summary for an agent with no reports', () => {
+      const store = new DeviceTelemetryStore();
+      const summary = store.getSummary('agent-1');
+      expect(summary.reports).toBe(0);
+      expect(summary.last_report_at).toBeNull();
+      expect(summary.latency).toEqual({});
+    });
+
+    it('computes percentiles from bucket upper bounds', () => {
+      const store = new DeviceTelemetryStore();
+      // 90 fast turns, 9 medium, 1 slow
+      store.record('agent-1', {
+        latency: { ttfb: hist([[1023, 90], [2047, 9], [4095, 1]], 3900) },
+      });
+
+      const ttfb = store.getSummary('agent-1').latency.ttfb;
+      expect(ttfb.count).toBe(100);
+      expect(ttfb.p50_ms).toBe(1023);
+      expect(ttfb.p90_ms).toBe(1023);
+      expect(ttfb.p99_ms).toBe(2047);
+      // The last bucket is capped at the reported max
+      expect(ttfb.max_ms).toBe(3900);
+    });
+
+    it('merges buckets across reports and devices', () => {
+      const store = new DeviceTelemetryStore();
+      store.record('agent-1', { latency: { decode: hist([[95, 3]]) } });
+      store.record('agent-1', { latency: { decode: hist([[95, 1], [383, 4]]) } });
+
+      const summary = store.getSummary('agent-1');
+      expect(summary.reports).toBe(2);
+      expect(summary.latency.decode.count).toBe(8);
+      expect(summary.latency.decode.p50_ms).toBe(95);
+      expect(summary.latency.decode.p99_ms).toBe(383);
+      expect(summary.latency.decode.mean_ms).toBe(Math.round((95 * 4 + 383 * 4) / 8));
+      expect(summary.last_report_at).not.toBeNull();
+    });
+
+    it('keeps the latest memory figures', () => {
+      const store = new DeviceTelemetryStore();
+      store.record('agent-1', { memory: { failed_allocs: 0, spiram_max_peak: 1000 } });
+      store.record('agent-1', { memory: { failed_allocs: 2, spiram_max_peak: 1500 } });
+
+      expect(store.getSummary('agent-1').memory).toEqual({ failed_allocs: 2, spiram_max_peak: 1500 });
+    });
+
+    it('isolates agents and cleans up on delete', () => {
+      const store = new DeviceTelemetryStore();
+      store.record('agent-1', { latency: { upload: hist([[63, 1]]) } });
+      expect(store.getSummary('agent-2').reports).toBe(0);
+
+      expect(store.deleteAgent('agent-1')).toBe(true);
+      expect(store.getSummary('agent-1').reports).toBe(0);
+    });
+  });
+
+  describe('validateHeartbeatReport', () => {
+    it('accepts a firmware-shaped report', () => {
+      expect(validateHeartbeatReport({
+        uptime_s: 120,
+        latency: { first_audio: hist([[2303, 2]]), ttfb: hist([]) },
+        memory: { turns: 2, failed_allocs: 0 },
+      })).toBeNull();
+    });
+
+    it('rejects non-object bodies', () => {
+      expect(validateHeartbeatReport([1, 2])).toContain('heartbeat report');
+      expect(validateHeartbeatReport(null)).toContain('heartbeat report');
+    });
+
+    it('rejects malformed buckets', () => {
+      const bad = { latency: { ttfb: { count: 1, sum_ms: 10, max_ms: 10, buckets: [[10]] } } };
+      expect(validateHeartbeatReport(bad)).toContain('[upper_ms, count]');
+    });
+
+    it('rejects negative counts and odd metric names', () => {
+      expect(validateHeartbeatReport({ latency: { ttfb: { count: -1, sum_ms: 0, max_ms: 0, buckets: [] } } }))
+        .toContain('Invalid histogram');
+      expect(validateHeartbeatReport({ latency: { 'TTFB!': hist([]) } })).toContain('metric name');
+    });
+
+    it('accepts a config version and rejects a malformed one', () => {
+      expect(validateHeartbeatReport({ uptime_s: 60, config_version: 3 })).toBeNull();
+      expect(validateHeartbeatReport({ config_version: -1 })).toContain('config_version');
+      expect(validateHeartbeatReport({ config_version: '3' })).toContain('config_version');
+    });
+  });
+});
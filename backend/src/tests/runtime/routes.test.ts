@@ -6,6 +6,8 @@ import express from 'express';
 import { AgentStore } from '../../services/runtime/agentStore.js';
 import { ConversationManager } from '../../services/runtime/conversationManager.js';
 import { TurnPipeline, UsageTracker } from '../../services/runtime/turnPipeline.js';
+import { DeviceTelemetryStore } from '../../services/runtime/deviceTelemetry.js';
+import { DeviceConfigStore } from '../../services/runtime/deviceConfig.js';
 import { createRuntimeRouter } from '../../routes/runtime.js';
 
 // ── Mock Anthropic Client ────────────────────────────────────────────
@@ -46,7 +48,13 @@ function createTestApp() {
 
   const app = express();
   app.use(express.json());
-  app.use('/v1', createRuntimeRouter({ agentStore, conversationManager, turnPipeline }));
+  app.use('/v1', createRuntimeRouter({
+    agentStore,
+    conversationManager,
+    turnPipeline,
+    deviceTelemetry: new DeviceTelemetryStore(),
+    deviceConfig: new DeviceConfigStore(),
+  }));
   return app;
 }
 
@@ -482,6 +490,195 @@ describe('GET /v1/agents/:id/heartbeat', () => {
   });
 });
 
+// ── POST /v1/agents/:id/heartbeat (Device Telemetry) ────────────────
+
+describe('POST /v1/agents/:id/heartbeat', () => {
+  function report(ttfbBuckets: Array<[number, number]>) {
+    const count = ttfbBuckets.reduce((n, [, c]) => n + c, 0);
+    return {
+      uptime_s: 600,
+      latency: {
+        ttfb: { count, sum_ms: count * 900, max_ms: 1900, buckets: ttfbBuckets },
+      },
+      memory: { turns: count, failed_allocs: 0 },
+    };
+  }
+
+  it('accepts a report and returns heartbeat status', async () => {
+    const { body: provisioned } = await fetchJSON('/v1/agents', {
+      method: 'POST',
+      body: JSON.stringify(makeSpec()),
+    });
+
+    const { status, body } = await fetchJSON(`/v1/agents/${provisioned.agent_id}/heartbeat`, {
+      method: 'POST',
+      body: JSON.stringify(report([[959, 3]])),
+      headers: { 'x-api-key': provisioned.api_key },
+    });
+
+    expect(status).toBe(200);
+    expect(body.status).toBe('online');
+    expect(body.agent_id).toBe(provisioned.agent_id);
+  });
+
+  it('aggregates reports into percentiles on GET /telemetry', async () => {
+    const { body: provisioned } = await fetchJSON('/v1/agents', {
+      method: 'POST',
+      body: JSON.stringify(makeSpec()),
+    });
+    const headers = { 'x-api-key': provisioned.api_key };
+
+    await fetchJSON(`/v1/agents/${provisioned.agent_id}/heartbeat`, {
+      method: 'POST', body: JSON.stringify(report([[959, 60]])), headers,
+    });
+    await fetchJSON(`/v1/agents/${provisioned.agent_id}/heartbeat`, {
+      method: 'POST', body: JSON.stringify(report([[959, 39], [1919, 1]])), headers,
+    });
+
+    const { status, body } = await fetchJSON(`/v1/agents/${provisioned.agent_id}/telemetry`, { headers });
+
+    expect(status).toBe(200);
+    expect(body.reports).toBe(2);
+    expect(body.latency.ttfb.count).toBe(100);
+    expect(body.latency.ttfb.p50_ms).toBe(959);
+    expect(body.latency.ttfb.p99_ms).toBe(959);
+    expect(body.latency.ttfb.max_ms).toBe(1900);
+    expect(body.memory.turns).toBe(40);
+  });
+
+  it('returns 400 for a malformed report', async () => {
+    const { body: provisioned } = await fetchJSON('/v1/agents', {
+      method: 'POST',
+      body: JSON.stringify(makeSpec()),
+    });
+
+    const { status, body } = await fetchJSON(`/v1/agents/${provisioned.agent_id}/heartbeat`, {
+      method: 'POST',
+      body: JSON.stringify({ latency: { ttfb: { count: 1, sum_ms: 1, max_ms: 1, buckets: 'nope' } } }),
+      headers: { 'x-api-key': provisioned.api_key },
+    });
+
+    expect(status).toBe(400);
+    expect(body.detail).toContain('ttfb');
+  });
+
+  it('returns 401 without api key', async () => {
+    const { body: provisioned } = await fetchJSON('/v1/agents', {
+      method: 'POST',
+      body: JSON.stringify(makeSpec()),
+    });
+
+    const { status } = await fetchJSON(`/v1/agents/${provisioned.agent_id}/heartbeat`, {
+      method: 'POST',
+      body: JSON.stringify(report([[959, 1]])),
+    });
+
+    expect(status).toBe(401);
+  });
+});
+
+// ── /v1/agents/:id/config (Live Device Config) ──────────────────────
+
+describe('PATCH /v1/agents/:id/config', () => {
+  async function provision() {
+    const { body } = await fetchJSON('/v1/agents', {
+      method: 'POST',
+      body: JSON.stringify(makeSpec()),
+    });
+    return { agentId: body.agent_id as string, headers: { 'x-api-key': body.api_key as string } };
+  }
+
+  function heartbeat(agentId: string, headers: Record<string, string>, configVersion: number) {
+    return fetchJSON(`/v1/agents/${agentId}/heartbeat`, {
+      method: 'POST',
+      body: JSON.stringify({ uptime_s: 60, config_version: configVersion }),
+      headers,
+    });
+  }
+
+  it('versions changes and returns them on GET', async () => {
+    const { agentId, headers } = await provision();
+
+    const first = await fetchJSON(`/v1/agents/${agentId}/config`, {
+      method: 'PATCH', body: JSON.stringify({ face_descriptor: { expression: 'cool' }, wake_cutoff: 0.9 }), headers,
+    });
+    expect(first.status).toBe(200);
+    expect(first.body.agent_id).toBe(agentId);
+    expect(first.body.version).toBeGreaterThan(0);
+
+    const { status, body } = await fetchJSON(`/v1/agents/${agentId}/config`, { headers });
+    expect(status).toBe(200);
+    expect(body.version).toBe(first.body.version);
+    expect(body.config).toEqual({ face_descriptor: { expression: 'cool' }, wake_cutoff: 0.9 });
+  });
+
+  it('sends the device the keys changed since the version it reports', async () => {
+    const { agentId, headers } = await provision();
+
+    // Nothing changed yet: a plain heartbeat status
+    const before = await heartbeat(agentId, headers, 0);
+    expect(before.body.status).toBe('online');
+    expect(before.body.config).toBeUndefined();
+
+    const { body: v1 } = await fetchJSON(`/v1/agents/${agentId}/config`, {
+      method: 'PATCH', body: JSON.stringify({ wake_cutoff: 0.8 }), headers,
+    });
+    const { body: v2 } = await fetchJSON(`/v1/agents/${agentId}/config`, {
+      method: 'PATCH', body: JSON.stringify({ face_descriptor: { mouth: { style: 'cat' } } }), headers,
+    });
+    expect(v2.version).toBe(v1.version + 1);
+
+    const stale = await heartbeat(agentId, headers, 0);
+    expect(stale.status).toBe(200);
+    expect(stale.body.config).toEqual({
+      version: v2.version,
+      changes: { wake_cutoff: 0.8, face_descriptor: { mouth: { style: 'cat' } } },
+    });
+
+    const partly = await heartbeat(agentId, headers, v1.version);
+    expect(partly.body.config.changes).toEqual({ face_descriptor: { mouth: { style: 'cat' } } });
+
+    const current = await heartbeat(agentId, headers, v2.version);
+    expect(current.body.config).toBeUndefined();
+  });
+
+  it('returns 400 for keys that need a reflash, keys the device ignores or bad values', async () => {
+    const { agentId, headers } = await provision();
+
+    const wifi = await fetchJSON(`/v1/agents/${agentId}/config`, {
+      method: 'PATCH', body: JSON.stringify({ wifi_password: 'new' }), headers,
+    });
+    expect(wifi.status).toBe(400);
+    expect(wifi.body.detail).toContain('wifi_password');
+
+    const prompt = await fetchJSON(`/v1/agents/${agentId}/config`, {
+      method: 'PATCH', body: JSON.stringify({ system_prompt: 'Talk like a pirate.' }), headers,
+    });
+    expect(prompt.status).toBe(400);
+    expect(prompt.body.detail).toContain('system_prompt');
+
+    const theme = await fetchJSON(`/v1/agents/${agentId}/config`, {
+      method: 'PATCH', body: JSON.stringify({ display_theme: 'candy' }), headers,
+    });
+    expect(theme.status).toBe(400);
+    expect(theme.body.detail).toContain('display_theme');
+
+    const cutoff = await fetchJSON(`/v1/agents/${agentId}/config`, {
+      method: 'PATCH', body: JSON.stringify({ wake_cutoff: 1.5 }), headers,
+    });
+    expect(cutoff.status).toBe(400);
+  });
+
+  it('returns 401 without api key', async () => {
+    const { agentId } = await provision();
+
+    const { status } = await fetchJSON(`/v1/agents/${agentId}/config`, {
+      method: 'PATCH', body: JSON.stringify({ wake_cutoff: 0.9 }),
+    });
+    expect(status).toBe(401);
+  });
+});
+
 // ── Auth validation across endpoints ─────────────────────────────────
 
 describe('API key auth validation', () => {
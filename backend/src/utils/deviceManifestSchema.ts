@@ -104,6 +104,14 @@ const EsptoolDeploySchema = z.object({
       obj_name_len: z.number().int().default(32),
       meta_len: z.number().int().default(4),
     }).optional(),
+    config_partition: z.object({
+      offset: z.string().max(20),
+      size: z.string().max(20),
+    }).optional(),
+    assets_partition: z.object({
+      offset: z.string().max(20),
+      size: z.string().max(20),
+    }).optional(),
   }),
   runtime_provision: RuntimeProvisionSchema.optional(),
 });
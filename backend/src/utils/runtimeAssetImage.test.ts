@@ -0,0 +1,121 @@
+/**
+ * Tests for the asset image (firmware elisa_assets_bin.h).
+ *
+ * findAsset() below walks the image the way elisa_assets_bin_find() does.
+ */
+
+import fs from 'node:fs';
+import os from 'node:os';
+import path from 'node:path';
+import { describe, it, expect, afterEach } from 'vitest';
+import {
+  ASSET_ALIGN,
+  ASSET_ENTRY_SIZE,
+  ASSET_HEADER_SIZE,
+  ASSET_IMAGE_MAGIC,
+  assetHash,
+  buildAssetImage,
+  collectAssetFiles,
+} from './runtimeAssetImage.js';
+import { crc32 } from './runtimeConfigBinary.js';
+
+function findAsset(img: Buffer, name: string): { data: Buffer; crc: number; offset: number } | undefined {
+  const buckets = img.readUInt16LE(12);
+  const hash = assetHash(name);
+  for (let b = hash & (buckets - 1); ; b = (b + 1) & (buckets - 1)) {
+    const entry = ASSET_HEADER_SIZE + b * ASSET_ENTRY_SIZE;
+    const nameOffset = img.readUInt32LE(entry + 4);
+    if (nameOffset === 0) return undefined;
+    const end = img.indexOf(0, nameOffset);
+    if (img.readUInt32LE(entry) === hash && img.subarray(nameOffset, end).toString('utf-8') === name) {
+      const offset = img.readUInt32LE(entry + 8);
+      return {
+        data: img.subarray(offset, offset + img.readUInt32LE(entry + 12)),
+        crc: img.readUInt32LE(entry + 16),
+        offset,
+      };
+    }
+  }
+}
+
+const FILES = [
+  { name: 'runtime_config.json', data: Buffer.from('{"agent_id":"a"}') },
+  { name: 'wake_word.tflite', data: Buffer.alloc(1000, 7) },
+  { name: 'tts/turn_failed.mp3', data: Buffer.from([0xff, 0xfb, 0x90, 0x00]) },
+  { name: 'earcon/wake.mp3', data: Buffer.alloc(0) },
+];
+
+// ── Encoding ────────────────────────────────────────────────────────────
+
+describe('buildAssetImage', () => {
+  it('writes a header with magic, sizes, table shape and directory CRC', () => {
+    const img = buildAssetImage(FILES);
+    expect(img.readUInt32LE(0)).toBe(ASSET_IMAGE_MAGIC);
+    expect(img.subarray(0, 4).toString('ascii')).toBe('ELAS');
+    expect(img.readUInt16LE(4)).toBe(1);
+    expect(img.readUInt16LE(6)).toBe(ASSET_HEADER_SIZE);
+    expect(img.readUInt32LE(8)).toBe(img.length);
+    expect(img.readUInt16LE(12)).toBe(8); // power of two, at most half full
+    expect(img.readUInt16LE(14)).toBe(FILES.length);
+    const dirEnd = ASSET_HEADER_SIZE + img.readUInt32LE(16);
+    expect(img[dirEnd - 1]).toBe(0);
+    expect(img.readUInt32LE(20)).toBe(crc32(img.subarray(ASSET_HEADER_SIZE, dirEnd)));
+  });
+
+  it('finds every file by name, aligned and with its CRC', () => {
+    const img = buildAssetImage(FILES);
+    for (const file of FILES) {
+      const asset = findAsset(img, file.name);
+      expect(asset).toBeDefined();
+      expect(asset!.data.equals(file.data)).toBe(true);
+      expect(asset!.crc).toBe(crc32(file.data));
+      expect(asset!.offset % ASSET_ALIGN).toBe(0);
+    }
+    expect(findAsset(img, 'missing.mp3')).toBeUndefined();
+    expect(findAsset(img, 'tts/turn_failed')).toBeUndefined();
+  });
+
+  it('builds a valid empty image', () => {
+    const img = buildAssetImage([]);
+    expect(img.readUInt16LE(14)).toBe(0);
+    expect(img.length).toBe(ASSET_HEADER_SIZE + img.readUInt32LE(16));
+    expect(findAsset(img, 'runtime_config.json')).toBeUndefined();
+  });
+
+  it('rejects bad and duplicate names', () => {
+    expect(() => buildAssetImage([{ name: '', data: Buffer.alloc(1) }])).toThrow('Invalid');
+    expect(() => buildAssetImage([{ name: 'ë'.repeat(32), data: Buffer.alloc(1) }])).toThrow('Invalid');
+    expect(() => buildAssetImage([FILES[0], FILES[0]])).toThrow('Duplicate');
+  });
+
+  it('hashes names with FNV-1a', () => {
+    expect(assetHash('')).toBe(0x811c9dc5);
+    expect(assetHash('a')).toBe(0xe40c292c);
+  });
+});
+
+// ── Collection ──────────────────────────────────────────────────────────
+
+describe('collectAssetFiles', () => {
+  let dir: string | undefined;
+
+  afterEach(() => {
+    if (dir) fs.rmSync(dir, { recursive: true, force: true });
+    dir = undefined;
+  });
+
+  it('names files by their path under the assets directory', () => {
+    dir = fs.mkdtempSync(path.join(os.tmpdir(), 'elisa-assets-test-'));
+    fs.mkdirSync(path.join(dir, 'tts'));
+    fs.writeFileSync(path.join(dir, 'tts', 'turn_failed.mp3'), 'mp3');
+    fs.writeFileSync(path.join(dir, 'wake_word.tflite'), 'model');
+
+    const files = collectAssetFiles(dir);
+    expect(files.map((f) => f.name)).toEqual(['tts/turn_failed.mp3', 'wake_word.tflite']);
+    expect(files[1].data.toString()).toBe('model');
+  });
+
+  it('returns nothing when there is no assets directory', () => {
+    expect(collectAssetFiles(path.join(os.tmpdir(), 'elisa-no-such-assets'))).toEqual([]);
+  });
+});
@@ -0,0 +1,147 @@
+/**
+ * Packs a device's read-only files into the asset image the BOX-3
+ * firmware maps from flash on first use (elisa_assets_bin.h).
+ *
+ * The image is a header, an open-addressed hash table of entries (FNV-1a
+ * of the name, linear probing, at most half full), the NUL-terminated
+ * names, then each file's data aligned to 16 bytes. The firmware looks a
+ * name up with one hash and usually one compare, and reads the data in
+ * place, so there is no filesystem to mount or walk.
+ *
+ * Layout and constants must match elisa_assets_bin.h.
+ */
+
+import fs from 'node:fs';
+import path from 'node:path';
+import { crc32 } from './runtimeConfigBinary.js';
+
+// ── Layout ──────────────────────────────────────────────────────────────
+
+export const ASSET_IMAGE_MAGIC = 0x53414c45; // "ELAS"
+export const ASSET_IMAGE_VERSION = 1;
+export const ASSET_HEADER_SIZE = 24;
+export const ASSET_ENTRY_SIZE = 20;
+export const ASSET_ALIGN = 16;
+export const ASSET_MAX_NAME = 63;
+
+/** Bucket counts are 16-bit and keep one bucket in two free. */
+const MAX_BUCKETS = 0x8000;
+
+export interface AssetFile {
+  /** Lookup name, e.g. "tts/turn_failed.mp3" */
+  name: string;
+  data: Buffer;
+}
+
+/** FNV-1a (32-bit) of the name's UTF-8 bytes, as elisa_assets_hash(). */
+export function assetHash(name: string): number {
+  let h = 0x811c9dc5;
+  for (const byte of Buffer.from(name, 'utf-8')) {
+    h = Math.imul(h ^ byte, 0x01000193) >>> 0;
+  }
+  return h;
+}
+
+function alignUp(n: number): number {
+  return Math.ceil(n / ASSET_ALIGN) * ASSET_ALIGN;
+}
+
+// ── Encoding ────────────────────────────────────────────────────────────
+
+/**
+ * Build an asset image. Throws on an empty, overlong (in UTF-8 bytes),
+ * NUL-containing or duplicate name.
+ */
+export function buildAssetImage(files: AssetFile[]): Buffer {
+  const seen = new Set<string>();
+  for (const { name } of files) {
+    const bytes = Buffer.byteLength(name, 'utf-8');
+    if (bytes === 0 || bytes > ASSET_MAX_NAME || name.includes('\0')) {
+      throw new Error(`Invalid asset name: ${JSON.stringify(name)}`);
+    }
+    if (seen.has(name)) {
+      throw new Error(`Duplicate asset: ${name}`);
+    }
+    seen.add(name);
+  }
+
+  let buckets = 2;
+  while (buckets < files.length * 2) buckets *= 2;
+  if (buckets > MAX_BUCKETS) {
+    throw new Error(`Too many assets: ${files.length}`);
+  }
+
+  // Directory: buckets, then names (at least one byte, so it ends in a NUL)
+  const namesStart = ASSET_HEADER_SIZE + buckets * ASSET_ENTRY_SIZE;
+  const nameOffsets: number[] = [];
+  let off = namesStart;
+  for (const { name } of files) {
+    nameOffsets.push(off);
+    off += Buffer.byteLength(name, 'utf-8') + 1;
+  }
+  const dirEnd = alignUp(Math.max(off, namesStart + 1));
+
+  const dataOffsets: number[] = [];
+  off = dirEnd;
+  for (const { data } of files) {
+    dataOffsets.push(off);
+    off = alignUp(off + data.length);
+  }
+  const imageSize = files.length > 0
+    ? dataOffsets[files.length - 1] + files[files.length - 1].data.length
+    : dirEnd;
+
+  const buf = Buffer.alloc(imageSize);
+  files.forEach(({ name, data }, i) => {
+    const hash = assetHash(name);
+    let b = hash & (buckets - 1);
+    while (buf.readUInt32LE(ASSET_HEADER_SIZE + b * ASSET_ENTRY_SIZE + 4) !== 0) {
+      b = (b + 1) & (buckets - 1);
+    }
+    const entry = ASSET_HEADER_SIZE + b * ASSET_ENTRY_SIZE;
+    buf.writeUInt32LE(hash, entry);
+    buf.writeUInt32LE(nameOffsets[i], entry + 4);
+    buf.writeUInt32LE(dataOffsets[i], entry + 8);
+    buf.writeUInt32LE(data.length, entry + 12);
+    buf.writeUInt32LE(crc32(data), entry + 16);
+    buf.write(name, nameOffsets[i], 'utf-8');
+    data.copy(buf, dataOffsets[i]);
+  });
+
+  buf.writeUInt32LE(ASSET_IMAGE_MAGIC, 0);
+  buf.writeUInt16LE(ASSET_IMAGE_VERSION, 4);
+  buf.writeUInt16LE(ASSET_HEADER_SIZE, 6);
+  buf.writeUInt32LE(imageSize, 8);
+  buf.writeUInt16LE(buckets, 12);
+  buf.writeUInt16LE(files.length, 14);
+  buf.writeUInt32LE(dirEnd - ASSET_HEADER_SIZE, 16);
+  buf.writeUInt32LE(crc32(buf.subarray(ASSET_HEADER_SIZE, dirEnd)), 20);
+  return buf;
+}
+
+// ── Collection ──────────────────────────────────────────────────────────
+
+/**
+ * Read every file under a device plugin's assets directory, named by its
+ * path relative to it with '/' separators (earcon/wake.mp3). Returns []
+ * if the directory does not exist.
+ */
+export function collectAssetFiles(assetsDir: string): AssetFile[] {
+  if (!fs.existsSync(assetsDir)) return [];
+  const files: AssetFile[] = [];
+  const walk = (dir: string, prefix: string): void => {
+    const entries = fs.readdirSync(dir, { withFileTypes: true })
+      .sort((a, b) => a.name.localeCompare(b.name));
+    for (const entry of entries) {
+      const full = path.join(dir, entry.name);
+      const name = prefix ? `${prefix}/${entry.name}` : entry.name;
+      if (entry.isDirectory()) {
+        walk(full, name);
+      } else if (entry.isFile()) {
+        files.push({ name, data: fs.readFileSync(full) });
+      }
+    }
+  };
+  walk(assetsDir, '');
+  return files;
+}
@@ -0,0 +1,138 @@
+/**
+ * Tests for the binary runtime config image (firmware elisa_config_bin.h).
+ *
+ * Offsets below are the firmware's struct layout; if one changes, the
+ * firmware's static_asserts and ELISA_CONFIG_BIN_VERSION change with it.
+ */
+
+import { describe, it, expect } from 'vitest';
+import {
+  CONFIG_BIN_MAGIC,
+  CONFIG_BIN_OFFSETS,
+  CONFIG_BIN_SIZE,
+  CONFIG_BIN_SLOT_SIZE,
+  CONFIG_BIN_SLOTS,
+  buildConfigPartitionImage,
+  crc32,
+  encodeRuntimeConfig,
+} from './runtimeConfigBinary.js';
+
+function readString(buf: Buffer, offset: number, size: number): string {
+  const slot = buf.subarray(offset, offset + size);
+  const end = slot.indexOf(0);
+  expect(end).toBeGreaterThanOrEqual(0);
+  return slot.subarray(0, end).toString('utf-8');
+}
+
+const CONFIG = {
+  agent_id: '123e4567-e89b-12d3-a456-426614174000',
+  api_key: 'eart_abc123',
+  runtime_url: 'http://192.168.1.20:8000',
+  wifi_ssid: 'HomeNet',
+  wifi_password: 'secret',
+  agent_name: 'Robo',
+  wake_word: 'Hey Box',
+  display_theme: 'candy',
+  tts_voice: 'echo',
+  display_buffer: 'psram_full',
+  wake_cutoff: 0.9,
+  wifi_static_ip: { ip: '192.168.1.50', gateway: '192.168.1.1', netmask: '255.255.255.0' },
+  face_descriptor: {
+    base_shape: 'oval',
+    eyes: { style: 'anime', size: 'large', color: '#112233' },
+    mouth: { style: 'cat' },
+    expression: 'cool',
+    colors: { face: '#abcdef', accent: '#010203' },
+  },
+};
+
+// ── Layout ──────────────────────────────────────────────────────────────
+
+describe('config image layout', () => {
+  it('matches the firmware struct offsets', () => {
+    expect(CONFIG_BIN_OFFSETS.strings.agent_id).toBe(20);
+    expect(CONFIG_BIN_OFFSETS.strings.system_prompt).toBe(980);
+    expect(CONFIG_BIN_OFFSETS.strings['wifi_static_ip.dns']).toBe(1540);
+    expect(CONFIG_BIN_OFFSETS.enums).toBe(1556);
+    expect(CONFIG_BIN_OFFSETS.configVersion).toBe(1564);
+    expect(CONFIG_BIN_OFFSETS.face).toBe(1568);
+    expect(CONFIG_BIN_SIZE).toBe(1588);
+  });
+
+  it('computes the standard CRC-32', () => {
+    expect(crc32(Buffer.from('123456789'))).toBe(0xcbf43926);
+  });
+});
+
+// ── Encoding ────────────────────────────────────────────────────────────
+
+describe('encodeRuntimeConfig', () => {
+  it('writes a header with magic, version, sizes, generation and payload CRC', () => {
+    const img = encodeRuntimeConfig(CONFIG, 7);
+    expect(img.length).toBe(CONFIG_BIN_SIZE);
+    expect(img.readUInt32LE(0)).toBe(CONFIG_BIN_MAGIC);
+    expect(img.subarray(0, 4).toString('ascii')).toBe('ELCF');
+    expect(img.readUInt16LE(4)).toBe(3);
+    expect(img.readUInt16LE(6)).toBe(20);
+    expect(img.readUInt32LE(8)).toBe(CONFIG_BIN_SIZE - 20);
+    expect(img.readUInt32LE(12)).toBe(7);
+    expect(img.readUInt32LE(16)).toBe(crc32(img.subarray(20)));
+  });
+
+  it('stores strings NUL-terminated at their offsets', () => {
+    const img = encodeRuntimeConfig(CONFIG);
+    const { strings } = CONFIG_BIN_OFFSETS;
+    expect(readString(img, strings.agent_id, 64)).toBe(CONFIG.agent_id);
+    expect(readString(img, strings.runtime_url, 256)).toBe(CONFIG.runtime_url);
+    expect(readString(img, strings.wake_word, 64)).toBe('Hey Box');
+    expect(readString(img, strings['wifi_static_ip.gateway'], 16)).toBe('192.168.1.1');
+    expect(readString(img, strings['wifi_static_ip.dns'], 16)).toBe('');
+  });
+
+  it('truncates long strings at a UTF-8 boundary', () => {
+    const img = encodeRuntimeConfig({ ...CONFIG, agent_name: 'Zoë'.repeat(30) });
+    const name = readString(img, CONFIG_BIN_OFFSETS.strings.agent_name, 64);
+    expect(Buffer.byteLength(name)).toBeLessThanOrEqual(63);
+    expect(name).not.toContain('�');
+    expect('Zoë'.repeat(30).startsWith(name)).toBe(true);
+  });
+
+  it('stores theme, voice, display buffer and face styles as enums', () => {
+    const img = encodeRuntimeConfig(CONFIG);
+    const { enums, face } = CONFIG_BIN_OFFSETS;
+    expect([...img.subarray(enums, enums + 3)]).toEqual([7, 3, 1]);
+    expect([...img.subarray(face, face + 6)]).toEqual([1, 2, 2, 2, 4, 4]);
+    expect(img.readUInt32LE(face + 8)).toBe(0x112233);
+    expect(img.readUInt32LE(face + 12)).toBe(0xabcdef);
+    expect(img.readUInt32LE(face + 16)).toBe(0x010203);
+  });
+
+  it('stores the wake threshold as a percentage, and config version 0', () => {
+    const img = encodeRuntimeConfig(CONFIG);
+    const { enums, configVersion } = CONFIG_BIN_OFFSETS;
+    expect([...img.subarray(enums + 3, enums + 8)]).toEqual([90, 0, 0, 0, 0]);
+    expect(img.readUInt32LE(configVersion)).toBe(0);
+  });
+
+  it('falls back to the firmware defaults for unknown or missing values', () => {
+    const img = encodeRuntimeConfig({
+      agent_id: 'a', display_theme: 'neon', tts_voice: 'alloy', wake_cutoff: 1.5,
+    });
+    const { strings, enums, face } = CONFIG_BIN_OFFSETS;
+    expect([...img.subarray(enums, enums + 4)]).toEqual([0, 0, 0, 0]);
+    expect(readString(img, strings.agent_name, 64)).toBe('Elisa Agent');
+    expect(readString(img, strings.wake_word, 64)).toBe('Hi Elisa');
+    expect(img[face]).toBe(0); // no face_descriptor
+  });
+});
+
+// ── Partition ───────────────────────────────────────────────────────────
+
+describe('buildConfigPartitionImage', () => {
+  it('puts the image in slot 0 and leaves the other slot erased', () => {
+    const part = buildConfigPartitionImage(CONFIG);
+    expect(part.length).toBe(CONFIG_BIN_SLOTS * CONFIG_BIN_SLOT_SIZE);
+    expect(part.subarray(0, CONFIG_BIN_SIZE).equals(encodeRuntimeConfig(CONFIG))).toBe(true);
+    expect(part.subarray(CONFIG_BIN_SLOT_SIZE).every((b) => b === 0xff)).toBe(true);
+  });
+});
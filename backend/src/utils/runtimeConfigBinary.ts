@@ -0,0 +1,188 @@
+/**
+ * Compiles runtime_config.json into the binary config image the BOX-3
+ * firmware maps from flash at boot (elisa_config_bin.h).
+ *
+ * The image is a fixed-offset little-endian struct: a header with magic,
+ * version, payload size, generation and CRC-32, then every string field
+ * in a NUL-terminated fixed-size slot, then the display theme, TTS voice,
+ * display buffer and wake thresholds as bytes, the live config version,
+ * and the face descriptor styles as enum bytes. The firmware
+ * uses it in place, so it never mounts SPIFFS or parses JSON on boot;
+ * runtime_config.json stays on SPIFFS as the fallback.
+ *
+ * Field order, sizes and enum orders must match elisa_config.h,
+ * elisa_config_bin.h and elisa_face_style.h.
+ */
+
+import type { FaceDescriptor } from '../models/display.js';
+import { DEFAULT_FACE } from '../models/display.js';
+
+// ── Layout ──────────────────────────────────────────────────────────────
+
+export const CONFIG_BIN_MAGIC = 0x46434c45; // "ELCF"
+export const CONFIG_BIN_VERSION = 3;
+export const CONFIG_BIN_SLOT_SIZE = 0x1000;
+export const CONFIG_BIN_SLOTS = 2;
+
+const HEADER_SIZE = 20;
+
+/** elisa_runtime_config_t string fields in struct order: [key, bytes]. */
+const STRING_FIELDS: Array<[string, number]> = [
+  ['agent_id', 64],
+  ['api_key', 128],
+  ['runtime_url', 256],
+  ['wifi_ssid', 64],
+  ['wifi_password', 64],
+  ['agent_name', 64],
+  ['wake_word', 64],
+  ['openai_api_key', 128],
+  ['anthropic_api_key', 128],
+  ['system_prompt', 512],
+  ['wifi_static_ip.ip', 16],
+  ['wifi_static_ip.gateway', 16],
+  ['wifi_static_ip.netmask', 16],
+  ['wifi_static_ip.dns', 16],
+];
+
+/** Enum tables, index = value stored in the image. */
+export const CONFIG_ENUMS = {
+  display_theme: ['default', 'forest', 'sunset', 'pixel', 'space', 'nature', 'tech', 'candy', 'plain'],
+  tts_voice: ['nova', 'onyx', 'shimmer', 'echo'],
+  display_buffer: ['partial', 'psram_full'],
+  base_shape: ['round', 'square', 'oval'],
+  eye_style: ['dots', 'circles', 'anime', 'pixels', 'sleepy'],
+  eye_size: ['small', 'medium', 'large'],
+  mouth_style: ['line', 'smile', 'zigzag', 'open', 'cat'],
+  expression: ['happy', 'neutral', 'excited', 'shy', 'cool'],
+} as const;
+
+/** Byte offsets within the image (header included). */
+export const CONFIG_BIN_OFFSETS = (() => {
+  const strings: Record<string, number> = {};
+  let off = HEADER_SIZE;
+  for (const [key, size] of STRING_FIELDS) {
+    strings[key] = off;
+    off += size;
+  }
+  // display_theme, tts_voice, display_buffer, wake_cutoff_pct, reserved[4]
+  const enums = off;
+  const configVersion = enums + 8;
+  const face = configVersion + 4;
+  return { strings, enums, configVersion, face, end: face + 20 };
+})();
+
+export const CONFIG_BIN_SIZE = CONFIG_BIN_OFFSETS.end;
+
+// ── CRC ─────────────────────────────────────────────────────────────────
+
+const CRC_TABLE = (() => {
+  const table = new Uint32Array(256);
+  for (let n = 0; n < 256; n++) {
+    let c = n;
+    for (let k = 0; k < 8; k++) c = c & 1 ? 0xedb88320 ^ (c >>> 1) : c >>> 1;
+    table[n] = c >>> 0;
+  }
+  return table;
+})();
+
+/** CRC-32 (IEEE 802.3, as zlib's crc32()). */
+export function crc32(data: Uint8Array): number {
+  let crc = 0xffffffff;
+  for (const byte of data) crc = CRC_TABLE[(crc ^ byte) & 0xff] ^ (crc >>> 8);
+  return (crc ^ 0xffffffff) >>> 0;
+}
+
+// ── Encoding ────────────────────────────────────────────────────────────
+
+function lookupPath(config: Record<string, unknown>, key: string): unknown {
+  return key.split('.').reduce<unknown>(
+    (obj, part) => (obj && typeof obj === 'object' ? (obj as Record<string, unknown>)[part] : undefined),
+    config,
+  );
+}
+
+/** Write a string into a fixed slot, cut at a UTF-8 boundary to leave room for the NUL. */
+function writeString(buf: Buffer, offset: number, size: number, value: unknown): void {
+  if (typeof value !== 'string') return;
+  let bytes = Buffer.from(value, 'utf-8');
+  if (bytes.length > size - 1) {
+    let end = size - 1;
+    while (end > 0 && (bytes[end] & 0xc0) === 0x80) end--;
+    bytes = bytes.subarray(0, end);
+  }
+  bytes.copy(buf, offset);
+}
+
+function enumIndex(names: readonly string[], value: unknown, fallback: string): number {
+  const i = typeof value === 'string' ? names.indexOf(value) : -1;
+  return i >= 0 ? i : names.indexOf(fallback);
+}
+
+/** Probability (0-1] as a whole percentage; anything else is 0, WakeNet's own threshold. */
+function percent(value: unknown): number {
+  return typeof value === 'number' && value > 0 && value <= 1 ? Math.round(value * 100) : 0;
+}
+
+function parseColor(value: unknown, fallback: string): number {
+  const hex = typeof value === 'string' && /^#[0-9a-fA-F]{6}$/.test(value) ? value : fallback;
+  return parseInt(hex.slice(1), 16);
+}
+
+/**
+ * Encode a runtime config object (the output of buildRuntimeConfig, i.e.
+ * runtime_config.json) as one config image. Unknown enum values take the
+ * firmware defaults; strings longer than their slot are truncated.
+ */
+export function encodeRuntimeConfig(config: Record<string, unknown>, generation = 1): Buffer {
+  const buf = Buffer.alloc(CONFIG_BIN_SIZE);
+  const { strings, enums, face } = CONFIG_BIN_OFFSETS;
+
+  for (const [key, size] of STRING_FIELDS) {
+    writeString(buf, strings[key], size, lookupPath(config, key));
+  }
+  // Same defaults as elisa_config.c applies to the JSON
+  if (typeof config.agent_name !== 'string') writeString(buf, strings.agent_name, 64, 'Elisa Agent');
+  if (typeof config.wake_word !== 'string') writeString(buf, strings.wake_word, 64, 'Hi Elisa');
+  if (typeof config.system_prompt !== 'string') {
+    writeString(buf, strings.system_prompt, 512,
+      'You are a helpful voice assistant. Keep responses to 1-2 sentences for natural conversation.');
+  }
+
+  buf[enums] = enumIndex(CONFIG_ENUMS.display_theme, config.display_theme, 'default');
+  buf[enums + 1] = enumIndex(CONFIG_ENUMS.tts_voice, config.tts_voice, 'nova');
+  buf[enums + 2] = enumIndex(CONFIG_ENUMS.display_buffer, config.display_buffer, 'partial');
+  buf[enums + 3] = percent(config.wake_cutoff);
+  // configVersion stays 0: a deployed image starts from the spec, and the
+  // runtime resends every live change made since (deviceConfig.ts)
+
+  const desc = config.face_descriptor as Partial<FaceDescriptor> | undefined;
+  if (desc && typeof desc === 'object') {
+    buf[face] = 1;
+    buf[face + 1] = enumIndex(CONFIG_ENUMS.base_shape, desc.base_shape, DEFAULT_FACE.base_shape);
+    buf[face + 2] = enumIndex(CONFIG_ENUMS.eye_style, desc.eyes?.style, DEFAULT_FACE.eyes.style);
+    buf[face + 3] = enumIndex(CONFIG_ENUMS.eye_size, desc.eyes?.size, DEFAULT_FACE.eyes.size);
+    buf[face + 4] = enumIndex(CONFIG_ENUMS.mouth_style, desc.mouth?.style, DEFAULT_FACE.mouth.style);
+    buf[face + 5] = enumIndex(CONFIG_ENUMS.expression, desc.expression, DEFAULT_FACE.expression);
+    buf.writeUInt32LE(parseColor(desc.eyes?.color, DEFAULT_FACE.eyes.color), face + 8);
+    buf.writeUInt32LE(parseColor(desc.colors?.face, DEFAULT_FACE.colors.face), face + 12);
+    buf.writeUInt32LE(parseColor(desc.colors?.accent, DEFAULT_FACE.colors.accent), face + 16);
+  }
+
+  buf.writeUInt32LE(CONFIG_BIN_MAGIC, 0);
+  buf.writeUInt16LE(CONFIG_BIN_VERSION, 4);
+  buf.writeUInt16LE(HEADER_SIZE, 6);
+  buf.writeUInt32LE(CONFIG_BIN_SIZE - HEADER_SIZE, 8);
+  buf.writeUInt32LE(generation >>> 0, 12);
+  buf.writeUInt32LE(crc32(buf.subarray(HEADER_SIZE)), 16);
+  return buf;
+}
+
+/**
+ * Build the elisa_cfg partition contents: the image in slot 0, the other
+ * slot erased (0xFF), so a fresh deploy always starts from generation 1.
+ */
+export function buildConfigPartitionImage(config: Record<string, unknown>): Buffer {
+  const part = Buffer.alloc(CONFIG_BIN_SLOTS * CONFIG_BIN_SLOT_SIZE, 0xff);
+  encodeRuntimeConfig(config).copy(part, 0);
+  return part;
+}
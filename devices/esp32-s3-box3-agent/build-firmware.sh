@@ -66,7 +66,7 @@ fi
 
 echo ""
 echo "Copying Elisa scaffold files..."
-cp "${SCAFFOLD_DIR}"/elisa_*.{c,h} "${BUILD_DIR}/main/"
+cp "${SCAFFOLD_DIR}"/elisa_*.{c,cc,h} "${BUILD_DIR}/main/"
 
 # Add sample runtime_config.json to SPIFFS
 if [ ! -f "${BUILD_DIR}/spiffs/runtime_config.json" ]; then
@@ -148,18 +148,261 @@ bool ui_ctrl_reply_get_audio_start_flag(void) { return false; }
 void ui_ctrl_reply_set_audio_end_flag(void) {}
 STUBEOF
 
+# ── Step 4e: Shim app_wifi.c ──────────────────────────────────────────
+# Elisa brings up WiFi itself (elisa_wifi.c: cached BSSID/channel directed
+# connect, DHCP lease reuse). chatgpt_demo's app_audio.c still asks
+# wifi_connected_already() before each turn, so forward that here and
+# make app_network_start() a no-op.
+
+echo "Writing app_wifi.c shim..."
+cat > "${BUILD_DIR}/main/app/app_wifi.c" <<'STUBEOF'
+/* Shim: replaces chatgpt_demo's app_wifi.c.
+ * WiFi is owned by elisa_wifi.c; these forward the calls chatgpt_demo's
+ * audio pipeline still makes. */
+
+#include <string.h>
+
+#include "app_wifi.h"
+#include "elisa_wifi.h"
+
+void app_network_start(void) {}
+
+WiFi_Connect_Status wifi_connected_already(void) {
+    return elisa_wifi_is_connected() ? WIFI_STATUS_CONNECTED_OK
+                                     : WIFI_STATUS_CONNECTED_FAILED;
+}
+
+esp_err_t app_wifi_get_wifi_ssid(char *ssid, size_t len) {
+    strncpy(ssid, elisa_wifi_get_ssid(), len - 1);
+    ssid[len - 1] = '\0';
+    return ESP_OK;
+}
+STUBEOF
+
+# ── Step 4f: sdkconfig options ─────────────────────────────────────────
+# set_sdkconfig KEY VALUE: set KEY in sdkconfig.defaults, and in sdkconfig
+# too if a previous build left one (defaults only apply to new keys).
+
+set_sdkconfig() {
+    local key="$1" value="$2" file
+    touch "${BUILD_DIR}/sdkconfig.defaults"
+    for file in "${BUILD_DIR}/sdkconfig.defaults" "${BUILD_DIR}/sdkconfig"; do
+        [ -f "${file}" ] || continue
+        if grep -qE "^${key}=|^# ${key} is not set" "${file}"; then
+            sed -i.bak "s|^${key}=.*|${key}=${value}|; s|^# ${key} is not set|${key}=${value}|" "${file}"
+            rm -f "${file}.bak"
+        else
+            echo "${key}=${value}" >> "${file}"
+        fi
+    done
+}
+
+# Re-request the previous DHCP lease (saved in NVS by lwIP) instead of a
+# full DISCOVER/OFFER exchange, and skip the duplicate address ARP probe.
+set_sdkconfig CONFIG_LWIP_DHCP_RESTORE_LAST_IP y
+set_sdkconfig CONFIG_LWIP_DHCP_DOES_ARP_CHECK n
+
+# Task plan (elisa_tasks.c): WiFi and lwIP on the network core, run-time
+# stats for the TASKS report.
+set_sdkconfig CONFIG_ESP_WIFI_TASK_PINNED_TO_CORE_0 y
+set_sdkconfig CONFIG_LWIP_TCPIP_TASK_AFFINITY_CPU0 y
+set_sdkconfig CONFIG_FREERTOS_USE_TRACE_FACILITY y
+set_sdkconfig CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS y
+
+# The face is one canvas composed from a pre-rendered atlas (elisa_face.c).
+set_sdkconfig CONFIG_LV_USE_CANVAS y
+
+# Reply captions (elisa_caption.c) pre-rasterize this font into PSRAM.
+set_sdkconfig CONFIG_LV_FONT_MONTSERRAT_16 y
+
+# ── Step 4g: Apply the task plan to chatgpt_demo ───────────────────────
+# app_sr.c / app_audio.c create the capture, wake word and SR handler
+# tasks. Compiling them with ELISA_TASKS_OVERRIDE_CREATE routes their
+# xTaskCreate*() calls through elisa_task_create_override(), which takes
+# core, priority and stack from the table in elisa_tasks.c. The audio
+# player task is created inside its component from audio_player_config_t,
+# so that initializer is pointed at the table too.
+
+for app_src in "${BUILD_DIR}/main/app/app_sr.c" "${BUILD_DIR}/main/app/app_audio.c"; do
+    if [ -f "${app_src}" ] && ! grep -q "ELISA_TASKS_OVERRIDE_CREATE" "${app_src}"; then
+        echo "Patching $(basename "${app_src}"): task creation follows elisa_tasks plan..."
+        printf '#define ELISA_TASKS_OVERRIDE_CREATE\n#include "elisa_tasks.h"\n' |
+            cat - "${app_src}" > "${app_src}.tmp" && mv "${app_src}.tmp" "${app_src}"
+    fi
+done
+
+APP_AUDIO="${BUILD_DIR}/main/app/app_audio.c"
+if ! grep -q "ELISA_TASK_AUDIO_PLAYER" "${APP_AUDIO}"; then
+    echo "Patching app_audio.c: audio_player priority/core from elisa_tasks plan..."
+    _AUDIO_PATH="${APP_AUDIO}"
+    if command -v cygpath &>/dev/null; then
+        _AUDIO_PATH="$(cygpath -w "${APP_AUDIO}")"
+    fi
+    python -c "
+import re, sys
+fpath = sys.argv[1]
+with open(fpath, 'r') as f:
+    content = f.read()
+m = re.search(r'(audio_player_config_t\s+\w+\s*=\s*\{)(.*?)(\};)', content, flags=re.DOTALL)
+if not m:
+    print('WARNING: audio_player_config_t initializer not found -- player task keeps its defaults')
+    sys.exit(0)
+body = re.sub(r'\s*\.(priority|coreID)\s*=\s*[^,}]+,?', '', m.group(2)).rstrip().rstrip(',')
+body += (',\n        .priority = elisa_task_spec(ELISA_TASK_AUDIO_PLAYER)->priority'
+         ',\n        .coreID = elisa_task_spec(ELISA_TASK_AUDIO_PLAYER)->core\n    ')
+content = content[:m.start(2)] + body + content[m.end(2):]
+with open(fpath, 'w') as f:
+    f.write(content)
+" "$_AUDIO_PATH"
+fi
+
+# ── Step 4h: Route playback through lip sync ───────────────────────────
+# The audio player writes decoded PCM with bsp_i2s_write() and sets the
+# codec rate with bsp_codec_set_fs(). elisa_lipsync.c wraps both: it
+# analyzes each window on its way to the speaker and posts the mouth
+# shape to the face when the window plays.
+
+if ! grep -q "elisa_lipsync_i2s_write" "${APP_AUDIO}"; then
+    echo "Patching app_audio.c: audio_player output through elisa_lipsync..."
+    _AUDIO_PATH="${APP_AUDIO}"
+    if command -v cygpath &>/dev/null; then
+        _AUDIO_PATH="$(cygpath -w "${APP_AUDIO}")"
+    fi
+    python -c "
+import re, sys
+fpath = sys.argv[1]
+with open(fpath, 'r') as f:
+    content = f.read()
+content, n_write = re.subn(r'(\.write_fn\s*=\s*)bsp_i2s_write\b', r'\1elisa_lipsync_i2s_write', content)
+content, n_clk = re.subn(r'(\.clk_set_fn\s*=\s*)bsp_codec_set_fs\b', r'\1elisa_lipsync_set_fs', content)
+if n_write == 0 or n_clk == 0:
+    print('WARNING: audio_player write_fn/clk_set_fn not found -- no lip sync')
+    sys.exit(0)
+content = '#include \"elisa_lipsync.h\"\n' + content
+with open(fpath, 'w') as f:
+    f.write(content)
+" "$_AUDIO_PATH"
+fi
+
+# ── Step 4i: Route WakeNet through elisa_wakenet ──────────────────────
+# app_sr.c's detect task fetches each AFE frame with afe_handle->fetch().
+# elisa_wakenet_fetch() wraps that call: a detection cancels the running
+# turn and marks the wake time, wake_cutoff updates are applied on that
+# task, and the STATS wake_word line counts frames and detections.
+
+APP_SR="${BUILD_DIR}/main/app/app_sr.c"
+if [ -f "${APP_SR}" ] && ! grep -q "elisa_wakenet_fetch" "${APP_SR}"; then
+    echo "Patching app_sr.c: AFE fetch through elisa_wakenet..."
+    _SR_PATH="${APP_SR}"
+    if command -v cygpath &>/dev/null; then
+        _SR_PATH="$(cygpath -w "${APP_SR}")"
+    fi
+    python -c "
+import re, sys
+fpath = sys.argv[1]
+with open(fpath, 'r') as f:
+    content = f.read()
+content, n = re.subn(r'\bafe_handle->fetch\(\s*(\w+)\s*\)', r'elisa_wakenet_fetch(afe_handle, \1)', content)
+if n == 0:
+    print('WARNING: afe_handle->fetch() not found -- no wake events, thresholds or WakeNet stats')
+    sys.exit(0)
+content = '#include \"elisa_wakenet.h\"\n' + content
+with open(fpath, 'w') as f:
+    f.write(content)
+" "$_SR_PATH"
+fi
+
+# ── Step 4j: Config image and asset partitions ─────────────────────────
+# elisa_config.c maps the compiled runtime config (elisa_config_bin.h)
+# from its own 64 KB data partition, and elisa_assets.c maps the asset
+# image (elisa_assets_bin.h) from a 960 KB one. Both are carved from the
+# end of the SPIFFS "storage" partition so nothing else moves (storage
+# 0x900000 + 0x100000, elisa_assets at 0xA00000, elisa_cfg at 0xAF0000;
+# device.json and deploy-astronaut.sh match). A smaller SPIFFS also
+# mounts faster, on the devices that still mount it.
+
+PARTITIONS_CSV="${BUILD_DIR}/$(grep -s '^CONFIG_PARTITION_TABLE_CUSTOM_FILENAME=' "${BUILD_DIR}/sdkconfig.defaults" | cut -d'"' -f2)"
+[ -f "${PARTITIONS_CSV}" ] || PARTITIONS_CSV="${BUILD_DIR}/partitions.csv"
+if [ -f "${PARTITIONS_CSV}" ] && ! grep -q "^elisa_assets" "${PARTITIONS_CSV}"; then
+    echo "Patching $(basename "${PARTITIONS_CSV}"): elisa_assets and elisa_cfg partitions..."
+    _CSV_PATH="${PARTITIONS_CSV}"
+    if command -v cygpath &>/dev/null; then
+        _CSV_PATH="$(cygpath -w "${PARTITIONS_CSV}")"
+    fi
+    python -c "
+import sys
+ASSETS_SIZE = 0xF0000
+CFG_SIZE = 0x10000
+def num(v):
+    v = v.strip().upper()
+    mult = {'K': 1024, 'M': 1024 * 1024}.get(v[-1:], 1)
+    return int(v[:-1] if mult > 1 else v, 0) * mult
+fpath = sys.argv[1]
+with open(fpath, 'r') as f:
+    lines = f.read().splitlines()
+# A build directory patched before the asset image already has elisa_cfg
+has_cfg = any(line.split(',')[0].strip() == 'elisa_cfg' for line in lines)
+out, done = [], False
+for line in lines:
+    cols = [c.strip() for c in line.split(',')]
+    if not done and cols[0] == 'storage' and len(cols) >= 5 and cols[3]:
+        offset, size = num(cols[3]), num(cols[4]) - ASSETS_SIZE - (0 if has_cfg else CFG_SIZE)
+        cols[4] = hex(size)
+        out.append(', '.join(cols).rstrip())
+        out.append('elisa_assets, data, 0x41, %s, %s,' % (hex(offset + size), hex(ASSETS_SIZE)))
+        if not has_cfg:
+            out.append('elisa_cfg, data, 0x40, %s, %s,' % (hex(offset + size + ASSETS_SIZE), hex(CFG_SIZE)))
+        done = True
+    else:
+        out.append(line)
+if not done:
+    print('WARNING: storage partition not found -- config and assets are read from SPIFFS')
+    sys.exit(0)
+with open(fpath, 'w') as f:
+    f.write('\n'.join(out) + '\n')
+" "$_CSV_PATH"
+fi
+
 # ── Step 5: Patch CMakeLists.txt ───────────────────────────────────────
 
 CMAKELISTS="${BUILD_DIR}/main/CMakeLists.txt"
-if ! grep -q "elisa_config.c" "${CMAKELISTS}"; then
-    echo "Patching main/CMakeLists.txt to include Elisa sources..."
-    sed -i.bak 's|"main.c"|"main.c"\n        "elisa_config.c"\n        "elisa_api.c"\n        "elisa_face.c"\n        "elisa_main.c"\n        "elisa_opus.cc"|' "${CMAKELISTS}"
-    rm -f "${CMAKELISTS}.bak"
-elif ! grep -q "elisa_opus.cc" "${CMAKELISTS}"; then
-    echo "Adding elisa_opus.cc to main/CMakeLists.txt..."
-    sed -i.bak 's|"elisa_main.c"|"elisa_main.c"\n        "elisa_opus.cc"|' "${CMAKELISTS}"
-    rm -f "${CMAKELISTS}.bak"
-fi
+ELISA_SOURCES=(
+    "elisa_config.c"
+    "elisa_config_bin.c"
+    "elisa_assets.c"
+    "elisa_assets_bin.c"
+    "elisa_api.c"
+    "elisa_face.c"
+    "elisa_ui_timer.c"
+    "elisa_face_atlas.c"
+    "elisa_dirty.c"
+    "elisa_anim.c"
+    "elisa_draw.c"
+    "elisa_face_style.c"
+    "elisa_viseme.c"
+    "elisa_lipsync.c"
+    "elisa_wakenet.c"
+    "elisa_caption_text.c"
+    "elisa_caption.c"
+    "elisa_main.c"
+    "elisa_opus.cc"
+    "elisa_cancel.c"
+    "elisa_trace.c"
+    "elisa_telemetry.c"
+    "elisa_latency.c"
+    "elisa_wifi.c"
+    "elisa_tasks.c"
+    "elisa_frame.c"
+    "elisa_capture.c"
+    "elisa_rice.c"
+)
+for src in "${ELISA_SOURCES[@]}"; do
+    if ! grep -q "\"${src}\"" "${CMAKELISTS}"; then
+        echo "Adding ${src} to main/CMakeLists.txt..."
+        sed -i.bak "s|\"main.c\"|\"main.c\"\n        \"${src}\"|" "${CMAKELISTS}"
+        rm -f "${CMAKELISTS}.bak"
+    fi
+done
 
 # Remove factory_nvs dependency (we use SPIFFS runtime_config.json instead)
 if grep -q "factory_nvs" "${CMAKELISTS}"; then
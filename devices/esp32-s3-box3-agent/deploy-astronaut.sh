@@ -42,11 +42,22 @@ FLASH_FREQ="80m"
 
 # SPIFFS partition config (from device.json)
 SPIFFS_OFFSET="0x900000"
-SPIFFS_SIZE="0x200000"
+SPIFFS_SIZE="0x100000"
 SPIFFS_PAGE_SIZE=256
 SPIFFS_OBJ_NAME_LEN=32
 SPIFFS_META_LEN=4
 
+# Config image partition (elisa_cfg). Flashed erased, so the firmware
+# falls back to the SPIFFS runtime_config.json written below instead of
+# an image left by an earlier Elisa deploy.
+CONFIG_OFFSET="0xaf0000"
+CONFIG_ERASED_SIZE=8192
+
+# Asset image partition (elisa_assets). Its header is erased for the same
+# reason: an earlier deploy's image also carries a runtime_config.json.
+ASSETS_OFFSET="0xa00000"
+ASSETS_ERASED_SIZE=4096
+
 # ── Parse Arguments ──────────────────────────────────────────────────────
 
 while [[ $# -gt 0 ]]; do
@@ -247,6 +258,14 @@ fi
 
 echo "  SPIFFS image: $(du -h "$SPIFFS_IMAGE" | cut -f1)"
 
+CONFIG_IMAGE="${TEMP_DIR}/elisa_cfg.bin"
+$PYTHON_CMD -c "import sys; open(sys.argv[1], 'wb').write(b'\xff' * int(sys.argv[2]))" \
+    "$CONFIG_IMAGE" "$CONFIG_ERASED_SIZE"
+
+ASSETS_IMAGE="${TEMP_DIR}/elisa_assets.bin"
+$PYTHON_CMD -c "import sys; open(sys.argv[1], 'wb').write(b'\xff' * int(sys.argv[2]))" \
+    "$ASSETS_IMAGE" "$ASSETS_ERASED_SIZE"
+
 if $SKIP_FLASH; then
     echo ""
     echo "SPIFFS image at: $SPIFFS_IMAGE"
@@ -265,6 +284,8 @@ echo "  0x008000  partition-table.bin"
 echo "  0x00d000  ota_data_initial.bin"
 echo "  0x010000  box3-agent.bin (app)"
 echo "  0x900000  storage.bin (SPIFFS -- astronaut config)"
+echo "  0xa00000  elisa_assets.bin (erased header -- no asset image)"
+echo "  0xaf0000  elisa_cfg.bin (erased -- firmware reads the SPIFFS config)"
 echo "  0xb00000  srmodels.bin (wake word model)"
 echo ""
 
@@ -283,6 +304,8 @@ $ESPTOOL \
     0xd000   "${PARTITIONS_DIR}/ota_data_initial.bin" \
     0x10000  "${FIRMWARE_DIR}/box3-agent.bin" \
     0x900000 "$SPIFFS_IMAGE" \
+    "$ASSETS_OFFSET" "$ASSETS_IMAGE" \
+    "$CONFIG_OFFSET" "$CONFIG_IMAGE" \
     0xb00000 "${PARTITIONS_DIR}/srmodels.bin"
 
 echo ""
@@ -0,0 +1,180 @@
+/**
+ * @file elisa_anim.c
+ * @brief Keyframe evaluation, easing table and blended players.
+ */
+
+#include "elisa_anim.h"
+
+#include <stddef.h>
+
+/* Easing table: 64 segments over 0..ELISA_EASE_ONE */
+#define EASE_SEGMENT_BITS  9
+#define EASE_SEGMENT_MASK  ((1 << EASE_SEGMENT_BITS) - 1)
+#define EASE_POINTS        65
+
+// ── Easing ──────────────────────────────────────────────────────────────
+
+/** Generated offline from the formulas noted on each curve, Q15. */
+static const uint16_t s_ease_lut[ELISA_EASE_COUNT][EASE_POINTS] = {
+    [ELISA_EASE_IN] = { /* Cubic ease-in: x^3 */
+            0,     0,     1,     3,     8,    16,    27,    43,
+           64,    91,   125,   166,   216,   275,   343,   422,
+          512,   614,   729,   857,  1000,  1158,  1331,  1521,
+         1728,  1953,  2197,  2460,  2744,  3049,  3375,  3724,
+         4096,  4492,  4913,  5359,  5832,  6332,  6859,  7415,
+         8000,  8615,  9261,  9938, 10648, 11391, 12167, 12978,
+        13824, 14706, 15625, 16581, 17576, 18610, 19683, 20797,
+        21952, 23149, 24389, 25672, 27000, 28373, 29791, 31256,
+        32768,
+    },
+    [ELISA_EASE_OUT] = { /* Cubic ease-out: 1 - (1 - x)^3 */
+            0,  1512,  2977,  4395,  5768,  7096,  8379,  9619,
+        10816, 11971, 13085, 14158, 15192, 16187, 17143, 18062,
+        18944, 19790, 20601, 21377, 22120, 22830, 23507, 24153,
+        24768, 25353, 25909, 26436, 26936, 27409, 27855, 28276,
+        28672, 29044, 29393, 29719, 30024, 30308, 30571, 30815,
+        31040, 31247, 31437, 31610, 31768, 31911, 32039, 32154,
+        32256, 32346, 32425, 32493, 32552, 32602, 32643, 32677,
+        32704, 32725, 32741, 32752, 32760, 32765, 32767, 32768,
+        32768,
+    },
+    [ELISA_EASE_IN_OUT] = { /* Half cosine: (1 - cos(pi x)) / 2 */
+            0,    20,    79,   177,   315,   491,   705,   958,
+         1247,  1573,  1935,  2331,  2761,  3224,  3719,  4244,
+         4799,  5381,  5990,  6624,  7282,  7961,  8661,  9379,
+        10114, 10864, 11628, 12403, 13188, 13980, 14778, 15580,
+        16384, 17188, 17990, 18788, 19580, 20365, 21140, 21904,
+        22654, 23389, 24107, 24807, 25486, 26144, 26778, 27387,
+        27969, 28524, 29049, 29544, 30007, 30437, 30833, 31195,
+        31521, 31810, 32063, 32277, 32453, 32591, 32689, 32748,
+        32768,
+    },
+};
+
+int32_t elisa_ease(elisa_ease_t ease, int32_t x) {
+    if (x <= 0) return 0;
+    if (x >= ELISA_EASE_ONE) return ELISA_EASE_ONE;
+
+    switch (ease) {
+    case ELISA_EASE_STEP:
+        return 0;
+    case ELISA_EASE_IN:
+    case ELISA_EASE_OUT:
+    case ELISA_EASE_IN_OUT: {
+        const uint16_t *lut = s_ease_lut[ease];
+        int32_t i = x >> EASE_SEGMENT_BITS;
+        int32_t frac = x & EASE_SEGMENT_MASK;
+        return lut[i] + (((lut[i + 1] - lut[i]) * frac) >> EASE_SEGMENT_BITS);
+    }
+    default:
+        return x;
+    }
+}
+
+/** a + (b - a) * ease(x). */
+static int32_t lerp(int32_t a, int32_t b, elisa_ease_t ease, int32_t x) {
+    return a + (int32_t)(((int64_t)(b - a) * elisa_ease(ease, x)) / ELISA_EASE_ONE);
+}
+
+// ── Tracks ──────────────────────────────────────────────────────────────
+
+static uint32_t track_end(const elisa_anim_track_t *track) {
+    return track->count ? track->keys[track->count - 1].t_ms : 0;
+}
+
+int32_t elisa_anim_track_eval(const elisa_anim_track_t *track, uint32_t t_ms) {
+    if (track == NULL || track->count == 0) return 0;
+
+    const elisa_keyframe_t *k = track->keys;
+    uint32_t end = track_end(track);
+    if (track->loop && end > 0) t_ms %= end;
+    if (t_ms >= end) return k[track->count - 1].value;
+
+    int i = 1;
+    while (t_ms >= k[i].t_ms) i++;
+    const elisa_keyframe_t *a = &k[i - 1], *b = &k[i];
+    int32_t x = (int32_t)(((t_ms - a->t_ms) << 15) / (uint32_t)(b->t_ms - a->t_ms));
+    return lerp(a->value, b->value, (elisa_ease_t)b->ease, x);
+}
+
+// ── Players ─────────────────────────────────────────────────────────────
+
+static int32_t value_at(const elisa_anim_player_t *p, uint32_t t_ms) {
+    int32_t v = elisa_anim_track_eval(p->track, t_ms);
+    if (t_ms < p->blend_ms) {
+        int32_t x = (int32_t)((t_ms << 15) / p->blend_ms);
+        v = lerp(p->from, v, (elisa_ease_t)p->blend_ease, x);
+    }
+    return v;
+}
+
+static int to_frame(int32_t v) {
+    return (int)((v + ELISA_ANIM_ONE / 2) >> 8);
+}
+
+/** True once nothing about the value can change after t_ms. */
+static bool settled_at(const elisa_anim_player_t *p, uint32_t t_ms) {
+    if (p->track == NULL) return true;
+    if (t_ms < p->blend_ms) return false;
+    if (p->track->loop && track_end(p->track) > 0) return false;
+    return t_ms >= track_end(p->track);
+}
+
+void elisa_anim_start(elisa_anim_player_t *p, const elisa_anim_track_t *track) {
+    p->track = track;
+    p->t_ms = 0;
+    p->from = 0;
+    p->blend_ms = 0;
+    p->blend_ease = ELISA_EASE_LINEAR;
+}
+
+void elisa_anim_play(elisa_anim_player_t *p, const elisa_anim_track_t *track,
+                     uint16_t blend_ms, elisa_ease_t blend_ease) {
+    int32_t from = (p->track != NULL) ? elisa_anim_value(p) : elisa_anim_track_eval(track, 0);
+    p->track = track;
+    p->t_ms = 0;
+    p->from = from;
+    p->blend_ms = blend_ms;
+    p->blend_ease = (uint8_t)blend_ease;
+}
+
+void elisa_anim_advance(elisa_anim_player_t *p, uint32_t elapsed_ms) {
+    if (p->track == NULL) return;
+    p->t_ms += elapsed_ms;
+
+    uint32_t end = track_end(p->track);
+    if (p->t_ms < p->blend_ms) return;
+    if (!p->track->loop || end == 0) {
+        /* Holding the last value: park the clock so it cannot wrap */
+        uint32_t park = (end > p->blend_ms) ? end : p->blend_ms;
+        if (p->t_ms > park) p->t_ms = park;
+    } else if (p->t_ms - p->blend_ms >= end) {
+        /* Drop whole periods, keeping the phase */
+        p->t_ms -= ((p->t_ms - p->blend_ms) / end) * end;
+    }
+}
+
+bool elisa_anim_settled(const elisa_anim_player_t *p) {
+    return settled_at(p, p->t_ms);
+}
+
+int32_t elisa_anim_value(const elisa_anim_player_t *p) {
+    return value_at(p, p->t_ms);
+}
+
+int elisa_anim_frame(const elisa_anim_player_t *p) {
+    return to_frame(elisa_anim_value(p));
+}
+
+uint32_t elisa_anim_next_change(const elisa_anim_player_t *p, uint32_t step_ms,
+                                uint32_t max_ms) {
+    if (settled_at(p, p->t_ms)) return ELISA_ANIM_SETTLED;
+
+    int now = to_frame(value_at(p, p->t_ms));
+    for (uint32_t dt = step_ms; dt < max_ms; dt += step_ms) {
+        uint32_t t = p->t_ms + dt;
+        if (to_frame(value_at(p, t)) != now) return dt;
+        if (settled_at(p, t)) return ELISA_ANIM_SETTLED;
+    }
+    return max_ms;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file elisa_anim.h
+ * @brief Fixed-point keyframe tracks for face animation.
+ *
+ * A track is a short list of keyframes: a time, a value and the easing
+ * curve used to reach that value from the previous key. Tracks either
+ * hold their last value or loop. A player runs one track for one face
+ * element and, when switched to a new track, blends from whatever value
+ * it was showing into the new track over a given time, so every state
+ * transition is smooth without per-state code.
+ *
+ * Everything is integer: values are Q8 (an atlas frame index times 256),
+ * easing is a 65-entry Q15 lookup table with linear interpolation.
+ *
+ * Plain C with no LVGL or ESP-IDF dependency so host tools can share it.
+ */
+
+#ifndef ELISA_ANIM_H
+#define ELISA_ANIM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** One unit of a track value (values are Q8). */
+#define ELISA_ANIM_ONE      256
+
+/** Q8 value of v units. */
+#define ELISA_ANIM_Q(v)     ((int16_t)((v) * ELISA_ANIM_ONE))
+
+/** One in the Q15 domain of elisa_ease(). */
+#define ELISA_EASE_ONE      32768
+
+/** elisa_anim_next_change(): the value cannot change any more. */
+#define ELISA_ANIM_SETTLED  0
+
+/** Easing curve of a keyframe segment. */
+typedef enum {
+    ELISA_EASE_STEP,      /**< Hold the previous value, jump at the key */
+    ELISA_EASE_LINEAR,
+    ELISA_EASE_IN,        /**< Cubic, slow start */
+    ELISA_EASE_OUT,       /**< Cubic, slow finish */
+    ELISA_EASE_IN_OUT,    /**< Half cosine; a looped in-out track is a sine */
+    ELISA_EASE_COUNT,
+} elisa_ease_t;
+
+typedef struct {
+    uint16_t t_ms;        /**< Time from the track start; the first key is 0 */
+    int16_t value;        /**< Q8 */
+    uint8_t ease;         /**< elisa_ease_t from the previous key into this one */
+} elisa_keyframe_t;
+
+typedef struct {
+    const elisa_keyframe_t *keys;
+    uint8_t count;
+    bool loop;            /**< Repeat every keys[count - 1].t_ms */
+} elisa_anim_track_t;
+
+/** Plays one track, blending in from the previous one. */
+typedef struct {
+    const elisa_anim_track_t *track;
+    uint32_t t_ms;        /**< Time into the track */
+    int32_t from;         /**< Value shown when the track started (Q8) */
+    uint16_t blend_ms;    /**< Length of the blend from `from` */
+    uint8_t blend_ease;
+} elisa_anim_player_t;
+
+/** Eased progress (Q15) at x (Q15, clamped to 0..ELISA_EASE_ONE). */
+int32_t elisa_ease(elisa_ease_t ease, int32_t x);
+
+/** Track value (Q8) at t_ms. */
+int32_t elisa_anim_track_eval(const elisa_anim_track_t *track, uint32_t t_ms);
+
+/** Start a player on track with no blend. */
+void elisa_anim_start(elisa_anim_player_t *p, const elisa_anim_track_t *track);
+
+/**
+ * Switch a running player to track, blending from its current value over
+ * blend_ms with the given curve. Switching to the track already playing
+ * restarts it, still blended.
+ */
+void elisa_anim_play(elisa_anim_player_t *p, const elisa_anim_track_t *track,
+                     uint16_t blend_ms, elisa_ease_t blend_ease);
+
+/** Advance a player by elapsed ms. */
+void elisa_anim_advance(elisa_anim_player_t *p, uint32_t elapsed_ms);
+
+/** True once the blend is over and the track holds its last value. */
+bool elisa_anim_settled(const elisa_anim_player_t *p);
+
+/** Current value (Q8). */
+int32_t elisa_anim_value(const elisa_anim_player_t *p);
+
+/** Current value rounded to whole units (an atlas frame index). */
+int elisa_anim_frame(const elisa_anim_player_t *p);
+
+/**
+ * Milliseconds until elisa_anim_frame() changes, probing every step_ms up
+ * to max_ms (returns max_ms if it does not change before then), or
+ * ELISA_ANIM_SETTLED when the blend is over and the track holds its value.
+ */
+uint32_t elisa_anim_next_change(const elisa_anim_player_t *p, uint32_t step_ms,
+                                uint32_t max_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ELISA_ANIM_H */
@@ -19,11 +19,15 @@
  */
 
 #include "elisa_api.h"
+#include "elisa_trace.h"
+#include "elisa_telemetry.h"
+#include "elisa_latency.h"
 
 #include <stdlib.h>
 #include <string.h>
 
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "esp_http_client.h"
 #include "esp_crt_bundle.h"
 #include "cJSON.h"
@@ -44,6 +48,12 @@ static bool s_initialized = false;
 /** HTTP timeout in milliseconds */
 #define HTTP_TIMEOUT_MS 30000
 
+/** Connect timeout for cancellable requests (connect itself is not polled) */
+#define HTTP_CONNECT_TIMEOUT_MS 5000
+
+/** Upload chunk size for cancellable requests */
+#define HTTP_UPLOAD_CHUNK 4096
+
 // ── HTTP Response Accumulator ───────────────────────────────────────────
 
 /**
@@ -59,8 +69,40 @@ typedef struct {
     char x_audio_format[16];
     char x_response_text[1024];
     char x_session_id[128];
+    /* When true the body is read via esp_http_client_read() instead of events */
+    bool read_body;
+    /* Set on the first response header (time-to-first-byte trace point) */
+    bool headers_seen;
 } http_response_ctx_t;
 
+/**
+ * Append a chunk of response body to the accumulator, growing it as needed.
+ * Returns ESP_FAIL if the body exceeds MAX_RESPONSE_SIZE or allocation fails.
+ */
+static esp_err_t response_ctx_append(http_response_ctx_t *ctx, const void *data, size_t len) {
+    if (ctx->body_len + len > MAX_RESPONSE_SIZE) {
+        ESP_LOGE(TAG, "Response exceeds %d bytes limit", MAX_RESPONSE_SIZE);
+        return ESP_FAIL;
+    }
+    if (ctx->body == NULL) {
+        ctx->body_capacity = (len > 4096) ? len * 2 : 4096;
+        ctx->body = (char *)malloc(ctx->body_capacity);
+    } else if (ctx->body_len + len > ctx->body_capacity) {
+        ctx->body_capacity = (ctx->body_len + len) * 2;
+        char *new_body = (char *)realloc(ctx->body, ctx->body_capacity);
+        if (new_body == NULL) {
+            free(ctx->body);
+            ctx->body = NULL;
+            return ESP_FAIL;
+        }
+        ctx->body = new_body;
+    }
+    if (ctx->body == NULL) return ESP_FAIL;
+    memcpy(ctx->body + ctx->body_len, data, len);
+    ctx->body_len += len;
+    return ESP_OK;
+}
+
 /**
  * HTTP event handler that accumulates response body data and captures headers.
  * Attached to esp_http_client via event_handler + user_data.
@@ -70,7 +112,14 @@ static esp_err_t http_event_handler(esp_http_client_event_t *evt) {
     if (ctx == NULL) return ESP_OK;
 
     switch (evt->event_id) {
+    case HTTP_EVENT_ON_CONNECTED:
+        elisa_trace(TRACE_HTTP_CONNECTED, TRACE_PH_INSTANT, 0);
+        break;
     case HTTP_EVENT_ON_HEADER:
+        if (!ctx->headers_seen) {
+            ctx->headers_seen = true;
+            elisa_trace(TRACE_HTTP_HEADERS, TRACE_PH_INSTANT, 0);
+        }
         if (strcasecmp(evt->header_key, "Content-Type") == 0) {
             strncpy(ctx->content_type, evt->header_value, sizeof(ctx->content_type) - 1);
         } else if (strcasecmp(evt->header_key, "X-Audio-Format") == 0) {
@@ -82,33 +131,110 @@ static esp_err_t http_event_handler(esp_http_client_event_t *evt) {
         }
         break;
     case HTTP_EVENT_ON_DATA:
-        if (ctx->body_len + evt->data_len > MAX_RESPONSE_SIZE) {
-            ESP_LOGE(TAG, "Response exceeds %d bytes limit", MAX_RESPONSE_SIZE);
-            return ESP_FAIL;
-        }
-        if (ctx->body == NULL) {
-            ctx->body_capacity = (evt->data_len > 4096) ? evt->data_len * 2 : 4096;
-            ctx->body = (char *)malloc(ctx->body_capacity);
-        } else if (ctx->body_len + evt->data_len > ctx->body_capacity) {
-            ctx->body_capacity = (ctx->body_len + evt->data_len) * 2;
-            char *new_body = (char *)realloc(ctx->body, ctx->body_capacity);
-            if (new_body == NULL) {
-                free(ctx->body);
-                ctx->body = NULL;
-                return ESP_FAIL;
-            }
-            ctx->body = new_body;
-        }
-        if (ctx->body == NULL) return ESP_FAIL;
-        memcpy(ctx->body + ctx->body_len, evt->data, evt->data_len);
-        ctx->body_len += evt->data_len;
-        break;
+        if (ctx->read_body) break; /* collected by http_perform_cancellable() */
+        return response_ctx_append(ctx, evt->data, (size_t)evt->data_len);
     default:
         break;
     }
     return ESP_OK;
 }
 
+// ── Cancellable Request ─────────────────────────────────────────────────
+
+/**
+ * Run a POST request in small blocking steps instead of esp_http_client_perform().
+ *
+ * After connecting, the socket timeout is dropped to ELISA_CANCEL_POLL_MS so
+ * every write/read returns at least that often; between steps the cancel
+ * token and the overall HTTP_TIMEOUT_MS deadline are checked. Headers still
+ * arrive through http_event_handler; the body is appended to @p ctx here.
+ *
+ * @return ESP_OK, ESP_ERR_TIMEOUT, ESP_ERR_INVALID_STATE (cancelled) or
+ *         another esp_err_t from the HTTP client
+ */
+static esp_err_t http_perform_cancellable(esp_http_client_handle_t client,
+                                          http_response_ctx_t *ctx,
+                                          const uint8_t *body, size_t body_len,
+                                          elisa_cancel_token_t cancel) {
+    const int64_t deadline_us = esp_timer_get_time() + (int64_t)HTTP_TIMEOUT_MS * 1000;
+    ctx->read_body = true;
+
+    esp_err_t err = esp_http_client_open(client, (int)body_len);
+    if (err != ESP_OK) {
+        return err;
+    }
+    esp_http_client_set_timeout_ms(client, ELISA_CANCEL_POLL_MS);
+
+    /* Upload in chunks so a cancel lands between writes */
+    elisa_trace(TRACE_UPLOAD, TRACE_PH_BEGIN, (uint32_t)body_len);
+    elisa_latency_record_since_wake(LAT_WAKE_TO_UPLOAD);
+    int64_t upload_start_us = esp_timer_get_time();
+    size_t sent = 0;
+    while (err == ESP_OK && sent < body_len) {
+        if (elisa_turn_cancelled(cancel)) { err = ESP_ERR_INVALID_STATE; break; }
+        if (esp_timer_get_time() > deadline_us) { err = ESP_ERR_TIMEOUT; break; }
+
+        size_t chunk = body_len - sent;
+        if (chunk > HTTP_UPLOAD_CHUNK) chunk = HTTP_UPLOAD_CHUNK;
+        int written = esp_http_client_write(client, (const char *)body + sent, (int)chunk);
+        if (written < 0) {
+            err = ESP_FAIL;
+            break;
+        }
+        sent += (size_t)written; /* 0 means the socket was not writable yet */
+    }
+    elisa_trace(TRACE_UPLOAD, TRACE_PH_END, (uint32_t)sent);
+    if (err != ESP_OK) return err;
+    elisa_mem_sample(MEM_STAGE_UPLOAD);
+    int64_t upload_end_us = esp_timer_get_time();
+    elisa_latency_record(LAT_UPLOAD, upload_end_us - upload_start_us);
+
+    /* Wait for the server: this is where STT + LLM + TTS time is spent */
+    elisa_trace(TRACE_SERVER, TRACE_PH_BEGIN, 0);
+    int64_t content_length;
+    while ((content_length = esp_http_client_fetch_headers(client)) == -ESP_ERR_HTTP_EAGAIN) {
+        if (elisa_turn_cancelled(cancel)) { err = ESP_ERR_INVALID_STATE; break; }
+        if (esp_timer_get_time() > deadline_us) { err = ESP_ERR_TIMEOUT; break; }
+    }
+    if (err == ESP_OK && content_length < 0) {
+        err = ESP_FAIL;
+    }
+    elisa_trace(TRACE_SERVER, TRACE_PH_END, (uint32_t)(content_length > 0 ? content_length : 0));
+    if (err != ESP_OK) return err;
+    elisa_latency_record(LAT_TTFB, esp_timer_get_time() - upload_end_us);
+
+    /* Download. Zero-length reads are timeouts unless the body is close-delimited. */
+    elisa_trace(TRACE_DOWNLOAD, TRACE_PH_BEGIN, 0);
+    bool framed = (content_length > 0) || esp_http_client_is_chunked_response(client);
+    char chunk_buf[1024];
+    while (!esp_http_client_is_complete_data_received(client)) {
+        if (elisa_turn_cancelled(cancel)) { err = ESP_ERR_INVALID_STATE; break; }
+        if (esp_timer_get_time() > deadline_us) { err = ESP_ERR_TIMEOUT; break; }
+
+        int n = esp_http_client_read(client, chunk_buf, sizeof(chunk_buf));
+        if (n == -ESP_ERR_HTTP_EAGAIN || (n == 0 && framed)) {
+            continue;
+        }
+        if (n < 0) {
+            err = ESP_FAIL;
+            break;
+        }
+        if (n == 0) {
+            break;
+        }
+        if (response_ctx_append(ctx, chunk_buf, (size_t)n) != ESP_OK) {
+            err = ESP_FAIL;
+            break;
+        }
+    }
+    elisa_trace(TRACE_DOWNLOAD, TRACE_PH_END, (uint32_t)ctx->body_len);
+    if (err == ESP_OK) {
+        elisa_mem_sample(MEM_STAGE_DOWNLOAD);
+    }
+
+    return err;
+}
+
 // ── Helper: Build full URL ──────────────────────────────────────────────
 
 /**
@@ -168,7 +294,8 @@ int elisa_api_init(const elisa_runtime_config_t *config) {
 }
 
 int elisa_api_audio_turn(const uint8_t *audio_data, size_t audio_len,
-                         elisa_turn_response_t *response) {
+                         elisa_turn_response_t *response,
+                         elisa_cancel_token_t cancel) {
     if (!s_initialized || response == NULL) {
         return -1;
     }
@@ -185,7 +312,7 @@ int elisa_api_audio_turn(const uint8_t *audio_data, size_t audio_len,
     esp_http_client_config_t http_config = {
         .url = url,
         .method = HTTP_METHOD_POST,
-        .timeout_ms = HTTP_TIMEOUT_MS,
+        .timeout_ms = HTTP_CONNECT_TIMEOUT_MS,
         .buffer_size = 4096,
         .event_handler = http_event_handler,
         .user_data = &resp_ctx,
@@ -202,19 +329,23 @@ int elisa_api_audio_turn(const uint8_t *audio_data, size_t audio_len,
     esp_http_client_set_header(client, "x-api-key", s_api_key);
     esp_http_client_set_header(client, "Accept", "audio/opus, application/octet-stream");
 
-    /* Set audio as POST body */
-    esp_http_client_set_post_field(client, (const char *)audio_data, (int)audio_len);
-
-    /* Execute request */
-    esp_err_t err = esp_http_client_perform(client);
+    /* Execute request (audio is streamed as the POST body) */
+    esp_err_t err = http_perform_cancellable(client, &resp_ctx, audio_data, audio_len, cancel);
     if (err != ESP_OK) {
-        ESP_LOGE(TAG, "HTTP request failed: %s", esp_err_to_name(err));
+        bool cancelled = (err == ESP_ERR_INVALID_STATE);
+        if (cancelled) {
+            ESP_LOGW(TAG, "Audio turn cancelled");
+        } else {
+            ESP_LOGE(TAG, "HTTP request failed: %s", esp_err_to_name(err));
+        }
         free(resp_ctx.body);
+        esp_http_client_close(client);
         esp_http_client_cleanup(client);
-        return -1;
+        return cancelled ? ELISA_CANCELLED : -1;
     }
 
     response->status_code = esp_http_client_get_status_code(client);
+    esp_http_client_close(client);
     esp_http_client_cleanup(client);
 
     if (response->status_code != 200 || resp_ctx.body == NULL || resp_ctx.body_len == 0) {
@@ -355,6 +486,142 @@ int elisa_api_heartbeat(elisa_heartbeat_t *result) {
     return 0;
 }
 
+// ── Heartbeat Report ────────────────────────────────────────────────────
+
+/**
+ * Build the heartbeat report body:
+ * {"uptime_s":N,"config_version":N,"latency":{"ttfb":{"count":N,"sum_ms":N,
+ *   "max_ms":N,"buckets":[[upper_ms,count],...]},...},"memory":{...}}
+ * Only non-empty buckets are sent. Returns a malloc'd string or NULL.
+ */
+static char *build_heartbeat_body(const elisa_latency_hist_t hists[LAT_METRIC_COUNT]) {
+    cJSON *root = cJSON_CreateObject();
+    if (root == NULL) return NULL;
+
+    cJSON_AddNumberToObject(root, "uptime_s", (double)(esp_timer_get_time() / 1000000));
+    cJSON_AddNumberToObject(root, "config_version", elisa_get_config()->config_version);
+
+    cJSON *latency = cJSON_AddObjectToObject(root, "latency");
+    for (int m = 0; m < LAT_METRIC_COUNT; m++) {
+        const elisa_latency_hist_t *h = &hists[m];
+        cJSON *metric = cJSON_AddObjectToObject(latency, elisa_latency_metric_name((elisa_latency_metric_t)m));
+        cJSON_AddNumberToObject(metric, "count", h->total);
+        cJSON_AddNumberToObject(metric, "sum_ms", h->sum_ms);
+        cJSON_AddNumberToObject(metric, "max_ms", h->max_ms);
+        cJSON *buckets = cJSON_AddArrayToObject(metric, "buckets");
+        for (int i = 0; i < ELISA_LAT_BUCKETS; i++) {
+            if (h->counts[i] == 0) continue;
+            cJSON *pair = cJSON_CreateArray();
+            cJSON_AddItemToArray(pair, cJSON_CreateNumber(elisa_latency_bucket_upper_ms(i)));
+            cJSON_AddItemToArray(pair, cJSON_CreateNumber(h->counts[i]));
+            cJSON_AddItemToArray(buckets, pair);
+        }
+    }
+
+    elisa_mem_report_t mem;
+    elisa_mem_get_report(&mem);
+    cJSON *memory = cJSON_AddObjectToObject(root, "memory");
+    cJSON_AddNumberToObject(memory, "turns", mem.turns);
+    cJSON_AddNumberToObject(memory, "internal_total", mem.internal_total);
+    cJSON_AddNumberToObject(memory, "spiram_total", mem.spiram_total);
+    cJSON_AddNumberToObject(memory, "internal_max_peak", mem.max_internal.peak_used);
+    cJSON_AddNumberToObject(memory, "spiram_max_peak", mem.max_spiram.peak_used);
+    cJSON_AddNumberToObject(memory, "internal_min_free_ever",
+                            mem.stage_low[MEM_STAGE_TURN_END].internal.min_free_ever);
+    cJSON_AddNumberToObject(memory, "spiram_min_free_ever",
+                            mem.stage_low[MEM_STAGE_TURN_END].spiram.min_free_ever);
+    cJSON_AddNumberToObject(memory, "failed_allocs", mem.failed_allocs);
+
+    char *body = cJSON_PrintUnformatted(root);
+    cJSON_Delete(root);
+    return body;
+}
+
+/**
+ * Apply the live config update a heartbeat response carries when the
+ * runtime has a newer config version than we reported:
+ * {..., "config": {"version": N, "changes": {"wake_cutoff": 0.9, ...}}}
+ */
+static void apply_config_update(const char *json) {
+    cJSON *root = cJSON_Parse(json);
+    if (root == NULL) return;
+
+    const cJSON *config = cJSON_GetObjectItemCaseSensitive(root, "config");
+    const cJSON *version = cJSON_GetObjectItemCaseSensitive(config, "version");
+    const cJSON *changes = cJSON_GetObjectItemCaseSensitive(config, "changes");
+    if (cJSON_IsNumber(version) && cJSON_IsObject(changes)) {
+        if (elisa_config_apply_update(changes, (uint32_t)version->valuedouble) != 0) {
+            ESP_LOGW(TAG, "Config update %.0f not applied -- runtime will resend it",
+                     version->valuedouble);
+        }
+    }
+    cJSON_Delete(root);
+}
+
+int elisa_api_report_heartbeat(elisa_heartbeat_t *result) {
+    if (!s_initialized || result == NULL) {
+        return -1;
+    }
+
+    memset(result, 0, sizeof(*result));
+
+    /* Take this interval's histograms; they go back if the report fails.
+     * Static: ~1.2 KB is too much for the caller's stack. */
+    static elisa_latency_hist_t hists[LAT_METRIC_COUNT];
+    elisa_latency_take(hists);
+
+    char *body = build_heartbeat_body(hists);
+    if (body == NULL) {
+        elisa_latency_restore(hists);
+        return -1;
+    }
+
+    char url[512];
+    build_url(url, sizeof(url), "heartbeat");
+
+    /* Static for the same reason; the response may carry a config update */
+    static http_response_ctx_t resp_ctx;
+    memset(&resp_ctx, 0, sizeof(resp_ctx));
+
+    esp_http_client_config_t http_config = {
+        .url = url,
+        .method = HTTP_METHOD_POST,
+        .timeout_ms = 5000,
+        .event_handler = http_event_handler,
+        .user_data = &resp_ctx,
+    };
+
+    esp_http_client_handle_t client = esp_http_client_init(&http_config);
+    if (client == NULL) {
+        free(body);
+        elisa_latency_restore(hists);
+        return -1;
+    }
+
+    esp_http_client_set_header(client, "Content-Type", "application/json");
+    esp_http_client_set_header(client, "x-api-key", s_api_key);
+    esp_http_client_set_post_field(client, body, (int)strlen(body));
+
+    esp_err_t err = esp_http_client_perform(client);
+    if (err == ESP_OK) {
+        result->status_code = esp_http_client_get_status_code(client);
+        result->healthy = (result->status_code == 200);
+    } else {
+        ESP_LOGW(TAG, "Heartbeat report failed: %s", esp_err_to_name(err));
+    }
+
+    esp_http_client_cleanup(client);
+    free(body);
+
+    if (!result->healthy) {
+        elisa_latency_restore(hists);
+    } else if (resp_ctx.body != NULL && response_ctx_append(&resp_ctx, "", 1) == ESP_OK) {
+        apply_config_update(resp_ctx.body);
+    }
+    free(resp_ctx.body);
+    return (err == ESP_OK) ? 0 : -1;
+}
+
 void elisa_api_free_response(elisa_turn_response_t *response) {
     if (response == NULL) return;
     if (response->text != NULL) {
@@ -11,6 +11,7 @@
  *   We replace those calls with Elisa runtime endpoints:
  *     POST /v1/agents/:id/turn/audio  (audio conversation turn)
  *     GET  /v1/agents/:id/heartbeat   (health check)
+ *     POST /v1/agents/:id/heartbeat   (latency/memory telemetry report)
  * - The device authenticates with x-api-key header (the eart_ key from config).
  * - Audio is sent as raw PCM and TTS audio is returned as MP3.
  */
@@ -21,6 +22,7 @@
 #include <stdint.h>
 #include <stddef.h>
 #include "elisa_config.h"
+#include "elisa_cancel.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -75,13 +77,19 @@ int elisa_api_init(const elisa_runtime_config_t *config);
  *
  * ADAPTATION: replaces chatgpt_demo's direct OpenAI Whisper + ChatGPT calls.
  *
+ * The request is cancellable: upload, server wait and download are run in
+ * ELISA_CANCEL_POLL_MS steps, and the call returns ELISA_CANCELLED shortly
+ * after elisa_turn_cancel() invalidates @p cancel.
+ *
  * @param audio_data Raw PCM audio data from I2S microphone
  * @param audio_len  Length of audio data in bytes
  * @param response   Output: populated with response text and TTS audio
- * @return 0 on success, -1 on error
+ * @param cancel     Turn token from elisa_turn_begin() (or ELISA_CANCEL_TOKEN_NONE)
+ * @return 0 on success, ELISA_CANCELLED if cancelled, -1 on error
  */
 int elisa_api_audio_turn(const uint8_t *audio_data, size_t audio_len,
-                         elisa_turn_response_t *response);
+                         elisa_turn_response_t *response,
+                         elisa_cancel_token_t cancel);
 
 /**
  * Send heartbeat to check runtime connectivity.
@@ -95,6 +103,24 @@ int elisa_api_audio_turn(const uint8_t *audio_data, size_t audio_len,
  */
 int elisa_api_heartbeat(elisa_heartbeat_t *result);
 
+/**
+ * Report device telemetry to the runtime.
+ *
+ * Calls POST /v1/agents/:id/heartbeat (x-api-key) with the latency
+ * histograms collected since the last successful report (see
+ * elisa_latency.h) and the memory telemetry summary. If the report is not
+ * accepted the histograms are merged back and sent with the next one.
+ * Called periodically from a background task, never from the turn path.
+ *
+ * The report carries the config version the device runs; if the runtime
+ * has a newer one, its response carries the changed keys and they are
+ * applied here (elisa_config_apply_update).
+ *
+ * @param result Output: populated with health status
+ * @return 0 on success (even if unhealthy), -1 on network error
+ */
+int elisa_api_report_heartbeat(elisa_heartbeat_t *result);
+
 /**
  * Free resources allocated in a turn response.
  * Safe to call with NULL fields.
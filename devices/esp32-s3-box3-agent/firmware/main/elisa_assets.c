@@ -0,0 +1,116 @@
+/**
+ * @file elisa_assets.c
+ * @brief Maps the asset image from the elisa_assets partition on first use.
+ *
+ * Mounting is reading the 24-byte header, mapping image_size bytes and
+ * checking the directory CRC: the data itself is not touched until a
+ * consumer reads it through the cache. There is no filesystem to walk,
+ * so the cost does not grow with the partition, and no RAM is held
+ * beyond a pointer.
+ *
+ * Two tasks can make the first call at once (the wake word init and the
+ * main task on a failed turn). The one that moves the state from
+ * UNMOUNTED to MOUNTING mounts; the other waits the few hundred
+ * microseconds until the state leaves MOUNTING.
+ *
+ * DEPENDENCIES:
+ * - ESP-IDF partition API (esp_partition)
+ */
+
+#include "elisa_assets.h"
+
+#include <stdatomic.h>
+
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+static const char *TAG = "elisa_assets";
+
+// ── Static State ────────────────────────────────────────────────────────
+
+typedef enum {
+    ASSETS_UNMOUNTED,
+    ASSETS_MOUNTING,    /**< One task is in mount() */
+    ASSETS_MOUNTED,
+    ASSETS_MISSING,     /**< No partition or no valid image: don't retry */
+} assets_state_t;
+
+static atomic_int s_state = ASSETS_UNMOUNTED;
+static const elisa_assets_header_t *s_image = NULL;
+
+// ── Mount ───────────────────────────────────────────────────────────────
+
+/** Leave MOUNTING; s_image is published with the state. */
+static void mount_done(assets_state_t result) {
+    int expected = ASSETS_MOUNTING;
+    if (!atomic_compare_exchange_strong(&s_state, &expected, result)) {
+        ESP_LOGE(TAG, "Mount finished in state %d", expected);
+    }
+}
+
+/** Called by the task that moved the state to MOUNTING, and only once. */
+static void mount(void) {
+    int64_t start_us = esp_timer_get_time();
+
+    const esp_partition_t *part = esp_partition_find_first(
+        ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)ELISA_ASSETS_PARTITION_SUBTYPE,
+        ELISA_ASSETS_PARTITION_LABEL);
+    if (part == NULL) {
+        ESP_LOGI(TAG, "No %s partition", ELISA_ASSETS_PARTITION_LABEL);
+        mount_done(ASSETS_MISSING);
+        return;
+    }
+
+    /* Map only the image, not the whole partition */
+    elisa_assets_header_t header;
+    if (esp_partition_read(part, 0, &header, sizeof(header)) != ESP_OK ||
+        header.magic != ELISA_ASSETS_MAGIC || header.image_size < sizeof(header) ||
+        header.image_size > part->size) {
+        ESP_LOGI(TAG, "No asset image in %s", ELISA_ASSETS_PARTITION_LABEL);
+        mount_done(ASSETS_MISSING);
+        return;
+    }
+
+    const void *map = NULL;
+    esp_partition_mmap_handle_t handle;
+    esp_err_t err = esp_partition_mmap(part, 0, header.image_size, ESP_PARTITION_MMAP_DATA,
+                                       &map, &handle);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to map %s: %s", ELISA_ASSETS_PARTITION_LABEL, esp_err_to_name(err));
+        mount_done(ASSETS_MISSING);
+        return;
+    }
+
+    const elisa_assets_header_t *image = elisa_assets_bin_check(map, header.image_size);
+    if (image == NULL) {
+        ESP_LOGW(TAG, "Invalid asset image in %s", ELISA_ASSETS_PARTITION_LABEL);
+        esp_partition_munmap(handle);
+        mount_done(ASSETS_MISSING);
+        return;
+    }
+
+    s_image = image;
+    ESP_LOGI(TAG, "Assets: %u in %lu bytes, mounted in %lld us",
+             (unsigned)image->entry_count, (unsigned long)image->image_size,
+             (long long)(esp_timer_get_time() - start_us));
+    mount_done(ASSETS_MOUNTED);
+}
+
+// ── Lookup ──────────────────────────────────────────────────────────────
+
+int elisa_assets_find(const char *name, elisa_asset_t *out) {
+    int state = ASSETS_UNMOUNTED;
+    if (atomic_compare_exchange_strong(&s_state, &state, ASSETS_MOUNTING)) {
+        mount();
+    }
+    while ((state = atomic_load(&s_state)) == ASSETS_MOUNTING) {
+        vTaskDelay(1);
+    }
+    if (state != ASSETS_MOUNTED) {
+        return -1;
+    }
+    return elisa_assets_bin_find(s_image, name, out);
+}
@@ -0,0 +1,50 @@
+/**
+ * @file elisa_assets.h
+ * @brief Lazily mapped read-only assets (elisa_assets partition).
+ *
+ * Nothing is mounted at boot. The first elisa_assets_find() maps the
+ * asset image (elisa_assets_bin.h) and checks its directory; later calls
+ * are a hash and a compare. Found data points into the flash mapping and
+ * stays valid for the life of the firmware, so callers use it in place
+ * (fmemopen() for the audio player, a TFLite model as is).
+ *
+ * Devices flashed without an asset image behave as if every asset is
+ * missing, and consumers keep their built-in fallback.
+ *
+ * Asset names:
+ *   runtime_config.json     JSON config fallback (elisa_config.c)
+ *   wake_word.tflite        Replaces elisa_wake_word.cc's built-in model
+ *                           (host turn_sim only: not in the firmware build)
+ *   tts/<phrase>.mp3        Cached TTS prompts, e.g. tts/turn_failed.mp3
+ *   earcon/<event>.mp3      Earcons
+ */
+
+#ifndef ELISA_ASSETS_H
+#define ELISA_ASSETS_H
+
+#include "elisa_assets_bin.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Wake word model (elisa_wake_word.cc; turn_sim only). */
+#define ELISA_ASSET_WAKE_MODEL "wake_word.tflite"
+
+/** Cached TTS prompt played when a turn fails. */
+#define ELISA_ASSET_TTS_TURN_FAILED "tts/turn_failed.mp3"
+
+/**
+ * Find an asset by name, mapping the image on first use. Safe to call
+ * from any task.
+ *
+ * @return 0 with *out filled in, or -1 if there is no such asset (or no
+ *         valid asset image)
+ */
+int elisa_assets_find(const char *name, elisa_asset_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ELISA_ASSETS_H */
@@ -0,0 +1,85 @@
+/**
+ * @file elisa_assets_bin.c
+ * @brief Asset image checks and lookup.
+ */
+
+#include "elisa_assets_bin.h"
+
+#include <string.h>
+
+#include "elisa_config_bin.h"
+
+// ── Hash ────────────────────────────────────────────────────────────────
+
+uint32_t elisa_assets_hash(const char *name) {
+    uint32_t h = 0x811C9DC5u;
+    for (const uint8_t *p = (const uint8_t *)name; *p != '\0'; p++) {
+        h ^= *p;
+        h *= 0x01000193u;
+    }
+    return h;
+}
+
+// ── Checks ──────────────────────────────────────────────────────────────
+
+static const elisa_asset_entry_t *buckets_of(const elisa_assets_header_t *h) {
+    return (const elisa_asset_entry_t *)((const uint8_t *)h + h->header_size);
+}
+
+const elisa_assets_header_t *elisa_assets_bin_check(const void *image, size_t size) {
+    if (size < sizeof(elisa_assets_header_t)) return NULL;
+    const elisa_assets_header_t *h = (const elisa_assets_header_t *)image;
+
+    if (h->magic != ELISA_ASSETS_MAGIC || h->version != ELISA_ASSETS_VERSION ||
+        h->header_size != sizeof(*h) || h->image_size < sizeof(*h) || h->image_size > size) {
+        return NULL;
+    }
+    /* Power-of-two table with a free bucket left, so probing ends */
+    uint32_t buckets = h->bucket_count;
+    if (buckets == 0 || (buckets & (buckets - 1)) != 0 || h->entry_count >= buckets) return NULL;
+
+    uint32_t names_start = h->header_size + buckets * sizeof(elisa_asset_entry_t);
+    uint32_t dir_end = h->header_size + h->dir_size;
+    if (h->dir_size > h->image_size - h->header_size || dir_end <= names_start) return NULL;
+    const uint8_t *base = (const uint8_t *)image;
+    if (elisa_config_crc32(base + h->header_size, h->dir_size) != h->dir_crc32) return NULL;
+    /* Names end in the directory, so strcmp() can't run off it */
+    if (base[dir_end - 1] != '\0') return NULL;
+
+    uint32_t used = 0;
+    const elisa_asset_entry_t *e = buckets_of(h);
+    for (uint32_t i = 0; i < buckets; i++, e++) {
+        if (e->name_offset == 0) continue;
+        used++;
+        if (e->name_offset < names_start || e->name_offset >= dir_end ||
+            e->data_offset < dir_end || e->data_offset > h->image_size ||
+            e->size > h->image_size - e->data_offset) {
+            return NULL;
+        }
+    }
+    return used == h->entry_count ? h : NULL;
+}
+
+// ── Lookup ──────────────────────────────────────────────────────────────
+
+int elisa_assets_bin_find(const elisa_assets_header_t *image, const char *name, elisa_asset_t *out) {
+    const uint8_t *base = (const uint8_t *)image;
+    const elisa_asset_entry_t *buckets = buckets_of(image);
+    uint32_t mask = image->bucket_count - 1u;
+    uint32_t hash = elisa_assets_hash(name);
+
+    for (uint32_t i = hash & mask;; i = (i + 1) & mask) {
+        const elisa_asset_entry_t *e = &buckets[i];
+        if (e->name_offset == 0) return -1;
+        if (e->hash == hash && strcmp((const char *)base + e->name_offset, name) == 0) {
+            out->data = base + e->data_offset;
+            out->size = e->size;
+            out->crc32 = e->crc32;
+            return 0;
+        }
+    }
+}
+
+bool elisa_asset_verify(const elisa_asset_t *asset) {
+    return elisa_config_crc32(asset->data, asset->size) == asset->crc32;
+}
@@ -0,0 +1,111 @@
+/**
+ * @file elisa_assets_bin.h
+ * @brief Read-only asset image: a hashed directory of blobs, used in place.
+ *
+ * The deploy pipeline packs the device's files (backend
+ * utils/runtimeAssetImage.ts) into one image and flashes it to the
+ * elisa_assets data partition: the runtime_config.json fallback, cached
+ * TTS prompts, earcons and an optional wake word model. elisa_assets.c
+ * maps it on first use and hands out pointers into the mapping, so a
+ * read is a memory access with no VFS, file descriptor or copy.
+ *
+ * Layout, little-endian:
+ *
+ *   offset               size                 field
+ *   0                    24                   elisa_assets_header_t
+ *   24                   20 * bucket_count    elisa_asset_entry_t buckets
+ *   ...                  ...                  names, NUL-terminated
+ *   header + dir_size    ...                  data, each ELISA_ASSETS_ALIGN-aligned
+ *
+ * The buckets are an open-addressed hash table (FNV-1a of the name,
+ * linear probing, at most half full), so a lookup hashes the name and
+ * compares one or two entries whatever the asset count. An empty bucket
+ * has name_offset 0. The header CRC covers the buckets and names;
+ * elisa_assets_bin_check() also bounds every entry, so lookups trust
+ * what they read. Each entry carries the CRC of its data for consumers
+ * that want it checked (elisa_asset_verify()).
+ *
+ * Plain C with no ESP-IDF dependency so host tools can share it.
+ */
+
+#ifndef ELISA_ASSETS_BIN_H
+#define ELISA_ASSETS_BIN_H
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ELISA_ASSETS_MAGIC    0x53414C45u  /**< "ELAS" */
+#define ELISA_ASSETS_VERSION  1
+
+/** Partition: data type, this subtype, this label (partitions.csv). */
+#define ELISA_ASSETS_PARTITION_LABEL   "elisa_assets"
+#define ELISA_ASSETS_PARTITION_SUBTYPE 0x41
+
+/** Data alignment: enough for a TFLite flatbuffer used in place. */
+#define ELISA_ASSETS_ALIGN 16
+
+/** Longest asset name, without its NUL. */
+#define ELISA_ASSETS_MAX_NAME 63
+
+typedef struct {
+    uint32_t magic;          /**< ELISA_ASSETS_MAGIC */
+    uint16_t version;        /**< ELISA_ASSETS_VERSION */
+    uint16_t header_size;    /**< sizeof(elisa_assets_header_t) */
+    uint32_t image_size;     /**< Header, directory and data */
+    uint16_t bucket_count;   /**< Power of two, >= 2 * entry_count */
+    uint16_t entry_count;
+    uint32_t dir_size;       /**< Buckets and names: bytes after the header */
+    uint32_t dir_crc32;      /**< CRC-32 (IEEE) of the directory */
+} elisa_assets_header_t;
+
+typedef struct {
+    uint32_t hash;           /**< elisa_assets_hash(name) */
+    uint32_t name_offset;    /**< From the image start; 0 = empty bucket */
+    uint32_t data_offset;    /**< From the image start */
+    uint32_t size;
+    uint32_t crc32;          /**< CRC-32 (IEEE) of the data */
+} elisa_asset_entry_t;
+
+static_assert(sizeof(elisa_assets_header_t) == 24, "asset image header layout");
+static_assert(sizeof(elisa_asset_entry_t) == 20, "asset image entry layout");
+
+/** An asset in the mapped image. */
+typedef struct {
+    const void *data;
+    size_t size;
+    uint32_t crc32;
+} elisa_asset_t;
+
+/** FNV-1a (32-bit) of a NUL-terminated name. */
+uint32_t elisa_assets_hash(const char *name);
+
+/**
+ * Check an image: header, directory CRC, table shape, and that every
+ * entry's name and data lie inside the image.
+ *
+ * @param size Bytes available at image (the partition size)
+ * @return The header, or NULL if it is not a valid image
+ */
+const elisa_assets_header_t *elisa_assets_bin_check(const void *image, size_t size);
+
+/**
+ * Look a name up in an image that passed elisa_assets_bin_check().
+ *
+ * @return 0 with *out filled in, or -1 if there is no such asset
+ */
+int elisa_assets_bin_find(const elisa_assets_header_t *image, const char *name, elisa_asset_t *out);
+
+/** True if the asset's data matches its CRC. Reads all of it. */
+bool elisa_asset_verify(const elisa_asset_t *asset);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ELISA_ASSETS_BIN_H */
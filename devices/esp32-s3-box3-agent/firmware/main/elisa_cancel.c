@@ -0,0 +1,55 @@
+/**
+ * @file elisa_cancel.c
+ * @brief Turn cancellation token implementation.
+ *
+ * A single atomic generation counter backs every token. elisa_turn_begin()
+ * hands out the current generation; elisa_turn_cancel() bumps it, so any
+ * token from before the bump compares unequal and reads as cancelled.
+ */
+
+#include "elisa_cancel.h"
+#include "elisa_trace.h"
+
+#include <stdatomic.h>
+
+#include "esp_log.h"
+
+static const char *TAG = "elisa_cancel";
+
+// ── Static State ────────────────────────────────────────────────────────
+
+/** Current turn generation. Starts at 1 so it never equals TOKEN_NONE. */
+static atomic_uint_least32_t s_generation = 1;
+
+/** Hook for stages that cannot poll a token (audio playback). */
+static _Atomic(elisa_cancel_cb_t) s_cancel_cb = NULL;
+
+// ── Public API ──────────────────────────────────────────────────────────
+
+elisa_cancel_token_t elisa_turn_begin(void) {
+    return (elisa_cancel_token_t)atomic_load(&s_generation);
+}
+
+void elisa_turn_cancel(void) {
+    uint32_t next = (uint32_t)atomic_fetch_add(&s_generation, 1) + 1;
+    if (next == ELISA_CANCEL_TOKEN_NONE) {
+        /* Skip the reserved value on wrap-around */
+        atomic_fetch_add(&s_generation, 1);
+    }
+    ESP_LOGI(TAG, "Turn cancelled");
+    elisa_trace(TRACE_CANCEL, TRACE_PH_INSTANT, next);
+
+    elisa_cancel_cb_t cb = atomic_load(&s_cancel_cb);
+    if (cb != NULL) {
+        cb();
+    }
+}
+
+bool elisa_turn_cancelled(elisa_cancel_token_t token) {
+    if (token == ELISA_CANCEL_TOKEN_NONE) return false;
+    return token != (elisa_cancel_token_t)atomic_load(&s_generation);
+}
+
+void elisa_turn_register_cancel_cb(elisa_cancel_cb_t cb) {
+    atomic_store(&s_cancel_cb, cb);
+}
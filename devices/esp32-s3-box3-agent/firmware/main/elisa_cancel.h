@@ -0,0 +1,74 @@
+/**
+ * @file elisa_cancel.h
+ * @brief Turn cancellation tokens for the conversation pipeline.
+ *
+ * Each conversation turn takes a token from elisa_turn_begin() and passes
+ * it down to the stages that can block for a long time: the runtime HTTP
+ * request, the Opus decode loop and playback. A new wake word or a touch
+ * on the screen calls elisa_turn_cancel(), which invalidates every token
+ * handed out so far. Stages poll elisa_turn_cancelled() between chunks of
+ * work, so an in-flight turn unwinds within ELISA_CANCEL_POLL_MS and
+ * frees its buffers instead of holding the device for HTTP_TIMEOUT_MS.
+ *
+ * Tokens are plain generation numbers, so they are cheap to copy and safe
+ * to check from any task without locking.
+ */
+
+#ifndef ELISA_CANCEL_H
+#define ELISA_CANCEL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Cancellation token: the turn generation it was issued for. */
+typedef uint32_t elisa_cancel_token_t;
+
+/** Token that is never cancelled (for callers outside a turn). */
+#define ELISA_CANCEL_TOKEN_NONE 0
+
+/** Upper bound on how long a blocking stage waits between token checks. */
+#define ELISA_CANCEL_POLL_MS 50
+
+/** Return code used by pipeline stages that stopped because of a cancel. */
+#define ELISA_CANCELLED (-2)
+
+/** Called from elisa_turn_cancel() to stop work that cannot poll (playback). */
+typedef void (*elisa_cancel_cb_t)(void);
+
+/**
+ * Start a new turn and return its token.
+ * The token stays valid until the next elisa_turn_cancel().
+ */
+elisa_cancel_token_t elisa_turn_begin(void);
+
+/**
+ * Cancel the current turn (if any).
+ *
+ * Invalidates all outstanding tokens and invokes the registered cancel
+ * callback. Safe to call from any task, including the wake word detector
+ * and the LVGL input handler. Calling it with no turn in progress is a
+ * harmless no-op apart from the callback.
+ */
+void elisa_turn_cancel(void);
+
+/**
+ * Check whether the turn that owns @p token has been cancelled.
+ * Always false for ELISA_CANCEL_TOKEN_NONE.
+ */
+bool elisa_turn_cancelled(elisa_cancel_token_t token);
+
+/**
+ * Register the callback invoked by elisa_turn_cancel().
+ * Only one callback is kept; pass NULL to remove it.
+ */
+void elisa_turn_register_cancel_cb(elisa_cancel_cb_t cb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ELISA_CANCEL_H */
@@ -0,0 +1,462 @@
+/**
+ * @file elisa_caption.c
+ * @brief Caption box: PSRAM glyph cache, paced reveal, dirty-rect redraw.
+ *
+ * GLYPH CACHE:
+ * At init every glyph of CAPTION_FONT from 0x20 to 0x7E is read from
+ * LVGL (any bpp, compressed or not), blended onto black in CAPTION_RGB and
+ * stored as RGB565 (byte-swapped like the display) in one PSRAM block.
+ *
+ * POSTING:
+ * Other tasks post text and play/finish/clear actions to a small mailbox
+ * (a spinlock around the raw text, an atomic bit set for the actions).
+ * A CAPTION_POLL_MS LVGL timer takes them, reads the playback position
+ * and redraws only what changed: newly revealed words are copied into the
+ * canvas buffer and their bounding box invalidated; new text, a scroll or
+ * a clear recomposes the whole box. Once the box is empty and idle the
+ * timer pauses itself, and the next post resumes it.
+ */
+
+#include "elisa_caption.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "lvgl.h"
+#include "bsp/esp-bsp.h"
+
+#include "elisa_caption_text.h"
+#include "elisa_dirty.h"
+#include "elisa_lipsync.h"
+#include "elisa_ui_timer.h"
+
+static const char *TAG = "elisa_caption";
+
+// ── Configuration ───────────────────────────────────────────────────────
+
+#define CAPTION_FONT     lv_font_montserrat_16
+#define CAPTION_RGB      0xF0F0F0
+#define CAPTION_W        300
+#define CAPTION_LINES    2
+#define CAPTION_BOTTOM   6     /* px between the box and the screen bottom */
+
+/* How often the LVGL task takes posts and follows the playback position */
+#define CAPTION_POLL_MS  50
+
+/* The finished reply stays up this long */
+#define CAPTION_HOLD_MS  3000
+
+/* Raw UTF-8 text kept from a post; sanitizing shortens it */
+#define RAW_TEXT_SIZE    (2 * ELISA_CAPTION_MAX_CHARS)
+
+/* Posted actions */
+enum {
+    POST_CLEAR  = 1 << 0,
+    POST_TEXT   = 1 << 1,
+    POST_PLAY   = 1 << 2,
+    POST_FINISH = 1 << 3,
+};
+
+typedef enum {
+    CAPTION_IDLE,     /* nothing shown */
+    CAPTION_ARMED,    /* text set, waiting for its stream */
+    CAPTION_PLAYING,  /* revealing with the stream */
+    CAPTION_HOLD,     /* all shown until s_hold_until_us */
+} caption_mode_t;
+
+// ── Static State ────────────────────────────────────────────────────────
+
+static elisa_glyph_cache_t s_cache;
+static void *s_cache_mem = NULL;
+static uint16_t *s_frame = NULL;          /* CAPTION_W x s_frame_h */
+static uint16_t s_frame_h = 0;
+static lv_obj_t *s_canvas = NULL;
+static elisa_ui_timer_t s_timer;          /* paused while idle */
+static bool s_initialized = false;
+
+/* Mailbox: posting tasks write, the LVGL task takes */
+static portMUX_TYPE s_post_lock = portMUX_INITIALIZER_UNLOCKED;
+static char *s_post_text = NULL;          /* RAW_TEXT_SIZE */
+static uint32_t s_post_duration_ms = 0;
+static uint32_t s_post_stream = 0;        /* stream playing when play was posted */
+static atomic_uint s_post_actions;
+
+/* LVGL task */
+static elisa_caption_text_t *s_text = NULL;
+static char *s_raw = NULL;                /* RAW_TEXT_SIZE, taken from the mailbox */
+static caption_mode_t s_mode = CAPTION_IDLE;
+static uint32_t s_duration_ms = 0;
+static uint32_t s_after_stream = 0;       /* ARMED: reveal with a stream after this one */
+static uint32_t s_stream = 0;             /* PLAYING: the stream revealed with */
+static int64_t s_hold_until_us = 0;
+static uint16_t s_shown = 0;              /* characters drawn */
+static uint16_t s_top = 0;                /* first line in the box */
+static bool s_blank = true;               /* s_frame is all background */
+
+/* Stats (LVGL task writes, STATS reads) */
+static portMUX_TYPE s_stats_lock = portMUX_INITIALIZER_UNLOCKED;
+static elisa_caption_stats_t s_stats;
+
+// ── Glyph Cache ─────────────────────────────────────────────────────────
+
+/** Allocate from PSRAM, falling back to internal RAM. */
+static void *caption_alloc(size_t bytes) {
+    void *p = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (p == NULL) {
+        p = heap_caps_malloc(bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    }
+    return p;
+}
+
+/** RGB565 of CAPTION_RGB at coverage a (0..255) over black. */
+static uint16_t glyph_pixel(uint32_t a) {
+    uint32_t r = ((CAPTION_RGB >> 16) & 0xFF) * a / 255;
+    uint32_t g = ((CAPTION_RGB >> 8) & 0xFF) * a / 255;
+    uint32_t b = (CAPTION_RGB & 0xFF) * a / 255;
+    uint16_t px = (uint16_t)(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+#if LV_COLOR_16_SWAP
+    px = (uint16_t)((px << 8) | (px >> 8));
+#endif
+    return px;
+}
+
+static int build_glyph_cache(void) {
+    const lv_font_t *font = &CAPTION_FONT;
+    lv_font_glyph_dsc_t dsc[ELISA_CAPTION_GLYPHS];
+    bool have[ELISA_CAPTION_GLYPHS];
+
+    size_t px_total = 0;
+    for (int i = 0; i < ELISA_CAPTION_GLYPHS; i++) {
+        have[i] = lv_font_get_glyph_dsc(font, &dsc[i], ELISA_CAPTION_FIRST_CHAR + i, 0);
+        if (have[i]) px_total += (size_t)dsc[i].box_w * dsc[i].box_h;
+    }
+    s_cache_mem = caption_alloc(px_total * sizeof(uint16_t));
+    if (s_cache_mem == NULL) {
+        return -1;
+    }
+
+    memset(&s_cache, 0, sizeof(s_cache));
+    s_cache.line_h = (uint8_t)font->line_height;
+    s_cache.bytes = px_total * sizeof(uint16_t);
+
+    uint16_t *p = (uint16_t *)s_cache_mem;
+    for (int i = 0; i < ELISA_CAPTION_GLYPHS; i++) {
+        if (!have[i]) continue;
+        const lv_font_glyph_dsc_t *d = &dsc[i];
+        elisa_glyph_t *g = &s_cache.glyph[i];
+        g->adv = (uint8_t)d->adv_w;
+        g->x = (int8_t)d->ofs_x;
+        g->y = (int8_t)(font->line_height - font->base_line - d->box_h - d->ofs_y);
+        g->w = (uint8_t)d->box_w;
+        g->h = (uint8_t)d->box_h;
+        if (d->box_w == 0 || d->box_h == 0) continue;
+
+        /* Bitmaps are bpp-bit coverage values packed MSB first, rows unpadded */
+        const uint8_t *bmp = lv_font_get_glyph_bitmap(d->resolved_font ? d->resolved_font : font,
+                                                      ELISA_CAPTION_FIRST_CHAR + i);
+        if (bmp == NULL) continue;
+        uint32_t mask = (1u << d->bpp) - 1;
+        for (uint32_t k = 0; k < (uint32_t)d->box_w * d->box_h; k++) {
+            uint32_t bit = k * d->bpp;
+            uint32_t v = (bmp[bit >> 3] >> (8 - d->bpp - (bit & 7))) & mask;
+            p[k] = glyph_pixel(v * 255 / mask);
+        }
+        g->px = p;
+        p += (size_t)d->box_w * d->box_h;
+    }
+    return 0;
+}
+
+// ── Drawing ─────────────────────────────────────────────────────────────
+
+static void invalidate(const elisa_rect_t *rect) {
+    lv_area_t canvas;
+    lv_obj_get_coords(s_canvas, &canvas);
+
+    elisa_rect_t r = *rect;
+    elisa_dirty_align(&r, canvas.x1, CAPTION_W);
+    lv_area_t area = {
+        .x1 = (lv_coord_t)(canvas.x1 + r.x),
+        .y1 = (lv_coord_t)(canvas.y1 + r.y),
+        .x2 = (lv_coord_t)(canvas.x1 + r.x + r.w - 1),
+        .y2 = (lv_coord_t)(canvas.y1 + r.y + r.h - 1),
+    };
+    lv_obj_invalidate_area(s_canvas, &area);
+}
+
+/**
+ * Show the first reveal characters: append the new ones, or recompose the
+ * box when it scrolls or shrinks.
+ *
+ * @return false if nothing changed
+ */
+static bool caption_render(uint16_t reveal) {
+    uint16_t last = (reveal > 0) ? elisa_caption_line_of(s_text, (uint16_t)(reveal - 1)) : 0;
+    uint16_t top = (last >= CAPTION_LINES) ? (uint16_t)(last - (CAPTION_LINES - 1)) : 0;
+    uint32_t px = 0;
+
+    if (top != s_top || reveal < s_shown) {
+        if (s_blank && reveal == 0) return false;
+        memset(s_frame, 0, (size_t)CAPTION_W * s_frame_h * sizeof(uint16_t));
+        for (int l = 0; l < CAPTION_LINES; l++) {
+            px += elisa_caption_draw_line(s_frame, CAPTION_W, s_frame_h, l * s_cache.line_h,
+                                          s_text, (uint16_t)(top + l), 0, reveal, &s_cache, NULL);
+        }
+        const elisa_rect_t full = { 0, 0, CAPTION_W, s_frame_h };
+        invalidate(&full);
+        s_top = top;
+        s_shown = reveal;
+        s_blank = (reveal == 0);
+
+        portENTER_CRITICAL(&s_stats_lock);
+        s_stats.scrolls++;
+        s_stats.drawn_px += px;
+        portEXIT_CRITICAL(&s_stats_lock);
+        return true;
+    }
+
+    if (reveal == s_shown) return false;
+    elisa_rect_t dirty = { 0, 0, 0, 0 };
+    for (int l = 0; l < CAPTION_LINES; l++) {
+        px += elisa_caption_draw_line(s_frame, CAPTION_W, s_frame_h, l * s_cache.line_h,
+                                      s_text, (uint16_t)(top + l), s_shown, reveal,
+                                      &s_cache, &dirty);
+    }
+    if (dirty.w > 0) invalidate(&dirty);
+    s_shown = reveal;
+    s_blank = false;
+
+    portENTER_CRITICAL(&s_stats_lock);
+    s_stats.drawn_px += px;
+    portEXIT_CRITICAL(&s_stats_lock);
+    return true;
+}
+
+// ── Timer ───────────────────────────────────────────────────────────────
+
+/** Have the LVGL task run the timer (any task). */
+static void caption_arm(void) {
+    elisa_ui_timer_arm(&s_timer);
+}
+
+/** Posts not yet taken by the timer. */
+static bool caption_posted(void) {
+    return atomic_load(&s_post_actions) != 0;
+}
+
+/**
+ * Apply posted actions in the order they can be posted.
+ *
+ * @return true if the box was blanked
+ */
+static bool caption_take_posts(void) {
+    uint32_t actions = atomic_exchange_explicit(&s_post_actions, 0, memory_order_acq_rel);
+    if (actions == 0) return false;
+
+    if (actions & POST_CLEAR) {
+        s_mode = CAPTION_IDLE;
+        s_text->len = 0;
+        s_text->lines = 0;
+    }
+    if (actions & POST_TEXT) {
+        portENTER_CRITICAL(&s_post_lock);
+        memcpy(s_raw, s_post_text, RAW_TEXT_SIZE);
+        portEXIT_CRITICAL(&s_post_lock);
+        elisa_caption_layout(s_text, s_raw, &s_cache, CAPTION_W);
+        s_mode = CAPTION_IDLE;
+    }
+    if (actions & POST_PLAY) {
+        portENTER_CRITICAL(&s_post_lock);
+        s_duration_ms = s_post_duration_ms;
+        s_after_stream = s_post_stream;
+        portEXIT_CRITICAL(&s_post_lock);
+        s_mode = CAPTION_ARMED;
+    }
+    if ((actions & POST_FINISH) && s_mode != CAPTION_IDLE) {
+        s_mode = CAPTION_HOLD;
+        s_hold_until_us = esp_timer_get_time() + (int64_t)CAPTION_HOLD_MS * 1000;
+    }
+    /* New text starts from an empty box */
+    return (actions & (POST_CLEAR | POST_TEXT)) && caption_render(0);
+}
+
+static void caption_timer_cb(lv_timer_t *timer) {
+    (void)timer;
+    int64_t t0 = esp_timer_get_time();
+    bool changed = caption_take_posts();
+
+    uint16_t reveal = 0;
+    switch (s_mode) {
+    case CAPTION_IDLE:
+        reveal = 0;
+        break;
+    case CAPTION_ARMED:
+    case CAPTION_PLAYING: {
+        uint32_t stream, pos_ms;
+        elisa_lipsync_position(&stream, &pos_ms);
+        if (s_mode == CAPTION_ARMED) {
+            if (stream == s_after_stream) break;
+            s_mode = CAPTION_PLAYING;
+            s_stream = stream;
+        }
+        /* A later stream is not this reply's audio: keep what is shown */
+        reveal = (s_mode == CAPTION_PLAYING && stream == s_stream)
+            ? elisa_caption_reveal(s_text, pos_ms, s_duration_ms) : s_shown;
+        break;
+    }
+    case CAPTION_HOLD:
+        if (t0 >= s_hold_until_us) {
+            s_mode = CAPTION_IDLE;
+            reveal = 0;
+        } else {
+            reveal = s_text->len;
+        }
+        break;
+    }
+
+    changed |= caption_render(reveal);
+    if (s_mode == CAPTION_IDLE && s_blank) {
+        /* Nothing shown and nothing to follow: pause until the next post */
+        elisa_ui_timer_park(&s_timer, caption_posted);
+    }
+    if (!changed) return;
+
+    uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
+    portENTER_CRITICAL(&s_stats_lock);
+    s_stats.updates++;
+    s_stats.update_us_total += us;
+    if (us > s_stats.update_us_max) s_stats.update_us_max = us;
+    portEXIT_CRITICAL(&s_stats_lock);
+}
+
+// ── Posting ─────────────────────────────────────────────────────────────
+
+static void post(uint32_t action) {
+    atomic_fetch_or_explicit(&s_post_actions, action, memory_order_release);
+    caption_arm();
+}
+
+// ── Public API ──────────────────────────────────────────────────────────
+
+/** elisa_caption_init() under the LVGL lock. */
+static int caption_create(void) {
+    lv_obj_t *scr = lv_scr_act();
+    if (scr == NULL) {
+        ESP_LOGE(TAG, "LVGL screen not available");
+        return -1;
+    }
+
+    if (build_glyph_cache() != 0) {
+        ESP_LOGE(TAG, "Failed to allocate caption glyph cache");
+        return -1;
+    }
+    s_frame_h = (uint16_t)(CAPTION_LINES * s_cache.line_h);
+    s_frame = caption_alloc((size_t)CAPTION_W * s_frame_h * sizeof(uint16_t));
+    s_text = caption_alloc(sizeof(*s_text));
+    s_post_text = caption_alloc(RAW_TEXT_SIZE);
+    s_raw = caption_alloc(RAW_TEXT_SIZE);
+    if (s_frame == NULL || s_text == NULL || s_post_text == NULL || s_raw == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate caption buffers");
+        elisa_caption_cleanup();
+        return -1;
+    }
+    memset(s_frame, 0, (size_t)CAPTION_W * s_frame_h * sizeof(uint16_t));
+    memset(s_text, 0, sizeof(*s_text));
+    s_post_text[0] = '\0';
+    s_mode = CAPTION_IDLE;
+    s_shown = 0;
+    s_top = 0;
+    s_blank = true;
+
+    s_canvas = lv_canvas_create(scr);
+    lv_canvas_set_buffer(s_canvas, s_frame, CAPTION_W, s_frame_h, LV_IMG_CF_TRUE_COLOR);
+    lv_obj_align(s_canvas, LV_ALIGN_BOTTOM_MID, 0, -CAPTION_BOTTOM);
+    lv_obj_clear_flag(s_canvas, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_update_layout(s_canvas);
+
+    atomic_store_explicit(&s_post_actions, 0, memory_order_relaxed);
+    elisa_ui_timer_init(&s_timer, lv_timer_create(caption_timer_cb, CAPTION_POLL_MS, NULL));
+
+    atomic_thread_fence(memory_order_release);
+    s_initialized = true;
+    ESP_LOGI(TAG, "Captions: %u byte glyph cache, %ux%u box",
+             (unsigned)s_cache.bytes, (unsigned)CAPTION_W, (unsigned)s_frame_h);
+    return 0;
+}
+
+int elisa_caption_init(void) {
+    /* app_main calls this while the LVGL task is already running */
+    bsp_display_lock(0);
+    int ret = caption_create();
+    bsp_display_unlock();
+    return ret;
+}
+
+void elisa_caption_set_text(const char *text) {
+    if (!s_initialized || text == NULL) return;
+
+    portENTER_CRITICAL(&s_post_lock);
+    strncpy(s_post_text, text, RAW_TEXT_SIZE - 1);
+    s_post_text[RAW_TEXT_SIZE - 1] = '\0';
+    portEXIT_CRITICAL(&s_post_lock);
+    post(POST_TEXT);
+}
+
+void elisa_caption_play(uint32_t duration_ms) {
+    if (!s_initialized) return;
+
+    uint32_t stream, pos_ms;
+    elisa_lipsync_position(&stream, &pos_ms);
+    portENTER_CRITICAL(&s_post_lock);
+    s_post_duration_ms = duration_ms;
+    s_post_stream = stream;
+    portEXIT_CRITICAL(&s_post_lock);
+    post(POST_PLAY);
+}
+
+void elisa_caption_finish(void) {
+    if (!s_initialized) return;
+    post(POST_FINISH);
+}
+
+void elisa_caption_clear(void) {
+    if (!s_initialized) return;
+    /* Drops whatever was posted before it */
+    atomic_store_explicit(&s_post_actions, POST_CLEAR, memory_order_release);
+    caption_arm();
+}
+
+void elisa_caption_take_stats(elisa_caption_stats_t *out) {
+    portENTER_CRITICAL(&s_stats_lock);
+    *out = s_stats;
+    memset(&s_stats, 0, sizeof(s_stats));
+    portEXIT_CRITICAL(&s_stats_lock);
+    out->cache_bytes = (uint32_t)s_cache.bytes;
+}
+
+void elisa_caption_cleanup(void) {
+    s_initialized = false;
+    if (s_timer.timer != NULL) {
+        lv_timer_del(s_timer.timer);
+        s_timer.timer = NULL;
+    }
+    if (s_canvas != NULL) {
+        lv_obj_del(s_canvas);
+        s_canvas = NULL;
+    }
+    heap_caps_free(s_frame);
+    heap_caps_free(s_text);
+    heap_caps_free(s_post_text);
+    heap_caps_free(s_raw);
+    heap_caps_free(s_cache_mem);
+    s_frame = NULL;
+    s_text = NULL;
+    s_post_text = NULL;
+    s_raw = NULL;
+    s_cache_mem = NULL;
+}
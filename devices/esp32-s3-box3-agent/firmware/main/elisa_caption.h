@@ -0,0 +1,76 @@
+/**
+ * @file elisa_caption.h
+ * @brief Reply captions under the face, revealed as the reply is spoken.
+ *
+ * A two-line caption box below the face shows the reply text a word at a
+ * time, paced by the playback position (elisa_lipsync_position()), and
+ * scrolls up a line when the spoken text reaches a third line. After
+ * playback the whole reply stays up for a few seconds.
+ *
+ * Like the face, the caption is one LVGL canvas composed by copying
+ * pre-rendered images: every printable ASCII glyph of the font is
+ * rasterized once at init into a PSRAM glyph cache (elisa_caption_text.h),
+ * so revealing a word copies its glyphs and invalidates just their
+ * rectangle, and LVGL never lays out or rasterizes text while speaking.
+ *
+ * elisa_caption_init() may be called from any task and takes the LVGL
+ * lock itself; elisa_caption_cleanup() runs where the face's does. The
+ * other calls may come from any task and only post to the LVGL task.
+ */
+
+#ifndef ELISA_CAPTION_H
+#define ELISA_CAPTION_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Build the glyph cache and create the caption box (after elisa_face_init).
+ *
+ * @return 0 on success, -1 if memory or the screen is not available
+ */
+int elisa_caption_init(void);
+
+/** Set the next reply's text (UTF-8; copied). Hides the current caption. */
+void elisa_caption_set_text(const char *text);
+
+/**
+ * Reveal the text with the next playback stream.
+ *
+ * @param duration_ms Length of the reply audio, 0 if unknown (paced at
+ *                    ELISA_CAPTION_CHARS_PER_S instead)
+ */
+void elisa_caption_play(uint32_t duration_ms);
+
+/** Playback ended: show all of the text, then hide it after a hold. */
+void elisa_caption_finish(void);
+
+/** Hide the caption now (cancelled turn). */
+void elisa_caption_clear(void);
+
+/**
+ * Caption counters since the previous elisa_caption_take_stats() call.
+ */
+typedef struct {
+    uint32_t updates;          /**< Polls that redrew part of the caption */
+    uint64_t update_us_total;  /**< Time spent composing */
+    uint32_t update_us_max;    /**< Slowest single update */
+    uint32_t drawn_px;         /**< Glyph pixels copied */
+    uint32_t scrolls;          /**< Full redraws (new text, scroll, clear) */
+    uint32_t cache_bytes;      /**< Glyph cache size (PSRAM) */
+} elisa_caption_stats_t;
+
+/** Read and reset the interval counters. */
+void elisa_caption_take_stats(elisa_caption_stats_t *out);
+
+/** Delete the caption box and free its memory. */
+void elisa_caption_cleanup(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ELISA_CAPTION_H */
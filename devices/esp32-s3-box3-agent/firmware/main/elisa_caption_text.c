@@ -0,0 +1,207 @@
+/**
+ * @file elisa_caption_text.c
+ * @brief Caption sanitizing, wrapping, reveal pacing and glyph drawing.
+ */
+
+#include "elisa_caption_text.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+// ── Sanitizing ──────────────────────────────────────────────────────────
+
+/* UTF-8 punctuation TTS replies commonly contain, as ASCII */
+typedef struct {
+    uint32_t cp;
+    const char *ascii;
+} caption_map_t;
+
+static const caption_map_t k_map[] = {
+    { 0x00A0, " " },   { 0x2018, "'" },   { 0x2019, "'" },   { 0x201C, "\"" },
+    { 0x201D, "\"" },  { 0x2013, "-" },   { 0x2014, "-" },   { 0x2026, "..." },
+    { 0x2022, "-" },   { 0x00B0, " deg" },
+};
+
+/** Decode one UTF-8 sequence; returns its length (1 for a stray byte). */
+static int utf8_next(const unsigned char *s, uint32_t *cp) {
+    int n = (s[0] >= 0xF0) ? 4 : (s[0] >= 0xE0) ? 3 : (s[0] >= 0xC0) ? 2 : 1;
+    if (n == 1) {
+        *cp = s[0];
+        return 1;
+    }
+    uint32_t v = s[0] & (0x3F >> (n - 1));
+    for (int i = 1; i < n; i++) {
+        if ((s[i] & 0xC0) != 0x80) {
+            *cp = 0xFFFD;
+            return i;
+        }
+        v = (v << 6) | (s[i] & 0x3F);
+    }
+    *cp = v;
+    return n;
+}
+
+size_t elisa_caption_sanitize(const char *utf8, char *out, size_t out_size) {
+    size_t n = 0;
+    bool space = true;  /* drops leading whitespace */
+    const unsigned char *s = (const unsigned char *)utf8;
+
+    while (*s != '\0' && n + 1 < out_size) {
+        uint32_t cp;
+        s += utf8_next(s, &cp);
+
+        const char *rep = NULL;
+        char one[2] = { 0, 0 };
+        if (cp == ' ' || cp == '\t' || cp == '\n' || cp == '\r') {
+            rep = " ";
+        } else if (cp >= ELISA_CAPTION_FIRST_CHAR &&
+                   cp < ELISA_CAPTION_FIRST_CHAR + ELISA_CAPTION_GLYPHS) {
+            one[0] = (char)cp;
+            rep = one;
+        } else {
+            for (size_t i = 0; i < sizeof(k_map) / sizeof(k_map[0]); i++) {
+                if (k_map[i].cp == cp) rep = k_map[i].ascii;
+            }
+        }
+        if (rep == NULL) continue;
+
+        for (; *rep != '\0' && n + 1 < out_size; rep++) {
+            if (*rep == ' ') {
+                if (space) continue;
+                space = true;
+            } else {
+                space = false;
+            }
+            out[n++] = *rep;
+        }
+    }
+    if (*s != '\0') {
+        /* Cut: drop the partial word */
+        while (n > 0 && out[n - 1] != ' ') n--;
+    }
+    while (n > 0 && out[n - 1] == ' ') n--;
+    out[n] = '\0';
+    return n;
+}
+
+// ── Layout ──────────────────────────────────────────────────────────────
+
+static const elisa_glyph_t *glyph_of(const elisa_glyph_cache_t *cache, char c) {
+    unsigned i = (unsigned char)c - ELISA_CAPTION_FIRST_CHAR;
+    return &cache->glyph[(i < ELISA_CAPTION_GLYPHS) ? i : 0];
+}
+
+/** Append a line, centered in width. */
+static bool push_line(elisa_caption_text_t *t, const elisa_glyph_cache_t *cache,
+                      uint16_t width, uint16_t start, uint16_t end) {
+    if (t->lines == ELISA_CAPTION_MAX_LINES) return false;
+    uint32_t w = 0;
+    for (uint16_t i = start; i < end; i++) w += glyph_of(cache, t->text[i])->adv;
+
+    elisa_caption_line_t *ln = &t->line[t->lines++];
+    ln->start = start;
+    ln->len = (uint16_t)(end - start);
+    ln->x = (uint16_t)((w < width) ? (width - w) / 2 : 0);
+    return true;
+}
+
+void elisa_caption_layout(elisa_caption_text_t *t, const char *text,
+                          const elisa_glyph_cache_t *cache, uint16_t width) {
+    t->len = (uint16_t)elisa_caption_sanitize(text, t->text, sizeof(t->text));
+    t->lines = 0;
+
+    uint16_t start = 0;      /* current line */
+    uint16_t brk = 0;        /* last space on the line, 0 = none */
+    uint32_t x = 0;
+    for (uint16_t i = 0; i < t->len; i++) {
+        if (t->text[i] == ' ') brk = i;
+        x += glyph_of(cache, t->text[i])->adv;
+        if (x <= width || i == start) continue;
+
+        /* Break at the last space, or split a word wider than the line */
+        uint16_t end = (brk > start) ? brk : i;
+        if (!push_line(t, cache, width, start, end)) return;
+        start = (brk > start) ? (uint16_t)(brk + 1) : i;
+        brk = 0;
+        x = 0;
+        for (uint16_t j = start; j <= i; j++) x += glyph_of(cache, t->text[j])->adv;
+    }
+    if (start < t->len) push_line(t, cache, width, start, t->len);
+}
+
+// ── Pacing ──────────────────────────────────────────────────────────────
+
+uint16_t elisa_caption_reveal(const elisa_caption_text_t *t, uint32_t pos_ms,
+                              uint32_t duration_ms) {
+    uint64_t n = (duration_ms > 0)
+        ? (uint64_t)t->len * pos_ms / duration_ms
+        : (uint64_t)pos_ms * ELISA_CAPTION_CHARS_PER_S / 1000;
+    if (n >= t->len) return t->len;
+    if (n == 0) return 0;
+
+    /* A word shows whole once it has started */
+    uint16_t i = (uint16_t)n;
+    while (i < t->len && t->text[i] != ' ') i++;
+    return i;
+}
+
+uint16_t elisa_caption_line_of(const elisa_caption_text_t *t, uint16_t i) {
+    uint16_t l = 0;
+    while (l + 1 < t->lines && t->line[l + 1].start <= i) l++;
+    return l;
+}
+
+// ── Drawing ─────────────────────────────────────────────────────────────
+
+uint32_t elisa_caption_draw_line(uint16_t *dst, uint16_t dst_w, uint16_t dst_h, int top,
+                                 const elisa_caption_text_t *t, uint16_t line,
+                                 uint16_t from, uint16_t to,
+                                 const elisa_glyph_cache_t *cache, elisa_rect_t *dirty) {
+    if (line >= t->lines) return 0;
+    const elisa_caption_line_t *ln = &t->line[line];
+    uint16_t end = (uint16_t)(ln->start + ln->len);
+    if (from < ln->start) from = ln->start;
+    if (to > end) to = end;
+
+    int pen = ln->x;
+    for (uint16_t i = ln->start; i < from; i++) pen += glyph_of(cache, t->text[i])->adv;
+
+    uint32_t px = 0;
+    for (uint16_t i = from; i < to; i++) {
+        const elisa_glyph_t *g = glyph_of(cache, t->text[i]);
+        int gx = pen + g->x, gy = top + g->y;
+        pen += g->adv;
+        if (g->px == NULL) continue;
+
+        for (int y = 0; y < g->h; y++) {
+            int dy = gy + y;
+            if (dy < 0 || dy >= dst_h) continue;
+            const uint16_t *src = g->px + (size_t)y * g->w;
+            uint16_t *row = dst + (size_t)dy * dst_w;
+            for (int x = 0; x < g->w; x++) {
+                int dx = gx + x;
+                if (src[x] == 0 || dx < 0 || dx >= dst_w) continue;
+                row[dx] = src[x];
+                px++;
+            }
+        }
+
+        if (dirty != NULL) {
+            int x0 = gx < 0 ? 0 : gx, y0 = gy < 0 ? 0 : gy;
+            int x1 = gx + g->w > dst_w ? dst_w : gx + g->w;
+            int y1 = gy + g->h > dst_h ? dst_h : gy + g->h;
+            if (x1 <= x0 || y1 <= y0) continue;
+            if (dirty->w == 0) {
+                *dirty = (elisa_rect_t){ (int16_t)x0, (int16_t)y0, (uint16_t)(x1 - x0),
+                                         (uint16_t)(y1 - y0) };
+                continue;
+            }
+            int rx0 = dirty->x < x0 ? dirty->x : x0, ry0 = dirty->y < y0 ? dirty->y : y0;
+            int rx1 = dirty->x + dirty->w > x1 ? dirty->x + dirty->w : x1;
+            int ry1 = dirty->y + dirty->h > y1 ? dirty->y + dirty->h : y1;
+            *dirty = (elisa_rect_t){ (int16_t)rx0, (int16_t)ry0, (uint16_t)(rx1 - rx0),
+                                     (uint16_t)(ry1 - ry0) };
+        }
+    }
+    return px;
+}
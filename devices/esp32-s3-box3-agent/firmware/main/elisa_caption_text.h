@@ -0,0 +1,110 @@
+/**
+ * @file elisa_caption_text.h
+ * @brief Caption text: wrapping, paced reveal and glyph-cache drawing.
+ *
+ * Reply text is reduced to printable ASCII (typographic quotes, dashes
+ * and ellipses mapped, other characters dropped, whitespace collapsed),
+ * wrapped into lines by the glyph advances, and revealed a word at a time
+ * as playback advances: in proportion to the reply's duration when it is
+ * known, otherwise at an average speaking rate.
+ *
+ * Glyphs come from a cache of pre-rasterized RGB565 images (one per
+ * character, already blended onto the black caption background), so
+ * drawing a character is a copy of its non-black pixels. Building the
+ * cache from a font is the caller's job (elisa_caption.c uses LVGL's).
+ *
+ * Plain C with no LVGL or ESP-IDF dependency so host tools can share it.
+ */
+
+#ifndef ELISA_CAPTION_TEXT_H
+#define ELISA_CAPTION_TEXT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "elisa_draw.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Cached characters: printable ASCII. */
+#define ELISA_CAPTION_FIRST_CHAR 0x20
+#define ELISA_CAPTION_GLYPHS     95
+
+/** Longest caption kept, in characters (longer replies are cut at a word). */
+#define ELISA_CAPTION_MAX_CHARS  1024
+#define ELISA_CAPTION_MAX_LINES  128
+
+/** Reveal rate when the reply's duration is unknown (about 150 words/min). */
+#define ELISA_CAPTION_CHARS_PER_S 14
+
+/** One pre-rasterized character. */
+typedef struct {
+    int8_t x, y;            /**< Image offset from the pen at the line's top */
+    uint8_t w, h;
+    uint8_t adv;            /**< Pen advance */
+    const uint16_t *px;     /**< w x h RGB565, 0 = background */
+} elisa_glyph_t;
+
+typedef struct {
+    elisa_glyph_t glyph[ELISA_CAPTION_GLYPHS];
+    uint8_t line_h;
+    size_t bytes;           /**< Pixel memory of all glyphs */
+} elisa_glyph_cache_t;
+
+typedef struct {
+    uint16_t start, len;    /**< Characters of text, without the breaking space */
+    uint16_t x;             /**< Pen start that centers the line */
+} elisa_caption_line_t;
+
+typedef struct {
+    char text[ELISA_CAPTION_MAX_CHARS];
+    uint16_t len;
+    elisa_caption_line_t line[ELISA_CAPTION_MAX_LINES];
+    uint16_t lines;
+} elisa_caption_text_t;
+
+/**
+ * Convert UTF-8 reply text to caption ASCII in out (NUL-terminated).
+ *
+ * @return Characters written
+ */
+size_t elisa_caption_sanitize(const char *utf8, char *out, size_t out_size);
+
+/**
+ * Set t to text (sanitized) wrapped at width pixels into centered lines.
+ * Words wider than a line are split; text past ELISA_CAPTION_MAX_LINES is
+ * dropped.
+ */
+void elisa_caption_layout(elisa_caption_text_t *t, const char *text,
+                          const elisa_glyph_cache_t *cache, uint16_t width);
+
+/**
+ * Characters to show at a playback position: whole words, all of them at
+ * the end of the duration (duration_ms 0 = unknown, paced by
+ * ELISA_CAPTION_CHARS_PER_S).
+ */
+uint16_t elisa_caption_reveal(const elisa_caption_text_t *t, uint32_t pos_ms,
+                              uint32_t duration_ms);
+
+/** Line holding character i (the last line if i is past the text). */
+uint16_t elisa_caption_line_of(const elisa_caption_text_t *t, uint16_t i);
+
+/**
+ * Draw characters [from, to) of a line into a dst_w x dst_h image whose
+ * row top is the line's top; characters of other lines are clipped.
+ * dirty, if not NULL, is grown to cover the pixels drawn.
+ *
+ * @return Pixels copied
+ */
+uint32_t elisa_caption_draw_line(uint16_t *dst, uint16_t dst_w, uint16_t dst_h, int top,
+                                 const elisa_caption_text_t *t, uint16_t line,
+                                 uint16_t from, uint16_t to,
+                                 const elisa_glyph_cache_t *cache, elisa_rect_t *dirty);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ELISA_CAPTION_TEXT_H */
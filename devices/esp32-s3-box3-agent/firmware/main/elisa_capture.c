@@ -0,0 +1,241 @@
+/**
+ * @file elisa_capture.c
+ * @brief Recording mode ring buffer and capture task.
+ *
+ * Ring indices are free-running 32-bit counters: the producer (audio
+ * callback) owns s_head, the consumer (capture task) owns s_tail, and
+ * fill = head - tail. Each side publishes its index with release ordering
+ * after touching the samples, so no lock is needed between them.
+ */
+
+#include "elisa_capture.h"
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+
+#include "elisa_frame.h"
+#include "elisa_rice.h"
+#include "elisa_tasks.h"
+
+static const char *TAG = "elisa_capture";
+
+#define RING_MASK (ELISA_CAPTURE_RING_SAMPLES - 1)
+
+_Static_assert((ELISA_CAPTURE_RING_SAMPLES & RING_MASK) == 0,
+               "ELISA_CAPTURE_RING_SAMPLES must be a power of two");
+_Static_assert(ELISA_RICE_MAX_BYTES(ELISA_CAPTURE_FRAME_SAMPLES) <= ELISA_FRAME_MAX_PAYLOAD,
+               "Encoded block must fit in one frame payload");
+
+// ── Static State ────────────────────────────────────────────────────────
+
+static int16_t *s_ring = NULL;
+static TaskHandle_t s_task = NULL;
+
+static atomic_uint s_head;            /* written by the producer only */
+static atomic_uint s_tail;            /* written by the consumer only */
+static atomic_bool s_active;
+static atomic_bool s_stop_pending;
+
+static atomic_uint s_dropped;
+static atomic_uint s_high_water;      /* producer only */
+
+/* Consumer-only state */
+static elisa_capture_format_t s_format = ELISA_CAPTURE_RICE;
+static uint32_t s_seq = 0;
+static uint32_t s_frames_sent = 0;
+static uint32_t s_samples_sent = 0;
+static uint32_t s_audio_bytes_sent = 0;
+static uint32_t s_frames_since_status = 0;
+
+static uint8_t s_frame_buf[ELISA_RICE_MAX_BYTES(ELISA_CAPTURE_FRAME_SAMPLES) + ELISA_FRAME_OVERHEAD];
+static uint8_t s_block_buf[ELISA_RICE_MAX_BYTES(ELISA_CAPTURE_FRAME_SAMPLES)];
+
+// ── Producer ────────────────────────────────────────────────────────────
+
+void elisa_recording_feed(const int16_t *samples, size_t count) {
+    if (!atomic_load_explicit(&s_active, memory_order_acquire) || s_ring == NULL) return;
+
+    uint32_t head = atomic_load_explicit(&s_head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&s_tail, memory_order_acquire);
+    uint32_t space = ELISA_CAPTURE_RING_SAMPLES - (head - tail);
+
+    uint32_t n = (uint32_t)count;
+    if (n > space) {
+        /* Never wait on the console: drop the overflow and count it */
+        atomic_fetch_add_explicit(&s_dropped, n - space, memory_order_relaxed);
+        n = space;
+    }
+
+    uint32_t start = head & RING_MASK;
+    uint32_t first = ELISA_CAPTURE_RING_SAMPLES - start;
+    if (first > n) first = n;
+    memcpy(&s_ring[start], samples, first * sizeof(int16_t));
+    memcpy(&s_ring[0], samples + first, (n - first) * sizeof(int16_t));
+    atomic_store_explicit(&s_head, head + n, memory_order_release);
+
+    uint32_t fill = head + n - tail;
+    if (fill > atomic_load_explicit(&s_high_water, memory_order_relaxed)) {
+        atomic_store_explicit(&s_high_water, fill, memory_order_relaxed);
+    }
+    if (fill >= ELISA_CAPTURE_FRAME_SAMPLES && s_task != NULL) {
+        xTaskNotifyGive(s_task);
+    }
+}
+
+// ── Consumer ────────────────────────────────────────────────────────────
+
+static void write_frame(uint8_t type, const uint8_t *payload, size_t len) {
+    size_t n = elisa_frame_encode(s_frame_buf, type, s_seq++, payload, len);
+    /* One fwrite holds the stdout lock for the whole frame */
+    fwrite(s_frame_buf, 1, n, stdout);
+    fflush(stdout);
+    s_frames_sent++;
+}
+
+static void send_status(bool final) {
+    elisa_frame_status_t st = {
+        .frames_sent = s_frames_sent,
+        .samples_sent = s_samples_sent,
+        .samples_dropped = atomic_load_explicit(&s_dropped, memory_order_relaxed),
+        .ring_high_water = atomic_load_explicit(&s_high_water, memory_order_relaxed),
+        .audio_bytes_sent = s_audio_bytes_sent,
+        .final = final ? 1 : 0,
+    };
+    uint8_t payload[ELISA_FRAME_STATUS_SIZE];
+    elisa_frame_status_pack(payload, &st);
+    write_frame(ELISA_FRAME_STATUS, payload, sizeof(payload));
+    s_frames_since_status = 0;
+}
+
+/** Send up to one frame of samples from the ring. Returns samples sent. */
+static uint32_t send_pcm(uint32_t max_samples) {
+    static int16_t chunk[ELISA_CAPTURE_FRAME_SAMPLES];
+
+    uint32_t tail = atomic_load_explicit(&s_tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&s_head, memory_order_acquire);
+    uint32_t n = head - tail;
+    if (n > max_samples) n = max_samples;
+    if (n == 0) return 0;
+
+    uint32_t start = tail & RING_MASK;
+    uint32_t first = ELISA_CAPTURE_RING_SAMPLES - start;
+    if (first > n) first = n;
+    memcpy(chunk, &s_ring[start], first * sizeof(int16_t));
+    memcpy(chunk + first, &s_ring[0], (n - first) * sizeof(int16_t));
+    atomic_store_explicit(&s_tail, tail + n, memory_order_release);
+
+    if (s_format == ELISA_CAPTURE_RICE) {
+        size_t len = elisa_rice_encode(chunk, n, s_block_buf);
+        write_frame(ELISA_FRAME_RICE, s_block_buf, len);
+        s_audio_bytes_sent += len;
+    } else {
+        write_frame(ELISA_FRAME_PCM16, (const uint8_t *)chunk, n * sizeof(int16_t));
+        s_audio_bytes_sent += n * sizeof(int16_t);
+    }
+    s_samples_sent += n;
+    s_frames_since_status++;
+    return n;
+}
+
+static void capture_task(void *arg) {
+    (void)arg;
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(50));
+
+        bool stopping = atomic_load_explicit(&s_stop_pending, memory_order_acquire);
+        if (!atomic_load_explicit(&s_active, memory_order_acquire) && !stopping) {
+            continue;
+        }
+
+        /* Full frames while recording; everything left once stopping */
+        while (1) {
+            uint32_t fill = atomic_load_explicit(&s_head, memory_order_acquire) -
+                            atomic_load_explicit(&s_tail, memory_order_relaxed);
+            if (fill == 0 || (!stopping && fill < ELISA_CAPTURE_FRAME_SAMPLES)) break;
+            send_pcm(ELISA_CAPTURE_FRAME_SAMPLES);
+            if (s_frames_since_status >= ELISA_CAPTURE_STATUS_EVERY) {
+                send_status(false);
+            }
+        }
+
+        if (stopping) {
+            send_status(true);
+            atomic_store_explicit(&s_stop_pending, false, memory_order_release);
+        }
+    }
+}
+
+// ── Public API ──────────────────────────────────────────────────────────
+
+int elisa_capture_init(void) {
+    if (s_ring != NULL) return 0;
+
+    /* Internal RAM keeps the audio callback's copy fast; PSRAM as fallback */
+    size_t bytes = ELISA_CAPTURE_RING_SAMPLES * sizeof(int16_t);
+    s_ring = heap_caps_malloc(bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (s_ring == NULL) {
+        s_ring = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    }
+    if (s_ring == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate %u byte capture ring", (unsigned)bytes);
+        return -1;
+    }
+
+    if (elisa_task_create(ELISA_TASK_CAPTURE, capture_task, NULL, &s_task) != 0) {
+        heap_caps_free(s_ring);
+        s_ring = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+void elisa_capture_start(elisa_capture_format_t format) {
+    if (s_ring == NULL || atomic_load(&s_active)) return;
+
+    /* Let a previous STOP finish flushing before the indices are reset */
+    for (int i = 0; i < 20 && atomic_load(&s_stop_pending); i++) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+
+    atomic_store(&s_head, 0);
+    atomic_store(&s_tail, 0);
+    atomic_store(&s_dropped, 0);
+    atomic_store(&s_high_water, 0);
+    s_format = format;
+    s_seq = 0;
+    s_frames_sent = 0;
+    s_samples_sent = 0;
+    s_audio_bytes_sent = 0;
+    s_frames_since_status = 0;
+
+    atomic_store_explicit(&s_active, true, memory_order_release);
+}
+
+void elisa_capture_stop(void) {
+    if (!atomic_load(&s_active)) return;
+    atomic_store_explicit(&s_active, false, memory_order_release);
+    atomic_store_explicit(&s_stop_pending, true, memory_order_release);
+    if (s_task != NULL) {
+        xTaskNotifyGive(s_task);
+    }
+}
+
+bool elisa_capture_is_active(void) {
+    return atomic_load(&s_active);
+}
+
+void elisa_capture_get_stats(elisa_capture_stats_t *out) {
+    out->active = atomic_load(&s_active);
+    out->frames_sent = s_frames_sent;
+    out->samples_sent = s_samples_sent;
+    out->audio_bytes_sent = s_audio_bytes_sent;
+    out->samples_dropped = atomic_load(&s_dropped);
+    out->ring_fill = atomic_load(&s_head) - atomic_load(&s_tail);
+    out->ring_high_water = atomic_load(&s_high_water);
+}
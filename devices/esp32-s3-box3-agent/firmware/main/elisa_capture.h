@@ -0,0 +1,90 @@
+/**
+ * @file elisa_capture.h
+ * @brief Recording mode: microphone capture streamed as framed binary.
+ *
+ * The audio callback hands samples to elisa_recording_feed(), which only
+ * copies them into a lock-free single-producer / single-consumer ring and
+ * never blocks; when the ring is full the samples are dropped and counted.
+ * A dedicated capture task drains the ring and writes sequence-numbered,
+ * CRC-checked frames (elisa_frame.h) to the console, one fwrite() per
+ * frame so ESP_LOG lines can only ever fall between frames. By default each
+ * frame carries a losslessly compressed block (elisa_rice.h), about half
+ * the size of raw PCM on speech.
+ *
+ * Used by wake-word-training/record.py through the RECORD / STOP console
+ * commands.
+ */
+
+#ifndef ELISA_CAPTURE_H
+#define ELISA_CAPTURE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Ring capacity in samples (power of two): 512 ms at 16 kHz. */
+#define ELISA_CAPTURE_RING_SAMPLES  8192
+
+/** Samples per PCM frame: 32 ms at 16 kHz, 1 KB of payload. */
+#define ELISA_CAPTURE_FRAME_SAMPLES 512
+
+/** A STATUS frame is sent after this many PCM frames (about 1 s). */
+#define ELISA_CAPTURE_STATUS_EVERY  32
+
+/** Payload encoding of the capture stream. */
+typedef enum {
+    ELISA_CAPTURE_RICE,   /**< ELISA_FRAME_RICE blocks (default) */
+    ELISA_CAPTURE_PCM16,  /**< ELISA_FRAME_PCM16, uncompressed */
+} elisa_capture_format_t;
+
+/** Counters for the current (or last) recording. */
+typedef struct {
+    bool active;
+    uint32_t frames_sent;
+    uint32_t samples_sent;
+    uint32_t audio_bytes_sent; /**< Audio payload after compression */
+    uint32_t samples_dropped;
+    uint32_t ring_fill;        /**< Samples waiting now */
+    uint32_t ring_high_water;  /**< Most samples ever waiting */
+} elisa_capture_stats_t;
+
+/**
+ * Allocate the ring and start the capture task.
+ *
+ * @return 0 on success, -1 on allocation or task failure
+ */
+int elisa_capture_init(void);
+
+/**
+ * Start streaming (RECORD / RECORD PCM). Resets counters and the sequence
+ * number.
+ */
+void elisa_capture_start(elisa_capture_format_t format);
+
+/**
+ * Stop streaming (STOP). The task flushes what is in the ring and sends a
+ * final STATUS frame.
+ */
+void elisa_capture_stop(void);
+
+/** True between start and stop. */
+bool elisa_capture_is_active(void);
+
+/** Snapshot of the counters. */
+void elisa_capture_get_stats(elisa_capture_stats_t *out);
+
+/**
+ * Audio callback entry point (called from chatgpt_demo's capture path).
+ * Copies samples into the ring when recording; returns immediately.
+ */
+void elisa_recording_feed(const int16_t *samples, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ELISA_CAPTURE_H */
@@ -2,9 +2,22 @@
  * @file elisa_config.c
  * @brief Runtime configuration loader for Elisa on ESP32-S3-BOX-3.
  *
- * Reads /spiffs/runtime_config.json on boot and parses it with cJSON.
- * This file replaces the chatgpt_demo's Kconfig-based configuration
- * approach, allowing per-deploy configuration without firmware rebuilds.
+ * Maps the compiled config image (elisa_config_bin.h) from the elisa_cfg
+ * partition on boot and uses it in place. Devices deployed before the
+ * image existed, or with a damaged one, fall back to parsing
+ * runtime_config.json with cJSON: in place from the asset image
+ * (elisa_assets.h) if there is one, else from SPIFFS, which is only
+ * mounted for that. This file replaces the
+ * chatgpt_demo's Kconfig-based configuration approach, allowing
+ * per-deploy configuration without firmware rebuilds.
+ *
+ * LIVE UPDATES:
+ * The runtime answers a heartbeat with the config keys changed since the
+ * version the device reported. elisa_config_apply_update() merges them
+ * into a copy of the active config, writes that as a new image to the
+ * elisa_cfg slot not in use and switches to it once it reads back valid,
+ * then calls the listeners subscribed to what changed. Nothing reboots
+ * and nothing else is reparsed; a reset mid-write boots the old slot.
  *
  * ADAPTATION NOTES (from chatgpt_demo):
  * - chatgpt_demo uses menuconfig for WiFi/API settings. We read JSON from
@@ -13,18 +26,25 @@
  *   to drive the LVGL face renderer (elisa_face.c).
  *
  * DEPENDENCIES:
+ * - ESP-IDF partition API (esp_partition)
  * - ESP-IDF SPIFFS component (esp_spiffs)
+ * - elisa_assets (asset image)
  * - cJSON (bundled with ESP-IDF)
  */
 
 #include "elisa_config.h"
+#include "elisa_assets.h"
+#include "elisa_config_bin.h"
+#include "elisa_face_style.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "esp_log.h"
+#include "esp_partition.h"
 #include "esp_spiffs.h"
+#include "esp_timer.h"
 #include "cJSON.h"
 
 static const char *TAG = "elisa_config";
@@ -32,16 +52,57 @@ static const char *TAG = "elisa_config";
 /** Path to runtime config on SPIFFS partition */
 #define CONFIG_PATH "/spiffs/runtime_config.json"
 
+/** The same file in the asset image (elisa_assets.h) */
+#define CONFIG_ASSET "runtime_config.json"
+
 /** Maximum config file size (8 KB should be plenty) */
 #define MAX_CONFIG_SIZE 8192
 
 // ── Static State ────────────────────────────────────────────────────────
 
+/** The config in use: a mapped image, or s_config when parsed from JSON */
+static const elisa_runtime_config_t *s_active = NULL;
 static elisa_runtime_config_t s_config;
 static face_descriptor_t s_face;
-static bool s_config_loaded = false;
 static bool s_face_loaded = false;
 
+/** Both elisa_cfg slots, mapped for good: s_active may point into them */
+static const esp_partition_t *s_part = NULL;
+static const uint8_t *s_map = NULL;
+
+#define MAP_SIZE (ELISA_CONFIG_BIN_SLOTS * ELISA_CONFIG_BIN_SLOT_SIZE)
+
+#define MAX_LISTENERS 4
+
+typedef struct {
+    uint32_t mask;
+    elisa_config_listener_t cb;
+    void *arg;
+} config_listener_t;
+
+static config_listener_t s_listeners[MAX_LISTENERS];
+static int s_listener_count = 0;
+
+// ── Enum Names ──────────────────────────────────────────────────────────
+
+static const char *const k_themes[ELISA_THEME_COUNT] = {
+    "default", "forest", "sunset", "pixel", "space", "nature", "tech", "candy", "plain",
+};
+static const char *const k_voices[ELISA_VOICE_COUNT] = { "nova", "onyx", "shimmer", "echo" };
+static const char *const k_display_buffers[ELISA_DISPLAY_BUFFER_COUNT] = { "partial", "psram_full" };
+
+const char *elisa_config_theme_name(uint8_t theme) {
+    return k_themes[theme < ELISA_THEME_COUNT ? theme : ELISA_THEME_DEFAULT];
+}
+
+const char *elisa_config_voice_name(uint8_t voice) {
+    return k_voices[voice < ELISA_VOICE_COUNT ? voice : ELISA_VOICE_NOVA];
+}
+
+const char *elisa_config_display_buffer_name(uint8_t buffer) {
+    return k_display_buffers[buffer < ELISA_DISPLAY_BUFFER_COUNT ? buffer : ELISA_DISPLAY_BUFFER_PARTIAL];
+}
+
 // ── Helper: Parse hex color string to uint32_t ──────────────────────────
 
 /**
@@ -70,86 +131,271 @@ static void safe_strcpy(char *dest, size_t dest_size, const cJSON *json, const c
     }
 }
 
-// ── Face Descriptor Parsing ─────────────────────────────────────────────
+/**
+ * Parse a probability (0-1) into a whole percentage. Missing, zero or
+ * out-of-range values give 0, which means the default.
+ */
+static uint8_t parse_pct(const cJSON *json, const char *key) {
+    const cJSON *item = cJSON_GetObjectItemCaseSensitive(json, key);
+    if (!cJSON_IsNumber(item) || item->valuedouble <= 0.0 || item->valuedouble > 1.0) return 0;
+    return (uint8_t)(item->valuedouble * 100.0 + 0.5);
+}
 
-static void parse_face_descriptor(const cJSON *face_json) {
-    if (face_json == NULL || !cJSON_IsObject(face_json)) {
+/**
+ * Parse a string choice into its enum value. Missing or unknown values
+ * take the fallback.
+ */
+static uint8_t parse_choice(const cJSON *json, const char *key, const char *const *names,
+                            int count, uint8_t fallback) {
+    const cJSON *item = cJSON_GetObjectItemCaseSensitive(json, key);
+    if (!cJSON_IsString(item) || item->valuestring == NULL) return fallback;
+    for (int i = 0; i < count; i++) {
+        if (strcmp(names[i], item->valuestring) == 0) return (uint8_t)i;
+    }
+    ESP_LOGW(TAG, "Unknown %s \"%s\", using \"%s\"", key, item->valuestring, names[fallback]);
+    return fallback;
+}
+
+// ── Face Descriptor ─────────────────────────────────────────────────────
+
+static void copy_name(char *dest, size_t dest_size, const char *name) {
+    strncpy(dest, name, dest_size - 1);
+    dest[dest_size - 1] = '\0';
+}
+
+/** Defaults matching DEFAULT_FACE from display.ts */
+static void set_default_face(face_descriptor_t *face) {
+    copy_name(face->base_shape, sizeof(face->base_shape), "round");
+    copy_name(face->eyes.style, sizeof(face->eyes.style), "circles");
+    copy_name(face->eyes.size, sizeof(face->eyes.size), "medium");
+    face->eyes.color = 0x4361ee;
+    copy_name(face->mouth.style, sizeof(face->mouth.style), "smile");
+    copy_name(face->expression, sizeof(face->expression), "happy");
+    face->face_color = 0xf0f0f0;
+    face->accent_color = 0xffb3ba;
+}
+
+/** Face from a config image (enums already range-checked). */
+static void load_face_image(const elisa_config_bin_face_t *f, face_descriptor_t *face) {
+    if (!f->present) {
         ESP_LOGW(TAG, "No face_descriptor in config, using defaults");
-        /* Set defaults matching DEFAULT_FACE from display.ts */
-        strncpy(s_face.base_shape, "round", sizeof(s_face.base_shape));
-        strncpy(s_face.eyes.style, "circles", sizeof(s_face.eyes.style));
-        strncpy(s_face.eyes.size, "medium", sizeof(s_face.eyes.size));
-        s_face.eyes.color = 0x4361ee;
-        strncpy(s_face.mouth.style, "smile", sizeof(s_face.mouth.style));
-        strncpy(s_face.expression, "happy", sizeof(s_face.expression));
-        s_face.face_color = 0xf0f0f0;
-        s_face.accent_color = 0xffb3ba;
-        s_face_loaded = true;
+        set_default_face(face);
         return;
     }
+    copy_name(face->base_shape, sizeof(face->base_shape), elisa_face_shape_names[f->shape]);
+    copy_name(face->eyes.style, sizeof(face->eyes.style), elisa_eye_style_names[f->eye_style]);
+    copy_name(face->eyes.size, sizeof(face->eyes.size), elisa_eye_size_names[f->eye_size]);
+    face->eyes.color = f->eye_rgb;
+    copy_name(face->mouth.style, sizeof(face->mouth.style), elisa_mouth_style_names[f->mouth]);
+    copy_name(face->expression, sizeof(face->expression), elisa_expression_names[f->expression]);
+    face->face_color = f->face_rgb;
+    face->accent_color = f->accent_rgb;
+}
+
+/** Image form of a face; unknown names take the defaults, as the renderer does. */
+static void store_face_image(const face_descriptor_t *face, elisa_config_bin_face_t *f) {
+    elisa_face_style_t style;
+    elisa_face_style_resolve(face, &style);
+    memset(f, 0, sizeof(*f));
+    f->present = 1;
+    f->shape = (uint8_t)style.shape;
+    f->eye_style = (uint8_t)style.eyes;
+    f->eye_size = (uint8_t)style.eye_size;
+    f->mouth = (uint8_t)style.mouth;
+    f->expression = (uint8_t)style.expression;
+    f->eye_rgb = face->eyes.color;
+    f->face_rgb = face->face_color;
+    f->accent_rgb = face->accent_color;
+}
+
+static void merge_name(char *dest, size_t dest_size, const cJSON *json, const char *key) {
+    const cJSON *item = cJSON_GetObjectItemCaseSensitive(json, key);
+    if (cJSON_IsString(item) && item->valuestring != NULL) {
+        copy_name(dest, dest_size, item->valuestring);
+    }
+}
 
-    safe_strcpy(s_face.base_shape, sizeof(s_face.base_shape), face_json, "base_shape", "round");
+static void merge_color(uint32_t *dest, const cJSON *json, const char *key) {
+    const cJSON *item = cJSON_GetObjectItemCaseSensitive(json, key);
+    if (cJSON_IsString(item)) {
+        *dest = parse_hex_color(item->valuestring);
+    }
+}
+
+/**
+ * Overwrite the fields face_json sets and keep the rest, so a live update
+ * of one field leaves the others as they are.
+ */
+static void merge_face_descriptor(const cJSON *face_json, face_descriptor_t *face) {
+    merge_name(face->base_shape, sizeof(face->base_shape), face_json, "base_shape");
 
-    /* Parse eyes */
     const cJSON *eyes = cJSON_GetObjectItemCaseSensitive(face_json, "eyes");
     if (cJSON_IsObject(eyes)) {
-        safe_strcpy(s_face.eyes.style, sizeof(s_face.eyes.style), eyes, "style", "circles");
-        safe_strcpy(s_face.eyes.size, sizeof(s_face.eyes.size), eyes, "size", "medium");
-        const cJSON *eye_color = cJSON_GetObjectItemCaseSensitive(eyes, "color");
-        s_face.eyes.color = cJSON_IsString(eye_color) ? parse_hex_color(eye_color->valuestring) : 0x4361ee;
+        merge_name(face->eyes.style, sizeof(face->eyes.style), eyes, "style");
+        merge_name(face->eyes.size, sizeof(face->eyes.size), eyes, "size");
+        merge_color(&face->eyes.color, eyes, "color");
     }
 
-    /* Parse mouth */
     const cJSON *mouth = cJSON_GetObjectItemCaseSensitive(face_json, "mouth");
     if (cJSON_IsObject(mouth)) {
-        safe_strcpy(s_face.mouth.style, sizeof(s_face.mouth.style), mouth, "style", "smile");
+        merge_name(face->mouth.style, sizeof(face->mouth.style), mouth, "style");
     }
 
-    safe_strcpy(s_face.expression, sizeof(s_face.expression), face_json, "expression", "happy");
+    merge_name(face->expression, sizeof(face->expression), face_json, "expression");
 
-    /* Parse colors */
     const cJSON *colors = cJSON_GetObjectItemCaseSensitive(face_json, "colors");
     if (cJSON_IsObject(colors)) {
-        const cJSON *face_col = cJSON_GetObjectItemCaseSensitive(colors, "face");
-        const cJSON *accent_col = cJSON_GetObjectItemCaseSensitive(colors, "accent");
-        s_face.face_color = cJSON_IsString(face_col) ? parse_hex_color(face_col->valuestring) : 0xf0f0f0;
-        s_face.accent_color = cJSON_IsString(accent_col) ? parse_hex_color(accent_col->valuestring) : 0xffb3ba;
+        merge_color(&face->face_color, colors, "face");
+        merge_color(&face->accent_color, colors, "accent");
     }
+}
 
+/** Face from the config JSON: the defaults, overridden by what it sets. */
+static void parse_face_descriptor(const cJSON *face_json, face_descriptor_t *face) {
+    set_default_face(face);
+    if (!cJSON_IsObject(face_json)) {
+        ESP_LOGW(TAG, "No face_descriptor in config, using defaults");
+        return;
+    }
+    merge_face_descriptor(face_json, face);
+}
+
+// ── Mode Check ──────────────────────────────────────────────────────────
+
+/** Direct API mode (has openai+anthropic keys) or runtime (has agent_id+api_key+runtime_url) */
+static int check_mode(const elisa_runtime_config_t *c, bool *direct) {
+    bool has_direct_keys = (strlen(c->openai_api_key) > 0 && strlen(c->anthropic_api_key) > 0);
+    bool has_runtime_keys = (strlen(c->agent_id) > 0 && strlen(c->api_key) > 0 && strlen(c->runtime_url) > 0);
+
+    if (!has_direct_keys && !has_runtime_keys) {
+        ESP_LOGE(TAG, "Missing required config: need either (openai_api_key + anthropic_api_key) or (agent_id + api_key + runtime_url)");
+        return -1;
+    }
+    *direct = has_direct_keys;
+    return 0;
+}
+
+// ── Config Image ────────────────────────────────────────────────────────
+
+/**
+ * Map both slots of the elisa_cfg partition. The mapping is never
+ * released: s_active may point into it, and live updates write through
+ * the partition and read back through it.
+ */
+static int map_partition(void) {
+    const esp_partition_t *part = esp_partition_find_first(
+        ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)ELISA_CONFIG_PARTITION_SUBTYPE,
+        ELISA_CONFIG_PARTITION_LABEL);
+    if (part == NULL || part->size < MAP_SIZE) {
+        ESP_LOGI(TAG, "No %s partition", ELISA_CONFIG_PARTITION_LABEL);
+        return -1;
+    }
+
+    const void *map = NULL;
+    esp_partition_mmap_handle_t handle;
+    esp_err_t err = esp_partition_mmap(part, 0, MAP_SIZE, ESP_PARTITION_MMAP_DATA, &map, &handle);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to map %s: %s", ELISA_CONFIG_PARTITION_LABEL, esp_err_to_name(err));
+        return -1;
+    }
+    s_part = part;
+    s_map = (const uint8_t *)map;
+    return 0;
+}
+
+/** Use the newest valid image in the elisa_cfg partition in place. */
+static int load_config_image(bool *direct) {
+    if (map_partition() != 0) {
+        return -1;
+    }
+
+    int slot = -1;
+    const elisa_config_bin_t *img = elisa_config_bin_select(s_map, MAP_SIZE, &slot);
+    if (img == NULL) {
+        ESP_LOGW(TAG, "No valid config image in %s", ELISA_CONFIG_PARTITION_LABEL);
+        return -1;
+    }
+    if (check_mode(&img->config, direct) != 0) {
+        return -1;
+    }
+
+    s_active = &img->config;
+    load_face_image(&img->face, &s_face);
     s_face_loaded = true;
-    ESP_LOGI(TAG, "Face: shape=%s eyes=%s(%s) mouth=%s expr=%s",
-             s_face.base_shape, s_face.eyes.style, s_face.eyes.size,
-             s_face.mouth.style, s_face.expression);
+    ESP_LOGI(TAG, "Config image: slot %d, generation %lu, version %lu", slot,
+             (unsigned long)img->header.generation, (unsigned long)img->config.config_version);
+    return 0;
 }
 
-// ── Public API ──────────────────────────────────────────────────────────
+// ── JSON Fallback ───────────────────────────────────────────────────────
+
+static int mount_spiffs(void) {
+    int64_t start_us = esp_timer_get_time();
+    esp_vfs_spiffs_conf_t conf = {
+        .base_path = "/spiffs",
+        .partition_label = NULL,
+        .max_files = 1, /* runtime_config.json, read once */
+        .format_if_mount_failed = false,
+    };
+    esp_err_t err = esp_vfs_spiffs_register(&conf);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        ESP_LOGE(TAG, "Failed to mount SPIFFS: %s", esp_err_to_name(err));
+        return -1;
+    }
+    ESP_LOGI(TAG, "SPIFFS mounted in %lld us", (long long)(esp_timer_get_time() - start_us));
+    return 0;
+}
+
+static cJSON *parse_json(const char *text, size_t len, const char *source) {
+    cJSON *root = cJSON_ParseWithLength(text, len);
+    if (root == NULL) {
+        const char *err = cJSON_GetErrorPtr();
+        ESP_LOGE(TAG, "JSON parse error in %s near: %.20s", source, err ? err : "unknown");
+    }
+    return root;
+}
+
+/** Read and parse runtime_config.json from SPIFFS (devices without an asset image). */
+static cJSON *parse_config_file(void) {
+    if (mount_spiffs() != 0) {
+        return NULL;
+    }
 
-int elisa_load_config(void) {
     /* Read config file from SPIFFS */
     FILE *f = fopen(CONFIG_PATH, "r");
     if (f == NULL) {
         ESP_LOGE(TAG, "Failed to open %s", CONFIG_PATH);
-        return -1; /* ESP_FAIL */
+        return NULL;
     }
 
     char *buf = (char *)malloc(MAX_CONFIG_SIZE);
     if (buf == NULL) {
         fclose(f);
         ESP_LOGE(TAG, "Failed to allocate config buffer");
-        return -1;
+        return NULL;
     }
 
     size_t len = fread(buf, 1, MAX_CONFIG_SIZE - 1, f);
     fclose(f);
     buf[len] = '\0';
 
-    /* Parse JSON */
-    cJSON *root = cJSON_Parse(buf);
+    cJSON *root = parse_json(buf, len, CONFIG_PATH);
     free(buf);
+    return root;
+}
 
+static int load_config_json(bool *direct) {
+    /* The asset image holds the same JSON, parsed in place from flash */
+    const char *source = CONFIG_ASSET;
+    elisa_asset_t asset;
+    cJSON *root = NULL;
+    if (elisa_assets_find(CONFIG_ASSET, &asset) == 0) {
+        root = parse_json((const char *)asset.data, asset.size, CONFIG_ASSET);
+    } else {
+        source = CONFIG_PATH;
+        root = parse_config_file();
+    }
     if (root == NULL) {
-        const char *err = cJSON_GetErrorPtr();
-        ESP_LOGE(TAG, "JSON parse error near: %.20s", err ? err : "unknown");
         return -1;
     }
 
@@ -161,41 +407,161 @@ int elisa_load_config(void) {
     safe_strcpy(s_config.wifi_password, sizeof(s_config.wifi_password), root, "wifi_password", NULL);
     safe_strcpy(s_config.agent_name, sizeof(s_config.agent_name), root, "agent_name", "Elisa Agent");
     safe_strcpy(s_config.wake_word, sizeof(s_config.wake_word), root, "wake_word", "Hi Elisa");
-    safe_strcpy(s_config.display_theme, sizeof(s_config.display_theme), root, "display_theme", "default");
+    s_config.display_theme = parse_choice(root, "display_theme", k_themes, ELISA_THEME_COUNT,
+                                          ELISA_THEME_DEFAULT);
+    s_config.display_buffer = parse_choice(root, "display_buffer", k_display_buffers,
+                                           ELISA_DISPLAY_BUFFER_COUNT, ELISA_DISPLAY_BUFFER_PARTIAL);
 
     /* Direct API mode fields */
     safe_strcpy(s_config.openai_api_key, sizeof(s_config.openai_api_key), root, "openai_api_key", NULL);
     safe_strcpy(s_config.anthropic_api_key, sizeof(s_config.anthropic_api_key), root, "anthropic_api_key", NULL);
     safe_strcpy(s_config.system_prompt, sizeof(s_config.system_prompt), root, "system_prompt",
                 "You are a helpful voice assistant. Keep responses to 1-2 sentences for natural conversation.");
-    safe_strcpy(s_config.tts_voice, sizeof(s_config.tts_voice), root, "tts_voice", "nova");
+    s_config.tts_voice = parse_choice(root, "tts_voice", k_voices, ELISA_VOICE_COUNT, ELISA_VOICE_NOVA);
 
-    /* Determine mode: direct API (has openai+anthropic keys) or runtime (has agent_id+api_key+runtime_url) */
-    bool has_direct_keys = (strlen(s_config.openai_api_key) > 0 && strlen(s_config.anthropic_api_key) > 0);
-    bool has_runtime_keys = (strlen(s_config.agent_id) > 0 && strlen(s_config.api_key) > 0 && strlen(s_config.runtime_url) > 0);
+    /* Optional static addressing: "wifi_static_ip": {ip, gateway, netmask, dns} */
+    const cJSON *static_ip = cJSON_GetObjectItemCaseSensitive(root, "wifi_static_ip");
+    safe_strcpy(s_config.wifi_static_ip, sizeof(s_config.wifi_static_ip), static_ip, "ip", NULL);
+    safe_strcpy(s_config.wifi_gateway, sizeof(s_config.wifi_gateway), static_ip, "gateway", NULL);
+    safe_strcpy(s_config.wifi_netmask, sizeof(s_config.wifi_netmask), static_ip, "netmask", NULL);
+    safe_strcpy(s_config.wifi_dns, sizeof(s_config.wifi_dns), static_ip, "dns", NULL);
 
-    if (!has_direct_keys && !has_runtime_keys) {
-        ESP_LOGE(TAG, "Missing required config: need either (openai_api_key + anthropic_api_key) or (agent_id + api_key + runtime_url)");
+    /* WakeNet threshold: 0 keeps the model's own */
+    s_config.wake_cutoff_pct = parse_pct(root, "wake_cutoff");
+
+    if (check_mode(&s_config, direct) != 0) {
         cJSON_Delete(root);
         return -1;
     }
 
     /* Parse face descriptor */
     const cJSON *face = cJSON_GetObjectItemCaseSensitive(root, "face_descriptor");
-    parse_face_descriptor(face);
+    parse_face_descriptor(face, &s_face);
+    s_face_loaded = true;
 
     cJSON_Delete(root);
-    s_config_loaded = true;
+    s_active = &s_config;
+    ESP_LOGI(TAG, "Config parsed from %s", source);
+    return 0;
+}
+
+// ── Live Updates ────────────────────────────────────────────────────────
+
+/** WakeNet threshold: null or 0 goes back to the model's own. */
+static uint32_t update_wake(elisa_runtime_config_t *c, const cJSON *changes) {
+    if (cJSON_GetObjectItemCaseSensitive(changes, "wake_cutoff") == NULL) return 0;
+    uint8_t cutoff = parse_pct(changes, "wake_cutoff");
+    if (cutoff == c->wake_cutoff_pct) return 0;
+    c->wake_cutoff_pct = cutoff;
+    return ELISA_CONFIG_CHANGED_WAKE;
+}
+
+int elisa_config_subscribe(uint32_t mask, elisa_config_listener_t cb, void *arg) {
+    if (cb == NULL || s_listener_count >= MAX_LISTENERS) {
+        return -1;
+    }
+    s_listeners[s_listener_count++] = (config_listener_t){ mask, cb, arg };
+    return 0;
+}
+
+int elisa_config_apply_update(const cJSON *changes, uint32_t version) {
+    if (s_active == NULL || !cJSON_IsObject(changes)) {
+        return -1;
+    }
+    if (s_map == NULL) {
+        ESP_LOGW(TAG, "No %s partition -- config update %lu not applied",
+                 ELISA_CONFIG_PARTITION_LABEL, (unsigned long)version);
+        return -1;
+    }
+
+    /* Stage the new image. Static: 1.6 KB is too much for the heartbeat
+     * task's stack, and updates come from that one task. */
+    static elisa_config_bin_t next;
+    memset(&next, 0, sizeof(next));
+    next.config = *s_active;
+    next.config.config_version = version;
+
+    uint32_t changed = update_wake(&next.config, changes);
+
+    face_descriptor_t face = s_face;
+    const cJSON *face_json = cJSON_GetObjectItemCaseSensitive(changes, "face_descriptor");
+    if (cJSON_IsObject(face_json)) {
+        merge_face_descriptor(face_json, &face);
+        if (memcmp(&face, &s_face, sizeof(face)) != 0) {
+            changed |= ELISA_CONFIG_CHANGED_FACE;
+        }
+    }
+    store_face_image(&face, &next.face);
+
+    if (changed == 0 && version == s_active->config_version) {
+        return 0;
+    }
+
+    /* Write over the older slot, one generation past the newest */
+    int newest_slot = -1;
+    const elisa_config_bin_t *newest = elisa_config_bin_select(s_map, MAP_SIZE, &newest_slot);
+    int slot = (newest != NULL) ? (newest_slot + 1) % ELISA_CONFIG_BIN_SLOTS : 0;
+    size_t offset = (size_t)slot * ELISA_CONFIG_BIN_SLOT_SIZE;
+
+    next.header.magic = ELISA_CONFIG_BIN_MAGIC;
+    next.header.version = ELISA_CONFIG_BIN_VERSION;
+    next.header.header_size = sizeof(next.header);
+    next.header.payload_size = ELISA_CONFIG_BIN_PAYLOAD_SIZE;
+    next.header.generation = (newest != NULL) ? newest->header.generation + 1 : 1;
+    next.header.crc32 = elisa_config_crc32(&next.config, ELISA_CONFIG_BIN_PAYLOAD_SIZE);
+
+    esp_err_t err = esp_partition_erase_range(s_part, offset, ELISA_CONFIG_BIN_SLOT_SIZE);
+    if (err == ESP_OK) {
+        err = esp_partition_write(s_part, offset, &next, sizeof(next));
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Config update %lu: writing slot %d failed: %s",
+                 (unsigned long)version, slot, esp_err_to_name(err));
+        return -1;
+    }
+
+    /* Read back through the mapping; only a valid image takes over */
+    const elisa_config_bin_t *img = elisa_config_bin_check(s_map + offset, ELISA_CONFIG_BIN_SLOT_SIZE);
+    if (img == NULL) {
+        ESP_LOGE(TAG, "Config update %lu: slot %d did not read back valid",
+                 (unsigned long)version, slot);
+        return -1;
+    }
+    s_active = &img->config;
+    load_face_image(&img->face, &s_face);
+
+    ESP_LOGI(TAG, "Config update %lu: slot %d, generation %lu, changed 0x%02lx",
+             (unsigned long)version, slot, (unsigned long)img->header.generation,
+             (unsigned long)changed);
+
+    for (int i = 0; i < s_listener_count; i++) {
+        if (s_listeners[i].mask & changed) {
+            s_listeners[i].cb(changed, s_active, s_listeners[i].arg);
+        }
+    }
+    return 0;
+}
+
+// ── Public API ──────────────────────────────────────────────────────────
+
+int elisa_load_config(void) {
+    bool direct = false;
+    if (load_config_image(&direct) != 0 && load_config_json(&direct) != 0) {
+        return -1; /* ESP_FAIL */
+    }
 
     ESP_LOGI(TAG, "Config loaded: name=%s wake=%s theme=%s mode=%s",
-             s_config.agent_name, s_config.wake_word, s_config.display_theme,
-             has_direct_keys ? "direct" : "runtime");
+             s_active->agent_name, s_active->wake_word,
+             elisa_config_theme_name(s_active->display_theme), direct ? "direct" : "runtime");
+    ESP_LOGI(TAG, "Face: shape=%s eyes=%s(%s) mouth=%s expr=%s",
+             s_face.base_shape, s_face.eyes.style, s_face.eyes.size,
+             s_face.mouth.style, s_face.expression);
 
     return 0; /* ESP_OK */
 }
 
 const elisa_runtime_config_t* elisa_get_config(void) {
-    return s_config_loaded ? &s_config : NULL;
+    return s_active;
 }
 
 const face_descriptor_t* elisa_get_face_descriptor(void) {
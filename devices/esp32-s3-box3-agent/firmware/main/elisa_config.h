@@ -2,10 +2,13 @@
  * @file elisa_config.h
  * @brief Configuration structures for Elisa runtime on ESP32-S3-BOX-3.
  *
- * This header defines the runtime configuration loaded from SPIFFS on boot
- * and the face animation state machine. The config is written as
- * runtime_config.json by the Elisa deploy pipeline (EsptoolFlashStrategy)
- * and parsed by elisa_config.c using cJSON.
+ * This header defines the runtime configuration loaded on boot and the face
+ * animation state machine. The deploy pipeline (EsptoolFlashStrategy)
+ * writes the config as a compiled binary image in the elisa_cfg
+ * partition (elisa_config_bin.h), which elisa_config.c maps from flash
+ * and uses in place, and as runtime_config.json in the asset image
+ * (elisa_assets.h) and on SPIFFS, which are only parsed with cJSON when
+ * no valid config image is found.
  *
  * ADAPTATION NOTES (from chatgpt_demo):
  * - chatgpt_demo stores WiFi creds in menuconfig (Kconfig). We read them
@@ -27,9 +30,34 @@ extern "C" {
 
 // ── Runtime Configuration ───────────────────────────────────────────────
 
+/** Display themes (backend DEFAULT_THEMES ids, in this order). */
+typedef enum {
+    ELISA_THEME_DEFAULT, ELISA_THEME_FOREST, ELISA_THEME_SUNSET, ELISA_THEME_PIXEL,
+    ELISA_THEME_SPACE, ELISA_THEME_NATURE, ELISA_THEME_TECH, ELISA_THEME_CANDY,
+    ELISA_THEME_PLAIN, ELISA_THEME_COUNT,
+} elisa_display_theme_t;
+
+/** TTS voices. */
+typedef enum {
+    ELISA_VOICE_NOVA, ELISA_VOICE_ONYX, ELISA_VOICE_SHIMMER, ELISA_VOICE_ECHO,
+    ELISA_VOICE_COUNT,
+} elisa_tts_voice_t;
+
+/** LVGL draw buffers (elisa_main.c). */
+typedef enum {
+    ELISA_DISPLAY_BUFFER_PARTIAL,     /**< Two bands in internal DMA RAM */
+    ELISA_DISPLAY_BUFFER_PSRAM_FULL,  /**< Two full frames in PSRAM */
+    ELISA_DISPLAY_BUFFER_COUNT,
+} elisa_display_buffer_t;
+
 /**
- * Runtime configuration loaded from /spiffs/runtime_config.json.
- * Written by the Elisa backend's EsptoolFlashStrategy during deploy.
+ * Runtime configuration written by the Elisa backend's
+ * EsptoolFlashStrategy during deploy.
+ *
+ * The layout is also the payload of the binary config image, which is
+ * used in place from mapped flash: no padding, strings NUL-terminated
+ * within their arrays, choices stored as the enums above. Changing it
+ * means bumping ELISA_CONFIG_BIN_VERSION.
  */
 typedef struct {
     char agent_id[64];          /**< UUID from agent provisioning */
@@ -39,11 +67,19 @@ typedef struct {
     char wifi_password[64];     /**< WiFi network password */
     char agent_name[64];        /**< Human-readable agent name */
     char wake_word[64];         /**< Wake word for ESP-SR (e.g. "Hi Elisa") */
-    char display_theme[32];     /**< Theme ID (matches backend DisplayTheme.id) */
     char openai_api_key[128];   /**< OpenAI API key for Whisper STT + TTS (direct mode) */
     char anthropic_api_key[128];/**< Anthropic API key for Claude Messages API (direct mode) */
     char system_prompt[512];    /**< Agent personality system prompt */
-    char tts_voice[16];         /**< TTS voice: nova, onyx, shimmer, echo */
+    char wifi_static_ip[16];    /**< Optional static IP (empty = DHCP) */
+    char wifi_gateway[16];      /**< Gateway for static IP */
+    char wifi_netmask[16];      /**< Netmask for static IP (default 255.255.255.0) */
+    char wifi_dns[16];          /**< DNS server for static IP (default: gateway) */
+    uint8_t display_theme;      /**< elisa_display_theme_t (backend DisplayTheme.id) */
+    uint8_t tts_voice;          /**< elisa_tts_voice_t */
+    uint8_t display_buffer;     /**< elisa_display_buffer_t */
+    uint8_t wake_cutoff_pct;    /**< WakeNet detection threshold, % (0 = the model's own) */
+    uint8_t reserved[4];
+    uint32_t config_version;    /**< Live update applied last (0 = as deployed) */
 } elisa_runtime_config_t;
 
 // ── Face State Machine ──────────────────────────────────────────────────
@@ -94,28 +130,73 @@ typedef struct {
 // ── API Functions ───────────────────────────────────────────────────────
 
 /**
- * Load runtime configuration from /spiffs/runtime_config.json.
+ * Load the runtime configuration.
  *
- * Must be called after SPIFFS is initialized. Parses JSON with cJSON
- * and populates the internal config struct. Also parses face_descriptor
- * if present.
+ * Maps the newest valid image in the elisa_cfg partition; if there is
+ * none (older deploy, bad CRC, other version), parses runtime_config.json
+ * instead: from the asset image, else from SPIFFS, which is only mounted
+ * then. Also loads the face descriptor.
  *
- * @return ESP_OK on success, ESP_FAIL on file read or parse error
+ * @return ESP_OK on success, ESP_FAIL if neither source is usable
  */
 int elisa_load_config(void);
 
 /**
  * Get pointer to the loaded runtime configuration.
  * Returns NULL if elisa_load_config() has not been called or failed.
+ *
+ * A live update swaps the config for a new one and the update after
+ * that erases the old one, so read what you need rather than keeping
+ * the pointer.
  */
 const elisa_runtime_config_t* elisa_get_config(void);
 
+/** Names of the config enums ("default", "nova", "partial", ...). */
+const char *elisa_config_theme_name(uint8_t theme);
+const char *elisa_config_voice_name(uint8_t voice);
+const char *elisa_config_display_buffer_name(uint8_t buffer);
+
 /**
  * Get pointer to the parsed face descriptor.
  * Returns NULL if no face_descriptor was present in config or load failed.
  */
 const face_descriptor_t* elisa_get_face_descriptor(void);
 
+// ── Live Updates ────────────────────────────────────────────────────────
+
+/** What a live update changed (elisa_config_listener_t). */
+#define ELISA_CONFIG_CHANGED_FACE    (1u << 4)  /**< face_descriptor */
+#define ELISA_CONFIG_CHANGED_WAKE    (1u << 5)  /**< wake_cutoff */
+
+/** Called from the updating task once the new config is active. */
+typedef void (*elisa_config_listener_t)(uint32_t changed, const elisa_runtime_config_t *config,
+                                        void *arg);
+
+/**
+ * Call cb after every live update that changes one of the mask bits.
+ * Subscribe during boot, before updates can arrive.
+ *
+ * @return 0, or -1 if every listener slot is taken
+ */
+int elisa_config_subscribe(uint32_t mask, elisa_config_listener_t cb, void *arg);
+
+struct cJSON;
+
+/**
+ * Apply a config update from the runtime: the changed keys only
+ * ({"face_descriptor": {...}, "wake_cutoff": 0.9}).
+ *
+ * The new config is written as a config image to the elisa_cfg slot not
+ * in use and takes over once it reads back valid, so a reset mid-write
+ * boots the old one. Then listeners are called. Updates are applied from
+ * one task (the heartbeat) only.
+ *
+ * @param changes Object of changed keys; unknown keys are ignored
+ * @param version The runtime's config version these changes bring us to
+ * @return 0 on success, -1 if nothing was written (the old config stays)
+ */
+int elisa_config_apply_update(const struct cJSON *changes, uint32_t version);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,86 @@
+/**
+ * @file elisa_config_bin.c
+ * @brief Config image checks and slot selection.
+ */
+
+#include "elisa_config_bin.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "elisa_face_style.h"
+
+// ── CRC ─────────────────────────────────────────────────────────────────
+
+uint32_t elisa_config_crc32(const void *data, size_t len) {
+    /* Nibble table: 64 bytes of rodata, fast enough for 1.5 KB at boot */
+    static const uint32_t k_crc_nibble[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4,
+        0x4DB26158, 0x5005713C, 0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+        0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+    };
+    const uint8_t *p = (const uint8_t *)data;
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= p[i];
+        crc = (crc >> 4) ^ k_crc_nibble[crc & 0x0F];
+        crc = (crc >> 4) ^ k_crc_nibble[crc & 0x0F];
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// ── Checks ──────────────────────────────────────────────────────────────
+
+#define TERMINATED(field) (memchr((field), '\0', sizeof(field)) != NULL)
+
+static bool strings_terminated(const elisa_runtime_config_t *c) {
+    return TERMINATED(c->agent_id) && TERMINATED(c->api_key) && TERMINATED(c->runtime_url) &&
+           TERMINATED(c->wifi_ssid) && TERMINATED(c->wifi_password) &&
+           TERMINATED(c->agent_name) && TERMINATED(c->wake_word) &&
+           TERMINATED(c->openai_api_key) && TERMINATED(c->anthropic_api_key) &&
+           TERMINATED(c->system_prompt) && TERMINATED(c->wifi_static_ip) &&
+           TERMINATED(c->wifi_gateway) && TERMINATED(c->wifi_netmask) &&
+           TERMINATED(c->wifi_dns);
+}
+
+static bool values_in_range(const elisa_config_bin_t *img) {
+    const elisa_runtime_config_t *c = &img->config;
+    const elisa_config_bin_face_t *f = &img->face;
+    return c->display_theme < ELISA_THEME_COUNT && c->tts_voice < ELISA_VOICE_COUNT &&
+           c->display_buffer < ELISA_DISPLAY_BUFFER_COUNT &&
+           f->shape < ELISA_SHAPE_COUNT && f->eye_style < ELISA_EYES_COUNT &&
+           f->eye_size < ELISA_EYE_SIZE_COUNT && f->mouth < ELISA_MOUTH_COUNT &&
+           f->expression < ELISA_EXPR_COUNT &&
+           c->wake_cutoff_pct <= 100;
+}
+
+const elisa_config_bin_t *elisa_config_bin_check(const void *slot, size_t size) {
+    if (size < sizeof(elisa_config_bin_t)) return NULL;
+    const elisa_config_bin_t *img = (const elisa_config_bin_t *)slot;
+    const elisa_config_bin_header_t *h = &img->header;
+
+    if (h->magic != ELISA_CONFIG_BIN_MAGIC || h->version != ELISA_CONFIG_BIN_VERSION ||
+        h->header_size != sizeof(*h) || h->payload_size != ELISA_CONFIG_BIN_PAYLOAD_SIZE) {
+        return NULL;
+    }
+    if (elisa_config_crc32(&img->config, h->payload_size) != h->crc32) return NULL;
+    if (!strings_terminated(&img->config) || !values_in_range(img)) return NULL;
+    return img;
+}
+
+const elisa_config_bin_t *elisa_config_bin_select(const void *part, size_t size, int *slot_out) {
+    const elisa_config_bin_t *best = NULL;
+    for (int i = 0; i < ELISA_CONFIG_BIN_SLOTS; i++) {
+        size_t off = (size_t)i * ELISA_CONFIG_BIN_SLOT_SIZE;
+        if (off + ELISA_CONFIG_BIN_SLOT_SIZE > size) break;
+        const elisa_config_bin_t *img =
+            elisa_config_bin_check((const uint8_t *)part + off, ELISA_CONFIG_BIN_SLOT_SIZE);
+        /* Generations compare in serial-number order, so wraparound is harmless */
+        if (img != NULL &&
+            (best == NULL || (int32_t)(img->header.generation - best->header.generation) > 0)) {
+            best = img;
+            if (slot_out != NULL) *slot_out = i;
+        }
+    }
+    return best;
+}
@@ -0,0 +1,117 @@
+/**
+ * @file elisa_config_bin.h
+ * @brief Compiled runtime config image, used in place from flash.
+ *
+ * The deploy pipeline compiles runtime_config.json into a fixed-layout
+ * image (backend utils/runtimeConfigBinary.ts) and flashes it to the
+ * elisa_cfg data partition. At boot elisa_config.c maps the partition
+ * and, once the header and CRC check out, points the config getter at the
+ * image itself: no SPIFFS mount, no file read, no JSON tree.
+ *
+ * Layout, little-endian, no padding:
+ *
+ *   offset  size  field
+ *   0       20    elisa_config_bin_header_t
+ *   20      1548  elisa_runtime_config_t (elisa_config.h)
+ *   1568    20    elisa_config_bin_face_t
+ *
+ * The partition holds ELISA_CONFIG_BIN_SLOTS images, one per flash
+ * sector. The valid one with the highest generation wins, so a new image
+ * can be written to the other slot and take over in one step; a slot
+ * that is erased or half written fails its check and is skipped. Live
+ * config updates (elisa_config_apply_update) are written this way.
+ *
+ * Version 2 added the wake thresholds and config_version. Version 3 kept
+ * only wake_cutoff, the one WakeNet takes.
+ *
+ * Plain C with no ESP-IDF dependency so host tools can share it.
+ */
+
+#ifndef ELISA_CONFIG_BIN_H
+#define ELISA_CONFIG_BIN_H
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "elisa_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ELISA_CONFIG_BIN_MAGIC    0x46434C45u  /**< "ELCF" */
+#define ELISA_CONFIG_BIN_VERSION  3
+
+/** Partition: data type, this subtype, this label (partitions.csv). */
+#define ELISA_CONFIG_PARTITION_LABEL   "elisa_cfg"
+#define ELISA_CONFIG_PARTITION_SUBTYPE 0x40
+
+#define ELISA_CONFIG_BIN_SLOT_SIZE 0x1000
+#define ELISA_CONFIG_BIN_SLOTS     2
+
+typedef struct {
+    uint32_t magic;          /**< ELISA_CONFIG_BIN_MAGIC */
+    uint16_t version;        /**< ELISA_CONFIG_BIN_VERSION */
+    uint16_t header_size;    /**< sizeof(elisa_config_bin_header_t) */
+    uint32_t payload_size;   /**< Bytes after the header: config + face */
+    uint32_t generation;     /**< Newest valid slot wins */
+    uint32_t crc32;          /**< CRC-32 (IEEE) of the payload */
+} elisa_config_bin_header_t;
+
+/** Face descriptor with its strings resolved (elisa_face_style.h enums). */
+typedef struct {
+    uint8_t present;         /**< 0 = no face_descriptor, use the defaults */
+    uint8_t shape;
+    uint8_t eye_style;
+    uint8_t eye_size;
+    uint8_t mouth;
+    uint8_t expression;
+    uint8_t reserved[2];
+    uint32_t eye_rgb;
+    uint32_t face_rgb;
+    uint32_t accent_rgb;
+} elisa_config_bin_face_t;
+
+typedef struct {
+    elisa_config_bin_header_t header;
+    elisa_runtime_config_t config;
+    elisa_config_bin_face_t face;
+} elisa_config_bin_t;
+
+#define ELISA_CONFIG_BIN_PAYLOAD_SIZE \
+    (sizeof(elisa_runtime_config_t) + sizeof(elisa_config_bin_face_t))
+
+static_assert(sizeof(elisa_config_bin_header_t) == 20, "config image header layout");
+static_assert(sizeof(elisa_runtime_config_t) == 1548, "config image payload layout");
+static_assert(offsetof(elisa_runtime_config_t, wake_cutoff_pct) == 1539, "config image wake cutoff");
+static_assert(offsetof(elisa_runtime_config_t, config_version) == 1544, "config image version");
+static_assert(offsetof(elisa_config_bin_t, face) == 1568, "config image face layout");
+static_assert(sizeof(elisa_config_bin_t) == 1588, "config image size");
+static_assert(sizeof(elisa_config_bin_t) <= ELISA_CONFIG_BIN_SLOT_SIZE, "config image slot");
+
+/** CRC-32 (IEEE 802.3, as zlib's crc32()) of len bytes. */
+uint32_t elisa_config_crc32(const void *data, size_t len);
+
+/**
+ * Check one slot: magic, version, sizes, CRC, NUL-terminated strings,
+ * enums and wake thresholds in range.
+ *
+ * @return The slot as an image, or NULL if it is not a valid one
+ */
+const elisa_config_bin_t *elisa_config_bin_check(const void *slot, size_t size);
+
+/**
+ * Pick the valid slot with the highest generation out of the partition
+ * contents (ELISA_CONFIG_BIN_SLOTS slots of ELISA_CONFIG_BIN_SLOT_SIZE).
+ *
+ * @param slot_out Index of the slot picked, if not NULL
+ * @return The image, or NULL if no slot is valid
+ */
+const elisa_config_bin_t *elisa_config_bin_select(const void *part, size_t size, int *slot_out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ELISA_CONFIG_BIN_H */
@@ -0,0 +1,137 @@
+/**
+ * @file elisa_dirty.c
+ * @brief Dirty-rectangle list and diffing blit.
+ */
+
+#include "elisa_dirty.h"
+
+#include <string.h>
+
+// ── Rectangle Helpers ───────────────────────────────────────────────────
+
+static uint32_t area(const elisa_rect_t *r) {
+    return (uint32_t)r->w * r->h;
+}
+
+static elisa_rect_t bounds(const elisa_rect_t *a, const elisa_rect_t *b) {
+    int x1 = a->x < b->x ? a->x : b->x;
+    int y1 = a->y < b->y ? a->y : b->y;
+    int x2 = (a->x + a->w > b->x + b->w) ? a->x + a->w : b->x + b->w;
+    int y2 = (a->y + a->h > b->y + b->h) ? a->y + a->h : b->y + b->h;
+    elisa_rect_t u = { (int16_t)x1, (int16_t)y1, (uint16_t)(x2 - x1), (uint16_t)(y2 - y1) };
+    return u;
+}
+
+/** Extra flushed pixels if a and b become one rectangle (negative: a win). */
+static int32_t merge_cost(const elisa_rect_t *a, const elisa_rect_t *b) {
+    elisa_rect_t u = bounds(a, b);
+    return (int32_t)area(&u) - (int32_t)area(a) - (int32_t)area(b) - ELISA_DIRTY_FLUSH_COST_PX;
+}
+
+static void remove_at(elisa_dirty_t *d, int i) {
+    d->rect[i] = d->rect[--d->count];
+}
+
+// ── List ────────────────────────────────────────────────────────────────
+
+void elisa_dirty_reset(elisa_dirty_t *d) {
+    d->count = 0;
+}
+
+void elisa_dirty_add(elisa_dirty_t *d, const elisa_rect_t *r) {
+    if (r->w == 0 || r->h == 0) return;
+    elisa_rect_t cur = *r;
+
+    /* Absorb every rectangle the new one is worth merging with */
+    for (int i = 0; i < d->count;) {
+        if (merge_cost(&cur, &d->rect[i]) <= 0) {
+            cur = bounds(&cur, &d->rect[i]);
+            remove_at(d, i);
+            i = 0; /* the grown rectangle may now reach earlier ones */
+        } else {
+            i++;
+        }
+    }
+
+    if (d->count < ELISA_DIRTY_MAX) {
+        d->rect[d->count++] = cur;
+        return;
+    }
+
+    /* Full: fold the new rectangle into its cheapest partner */
+    int best = 0;
+    int32_t best_cost = merge_cost(&cur, &d->rect[0]);
+    for (int i = 1; i < d->count; i++) {
+        int32_t c = merge_cost(&cur, &d->rect[i]);
+        if (c < best_cost) {
+            best_cost = c;
+            best = i;
+        }
+    }
+    d->rect[best] = bounds(&cur, &d->rect[best]);
+}
+
+uint32_t elisa_dirty_area(const elisa_dirty_t *d) {
+    uint32_t px = 0;
+    for (int i = 0; i < d->count; i++) px += area(&d->rect[i]);
+    return px;
+}
+
+void elisa_dirty_align(elisa_rect_t *r, int origin_x, int limit_w) {
+    int ax = origin_x + r->x;
+    int x1 = ax - (((ax % ELISA_DIRTY_ALIGN_X) + ELISA_DIRTY_ALIGN_X) % ELISA_DIRTY_ALIGN_X);
+    int x2 = ax + r->w;
+    x2 += (ELISA_DIRTY_ALIGN_X - (((x2 % ELISA_DIRTY_ALIGN_X) + ELISA_DIRTY_ALIGN_X) %
+                                  ELISA_DIRTY_ALIGN_X)) % ELISA_DIRTY_ALIGN_X;
+    x1 -= origin_x;
+    x2 -= origin_x;
+    if (x1 < 0) x1 = 0;
+    if (x2 > limit_w) x2 = limit_w;
+    r->x = (int16_t)x1;
+    r->w = (uint16_t)(x2 - x1);
+}
+
+// ── Diffing Blit ────────────────────────────────────────────────────────
+
+uint32_t elisa_dirty_diff_blit(uint16_t *dst, uint16_t dst_w, const elisa_rect_t *rect,
+                               const uint16_t *src, elisa_dirty_t *d) {
+    uint32_t copied = 0;
+    int band_y = -1, band_x1 = 0, band_x2 = 0;
+
+    for (int y = 0; y <= rect->h; y++) {
+        int x1 = -1, x2 = -1;
+        if (y < rect->h) {
+            uint16_t *drow = dst + (size_t)(rect->y + y) * dst_w + rect->x;
+            const uint16_t *srow = src + (size_t)y * rect->w;
+            for (int x = 0; x < rect->w; x++) {
+                if (drow[x] != srow[x]) {
+                    if (x1 < 0) x1 = x;
+                    x2 = x;
+                }
+            }
+            if (x1 >= 0) {
+                memcpy(drow + x1, srow + x1, (size_t)(x2 - x1 + 1) * sizeof(uint16_t));
+                copied += (uint32_t)(x2 - x1 + 1);
+            }
+        }
+
+        if (x1 >= 0) {
+            if (band_y < 0) {
+                band_y = y;
+                band_x1 = x1;
+                band_x2 = x2;
+            } else {
+                if (x1 < band_x1) band_x1 = x1;
+                if (x2 > band_x2) band_x2 = x2;
+            }
+        } else if (band_y >= 0) {
+            elisa_rect_t band = {
+                (int16_t)(rect->x + band_x1), (int16_t)(rect->y + band_y),
+                (uint16_t)(band_x2 - band_x1 + 1), (uint16_t)(y - band_y),
+            };
+            elisa_dirty_add(d, &band);
+            band_y = -1;
+        }
+    }
+    return copied;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file elisa_dirty.h
+ * @brief Dirty-rectangle collection for partial display updates.
+ *
+ * Each rectangle LVGL invalidates becomes one SPI flush: a window command
+ * (CASET/RASET/RAMWR) plus the pixels. Many tiny flushes waste the
+ * command overhead, one big flush resends unchanged pixels. The list keeps
+ * rectangles separate while that is cheaper and merges them when the
+ * union costs less than ELISA_DIRTY_FLUSH_COST_PX extra pixels.
+ *
+ * elisa_dirty_diff_blit() produces the rectangles: it copies a source
+ * image into a destination and reports only the rows and columns whose
+ * pixels actually changed.
+ *
+ * Plain C with no LVGL or ESP-IDF dependency so host tools can share it.
+ */
+
+#ifndef ELISA_DIRTY_H
+#define ELISA_DIRTY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "elisa_face_atlas.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Most rectangles kept before the cheapest pair is merged. */
+#define ELISA_DIRTY_MAX            8
+
+/** Fixed cost of one flush, in pixel-equivalents of SPI time. */
+#define ELISA_DIRTY_FLUSH_COST_PX  256
+
+/** Column alignment of flushed areas (2 px keeps DMA lengths word sized). */
+#define ELISA_DIRTY_ALIGN_X        2
+
+typedef struct {
+    elisa_rect_t rect[ELISA_DIRTY_MAX];
+    int count;
+} elisa_dirty_t;
+
+/** Empty the list. */
+void elisa_dirty_reset(elisa_dirty_t *d);
+
+/** Add a rectangle, merging with existing ones where that is cheaper. */
+void elisa_dirty_add(elisa_dirty_t *d, const elisa_rect_t *r);
+
+/** Total pixels covered by the list. */
+uint32_t elisa_dirty_area(const elisa_dirty_t *d);
+
+/**
+ * Copy src (rect->w x rect->h) into dst (dst_w wide) at rect, adding one
+ * dirty rectangle per run of changed rows, spanning the changed columns.
+ * Unchanged rows are neither copied nor reported.
+ *
+ * @return Pixels copied
+ */
+uint32_t elisa_dirty_diff_blit(uint16_t *dst, uint16_t dst_w, const elisa_rect_t *rect,
+                               const uint16_t *src, elisa_dirty_t *d);
+
+/**
+ * Grow r so x and width are multiples of ELISA_DIRTY_ALIGN_X relative to
+ * origin_x, clipped to [0, limit_w).
+ */
+void elisa_dirty_align(elisa_rect_t *r, int origin_x, int limit_w);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ELISA_DIRTY_H */
@@ -0,0 +1,312 @@
+/**
+ * @file elisa_draw.c
+ * @brief Draw list building and signed-distance rasterization.
+ *
+ * Coverage comes from the signed distance to each primitive at the pixel
+ * center, which gives one pixel of anti-aliasing on every edge. Ellipses
+ * use a first-order distance estimate, exact for circles and within a
+ * fraction of a pixel for the mild ellipses a face uses. This runs once
+ * at init, so it favours simplicity over speed, but each primitive only
+ * visits the pixels inside its bounds.
+ */
+
+#include "elisa_draw.h"
+
+#include <math.h>
+
+/* Segments per flattened curve */
+#define QUAD_SEGMENTS   8
+#define CUBIC_SEGMENTS  12
+
+// ── Pixel Helpers ───────────────────────────────────────────────────────
+
+static uint16_t rgb565(uint32_t rgb) {
+    return (uint16_t)(((rgb >> 8) & 0xF800) | ((rgb >> 5) & 0x07E0) | ((rgb >> 3) & 0x001F));
+}
+
+/** Blend rgb over a 565 pixel with alpha 0..255. */
+static uint16_t blend565(uint16_t dst, uint32_t rgb, uint32_t alpha) {
+    uint32_t dr = (dst >> 11) & 0x1F, dg = (dst >> 5) & 0x3F, db = dst & 0x1F;
+    uint32_t sr = (rgb >> 19) & 0x1F, sg = (rgb >> 10) & 0x3F, sb = (rgb >> 3) & 0x1F;
+    uint32_t inv = 255 - alpha;
+    uint32_t r = (sr * alpha + dr * inv + 127) / 255;
+    uint32_t g = (sg * alpha + dg * inv + 127) / 255;
+    uint32_t b = (sb * alpha + db * inv + 127) / 255;
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+static int16_t q4(float v) {
+    return (int16_t)lroundf(v * ELISA_DRAW_Q);
+}
+
+static float unq4(int16_t v) {
+    return (float)v / ELISA_DRAW_Q;
+}
+
+// ── Building ────────────────────────────────────────────────────────────
+
+void elisa_draw_reset(elisa_draw_list_t *l) {
+    l->n_ops = 0;
+    l->n_points = 0;
+    l->overflow = false;
+}
+
+static elisa_draw_op_t *add_op(elisa_draw_list_t *l, elisa_draw_kind_t kind,
+                               elisa_paint_t paint, uint8_t alpha) {
+    if (l->n_ops >= ELISA_DRAW_MAX_OPS) {
+        l->overflow = true;
+        return NULL;
+    }
+    elisa_draw_op_t *op = &l->op[l->n_ops++];
+    *op = (elisa_draw_op_t){ .kind = (uint8_t)kind, .paint = (uint8_t)paint, .alpha = alpha };
+    return op;
+}
+
+void elisa_draw_ellipse(elisa_draw_list_t *l, float cx, float cy, float rx, float ry,
+                        elisa_paint_t paint, uint8_t alpha) {
+    elisa_draw_op_t *op = add_op(l, ELISA_DRAW_ELLIPSE, paint, alpha);
+    if (op == NULL) return;
+    op->x = q4(cx);
+    op->y = q4(cy);
+    op->rx = q4(rx);
+    op->ry = q4(ry);
+}
+
+void elisa_draw_ellipse_stroke(elisa_draw_list_t *l, float cx, float cy, float rx, float ry,
+                               float width, elisa_paint_t paint, uint8_t alpha) {
+    elisa_draw_op_t *op = add_op(l, ELISA_DRAW_ELLIPSE_STROKE, paint, alpha);
+    if (op == NULL) return;
+    op->x = q4(cx);
+    op->y = q4(cy);
+    op->rx = q4(rx);
+    op->ry = q4(ry);
+    op->width = q4(width);
+}
+
+void elisa_draw_rect(elisa_draw_list_t *l, float x, float y, float w, float h, float radius,
+                     elisa_paint_t paint, uint8_t alpha) {
+    elisa_draw_op_t *op = add_op(l, ELISA_DRAW_RECT, paint, alpha);
+    if (op == NULL) return;
+    op->x = q4(x + w * 0.5f);
+    op->y = q4(y + h * 0.5f);
+    op->rx = q4(w * 0.5f);
+    op->ry = q4(h * 0.5f);
+    op->width = q4(radius);
+}
+
+static void add_point(elisa_draw_list_t *l, float x, float y) {
+    if (l->n_ops == 0 || l->op[l->n_ops - 1].kind != ELISA_DRAW_POLYLINE) {
+        l->overflow = true;  /* segment without a path */
+        return;
+    }
+    if (l->n_points >= ELISA_DRAW_MAX_POINTS) {
+        l->overflow = true;
+        return;
+    }
+    l->pt[l->n_points][0] = q4(x);
+    l->pt[l->n_points][1] = q4(y);
+    l->n_points++;
+    l->op[l->n_ops - 1].npoints++;
+}
+
+/** Last point of the open path. */
+static void path_end(const elisa_draw_list_t *l, float *x, float *y) {
+    *x = unq4(l->pt[l->n_points - 1][0]);
+    *y = unq4(l->pt[l->n_points - 1][1]);
+}
+
+void elisa_draw_path(elisa_draw_list_t *l, float x, float y, float width,
+                     elisa_paint_t paint, uint8_t alpha) {
+    elisa_draw_op_t *op = add_op(l, ELISA_DRAW_POLYLINE, paint, alpha);
+    if (op == NULL) return;
+    op->first = l->n_points;
+    op->width = q4(width);
+    add_point(l, x, y);
+}
+
+void elisa_draw_line_to(elisa_draw_list_t *l, float x, float y) {
+    add_point(l, x, y);
+}
+
+void elisa_draw_quad_to(elisa_draw_list_t *l, float cx, float cy, float x, float y) {
+    if (l->overflow || l->n_points == 0) { l->overflow = true; return; }
+    float x0, y0;
+    path_end(l, &x0, &y0);
+    for (int i = 1; i <= QUAD_SEGMENTS; i++) {
+        float t = (float)i / QUAD_SEGMENTS, u = 1.0f - t;
+        add_point(l, u * u * x0 + 2 * u * t * cx + t * t * x,
+                     u * u * y0 + 2 * u * t * cy + t * t * y);
+    }
+}
+
+void elisa_draw_cubic_to(elisa_draw_list_t *l, float c1x, float c1y, float c2x, float c2y,
+                         float x, float y) {
+    if (l->overflow || l->n_points == 0) { l->overflow = true; return; }
+    float x0, y0;
+    path_end(l, &x0, &y0);
+    for (int i = 1; i <= CUBIC_SEGMENTS; i++) {
+        float t = (float)i / CUBIC_SEGMENTS, u = 1.0f - t;
+        float a = u * u * u, b = 3 * u * u * t, c = 3 * u * t * t, d = t * t * t;
+        add_point(l, a * x0 + b * c1x + c * c2x + d * x,
+                     a * y0 + b * c1y + c * c2y + d * y);
+    }
+}
+
+// ── Distance ────────────────────────────────────────────────────────────
+
+static float ellipse_distance(float px, float py, float rx, float ry) {
+    if (rx == ry) return sqrtf(px * px + py * py) - rx;
+    if (rx <= 0 || ry <= 0) return INFINITY;
+    float k0 = sqrtf((px / rx) * (px / rx) + (py / ry) * (py / ry));
+    float k1 = sqrtf((px / (rx * rx)) * (px / (rx * rx)) + (py / (ry * ry)) * (py / (ry * ry)));
+    if (k1 == 0) return -fminf(rx, ry);
+    return k0 * (k0 - 1.0f) / k1;
+}
+
+static float rect_distance(float px, float py, float hw, float hh, float radius) {
+    float rmax = fminf(hw, hh);
+    if (radius > rmax) radius = rmax;
+    float qx = fabsf(px) - (hw - radius), qy = fabsf(py) - (hh - radius);
+    float ox = fmaxf(qx, 0), oy = fmaxf(qy, 0);
+    return sqrtf(ox * ox + oy * oy) + fminf(fmaxf(qx, qy), 0) - radius;
+}
+
+static float segment_distance(float px, float py, float ax, float ay, float bx, float by) {
+    float dx = bx - ax, dy = by - ay;
+    float len2 = dx * dx + dy * dy;
+    float t = (len2 > 0) ? ((px - ax) * dx + (py - ay) * dy) / len2 : 0;
+    if (t < 0) t = 0;
+    if (t > 1) t = 1;
+    float ex = px - (ax + t * dx), ey = py - (ay + t * dy);
+    return sqrtf(ex * ex + ey * ey);
+}
+
+/** Signed distance (px, list units) from (x, y) to op. */
+static float op_distance(const elisa_draw_list_t *l, const elisa_draw_op_t *op, float x, float y) {
+    float cx = unq4(op->x), cy = unq4(op->y);
+    float rx = unq4(op->rx), ry = unq4(op->ry), w = unq4(op->width);
+
+    switch (op->kind) {
+    case ELISA_DRAW_ELLIPSE:
+        return ellipse_distance(x - cx, y - cy, rx, ry);
+    case ELISA_DRAW_ELLIPSE_STROKE:
+        return fabsf(ellipse_distance(x - cx, y - cy, rx, ry)) - w * 0.5f;
+    case ELISA_DRAW_RECT:
+        return rect_distance(x - cx, y - cy, rx, ry, w);
+    case ELISA_DRAW_POLYLINE: {
+        const int16_t (*p)[2] = &l->pt[op->first];
+        float d = INFINITY;
+        if (op->npoints == 1) {
+            d = segment_distance(x, y, unq4(p[0][0]), unq4(p[0][1]), unq4(p[0][0]), unq4(p[0][1]));
+        }
+        for (int i = 1; i < op->npoints; i++) {
+            float s = segment_distance(x, y, unq4(p[i - 1][0]), unq4(p[i - 1][1]),
+                                       unq4(p[i][0]), unq4(p[i][1]));
+            if (s < d) d = s;
+        }
+        return d - w * 0.5f;
+    }
+    default:
+        return INFINITY;
+    }
+}
+
+/** Bounds of op in list units: x0, y0, x1, y1. */
+static void op_bounds(const elisa_draw_list_t *l, const elisa_draw_op_t *op, float b[4]) {
+    float half_w = unq4(op->width) * 0.5f;
+    if (op->kind == ELISA_DRAW_POLYLINE) {
+        const int16_t (*p)[2] = &l->pt[op->first];
+        b[0] = b[2] = unq4(p[0][0]);
+        b[1] = b[3] = unq4(p[0][1]);
+        for (int i = 1; i < op->npoints; i++) {
+            b[0] = fminf(b[0], unq4(p[i][0]));
+            b[1] = fminf(b[1], unq4(p[i][1]));
+            b[2] = fmaxf(b[2], unq4(p[i][0]));
+            b[3] = fmaxf(b[3], unq4(p[i][1]));
+        }
+    } else {
+        float cx = unq4(op->x), cy = unq4(op->y);
+        float rx = unq4(op->rx), ry = unq4(op->ry);
+        if (op->kind != ELISA_DRAW_ELLIPSE_STROKE) half_w = 0; /* RECT: width is a radius */
+        b[0] = cx - rx;
+        b[1] = cy - ry;
+        b[2] = cx + rx;
+        b[3] = cy + ry;
+    }
+    b[0] -= half_w;
+    b[1] -= half_w;
+    b[2] += half_w;
+    b[3] += half_w;
+}
+
+// ── Rendering ───────────────────────────────────────────────────────────
+
+elisa_rect_t elisa_draw_bounds(const elisa_draw_list_t *l, float scale) {
+    if (l->n_ops == 0) return (elisa_rect_t){ 0, 0, 0, 0 };
+
+    float u[4];
+    op_bounds(l, &l->op[0], u);
+    for (int i = 1; i < l->n_ops; i++) {
+        float b[4];
+        op_bounds(l, &l->op[i], b);
+        u[0] = fminf(u[0], b[0]);
+        u[1] = fminf(u[1], b[1]);
+        u[2] = fmaxf(u[2], b[2]);
+        u[3] = fmaxf(u[3], b[3]);
+    }
+    /* One pixel of anti-aliasing fringe on each side */
+    int x0 = (int)floorf(u[0] * scale) - 1, y0 = (int)floorf(u[1] * scale) - 1;
+    int x1 = (int)ceilf(u[2] * scale) + 1, y1 = (int)ceilf(u[3] * scale) + 1;
+    return (elisa_rect_t){ (int16_t)x0, (int16_t)y0, (uint16_t)(x1 - x0), (uint16_t)(y1 - y0) };
+}
+
+void elisa_draw_clear(uint16_t *img, const elisa_rect_t *rect, uint32_t rgb) {
+    uint16_t c = rgb565(rgb);
+    for (size_t i = 0; i < (size_t)rect->w * rect->h; i++) img[i] = c;
+}
+
+void elisa_draw_raster(uint16_t *img, const elisa_rect_t *rect, const elisa_draw_list_t *l,
+                       const elisa_draw_xform_t *xf, const uint32_t palette[ELISA_PAINT_COUNT]) {
+    if (xf->scale <= 0 || xf->alpha == 0) return;
+    float inv = 1.0f / xf->scale;
+
+    for (int i = 0; i < l->n_ops; i++) {
+        const elisa_draw_op_t *op = &l->op[i];
+        uint32_t alpha = (uint32_t)op->alpha * xf->alpha / 255;
+        if (alpha == 0) continue;
+
+        /* Visit only the op's bounds, clipped to the image */
+        float b[4];
+        op_bounds(l, op, b);
+        int x0 = (int)floorf(xf->ox + b[0] * xf->scale) - 1 - rect->x;
+        int y0 = (int)floorf(xf->oy + b[1] * xf->scale) - 1 - rect->y;
+        int x1 = (int)ceilf(xf->ox + b[2] * xf->scale) + 1 - rect->x;
+        int y1 = (int)ceilf(xf->oy + b[3] * xf->scale) + 1 - rect->y;
+        if (x0 < 0) x0 = 0;
+        if (y0 < 0) y0 = 0;
+        if (x1 > rect->w) x1 = rect->w;
+        if (y1 > rect->h) y1 = rect->h;
+
+        uint32_t rgb = palette[op->paint];
+        for (int y = y0; y < y1; y++) {
+            float py = (float)(rect->y + y) + 0.5f;
+            float band = 1.0f;
+            if (xf->clip_half_h >= 0) {
+                band = xf->clip_half_h + 0.5f - fabsf(py - xf->oy);
+                if (band <= 0) continue;
+                if (band > 1) band = 1;
+            }
+            float ly = (py - xf->oy) * inv;
+            for (int x = x0; x < x1; x++) {
+                float lx = ((float)(rect->x + x) + 0.5f - xf->ox) * inv;
+                float cover = 0.5f - op_distance(l, op, lx, ly) * xf->scale;
+                if (cover <= 0) continue;
+                if (cover > 1) cover = 1;
+                uint32_t a = (uint32_t)(cover * band * (float)alpha + 0.5f);
+                if (a == 0) continue;
+                uint16_t *p = &img[(size_t)y * rect->w + x];
+                *p = blend565(*p, rgb, a);
+            }
+        }
+    }
+}
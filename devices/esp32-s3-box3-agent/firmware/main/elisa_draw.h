@@ -0,0 +1,133 @@
+/**
+ * @file elisa_draw.h
+ * @brief Compact vector draw lists and their anti-aliased rasterizer.
+ *
+ * A draw list is a short sequence of primitives (filled or stroked
+ * ellipses, rounded rectangles, stroked polylines) in fixed-point
+ * coordinates around an origin. Curves are flattened into polylines when
+ * they are added, so the rasterizer only knows four shapes. Colors are
+ * palette slots, not RGB, so one list renders the normal and the error
+ * face.
+ *
+ * Lists are compiled once from the face descriptor and rasterized into
+ * the face atlas at init; nothing here runs per frame.
+ *
+ * Plain C with no LVGL or ESP-IDF dependency so host tools can share it.
+ */
+
+#ifndef ELISA_DRAW_H
+#define ELISA_DRAW_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Most primitives and polyline points in one list. */
+#define ELISA_DRAW_MAX_OPS     8
+#define ELISA_DRAW_MAX_POINTS  48
+
+/** Coordinates are Q4 (1/16 px). */
+#define ELISA_DRAW_Q           16
+
+/** Rectangle in face-box coordinates. */
+typedef struct {
+    int16_t x, y;
+    uint16_t w, h;
+} elisa_rect_t;
+
+typedef enum {
+    ELISA_DRAW_ELLIPSE,         /**< Filled ellipse */
+    ELISA_DRAW_ELLIPSE_STROKE,  /**< Ellipse outline */
+    ELISA_DRAW_RECT,            /**< Filled rounded rectangle */
+    ELISA_DRAW_POLYLINE,        /**< Stroked polyline, round caps and joins */
+} elisa_draw_kind_t;
+
+/** Palette slots. */
+typedef enum {
+    ELISA_PAINT_FACE,
+    ELISA_PAINT_FEATURE,        /**< Eyes and mouth */
+    ELISA_PAINT_ACCENT,         /**< Cheeks */
+    ELISA_PAINT_WHITE,
+    ELISA_PAINT_DARK,           /**< Inside of an open mouth */
+    ELISA_PAINT_COUNT,
+} elisa_paint_t;
+
+typedef struct {
+    uint8_t kind;               /**< elisa_draw_kind_t */
+    uint8_t paint;              /**< elisa_paint_t */
+    uint8_t alpha;              /**< 0..255 */
+    uint8_t npoints;            /**< POLYLINE: points from `first` */
+    uint16_t first;
+    int16_t x, y;               /**< Center (ellipse, rect) */
+    int16_t rx, ry;             /**< Half width and height */
+    int16_t width;              /**< Stroke width; RECT: corner radius */
+} elisa_draw_op_t;
+
+typedef struct {
+    elisa_draw_op_t op[ELISA_DRAW_MAX_OPS];
+    int16_t pt[ELISA_DRAW_MAX_POINTS][2];
+    uint8_t n_ops;
+    uint8_t n_points;
+    bool overflow;              /**< An add did not fit; the list is incomplete */
+} elisa_draw_list_t;
+
+/** Placement of a list in the image: origin, uniform scale, optional clip. */
+typedef struct {
+    float ox, oy;               /**< Where the list origin lands, face-box px */
+    float scale;
+    float clip_half_h;          /**< Keep only |y - oy| <= this (eyelids); < 0 for none */
+    uint8_t alpha;              /**< Applied to every primitive */
+} elisa_draw_xform_t;
+
+// ── Building ────────────────────────────────────────────────────────────
+
+void elisa_draw_reset(elisa_draw_list_t *l);
+
+void elisa_draw_ellipse(elisa_draw_list_t *l, float cx, float cy, float rx, float ry,
+                        elisa_paint_t paint, uint8_t alpha);
+
+void elisa_draw_ellipse_stroke(elisa_draw_list_t *l, float cx, float cy, float rx, float ry,
+                               float width, elisa_paint_t paint, uint8_t alpha);
+
+void elisa_draw_rect(elisa_draw_list_t *l, float x, float y, float w, float h, float radius,
+                     elisa_paint_t paint, uint8_t alpha);
+
+/**
+ * Start a stroked path at (x, y). Segments added with the *_to calls
+ * extend it until the next primitive or path starts.
+ */
+void elisa_draw_path(elisa_draw_list_t *l, float x, float y, float width,
+                     elisa_paint_t paint, uint8_t alpha);
+void elisa_draw_line_to(elisa_draw_list_t *l, float x, float y);
+void elisa_draw_quad_to(elisa_draw_list_t *l, float cx, float cy, float x, float y);
+void elisa_draw_cubic_to(elisa_draw_list_t *l, float c1x, float c1y, float c2x, float c2y,
+                         float x, float y);
+
+// ── Rendering ───────────────────────────────────────────────────────────
+
+/**
+ * Pixel bounds of a list drawn at scale around its origin, including
+ * the anti-aliasing fringe. x and y are offsets from the origin.
+ */
+elisa_rect_t elisa_draw_bounds(const elisa_draw_list_t *l, float scale);
+
+/** Fill an image covering rect with one color (0xRRGGBB). */
+void elisa_draw_clear(uint16_t *img, const elisa_rect_t *rect, uint32_t rgb);
+
+/**
+ * Blend a list into an RGB565 image covering rect (face-box coordinates).
+ *
+ * @param palette 0xRRGGBB per elisa_paint_t
+ */
+void elisa_draw_raster(uint16_t *img, const elisa_rect_t *rect, const elisa_draw_list_t *l,
+                       const elisa_draw_xform_t *xf, const uint32_t palette[ELISA_PAINT_COUNT]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ELISA_DRAW_H */
@@ -2,24 +2,91 @@
  * @file elisa_face.c
  * @brief LVGL face rendering implementation for BOX-3 display.
  *
- * Renders the agent face using LVGL primitives on the 320x240 screen.
- * All shapes are basic geometry (circles, arcs, lines) to keep rendering
- * identical between firmware (LVGL) and browser preview (SVG).
+ * Renders the agent face on the 320x240 screen. The face descriptor is
+ * compiled into draw lists laid out like the browser preview (SVG), see
+ * elisa_face_style.c, so both render the same face.
  *
- * ANIMATION TICK:
- * A 30ms LVGL timer drives all animations (blink, pulse, mouth movement).
- * State transitions reset animation counters and start new ones.
+ * RENDERING:
+ * The face is pre-rendered at init into an RGB565 atlas in PSRAM
+ * (elisa_face_atlas.c): background variants, eye frames and mouth frames.
+ * The screen shows one LVGL canvas whose buffer is composed from atlas
+ * frames. Animating copies only the eye or mouth box that changed into the
+ * canvas buffer and invalidates that box, so LVGL never re-lays out objects
+ * or redraws shapes at runtime.
+ *
+ * DIRTY RECTANGLES:
+ * Frames are copied with a diffing blit (elisa_dirty.c) that only touches
+ * rows whose pixels differ and reports one rectangle per run of changed
+ * rows. The rectangles are merged when one flush is cheaper than two,
+ * aligned to the flush column granularity and only then invalidated, so
+ * the SPI bus carries the changed pixels rather than whole feature boxes.
+ * The display driver's monitor_cb counts what was actually flushed, per
+ * face state.
+ *
+ * EXPRESSIONS:
+ * Each face state is a row of s_expressions: a background plus one
+ * keyframe track per element (eye frame, mouth opening, mouth fade),
+ * and whether the eyes blink or the mouth follows speech. While speaking,
+ * the mouth shows the latest viseme (elisa_viseme.h) posted by the audio
+ * path: a resting or closed mouth, an opening sized by the level, or a
+ * wide, round or teeth shape in three sizes.
+ * The elements are played by fixed-point players (elisa_anim.c); on a
+ * state change every player blends from the frame it shows into the new
+ * track, so eyes widen or droop smoothly instead of jumping. A new
+ * expression is a table row, not code.
+ *
+ * ANIMATION CLOCK:
+ * One LVGL timer drives all animations, but it only fires when something
+ * is due: after each tick face_next_deadline() works out when the shown
+ * frames next change (the blink countdown, the next frame of a track or
+ * blend) and the timer is re-armed for exactly that, or paused when the
+ * face is static. State changes wake it, and so do speech commands that
+ * change the mouth, so the mouth moves when the audio says so rather
+ * than on a polling period. Players
+ * advance by the measured elapsed time, not a fixed step, so late or
+ * early ticks do not drift the animation.
+ *
+ * COMMAND QUEUE:
+ * Everything above belongs to the LVGL task. Other tasks (app_main, the
+ * speech-recognition handler, the audio player callback) only post
+ * commands to a bounded lock-free MPSC ring: a producer claims a slot
+ * with one compare-and-swap on the head and publishes it by writing the
+ * slot's sequence number, so the audio and network paths pay one enqueue
+ * and never wait on the LVGL lock. A post also resumes a drain timer
+ * that is paused while the ring is empty, so an idle face costs no
+ * wakeups; the LVGL task runs it on its next pass, and every animation
+ * tick drains too, so speech levels are as fresh as the frame they drive.
+ *
+ * RESTYLING:
+ * A live config update posts a new descriptor (elisa_face_set_descriptor).
+ * The LVGL task renders a second atlas for it while the old one is still
+ * shown, then swaps the canvas over and frees the old one; if the new
+ * atlas does not fit in memory, the face keeps its current style.
  */
 
 #include "elisa_face.h"
 
-#include <math.h>
+#include <stdatomic.h>
 #include <string.h>
 
+#include "freertos/FreeRTOS.h"
+#include "esp_heap_caps.h"
 #include "esp_log.h"
 #include "esp_random.h"
+#include "esp_timer.h"
 #include "lvgl.h"
 
+#include "elisa_anim.h"
+#include "elisa_cancel.h"
+#include "elisa_dirty.h"
+#include "elisa_face_atlas.h"
+#include "elisa_face_style.h"
+#include "elisa_ui_timer.h"
+
+#if LV_COLOR_DEPTH != 16
+#error "elisa_face blits RGB565 atlas frames; LV_COLOR_DEPTH must be 16"
+#endif
+
 static const char *TAG = "elisa_face";
 
 // ── Display Constants ───────────────────────────────────────────────────
@@ -29,120 +96,643 @@ static const char *TAG = "elisa_face";
 #define FACE_CX     (SCREEN_W / 2)   /* Face center X */
 #define FACE_CY     (SCREEN_H / 2 - 20) /* Face center Y (shifted up for name) */
 
-/* Eye size lookup (radius in pixels) */
-#define EYE_SIZE_SMALL   8
-#define EYE_SIZE_MEDIUM  12
-#define EYE_SIZE_LARGE   16
-
-/* Eye spacing from center */
-#define EYE_SPACING      35
+#define ERROR_FACE_RGB   0xC83232
 
-/* Blink interval range (ms) */
+/* Blink interval range (ms); a blink closes and reopens the eyes */
 #define BLINK_MIN_MS    3000
 #define BLINK_MAX_MS    5000
-#define BLINK_DURATION  60
+#define BLINK_DURATION  90
+
+/* Blend from one expression into the next */
+#define TRANSITION_MS   150
+
+/* Finest step between keyframed frames, and the longest a tick waits
+ * for a looping track to change */
+#define ANIM_STEP_MS    15
+#define ANIM_HORIZON_MS 1000
+
+/* face_next_deadline(): nothing will change until the next state change */
+#define DEADLINE_NONE   0
 
-/* Animation timer period */
-#define ANIM_TICK_MS    30
+/* Command ring slots (power of two) */
+#define CMD_QUEUE_SIZE  32
+
+#define CMD_QUEUE_MASK  (CMD_QUEUE_SIZE - 1)
+
+_Static_assert((CMD_QUEUE_SIZE & CMD_QUEUE_MASK) == 0,
+               "CMD_QUEUE_SIZE must be a power of two");
 
 // ── Static State ────────────────────────────────────────────────────────
 
 static face_descriptor_t s_desc;
+static elisa_face_style_t s_style;       /* s_desc with its strings resolved */
 static face_state_t s_state = FACE_STATE_IDLE;
-static float s_audio_level = 0.0f;
+static uint8_t s_viseme = ELISA_VISEME_REST;  /* elisa_viseme_t while speaking */
+static uint32_t s_audio_level = 0;       /* Q16, LEVEL_ONE = 1.0 */
 static bool s_initialized = false;
 
+/* Atlas and the canvas buffer composed from it */
+static elisa_face_atlas_t s_atlas;
+static void *s_atlas_mem = NULL;
+static uint16_t *s_frame = NULL;         /* face_w x face_h, shown by s_canvas */
+
+/* Atlas frames currently composed into s_frame */
+typedef struct {
+    uint8_t bg;
+    uint8_t eye;
+    uint8_t mouth;
+} face_frame_t;
+
+#define FRAME_NONE 0xFF
+static face_frame_t s_shown = { FRAME_NONE, FRAME_NONE, FRAME_NONE };
+
 /* LVGL objects */
-static lv_obj_t *s_face_bg = NULL;     /* Face background circle/rect */
-static lv_obj_t *s_eye_left = NULL;    /* Left eye */
-static lv_obj_t *s_eye_right = NULL;   /* Right eye */
-static lv_obj_t *s_mouth = NULL;       /* Mouth line/arc */
-static lv_obj_t *s_name_label = NULL;  /* Agent name text */
+static lv_obj_t *s_canvas = NULL;      /* Face, drawn from s_frame */
 static lv_timer_t *s_anim_timer = NULL; /* Animation tick timer */
+static uint32_t s_last_tick = 0;        /* lv_tick_get() at the last tick */
 
-/* Blink animation state */
-static uint32_t s_blink_countdown = 4000; /* ms until next blink */
+/* Animated face elements, one player each */
+enum { FACE_EYES, FACE_MOUTH, FACE_MOUTH_ALPHA, FACE_ELEMENT_COUNT };
+static elisa_anim_player_t s_player[FACE_ELEMENT_COUNT];
+
+/* Blink, played over the eye track */
+static elisa_anim_player_t s_blink;
 static bool s_blink_active = false;
-static uint32_t s_blink_timer = 0;        /* ms into current blink */
+static uint32_t s_blink_countdown = 4000; /* ms until next blink */
 
-/* Thinking animation state */
-static uint32_t s_think_counter = 0;
+/* Command ring: type in the top byte, argument below */
+enum { CMD_STATE = 1, CMD_AUDIO_LEVEL = 2, CMD_VISEME = 3 };
+#define CMD_MAKE(type, arg)  (((uint32_t)(type) << 24) | ((uint32_t)(arg) & 0xFFFFFF))
+#define CMD_TYPE(cmd)        ((cmd) >> 24)
+#define CMD_ARG(cmd)         ((cmd) & 0xFFFFFF)
+#define LEVEL_ONE            0xFFFF  /* audio level 1.0 in CMD_AUDIO_LEVEL and CMD_VISEME */
+
+/* CMD_VISEME argument: viseme above a 16-bit level */
+#define VISEME_ARG(v, level) (((uint32_t)(v) << 16) | ((level) & 0xFFFF))
+
+_Static_assert(ELISA_VISEME_LEVEL_ONE == LEVEL_ONE, "viseme and face levels differ");
+
+typedef struct {
+    atomic_uint seq;       /* position + 1 once written; position + SIZE once free */
+    uint32_t cmd;
+} face_cmd_slot_t;
+
+static face_cmd_slot_t s_cmd_ring[CMD_QUEUE_SIZE];
+static atomic_uint s_cmd_head;           /* next position to claim (producers) */
+static uint32_t s_cmd_tail = 0;          /* next position to read (LVGL task) */
+static atomic_int s_wanted_state;        /* last state posted, for get_state and overflow */
+static atomic_bool s_cmd_overflow;       /* a command was dropped since the last drain */
+static atomic_uint s_cmd_posted;
+static atomic_uint s_cmd_dropped;
+static elisa_ui_timer_t s_cmd_timer;     /* paused while the ring is empty */
+
+/* Descriptor posted by elisa_face_set_descriptor(), taken by the LVGL task */
+static portMUX_TYPE s_restyle_lock = portMUX_INITIALIZER_UNLOCKED;
+static face_descriptor_t s_restyle_desc;
+static atomic_bool s_restyle_pending;
+
+/* Tick statistics (LVGL task writes, STATS reads) */
+static portMUX_TYPE s_stats_lock = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t s_stat_ticks = 0;
+static uint64_t s_stat_tick_us = 0;
+static uint32_t s_stat_tick_max_us = 0;
+static uint32_t s_stat_blit_px = 0;
+static int64_t s_stat_since_us = 0;
+static elisa_face_state_stats_t s_stat_state[ELISA_FACE_STATE_COUNT];
+static int64_t s_state_since_us = 0;     /* when s_state was entered */
+static void (*s_prev_monitor_cb)(lv_disp_drv_t *, uint32_t, uint32_t) = NULL;
+
+// ── Expressions ─────────────────────────────────────────────────────────
+
+#define Q(v)           ELISA_ANIM_Q(v)
+#define MOUTH_OPAQUE   (ELISA_ATLAS_MOUTH_FADES - 1)
+#define TRACK(keys, loop) { (keys), sizeof(keys) / sizeof((keys)[0]), (loop) }
+
+/* Eye frames (elisa_atlas_eye_t) */
+static const elisa_keyframe_t k_eyes_open[]  = { { 0, Q(ELISA_ATLAS_EYE_OPEN), ELISA_EASE_STEP } };
+static const elisa_keyframe_t k_eyes_wide[]  = { { 0, Q(ELISA_ATLAS_EYE_WIDE), ELISA_EASE_STEP } };
+static const elisa_keyframe_t k_eyes_droop[] = { { 0, Q(ELISA_ATLAS_EYE_OPEN - 1), ELISA_EASE_STEP } };
+static const elisa_keyframe_t k_blink[] = {
+    { 0,                  Q(ELISA_ATLAS_EYE_OPEN),   ELISA_EASE_STEP },
+    { BLINK_DURATION / 2, Q(ELISA_ATLAS_EYE_CLOSED), ELISA_EASE_IN },
+    { BLINK_DURATION,     Q(ELISA_ATLAS_EYE_OPEN),   ELISA_EASE_OUT },
+};
+
+/* Mouth openings (0 = at rest) */
+static const elisa_keyframe_t k_mouth_rest[] = { { 0, Q(0), ELISA_EASE_STEP } };
+static const elisa_keyframe_t k_mouth_ajar[] = { { 0, Q(1), ELISA_EASE_STEP } };
+
+/* Mouth fade levels; two half-cosine segments make a ~1 Hz sine */
+static const elisa_keyframe_t k_alpha_opaque[] = { { 0, Q(MOUTH_OPAQUE), ELISA_EASE_STEP } };
+static const elisa_keyframe_t k_alpha_pulse[] = {
+    { 0,    Q(MOUTH_OPAQUE), ELISA_EASE_STEP },
+    { 500,  Q(0),            ELISA_EASE_IN_OUT },
+    { 1000, Q(MOUTH_OPAQUE), ELISA_EASE_IN_OUT },
+};
+
+static const elisa_anim_track_t t_eyes_open    = TRACK(k_eyes_open, false);
+static const elisa_anim_track_t t_eyes_wide    = TRACK(k_eyes_wide, false);
+static const elisa_anim_track_t t_eyes_droop   = TRACK(k_eyes_droop, false);
+static const elisa_anim_track_t t_blink        = TRACK(k_blink, false);
+static const elisa_anim_track_t t_mouth_rest   = TRACK(k_mouth_rest, false);
+static const elisa_anim_track_t t_mouth_ajar   = TRACK(k_mouth_ajar, false);
+static const elisa_anim_track_t t_alpha_opaque = TRACK(k_alpha_opaque, false);
+static const elisa_anim_track_t t_alpha_pulse  = TRACK(k_alpha_pulse, true);
+
+typedef struct {
+    uint8_t bg;                                          /* elisa_atlas_bg_t */
+    const elisa_anim_track_t *track[FACE_ELEMENT_COUNT]; /* eyes, mouth, mouth fade */
+    bool blinks;          /* random blinks over the eye track */
+    bool mouth_audio;     /* mouth follows the posted visemes */
+} face_expression_t;
+
+static const face_expression_t s_expressions[ELISA_FACE_STATE_COUNT] = {
+    [FACE_STATE_IDLE] = {
+        ELISA_ATLAS_BG_NORMAL, { &t_eyes_open, &t_mouth_rest, &t_alpha_opaque }, true, false },
+    [FACE_STATE_LISTENING] = {
+        ELISA_ATLAS_BG_NORMAL, { &t_eyes_wide, &t_mouth_ajar, &t_alpha_opaque }, false, false },
+    [FACE_STATE_THINKING] = {
+        ELISA_ATLAS_BG_NORMAL, { &t_eyes_open, &t_mouth_rest, &t_alpha_pulse }, false, false },
+    [FACE_STATE_SPEAKING] = {
+        ELISA_ATLAS_BG_NORMAL, { &t_eyes_open, &t_mouth_rest, &t_alpha_opaque }, true, true },
+    [FACE_STATE_ERROR] = {
+        ELISA_ATLAS_BG_ERROR,  { &t_eyes_droop, &t_mouth_rest, &t_alpha_opaque }, false, false },
+};
+
+static uint32_t random_blink_countdown(void) {
+    return BLINK_MIN_MS + (esp_random() % (BLINK_MAX_MS - BLINK_MIN_MS));
+}
 
-// ── Helper: Get eye radius from size string ─────────────────────────────
+// ── Atlas Composition ───────────────────────────────────────────────────
 
-static int get_eye_radius(const char *size_str) {
-    if (strcmp(size_str, "small") == 0) return EYE_SIZE_SMALL;
-    if (strcmp(size_str, "large") == 0) return EYE_SIZE_LARGE;
-    return EYE_SIZE_MEDIUM;
+/** Allocate from PSRAM, falling back to internal RAM. */
+static void *face_alloc(size_t bytes) {
+    void *p = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (p == NULL) {
+        p = heap_caps_malloc(bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    }
+    return p;
 }
 
-// ── Helper: Create LVGL color from uint32_t RGB ─────────────────────────
+static int build_atlas(void) {
+    /* The draw lists are only needed while the atlas is rasterized */
+    elisa_face_geometry_t geom;
+    elisa_face_design_t *design = face_alloc(sizeof(*design));
+    if (design == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate face draw lists");
+        return -1;
+    }
+    if (elisa_face_style_compile(&s_style, design, &geom) != 0) {
+        ESP_LOGE(TAG, "Face style does not fit its draw lists");
+        heap_caps_free(design);
+        return -1;
+    }
+    geom.screen_rgb = 0x000000;
+    geom.error_rgb = ERROR_FACE_RGB;
+    geom.swap_bytes = LV_COLOR_16_SWAP;
+
+    size_t bytes = elisa_face_atlas_size(&geom);
+    s_atlas_mem = face_alloc(bytes);
+    s_frame = face_alloc((size_t)geom.face_w * geom.face_h * sizeof(uint16_t));
+    if (s_atlas_mem == NULL || s_frame == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate %u byte face atlas", (unsigned)bytes);
+        goto fail;
+    }
 
-static lv_color_t make_color(uint32_t rgb) {
-    return lv_color_make((rgb >> 16) & 0xFF, (rgb >> 8) & 0xFF, rgb & 0xFF);
+    int64_t t0 = esp_timer_get_time();
+    if (elisa_face_atlas_build(&s_atlas, &geom, s_atlas_mem, bytes) != 0) {
+        ESP_LOGE(TAG, "Face geometry does not fit its box");
+        goto fail;
+    }
+    ESP_LOGI(TAG, "Face atlas: %u bytes, rendered in %lld us",
+             (unsigned)bytes, (long long)(esp_timer_get_time() - t0));
+    heap_caps_free(design);
+    return 0;
+
+fail:
+    heap_caps_free(design);
+    heap_caps_free(s_atlas_mem);
+    heap_caps_free(s_frame);
+    s_atlas_mem = NULL;
+    s_frame = NULL;
+    return -1;
 }
 
-// ── Animation Timer Callback ────────────────────────────────────────────
+/** Align and invalidate the dirty rectangles (face-box coordinates). */
+static void invalidate_dirty(const elisa_dirty_t *dirty) {
+    lv_area_t canvas;
+    lv_obj_get_coords(s_canvas, &canvas);
+
+    for (int i = 0; i < dirty->count; i++) {
+        elisa_rect_t r = dirty->rect[i];
+        elisa_dirty_align(&r, canvas.x1, s_atlas.face_w);
+        lv_area_t area = {
+            .x1 = (lv_coord_t)(canvas.x1 + r.x),
+            .y1 = (lv_coord_t)(canvas.y1 + r.y),
+            .x2 = (lv_coord_t)(canvas.x1 + r.x + r.w - 1),
+            .y2 = (lv_coord_t)(canvas.y1 + r.y + r.h - 1),
+        };
+        lv_obj_invalidate_area(s_canvas, &area);
+    }
+}
 
 /**
- * Called every ANIM_TICK_MS to update face animations.
- *
- * - IDLE: periodic blink (hide eyes for ~60ms every 3-5s)
- * - THINKING: pulse mouth opacity (sine wave)
- * - SPEAKING: resize mouth height proportional to s_audio_level
+ * Compose the wanted frames into s_frame, copying and invalidating only
+ * the pixels that differ from what is shown. Returns pixels copied.
+ */
+static uint32_t face_present(face_frame_t want) {
+    elisa_dirty_t dirty;
+    elisa_dirty_reset(&dirty);
+    uint32_t px = 0;
+
+    if (want.bg != s_shown.bg) {
+        const elisa_rect_t full = { 0, 0, s_atlas.face_w, s_atlas.face_h };
+        px += elisa_face_atlas_blit(s_frame, s_atlas.face_w, &full, s_atlas.base[want.bg]);
+        elisa_dirty_add(&dirty, &full);
+        s_shown.bg = want.bg;
+        s_shown.eye = FRAME_NONE;
+        s_shown.mouth = FRAME_NONE;
+    }
+    if (want.eye != s_shown.eye) {
+        for (int i = 0; i < 2; i++) {
+            px += elisa_dirty_diff_blit(s_frame, s_atlas.face_w, &s_atlas.eye_rect[i],
+                                        s_atlas.eye[want.bg][i][want.eye], &dirty);
+        }
+        s_shown.eye = want.eye;
+    }
+    if (want.mouth != s_shown.mouth) {
+        px += elisa_dirty_diff_blit(s_frame, s_atlas.face_w, &s_atlas.mouth_rect,
+                                    s_atlas.mouth[want.bg][want.mouth], &dirty);
+        s_shown.mouth = want.mouth;
+    }
+
+    invalidate_dirty(&dirty);
+    return px;
+}
+
+/**
+ * LVGL calls this after every refresh with the render + flush time and
+ * the number of pixels sent to the panel.
+ */
+static void face_monitor_cb(lv_disp_drv_t *drv, uint32_t time_ms, uint32_t px) {
+    portENTER_CRITICAL(&s_stats_lock);
+    elisa_face_state_stats_t *st = &s_stat_state[s_state];
+    st->flushes++;
+    st->flushed_px += px;
+    st->render_ms += time_ms;
+    portEXIT_CRITICAL(&s_stats_lock);
+
+    if (s_prev_monitor_cb != NULL) {
+        s_prev_monitor_cb(drv, time_ms, px);
+    }
+}
+
+/** Charge the time since the last state change to the current state. */
+static void account_state_time(int64_t now) {
+    s_stat_state[s_state].time_us += now - s_state_since_us;
+    s_state_since_us = now;
+}
+
+static int clamp_frame(int v, int max) {
+    return v < 0 ? 0 : (v > max ? max : v);
+}
+
+/** Mouth frame for the current viseme and level. */
+static int speech_mouth(void) {
+    int shape;
+    switch (s_viseme) {
+    case ELISA_VISEME_REST:
+    case ELISA_VISEME_CLOSED:
+        return 0;
+    case ELISA_VISEME_WIDE:  shape = ELISA_ATLAS_MOUTH_WIDE;  break;
+    case ELISA_VISEME_ROUND: shape = ELISA_ATLAS_MOUTH_ROUND; break;
+    case ELISA_VISEME_TEETH: shape = ELISA_ATLAS_MOUTH_TEETH; break;
+    default:
+        return clamp_frame((int)((s_audio_level * (ELISA_ATLAS_MOUTH_OPENINGS - 1) +
+                                  LEVEL_ONE / 2) / LEVEL_ONE),
+                           ELISA_ATLAS_MOUTH_OPENINGS - 1);
+    }
+    int size = (int)(s_audio_level * ELISA_ATLAS_MOUTH_SHAPE_SIZES / (LEVEL_ONE + 1));
+    return ELISA_ATLAS_MOUTH_SHAPE(shape, size);
+}
+
+/** Atlas frames for the current expression and players. */
+static face_frame_t face_target(void) {
+    const face_expression_t *ex = &s_expressions[s_state];
+    face_frame_t f = { ex->bg, 0, 0 };
+
+    int eye = elisa_anim_frame(&s_player[FACE_EYES]);
+    if (s_blink_active) {
+        int lid = elisa_anim_frame(&s_blink);
+        if (lid < eye) eye = lid;
+    }
+    f.eye = (uint8_t)clamp_frame(eye, ELISA_ATLAS_EYE_COUNT - 1);
+
+    /* A faded mouth is always the resting shape */
+    int alpha = clamp_frame(elisa_anim_frame(&s_player[FACE_MOUTH_ALPHA]), MOUTH_OPAQUE);
+    if (alpha < MOUTH_OPAQUE) {
+        f.mouth = (uint8_t)ELISA_ATLAS_MOUTH_FADE(alpha);
+    } else {
+        f.mouth = (uint8_t)(ex->mouth_audio
+            ? speech_mouth()
+            : clamp_frame(elisa_anim_frame(&s_player[FACE_MOUTH]), ELISA_ATLAS_MOUTH_OPENINGS - 1));
+    }
+    return f;
+}
+
+// ── Animation Clock ─────────────────────────────────────────────────────
+
+static void cmd_drain(void);
+
+/** Advance the players and the blink countdown by elapsed ms. */
+static void face_advance(uint32_t elapsed) {
+    for (int e = 0; e < FACE_ELEMENT_COUNT; e++) {
+        elisa_anim_advance(&s_player[e], elapsed);
+    }
+
+    if (s_blink_active) {
+        elisa_anim_advance(&s_blink, elapsed);
+        if (elisa_anim_settled(&s_blink)) {
+            s_blink_active = false;
+            s_blink_countdown = random_blink_countdown();
+        }
+    } else if (s_expressions[s_state].blinks) {
+        if (s_blink_countdown <= elapsed) {
+            elisa_anim_start(&s_blink, &t_blink);
+            s_blink_active = true;
+        } else {
+            s_blink_countdown -= elapsed;
+        }
+    }
+}
+
+/** Keep the earlier of two deadlines, ignoring DEADLINE_NONE. */
+static void deadline_min(uint32_t *next, uint32_t ms) {
+    if (ms != DEADLINE_NONE && (*next == DEADLINE_NONE || ms < *next)) *next = ms;
+}
+
+/**
+ * Milliseconds until the shown frames can next change, or DEADLINE_NONE
+ * when they cannot change without a state change.
+ */
+static uint32_t face_next_deadline(void) {
+    uint32_t next = DEADLINE_NONE;
+
+    /* Players skip ahead over steps where their frame stays the same */
+    for (int e = 0; e < FACE_ELEMENT_COUNT; e++) {
+        deadline_min(&next, elisa_anim_next_change(&s_player[e], ANIM_STEP_MS, ANIM_HORIZON_MS));
+    }
+
+    if (s_blink_active) {
+        uint32_t ms = elisa_anim_next_change(&s_blink, ANIM_STEP_MS, ANIM_HORIZON_MS);
+        /* Still wake at the end of a blink that shows no more change */
+        deadline_min(&next, ms != ELISA_ANIM_SETTLED ? ms : BLINK_DURATION - s_blink.t_ms);
+    } else if (s_expressions[s_state].blinks) {
+        deadline_min(&next, s_blink_countdown);
+    }
+    return next;
+}
+
+/** Pause the clock or re-arm it for the next deadline. */
+static void face_schedule(lv_timer_t *timer) {
+    uint32_t next = face_next_deadline();
+    if (next == DEADLINE_NONE) {
+        lv_timer_pause(timer);
+        return;
+    }
+    lv_timer_set_period(timer, next);
+    lv_timer_reset(timer);
+}
+
+/**
+ * Fires at the deadline computed by the previous tick: advances the
+ * players, composes their frames and re-arms itself.
  */
 static void anim_timer_cb(lv_timer_t *timer) {
-    (void)timer;
+    int64_t t0 = esp_timer_get_time();
+
+    cmd_drain();
+    uint32_t elapsed = lv_tick_elaps(s_last_tick);
+    s_last_tick = lv_tick_get();
+    face_advance(elapsed);
+
+    uint32_t px = face_present(face_target());
+    face_schedule(timer);
+
+    uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
+    portENTER_CRITICAL(&s_stats_lock);
+    s_stat_ticks++;
+    s_stat_tick_us += us;
+    if (us > s_stat_tick_max_us) s_stat_tick_max_us = us;
+    s_stat_blit_px += px;
+    portEXIT_CRITICAL(&s_stats_lock);
+}
 
-    switch (s_state) {
-    case FACE_STATE_IDLE:
-        /* Blink logic: hide eyes briefly every 3-5 seconds */
-        if (s_blink_active) {
-            s_blink_timer += ANIM_TICK_MS;
-            if (s_blink_timer >= BLINK_DURATION) {
-                /* End blink -- show eyes */
-                lv_obj_clear_flag(s_eye_left, LV_OBJ_FLAG_HIDDEN);
-                lv_obj_clear_flag(s_eye_right, LV_OBJ_FLAG_HIDDEN);
-                s_blink_active = false;
-                /* Schedule next blink */
-                s_blink_countdown = BLINK_MIN_MS +
-                    (esp_random() % (BLINK_MAX_MS - BLINK_MIN_MS));
+/** Run the clock on the next LVGL pass, with no time elapsed. */
+static void face_kick(void) {
+    s_last_tick = lv_tick_get();
+    lv_timer_resume(s_anim_timer);
+    lv_timer_ready(s_anim_timer);
+}
+
+/** Run the clock on the next LVGL pass, advancing by the time since the last tick. */
+static void face_wake(void) {
+    lv_timer_resume(s_anim_timer);
+    lv_timer_ready(s_anim_timer);
+}
+
+// ── Command Queue ───────────────────────────────────────────────────────
+
+static void cmd_queue_reset(void) {
+    for (uint32_t i = 0; i < CMD_QUEUE_SIZE; i++) {
+        atomic_store_explicit(&s_cmd_ring[i].seq, i, memory_order_relaxed);
+    }
+    s_cmd_tail = 0;
+    atomic_store_explicit(&s_cmd_head, 0, memory_order_relaxed);
+    atomic_store_explicit(&s_cmd_overflow, false, memory_order_relaxed);
+    atomic_store_explicit(&s_restyle_pending, false, memory_order_relaxed);
+}
+
+/** Have the LVGL task drain on its next pass (any task). */
+static void cmd_arm(void) {
+    elisa_ui_timer_arm(&s_cmd_timer);
+}
+
+/**
+ * Post a command from any task. Returns -1 when the ring is full; the
+ * command is then dropped and counted.
+ */
+static int cmd_post(uint32_t cmd) {
+    uint32_t pos = atomic_load_explicit(&s_cmd_head, memory_order_relaxed);
+    for (;;) {
+        face_cmd_slot_t *slot = &s_cmd_ring[pos & CMD_QUEUE_MASK];
+        uint32_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        int32_t diff = (int32_t)(seq - pos);
+        if (diff == 0) {
+            /* Free slot: claim it, or retry from the head another producer moved */
+            if (atomic_compare_exchange_weak_explicit(&s_cmd_head, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                slot->cmd = cmd;
+                atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+                atomic_fetch_add_explicit(&s_cmd_posted, 1, memory_order_relaxed);
+                cmd_arm();
+                return 0;
             }
+        } else if (diff < 0) {
+            /* The LVGL task has not consumed this slot's previous lap */
+            atomic_store_explicit(&s_cmd_overflow, true, memory_order_release);
+            atomic_fetch_add_explicit(&s_cmd_dropped, 1, memory_order_relaxed);
+            cmd_arm();
+            return -1;
         } else {
-            if (s_blink_countdown <= ANIM_TICK_MS) {
-                /* Start blink -- hide eyes */
-                lv_obj_add_flag(s_eye_left, LV_OBJ_FLAG_HIDDEN);
-                lv_obj_add_flag(s_eye_right, LV_OBJ_FLAG_HIDDEN);
-                s_blink_active = true;
-                s_blink_timer = 0;
-            } else {
-                s_blink_countdown -= ANIM_TICK_MS;
-            }
+            pos = atomic_load_explicit(&s_cmd_head, memory_order_relaxed);
         }
-        break;
+    }
+}
 
-    case FACE_STATE_THINKING: {
-        /* Pulse mouth opacity with a sine-ish wave (~1Hz cycle) */
-        s_think_counter += ANIM_TICK_MS;
-        float t = (float)s_think_counter / 1000.0f;
-        int opacity = (int)(128.0f + 127.0f * sinf(t * 3.14159f * 2.0f));
-        if (opacity < 0) opacity = 0;
-        if (opacity > 255) opacity = 255;
-        lv_obj_set_style_bg_opa(s_mouth, (lv_opa_t)opacity, 0);
-        break;
+/** Enter a state: blend every element into its expression and restart the clock. */
+static void face_apply_state(face_state_t state) {
+    const face_expression_t *ex = &s_expressions[state];
+    for (int e = 0; e < FACE_ELEMENT_COUNT; e++) {
+        elisa_anim_play(&s_player[e], ex->track[e], TRANSITION_MS, ELISA_EASE_OUT);
     }
+    s_blink_active = false;
+    s_blink_countdown = random_blink_countdown();
 
-    case FACE_STATE_SPEAKING: {
-        /* Scale mouth height proportional to audio level */
-        int base_h = 4;
-        int max_h = 24;
-        int h = base_h + (int)((float)(max_h - base_h) * s_audio_level);
-        lv_obj_set_height(s_mouth, h);
-        break;
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&s_stats_lock);
+    account_state_time(now);
+    s_state = state;
+    portEXIT_CRITICAL(&s_stats_lock);
+
+    /* The kicked tick composes the new frames */
+    face_kick();
+}
+
+/** Show a speech command's viseme and level, waking the clock if the mouth changes. */
+static void face_apply_speech(uint8_t viseme, uint32_t level) {
+    if (viseme == s_viseme && level == s_audio_level) return;
+    s_viseme = viseme;
+    s_audio_level = level;
+    if (s_expressions[s_state].mouth_audio) {
+        face_wake();
     }
+}
 
-    default:
-        break;
+/**
+ * Rebuild the atlas for the posted descriptor (LVGL task). The old atlas
+ * stays on screen until the new one is rendered, and stays for good if
+ * that fails.
+ */
+static void face_restyle(void) {
+    face_descriptor_t desc;
+    portENTER_CRITICAL(&s_restyle_lock);
+    desc = s_restyle_desc;
+    portEXIT_CRITICAL(&s_restyle_lock);
+
+    elisa_face_style_t old_style = s_style;
+    elisa_face_atlas_t old_atlas = s_atlas;
+    void *old_mem = s_atlas_mem;
+    uint16_t *old_frame = s_frame;
+
+    elisa_face_style_resolve(&desc, &s_style);
+    if (build_atlas() != 0) {
+        ESP_LOGW(TAG, "Keeping the current face style");
+        s_style = old_style;
+        s_atlas = old_atlas;
+        s_atlas_mem = old_mem;
+        s_frame = old_frame;
+        return;
+    }
+    s_desc = desc;
+
+    /* The box may change size: clear where the old face was */
+    lv_obj_invalidate(s_canvas);
+    lv_canvas_set_buffer(s_canvas, s_frame, s_atlas.face_w, s_atlas.face_h,
+                         LV_IMG_CF_TRUE_COLOR);
+    lv_obj_align(s_canvas, LV_ALIGN_CENTER, 0, FACE_CY - SCREEN_H / 2);
+    lv_obj_update_layout(s_canvas);
+    heap_caps_free(old_mem);
+    heap_caps_free(old_frame);
+
+    /* Compose every element from the new atlas */
+    s_shown = (face_frame_t){ FRAME_NONE, FRAME_NONE, FRAME_NONE };
+    face_present(face_target());
+
+    ESP_LOGI(TAG, "Face restyled: %s eyes=%s mouth=%s",
+             s_desc.base_shape, s_desc.eyes.style, s_desc.mouth.style);
+}
+
+/**
+ * Apply every posted command in order (LVGL task). Speech commands only
+ * keep the latest; a state command always resets the animation, even to
+ * the current state, as a direct call used to.
+ */
+static void cmd_drain(void) {
+    for (;;) {
+        face_cmd_slot_t *slot = &s_cmd_ring[s_cmd_tail & CMD_QUEUE_MASK];
+        uint32_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        if (seq != s_cmd_tail + 1) break;
+
+        uint32_t cmd = slot->cmd;
+        atomic_store_explicit(&slot->seq, s_cmd_tail + CMD_QUEUE_SIZE, memory_order_release);
+        s_cmd_tail++;
+
+        switch (CMD_TYPE(cmd)) {
+        case CMD_STATE:
+            face_apply_state((face_state_t)CMD_ARG(cmd));
+            break;
+        case CMD_AUDIO_LEVEL:
+            face_apply_speech(ELISA_VISEME_OPEN, CMD_ARG(cmd) & 0xFFFF);
+            break;
+        case CMD_VISEME:
+            face_apply_speech((uint8_t)(CMD_ARG(cmd) >> 16), CMD_ARG(cmd) & 0xFFFF);
+            break;
+        default:
+            break;
+        }
+    }
+
+    /* A dropped state command must not leave the face behind its callers */
+    if (atomic_exchange_explicit(&s_cmd_overflow, false, memory_order_acq_rel)) {
+        face_state_t wanted =
+            (face_state_t)atomic_load_explicit(&s_wanted_state, memory_order_acquire);
+        if (wanted != s_state) {
+            face_apply_state(wanted);
+        }
+    }
+
+    if (atomic_exchange_explicit(&s_restyle_pending, false, memory_order_acq_rel)) {
+        face_restyle();
+    }
+}
+
+/** Anything left for cmd_drain() (LVGL task). */
+static bool cmd_pending(void) {
+    const face_cmd_slot_t *slot = &s_cmd_ring[s_cmd_tail & CMD_QUEUE_MASK];
+    return atomic_load(&slot->seq) == s_cmd_tail + 1 ||
+           atomic_load(&s_cmd_overflow) || atomic_load(&s_restyle_pending);
+}
+
+/** Drain, then park until the next post. */
+static void cmd_timer_cb(lv_timer_t *timer) {
+    (void)timer;
+    cmd_drain();
+    elisa_ui_timer_park(&s_cmd_timer, cmd_pending);
+}
+
+// ── Touch Handler ───────────────────────────────────────────────────────
+
+/**
+ * A touch anywhere on the screen while the agent is busy cancels the turn.
+ * Runs in the LVGL task; elisa_turn_cancel() only bumps a counter and
+ * signals the audio player, so it is safe to call from here.
+ */
+static void screen_pressed_cb(lv_event_t *e) {
+    (void)e;
+    if (s_state == FACE_STATE_THINKING || s_state == FACE_STATE_SPEAKING) {
+        elisa_turn_cancel();
     }
 }
 
@@ -169,145 +759,139 @@ int elisa_face_init(const face_descriptor_t *desc) {
         return -1;
     }
 
-    /* Set screen background to black */
-    lv_obj_set_style_bg_color(scr, lv_color_black(), 0);
-
     /*
-     * Create face background shape.
-     *
-     * For "round": circle with radius proportional to screen
-     * For "square": rounded rectangle
-     * For "oval": ellipse approximated with large border radius
+     * Resolve the descriptor once, then pre-render every face frame from
+     * the draw lists its styles compile to (elisa_face_style.c).
      */
-    s_face_bg = lv_obj_create(scr);
-    lv_obj_set_size(s_face_bg, 160, 160);
-    lv_obj_align(s_face_bg, LV_ALIGN_CENTER, 0, -20);
-    lv_obj_set_style_bg_color(s_face_bg, make_color(s_desc.face_color), 0);
-    lv_obj_set_style_border_width(s_face_bg, 0, 0);
+    elisa_face_style_resolve(&s_desc, &s_style);
+    if (build_atlas() != 0) {
+        return -1;
+    }
 
-    if (strcmp(s_desc.base_shape, "round") == 0) {
-        lv_obj_set_style_radius(s_face_bg, LV_RADIUS_CIRCLE, 0);
-    } else if (strcmp(s_desc.base_shape, "square") == 0) {
-        lv_obj_set_style_radius(s_face_bg, 16, 0);
-    } else { /* oval */
-        lv_obj_set_size(s_face_bg, 140, 170);
-        lv_obj_set_style_radius(s_face_bg, LV_RADIUS_CIRCLE, 0);
+    /* Set screen background to black */
+    lv_obj_set_style_bg_color(scr, lv_color_black(), 0);
+
+    s_canvas = lv_canvas_create(scr);
+    lv_canvas_set_buffer(s_canvas, s_frame, s_atlas.face_w, s_atlas.face_h,
+                         LV_IMG_CF_TRUE_COLOR);
+    lv_obj_align(s_canvas, LV_ALIGN_CENTER, 0, FACE_CY - SCREEN_H / 2);
+    lv_obj_update_layout(s_canvas);
+
+    /* Count flushed pixels per face state */
+    lv_disp_t *disp = lv_disp_get_default();
+    if (disp != NULL && disp->driver != NULL) {
+        s_prev_monitor_cb = disp->driver->monitor_cb;
+        disp->driver->monitor_cb = face_monitor_cb;
     }
 
-    /*
-     * Create eyes.
-     *
-     * Style determines shape:
-     * - "dots": small filled circles
-     * - "circles": outlined circles
-     * - "anime": large circles with highlight
-     * - "pixels": small squares
-     * - "sleepy": half-circles (arcs)
-     */
-    int eye_r = get_eye_radius(s_desc.eyes.size);
-    lv_color_t eye_color = make_color(s_desc.eyes.color);
-
-    s_eye_left = lv_obj_create(s_face_bg);
-    lv_obj_set_size(s_eye_left, eye_r * 2, eye_r * 2);
-    lv_obj_align(s_eye_left, LV_ALIGN_CENTER, -EYE_SPACING, -15);
-    lv_obj_set_style_bg_color(s_eye_left, eye_color, 0);
-    lv_obj_set_style_radius(s_eye_left, LV_RADIUS_CIRCLE, 0);
-    lv_obj_set_style_border_width(s_eye_left, 0, 0);
-
-    s_eye_right = lv_obj_create(s_face_bg);
-    lv_obj_set_size(s_eye_right, eye_r * 2, eye_r * 2);
-    lv_obj_align(s_eye_right, LV_ALIGN_CENTER, EYE_SPACING, -15);
-    lv_obj_set_style_bg_color(s_eye_right, eye_color, 0);
-    lv_obj_set_style_radius(s_eye_right, LV_RADIUS_CIRCLE, 0);
-    lv_obj_set_style_border_width(s_eye_right, 0, 0);
-
-    /* Create mouth */
-    s_mouth = lv_obj_create(s_face_bg);
-    lv_obj_set_size(s_mouth, 40, 4);
-    lv_obj_align(s_mouth, LV_ALIGN_CENTER, 0, 25);
-    lv_obj_set_style_bg_color(s_mouth, eye_color, 0);
-    lv_obj_set_style_radius(s_mouth, 2, 0);
-    lv_obj_set_style_border_width(s_mouth, 0, 0);
-
-    /* Start animation timer */
-    s_anim_timer = lv_timer_create(anim_timer_cb, ANIM_TICK_MS, NULL);
+    /* Let presses fall through the face to the screen handler */
+    lv_obj_clear_flag(s_canvas, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_event_cb(scr, screen_pressed_cb, LV_EVENT_PRESSED, NULL);
 
     s_state = FACE_STATE_IDLE;
+    atomic_store_explicit(&s_wanted_state, FACE_STATE_IDLE, memory_order_relaxed);
+    cmd_queue_reset();
+    for (int e = 0; e < FACE_ELEMENT_COUNT; e++) {
+        elisa_anim_start(&s_player[e], s_expressions[FACE_STATE_IDLE].track[e]);
+    }
+    s_blink_active = false;
+    face_present(face_target());
+
+    /* Schedule first blink, then start the clock for it */
+    s_blink_countdown = random_blink_countdown();
+    s_stat_since_us = esp_timer_get_time();
+    s_state_since_us = s_stat_since_us;
+    s_last_tick = lv_tick_get();
+    s_anim_timer = lv_timer_create(anim_timer_cb, s_blink_countdown, NULL);
+    /* Period 0: once a post resumes it, it runs on the next LVGL pass */
+    elisa_ui_timer_init(&s_cmd_timer, lv_timer_create(cmd_timer_cb, 0, NULL));
+
+    atomic_thread_fence(memory_order_release);
     s_initialized = true;
 
-    /* Schedule first blink */
-    s_blink_countdown = BLINK_MIN_MS + (esp_random() % (BLINK_MAX_MS - BLINK_MIN_MS));
-
     ESP_LOGI(TAG, "Face initialized: %s eyes=%s mouth=%s",
              s_desc.base_shape, s_desc.eyes.style, s_desc.mouth.style);
 
     return 0;
 }
 
+int elisa_face_set_descriptor(const face_descriptor_t *desc) {
+    if (!s_initialized || desc == NULL) {
+        return -1;
+    }
+    /* A newer descriptor replaces one not yet picked up */
+    portENTER_CRITICAL(&s_restyle_lock);
+    s_restyle_desc = *desc;
+    portEXIT_CRITICAL(&s_restyle_lock);
+    atomic_store_explicit(&s_restyle_pending, true, memory_order_release);
+    cmd_arm();
+    return 0;
+}
+
 void elisa_face_set_state(face_state_t state) {
     if (!s_initialized) return;
 
-    face_state_t prev = s_state;
-    s_state = state;
-
-    ESP_LOGI(TAG, "Face state: %d -> %d", prev, state);
-
-    /* Reset common state on every transition */
-    lv_obj_clear_flag(s_eye_left, LV_OBJ_FLAG_HIDDEN);
-    lv_obj_clear_flag(s_eye_right, LV_OBJ_FLAG_HIDDEN);
-    lv_obj_set_style_bg_opa(s_mouth, LV_OPA_COVER, 0);
-    lv_obj_set_height(s_mouth, 4);
-    s_blink_active = false;
+    face_state_t prev =
+        (face_state_t)atomic_exchange_explicit(&s_wanted_state, state, memory_order_acq_rel);
 
-    int eye_r = get_eye_radius(s_desc.eyes.size);
+    ESP_LOGD(TAG, "Face state: %d -> %d", prev, state);
 
-    switch (state) {
-    case FACE_STATE_IDLE:
-        /* Schedule next blink, restore face color and eye size */
-        s_blink_countdown = BLINK_MIN_MS +
-            (esp_random() % (BLINK_MAX_MS - BLINK_MIN_MS));
-        lv_obj_set_style_bg_color(s_face_bg, make_color(s_desc.face_color), 0);
-        lv_obj_set_size(s_eye_left, eye_r * 2, eye_r * 2);
-        lv_obj_set_size(s_eye_right, eye_r * 2, eye_r * 2);
-        break;
-
-    case FACE_STATE_LISTENING:
-        /* Widen eyes slightly (+4px) */
-        lv_obj_set_size(s_eye_left, eye_r * 2 + 4, eye_r * 2 + 4);
-        lv_obj_set_size(s_eye_right, eye_r * 2 + 4, eye_r * 2 + 4);
-        break;
-
-    case FACE_STATE_THINKING:
-        /* Restore eye size to normal, reset pulse counter */
-        lv_obj_set_size(s_eye_left, eye_r * 2, eye_r * 2);
-        lv_obj_set_size(s_eye_right, eye_r * 2, eye_r * 2);
-        s_think_counter = 0;
-        break;
-
-    case FACE_STATE_SPEAKING:
-        /* Eyes normal, mouth will be animated in anim_timer_cb */
-        lv_obj_set_size(s_eye_left, eye_r * 2, eye_r * 2);
-        lv_obj_set_size(s_eye_right, eye_r * 2, eye_r * 2);
-        break;
-
-    case FACE_STATE_ERROR:
-        /* Change face background to red */
-        lv_obj_set_style_bg_color(s_face_bg, lv_color_make(200, 50, 50), 0);
-        break;
-    }
-
-    (void)prev;
+    /* The LVGL task applies it at its next drain */
+    cmd_post(CMD_MAKE(CMD_STATE, state));
 }
 
 face_state_t elisa_face_get_state(void) {
-    return s_state;
+    return (face_state_t)atomic_load_explicit(&s_wanted_state, memory_order_acquire);
+}
+
+const char *elisa_face_state_name(face_state_t state) {
+    switch (state) {
+    case FACE_STATE_IDLE:      return "idle";
+    case FACE_STATE_LISTENING: return "listening";
+    case FACE_STATE_THINKING:  return "thinking";
+    case FACE_STATE_SPEAKING:  return "speaking";
+    case FACE_STATE_ERROR:     return "error";
+    }
+    return "unknown";
 }
 
 void elisa_face_set_audio_level(float level) {
+    if (!s_initialized) return;
+
     /* Clamp to 0.0 - 1.0 */
     if (level < 0.0f) level = 0.0f;
     if (level > 1.0f) level = 1.0f;
-    s_audio_level = level;
+    cmd_post(CMD_MAKE(CMD_AUDIO_LEVEL, (uint32_t)(level * (float)LEVEL_ONE + 0.5f)));
+}
+
+void elisa_face_set_viseme(elisa_viseme_t viseme, uint16_t level) {
+    if (!s_initialized || viseme >= ELISA_VISEME_COUNT) return;
+    cmd_post(CMD_MAKE(CMD_VISEME, VISEME_ARG(viseme, level)));
+}
+
+void elisa_face_take_stats(elisa_face_stats_t *out) {
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&s_stats_lock);
+    out->ticks = s_stat_ticks;
+    out->tick_us_total = s_stat_tick_us;
+    out->tick_us_max = s_stat_tick_max_us;
+    out->blit_px = s_stat_blit_px;
+    out->interval_us = now - s_stat_since_us;
+    account_state_time(now);
+    memcpy(out->state, s_stat_state, sizeof(out->state));
+    memset(s_stat_state, 0, sizeof(s_stat_state));
+    s_stat_ticks = 0;
+    s_stat_tick_us = 0;
+    s_stat_tick_max_us = 0;
+    s_stat_blit_px = 0;
+    s_stat_since_us = now;
+    portEXIT_CRITICAL(&s_stats_lock);
+
+    out->commands = atomic_exchange_explicit(&s_cmd_posted, 0, memory_order_relaxed);
+    out->commands_dropped = atomic_exchange_explicit(&s_cmd_dropped, 0, memory_order_relaxed);
+
+    out->atlas_bytes = (uint32_t)s_atlas.bytes;
 }
 
 void elisa_face_cleanup(void) {
@@ -315,7 +899,23 @@ void elisa_face_cleanup(void) {
         lv_timer_del(s_anim_timer);
         s_anim_timer = NULL;
     }
-    /* LVGL objects are cleaned up when screen is deleted */
+    if (s_cmd_timer.timer != NULL) {
+        lv_timer_del(s_cmd_timer.timer);
+        s_cmd_timer.timer = NULL;
+    }
+    lv_disp_t *disp = lv_disp_get_default();
+    if (disp != NULL && disp->driver != NULL && disp->driver->monitor_cb == face_monitor_cb) {
+        disp->driver->monitor_cb = s_prev_monitor_cb;
+    }
+    if (s_canvas != NULL) {
+        lv_obj_del(s_canvas);
+        s_canvas = NULL;
+    }
+    heap_caps_free(s_frame);
+    heap_caps_free(s_atlas_mem);
+    s_frame = NULL;
+    s_atlas_mem = NULL;
+    s_shown = (face_frame_t){ FRAME_NONE, FRAME_NONE, FRAME_NONE };
     s_initialized = false;
     ESP_LOGI(TAG, "Face renderer cleaned up");
 }
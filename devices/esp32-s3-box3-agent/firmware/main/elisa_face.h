@@ -11,27 +11,32 @@
  *   We replace it with an animated face that reflects the agent's state:
  *   idle (slow blink), listening (wide eyes + pulse), thinking (dots),
  *   speaking (mouth animation synced to audio amplitude).
- * - The face is built from basic geometric shapes (arcs, circles, lines)
- *   that are deliberately renderable on both LVGL (firmware) and SVG
- *   (browser preview in AgentStudioCanvas).
+ * - The face is built from basic geometric shapes (ellipses, rounded
+ *   rectangles, strokes) that are deliberately renderable on both the
+ *   firmware (elisa_draw.c) and SVG (browser preview in AgentStudioCanvas).
  *
  * LVGL PRIMITIVES USED:
- * - lv_obj_create()   -- face background container
- * - lv_arc_create()   -- round/oval face outline
- * - lv_obj_set_style_bg_color() -- face/eye colors
- * - lv_line_create()  -- mouth shapes (line, zigzag, cat)
- * - lv_anim_create()  -- blink, pulse, thinking animations
- * - lv_timer_create() -- animation tick driver
+ * - lv_canvas_create()       -- one RGB565 image holding the whole face
+ * - lv_obj_invalidate_area() -- redraw only the eye/mouth box that changed
+ * - lv_timer_create()        -- animation tick driver
+ *
+ * The face frames themselves (eye openings, mouth openings, state
+ * variants) are pre-rendered at init by elisa_face_atlas.c and sequenced
+ * by keyframe tracks (elisa_anim.c).
  *
  * DEPENDENCIES:
- * - LVGL (v8.x, bundled with esp-box BSP)
+ * - LVGL (v8.x, bundled with esp-box BSP), LV_COLOR_DEPTH 16
  * - elisa_config.h (face_descriptor_t, face_state_t)
+ * - elisa_face_atlas.h (pre-rendered frames)
+ * - elisa_anim.h (keyframe tracks)
+ * - elisa_face_style.h (descriptor styles compiled into draw lists)
  */
 
 #ifndef ELISA_FACE_H
 #define ELISA_FACE_H
 
 #include "elisa_config.h"
+#include "elisa_viseme.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -40,54 +45,119 @@ extern "C" {
 /**
  * Initialize the face renderer with a parsed FaceDescriptor.
  *
- * Creates LVGL objects for the face background, eyes, mouth, and
- * accent elements (cheeks for some expressions). Call after LVGL
- * and the display driver are initialized.
+ * Renders the face atlas into PSRAM and creates the canvas that shows
+ * it. Call after LVGL and the display driver are initialized.
  *
  * @param desc Parsed face descriptor from config (or NULL for defaults)
- * @return 0 on success, -1 if LVGL is not initialized
+ * @return 0 on success, -1 if LVGL is not initialized or the atlas
+ *         cannot be allocated
  */
 int elisa_face_init(const face_descriptor_t *desc);
 
+/**
+ * Restyle the face for a new descriptor (live config update), from any
+ * task. The LVGL task renders the new atlas on its next drain and swaps
+ * it in; the current face stays up meanwhile, and for good if the new
+ * atlas cannot be allocated.
+ *
+ * @return 0 if posted, -1 if the face is not initialized
+ */
+int elisa_face_set_descriptor(const face_descriptor_t *desc);
+
 /**
  * Set the face animation state.
  *
- * Transitions the face to the given state with appropriate animations:
+ * Blends the face into the given state's expression (150 ms), then runs
+ * its animation:
  *
  * - FACE_STATE_IDLE:      Slow periodic blink (eyes close briefly every 3-5s).
- *                         Mouth in resting position. Gentle color pulse on accent.
+ *                         Mouth in resting position.
+ *
+ * - FACE_STATE_LISTENING: Eyes widen. Mouth slightly open.
  *
- * - FACE_STATE_LISTENING: Eyes widen (size increases). A pulsing ring appears
- *                         around the face. Mouth slightly open.
+ * - FACE_STATE_THINKING:  Resting mouth pulses in and out (~1 Hz).
  *
- * - FACE_STATE_THINKING:  Eyes look up/down (animate Y offset). Three dots
- *                         appear below the face with a sequential bounce.
+ * - FACE_STATE_SPEAKING:  Mouth follows the speech (set via
+ *                         elisa_face_set_viseme or
+ *                         elisa_face_set_audio_level). Eyes blink.
  *
- * - FACE_STATE_SPEAKING:  Mouth animates based on audio amplitude (set via
- *                         elisa_face_set_audio_level). Eyes in normal state.
+ * - FACE_STATE_ERROR:     Eyes droop. Face color changes to red.
  *
- * - FACE_STATE_ERROR:     Sad expression (eyes droop, mouth frowns).
- *                         Accent color changes to red.
+ * Safe to call from any task: the change is posted to the renderer's
+ * command queue and applied by the LVGL task within a few milliseconds.
+ * The caller never takes the LVGL lock.
  *
  * @param state Target animation state
  */
 void elisa_face_set_state(face_state_t state);
 
 /**
- * Get the current face animation state.
+ * Get the face animation state, as last set by elisa_face_set_state()
+ * (the renderer may not have drawn it yet).
  */
 face_state_t elisa_face_get_state(void);
 
+/**
+ * Lower-case name of a face state ("idle", "speaking", ...).
+ */
+const char *elisa_face_state_name(face_state_t state);
+
 /**
  * Set audio amplitude level for speaking animation.
  *
  * During FACE_STATE_SPEAKING, the mouth opening scales with the
- * audio level. Call this from the I2S playback callback.
+ * audio level. Call this from the I2S playback callback: it only
+ * enqueues, and the renderer keeps the latest level per frame.
  *
  * @param level Audio amplitude 0.0 (silent) to 1.0 (max)
  */
 void elisa_face_set_audio_level(float level);
 
+/**
+ * Set the mouth shape for speaking animation (lip sync).
+ *
+ * During FACE_STATE_SPEAKING the mouth shows the viseme, opened by level;
+ * a level alone (elisa_face_set_audio_level) shows ELISA_VISEME_OPEN.
+ * Safe from any task: it only enqueues, and the renderer shows the latest
+ * one, changing the mouth on the next LVGL pass.
+ *
+ * @param viseme Mouth shape
+ * @param level  Opening, 0 .. ELISA_VISEME_LEVEL_ONE
+ */
+void elisa_face_set_viseme(elisa_viseme_t viseme, uint16_t level);
+
+/** Number of face_state_t values. */
+#define ELISA_FACE_STATE_COUNT (FACE_STATE_ERROR + 1)
+
+/** Display traffic while the face was in one state. */
+typedef struct {
+    int64_t time_us;         /**< Time spent in the state */
+    uint32_t flushes;        /**< Display refreshes */
+    uint32_t flushed_px;     /**< Pixels sent to the panel */
+    uint32_t render_ms;      /**< LVGL render + flush time */
+} elisa_face_state_stats_t;
+
+/**
+ * Animation statistics for the interval since the previous
+ * elisa_face_take_stats() call.
+ */
+typedef struct {
+    uint32_t ticks;          /**< Animation ticks in the interval */
+    uint64_t tick_us_total;  /**< Time spent composing frames */
+    uint32_t tick_us_max;    /**< Slowest single tick */
+    uint32_t blit_px;        /**< Pixels copied from the atlas */
+    int64_t interval_us;     /**< Length of the interval */
+    uint32_t atlas_bytes;    /**< Size of the pre-rendered atlas */
+    uint32_t commands;       /**< State/level commands posted */
+    uint32_t commands_dropped; /**< Commands lost to a full queue */
+    elisa_face_state_stats_t state[ELISA_FACE_STATE_COUNT]; /**< By face_state_t */
+} elisa_face_stats_t;
+
+/**
+ * Read and reset the interval counters.
+ */
+void elisa_face_take_stats(elisa_face_stats_t *out);
+
 /**
  * Clean up face renderer resources. Call before shutdown.
  */
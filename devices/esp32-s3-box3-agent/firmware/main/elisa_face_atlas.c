@@ -0,0 +1,173 @@
+/**
+ * @file elisa_face_atlas.c
+ * @brief Face atlas composition.
+ *
+ * Lays out the eye and mouth boxes from the bounds of their draw lists,
+ * then rasterizes every layer variant with elisa_draw_raster(). Eye and
+ * mouth frames start as a crop of the finished background so their edges
+ * match it exactly. This runs once at init.
+ */
+
+#include "elisa_face_atlas.h"
+
+#include <string.h>
+
+// ── Helpers ─────────────────────────────────────────────────────────────
+
+/** Copy rect out of a face_w-wide image. */
+static void crop(uint16_t *dst, const uint16_t *src, uint16_t src_w, const elisa_rect_t *r) {
+    for (uint16_t y = 0; y < r->h; y++) {
+        memcpy(dst + (size_t)y * r->w, src + (size_t)(r->y + y) * src_w + r->x,
+               r->w * sizeof(uint16_t));
+    }
+}
+
+static elisa_rect_t rect_union(elisa_rect_t a, elisa_rect_t b) {
+    if (a.w == 0 || a.h == 0) return b;
+    if (b.w == 0 || b.h == 0) return a;
+    int x0 = a.x < b.x ? a.x : b.x, y0 = a.y < b.y ? a.y : b.y;
+    int x1 = (a.x + a.w > b.x + b.w) ? a.x + a.w : b.x + b.w;
+    int y1 = (a.y + a.h > b.y + b.h) ? a.y + a.h : b.y + b.h;
+    return (elisa_rect_t){ (int16_t)x0, (int16_t)y0, (uint16_t)(x1 - x0), (uint16_t)(y1 - y0) };
+}
+
+// ── Layout ──────────────────────────────────────────────────────────────
+
+static float eye_scale(const elisa_face_geometry_t *g, int frame) {
+    return frame > ELISA_ATLAS_EYE_OPEN
+        ? 1.0f + g->eye_wide_step * (float)(frame - ELISA_ATLAS_EYE_OPEN) : 1.0f;
+}
+
+static void eye_center(const elisa_face_geometry_t *g, int i, int *x, int *y) {
+    *x = g->face_w / 2 + (i == 0 ? -g->eye_dx : g->eye_dx);
+    *y = g->face_h / 2 + g->eye_dy;
+}
+
+static void layout(const elisa_face_geometry_t *g, elisa_rect_t eye[2], elisa_rect_t *mouth) {
+    /* Eye box: the widest frame */
+    elisa_rect_t eb = elisa_draw_bounds(g->eye, eye_scale(g, ELISA_ATLAS_EYE_WIDE));
+    for (int i = 0; i < 2; i++) {
+        int cx, cy;
+        eye_center(g, i, &cx, &cy);
+        eye[i] = (elisa_rect_t){ (int16_t)(cx + eb.x), (int16_t)(cy + eb.y), eb.w, eb.h };
+    }
+
+    /* Mouth box: every opening and shape */
+    elisa_rect_t mb = { 0, 0, 0, 0 };
+    for (int m = 0; m < ELISA_ATLAS_MOUTH_DRAWN; m++) {
+        mb = rect_union(mb, elisa_draw_bounds(g->mouth[m], 1.0f));
+    }
+    mouth->x = (int16_t)(g->face_w / 2 + mb.x);
+    mouth->y = (int16_t)(g->face_h / 2 + g->mouth_dy + mb.y);
+    mouth->w = mb.w;
+    mouth->h = mb.h;
+}
+
+static bool rect_inside(const elisa_rect_t *r, uint16_t w, uint16_t h) {
+    return r->w > 0 && r->h > 0 && r->x >= 0 && r->y >= 0 && r->x + r->w <= w && r->y + r->h <= h;
+}
+
+static size_t rect_px(const elisa_rect_t *r) {
+    return (size_t)r->w * r->h;
+}
+
+// ── Public API ──────────────────────────────────────────────────────────
+
+size_t elisa_face_atlas_size(const elisa_face_geometry_t *geom) {
+    elisa_rect_t eye[2], mouth;
+    layout(geom, eye, &mouth);
+    size_t per_bg = (size_t)geom->face_w * geom->face_h +
+                    2 * ELISA_ATLAS_EYE_COUNT * rect_px(&eye[0]) +
+                    ELISA_ATLAS_MOUTH_COUNT * rect_px(&mouth);
+    return ELISA_ATLAS_BG_COUNT * per_bg * sizeof(uint16_t);
+}
+
+int elisa_face_atlas_build(elisa_face_atlas_t *atlas, const elisa_face_geometry_t *geom,
+                           void *mem, size_t mem_size) {
+    size_t need = elisa_face_atlas_size(geom);
+    if (mem == NULL || mem_size < need) return -1;
+
+    memset(atlas, 0, sizeof(*atlas));
+    atlas->face_w = geom->face_w;
+    atlas->face_h = geom->face_h;
+    layout(geom, atlas->eye_rect, &atlas->mouth_rect);
+    if (!rect_inside(&atlas->eye_rect[0], geom->face_w, geom->face_h) ||
+        !rect_inside(&atlas->eye_rect[1], geom->face_w, geom->face_h) ||
+        !rect_inside(&atlas->mouth_rect, geom->face_w, geom->face_h)) {
+        return -1;
+    }
+
+    const elisa_rect_t full = { 0, 0, geom->face_w, geom->face_h };
+    const elisa_rect_t *mr = &atlas->mouth_rect;
+    float mx = (float)(geom->face_w / 2), my = (float)(geom->face_h / 2 + geom->mouth_dy);
+
+    /* Eyelids clip to a band around the eye center; OPEN is unclipped */
+    elisa_rect_t open = elisa_draw_bounds(geom->eye, 1.0f);
+    int lid = (-open.y > open.y + open.h) ? -open.y : open.y + open.h;
+
+    uint32_t palette[ELISA_PAINT_COUNT];
+    memcpy(palette, geom->palette, sizeof(palette));
+
+    uint16_t *p = (uint16_t *)mem;
+    for (int bg = 0; bg < ELISA_ATLAS_BG_COUNT; bg++) {
+        palette[ELISA_PAINT_FACE] =
+            (bg == ELISA_ATLAS_BG_ERROR) ? geom->error_rgb : geom->palette[ELISA_PAINT_FACE];
+
+        uint16_t *base = p;
+        elisa_draw_clear(base, &full, geom->screen_rgb);
+        elisa_draw_xform_t xf = { 0, 0, 1.0f, -1, 255 };
+        elisa_draw_raster(base, &full, geom->base, &xf, palette);
+        atlas->base[bg] = base;
+        p += rect_px(&full);
+
+        for (int i = 0; i < 2; i++) {
+            const elisa_rect_t *er = &atlas->eye_rect[i];
+            int ex, ey;
+            eye_center(geom, i, &ex, &ey);
+            for (int e = 0; e < ELISA_ATLAS_EYE_COUNT; e++) {
+                crop(p, base, geom->face_w, er);
+                xf = (elisa_draw_xform_t){ (float)ex, (float)ey, eye_scale(geom, e), -1, 255 };
+                if (e < ELISA_ATLAS_EYE_OPEN) {
+                    xf.clip_half_h = (float)lid * (float)e / ELISA_ATLAS_EYE_OPEN;
+                }
+                elisa_draw_raster(p, er, geom->eye, &xf, palette);
+                atlas->eye[bg][i][e] = p;
+                p += rect_px(er);
+            }
+        }
+
+        for (int m = 0; m < ELISA_ATLAS_MOUTH_COUNT; m++) {
+            crop(p, base, geom->face_w, mr);
+            xf = (elisa_draw_xform_t){ mx, my, 1.0f, -1, 255 };
+            const elisa_draw_list_t *shape = geom->mouth[0];
+            if (m < ELISA_ATLAS_MOUTH_DRAWN) {
+                shape = geom->mouth[m];
+            } else {
+                xf.alpha = (uint8_t)((m - ELISA_ATLAS_MOUTH_DRAWN) * 255 /
+                                     (ELISA_ATLAS_MOUTH_FADES - 1));
+            }
+            elisa_draw_raster(p, mr, shape, &xf, palette);
+            atlas->mouth[bg][m] = p;
+            p += rect_px(mr);
+        }
+    }
+
+    if (geom->swap_bytes) {
+        uint16_t *px = (uint16_t *)mem;
+        for (size_t i = 0; i < need / sizeof(uint16_t); i++) {
+            px[i] = (uint16_t)((px[i] << 8) | (px[i] >> 8));
+        }
+    }
+
+    atlas->bytes = need;
+    return 0;
+}
+
+size_t elisa_face_atlas_blit(uint16_t *dst, uint16_t dst_w, const elisa_rect_t *rect,
+                             const uint16_t *src) {
+    for (uint16_t y = 0; y < rect->h; y++) {
+        memcpy(dst + (size_t)(rect->y + y) * dst_w + rect->x, src + (size_t)y * rect->w,
+               rect->w * sizeof(uint16_t));
+    }
+    return rect_px(rect);
+}
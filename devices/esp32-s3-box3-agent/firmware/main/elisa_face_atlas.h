@@ -0,0 +1,144 @@
+/**
+ * @file elisa_face_atlas.h
+ * @brief Pre-rendered RGB565 frames of the face, built once at init.
+ *
+ * Every state the face can show is a combination of three layers: the
+ * face background (normal or error color), the eye frame (an openness
+ * from closed to open, then wider) and the mouth frame (an opening height, a
+ * lip-sync shape or a fade level of the resting mouth). The layers are described by draw lists
+ * (elisa_draw.h) compiled from the face descriptor; the atlas rasterizes
+ * each layer variant once, anti-aliased, into a single caller-supplied
+ * block (normally PSRAM):
+ *
+ *   base   full face box per background           face_w x face_h
+ *   eye    eye box per background, side and frame  eye_rect size
+ *   mouth  mouth box per background and frame      mouth_rect size
+ *
+ * Eye and mouth frames already contain the background around them, so
+ * animating is an opaque rectangle copy into the frame the display shows
+ * (elisa_face_atlas_blit()), never a style recalculation or shape redraw.
+ * Each eye has its own frames: the background around the two eyes is
+ * mirrored (cheeks, face outline), not identical.
+ *
+ * Plain C with no LVGL or ESP-IDF dependency so host tools can share it.
+ */
+
+#ifndef ELISA_FACE_ATLAS_H
+#define ELISA_FACE_ATLAS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "elisa_draw.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Face background variants. */
+typedef enum {
+    ELISA_ATLAS_BG_NORMAL,
+    ELISA_ATLAS_BG_ERROR,
+    ELISA_ATLAS_BG_COUNT,
+} elisa_atlas_bg_t;
+
+/**
+ * Eye frames, ordered so that neighbours differ by one step: the eyelids
+ * open in quarter heights from CLOSED to OPEN, then the eye grows by
+ * geometry.eye_wide_step per frame up to WIDE. Animations interpolate
+ * across the index.
+ */
+typedef enum {
+    ELISA_ATLAS_EYE_CLOSED = 0,  /**< Eyes fully hidden */
+    ELISA_ATLAS_EYE_HALF = 2,    /**< Half height */
+    ELISA_ATLAS_EYE_OPEN = 4,
+    ELISA_ATLAS_EYE_WIDE = 6,    /**< LISTENING: two widening steps */
+    ELISA_ATLAS_EYE_COUNT = 7,
+} elisa_atlas_eye_t;
+
+/** Mouth openings (SPEAKING), one draw list each. Frame 0 is at rest. */
+#define ELISA_ATLAS_MOUTH_OPENINGS 11
+
+/** Opacity levels of the resting mouth (THINKING pulse), transparent to opaque. */
+#define ELISA_ATLAS_MOUTH_FADES    8
+
+/** Lip-sync mouth shapes (SPEAKING visemes other than a plain opening). */
+typedef enum {
+    ELISA_ATLAS_MOUTH_WIDE,      /**< Lips spread: e, i */
+    ELISA_ATLAS_MOUTH_ROUND,     /**< Lips rounded: o, u */
+    ELISA_ATLAS_MOUTH_TEETH,     /**< Teeth showing: s, f */
+    ELISA_ATLAS_MOUTH_SHAPES,
+} elisa_atlas_mouth_shape_t;
+
+/** Sizes of each lip-sync shape, smallest first. */
+#define ELISA_ATLAS_MOUTH_SHAPE_SIZES 3
+
+/** Mouth frames with their own draw list: openings, then shapes. */
+#define ELISA_ATLAS_MOUTH_DRAWN \
+    (ELISA_ATLAS_MOUTH_OPENINGS + ELISA_ATLAS_MOUTH_SHAPES * ELISA_ATLAS_MOUTH_SHAPE_SIZES)
+
+#define ELISA_ATLAS_MOUTH_COUNT    (ELISA_ATLAS_MOUTH_DRAWN + ELISA_ATLAS_MOUTH_FADES)
+
+/** Mouth frame index of a lip-sync shape at size 0 .. SHAPE_SIZES-1. */
+#define ELISA_ATLAS_MOUTH_SHAPE(shape, size) \
+    (ELISA_ATLAS_MOUTH_OPENINGS + (shape) * ELISA_ATLAS_MOUTH_SHAPE_SIZES + (size))
+
+/** Mouth frame index of fade level i (0 = invisible .. FADES-1 = opaque). */
+#define ELISA_ATLAS_MOUTH_FADE(i)  (ELISA_ATLAS_MOUTH_DRAWN + (i))
+
+/** Face layout, draw lists and colors (0xRRGGBB) the atlas is rendered from. */
+typedef struct {
+    uint16_t face_w, face_h;     /**< Face box */
+    int16_t eye_dx, eye_dy;      /**< Eye centers from face center (x mirrored) */
+    int16_t mouth_dy;            /**< Mouth center from face center */
+    const elisa_draw_list_t *base;   /**< Face shape and cheeks, face-box coordinates */
+    const elisa_draw_list_t *eye;    /**< One open eye around its center */
+    const elisa_draw_list_t *mouth[ELISA_ATLAS_MOUTH_DRAWN]; /**< Around the mouth center */
+    float eye_wide_step;         /**< Scale added per widening frame */
+    uint32_t screen_rgb;         /**< Color outside the face shape */
+    uint32_t palette[ELISA_PAINT_COUNT];
+    uint32_t error_rgb;          /**< ELISA_PAINT_FACE in ELISA_ATLAS_BG_ERROR */
+    bool swap_bytes;             /**< Store pixels byte-swapped (LV_COLOR_16_SWAP) */
+} elisa_face_geometry_t;
+
+/** Built atlas; all pixel pointers point into the block passed to build. */
+typedef struct {
+    uint16_t face_w, face_h;
+    elisa_rect_t eye_rect[2];    /**< Left, right */
+    elisa_rect_t mouth_rect;
+    const uint16_t *base[ELISA_ATLAS_BG_COUNT];
+    const uint16_t *eye[ELISA_ATLAS_BG_COUNT][2][ELISA_ATLAS_EYE_COUNT]; /**< [bg][side][frame] */
+    const uint16_t *mouth[ELISA_ATLAS_BG_COUNT][ELISA_ATLAS_MOUTH_COUNT];
+    size_t bytes;
+} elisa_face_atlas_t;
+
+/** Bytes of pixel memory elisa_face_atlas_build() needs for this geometry. */
+size_t elisa_face_atlas_size(const elisa_face_geometry_t *geom);
+
+/**
+ * Render every frame into mem.
+ *
+ * @param atlas    Output atlas
+ * @param geom     Face geometry and colors
+ * @param mem      Pixel memory, 2-byte aligned
+ * @param mem_size At least elisa_face_atlas_size(geom)
+ * @return 0 on success, -1 if mem is too small or a feature does not fit
+ *         inside the face box
+ */
+int elisa_face_atlas_build(elisa_face_atlas_t *atlas, const elisa_face_geometry_t *geom,
+                           void *mem, size_t mem_size);
+
+/**
+ * Copy a frame into a face_w-wide destination image at rect.
+ *
+ * @return Pixels copied
+ */
+size_t elisa_face_atlas_blit(uint16_t *dst, uint16_t dst_w, const elisa_rect_t *rect,
+                             const uint16_t *src);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ELISA_FACE_ATLAS_H */
@@ -0,0 +1,270 @@
+/**
+ * @file elisa_face_style.c
+ * @brief Style resolution and draw list compilation.
+ *
+ * Every number below comes from FacePreview.tsx. Preview coordinates are
+ * a 200x200 box with the face centered at 100,100; eyes and mouth are
+ * compiled around their own centers, the base around the face box.
+ */
+
+#include "elisa_face_style.h"
+
+#include <string.h>
+
+/* Preview layout, relative to the face center */
+#define EYE_DX          35
+#define EYE_DY          (-20)
+#define HAPPY_EYE_LIFT  2
+#define MOUTH_DY        30
+#define CHEEK_DX        45
+#define CHEEK_DY        10
+
+/* Face boxes per base shape */
+#define ROUND_R         80
+#define SQUARE_SIZE     160
+#define SQUARE_RADIUS   20
+#define OVAL_RX         70
+#define OVAL_RY         85
+
+#define WHITE_RGB       0xFFFFFF
+#define DARK_RGB        0x333333
+
+/* Opacity (0..255) of cheeks and the extra shy blush */
+#define CHEEK_ALPHA     77
+#define SHY_ALPHA       64
+
+// ── Resolution ──────────────────────────────────────────────────────────
+
+const char *const elisa_face_shape_names[ELISA_SHAPE_COUNT] = { "round", "square", "oval" };
+const char *const elisa_eye_style_names[ELISA_EYES_COUNT] = {
+    "dots", "circles", "anime", "pixels", "sleepy",
+};
+const char *const elisa_eye_size_names[ELISA_EYE_SIZE_COUNT] = { "small", "medium", "large" };
+const char *const elisa_mouth_style_names[ELISA_MOUTH_COUNT] = {
+    "line", "smile", "zigzag", "open", "cat",
+};
+const char *const elisa_expression_names[ELISA_EXPR_COUNT] = {
+    "happy", "neutral", "excited", "shy", "cool",
+};
+
+#define LOOKUP(names, str, fallback) lookup((names), sizeof(names) / sizeof((names)[0]), (str), (fallback))
+
+static int lookup(const char *const *names, int count, const char *str, int fallback) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(names[i], str) == 0) return i;
+    }
+    return fallback;
+}
+
+void elisa_face_style_resolve(const face_descriptor_t *desc, elisa_face_style_t *out) {
+    out->shape = (elisa_face_shape_t)LOOKUP(elisa_face_shape_names, desc->base_shape, ELISA_SHAPE_ROUND);
+    out->eyes = (elisa_eye_style_t)LOOKUP(elisa_eye_style_names, desc->eyes.style, ELISA_EYES_CIRCLES);
+    out->eye_size = (elisa_eye_size_t)LOOKUP(elisa_eye_size_names, desc->eyes.size, ELISA_EYE_MEDIUM);
+    out->mouth = (elisa_mouth_style_t)LOOKUP(elisa_mouth_style_names, desc->mouth.style, ELISA_MOUTH_SMILE);
+    out->expression = (elisa_expression_t)LOOKUP(elisa_expression_names, desc->expression, ELISA_EXPR_HAPPY);
+    out->face_rgb = desc->face_color;
+    out->feature_rgb = desc->eyes.color;
+    out->accent_rgb = desc->accent_color;
+}
+
+// ── Base ────────────────────────────────────────────────────────────────
+
+static void compile_base(const elisa_face_style_t *st, elisa_draw_list_t *l,
+                         uint16_t *face_w, uint16_t *face_h) {
+    elisa_draw_reset(l);
+    switch (st->shape) {
+    case ELISA_SHAPE_SQUARE:
+        *face_w = *face_h = SQUARE_SIZE;
+        elisa_draw_rect(l, 0, 0, SQUARE_SIZE, SQUARE_SIZE, SQUARE_RADIUS, ELISA_PAINT_FACE, 255);
+        break;
+    case ELISA_SHAPE_OVAL:
+        *face_w = 2 * OVAL_RX;
+        *face_h = 2 * OVAL_RY;
+        elisa_draw_ellipse(l, OVAL_RX, OVAL_RY, OVAL_RX, OVAL_RY, ELISA_PAINT_FACE, 255);
+        break;
+    default:
+        *face_w = *face_h = 2 * ROUND_R;
+        elisa_draw_ellipse(l, ROUND_R, ROUND_R, ROUND_R, ROUND_R, ELISA_PAINT_FACE, 255);
+        break;
+    }
+
+    float cx = *face_w / 2.0f, cy = *face_h / 2.0f + CHEEK_DY;
+    for (int side = -1; side <= 1; side += 2) {
+        elisa_draw_ellipse(l, cx + side * CHEEK_DX, cy, 12, 12, ELISA_PAINT_ACCENT, CHEEK_ALPHA);
+        if (st->expression == ELISA_EXPR_SHY) {
+            elisa_draw_ellipse(l, cx + side * CHEEK_DX, cy, 14, 14, ELISA_PAINT_ACCENT, SHY_ALPHA);
+        }
+    }
+}
+
+// ── Eyes ────────────────────────────────────────────────────────────────
+
+static float eye_radius(const elisa_face_style_t *st) {
+    static const float k_radius[] = { 8, 12, 16 };
+    float r = k_radius[st->eye_size];
+    if (st->expression == ELISA_EXPR_EXCITED) r *= 1.2f;
+    if (st->expression == ELISA_EXPR_SHY) r *= 0.85f;
+    return r;
+}
+
+static void compile_eye(const elisa_face_style_t *st, elisa_draw_list_t *l, float r) {
+    elisa_draw_reset(l);
+
+    if (st->expression == ELISA_EXPR_COOL) {
+        elisa_draw_path(l, -r, 0, 3, ELISA_PAINT_FEATURE, 255);
+        elisa_draw_line_to(l, r, 0);
+        return;
+    }
+
+    switch (st->eyes) {
+    case ELISA_EYES_DOTS:
+        elisa_draw_ellipse(l, 0, 0, r * 0.5f, r * 0.5f, ELISA_PAINT_FEATURE, 255);
+        break;
+    case ELISA_EYES_ANIME:
+        elisa_draw_ellipse(l, 0, 0, r, r, ELISA_PAINT_FEATURE, 255);
+        elisa_draw_ellipse(l, r * 0.25f, -r * 0.25f, r * 0.3f, r * 0.3f, ELISA_PAINT_WHITE, 255);
+        break;
+    case ELISA_EYES_PIXELS: {
+        float s = r * 0.35f;
+        elisa_draw_rect(l, -r * 0.4f, -r * 0.4f, s, s, 0, ELISA_PAINT_FEATURE, 255);
+        elisa_draw_rect(l, r * 0.05f, -r * 0.4f, s, s, 0, ELISA_PAINT_FEATURE, 255);
+        elisa_draw_rect(l, -r * 0.4f, r * 0.05f, s, s, 0, ELISA_PAINT_FEATURE, 255);
+        elisa_draw_rect(l, r * 0.05f, r * 0.05f, s, s, 0, ELISA_PAINT_FEATURE, 255);
+        break;
+    }
+    case ELISA_EYES_SLEEPY:
+        elisa_draw_path(l, -r, 0, 2.5f, ELISA_PAINT_FEATURE, 255);
+        elisa_draw_quad_to(l, 0, r * 0.8f, r, 0);
+        break;
+    default: /* circles */
+        elisa_draw_ellipse_stroke(l, 0, 0, r, r, 2, ELISA_PAINT_FEATURE, 255);
+        elisa_draw_ellipse(l, 0, 0, r * 0.4f, r * 0.4f, ELISA_PAINT_FEATURE, 255);
+        break;
+    }
+}
+
+// ── Mouth ───────────────────────────────────────────────────────────────
+
+static void compile_mouth_rest(const elisa_face_style_t *st, elisa_draw_list_t *l, float scale) {
+    float w = 20 * scale;
+    elisa_draw_reset(l);
+
+    switch (st->mouth) {
+    case ELISA_MOUTH_LINE:
+        elisa_draw_path(l, -w, 0, 2.5f, ELISA_PAINT_FEATURE, 255);
+        elisa_draw_line_to(l, w, 0);
+        break;
+    case ELISA_MOUTH_ZIGZAG:
+        elisa_draw_path(l, -w, 0, 2, ELISA_PAINT_FEATURE, 255);
+        elisa_draw_line_to(l, -w * 0.5f, -5);
+        elisa_draw_line_to(l, 0, 3);
+        elisa_draw_line_to(l, w * 0.5f, -5);
+        elisa_draw_line_to(l, w, 0);
+        break;
+    case ELISA_MOUTH_OPEN:
+        elisa_draw_ellipse(l, 0, 0, w * 0.6f, w * 0.45f * scale, ELISA_PAINT_DARK, 255);
+        elisa_draw_ellipse_stroke(l, 0, 0, w * 0.6f, w * 0.45f * scale, 2, ELISA_PAINT_FEATURE, 255);
+        break;
+    case ELISA_MOUTH_CAT: {
+        float half = w * 0.8f;
+        elisa_draw_path(l, -half, -3, 2.5f, ELISA_PAINT_FEATURE, 255);
+        elisa_draw_quad_to(l, -half * 0.4f, 8, 0, -2);
+        elisa_draw_quad_to(l, half * 0.4f, 8, half, -3);
+        break;
+    }
+    default: /* smile */
+        elisa_draw_path(l, -w, -4, 2.5f, ELISA_PAINT_FEATURE, 255);
+        elisa_draw_cubic_to(l, -w * 0.5f, 14 * scale, w * 0.5f, 14 * scale, w, -4);
+        break;
+    }
+}
+
+/** Speaking: an open ellipse, k = 1 .. ELISA_ATLAS_MOUTH_OPENINGS - 1. */
+static void compile_mouth_open(const elisa_face_style_t *st, elisa_draw_list_t *l,
+                               float scale, int k) {
+    float w = 20 * scale;
+    float rx = w * 0.6f;
+    float ry = 1.2f * (float)k * scale;
+    if (st->mouth == ELISA_MOUTH_OPEN) {
+        /* The preview's speaking pulse: 0.8x to 1.2x the resting height */
+        ry = w * 0.45f * scale * (0.8f + 0.4f * (float)k / (ELISA_ATLAS_MOUTH_OPENINGS - 1));
+    }
+    elisa_draw_reset(l);
+    elisa_draw_ellipse(l, 0, 0, rx, ry, ELISA_PAINT_DARK, 255);
+    elisa_draw_ellipse_stroke(l, 0, 0, rx, ry, 2, ELISA_PAINT_FEATURE, 255);
+}
+
+/**
+ * Speaking lip-sync shape at size z = 0 .. ELISA_ATLAS_MOUTH_SHAPE_SIZES - 1,
+ * opening about as far as the plain openings of the same loudness.
+ */
+static void compile_mouth_shape(elisa_draw_list_t *l, float scale,
+                                elisa_atlas_mouth_shape_t shape, int z) {
+    float w = 20 * scale;
+    float rx, ry;
+    elisa_draw_reset(l);
+
+    switch (shape) {
+    case ELISA_ATLAS_MOUTH_WIDE:
+        rx = w * 0.85f;
+        ry = (2.0f + 2.5f * (float)z) * scale;
+        elisa_draw_ellipse(l, 0, 0, rx, ry, ELISA_PAINT_DARK, 255);
+        break;
+    case ELISA_ATLAS_MOUTH_ROUND:
+        rx = (4.0f + 1.5f * (float)z) * scale;
+        ry = (5.0f + 2.5f * (float)z) * scale;
+        elisa_draw_ellipse(l, 0, 0, rx, ry, ELISA_PAINT_DARK, 255);
+        break;
+    default: /* teeth: a band of upper teeth over a narrow opening */
+        rx = w * 0.7f;
+        ry = (3.0f + 1.5f * (float)z) * scale;
+        elisa_draw_ellipse(l, 0, 0, rx, ry, ELISA_PAINT_DARK, 255);
+        elisa_draw_rect(l, -rx * 0.7f, -ry * 0.8f, rx * 1.4f, ry, 1, ELISA_PAINT_WHITE, 255);
+        break;
+    }
+    elisa_draw_ellipse_stroke(l, 0, 0, rx, ry, 2, ELISA_PAINT_FEATURE, 255);
+}
+
+// ── Public API ──────────────────────────────────────────────────────────
+
+int elisa_face_style_compile(const elisa_face_style_t *style, elisa_face_design_t *design,
+                             elisa_face_geometry_t *geom) {
+    memset(geom, 0, sizeof(*geom));
+
+    compile_base(style, &design->base, &geom->face_w, &geom->face_h);
+
+    float r = eye_radius(style);
+    compile_eye(style, &design->eye, r);
+
+    float mouth_scale = (style->expression == ELISA_EXPR_EXCITED) ? 1.3f : 1.0f;
+    compile_mouth_rest(style, &design->mouth[0], mouth_scale);
+    for (int k = 1; k < ELISA_ATLAS_MOUTH_OPENINGS; k++) {
+        compile_mouth_open(style, &design->mouth[k], mouth_scale, k);
+    }
+    for (int sh = 0; sh < ELISA_ATLAS_MOUTH_SHAPES; sh++) {
+        for (int z = 0; z < ELISA_ATLAS_MOUTH_SHAPE_SIZES; z++) {
+            compile_mouth_shape(&design->mouth[ELISA_ATLAS_MOUTH_SHAPE(sh, z)], mouth_scale,
+                                (elisa_atlas_mouth_shape_t)sh, z);
+        }
+    }
+
+    bool overflow = design->base.overflow || design->eye.overflow;
+    for (int k = 0; k < ELISA_ATLAS_MOUTH_DRAWN; k++) {
+        overflow |= design->mouth[k].overflow;
+        geom->mouth[k] = &design->mouth[k];
+    }
+    if (overflow) return -1;
+
+    geom->eye_dx = EYE_DX;
+    geom->eye_dy = (int16_t)(EYE_DY - (style->expression == ELISA_EXPR_HAPPY ? HAPPY_EYE_LIFT : 0));
+    geom->mouth_dy = MOUTH_DY;
+    geom->base = &design->base;
+    geom->eye = &design->eye;
+    geom->eye_wide_step = 1.0f / r;  /* 1 px of radius per widening frame */
+    geom->palette[ELISA_PAINT_FACE] = style->face_rgb;
+    geom->palette[ELISA_PAINT_FEATURE] = style->feature_rgb;
+    geom->palette[ELISA_PAINT_ACCENT] = style->accent_rgb;
+    geom->palette[ELISA_PAINT_WHITE] = WHITE_RGB;
+    geom->palette[ELISA_PAINT_DARK] = DARK_RGB;
+    return 0;
+}
@@ -0,0 +1,100 @@
+/**
+ * @file elisa_face_style.h
+ * @brief FaceDescriptor styles compiled into atlas draw lists.
+ *
+ * The descriptor's strings are resolved once into enums, then every
+ * style is compiled into draw lists in the same coordinates as the
+ * browser preview (FacePreview.tsx, a 200x200 SVG with the face centered
+ * at 100,100), so the device and the preview draw the same face:
+ *
+ * - base shapes: round, square, oval, with cheeks (extra blush when shy)
+ * - eyes: dots, circles, anime, pixels, sleepy; small/medium/large;
+ *   "cool" replaces them with lines, "excited"/"shy" scale them
+ * - mouths: line, smile, zigzag, open, cat; "excited" scales them
+ *
+ * While speaking, every mouth style opens into an ellipse sized by the
+ * audio level (the "open" style keeps its own proportions), or takes one
+ * of the lip-sync shapes (wide, round, teeth) in three sizes.
+ *
+ * Plain C with no LVGL or ESP-IDF dependency so host tools can share it.
+ */
+
+#ifndef ELISA_FACE_STYLE_H
+#define ELISA_FACE_STYLE_H
+
+#include "elisa_config.h"
+#include "elisa_draw.h"
+#include "elisa_face_atlas.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    ELISA_SHAPE_ROUND, ELISA_SHAPE_SQUARE, ELISA_SHAPE_OVAL, ELISA_SHAPE_COUNT,
+} elisa_face_shape_t;
+
+typedef enum {
+    ELISA_EYES_DOTS, ELISA_EYES_CIRCLES, ELISA_EYES_ANIME, ELISA_EYES_PIXELS, ELISA_EYES_SLEEPY,
+    ELISA_EYES_COUNT,
+} elisa_eye_style_t;
+
+typedef enum { ELISA_EYE_SMALL, ELISA_EYE_MEDIUM, ELISA_EYE_LARGE, ELISA_EYE_SIZE_COUNT } elisa_eye_size_t;
+
+typedef enum {
+    ELISA_MOUTH_LINE, ELISA_MOUTH_SMILE, ELISA_MOUTH_ZIGZAG, ELISA_MOUTH_OPEN, ELISA_MOUTH_CAT,
+    ELISA_MOUTH_COUNT,
+} elisa_mouth_style_t;
+
+typedef enum {
+    ELISA_EXPR_HAPPY, ELISA_EXPR_NEUTRAL, ELISA_EXPR_EXCITED, ELISA_EXPR_SHY, ELISA_EXPR_COOL,
+    ELISA_EXPR_COUNT,
+} elisa_expression_t;
+
+/** Descriptor strings by enum value (the binary config stores the enums). */
+extern const char *const elisa_face_shape_names[ELISA_SHAPE_COUNT];
+extern const char *const elisa_eye_style_names[ELISA_EYES_COUNT];
+extern const char *const elisa_eye_size_names[ELISA_EYE_SIZE_COUNT];
+extern const char *const elisa_mouth_style_names[ELISA_MOUTH_COUNT];
+extern const char *const elisa_expression_names[ELISA_EXPR_COUNT];
+
+/** A face descriptor with its strings resolved. */
+typedef struct {
+    elisa_face_shape_t shape;
+    elisa_eye_style_t eyes;
+    elisa_eye_size_t eye_size;
+    elisa_mouth_style_t mouth;
+    elisa_expression_t expression;
+    uint32_t face_rgb;
+    uint32_t feature_rgb;
+    uint32_t accent_rgb;
+} elisa_face_style_t;
+
+/** Draw lists a style compiles into; only needed while the atlas is built. */
+typedef struct {
+    elisa_draw_list_t base;
+    elisa_draw_list_t eye;
+    elisa_draw_list_t mouth[ELISA_ATLAS_MOUTH_DRAWN];
+} elisa_face_design_t;
+
+/**
+ * Resolve descriptor strings. Unknown values fall back to the defaults of
+ * elisa_config.c (round, circles, medium, smile, happy).
+ */
+void elisa_face_style_resolve(const face_descriptor_t *desc, elisa_face_style_t *out);
+
+/**
+ * Compile a style into draw lists and the atlas geometry that uses them.
+ * geom points into design; screen_rgb, error_rgb and swap_bytes are left
+ * for the caller.
+ *
+ * @return 0 on success, -1 if a draw list overflowed
+ */
+int elisa_face_style_compile(const elisa_face_style_t *style, elisa_face_design_t *design,
+                             elisa_face_geometry_t *geom);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ELISA_FACE_STYLE_H */
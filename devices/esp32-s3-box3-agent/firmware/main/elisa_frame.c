@@ -0,0 +1,121 @@
+/**
+ * @file elisa_frame.c
+ * @brief Serial stream framing implementation.
+ */
+
+#include "elisa_frame.h"
+
+#include <string.h>
+
+// ── CRC-32 ──────────────────────────────────────────────────────────────
+
+static uint32_t s_crc_table[256];
+static int s_crc_ready = 0;
+
+static void crc_table_init(void) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++) {
+            c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+        }
+        s_crc_table[i] = c;
+    }
+    s_crc_ready = 1;
+}
+
+uint32_t elisa_crc32(uint32_t crc, const uint8_t *data, size_t len) {
+    if (!s_crc_ready) crc_table_init();
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc = s_crc_table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+// ── Little-Endian Helpers ───────────────────────────────────────────────
+
+static void put_le16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_le32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static uint16_t get_le16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_le32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// ── Encode / Decode ─────────────────────────────────────────────────────
+
+size_t elisa_frame_encode(uint8_t *out, uint8_t type, uint32_t seq,
+                          const uint8_t *payload, size_t len) {
+    if (len > ELISA_FRAME_MAX_PAYLOAD) return 0;
+
+    out[0] = ELISA_FRAME_SYNC0;
+    out[1] = ELISA_FRAME_SYNC1;
+    out[2] = type;
+    out[3] = 0;
+    put_le32(out + 4, seq);
+    put_le16(out + 8, (uint16_t)len);
+    if (len > 0) {
+        memcpy(out + ELISA_FRAME_HEADER_SIZE, payload, len);
+    }
+
+    uint32_t crc = elisa_crc32(0, out + 2, ELISA_FRAME_HEADER_SIZE - 2 + len);
+    put_le32(out + ELISA_FRAME_HEADER_SIZE + len, crc);
+    return ELISA_FRAME_HEADER_SIZE + len + ELISA_FRAME_CRC_SIZE;
+}
+
+void elisa_frame_status_pack(uint8_t out[ELISA_FRAME_STATUS_SIZE], const elisa_frame_status_t *st) {
+    put_le32(out + 0, st->frames_sent);
+    put_le32(out + 4, st->samples_sent);
+    put_le32(out + 8, st->samples_dropped);
+    put_le32(out + 12, st->ring_high_water);
+    put_le32(out + 16, st->audio_bytes_sent);
+    out[20] = st->final;
+}
+
+int elisa_frame_decode(const uint8_t *buf, size_t size, elisa_frame_t *frame, size_t *consumed) {
+    size_t pos = 0;
+
+    while (pos + ELISA_FRAME_OVERHEAD <= size) {
+        if (buf[pos] != ELISA_FRAME_SYNC0 || buf[pos + 1] != ELISA_FRAME_SYNC1) {
+            pos++;
+            continue;
+        }
+
+        size_t len = get_le16(buf + pos + 8);
+        if (len > ELISA_FRAME_MAX_PAYLOAD) {
+            pos++; /* sync pattern inside other data */
+            continue;
+        }
+        if (pos + ELISA_FRAME_OVERHEAD + len > size) {
+            break; /* plausible frame, not all here yet */
+        }
+
+        uint32_t want = get_le32(buf + pos + ELISA_FRAME_HEADER_SIZE + len);
+        if (elisa_crc32(0, buf + pos + 2, ELISA_FRAME_HEADER_SIZE - 2 + len) != want) {
+            pos++;
+            continue;
+        }
+
+        frame->type = buf[pos + 2];
+        frame->seq = get_le32(buf + pos + 4);
+        frame->payload = buf + pos + ELISA_FRAME_HEADER_SIZE;
+        frame->len = len;
+        *consumed = pos + ELISA_FRAME_OVERHEAD + len;
+        return 1;
+    }
+
+    *consumed = pos;
+    return 0;
+}
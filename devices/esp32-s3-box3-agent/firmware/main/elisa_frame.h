@@ -0,0 +1,104 @@
+/**
+ * @file elisa_frame.h
+ * @brief Framing for binary streams over the serial console.
+ *
+ * Recording mode shares the console with ESP_LOG output, so every chunk of
+ * binary data is wrapped in a self-delimiting frame the host can find in
+ * the byte stream, check and put back in order:
+ *
+ *   offset  size  field
+ *   0       2     sync: 0xA5 0x5A
+ *   2       1     type (elisa_frame_type_t)
+ *   3       1     flags (reserved, 0)
+ *   4       4     sequence number, little endian, +1 per frame
+ *   8       2     payload length, little endian (<= ELISA_FRAME_MAX_PAYLOAD)
+ *   10      n     payload
+ *   10+n    4     CRC-32 (zlib polynomial) of bytes 2 .. 10+n-1, little endian
+ *
+ * A gap in sequence numbers means frames were lost on the host side; the
+ * device's own losses are reported in ELISA_FRAME_STATUS frames. The host
+ * resynchronizes on the next sync pattern with a valid CRC.
+ *
+ * Plain C with no ESP-IDF dependency so host tools can share it.
+ */
+
+#ifndef ELISA_FRAME_H
+#define ELISA_FRAME_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ELISA_FRAME_SYNC0         0xA5
+#define ELISA_FRAME_SYNC1         0x5A
+#define ELISA_FRAME_HEADER_SIZE   10
+#define ELISA_FRAME_CRC_SIZE      4
+#define ELISA_FRAME_OVERHEAD      (ELISA_FRAME_HEADER_SIZE + ELISA_FRAME_CRC_SIZE)
+#define ELISA_FRAME_MAX_PAYLOAD   4096
+
+/** Frame payload types. */
+typedef enum {
+    ELISA_FRAME_PCM16  = 0x01, /**< 16 kHz mono int16 LE samples */
+    ELISA_FRAME_STATUS = 0x02, /**< elisa_frame_status_t, little endian */
+    ELISA_FRAME_RICE   = 0x03, /**< one elisa_rice.h block of 16 kHz mono samples */
+} elisa_frame_type_t;
+
+/** Payload of an ELISA_FRAME_STATUS frame (all fields little endian). */
+typedef struct {
+    uint32_t frames_sent;      /**< Frames written since RECORD */
+    uint32_t samples_sent;     /**< Samples written since RECORD */
+    uint32_t samples_dropped;  /**< Samples lost because the ring was full */
+    uint32_t ring_high_water;  /**< Most samples ever waiting in the ring */
+    uint32_t audio_bytes_sent; /**< Audio payload bytes (after compression) */
+    uint8_t  final;            /**< 1 in the last frame before STOP completes */
+} elisa_frame_status_t;
+
+#define ELISA_FRAME_STATUS_SIZE 21
+
+/** CRC-32 (reflected, polynomial 0xEDB88320), same as zlib.crc32(). */
+uint32_t elisa_crc32(uint32_t crc, const uint8_t *data, size_t len);
+
+/**
+ * Write a complete frame into out.
+ *
+ * @param out      Buffer of at least len + ELISA_FRAME_OVERHEAD bytes
+ * @param type     Payload type
+ * @param seq      Sequence number
+ * @param payload  Payload bytes (may be NULL when len is 0)
+ * @param len      Payload length, <= ELISA_FRAME_MAX_PAYLOAD
+ * @return Total frame size in bytes, or 0 if len is too large
+ */
+size_t elisa_frame_encode(uint8_t *out, uint8_t type, uint32_t seq,
+                          const uint8_t *payload, size_t len);
+
+/** Serialize a status payload (ELISA_FRAME_STATUS_SIZE bytes). */
+void elisa_frame_status_pack(uint8_t out[ELISA_FRAME_STATUS_SIZE], const elisa_frame_status_t *st);
+
+/** Parsed view of a frame inside a caller's buffer. */
+typedef struct {
+    uint8_t type;
+    uint32_t seq;
+    const uint8_t *payload;
+    size_t len;
+} elisa_frame_t;
+
+/**
+ * Find and validate the first frame in buf.
+ *
+ * @param buf      Received bytes
+ * @param size     Number of bytes in buf
+ * @param frame    Output frame (payload points into buf)
+ * @param consumed Output: bytes of buf that can be discarded (garbage
+ *                 before the frame plus the frame itself when found)
+ * @return 1 if a valid frame was found, 0 if more data is needed
+ */
+int elisa_frame_decode(const uint8_t *buf, size_t size, elisa_frame_t *frame, size_t *consumed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ELISA_FRAME_H */
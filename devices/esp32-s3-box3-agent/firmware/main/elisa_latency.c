@@ -0,0 +1,174 @@
+/**
+ * @file elisa_latency.c
+ * @brief Log-bucketed turn latency histograms implementation.
+ *
+ * Bucket index for value v (ms): v itself below 16; otherwise the octave
+ * e = floor(log2(v)) and the next ELISA_LAT_SUB_BITS bits below the top
+ * bit select one of 8 sub-buckets. Writers are the sr_handler task and the
+ * HTTP event handler; the heartbeat task swaps the set out, so every
+ * access is under a spinlock (a few dozen instructions at most).
+ */
+
+#include "elisa_latency.h"
+
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "esp_timer.h"
+
+#define SUB_COUNT     (1u << ELISA_LAT_SUB_BITS)
+#define LINEAR_LIMIT  (2u * SUB_COUNT) /* values below this get their own bucket */
+#define LINEAR_BITS   (ELISA_LAT_SUB_BITS + 1)
+
+_Static_assert(ELISA_LAT_BUCKETS == LINEAR_LIMIT + (16 - LINEAR_BITS) * SUB_COUNT,
+               "ELISA_LAT_BUCKETS must cover 0..ELISA_LAT_MAX_MS");
+
+// ── Static State ────────────────────────────────────────────────────────
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static elisa_latency_hist_t s_hists[LAT_METRIC_COUNT];
+
+/** Last wake word detection not yet claimed by a turn (0 = none). */
+static int64_t s_pending_wake_us = 0;
+/** Wake time of the current turn (0 = no turn). */
+static int64_t s_turn_wake_us = 0;
+/** Metrics already recorded relative to this turn's wake (bit per metric). */
+static uint32_t s_turn_recorded = 0;
+
+static const char *const s_metric_names[LAT_METRIC_COUNT] = {
+    [LAT_WAKE_TO_UPLOAD] = "wake_to_upload",
+    [LAT_UPLOAD]         = "upload",
+    [LAT_TTFB]           = "ttfb",
+    [LAT_DECODE]         = "decode",
+    [LAT_FIRST_AUDIO]    = "first_audio",
+};
+
+// ── Buckets ─────────────────────────────────────────────────────────────
+
+static int bucket_index(uint32_t ms) {
+    if (ms < LINEAR_LIMIT) return (int)ms;
+    int e = 31 - __builtin_clz(ms);
+    uint32_t sub = (ms >> (e - ELISA_LAT_SUB_BITS)) & (SUB_COUNT - 1);
+    return (int)(LINEAR_LIMIT + (uint32_t)(e - LINEAR_BITS) * SUB_COUNT + sub);
+}
+
+uint32_t elisa_latency_bucket_upper_ms(int idx) {
+    if (idx < 0) return 0;
+    if (idx < (int)LINEAR_LIMIT) return (uint32_t)idx;
+    if (idx >= ELISA_LAT_BUCKETS) return ELISA_LAT_MAX_MS;
+    int e = (idx - (int)LINEAR_LIMIT) / (int)SUB_COUNT + LINEAR_BITS;
+    uint32_t sub = (uint32_t)(idx - (int)LINEAR_LIMIT) % SUB_COUNT;
+    uint32_t width = 1u << (e - ELISA_LAT_SUB_BITS);
+    return ((SUB_COUNT + sub) << (e - ELISA_LAT_SUB_BITS)) + width - 1;
+}
+
+/** Add one hist into another, saturating the 16-bit counters. */
+static void hist_merge(elisa_latency_hist_t *dst, const elisa_latency_hist_t *src) {
+    for (int i = 0; i < ELISA_LAT_BUCKETS; i++) {
+        uint32_t c = (uint32_t)dst->counts[i] + src->counts[i];
+        dst->counts[i] = (c > UINT16_MAX) ? UINT16_MAX : (uint16_t)c;
+    }
+    dst->total += src->total;
+    dst->sum_ms += src->sum_ms;
+    if (src->max_ms > dst->max_ms) dst->max_ms = src->max_ms;
+}
+
+// ── Recording ───────────────────────────────────────────────────────────
+
+void elisa_latency_mark_wake(void) {
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&s_lock);
+    s_pending_wake_us = now;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void elisa_latency_turn_begin(int64_t record_start_us) {
+    portENTER_CRITICAL(&s_lock);
+    s_turn_wake_us = (s_pending_wake_us != 0) ? s_pending_wake_us : record_start_us;
+    s_pending_wake_us = 0;
+    s_turn_recorded = 0;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void elisa_latency_record(elisa_latency_metric_t metric, int64_t duration_us) {
+    if (metric >= LAT_METRIC_COUNT || duration_us < 0) return;
+
+    uint32_t ms = (uint32_t)((duration_us + 500) / 1000);
+    if (ms > ELISA_LAT_MAX_MS) ms = ELISA_LAT_MAX_MS;
+    int idx = bucket_index(ms);
+
+    portENTER_CRITICAL(&s_lock);
+    elisa_latency_hist_t *h = &s_hists[metric];
+    if (h->counts[idx] < UINT16_MAX) h->counts[idx]++;
+    h->total++;
+    h->sum_ms += ms;
+    if (ms > h->max_ms) h->max_ms = ms;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void elisa_latency_record_since_wake(elisa_latency_metric_t metric) {
+    if (metric >= LAT_METRIC_COUNT) return;
+
+    int64_t now = esp_timer_get_time();
+    int64_t wake_us = 0;
+
+    portENTER_CRITICAL(&s_lock);
+    if (s_turn_wake_us != 0 && !(s_turn_recorded & (1u << metric))) {
+        s_turn_recorded |= 1u << metric;
+        wake_us = s_turn_wake_us;
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+    if (wake_us != 0) {
+        elisa_latency_record(metric, now - wake_us);
+    }
+}
+
+void elisa_latency_skip(elisa_latency_metric_t metric) {
+    if (metric >= LAT_METRIC_COUNT) return;
+
+    portENTER_CRITICAL(&s_lock);
+    s_turn_recorded |= 1u << metric;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+// ── Reporting ───────────────────────────────────────────────────────────
+
+void elisa_latency_take(elisa_latency_hist_t out[LAT_METRIC_COUNT]) {
+    portENTER_CRITICAL(&s_lock);
+    memcpy(out, s_hists, sizeof(s_hists));
+    memset(s_hists, 0, sizeof(s_hists));
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void elisa_latency_restore(const elisa_latency_hist_t in[LAT_METRIC_COUNT]) {
+    portENTER_CRITICAL(&s_lock);
+    for (int m = 0; m < LAT_METRIC_COUNT; m++) {
+        hist_merge(&s_hists[m], &in[m]);
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+uint32_t elisa_latency_percentile(const elisa_latency_hist_t *hist, uint32_t pct) {
+    if (hist == NULL || hist->total == 0) return 0;
+    if (pct > 100) pct = 100;
+
+    /* Rank of the requested sample, 1-based, rounded up */
+    uint32_t rank = (uint32_t)(((uint64_t)hist->total * pct + 99) / 100);
+    if (rank == 0) rank = 1;
+
+    uint32_t seen = 0;
+    for (int i = 0; i < ELISA_LAT_BUCKETS; i++) {
+        seen += hist->counts[i];
+        if (seen >= rank) {
+            uint32_t upper = elisa_latency_bucket_upper_ms(i);
+            return (upper < hist->max_ms) ? upper : hist->max_ms;
+        }
+    }
+    return hist->max_ms;
+}
+
+const char *elisa_latency_metric_name(elisa_latency_metric_t metric) {
+    return (metric < LAT_METRIC_COUNT) ? s_metric_names[metric] : "unknown";
+}
@@ -0,0 +1,95 @@
+/**
+ * @file elisa_latency.h
+ * @brief Log-bucketed turn latency histograms for the runtime heartbeat.
+ *
+ * Keeps one fixed-size histogram per turn latency metric. Buckets are
+ * HDR-style: exact below 16 ms, then 8 sub-buckets per power of two
+ * (<= 12.5% relative error) up to 65.5 s, in 112 16-bit counters per
+ * metric. Recording is a bucket lookup and an increment.
+ *
+ * Histograms cover one heartbeat interval: the heartbeat task takes them
+ * with elisa_latency_take(), posts them, and hands them back with
+ * elisa_latency_restore() if the post failed. The runtime merges the
+ * buckets, so fleet-wide percentiles need no extra tooling.
+ */
+
+#ifndef ELISA_LATENCY_H
+#define ELISA_LATENCY_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Sub-buckets per power of two, as a bit count (8 -> 12.5% resolution). */
+#define ELISA_LAT_SUB_BITS  3
+/** Values are clamped to this many milliseconds. */
+#define ELISA_LAT_MAX_MS    65535u
+/** 16 exact buckets + 8 per octave from 16 ms to 64 s. */
+#define ELISA_LAT_BUCKETS   112
+
+/**
+ * Turn latency metrics.
+ */
+typedef enum {
+    LAT_WAKE_TO_UPLOAD, /**< Wake word -> first request byte (includes recording) */
+    LAT_UPLOAD,         /**< Request body upload */
+    LAT_TTFB,           /**< Upload done -> first response header (server time) */
+    LAT_DECODE,         /**< Ogg Opus -> PCM decode */
+    LAT_FIRST_AUDIO,    /**< Wake word -> first reply audio written to I2S */
+    LAT_METRIC_COUNT
+} elisa_latency_metric_t;
+
+/** One metric's histogram (milliseconds). */
+typedef struct {
+    uint16_t counts[ELISA_LAT_BUCKETS];
+    uint32_t total;
+    uint32_t sum_ms;
+    uint32_t max_ms;
+} elisa_latency_hist_t;
+
+/** Record the wake word detection time. Called from the detector. */
+void elisa_latency_mark_wake(void);
+
+/**
+ * Start a turn's wake-relative clock. Uses the last elisa_latency_mark_wake()
+ * if there is one, otherwise @p record_start_us (the back-dated capture start).
+ */
+void elisa_latency_turn_begin(int64_t record_start_us);
+
+/** Record a duration for @p metric. */
+void elisa_latency_record(elisa_latency_metric_t metric, int64_t duration_us);
+
+/**
+ * Record the time since this turn's wake for @p metric. Each metric is
+ * recorded at most once per turn; later calls are ignored.
+ */
+void elisa_latency_record_since_wake(elisa_latency_metric_t metric);
+
+/**
+ * Mark @p metric as recorded for this turn without a sample, for a turn
+ * that will not reach that stage (a failed turn playing its prompt).
+ */
+void elisa_latency_skip(elisa_latency_metric_t metric);
+
+/** Move the interval histograms into @p out and start a new interval. */
+void elisa_latency_take(elisa_latency_hist_t out[LAT_METRIC_COUNT]);
+
+/** Merge histograms from elisa_latency_take() back in (report failed). */
+void elisa_latency_restore(const elisa_latency_hist_t in[LAT_METRIC_COUNT]);
+
+/** Highest value (ms) that falls into bucket @p idx. */
+uint32_t elisa_latency_bucket_upper_ms(int idx);
+
+/** Value (ms) at percentile @p pct (0-100), as its bucket's upper bound. */
+uint32_t elisa_latency_percentile(const elisa_latency_hist_t *hist, uint32_t pct);
+
+/** Metric name used in the heartbeat body ("wake_to_upload", ...). */
+const char *elisa_latency_metric_name(elisa_latency_metric_t metric);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ELISA_LATENCY_H */
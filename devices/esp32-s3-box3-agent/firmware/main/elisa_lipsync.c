@@ -0,0 +1,221 @@
+/**
+ * @file elisa_lipsync.c
+ * @brief audio_player write hook: viseme analysis and play-clock posting.
+ *
+ * Everything but the stats runs on the audio player task, the only
+ * caller of the hooks and of the playback finish callback, so the
+ * analyzer, the play clock and the pending ring need no lock. The face
+ * only sees elisa_face_set_viseme(), one enqueue per 20 ms window.
+ */
+
+#include "elisa_lipsync.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#include "elisa_face.h"
+#include "elisa_latency.h"
+
+static const char *TAG = "elisa_lipsync";
+
+/* Windows analyzed but not yet playing; the DMA ring holds at most three */
+#define PENDING_SIZE 8
+
+// ── Static State ────────────────────────────────────────────────────────
+
+static elisa_viseme_analyzer_t s_analyzer;
+static bool s_active = false;          /* stream is analyzed */
+static uint32_t s_rate = 0;
+static uint8_t s_channels = 0;
+static size_t s_window_frames = 0;
+static size_t s_window_fill = 0;       /* frames fed into the current window */
+static int64_t s_play_end_us = 0;      /* when the last written frame plays */
+static bool s_first_write = false;     /* nothing of this stream written yet */
+
+typedef struct {
+    int64_t due_us;
+    elisa_viseme_frame_t frame;
+} pending_t;
+
+static pending_t s_pending[PENDING_SIZE];
+static uint8_t s_pending_head = 0;
+static uint8_t s_pending_count = 0;
+
+/* Stats and position (audio player task writes, STATS and captions read) */
+static portMUX_TYPE s_stats_lock = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t s_stream = 0;
+static uint32_t s_stream_windows = 0;  /* windows posted this stream */
+static int64_t s_stream_start_us = 0;
+static elisa_lipsync_stats_t s_stats;
+static int64_t s_stats_since_us = 0;
+
+// ── Posting ─────────────────────────────────────────────────────────────
+
+static void post(const pending_t *p, int64_t now) {
+    elisa_face_set_viseme((elisa_viseme_t)p->frame.viseme, p->frame.level);
+
+    portENTER_CRITICAL(&s_stats_lock);
+    if (now - p->due_us > ELISA_VISEME_WINDOW_MS * 1000) s_stats.late++;
+    s_stats.visemes[p->frame.viseme]++;
+    s_stream_windows++;
+    portEXIT_CRITICAL(&s_stats_lock);
+}
+
+/** Post pending windows that are due, oldest first. */
+static void post_due(int64_t now) {
+    while (s_pending_count > 0 && s_pending[s_pending_head].due_us <= now) {
+        post(&s_pending[s_pending_head], now);
+        s_pending_head = (uint8_t)((s_pending_head + 1) % PENDING_SIZE);
+        s_pending_count--;
+    }
+}
+
+static void queue_window(elisa_viseme_frame_t frame, int64_t due_us, int64_t now) {
+    if (s_pending_count == PENDING_SIZE) {
+        /* Only if the clock is far off: show the oldest rather than lose it */
+        post(&s_pending[s_pending_head], now);
+        s_pending_head = (uint8_t)((s_pending_head + 1) % PENDING_SIZE);
+        s_pending_count--;
+    }
+    pending_t *p = &s_pending[(s_pending_head + s_pending_count) % PENDING_SIZE];
+    p->due_us = due_us;
+    p->frame = frame;
+    s_pending_count++;
+}
+
+// ── Public API ──────────────────────────────────────────────────────────
+
+esp_err_t elisa_lipsync_set_fs(uint32_t rate, uint32_t bits_cfg, i2s_slot_mode_t ch) {
+    uint8_t channels = (ch == I2S_SLOT_MODE_STEREO) ? 2 : 1;
+
+    /* A new stream: what is pending belonged to the previous one */
+    s_pending_count = 0;
+    s_window_fill = 0;
+    s_play_end_us = 0;
+    s_first_write = true;
+    s_active = false;
+    if (bits_cfg == 16 && elisa_viseme_init(&s_analyzer, rate, channels) == 0) {
+        s_active = true;
+        s_window_frames = elisa_viseme_window_frames(&s_analyzer);
+    } else {
+        ESP_LOGW(TAG, "No lip sync for %lu Hz %lu-bit audio",
+                 (unsigned long)rate, (unsigned long)bits_cfg);
+    }
+    s_rate = rate;
+    s_channels = channels;
+
+    portENTER_CRITICAL(&s_stats_lock);
+    s_stream++;
+    s_stream_windows = 0;
+    s_stream_start_us = esp_timer_get_time();
+    portEXIT_CRITICAL(&s_stats_lock);
+
+    return bsp_codec_set_fs(rate, bits_cfg, ch);
+}
+
+/** The turn's first_audio: when its first samples reach the I2S DMA ring. */
+static void mark_first_write(size_t written) {
+    if (s_first_write && written > 0) {
+        s_first_write = false;
+        elisa_latency_record_since_wake(LAT_FIRST_AUDIO);
+    }
+}
+
+esp_err_t elisa_lipsync_i2s_write(void *audio_buffer, size_t len, size_t *bytes_written,
+                                  uint32_t timeout_ms) {
+    if (!s_active) {
+        size_t written = 0;
+        esp_err_t err = bsp_i2s_write(audio_buffer, len, &written, timeout_ms);
+        mark_first_write(written);
+        if (bytes_written != NULL) *bytes_written = written;
+        return err;
+    }
+
+    const size_t frame_bytes = (size_t)s_channels * sizeof(int16_t);
+    const uint8_t *src = (const uint8_t *)audio_buffer;
+    size_t done = 0;
+    esp_err_t err = ESP_OK;
+
+    while (done < len) {
+        /* Slices end on window boundaries, so each finishes at most one window */
+        size_t frames = (len - done) / frame_bytes;
+        size_t bytes = len - done;
+        if (frames > s_window_frames - s_window_fill) {
+            frames = s_window_frames - s_window_fill;
+            bytes = frames * frame_bytes;
+        }
+
+        int64_t t0 = esp_timer_get_time();
+        elisa_viseme_frame_t frame;
+        size_t n = elisa_viseme_feed(&s_analyzer, (const int16_t *)(src + done), frames,
+                                     &frame, 1);
+        s_window_fill = (s_window_fill + frames) % s_window_frames;
+        int64_t t1 = esp_timer_get_time();
+
+        size_t written = 0;
+        err = bsp_i2s_write((void *)(src + done), bytes, &written, timeout_ms);
+        mark_first_write(written);
+        done += written;
+
+        /* This slice plays after whatever is still in the DMA ring */
+        int64_t slice_us = (int64_t)(written / frame_bytes) * 1000000 / s_rate;
+        s_play_end_us = ((s_play_end_us > t0) ? s_play_end_us : t0) + slice_us;
+        if (n > 0) {
+            /* Due before the window's first frame plays */
+            int64_t lead_us = (int64_t)(ELISA_VISEME_WINDOW_MS + ELISA_LIPSYNC_LEAD_MS) * 1000;
+            queue_window(frame, s_play_end_us - lead_us, t1);
+        }
+
+        int64_t now = esp_timer_get_time();
+        post_due(now);
+
+        uint32_t us = (uint32_t)(t1 - t0);
+        portENTER_CRITICAL(&s_stats_lock);
+        s_stats.windows += (uint32_t)n;
+        s_stats.analyze_us_total += us;
+        if (us > s_stats.analyze_us_max) s_stats.analyze_us_max = us;
+        portEXIT_CRITICAL(&s_stats_lock);
+
+        if (err != ESP_OK || written < bytes) break;
+    }
+
+    if (bytes_written != NULL) *bytes_written = done;
+    return err;
+}
+
+void elisa_lipsync_finish(void) {
+    /* Nothing writes any more, so each remaining window waits for its own due time */
+    while (s_pending_count > 0) {
+        int64_t wait_us = s_pending[s_pending_head].due_us - esp_timer_get_time();
+        if (wait_us > 0) {
+            vTaskDelay(pdMS_TO_TICKS((wait_us + 999) / 1000) + 1);
+        }
+        post_due(esp_timer_get_time());
+    }
+}
+
+void elisa_lipsync_position(uint32_t *stream, uint32_t *position_ms) {
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&s_stats_lock);
+    *stream = s_stream;
+    *position_ms = s_active ? s_stream_windows * ELISA_VISEME_WINDOW_MS
+                            : (uint32_t)((now - s_stream_start_us) / 1000);
+    portEXIT_CRITICAL(&s_stats_lock);
+}
+
+void elisa_lipsync_take_stats(elisa_lipsync_stats_t *out) {
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&s_stats_lock);
+    *out = s_stats;
+    out->interval_us = now - s_stats_since_us;
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_stats_since_us = now;
+    portEXIT_CRITICAL(&s_stats_lock);
+}
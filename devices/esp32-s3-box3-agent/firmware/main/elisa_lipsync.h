@@ -0,0 +1,91 @@
+/**
+ * @file elisa_lipsync.h
+ * @brief Lip sync on the speaker path: audio_player output to face visemes.
+ *
+ * chatgpt_demo's audio_player hands decoded PCM to bsp_i2s_write() and
+ * sets the codec rate with bsp_codec_set_fs(). build-firmware.sh points
+ * its write_fn and clk_set_fn at the wrappers below, so every response
+ * (WAV from Opus or MP3, any rate) is analyzed where it is played. Each
+ * write is cut at analysis window boundaries (elisa_viseme.h); a slice
+ * is analyzed, then written, and a finished window's viseme is posted to
+ * the face when that window reaches the speaker, not when it is decoded.
+ *
+ * Play clock: bsp_i2s_write() returns once the slice is in the I2S DMA
+ * ring, which blocks the writer once the ring is full, so the player runs
+ * ahead of the speaker by up to the ring length (6 x 240 frames: 30 ms at
+ * 48 kHz, 60 ms at 24 kHz). The clock keeps when the last written sample
+ * will play, max(now, previous end) + slice duration, so it holds both at
+ * the start of a stream (empty ring) and in steady state (full ring). A
+ * window is due ELISA_LIPSYNC_LEAD_MS before its first sample plays, to
+ * cover the face's command drain and flush; due visemes are posted after
+ * each write, so posting is late by at most one write (one window).
+ */
+
+#ifndef ELISA_LIPSYNC_H
+#define ELISA_LIPSYNC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bsp_board.h"
+#include "elisa_viseme.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Post a window this long before it plays (face command drain + flush). */
+#define ELISA_LIPSYNC_LEAD_MS 20
+
+/**
+ * audio_player clk_set_fn: start a stream at this format, then set the
+ * codec. Streams that are not 16-bit, or slower than
+ * ELISA_VISEME_MIN_RATE, play without lip sync.
+ */
+esp_err_t elisa_lipsync_set_fs(uint32_t rate, uint32_t bits_cfg, i2s_slot_mode_t ch);
+
+/**
+ * audio_player write_fn: analyze and write to the codec in window-sized
+ * slices, posting the visemes that are due. Same contract as
+ * bsp_i2s_write(); bytes_written counts every slice written. A stream's
+ * first write records the turn's first_audio latency.
+ */
+esp_err_t elisa_lipsync_i2s_write(void *audio_buffer, size_t len, size_t *bytes_written,
+                                  uint32_t timeout_ms);
+
+/**
+ * End of playback (audio player task, from the play finish callback):
+ * post the windows still waiting in the DMA ring, each when it is due, so
+ * the mouth follows the last words too. Returns once the last window is
+ * posted, at most a DMA ring's length (60 ms at 24 kHz) later.
+ */
+void elisa_lipsync_finish(void);
+
+/**
+ * Playback position for pacing (captions): the stream number (counts
+ * streams since boot, 0 = none yet) and how far into it the speaker is.
+ * For analyzed streams that is the windows posted so far, so it follows
+ * the play clock; otherwise the time since the stream started.
+ */
+void elisa_lipsync_position(uint32_t *stream, uint32_t *position_ms);
+
+/**
+ * Lip sync counters since the previous elisa_lipsync_take_stats() call.
+ */
+typedef struct {
+    uint32_t windows;                      /**< Windows analyzed */
+    uint64_t analyze_us_total;             /**< Time spent analyzing */
+    uint32_t analyze_us_max;               /**< Slowest single slice's analysis */
+    uint32_t late;                         /**< Posted more than a window after due */
+    uint32_t visemes[ELISA_VISEME_COUNT];  /**< Windows per viseme */
+    int64_t interval_us;                   /**< Length of the interval */
+} elisa_lipsync_stats_t;
+
+/** Read and reset the interval counters. */
+void elisa_lipsync_take_stats(elisa_lipsync_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ELISA_LIPSYNC_H */
@@ -21,27 +21,28 @@
  * - esp_sr              -- Speech recognition (wake word)
  * - audio_player        -- Audio playback
  * - app_sr / app_audio  -- chatgpt_demo's audio pipeline
- * - settings            -- chatgpt_demo's sys_param for WiFi bridge
+ * - elisa_wifi          -- WiFi station with cached-AP fast reconnect
+ * - elisa_assets        -- Lazily mapped asset image (cached TTS, models)
  * - espressif__openai   -- OpenAI API wrapper (Whisper STT + TTS)
  */
 
+#include <stdatomic.h>
 #include <stdio.h>
 #include <string.h>
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/event_groups.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "esp_heap_caps.h"
 #include "nvs_flash.h"
-#include "esp_spiffs.h"
 
 /* BSP includes */
 #include "bsp/esp-bsp.h"
 #include "bsp_board.h"
 
 /* chatgpt_demo reused components */
-#include "settings.h"
-#include "app_wifi.h"
 #include "app_sr.h"
 #include "app_audio.h"
 #include "audio_player.h"
@@ -54,26 +55,46 @@
 #include "elisa_api.h"
 #include "elisa_face.h"
 #include "elisa_opus.h"
+#include "elisa_cancel.h"
+#include "elisa_trace.h"
+#include "elisa_telemetry.h"
+#include "elisa_latency.h"
+#include "elisa_wifi.h"
+#include "elisa_tasks.h"
+#include "elisa_wakenet.h"
+#include "elisa_capture.h"
+#include "elisa_lipsync.h"
+#include "elisa_caption.h"
+#include "elisa_assets.h"
 
 static const char *TAG = "elisa_main";
 
 // ── Forward Declarations ────────────────────────────────────────────────
 
 static void init_nvs(void);
-static void init_spiffs(void);
-static void init_wifi(const char *ssid, const char *password);
+static void start_wifi(void);
+static void wifi_connect_task(void *arg);
 static void init_audio(void);
 static void init_wake_word(const char *wake_word);
 static void conversation_loop(void);
+static void heartbeat_task(void *arg);
+static void config_update_cb(uint32_t changed, const elisa_runtime_config_t *config, void *arg);
 static void elisa_audio_play_finish_cb(void);
-static esp_err_t start_openai_direct(uint8_t *audio, int wav_len);
-static esp_err_t start_openai_runtime(uint8_t *audio, int wav_len);
+static void elisa_turn_cancel_cb(void);
+static void begin_playback(FILE *fp);
+static void end_turn(uint32_t result);
+static void play_asset(const char *name);
+static esp_err_t start_openai_direct(uint8_t *audio, int wav_len, elisa_cancel_token_t cancel);
+static esp_err_t start_openai_runtime(uint8_t *audio, int wav_len, elisa_cancel_token_t cancel);
 
 // ── Mode Flag ───────────────────────────────────────────────────────────
 
 /** True when running in direct API mode (no runtime required). */
 static bool s_direct_mode = false;
 
+/** True when LVGL draws into full-frame PSRAM buffers instead of partial bands. */
+static bool s_display_full_frame = false;
+
 // ── Direct Mode State ───────────────────────────────────────────────────
 
 /** OpenAI handle for Whisper STT and TTS (direct mode only). */
@@ -102,19 +123,41 @@ static char *s_pending_response_text = NULL;
 static uint8_t *s_pending_opus_wav = NULL;
 static size_t s_pending_opus_wav_len = 0;
 
+/** True while audio_player owns one of the pending buffers above. */
+static atomic_bool s_playback_active = false;
+
+/** True while audio_player plays a cached prompt from the asset image. */
+static atomic_bool s_asset_active = false;
+
+/** True from start_openai() until end_turn() closes the turn's stats. */
+static atomic_bool s_turn_open = false;
+
+// ── Boot State ──────────────────────────────────────────────────────────
+
+/** Set by wifi_connect_task once the station has an IP. */
+#define BOOT_WIFI_CONNECTED_BIT BIT0
+
+static EventGroupHandle_t s_boot_events = NULL;
+
+/** Log a boot milestone with the time since reset (esp_timer starts at boot). */
+static void boot_mark(const char *milestone) {
+    ESP_LOGI(TAG, "[boot] %s at %lld ms", milestone, (long long)(esp_timer_get_time() / 1000));
+}
+
 // ── Boot Sequence ───────────────────────────────────────────────────────
 
 void app_main(void) {
     ESP_LOGI(TAG, "=== Elisa Agent Firmware ===");
     ESP_LOGI(TAG, "Booting...");
 
+    /* Memory telemetry first, so the failed-alloc hook covers all of boot */
+    elisa_telemetry_init();
+
     /* Step 1: Initialize NVS (required for WiFi) */
     init_nvs();
 
-    /* Step 2: Initialize SPIFFS (for runtime_config.json) */
-    init_spiffs();
-
-    /* Step 3: Load runtime configuration */
+    /* Step 2: Load runtime configuration: the config image mapped from
+     * flash, or runtime_config.json (SPIFFS is only mounted for that). */
     if (elisa_load_config() != 0) {
         ESP_LOGE(TAG, "Failed to load runtime config -- halting");
         while (1) { vTaskDelay(pdMS_TO_TICKS(1000)); }
@@ -125,18 +168,37 @@ void app_main(void) {
 
     /* Determine mode */
     s_direct_mode = (strlen(config->openai_api_key) > 0 && strlen(config->anthropic_api_key) > 0);
+    boot_mark("config loaded");
+
+    /* Step 3: Start WiFi association in the background. It takes 1-4 s
+     * (up to the 15 s timeout on a bad AP) and nothing below needs the
+     * network, so display, audio and wake word init overlap with it. */
+    s_boot_events = xEventGroupCreate();
+    start_wifi();
 
     /* Step 4: Initialize display + face renderer.
-     * Use chatgpt_demo's display init pattern with DMA buffer config.
+     * Two draw buffers so LVGL renders into one while the SPI DMA flushes
+     * the other: partial bands in internal DMA RAM by default, or full
+     * frames in PSRAM ("display_buffer": "psram_full").
      * Skip ui_ctrl_init() -- Elisa uses elisa_face instead. */
+    s_display_full_frame = (config->display_buffer == ELISA_DISPLAY_BUFFER_PSRAM_FULL);
     bsp_display_cfg_t cfg = {
         .lvgl_port_cfg = ESP_LVGL_PORT_INIT_CONFIG(),
-        .buffer_size = BSP_LCD_H_RES * CONFIG_BSP_LCD_DRAW_BUF_HEIGHT,
-        .double_buffer = 0,
+        .buffer_size = s_display_full_frame ? BSP_LCD_H_RES * BSP_LCD_V_RES
+                                            : BSP_LCD_H_RES * CONFIG_BSP_LCD_DRAW_BUF_HEIGHT,
+        .double_buffer = 1,
         .flags = {
-            .buff_dma = true,
+            .buff_dma = !s_display_full_frame,
+            .buff_spiram = s_display_full_frame,
         },
     };
+    ESP_LOGI(TAG, "Display: 2 x %u px %s buffers", (unsigned)cfg.buffer_size,
+             s_display_full_frame ? "PSRAM full-frame" : "internal DMA partial");
+    /* LVGL task placement comes from the task plan (elisa_tasks.c) */
+    const elisa_task_spec_t *lvgl_task = elisa_task_spec(ELISA_TASK_LVGL);
+    cfg.lvgl_port_cfg.task_priority = lvgl_task->priority;
+    cfg.lvgl_port_cfg.task_stack = lvgl_task->stack_bytes;
+    cfg.lvgl_port_cfg.task_affinity = lvgl_task->core;
     bsp_display_start_with_config(&cfg);
     bsp_board_init();
     bsp_display_backlight_on();
@@ -144,13 +206,17 @@ void app_main(void) {
     const face_descriptor_t *face = elisa_get_face_descriptor();
     elisa_face_init(face);
     elisa_face_set_state(FACE_STATE_IDLE);
+    if (elisa_caption_init() != 0) {
+        ESP_LOGW(TAG, "Captions unavailable");
+    }
+    boot_mark("display ready");
 
-    /* Step 5: Connect to WiFi */
-    ESP_LOGI(TAG, "Connecting to WiFi: %s", config->wifi_ssid);
-    elisa_face_set_state(FACE_STATE_THINKING); /* Show "connecting" animation */
-    init_wifi(config->wifi_ssid, config->wifi_password);
+    /* Live config updates arrive with heartbeat responses (runtime mode) */
+    elisa_config_subscribe(ELISA_CONFIG_CHANGED_FACE | ELISA_CONFIG_CHANGED_WAKE,
+                           config_update_cb, NULL);
 
-    /* Step 6: Initialize API clients based on mode */
+    /* Step 5: Initialize API clients based on mode. Neither touches the
+     * network here: handles and URLs only. */
     if (s_direct_mode) {
         ESP_LOGI(TAG, "Direct API mode -- no runtime required");
 
@@ -161,32 +227,30 @@ void app_main(void) {
 
         s_tts = s_openai->audioSpeechCreate(s_openai);
         s_tts->setModel(s_tts, "tts-1");
-        s_tts->setVoice(s_tts, config->tts_voice);
+        s_tts->setVoice(s_tts, elisa_config_voice_name(config->tts_voice));
         s_tts->setResponseFormat(s_tts, OPENAI_AUDIO_OUTPUT_FORMAT_MP3);
         s_tts->setSpeed(s_tts, 1.0);
 
         /* Initialize Claude API */
         elisa_claude_init(config->anthropic_api_key, config->system_prompt);
     } else {
-        ESP_LOGI(TAG, "Runtime mode -- connecting to %s", config->runtime_url);
+        ESP_LOGI(TAG, "Runtime mode -- runtime at %s", config->runtime_url);
         elisa_api_init(config);
 
-        elisa_heartbeat_t hb;
-        if (elisa_api_heartbeat(&hb) == 0 && hb.healthy) {
-            ESP_LOGI(TAG, "Runtime is reachable");
-        } else {
-            ESP_LOGW(TAG, "Runtime not reachable -- will retry in conversation loop");
-        }
+        /* Reachability check and periodic reports wait for WiFi there */
+        elisa_task_create(ELISA_TASK_HEARTBEAT, heartbeat_task, NULL, NULL);
     }
 
-    /* Step 7: Initialize audio hardware + wake word engine */
+    /* Step 6: Initialize audio hardware + wake word engine */
     init_audio();
     init_wake_word(config->wake_word);
+    elisa_wakenet_set_threshold(config->wake_cutoff_pct);
 
     elisa_face_set_state(FACE_STATE_IDLE);
+    boot_mark("ready (listening for wake word)");
     ESP_LOGI(TAG, "Ready! Say \"%s\" to start.", config->wake_word);
 
-    /* Step 8: Enter main conversation loop.
+    /* Step 7: Enter main conversation loop.
      * Actual conversation is driven by sr_handler_task calling start_openai().
      * This loop is just a periodic heartbeat logger. */
     conversation_loop();
@@ -204,39 +268,43 @@ static void init_nvs(void) {
     ESP_LOGI(TAG, "NVS initialized");
 }
 
-static void init_spiffs(void) {
-    esp_vfs_spiffs_conf_t conf = {
-        .base_path = "/spiffs",
-        .partition_label = NULL,
-        .max_files = 5,
-        .format_if_mount_failed = false,
-    };
-    ESP_ERROR_CHECK(esp_vfs_spiffs_register(&conf));
-    ESP_LOGI(TAG, "SPIFFS mounted");
+static void start_wifi(void) {
+    elisa_task_create(ELISA_TASK_WIFI_CONNECT, wifi_connect_task, NULL, NULL);
 }
 
-static void init_wifi(const char *ssid, const char *password) {
-    ESP_LOGI(TAG, "WiFi connecting to %s...", ssid);
-
-    /* Bridge: write our credentials into chatgpt_demo's sys_param struct
-     * so app_network_start() picks them up via the existing WiFi stack.
-     * This reuses the entire chatgpt_demo WiFi init (including the
-     * wifi_connected flag that app_audio.c checks). */
-    sys_param_t *param = settings_get_parameter();
-    strncpy(param->ssid, ssid, sizeof(param->ssid) - 1);
-    strncpy(param->password, password, sizeof(param->password) - 1);
+/**
+ * Starts the WiFi station (elisa_wifi.c: directed connect to the cached
+ * AP, full scan fallback) and waits for an IP, then sets
+ * BOOT_WIFI_CONNECTED_BIT. Runs alongside display/audio/wake word init.
+ * Reconnects after a dropout are handled inside elisa_wifi.c; turns during
+ * an outage fail fast on app_audio.c's wifi_connected_already() check.
+ */
+static void wifi_connect_task(void *arg) {
+    (void)arg;
+    const elisa_runtime_config_t *config = elisa_get_config();
 
-    app_network_start();
+    elisa_wifi_static_ip_t static_ip;
+    memset(&static_ip, 0, sizeof(static_ip));
+    strncpy(static_ip.ip, config->wifi_static_ip, sizeof(static_ip.ip) - 1);
+    strncpy(static_ip.gateway, config->wifi_gateway, sizeof(static_ip.gateway) - 1);
+    strncpy(static_ip.netmask, config->wifi_netmask, sizeof(static_ip.netmask) - 1);
+    strncpy(static_ip.dns, config->wifi_dns, sizeof(static_ip.dns) - 1);
+
+    ESP_LOGI(TAG, "WiFi connecting to %s...", config->wifi_ssid);
+    if (elisa_wifi_start(config->wifi_ssid, config->wifi_password, &static_ip) != 0) {
+        ESP_LOGE(TAG, "WiFi stack failed to start");
+        vTaskDelete(NULL);
+        return;
+    }
 
-    /* Poll for connection (up to 15s) */
-    for (int i = 0; i < 150; i++) {
-        if (WIFI_STATUS_CONNECTED_OK == wifi_connected_already()) {
-            ESP_LOGI(TAG, "WiFi connected");
-            return;
-        }
-        vTaskDelay(pdMS_TO_TICKS(100));
+    if (!elisa_wifi_wait_connected(15000)) {
+        ESP_LOGW(TAG, "WiFi not connected after 15 s -- still retrying");
+        elisa_wifi_wait_connected(UINT32_MAX);
     }
-    ESP_LOGW(TAG, "WiFi connection timeout -- will retry");
+
+    boot_mark("WiFi connected");
+    xEventGroupSetBits(s_boot_events, BOOT_WIFI_CONNECTED_BIT);
+    vTaskDelete(NULL);
 }
 
 static void init_audio(void) {
@@ -248,6 +316,7 @@ static void init_audio(void) {
 static void init_wake_word(const char *wake_word) {
     app_sr_start(false);
     audio_register_play_finish_cb(elisa_audio_play_finish_cb);
+    elisa_turn_register_cancel_cb(elisa_turn_cancel_cb);
     ESP_LOGI(TAG, "Wake word engine initialized: %s", wake_word);
     (void)wake_word; /* Display-only; actual wake word is from SR model in flash */
 }
@@ -325,11 +394,46 @@ esp_err_t start_openai(uint8_t *audio, int audio_len) {
         }
     }
 
+    /* New turn: anything still running from the previous one was already
+     * cancelled by the wake word that led here. */
+    elisa_cancel_token_t cancel = elisa_turn_begin();
+
+    /* Back-date the capture from the WAV length (16 kHz mono 16-bit) */
+    int64_t now_us = esp_timer_get_time();
+    int64_t record_us = (int64_t)(wav_len > 44 ? wav_len - 44 : 0) * 1000000 / (16000 * 2);
+    elisa_trace_turn_begin((uint32_t)wav_len);
+    elisa_mem_turn_begin();
+    atomic_store(&s_turn_open, true);
+    elisa_latency_turn_begin(now_us - record_us);
+    elisa_trace_at(TRACE_RECORD, TRACE_PH_BEGIN, now_us - record_us, (uint32_t)wav_len);
+    elisa_trace_at(TRACE_RECORD, TRACE_PH_END, now_us, (uint32_t)wav_len);
+
+    esp_err_t ret;
     if (s_direct_mode) {
-        return start_openai_direct(audio, wav_len);
+        ret = start_openai_direct(audio, wav_len, cancel);
     } else {
-        return start_openai_runtime(audio, wav_len);
+        ret = start_openai_runtime(audio, wav_len, cancel);
+    }
+
+    /* A successful turn ends when playback finishes (elisa_audio_play_finish_cb),
+     * which may already have happened for a short clip */
+    if (!atomic_load(&s_playback_active)) {
+        end_turn((uint32_t)ret);
+    }
+    return ret;
+}
+
+/**
+ * Close the turn's trace and memory stats. start_openai() and the playback
+ * finish callback run on different tasks and may both get here for the
+ * same turn; only the first one counts it.
+ */
+static void end_turn(uint32_t result) {
+    if (!atomic_exchange(&s_turn_open, false)) {
+        return;
     }
+    elisa_trace(TRACE_TURN, TRACE_PH_END, result);
+    elisa_mem_turn_end();
 }
 
 // ── Direct API Mode ─────────────────────────────────────────────────────
@@ -337,7 +441,7 @@ esp_err_t start_openai(uint8_t *audio, int audio_len) {
 // Three direct API calls: OpenAI Whisper STT -> Claude -> OpenAI TTS.
 // No runtime/laptop required.
 
-static esp_err_t start_openai_direct(uint8_t *audio, int wav_len) {
+static esp_err_t start_openai_direct(uint8_t *audio, int wav_len, elisa_cancel_token_t cancel) {
     ESP_LOGI(TAG, "[Direct] Processing WAV (%d bytes)", wav_len);
 
     /* Step 1: Whisper STT */
@@ -354,6 +458,14 @@ static esp_err_t start_openai_direct(uint8_t *audio, int wav_len) {
     }
     ESP_LOGI(TAG, "[Direct] Whisper: %s", transcript);
 
+    /* The OpenAI component calls block without a cancel hook, so the direct
+     * path can only stop between stages and during playback. */
+    if (elisa_turn_cancelled(cancel)) {
+        free(transcript);
+        elisa_face_set_state(FACE_STATE_IDLE);
+        return ESP_FAIL;
+    }
+
     /* Step 2: Claude Messages API */
     char *response_text = NULL;
     int ret = elisa_claude_chat(transcript, &response_text);
@@ -368,6 +480,13 @@ static esp_err_t start_openai_direct(uint8_t *audio, int wav_len) {
         return ESP_FAIL;
     }
     ESP_LOGI(TAG, "[Direct] Claude: %s", response_text);
+    elisa_caption_set_text(response_text);
+
+    if (elisa_turn_cancelled(cancel)) {
+        free(response_text);
+        elisa_face_set_state(FACE_STATE_IDLE);
+        return ESP_FAIL;
+    }
 
     /* Step 3: OpenAI TTS */
     elisa_face_set_state(FACE_STATE_SPEAKING);
@@ -392,9 +511,19 @@ static esp_err_t start_openai_direct(uint8_t *audio, int wav_len) {
     s_pending_tts_len = tts_len;
     s_pending_response_text = response_text;
 
-    FILE *fp = fmemopen(s_pending_tts_data, s_pending_tts_len, "rb");
+    FILE *fp = NULL;
+    if (!elisa_turn_cancelled(cancel)) {
+        fp = fmemopen(s_pending_tts_data, s_pending_tts_len, "rb");
+    }
     if (fp != NULL) {
-        audio_player_play(fp);
+        elisa_caption_play(0);
+        begin_playback(fp);
+    } else if (elisa_turn_cancelled(cancel)) {
+        elisa_face_set_state(FACE_STATE_IDLE);
+        free(s_pending_tts_data);
+        s_pending_tts_data = NULL;
+        free(s_pending_response_text);
+        s_pending_response_text = NULL;
     } else {
         ESP_LOGE(TAG, "fmemopen failed");
         elisa_face_set_state(FACE_STATE_ERROR);
@@ -416,16 +545,17 @@ static esp_err_t start_openai_direct(uint8_t *audio, int wav_len) {
 //
 // Single API call to Elisa runtime (POST /v1/agents/:id/turn/audio).
 
-static esp_err_t start_openai_runtime(uint8_t *audio, int wav_len) {
+static esp_err_t start_openai_runtime(uint8_t *audio, int wav_len, elisa_cancel_token_t cancel) {
     ESP_LOGI(TAG, "[Runtime] Sending WAV (%d bytes) to runtime", wav_len);
 
     elisa_face_set_state(FACE_STATE_THINKING);
 
     elisa_turn_response_t response;
-    int ret = elisa_api_audio_turn(audio, (size_t)wav_len, &response);
+    int ret = elisa_api_audio_turn(audio, (size_t)wav_len, &response, cancel);
 
     if (ret == 0 && response.audio_data != NULL) {
         ESP_LOGI(TAG, "Response: %s", response.text ? response.text : "(no text)");
+        elisa_caption_set_text(response.text ? response.text : "");
         ESP_LOGI(TAG, "Response format=%s, %zu bytes", response.audio_format, response.audio_len);
 
         elisa_face_set_state(FACE_STATE_SPEAKING);
@@ -437,10 +567,14 @@ static esp_err_t start_openai_runtime(uint8_t *audio, int wav_len) {
             uint32_t sample_rate = 0;
 
             ret = elisa_opus_decode(response.audio_data, response.audio_len,
-                                   &pcm_data, &pcm_samples, &sample_rate);
+                                   &pcm_data, &pcm_samples, &sample_rate, cancel);
             /* Free the original Opus data -- we have PCM now */
             elisa_api_free_response(&response);
 
+            if (ret == ELISA_CANCELLED) {
+                elisa_face_set_state(FACE_STATE_IDLE);
+                return ESP_FAIL;
+            }
             if (ret != 0 || pcm_data == NULL) {
                 ESP_LOGE(TAG, "Opus decode failed");
                 elisa_face_set_state(FACE_STATE_ERROR);
@@ -470,9 +604,18 @@ static esp_err_t start_openai_runtime(uint8_t *audio, int wav_len) {
             s_pending_opus_wav = wav_data;
             s_pending_opus_wav_len = wav_data_len;
 
-            FILE *fp = fmemopen(s_pending_opus_wav, s_pending_opus_wav_len, "rb");
+            FILE *fp = NULL;
+            if (!elisa_turn_cancelled(cancel)) {
+                fp = fmemopen(s_pending_opus_wav, s_pending_opus_wav_len, "rb");
+            }
             if (fp != NULL) {
-                audio_player_play(fp);
+                elisa_caption_play(sample_rate
+                    ? (uint32_t)((uint64_t)pcm_samples * 1000 / sample_rate) : 0);
+                begin_playback(fp);
+            } else if (elisa_turn_cancelled(cancel)) {
+                elisa_face_set_state(FACE_STATE_IDLE);
+                heap_caps_free(s_pending_opus_wav);
+                s_pending_opus_wav = NULL;
             } else {
                 ESP_LOGE(TAG, "fmemopen failed");
                 elisa_face_set_state(FACE_STATE_ERROR);
@@ -485,10 +628,18 @@ static esp_err_t start_openai_runtime(uint8_t *audio, int wav_len) {
             /* MP3 path (legacy): play directly via audio_player */
             s_pending_audio_response = response;
 
-            FILE *fp = fmemopen(s_pending_audio_response.audio_data,
-                                s_pending_audio_response.audio_len, "rb");
+            FILE *fp = NULL;
+            if (!elisa_turn_cancelled(cancel)) {
+                fp = fmemopen(s_pending_audio_response.audio_data,
+                              s_pending_audio_response.audio_len, "rb");
+            }
             if (fp != NULL) {
-                audio_player_play(fp);
+                /* MP3 length is unknown before decoding: paced by speaking rate */
+                elisa_caption_play(0);
+                begin_playback(fp);
+            } else if (elisa_turn_cancelled(cancel)) {
+                elisa_face_set_state(FACE_STATE_IDLE);
+                elisa_api_free_response(&s_pending_audio_response);
             } else {
                 ESP_LOGE(TAG, "fmemopen failed");
                 elisa_face_set_state(FACE_STATE_ERROR);
@@ -497,9 +648,16 @@ static esp_err_t start_openai_runtime(uint8_t *audio, int wav_len) {
                 elisa_api_free_response(&s_pending_audio_response);
             }
         }
+    } else if (ret == ELISA_CANCELLED) {
+        /* Superseded by a new wake word or a touch -- not an error */
+        elisa_face_set_state(FACE_STATE_IDLE);
+        elisa_api_free_response(&response);
+        return ESP_FAIL;
     } else {
         ESP_LOGE(TAG, "Audio turn failed (status=%d)", response.status_code);
         elisa_face_set_state(FACE_STATE_ERROR);
+        /* No reply to speak: say so with the prompt cached at deploy */
+        play_asset(ELISA_ASSET_TTS_TURN_FAILED);
         vTaskDelay(pdMS_TO_TICKS(2000));
         elisa_face_set_state(FACE_STATE_IDLE);
         elisa_api_free_response(&response);
@@ -509,9 +667,56 @@ static esp_err_t start_openai_runtime(uint8_t *audio, int wav_len) {
     return ESP_OK;
 }
 
+// ── Playback ────────────────────────────────────────────────────────────
+
+/** Hand a pending buffer to audio_player. It stays owned until the finish callback. */
+static void begin_playback(FILE *fp) {
+    atomic_store(&s_playback_active, true);
+    elisa_mem_sample(MEM_STAGE_PLAYBACK);
+    elisa_trace(TRACE_PLAYBACK, TRACE_PH_BEGIN, 0);
+    audio_player_play(fp);
+}
+
+/**
+ * Play a cached prompt or earcon in place from the asset image. Not a
+ * turn: the image owns the data, so the finish callback only returns the
+ * face to idle (finish_asset()).
+ */
+static void play_asset(const char *name) {
+    elisa_asset_t asset;
+    if (elisa_assets_find(name, &asset) != 0) {
+        return;
+    }
+    FILE *fp = fmemopen((void *)asset.data, asset.size, "rb");
+    if (fp != NULL) {
+        /* The prompt is not the turn's reply: keep it out of first_audio */
+        elisa_latency_skip(LAT_FIRST_AUDIO);
+        atomic_store(&s_asset_active, true);
+        audio_player_play(fp);
+    }
+}
+
 // ── Playback Complete Callback ──────────────────────────────────────────
 
+/** A cached prompt ended: nothing to free, and its turn is already closed. */
+static void finish_asset(void) {
+    elisa_face_set_state(FACE_STATE_IDLE);
+}
+
 static void elisa_audio_play_finish_cb(void) {
+    /* The last visemes are still queued behind audio in the DMA ring */
+    elisa_lipsync_finish();
+
+    if (atomic_exchange(&s_asset_active, false)) {
+        finish_asset();
+        return;
+    }
+
+    bool turn_finished = atomic_exchange(&s_playback_active, false);
+    if (turn_finished) {
+        elisa_trace(TRACE_PLAYBACK, TRACE_PH_END, 0);
+        elisa_caption_finish();
+    }
     elisa_face_set_state(FACE_STATE_IDLE);
 
     if (s_direct_mode) {
@@ -536,21 +741,167 @@ static void elisa_audio_play_finish_cb(void) {
             s_pending_opus_wav_len = 0;
         }
     }
+
+    /* Sample after the turn's buffers are released */
+    if (turn_finished) {
+        end_turn(0);
+    }
+}
+
+// ── Turn Cancellation ───────────────────────────────────────────────────
+//
+// Registered with elisa_turn_register_cancel_cb(). HTTP and decode poll
+// their token; playback can't, so stop the player here. audio_player_stop()
+// ends in the normal finish callback, which frees the pending buffers (or,
+// for a failed turn's cached prompt, only returns the face to idle).
+
+static void elisa_turn_cancel_cb(void) {
+    elisa_caption_clear();
+    if (atomic_load(&s_playback_active)) {
+        ESP_LOGI(TAG, "Stopping playback of cancelled turn");
+        audio_player_stop();
+    } else if (atomic_load(&s_asset_active)) {
+        ESP_LOGI(TAG, "Stopping cached prompt of cancelled turn");
+        audio_player_stop();
+    }
 }
 
 // ── Recording Mode ──────────────────────────────────────────────────────
 //
-// When the device receives "RECORD\n" on UART, it streams raw 16-bit LE
-// PCM at 16kHz to the serial port until it receives "STOP\n".
-// Used by wake-word-training/record.py to capture training samples
-// through the BOX-3's actual microphones.
+// When the device receives "RECORD\n" on UART, it streams 16kHz audio to
+// the serial port in CRC-checked, losslessly compressed frames
+// (elisa_capture.c) until it receives "STOP\n" ("RECORD PCM\n" sends
+// uncompressed 16-bit LE PCM instead). Used by wake-word-training/record.py
+// to capture training samples through the BOX-3's actual microphones.
+//
+// "TRACE\n" dumps the turn latency trace ring as Chrome trace JSON
+// between TRACE_BEGIN / TRACE_END marker lines. "MEM\n" prints heap and
+// PSRAM watermark telemetry as "MEM key=value" lines. "TASKS\n" prints the
+// task plan report (elisa_tasks.c). "STATS\n" prints the soak-test
+// snapshot below.
 
-static volatile bool s_recording = false;
+#define STATS_MAX_TASKS 48
 
 /**
- * UART command listener task. Checks for RECORD/STOP commands.
+ * One STATS snapshot: a STATS_BEGIN line, then one "STATS <kind> key=value"
+ * line per task, per core, for the wake word, the audio buffers, lip sync
+ * and the face, then STATS_END. Rates and CPU shares cover the interval since the
+ * previous STATS (or TASKS) command, so a soak script just polls it.
+ * Keys are only ever added, never renamed.
+ */
+static void print_stats(FILE *out) {
+    int64_t now_us = esp_timer_get_time();
+    fprintf(out, "STATS_BEGIN uptime_ms=%lld\n", (long long)(now_us / 1000));
+
+    elisa_task_stats_t *tasks = heap_caps_malloc(STATS_MAX_TASKS * sizeof(elisa_task_stats_t),
+                                                 MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    uint32_t core_load[2] = {0, 0};
+    int n = tasks ? elisa_tasks_snapshot(tasks, STATS_MAX_TASKS, core_load) : -1;
+    for (int i = 0; i < n; i++) {
+        const elisa_task_stats_t *t = &tasks[i];
+        fprintf(out, "STATS task name=%s core=%d prio=%u cpu_pct=%lu.%lu stack_free_min=%lu\n",
+                t->name, (t->core == tskNO_AFFINITY) ? -1 : (int)t->core, (unsigned)t->priority,
+                (unsigned long)(t->cpu_permille / 10), (unsigned long)(t->cpu_permille % 10),
+                (unsigned long)t->stack_free_min);
+    }
+    if (n >= 0) {
+        for (int c = 0; c < 2; c++) {
+            fprintf(out, "STATS cpu core=%d load_pct=%lu.%lu\n", c,
+                    (unsigned long)(core_load[c] / 10), (unsigned long)(core_load[c] % 10));
+        }
+    } else {
+        fprintf(out, "STATS task error=runtime_stats_unavailable\n");
+    }
+    free(tasks);
+
+    elisa_wakenet_stats_t ww;
+    elisa_wakenet_take_stats(&ww);
+    uint32_t per_s_x10 = (ww.interval_us > 0)
+        ? (uint32_t)(((uint64_t)ww.frames * 10000000ULL) / (uint64_t)ww.interval_us) : 0;
+    uint32_t avg_us = ww.frames ? (uint32_t)(ww.fetch_us_total / ww.frames) : 0;
+    fprintf(out, "STATS wake_word engine=wakenet frames=%lu frames_per_s=%lu.%lu "
+                 "fetch_avg_us=%lu fetch_max_us=%lu detections=%lu threshold_pct=%u "
+                 "interval_ms=%lld\n",
+            (unsigned long)ww.frames, (unsigned long)(per_s_x10 / 10),
+            (unsigned long)(per_s_x10 % 10), (unsigned long)avg_us,
+            (unsigned long)ww.fetch_us_max, (unsigned long)ww.detections,
+            (unsigned)ww.threshold_pct, (long long)(ww.interval_us / 1000));
+
+    /* Playback: response audio handed to audio_player for this turn */
+    size_t playback_bytes = 0;
+    if (s_pending_opus_wav) {
+        playback_bytes = s_pending_opus_wav_len;
+    } else if (s_pending_tts_data) {
+        playback_bytes = s_pending_tts_len;
+    } else if (s_pending_audio_response.audio_data) {
+        playback_bytes = s_pending_audio_response.audio_len;
+    }
+    elisa_capture_stats_t cap;
+    elisa_capture_get_stats(&cap);
+    fprintf(out, "STATS audio playback_active=%d playback_bytes=%lu recording=%d "
+                 "capture_ring_samples=%lu capture_ring_capacity=%u capture_ring_high_water=%lu "
+                 "capture_dropped=%lu capture_samples=%lu capture_bytes=%lu\n",
+            atomic_load(&s_playback_active) ? 1 : 0, (unsigned long)playback_bytes,
+            cap.active ? 1 : 0, (unsigned long)cap.ring_fill,
+            (unsigned)ELISA_CAPTURE_RING_SAMPLES, (unsigned long)cap.ring_high_water,
+            (unsigned long)cap.samples_dropped, (unsigned long)cap.samples_sent,
+            (unsigned long)cap.audio_bytes_sent);
+
+    fprintf(out, "STATS display buffer=%s double=1 buffer_px=%u\n",
+            s_display_full_frame ? "psram_full" : "partial",
+            (unsigned)(s_display_full_frame ? BSP_LCD_H_RES * BSP_LCD_V_RES
+                                            : BSP_LCD_H_RES * CONFIG_BSP_LCD_DRAW_BUF_HEIGHT));
+
+    elisa_lipsync_stats_t ls;
+    elisa_lipsync_take_stats(&ls);
+    uint32_t analyze_avg_us = ls.windows ? (uint32_t)(ls.analyze_us_total / ls.windows) : 0;
+    fprintf(out, "STATS lipsync windows=%lu analyze_avg_us=%lu analyze_max_us=%lu late=%lu",
+            (unsigned long)ls.windows, (unsigned long)analyze_avg_us,
+            (unsigned long)ls.analyze_us_max, (unsigned long)ls.late);
+    for (int v = 0; v < ELISA_VISEME_COUNT; v++) {
+        fprintf(out, " %s=%lu", elisa_viseme_name((elisa_viseme_t)v),
+                (unsigned long)ls.visemes[v]);
+    }
+    fprintf(out, " interval_ms=%lld\n", (long long)(ls.interval_us / 1000));
+
+    elisa_caption_stats_t cs;
+    elisa_caption_take_stats(&cs);
+    uint32_t caption_avg_us = cs.updates ? (uint32_t)(cs.update_us_total / cs.updates) : 0;
+    fprintf(out, "STATS caption updates=%lu update_avg_us=%lu update_max_us=%lu drawn_px=%lu "
+                 "scrolls=%lu cache_bytes=%lu\n",
+            (unsigned long)cs.updates, (unsigned long)caption_avg_us,
+            (unsigned long)cs.update_us_max, (unsigned long)cs.drawn_px,
+            (unsigned long)cs.scrolls, (unsigned long)cs.cache_bytes);
+
+    elisa_face_stats_t fs;
+    elisa_face_take_stats(&fs);
+    uint32_t face_avg_us = fs.ticks ? (uint32_t)(fs.tick_us_total / fs.ticks) : 0;
+    uint32_t blit_px_per_s = (fs.interval_us > 0)
+        ? (uint32_t)(((uint64_t)fs.blit_px * 1000000ULL) / (uint64_t)fs.interval_us) : 0;
+    fprintf(out, "STATS face state=%s ticks=%lu tick_avg_us=%lu tick_max_us=%lu "
+                 "blit_px_per_s=%lu atlas_bytes=%lu commands=%lu commands_dropped=%lu\n",
+            elisa_face_state_name(elisa_face_get_state()), (unsigned long)fs.ticks,
+            (unsigned long)face_avg_us, (unsigned long)fs.tick_us_max,
+            (unsigned long)blit_px_per_s, (unsigned long)fs.atlas_bytes,
+            (unsigned long)fs.commands, (unsigned long)fs.commands_dropped);
+    for (int i = 0; i < ELISA_FACE_STATE_COUNT; i++) {
+        const elisa_face_state_stats_t *st = &fs.state[i];
+        uint32_t px_per_s = (st->time_us > 0)
+            ? (uint32_t)(((uint64_t)st->flushed_px * 1000000ULL) / (uint64_t)st->time_us) : 0;
+        fprintf(out, "STATS face_state state=%s time_ms=%lu flushes=%lu flushed_px=%lu "
+                     "flushed_px_per_s=%lu render_ms=%lu\n",
+                elisa_face_state_name((face_state_t)i), (unsigned long)(st->time_us / 1000),
+                (unsigned long)st->flushes, (unsigned long)st->flushed_px,
+                (unsigned long)px_per_s, (unsigned long)st->render_ms);
+    }
+    fprintf(out, "STATS_END\n");
+}
+
+/**
+ * UART command listener task. Checks for RECORD/STOP/TRACE/MEM/TASKS/STATS commands.
  */
 static void uart_cmd_task(void *arg) {
+    (void)arg;
     char line_buf[32];
     int line_len = 0;
 
@@ -563,11 +914,28 @@ static void uart_cmd_task(void *arg) {
         if (ch == '\n' || ch == '\r') {
             line_buf[line_len] = '\0';
             if (strcmp(line_buf, "RECORD") == 0) {
-                ESP_LOGI(TAG, "Recording mode: ON");
-                s_recording = true;
+                ESP_LOGI(TAG, "Recording mode: ON (compressed)");
+                elisa_capture_start(ELISA_CAPTURE_RICE);
+            } else if (strcmp(line_buf, "RECORD PCM") == 0) {
+                ESP_LOGI(TAG, "Recording mode: ON (raw PCM)");
+                elisa_capture_start(ELISA_CAPTURE_PCM16);
             } else if (strcmp(line_buf, "STOP") == 0) {
+                elisa_capture_stop();
                 ESP_LOGI(TAG, "Recording mode: OFF");
-                s_recording = false;
+            } else if (strcmp(line_buf, "TRACE") == 0) {
+                printf("TRACE_BEGIN\n");
+                elisa_trace_dump(stdout);
+                printf("TRACE_END\n");
+                fflush(stdout);
+            } else if (strcmp(line_buf, "MEM") == 0) {
+                elisa_mem_print_report(stdout);
+                fflush(stdout);
+            } else if (strcmp(line_buf, "TASKS") == 0) {
+                elisa_tasks_print_report(stdout);
+                fflush(stdout);
+            } else if (strcmp(line_buf, "STATS") == 0) {
+                print_stats(stdout);
+                fflush(stdout);
             }
             line_len = 0;
         } else if (line_len < (int)sizeof(line_buf) - 1) {
@@ -576,18 +944,52 @@ static void uart_cmd_task(void *arg) {
     }
 }
 
-/**
- * Audio recording callback. When s_recording is true, writes raw PCM
- * samples to stdout (UART) for capture by record.py.
- *
- * Called from the I2S audio pipeline in app_audio.c context.
- * The record.py script reads these bytes over serial.
- */
-void elisa_recording_feed(const int16_t *samples, size_t count) {
-    if (!s_recording) return;
-    /* Write raw 16-bit LE PCM directly to UART stdout */
-    fwrite(samples, sizeof(int16_t), count, stdout);
-    fflush(stdout);
+// ── Live Config ─────────────────────────────────────────────────────────
+//
+// Called on the heartbeat task once a config update from the runtime is
+// active (elisa_config_apply_update).
+
+static void config_update_cb(uint32_t changed, const elisa_runtime_config_t *config, void *arg) {
+    (void)arg;
+    if (changed & ELISA_CONFIG_CHANGED_FACE) {
+        elisa_face_set_descriptor(elisa_get_face_descriptor());
+    }
+    if (changed & ELISA_CONFIG_CHANGED_WAKE) {
+        elisa_wakenet_set_threshold(config->wake_cutoff_pct);
+    }
+}
+
+// ── Heartbeat Reporting ─────────────────────────────────────────────────
+//
+// Runtime mode only, started from app_main(). Once WiFi is up it checks the
+// runtime is reachable, then every ELISA_HEARTBEAT_INTERVAL_MS the latency
+// histograms and memory telemetry are POSTed to the runtime, which merges
+// them into per-agent percentiles. Runs at low priority so a slow or
+// unreachable runtime never delays a turn.
+
+#define ELISA_HEARTBEAT_INTERVAL_MS 60000
+
+static void heartbeat_task(void *arg) {
+    (void)arg;
+    /* Boot-time reachability check, deferred until WiFi is up */
+    xEventGroupWaitBits(s_boot_events, BOOT_WIFI_CONNECTED_BIT, pdFALSE, pdTRUE, portMAX_DELAY);
+
+    elisa_heartbeat_t hb;
+    if (elisa_api_heartbeat(&hb) == 0 && hb.healthy) {
+        boot_mark("runtime reachable");
+    } else {
+        ESP_LOGW(TAG, "Runtime not reachable -- will retry with the next report");
+    }
+
+    while (1) {
+        vTaskDelay(pdMS_TO_TICKS(ELISA_HEARTBEAT_INTERVAL_MS));
+
+        if (elisa_api_report_heartbeat(&hb) != 0) {
+            ESP_LOGW(TAG, "Heartbeat report got no response");
+        } else if (!hb.healthy) {
+            ESP_LOGW(TAG, "Heartbeat report not accepted (status=%d)", hb.status_code);
+        }
+    }
 }
 
 // ── Main Conversation Loop ──────────────────────────────────────────────
@@ -600,7 +1002,8 @@ static void conversation_loop(void) {
     ESP_LOGI(TAG, "Entering conversation loop (audio pipeline active)");
 
     /* Start UART command listener for recording mode */
-    xTaskCreate(uart_cmd_task, "uart_cmd", 2048, NULL, 5, NULL);
+    elisa_capture_init();
+    elisa_task_create(ELISA_TASK_UART_CMD, uart_cmd_task, NULL, NULL);
 
     while (1) {
         ESP_LOGD(TAG, "Heartbeat -- face state: %d", elisa_face_get_state());
@@ -14,12 +14,16 @@
  */
 
 #include "elisa_opus.h"
+#include "elisa_trace.h"
+#include "elisa_telemetry.h"
+#include "elisa_latency.h"
 
 #include <stdlib.h>
 #include <string.h>
 
 #include "esp_log.h"
 #include "esp_heap_caps.h"
+#include "esp_timer.h"
 #include "micro_opus/ogg_opus_decoder.h"
 
 using namespace micro_opus;
@@ -32,9 +36,9 @@ static const char *TAG = "elisa_opus";
 /** Decode output buffer: 120ms of 48kHz mono = 5760 samples = 11520 bytes. */
 #define DECODE_OUTPUT_BYTES (5760 * 2)
 
-extern "C" int elisa_opus_decode(const uint8_t *ogg_data, size_t ogg_len,
-                                  int16_t **pcm_out, size_t *pcm_samples,
-                                  uint32_t *sample_rate) {
+static int opus_decode_impl(const uint8_t *ogg_data, size_t ogg_len,
+                            int16_t **pcm_out, size_t *pcm_samples,
+                            uint32_t *sample_rate, elisa_cancel_token_t cancel) {
     if (ogg_data == NULL || ogg_len == 0 || pcm_out == NULL ||
         pcm_samples == NULL || sample_rate == NULL) {
         return -1;
@@ -74,6 +78,13 @@ extern "C" int elisa_opus_decode(const uint8_t *ogg_data, size_t ogg_len,
     size_t input_offset = 0;
 
     while (input_offset < ogg_len) {
+        if (elisa_turn_cancelled(cancel)) {
+            ESP_LOGW(TAG, "Decode cancelled at offset %zu", input_offset);
+            heap_caps_free(decode_buf);
+            heap_caps_free(pcm_buf);
+            return ELISA_CANCELLED;
+        }
+
         size_t bytes_consumed = 0;
         size_t samples_decoded = 0;
 
@@ -124,6 +135,8 @@ extern "C" int elisa_opus_decode(const uint8_t *ogg_data, size_t ogg_len,
         }
     }
 
+    /* High-water point: Ogg input, PCM output and decode scratch all live */
+    elisa_mem_sample(MEM_STAGE_DECODE);
     heap_caps_free(decode_buf);
 
     /* Get sample rate from decoder */
@@ -147,6 +160,20 @@ extern "C" int elisa_opus_decode(const uint8_t *ogg_data, size_t ogg_len,
     return 0;
 }
 
+extern "C" int elisa_opus_decode(const uint8_t *ogg_data, size_t ogg_len,
+                                  int16_t **pcm_out, size_t *pcm_samples,
+                                  uint32_t *sample_rate, elisa_cancel_token_t cancel) {
+    elisa_trace(TRACE_DECODE, TRACE_PH_BEGIN, (uint32_t)ogg_len);
+    int64_t start_us = esp_timer_get_time();
+    int ret = opus_decode_impl(ogg_data, ogg_len, pcm_out, pcm_samples, sample_rate, cancel);
+    elisa_trace(TRACE_DECODE, TRACE_PH_END,
+                (ret == 0 && pcm_samples != NULL) ? (uint32_t)*pcm_samples : 0);
+    if (ret == 0) {
+        elisa_latency_record(LAT_DECODE, esp_timer_get_time() - start_us);
+    }
+    return ret;
+}
+
 extern "C" void elisa_opus_free(int16_t *pcm_data) {
     if (pcm_data != NULL) {
         heap_caps_free(pcm_data);
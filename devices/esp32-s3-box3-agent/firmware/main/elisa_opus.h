@@ -14,6 +14,8 @@
 #include <stdint.h>
 #include <stddef.h>
 
+#include "elisa_cancel.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -29,11 +31,12 @@ extern "C" {
  * @param pcm_out     Output: pointer to decoded PCM int16 samples (PSRAM)
  * @param pcm_samples Output: number of PCM samples decoded
  * @param sample_rate Output: sample rate of decoded audio (typically 48000)
- * @return 0 on success, -1 on error
+ * @param cancel      Turn token; checked between Ogg pages
+ * @return 0 on success, ELISA_CANCELLED if cancelled, -1 on error
  */
 int elisa_opus_decode(const uint8_t *ogg_data, size_t ogg_len,
                       int16_t **pcm_out, size_t *pcm_samples,
-                      uint32_t *sample_rate);
+                      uint32_t *sample_rate, elisa_cancel_token_t cancel);
 
 /**
  * Free PCM data allocated by elisa_opus_decode().
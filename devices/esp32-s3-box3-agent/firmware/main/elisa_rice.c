@@ -0,0 +1,235 @@
+/**
+ * @file elisa_rice.c
+ * @brief Fixed-predictor + Rice lossless codec implementation.
+ *
+ * Residuals of the order-3 predictor on int16 input fit in 19 bits, so all
+ * arithmetic is 32-bit. Cost per k is computed exactly from the zigzagged
+ * residuals (sum of quotients + n * (k + 1)) over a small window around the
+ * mean-based estimate.
+ */
+
+#include "elisa_rice.h"
+
+#include <string.h>
+
+// ── Prediction ──────────────────────────────────────────────────────────
+
+/** Residual of sample i for a fixed predictor of the given order (i >= order). */
+static inline int32_t residual(const int16_t *x, size_t i, int order) {
+    switch (order) {
+    case 0:  return x[i];
+    case 1:  return (int32_t)x[i] - x[i - 1];
+    case 2:  return (int32_t)x[i] - 2 * (int32_t)x[i - 1] + x[i - 2];
+    default: return (int32_t)x[i] - 3 * (int32_t)x[i - 1] + 3 * (int32_t)x[i - 2] - x[i - 3];
+    }
+}
+
+/** Inverse of residual(): rebuild sample i from the residual. */
+static inline int32_t reconstruct(const int16_t *x, size_t i, int order, int32_t r) {
+    switch (order) {
+    case 0:  return r;
+    case 1:  return r + x[i - 1];
+    case 2:  return r + 2 * (int32_t)x[i - 1] - x[i - 2];
+    default: return r + 3 * (int32_t)x[i - 1] - 3 * (int32_t)x[i - 2] + x[i - 3];
+    }
+}
+
+static inline uint32_t zigzag(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static inline int32_t unzigzag(uint32_t u) {
+    return (int32_t)(u >> 1) ^ -(int32_t)(u & 1);
+}
+
+// ── Bit I/O ─────────────────────────────────────────────────────────────
+
+typedef struct {
+    uint8_t *out;
+    size_t pos;       /* bytes completed */
+    uint32_t acc;     /* pending bits, MSB first */
+    int nbits;
+} bit_writer_t;
+
+static inline void bw_put(bit_writer_t *bw, uint32_t bits, int count) {
+    /* count <= 24 keeps acc from overflowing */
+    bw->acc = (bw->acc << count) | (bits & ((1u << count) - 1));
+    bw->nbits += count;
+    while (bw->nbits >= 8) {
+        bw->nbits -= 8;
+        bw->out[bw->pos++] = (uint8_t)(bw->acc >> bw->nbits);
+    }
+}
+
+static inline void bw_flush(bit_writer_t *bw) {
+    if (bw->nbits > 0) {
+        bw->out[bw->pos++] = (uint8_t)(bw->acc << (8 - bw->nbits));
+        bw->nbits = 0;
+    }
+}
+
+typedef struct {
+    const uint8_t *in;
+    size_t len;
+    size_t pos;       /* next byte to load */
+    uint32_t acc;
+    int nbits;
+} bit_reader_t;
+
+/** Read one bit; returns -1 past the end. */
+static inline int br_bit(bit_reader_t *br) {
+    if (br->nbits == 0) {
+        if (br->pos >= br->len) return -1;
+        br->acc = br->in[br->pos++];
+        br->nbits = 8;
+    }
+    br->nbits--;
+    return (int)((br->acc >> br->nbits) & 1);
+}
+
+static inline int br_bits(bit_reader_t *br, int count, uint32_t *value) {
+    uint32_t v = 0;
+    for (int i = 0; i < count; i++) {
+        int b = br_bit(br);
+        if (b < 0) return -1;
+        v = (v << 1) | (uint32_t)b;
+    }
+    *value = v;
+    return 0;
+}
+
+// ── Encode ──────────────────────────────────────────────────────────────
+
+static size_t rice_cost_bits(const int16_t *pcm, size_t n, int order, int k) {
+    size_t bits = (n - (size_t)order) * (size_t)(k + 1);
+    for (size_t i = (size_t)order; i < n; i++) {
+        bits += zigzag(residual(pcm, i, order)) >> k;
+    }
+    return bits;
+}
+
+size_t elisa_rice_encode(const int16_t *pcm, size_t n, uint8_t *out) {
+    if (n == 0 || n > 0xFFFF) return 0;
+
+    /* Pick the predictor with the smallest sum of |residual| */
+    int order = 0;
+    uint64_t best_sum = UINT64_MAX;
+    int max_order = (n > ELISA_RICE_MAX_ORDER) ? ELISA_RICE_MAX_ORDER : (int)n - 1;
+    for (int o = 0; o <= max_order; o++) {
+        uint64_t sum = 0;
+        for (size_t i = (size_t)o; i < n; i++) {
+            int32_t r = residual(pcm, i, o);
+            sum += (uint64_t)(r < 0 ? -r : r);
+        }
+        if (sum < best_sum) {
+            best_sum = sum;
+            order = o;
+        }
+    }
+
+    /* k estimate: log2 of the mean |residual|, then exact cost for k-1..k+1 */
+    size_t count = n - (size_t)order;
+    uint32_t mean = count ? (uint32_t)(best_sum / count) : 0;
+    int k_est = 0;
+    while (k_est < 30 && (1u << (k_est + 1)) <= mean) k_est++;
+
+    int k = 0;
+    size_t best_bits = SIZE_MAX;
+    for (int kk = k_est - 1; kk <= k_est + 1; kk++) {
+        if (kk < 0 || kk > 30) continue;
+        size_t bits = rice_cost_bits(pcm, n, order, kk);
+        if (bits < best_bits) {
+            best_bits = bits;
+            k = kk;
+        }
+    }
+
+    out[0] = (uint8_t)n;
+    out[1] = (uint8_t)(n >> 8);
+
+    size_t coded = ELISA_RICE_HEADER_SIZE + 2 * (size_t)order + (best_bits + 7) / 8;
+    if (coded >= ELISA_RICE_MAX_BYTES(n)) {
+        out[2] = 0;
+        out[3] = ELISA_RICE_VERBATIM;
+        for (size_t i = 0; i < n; i++) {
+            out[ELISA_RICE_HEADER_SIZE + 2 * i] = (uint8_t)pcm[i];
+            out[ELISA_RICE_HEADER_SIZE + 2 * i + 1] = (uint8_t)((uint16_t)pcm[i] >> 8);
+        }
+        return ELISA_RICE_MAX_BYTES(n);
+    }
+
+    out[2] = (uint8_t)order;
+    out[3] = (uint8_t)k;
+    uint8_t *p = out + ELISA_RICE_HEADER_SIZE;
+    for (int i = 0; i < order; i++) {
+        *p++ = (uint8_t)pcm[i];
+        *p++ = (uint8_t)((uint16_t)pcm[i] >> 8);
+    }
+
+    bit_writer_t bw = { .out = p, .pos = 0, .acc = 0, .nbits = 0 };
+    for (size_t i = (size_t)order; i < n; i++) {
+        uint32_t u = zigzag(residual(pcm, i, order));
+        uint32_t q = u >> k;
+        while (q >= 16) {
+            bw_put(&bw, 0xFFFF, 16);
+            q -= 16;
+        }
+        bw_put(&bw, ((1u << q) - 1) << 1, (int)q + 1); /* q ones, then a zero */
+        if (k > 16) {
+            bw_put(&bw, u >> 16, k - 16);
+            bw_put(&bw, u, 16);
+        } else if (k > 0) {
+            bw_put(&bw, u, k);
+        }
+    }
+    bw_flush(&bw);
+
+    return (size_t)(p - out) + bw.pos;
+}
+
+// ── Decode ──────────────────────────────────────────────────────────────
+
+int elisa_rice_decode(const uint8_t *in, size_t len, int16_t *pcm, size_t max) {
+    if (len < ELISA_RICE_HEADER_SIZE) return -1;
+
+    size_t n = (size_t)in[0] | ((size_t)in[1] << 8);
+    int order = in[2];
+    int k = in[3];
+    if (n == 0 || n > max) return -1;
+
+    if (k == ELISA_RICE_VERBATIM) {
+        if (len < ELISA_RICE_MAX_BYTES(n)) return -1;
+        for (size_t i = 0; i < n; i++) {
+            const uint8_t *s = in + ELISA_RICE_HEADER_SIZE + 2 * i;
+            pcm[i] = (int16_t)(uint16_t)(s[0] | (s[1] << 8));
+        }
+        return (int)n;
+    }
+
+    if (order > ELISA_RICE_MAX_ORDER || (size_t)order > n || k > 30) return -1;
+    if (len < ELISA_RICE_HEADER_SIZE + 2 * (size_t)order) return -1;
+
+    const uint8_t *p = in + ELISA_RICE_HEADER_SIZE;
+    for (int i = 0; i < order; i++) {
+        pcm[i] = (int16_t)(uint16_t)(p[0] | (p[1] << 8));
+        p += 2;
+    }
+
+    bit_reader_t br = { .in = p, .len = len - (size_t)(p - in), .pos = 0, .acc = 0, .nbits = 0 };
+    for (size_t i = (size_t)order; i < n; i++) {
+        uint32_t q = 0;
+        int b;
+        while ((b = br_bit(&br)) == 1) {
+            if (++q > (1u << 20)) return -1;
+        }
+        if (b < 0) return -1;
+
+        uint32_t low = 0;
+        if (k > 0 && br_bits(&br, k, &low) != 0) return -1;
+
+        int32_t v = reconstruct(pcm, i, order, unzigzag((q << k) | low));
+        if (v < INT16_MIN || v > INT16_MAX) return -1;
+        pcm[i] = (int16_t)v;
+    }
+    return (int)n;
+}
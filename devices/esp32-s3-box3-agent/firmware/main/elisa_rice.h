@@ -0,0 +1,66 @@
+/**
+ * @file elisa_rice.h
+ * @brief Lossless block codec for 16-bit PCM: fixed predictor + Rice codes.
+ *
+ * The same scheme as FLAC's fixed subframes, without FLAC's container.
+ * Each block picks the fixed polynomial predictor (order 0-3) with the
+ * smallest residual, maps residuals to unsigned (zigzag) and Rice codes them
+ * with one parameter k per block, chosen by exact bit cost. A block that
+ * would not shrink is stored verbatim.
+ *
+ * Block layout (all multi-byte fields little endian):
+ *
+ *   0  u16  sample count n
+ *   2  u8   predictor order (0-3)
+ *   3  u8   Rice parameter k (0-30), or ELISA_RICE_VERBATIM
+ *   4  ...  order warm-up samples as int16, then the Rice bitstream
+ *           (MSB first: q one-bits, a zero, then k low bits), padded to
+ *           a byte; for verbatim blocks, n int16 samples
+ *
+ * Plain C with no ESP-IDF dependency: the capture task encodes with it and
+ * the host decoder tool (host/capture_decode) decodes with it.
+ */
+
+#ifndef ELISA_RICE_H
+#define ELISA_RICE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ELISA_RICE_HEADER_SIZE  4
+#define ELISA_RICE_MAX_ORDER    3
+#define ELISA_RICE_VERBATIM     0xFF
+
+/** Worst-case encoded size of a block of n samples (verbatim). */
+#define ELISA_RICE_MAX_BYTES(n) (ELISA_RICE_HEADER_SIZE + 2 * (n))
+
+/**
+ * Encode one block.
+ *
+ * @param pcm  Samples
+ * @param n    Sample count (1-65535)
+ * @param out  Buffer of at least ELISA_RICE_MAX_BYTES(n) bytes
+ * @return Encoded size in bytes, or 0 if n is out of range
+ */
+size_t elisa_rice_encode(const int16_t *pcm, size_t n, uint8_t *out);
+
+/**
+ * Decode one block.
+ *
+ * @param in   Encoded block
+ * @param len  Encoded size
+ * @param pcm  Output samples
+ * @param max  Capacity of pcm in samples
+ * @return Samples decoded, or -1 if the block is malformed or too large
+ */
+int elisa_rice_decode(const uint8_t *in, size_t len, int16_t *pcm, size_t max);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ELISA_RICE_H */
@@ -0,0 +1,220 @@
+/**
+ * @file elisa_tasks.c
+ * @brief Task topology table and per-task stack / CPU reporting.
+ *
+ * The override never shrinks a stack: third-party tasks get the larger of
+ * what they asked for and the table's size. CPU load comes from the
+ * FreeRTOS run-time counters; the previous counter of each task is kept
+ * (by handle) so every report covers the interval since the last one.
+ */
+
+#include "elisa_tasks.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+
+static const char *TAG = "elisa_tasks";
+
+// ── Topology ────────────────────────────────────────────────────────────
+//
+// WiFi (prio 23) and lwIP tcpip (prio 18) are IDF tasks, pinned to
+// ELISA_CORE_NET through sdkconfig. Names of the chatgpt_demo / component
+// tasks must match what they pass to xTaskCreatePinnedToCore().
+
+static const elisa_task_spec_t s_plan[ELISA_TASK_COUNT] = {
+    /* Audio core: capture > inference > playback */
+    [ELISA_TASK_AUDIO_FEED]   = { "Feed Task",       8 * 1024,  8, ELISA_CORE_AUDIO },
+    [ELISA_TASK_AUDIO_DETECT] = { "Detect Task",     10 * 1024, 7, ELISA_CORE_AUDIO },
+    [ELISA_TASK_AUDIO_PLAYER] = { "audio task",      4 * 1024,  6, ELISA_CORE_AUDIO },
+
+    /* Network/UI core: LVGL above the turn pipeline so Opus decode and
+     * response parsing don't stall the face animation */
+    [ELISA_TASK_LVGL]         = { "taskLVGL",        6 * 1024,  5, ELISA_CORE_NET },
+    [ELISA_TASK_WIFI_CONNECT] = { "wifi_connect",    4 * 1024,  5, ELISA_CORE_NET },
+    [ELISA_TASK_SR_HANDLER]   = { "SR Handler Task", 8 * 1024,  4, ELISA_CORE_NET },
+    [ELISA_TASK_CAPTURE]      = { "capture",         4 * 1024,  4, ELISA_CORE_NET },
+    [ELISA_TASK_UART_CMD]     = { "uart_cmd",        4 * 1024,  3, ELISA_CORE_NET },
+    [ELISA_TASK_HEARTBEAT]    = { "heartbeat",       6 * 1024,  2, ELISA_CORE_NET },
+};
+
+const elisa_task_spec_t *elisa_task_spec(elisa_task_id_t id) {
+    return (id < ELISA_TASK_COUNT) ? &s_plan[id] : NULL;
+}
+
+static int plan_lookup(const char *name) {
+    if (name == NULL) return -1;
+    for (int i = 0; i < ELISA_TASK_COUNT; i++) {
+        if (strcmp(s_plan[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+// ── Task Creation ───────────────────────────────────────────────────────
+
+int elisa_task_create(elisa_task_id_t id, TaskFunction_t fn, void *arg, TaskHandle_t *handle) {
+    const elisa_task_spec_t *spec = elisa_task_spec(id);
+    if (spec == NULL) return -1;
+
+    if (xTaskCreatePinnedToCore(fn, spec->name, spec->stack_bytes, arg, spec->priority,
+                                handle, spec->core) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create task %s", spec->name);
+        return -1;
+    }
+    return 0;
+}
+
+BaseType_t elisa_task_create_override(TaskFunction_t fn, const char *name, uint32_t stack_bytes,
+                                      void *arg, UBaseType_t priority, TaskHandle_t *handle,
+                                      BaseType_t core) {
+    int id = plan_lookup(name);
+    if (id >= 0) {
+        const elisa_task_spec_t *spec = &s_plan[id];
+        ESP_LOGI(TAG, "%s: prio %u core %d -> prio %u core %d", name,
+                 (unsigned)priority, (int)core, (unsigned)spec->priority, (int)spec->core);
+        if (spec->stack_bytes > stack_bytes) stack_bytes = spec->stack_bytes;
+        priority = spec->priority;
+        core = spec->core;
+    } else {
+        ESP_LOGW(TAG, "%s not in task plan -- created as requested (prio %u core %d)",
+                 name ? name : "?", (unsigned)priority, (int)core);
+    }
+    return xTaskCreatePinnedToCore(fn, name, stack_bytes, arg, priority, handle, core);
+}
+
+// ── Reporting ───────────────────────────────────────────────────────────
+
+#define MAX_TRACKED_TASKS 48
+
+/** Slack for tasks created between counting and listing them. */
+#define SNAPSHOT_SPARE_TASKS 4
+
+#if configUSE_TRACE_FACILITY && configGENERATE_RUN_TIME_STATS
+/** Run-time counter of each task at the previous snapshot. */
+typedef struct {
+    TaskHandle_t handle;
+    uint32_t counter;
+} prev_counter_t;
+
+static prev_counter_t s_prev[MAX_TRACKED_TASKS];
+static int s_prev_count = 0;
+static uint32_t s_prev_total = 0;
+
+static uint32_t prev_counter_of(TaskHandle_t handle) {
+    for (int i = 0; i < s_prev_count; i++) {
+        if (s_prev[i].handle == handle) return s_prev[i].counter;
+    }
+    return 0;
+}
+#endif
+
+int elisa_tasks_snapshot(elisa_task_stats_t *out, int max, uint32_t core_load_permille[2]) {
+#if configUSE_TRACE_FACILITY && configGENERATE_RUN_TIME_STATS
+    /* uxTaskGetSystemState() lists nothing if the array is too small,
+     * so size it for every task rather than for what is reported */
+    UBaseType_t n = uxTaskGetNumberOfTasks() + SNAPSHOT_SPARE_TASKS;
+
+    TaskStatus_t *status = heap_caps_malloc(n * sizeof(TaskStatus_t),
+                                            MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (status == NULL) {
+        status = malloc(n * sizeof(TaskStatus_t));
+        if (status == NULL) return -1;
+    }
+
+    configRUN_TIME_COUNTER_TYPE total = 0;
+    n = uxTaskGetSystemState(status, n, &total);
+
+    /* Counters are per task; total is one core's elapsed time */
+    uint32_t elapsed = (uint32_t)total - s_prev_total;
+    if (core_load_permille) {
+        core_load_permille[0] = core_load_permille[1] = 0;
+    }
+
+    int written = 0;
+    for (UBaseType_t i = 0; i < n; i++) {
+        const TaskStatus_t *t = &status[i];
+        uint32_t delta = (uint32_t)t->ulRunTimeCounter - prev_counter_of(t->xHandle);
+        uint32_t permille = elapsed ? (uint32_t)(((uint64_t)delta * 1000) / elapsed) : 0;
+        if (permille > 1000) permille = 1000;
+        BaseType_t core = xTaskGetCoreID(t->xHandle);
+
+        /* IDLE0 / IDLE1: whatever they did not get, the core was busy */
+        if (core_load_permille && strncmp(t->pcTaskName, "IDLE", 4) == 0 &&
+            core >= 0 && core < 2) {
+            core_load_permille[core] = 1000 - permille;
+        }
+
+        if (written < max) {
+            elisa_task_stats_t *o = &out[written++];
+            strncpy(o->name, t->pcTaskName, sizeof(o->name) - 1);
+            o->name[sizeof(o->name) - 1] = '\0';
+            /* "Feed Task" -> "Feed_Task" so reports stay key=value parseable */
+            for (char *c = o->name; *c; c++) {
+                if (*c == ' ' || *c == '=') *c = '_';
+            }
+            o->priority = t->uxCurrentPriority;
+            o->core = core;
+            o->stack_free_min = (uint32_t)t->usStackHighWaterMark * sizeof(StackType_t);
+            o->cpu_permille = permille;
+            o->planned = plan_lookup(t->pcTaskName);
+        }
+    }
+
+    /* Remember counters for the next interval */
+    s_prev_count = 0;
+    for (UBaseType_t i = 0; i < n && s_prev_count < MAX_TRACKED_TASKS; i++) {
+        s_prev[s_prev_count].handle = status[i].xHandle;
+        s_prev[s_prev_count].counter = (uint32_t)status[i].ulRunTimeCounter;
+        s_prev_count++;
+    }
+    s_prev_total = (uint32_t)total;
+
+    free(status);
+    return written;
+#else
+    (void)out;
+    (void)max;
+    (void)core_load_permille;
+    return -1;
+#endif
+}
+
+void elisa_tasks_print_report(FILE *out) {
+    elisa_task_stats_t *stats = heap_caps_malloc(MAX_TRACKED_TASKS * sizeof(elisa_task_stats_t),
+                                                 MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (stats == NULL) {
+        fprintf(out, "TASK error=no_memory\n");
+        return;
+    }
+
+    uint32_t core_load[2];
+    int n = elisa_tasks_snapshot(stats, MAX_TRACKED_TASKS, core_load);
+    if (n < 0) {
+        fprintf(out, "TASK error=runtime_stats_disabled\n");
+        free(stats);
+        return;
+    }
+
+    for (int i = 0; i < n; i++) {
+        const elisa_task_stats_t *s = &stats[i];
+        const elisa_task_spec_t *spec = (s->planned >= 0) ? &s_plan[s->planned] : NULL;
+        fprintf(out, "TASK name=%s core=%d prio=%u stack_free_min=%lu cpu=%lu.%lu planned=%s",
+                s->name, (s->core == tskNO_AFFINITY) ? -1 : (int)s->core,
+                (unsigned)s->priority, (unsigned long)s->stack_free_min,
+                (unsigned long)(s->cpu_permille / 10), (unsigned long)(s->cpu_permille % 10),
+                spec ? "yes" : "no");
+        if (spec) {
+            fprintf(out, " plan_core=%d plan_prio=%u stack=%lu",
+                    (spec->core == tskNO_AFFINITY) ? -1 : (int)spec->core,
+                    (unsigned)spec->priority, (unsigned long)spec->stack_bytes);
+        }
+        fputc('\n', out);
+    }
+    for (int c = 0; c < 2; c++) {
+        fprintf(out, "CPU core=%d load=%lu.%lu\n", c,
+                (unsigned long)(core_load[c] / 10), (unsigned long)(core_load[c] % 10));
+    }
+    free(stats);
+}
@@ -0,0 +1,133 @@
+/**
+ * @file elisa_tasks.h
+ * @brief Task topology: one table for every task's core, priority and stack.
+ *
+ * Core 1 is the audio core: I2S capture (AFE feed), AFE + wake word
+ * inference and the audio player. Core 0 runs network and UI: the WiFi
+ * driver and lwIP (pinned there by sdkconfig), the SR handler that runs the
+ * turn pipeline (HTTP, Opus decode), LVGL, and the background helpers.
+ * Priorities are ordered so capture can never be starved by inference,
+ * and inference never by the turn pipeline or UI.
+ *
+ * Elisa's own tasks are created with elisa_task_create(). chatgpt_demo's
+ * app_sr.c / app_audio.c are compiled with ELISA_TASKS_OVERRIDE_CREATE
+ * (build-firmware.sh), which routes their xTaskCreate*() calls through
+ * elisa_task_create_override(): a task whose name is in the table gets the
+ * table's core, priority and stack, anything else is created as asked.
+ * LVGL's task is configured through lvgl_port_cfg (see elisa_main.c).
+ *
+ * elisa_tasks_print_report() prints stack high-water marks and CPU load
+ * per task since the previous report; it needs
+ * CONFIG_FREERTOS_USE_TRACE_FACILITY and CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+ * (set by build-firmware.sh). The UART command "TASKS" prints it.
+ */
+
+#ifndef ELISA_TASKS_H
+#define ELISA_TASKS_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Cores in the plan. */
+#define ELISA_CORE_NET    0   /**< WiFi, lwIP, turn pipeline, LVGL */
+#define ELISA_CORE_AUDIO  1   /**< capture, wake word, playback */
+
+/**
+ * Every task in the plan. The first group is created by chatgpt_demo /
+ * components and matched by name; the rest are created by Elisa.
+ */
+typedef enum {
+    ELISA_TASK_AUDIO_FEED,    /**< app_sr.c: I2S capture -> AFE feed */
+    ELISA_TASK_AUDIO_DETECT,  /**< app_sr.c: AFE fetch + wake word inference */
+    ELISA_TASK_SR_HANDLER,    /**< app_sr.c: wake -> record -> start_openai() */
+    ELISA_TASK_AUDIO_PLAYER,  /**< audio_player component */
+    ELISA_TASK_LVGL,          /**< esp_lvgl_port timer task */
+    ELISA_TASK_WIFI_CONNECT,  /**< elisa_main.c: boot WiFi bring-up */
+    ELISA_TASK_HEARTBEAT,     /**< elisa_main.c: runtime heartbeat reports */
+    ELISA_TASK_CAPTURE,       /**< elisa_capture.c: recording mode frames */
+    ELISA_TASK_UART_CMD,      /**< elisa_main.c: serial console commands */
+    ELISA_TASK_COUNT
+} elisa_task_id_t;
+
+/** Placement of one task. */
+typedef struct {
+    const char *name;       /**< FreeRTOS task name */
+    uint32_t stack_bytes;
+    UBaseType_t priority;
+    BaseType_t core;        /**< ELISA_CORE_* or tskNO_AFFINITY */
+} elisa_task_spec_t;
+
+/** Table entry for a task. */
+const elisa_task_spec_t *elisa_task_spec(elisa_task_id_t id);
+
+/**
+ * Create a task with the table's name, stack, priority and core.
+ *
+ * @param id     Task in the plan
+ * @param fn     Task function
+ * @param arg    Task argument
+ * @param handle Optional output handle
+ * @return 0 on success, -1 if the task could not be created
+ */
+int elisa_task_create(elisa_task_id_t id, TaskFunction_t fn, void *arg, TaskHandle_t *handle);
+
+/**
+ * xTaskCreatePinnedToCore() replacement for third-party code: applies the
+ * table entry whose name matches, otherwise creates the task unchanged.
+ */
+BaseType_t elisa_task_create_override(TaskFunction_t fn, const char *name, uint32_t stack_bytes,
+                                      void *arg, UBaseType_t priority, TaskHandle_t *handle,
+                                      BaseType_t core);
+
+/** Per-task figures from elisa_tasks_snapshot(). */
+typedef struct {
+    char name[configMAX_TASK_NAME_LEN]; /**< spaces replaced by '_' */
+    UBaseType_t priority;
+    BaseType_t core;          /**< tskNO_AFFINITY if unpinned */
+    uint32_t stack_free_min;  /**< high-water mark: least free stack ever (bytes) */
+    uint32_t cpu_permille;    /**< share of one core since the previous snapshot */
+    int planned;              /**< elisa_task_id_t, or -1 if not in the table */
+} elisa_task_stats_t;
+
+/**
+ * Snapshot all tasks. CPU load is measured since the previous call, so the
+ * first call reports load since boot.
+ *
+ * @param out      Output array
+ * @param max      Capacity of out
+ * @param core_load_permille Optional: load of core 0 and 1 (1000 - idle)
+ * @return Number of tasks written, or -1 if run-time stats are unavailable
+ */
+int elisa_tasks_snapshot(elisa_task_stats_t *out, int max, uint32_t core_load_permille[2]);
+
+/**
+ * Print one "TASK key=value" line per task and one "CPU" line per core.
+ */
+void elisa_tasks_print_report(FILE *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+/*
+ * Defined (by build-firmware.sh) at the top of chatgpt_demo sources so their
+ * task creation follows the table. Must come after freertos/task.h, which
+ * this header has already included.
+ */
+#ifdef ELISA_TASKS_OVERRIDE_CREATE
+#undef xTaskCreatePinnedToCore
+#undef xTaskCreate
+#define xTaskCreatePinnedToCore(fn, name, stack, arg, prio, handle, core) \
+    elisa_task_create_override((fn), (name), (stack), (arg), (prio), (handle), (core))
+#define xTaskCreate(fn, name, stack, arg, prio, handle) \
+    elisa_task_create_override((fn), (name), (stack), (arg), (prio), (handle), tskNO_AFFINITY)
+#endif
+
+#endif /* ELISA_TASKS_H */
@@ -0,0 +1,207 @@
+/**
+ * @file elisa_telemetry.c
+ * @brief Heap and PSRAM watermark telemetry implementation.
+ *
+ * Samples are taken from the sr_handler task (turn stages) and the audio
+ * player task (play-finish), so folding into the shared aggregates is done
+ * under a spinlock. heap_caps queries run outside the critical section.
+ */
+
+#include "elisa_telemetry.h"
+
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+
+static const char *TAG = "elisa_telemetry";
+
+#define CAPS_INTERNAL (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)
+#define CAPS_SPIRAM   (MALLOC_CAP_SPIRAM)
+
+// ── Static State ────────────────────────────────────────────────────────
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static elisa_mem_report_t s_report;
+
+/* Per-turn accumulation */
+static bool s_turn_active = false;
+static uint32_t s_turn_low_internal;
+static uint32_t s_turn_low_spiram;
+static uint8_t s_turn_frag_internal;
+static uint8_t s_turn_frag_spiram;
+
+/* Running sums for the per-turn averages */
+static uint64_t s_peak_sum_internal = 0;
+static uint64_t s_peak_sum_spiram = 0;
+
+/* Stage active when an allocation fails (read from the failure hook) */
+static volatile elisa_mem_stage_t s_current_stage = MEM_STAGE_TURN_END;
+
+static const char *const s_stage_names[MEM_STAGE_COUNT] = {
+    [MEM_STAGE_TURN_START] = "turn_start",
+    [MEM_STAGE_UPLOAD]     = "upload",
+    [MEM_STAGE_DOWNLOAD]   = "download",
+    [MEM_STAGE_DECODE]     = "decode",
+    [MEM_STAGE_PLAYBACK]   = "playback",
+    [MEM_STAGE_TURN_END]   = "turn_end",
+};
+
+// ── Helpers ─────────────────────────────────────────────────────────────
+
+static void sample_heap(uint32_t caps, elisa_heap_sample_t *out) {
+    out->free_bytes = (uint32_t)heap_caps_get_free_size(caps);
+    out->largest_block = (uint32_t)heap_caps_get_largest_free_block(caps);
+    out->min_free_ever = (uint32_t)heap_caps_get_minimum_free_size(caps);
+}
+
+static uint8_t frag_pct(const elisa_heap_sample_t *s) {
+    if (s->free_bytes == 0) return 100;
+    return (uint8_t)(100 - (uint64_t)s->largest_block * 100 / s->free_bytes);
+}
+
+/** Keep the field-wise minimum of two samples (lowest free, smallest block). */
+static void sample_min(elisa_heap_sample_t *acc, const elisa_heap_sample_t *s) {
+    if (acc->free_bytes == 0 || s->free_bytes < acc->free_bytes) acc->free_bytes = s->free_bytes;
+    if (acc->largest_block == 0 || s->largest_block < acc->largest_block) acc->largest_block = s->largest_block;
+    acc->min_free_ever = s->min_free_ever; /* already monotonic */
+}
+
+static void alloc_failed_hook(size_t size, uint32_t caps, const char *function_name) {
+    (void)function_name;
+    portENTER_CRITICAL_SAFE(&s_lock);
+    s_report.failed_allocs++;
+    s_report.last_failed_size = (uint32_t)size;
+    s_report.last_failed_caps = caps;
+    s_report.last_failed_stage = s_current_stage;
+    portEXIT_CRITICAL_SAFE(&s_lock);
+}
+
+// ── Public API ──────────────────────────────────────────────────────────
+
+void elisa_telemetry_init(void) {
+    memset(&s_report, 0, sizeof(s_report));
+    s_report.internal_total = (uint32_t)heap_caps_get_total_size(CAPS_INTERNAL);
+    s_report.spiram_total = (uint32_t)heap_caps_get_total_size(CAPS_SPIRAM);
+    s_report.last_failed_stage = MEM_STAGE_TURN_END;
+
+    heap_caps_register_failed_alloc_callback(alloc_failed_hook);
+
+    ESP_LOGI(TAG, "Heap totals: internal=%lu spiram=%lu",
+             (unsigned long)s_report.internal_total, (unsigned long)s_report.spiram_total);
+}
+
+void elisa_mem_turn_begin(void) {
+    portENTER_CRITICAL(&s_lock);
+    s_turn_active = true;
+    s_turn_low_internal = UINT32_MAX;
+    s_turn_low_spiram = UINT32_MAX;
+    s_turn_frag_internal = 0;
+    s_turn_frag_spiram = 0;
+    portEXIT_CRITICAL(&s_lock);
+
+    elisa_mem_sample(MEM_STAGE_TURN_START);
+}
+
+void elisa_mem_sample(elisa_mem_stage_t stage) {
+    if (stage >= MEM_STAGE_COUNT) return;
+
+    elisa_mem_sample_t s;
+    sample_heap(CAPS_INTERNAL, &s.internal);
+    sample_heap(CAPS_SPIRAM, &s.spiram);
+    uint8_t fi = frag_pct(&s.internal);
+    uint8_t fs = frag_pct(&s.spiram);
+
+    portENTER_CRITICAL(&s_lock);
+    s_current_stage = stage;
+    sample_min(&s_report.stage_low[stage].internal, &s.internal);
+    sample_min(&s_report.stage_low[stage].spiram, &s.spiram);
+    if (s_turn_active) {
+        if (s.internal.free_bytes < s_turn_low_internal) s_turn_low_internal = s.internal.free_bytes;
+        if (s.spiram.free_bytes < s_turn_low_spiram) s_turn_low_spiram = s.spiram.free_bytes;
+        if (fi > s_turn_frag_internal) s_turn_frag_internal = fi;
+        if (fs > s_turn_frag_spiram) s_turn_frag_spiram = fs;
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void elisa_mem_turn_end(void) {
+    elisa_mem_sample(MEM_STAGE_TURN_END);
+
+    portENTER_CRITICAL(&s_lock);
+    if (s_turn_active) {
+        s_turn_active = false;
+
+        elisa_heap_turn_t ti = {
+            .peak_used = s_report.internal_total - s_turn_low_internal,
+            .frag_pct = s_turn_frag_internal,
+        };
+        elisa_heap_turn_t ts = {
+            .peak_used = s_report.spiram_total - s_turn_low_spiram,
+            .frag_pct = s_turn_frag_spiram,
+        };
+        s_report.last_internal = ti;
+        s_report.last_spiram = ts;
+        if (ti.peak_used > s_report.max_internal.peak_used) s_report.max_internal.peak_used = ti.peak_used;
+        if (ti.frag_pct > s_report.max_internal.frag_pct) s_report.max_internal.frag_pct = ti.frag_pct;
+        if (ts.peak_used > s_report.max_spiram.peak_used) s_report.max_spiram.peak_used = ts.peak_used;
+        if (ts.frag_pct > s_report.max_spiram.frag_pct) s_report.max_spiram.frag_pct = ts.frag_pct;
+
+        s_report.turns++;
+        s_peak_sum_internal += ti.peak_used;
+        s_peak_sum_spiram += ts.peak_used;
+        s_report.avg_peak_internal = (uint32_t)(s_peak_sum_internal / s_report.turns);
+        s_report.avg_peak_spiram = (uint32_t)(s_peak_sum_spiram / s_report.turns);
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void elisa_mem_get_report(elisa_mem_report_t *out) {
+    if (out == NULL) return;
+    portENTER_CRITICAL(&s_lock);
+    memcpy(out, &s_report, sizeof(*out));
+    portEXIT_CRITICAL(&s_lock);
+}
+
+const char *elisa_mem_stage_name(elisa_mem_stage_t stage) {
+    return (stage < MEM_STAGE_COUNT) ? s_stage_names[stage] : "unknown";
+}
+
+void elisa_mem_print_report(FILE *out) {
+    elisa_mem_report_t r;
+    elisa_mem_get_report(&r);
+
+    elisa_mem_sample_t now;
+    sample_heap(CAPS_INTERNAL, &now.internal);
+    sample_heap(CAPS_SPIRAM, &now.spiram);
+
+    fprintf(out, "MEM heap=internal total=%lu free=%lu largest=%lu min_ever=%lu "
+                 "last_peak=%lu last_frag=%u max_peak=%lu max_frag=%u avg_peak=%lu\n",
+            (unsigned long)r.internal_total, (unsigned long)now.internal.free_bytes,
+            (unsigned long)now.internal.largest_block, (unsigned long)now.internal.min_free_ever,
+            (unsigned long)r.last_internal.peak_used, (unsigned)r.last_internal.frag_pct,
+            (unsigned long)r.max_internal.peak_used, (unsigned)r.max_internal.frag_pct,
+            (unsigned long)r.avg_peak_internal);
+    fprintf(out, "MEM heap=spiram total=%lu free=%lu largest=%lu min_ever=%lu "
+                 "last_peak=%lu last_frag=%u max_peak=%lu max_frag=%u avg_peak=%lu\n",
+            (unsigned long)r.spiram_total, (unsigned long)now.spiram.free_bytes,
+            (unsigned long)now.spiram.largest_block, (unsigned long)now.spiram.min_free_ever,
+            (unsigned long)r.last_spiram.peak_used, (unsigned)r.last_spiram.frag_pct,
+            (unsigned long)r.max_spiram.peak_used, (unsigned)r.max_spiram.frag_pct,
+            (unsigned long)r.avg_peak_spiram);
+    for (int i = 0; i < MEM_STAGE_COUNT; i++) {
+        const elisa_mem_sample_t *s = &r.stage_low[i];
+        fprintf(out, "MEM stage=%s int_free_low=%lu int_largest_low=%lu "
+                     "psram_free_low=%lu psram_largest_low=%lu\n",
+                s_stage_names[i],
+                (unsigned long)s->internal.free_bytes, (unsigned long)s->internal.largest_block,
+                (unsigned long)s->spiram.free_bytes, (unsigned long)s->spiram.largest_block);
+    }
+    fprintf(out, "MEM turns=%lu failed_allocs=%lu last_failed_size=%lu "
+                 "last_failed_caps=0x%lx last_failed_stage=%s\n",
+            (unsigned long)r.turns, (unsigned long)r.failed_allocs,
+            (unsigned long)r.last_failed_size, (unsigned long)r.last_failed_caps,
+            elisa_mem_stage_name(r.last_failed_stage));
+}
@@ -0,0 +1,112 @@
+/**
+ * @file elisa_telemetry.h
+ * @brief Heap and PSRAM watermark telemetry per turn pipeline stage.
+ *
+ * Samples free bytes, largest free block and the minimum-ever free size of
+ * the internal and SPIRAM heaps at fixed points of each turn. Per turn the
+ * module keeps the peak usage (lowest free seen) and the worst
+ * fragmentation; across turns it keeps the lowest sample per stage and
+ * aggregate peak/average figures, so buffer sizes can be chosen from data
+ * rather than from "Failed to allocate PCM buffer" reports.
+ *
+ * Failed heap allocations are also counted, with the size, caps and the
+ * last stage sampled before they happened.
+ *
+ * The UART command "MEM" prints the report (see elisa_mem_print_report()).
+ */
+
+#ifndef ELISA_TELEMETRY_H
+#define ELISA_TELEMETRY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Sampling points within a turn.
+ */
+typedef enum {
+    MEM_STAGE_TURN_START, /**< start_openai(): recorded WAV in hand */
+    MEM_STAGE_UPLOAD,     /**< request body sent */
+    MEM_STAGE_DOWNLOAD,   /**< response body fully buffered */
+    MEM_STAGE_DECODE,     /**< Opus decoded, PCM + scratch still live */
+    MEM_STAGE_PLAYBACK,   /**< playback buffer handed to audio_player */
+    MEM_STAGE_TURN_END,   /**< playback finished or turn abandoned */
+    MEM_STAGE_COUNT
+} elisa_mem_stage_t;
+
+/** One heap's state at a sampling point (bytes). */
+typedef struct {
+    uint32_t free_bytes;
+    uint32_t largest_block;
+    uint32_t min_free_ever;
+} elisa_heap_sample_t;
+
+/** Internal RAM and PSRAM sampled together. */
+typedef struct {
+    elisa_heap_sample_t internal;
+    elisa_heap_sample_t spiram;
+} elisa_mem_sample_t;
+
+/** Peak usage and fragmentation of one heap over a turn. */
+typedef struct {
+    uint32_t peak_used;  /**< total - lowest free seen during the turn */
+    uint8_t frag_pct;    /**< worst 100 * (1 - largest_block / free) during the turn */
+} elisa_heap_turn_t;
+
+/**
+ * Aggregated memory telemetry since boot.
+ */
+typedef struct {
+    uint32_t turns;                          /**< Turns completed */
+    uint32_t internal_total;                 /**< Heap sizes at boot */
+    uint32_t spiram_total;
+    elisa_heap_turn_t last_internal;         /**< Most recent turn */
+    elisa_heap_turn_t last_spiram;
+    elisa_heap_turn_t max_internal;          /**< Worst turn so far */
+    elisa_heap_turn_t max_spiram;
+    uint32_t avg_peak_internal;              /**< Mean peak usage per turn */
+    uint32_t avg_peak_spiram;
+    elisa_mem_sample_t stage_low[MEM_STAGE_COUNT]; /**< Lowest free seen at each stage */
+    uint32_t failed_allocs;                  /**< heap_caps allocation failures */
+    uint32_t last_failed_size;
+    uint32_t last_failed_caps;
+    elisa_mem_stage_t last_failed_stage;     /**< Last stage sampled before the failure */
+} elisa_mem_report_t;
+
+/**
+ * Initialize telemetry: records heap totals and registers the failed
+ * allocation callback. Call once early in app_main().
+ */
+void elisa_telemetry_init(void);
+
+/** Mark the start of a turn (resets per-turn peaks, samples TURN_START). */
+void elisa_mem_turn_begin(void);
+
+/** Sample both heaps at @p stage and fold the result into the turn. */
+void elisa_mem_sample(elisa_mem_stage_t stage);
+
+/** Sample TURN_END and fold the turn into the aggregates. */
+void elisa_mem_turn_end(void);
+
+/** Copy the current aggregates. */
+void elisa_mem_get_report(elisa_mem_report_t *out);
+
+/** Stage name as used in reports ("turn_start", "upload", ...). */
+const char *elisa_mem_stage_name(elisa_mem_stage_t stage);
+
+/**
+ * Print the report as "MEM key=value ..." lines, one per heap summary and
+ * one per stage, for scripted capture over UART.
+ */
+void elisa_mem_print_report(FILE *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ELISA_TELEMETRY_H */
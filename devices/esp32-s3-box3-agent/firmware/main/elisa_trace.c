@@ -0,0 +1,144 @@
+/**
+ * @file elisa_trace.c
+ * @brief Lock-free trace ring and Chrome trace JSON export.
+ *
+ * Writers claim a slot with one atomic fetch-add on the head counter and
+ * fill it in place. Each slot carries the sequence number it was claimed
+ * with; the writer clears it first and publishes it last, so the dumper
+ * can tell a complete record from one that is mid-write or was lapped.
+ */
+
+#include "elisa_trace.h"
+
+#if ELISA_TRACE_ENABLED
+
+#include <stdatomic.h>
+#include <stdbool.h>
+
+#include "esp_timer.h"
+
+#define RING_MASK (ELISA_TRACE_RING_SIZE - 1)
+
+_Static_assert((ELISA_TRACE_RING_SIZE & RING_MASK) == 0,
+               "ELISA_TRACE_RING_SIZE must be a power of two");
+
+// ── Event Table ─────────────────────────────────────────────────────────
+
+/**
+ * Display name and Chrome trace track (tid) per trace point. Events on the
+ * same track must nest, so the sequential network stages share one track
+ * and decode/playback share another.
+ */
+typedef struct {
+    const char *name;
+    uint8_t track;
+} trace_event_info_t;
+
+enum { TRACK_TURN = 1, TRACK_NETWORK = 2, TRACK_AUDIO = 3 };
+
+static const trace_event_info_t s_event_info[TRACE_EVENT_COUNT] = {
+    [TRACE_TURN]           = { "turn",           TRACK_TURN },
+    [TRACE_RECORD]         = { "record",         TRACK_AUDIO },
+    [TRACE_UPLOAD]         = { "upload",         TRACK_NETWORK },
+    [TRACE_SERVER]         = { "server",         TRACK_NETWORK },
+    [TRACE_DOWNLOAD]       = { "download",       TRACK_NETWORK },
+    [TRACE_HTTP_CONNECTED] = { "http_connected", TRACK_NETWORK },
+    [TRACE_HTTP_HEADERS]   = { "http_headers",   TRACK_NETWORK },
+    [TRACE_DECODE]         = { "decode",         TRACK_AUDIO },
+    [TRACE_PLAYBACK]       = { "playback",       TRACK_AUDIO },
+    [TRACE_CANCEL]         = { "cancel",         TRACK_TURN },
+};
+
+static const char *const s_track_names[] = {
+    [TRACK_TURN] = "turn", [TRACK_NETWORK] = "network", [TRACK_AUDIO] = "audio",
+};
+
+// ── Ring ────────────────────────────────────────────────────────────────
+
+typedef struct {
+    _Atomic uint32_t seq;  /**< claim number + 1; 0 while being written */
+    uint32_t arg;
+    int64_t ts_us;
+    uint16_t turn;
+    uint8_t event;
+    char phase;
+} trace_record_t;
+
+static trace_record_t s_ring[ELISA_TRACE_RING_SIZE];
+static atomic_uint_least32_t s_head = 0;
+static atomic_uint_least32_t s_turn = 0;
+
+// ── Recording ───────────────────────────────────────────────────────────
+
+void elisa_trace_at(elisa_trace_event_t event, elisa_trace_phase_t phase,
+                    int64_t ts_us, uint32_t arg) {
+    uint32_t claim = (uint32_t)atomic_fetch_add_explicit(&s_head, 1, memory_order_relaxed);
+    trace_record_t *rec = &s_ring[claim & RING_MASK];
+
+    atomic_store_explicit(&rec->seq, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    rec->ts_us = ts_us;
+    rec->arg = arg;
+    rec->turn = (uint16_t)atomic_load_explicit(&s_turn, memory_order_relaxed);
+    rec->event = (uint8_t)event;
+    rec->phase = (char)phase;
+    atomic_store_explicit(&rec->seq, claim + 1, memory_order_release);
+}
+
+void elisa_trace(elisa_trace_event_t event, elisa_trace_phase_t phase, uint32_t arg) {
+    elisa_trace_at(event, phase, esp_timer_get_time(), arg);
+}
+
+void elisa_trace_turn_begin(uint32_t arg) {
+    atomic_fetch_add_explicit(&s_turn, 1, memory_order_relaxed);
+    elisa_trace(TRACE_TURN, TRACE_PH_BEGIN, arg);
+}
+
+// ── Export ──────────────────────────────────────────────────────────────
+
+void elisa_trace_dump(FILE *out) {
+    uint32_t head = (uint32_t)atomic_load_explicit(&s_head, memory_order_acquire);
+    uint32_t start = (head > ELISA_TRACE_RING_SIZE) ? head - ELISA_TRACE_RING_SIZE : 0;
+
+    fprintf(out, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    /* Name the tracks so the viewer shows "network" instead of "tid 2" */
+    bool first = true;
+    for (int t = TRACK_TURN; t <= TRACK_AUDIO; t++) {
+        fprintf(out, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                     "\"args\":{\"name\":\"%s\"}}",
+                first ? "" : ",", t, s_track_names[t]);
+        first = false;
+    }
+
+    for (uint32_t claim = start; claim < head; claim++) {
+        const trace_record_t *rec = &s_ring[claim & RING_MASK];
+        if (atomic_load_explicit(&rec->seq, memory_order_acquire) != claim + 1) {
+            continue; /* mid-write or already overwritten */
+        }
+        trace_record_t copy;
+        copy.ts_us = rec->ts_us;
+        copy.arg = rec->arg;
+        copy.turn = rec->turn;
+        copy.event = rec->event;
+        copy.phase = rec->phase;
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&rec->seq, memory_order_relaxed) != claim + 1 ||
+            copy.event >= TRACE_EVENT_COUNT) {
+            continue;
+        }
+
+        const trace_event_info_t *info = &s_event_info[copy.event];
+        fprintf(out, ",{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%lld,\"pid\":1,\"tid\":%u,",
+                info->name, copy.phase, (long long)copy.ts_us, (unsigned)info->track);
+        if (copy.phase == TRACE_PH_INSTANT) {
+            fprintf(out, "\"s\":\"t\",");
+        }
+        fprintf(out, "\"args\":{\"turn\":%u,\"v\":%lu}}",
+                (unsigned)copy.turn, (unsigned long)copy.arg);
+    }
+
+    fprintf(out, "]}\n");
+}
+
+#endif /* ELISA_TRACE_ENABLED */
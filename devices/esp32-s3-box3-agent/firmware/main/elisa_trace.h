@@ -0,0 +1,106 @@
+/**
+ * @file elisa_trace.h
+ * @brief Per-turn latency trace ring with Chrome trace export.
+ *
+ * Records timestamped begin/end/instant events at fixed points of the
+ * turn pipeline (recording, upload, server wait, download, decode,
+ * playback) into a fixed-size ring in internal RAM. Recording is one
+ * atomic increment, one esp_timer_get_time() and a 24-byte store, so it
+ * stays enabled in production builds.
+ *
+ * The UART command "TRACE" dumps the ring as Chrome trace JSON between
+ * "TRACE_BEGIN" / "TRACE_END" marker lines. Save the JSON and open it in
+ * chrome://tracing or https://ui.perfetto.dev.
+ *
+ * Set ELISA_TRACE_ENABLED to 0 to compile every call out.
+ */
+
+#ifndef ELISA_TRACE_H
+#define ELISA_TRACE_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef ELISA_TRACE_ENABLED
+#define ELISA_TRACE_ENABLED 1
+#endif
+
+/** Ring capacity in events (power of two). ~12 turns of full detail. */
+#define ELISA_TRACE_RING_SIZE 256
+
+/**
+ * Trace points. Each maps to a display name and a track in the Chrome
+ * trace (see s_event_info in elisa_trace.c).
+ */
+typedef enum {
+    TRACE_TURN,          /**< Whole turn: start_openai() -> playback finished */
+    TRACE_RECORD,        /**< Microphone capture (back-dated from WAV length) */
+    TRACE_UPLOAD,        /**< POST body upload to the runtime */
+    TRACE_SERVER,        /**< Waiting for response headers (STT + LLM + TTS) */
+    TRACE_DOWNLOAD,      /**< Response body download */
+    TRACE_HTTP_CONNECTED,/**< Instant: TCP/TLS connection established */
+    TRACE_HTTP_HEADERS,  /**< Instant: first response header received (TTFB) */
+    TRACE_DECODE,        /**< Ogg Opus -> PCM decode */
+    TRACE_PLAYBACK,      /**< audio_player_play() -> play-finish callback */
+    TRACE_CANCEL,        /**< Instant: turn cancelled */
+    TRACE_EVENT_COUNT
+} elisa_trace_event_t;
+
+/** Chrome trace phases used by the ring. */
+typedef enum {
+    TRACE_PH_BEGIN   = 'B',
+    TRACE_PH_END     = 'E',
+    TRACE_PH_INSTANT = 'i',
+} elisa_trace_phase_t;
+
+#if ELISA_TRACE_ENABLED
+
+/**
+ * Record an event at the current esp_timer time.
+ * Lock-free and safe from any task. Not for use from ISRs.
+ *
+ * @param event Trace point
+ * @param phase Begin, end or instant
+ * @param arg   Free-form value shown in the event args (bytes, samples...)
+ */
+void elisa_trace(elisa_trace_event_t event, elisa_trace_phase_t phase, uint32_t arg);
+
+/** Record an event with an explicit esp_timer timestamp (for back-dating). */
+void elisa_trace_at(elisa_trace_event_t event, elisa_trace_phase_t phase,
+                    int64_t ts_us, uint32_t arg);
+
+/**
+ * Start a new turn: bumps the turn number attached to subsequent events
+ * and records TRACE_TURN begin.
+ */
+void elisa_trace_turn_begin(uint32_t arg);
+
+/**
+ * Write the ring, oldest event first, as Chrome trace JSON.
+ * Events being written concurrently are skipped rather than torn.
+ */
+void elisa_trace_dump(FILE *out);
+
+#else
+
+static inline void elisa_trace(elisa_trace_event_t event, elisa_trace_phase_t phase, uint32_t arg) {
+    (void)event; (void)phase; (void)arg;
+}
+static inline void elisa_trace_at(elisa_trace_event_t event, elisa_trace_phase_t phase,
+                                  int64_t ts_us, uint32_t arg) {
+    (void)event; (void)phase; (void)ts_us; (void)arg;
+}
+static inline void elisa_trace_turn_begin(uint32_t arg) { (void)arg; }
+static inline void elisa_trace_dump(FILE *out) { (void)out; }
+
+#endif /* ELISA_TRACE_ENABLED */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ELISA_TRACE_H */
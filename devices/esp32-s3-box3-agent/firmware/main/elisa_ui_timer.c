@@ -0,0 +1,34 @@
+/**
+ * @file elisa_ui_timer.c
+ * @brief Armed-flag pause and resume of an LVGL timer.
+ */
+
+#include "elisa_ui_timer.h"
+
+void elisa_ui_timer_init(elisa_ui_timer_t *t, lv_timer_t *timer) {
+    t->timer = timer;
+    atomic_store_explicit(&t->armed, false, memory_order_relaxed);
+    lv_timer_pause(timer);
+}
+
+/*
+ * The one LVGL call made outside the LVGL task, without bsp_display_lock:
+ * taking it would hold the posting task (a turn, the detect task) behind
+ * a whole frame render. In LVGL 8.3 lv_timer_resume() only clears
+ * timer->paused, the sole bit field in its word, and leaves last_run and
+ * the timer list alone. lv_timer_handler() reads the bit on a later pass,
+ * and the armed flag orders the resume after any pause of the same timer.
+ * Recheck this if LVGL is upgraded.
+ */
+void elisa_ui_timer_arm(elisa_ui_timer_t *t) {
+    if (atomic_exchange(&t->armed, true)) return;
+    lv_timer_resume(t->timer);
+}
+
+void elisa_ui_timer_park(elisa_ui_timer_t *t, elisa_ui_timer_pending_t pending) {
+    lv_timer_pause(t->timer);
+    atomic_store(&t->armed, false);
+    if (pending()) {
+        elisa_ui_timer_arm(t);
+    }
+}
@@ -0,0 +1,54 @@
+/**
+ * @file elisa_ui_timer.h
+ * @brief LVGL timer that stays paused until another task has work for it.
+ *
+ * The face's command queue and the caption mailbox are posted to from any
+ * task and drained by an LVGL timer on the LVGL task. A timer polling an
+ * empty queue still wakes the LVGL task each period, so it is paused while
+ * there is nothing to do:
+ *
+ * - a producer posts, then calls elisa_ui_timer_arm()
+ * - the timer callback drains and, once idle, calls elisa_ui_timer_park()
+ *
+ * An armed flag decides who touches the timer. Only the caller that raises
+ * it resumes the timer, and park pauses the timer before lowering it, so a
+ * resume never races a pause.
+ */
+
+#ifndef ELISA_UI_TIMER_H
+#define ELISA_UI_TIMER_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    lv_timer_t *timer;
+    atomic_bool armed;          /**< timer resumed, or about to be */
+} elisa_ui_timer_t;
+
+/** Anything left for the timer to do (LVGL task). */
+typedef bool (*elisa_ui_timer_pending_t)(void);
+
+/** Take a new timer and pause it until the first arm (LVGL task or under its lock). */
+void elisa_ui_timer_init(elisa_ui_timer_t *t, lv_timer_t *timer);
+
+/** Have the LVGL task run the timer on its next pass (any task). */
+void elisa_ui_timer_arm(elisa_ui_timer_t *t);
+
+/**
+ * Pause the timer until the next arm (timer callback). Re-arms at once if
+ * @p pending: a post that saw the flag still raised did not resume it.
+ */
+void elisa_ui_timer_park(elisa_ui_timer_t *t, elisa_ui_timer_pending_t pending);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ELISA_UI_TIMER_H */
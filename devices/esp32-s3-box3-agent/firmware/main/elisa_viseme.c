@@ -0,0 +1,207 @@
+/**
+ * @file elisa_viseme.c
+ * @brief Goertzel band energies and viseme classification.
+ */
+
+#include "elisa_viseme.h"
+
+#include <math.h>
+#include <string.h>
+
+/* Analyzed rate is the input rate divided down to at least this */
+#define ANALYSIS_RATE   16000
+
+/* Goertzel blocks are 1 / BLOCK_HZ long */
+#define BLOCK_HZ        250
+
+/* Coefficient fixed point */
+#define COEFF_SHIFT     14
+
+#define TWO_PI          6.28318531f
+
+/* Bin indices into the power array */
+enum { BIN_250, BIN_500, BIN_750, BIN_1250, BIN_1750, BIN_2250, BIN_2750, BIN_5000, BIN_6500 };
+
+static const uint16_t k_bin_hz[ELISA_VISEME_BINS] = {
+    250, 500, 750, 1250, 1750, 2250, 2750, 5000, 6500,
+};
+
+/* Silence: window RMS under -50 dBFS, or under 1/8 (-18 dB) of the recent peak */
+#define SILENCE_MEAN_SQ 10737
+#define REST_LEVEL      (ELISA_VISEME_LEVEL_ONE / 8)
+
+/* Nasals are at least 6 dB quieter than the vowels around them */
+#define CLOSED_LEVEL    (ELISA_VISEME_LEVEL_ONE / 2)
+
+/* The loudness peak decays by 1/64 per window (about 3 dB/s) and never
+ * drops below -30 dBFS, so a quiet stream does not open the mouth fully */
+#define PEAK_DECAY_SHIFT 6
+#define PEAK_FLOOR       1073741ULL
+
+// ── Classification ──────────────────────────────────────────────────────
+
+/*
+ * Formant rules on the bin powers:
+ *
+ * - fricatives put more energy above 4 kHz than below 1.5 kHz: TEETH
+ * - a second formant above 1.5 kHz (more energy there than at 1250 Hz)
+ *   is a front vowel: OPEN if the first formant is near 750 Hz (ae; the
+ *   750 Hz bin within 3 dB of the 500 Hz one), WIDE if lower (e, i)
+ * - a back vowel with its first formant at 750 Hz is OPEN if the second
+ *   formant is near 1 kHz (a), ROUND if it is lower (o)
+ * - both formants low is u, or a nasal hum if it is also quiet
+ *   (m, n, and the voicing of b, p): CLOSED
+ */
+static elisa_viseme_t classify(const uint64_t p[ELISA_VISEME_BINS], uint32_t level) {
+    uint64_t hiss = p[BIN_5000] + p[BIN_6500];
+    uint64_t voice = p[BIN_250] + p[BIN_500] + p[BIN_750] + p[BIN_1250];
+    uint64_t front = p[BIN_1750] + p[BIN_2250] + p[BIN_2750];
+
+    if (hiss * 2 > voice) return ELISA_VISEME_TEETH;
+    if (front > p[BIN_1250]) {
+        return (p[BIN_750] * 2 > p[BIN_500]) ? ELISA_VISEME_OPEN : ELISA_VISEME_WIDE;
+    }
+    if (p[BIN_750] > p[BIN_250]) {
+        return (p[BIN_1250] * 16 > p[BIN_750]) ? ELISA_VISEME_OPEN : ELISA_VISEME_ROUND;
+    }
+    return (level < CLOSED_LEVEL) ? ELISA_VISEME_CLOSED : ELISA_VISEME_ROUND;
+}
+
+static uint32_t isqrt64(uint64_t x) {
+    uint64_t r = 0, bit = 1ULL << 62;
+    while (bit > x) bit >>= 2;
+    while (bit != 0) {
+        if (x >= r + bit) {
+            x -= r + bit;
+            r = (r >> 1) + bit;
+        } else {
+            r >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)r;
+}
+
+// ── Analysis ────────────────────────────────────────────────────────────
+
+static void block_done(elisa_viseme_analyzer_t *a) {
+    uint64_t n2 = (uint64_t)a->block_len * a->block_len;
+    for (int b = 0; b < ELISA_VISEME_BINS; b++) {
+        int64_t s1 = a->s1[b], s2 = a->s2[b];
+        int64_t p = s1 * s1 + s2 * s2 - ((a->coeff[b] * s1) >> COEFF_SHIFT) * s2;
+        if (p > 0) a->bin_power[b] += (uint64_t)p / n2;
+        a->s1[b] = 0;
+        a->s2[b] = 0;
+    }
+    a->block_n = 0;
+    a->blocks++;
+}
+
+static elisa_viseme_frame_t window_done(elisa_viseme_analyzer_t *a) {
+    uint64_t mean_sq = a->energy / ((uint32_t)a->block_len * ELISA_VISEME_BLOCKS);
+
+    a->peak -= a->peak >> PEAK_DECAY_SHIFT;
+    if (a->peak < PEAK_FLOOR) a->peak = PEAK_FLOOR;
+    if (mean_sq > a->peak) a->peak = mean_sq;
+
+    /* sqrt(mean_sq / peak) in Q16; mean_sq <= peak < 2^31 */
+    uint32_t level = isqrt64((mean_sq << 32) / a->peak);
+    if (level > ELISA_VISEME_LEVEL_ONE) level = ELISA_VISEME_LEVEL_ONE;
+
+    elisa_viseme_frame_t f = { ELISA_VISEME_REST, 0 };
+    if (mean_sq >= SILENCE_MEAN_SQ && level >= REST_LEVEL) {
+        f.viseme = (uint8_t)classify(a->bin_power, level);
+        f.level = (uint16_t)level;
+    }
+
+    memset(a->bin_power, 0, sizeof(a->bin_power));
+    a->energy = 0;
+    a->blocks = 0;
+    return f;
+}
+
+// ── Public API ──────────────────────────────────────────────────────────
+
+int elisa_viseme_init(elisa_viseme_analyzer_t *a, uint32_t sample_rate, uint8_t channels) {
+    memset(a, 0, sizeof(*a));
+    if (sample_rate < ELISA_VISEME_MIN_RATE || channels < 1 || channels > 2) return -1;
+
+    a->channels = channels;
+    a->decim = (uint8_t)(sample_rate / ANALYSIS_RATE);
+    uint32_t rate = sample_rate / a->decim;
+    a->block_len = (uint16_t)(rate / BLOCK_HZ);
+    for (int b = 0; b < ELISA_VISEME_BINS; b++) {
+        float w = TWO_PI * (float)k_bin_hz[b] / (float)rate;
+        a->coeff[b] = (int32_t)lroundf(2.0f * cosf(w) * (1 << COEFF_SHIFT));
+    }
+    for (int i = 0; i < a->block_len; i++) {
+        float h = 0.5f - 0.5f * cosf(TWO_PI * ((float)i + 0.5f) / (float)a->block_len);
+        a->hann[i] = (int16_t)lroundf(h * 32767.0f);
+    }
+    a->peak = PEAK_FLOOR;
+    return 0;
+}
+
+void elisa_viseme_reset(elisa_viseme_analyzer_t *a) {
+    a->dec_acc = 0;
+    a->dec_n = 0;
+    a->block_n = 0;
+    a->blocks = 0;
+    memset(a->s1, 0, sizeof(a->s1));
+    memset(a->s2, 0, sizeof(a->s2));
+    memset(a->bin_power, 0, sizeof(a->bin_power));
+    a->energy = 0;
+    a->peak = PEAK_FLOOR;
+}
+
+size_t elisa_viseme_feed(elisa_viseme_analyzer_t *a, const int16_t *pcm, size_t frames,
+                         elisa_viseme_frame_t *out, size_t max_out) {
+    if (a->block_len == 0) return 0;
+
+    size_t n_out = 0;
+    for (size_t i = 0; i < frames; i++) {
+        int32_t s = pcm[0];
+        if (a->channels == 2) s = (s + pcm[1]) >> 1;
+        pcm += a->channels;
+
+        a->dec_acc += s;
+        if (++a->dec_n < a->decim) continue;
+        int32_t x = a->dec_acc / a->decim;
+        a->dec_acc = 0;
+        a->dec_n = 0;
+
+        a->energy += (uint64_t)((int64_t)x * x);
+        x = (x * a->hann[a->block_n]) >> 15;
+        for (int b = 0; b < ELISA_VISEME_BINS; b++) {
+            int32_t s0 = x + (int32_t)(((int64_t)a->coeff[b] * a->s1[b]) >> COEFF_SHIFT) - a->s2[b];
+            a->s2[b] = a->s1[b];
+            a->s1[b] = s0;
+        }
+
+        if (++a->block_n < a->block_len) continue;
+        block_done(a);
+        if (a->blocks < ELISA_VISEME_BLOCKS) continue;
+
+        elisa_viseme_frame_t f = window_done(a);
+        if (max_out == 0) continue;
+        if (n_out < max_out) n_out++;
+        out[n_out - 1] = f;
+    }
+    return n_out;
+}
+
+size_t elisa_viseme_window_frames(const elisa_viseme_analyzer_t *a) {
+    return (size_t)a->decim * a->block_len * ELISA_VISEME_BLOCKS;
+}
+
+const char *elisa_viseme_name(elisa_viseme_t viseme) {
+    switch (viseme) {
+    case ELISA_VISEME_REST:   return "rest";
+    case ELISA_VISEME_CLOSED: return "closed";
+    case ELISA_VISEME_OPEN:   return "open";
+    case ELISA_VISEME_WIDE:   return "wide";
+    case ELISA_VISEME_ROUND:  return "round";
+    case ELISA_VISEME_TEETH:  return "teeth";
+    default:                  return "unknown";
+    }
+}
@@ -0,0 +1,114 @@
+/**
+ * @file elisa_viseme.h
+ * @brief Lip-sync analyzer: playback PCM to mouth shapes (visemes).
+ *
+ * PCM is averaged down to about 16 kHz and cut into 20 ms windows. Each
+ * window runs a bank of Goertzel filters over Hann-windowed 4 ms blocks
+ * and sums the block powers per bin. Every bin is then about 500 Hz wide,
+ * so it always spans several pitch harmonics, and bins 500 Hz apart meet
+ * at -6 dB, so a formant anywhere below 3 kHz shows up; the window keeps
+ * a strong first formant from leaking into the upper bins. Where the first
+ * and second formants sit, and how much fricative hiss there is, picks
+ * one of a handful of visemes; the window energy relative to a slowly
+ * decaying peak gives how far the mouth opens.
+ *
+ * Integer only per sample: Q14 filter coefficients with 64-bit products.
+ * The coefficients are computed once per sample rate.
+ *
+ * Plain C with no LVGL or ESP-IDF dependency so host tools can share it.
+ */
+
+#ifndef ELISA_VISEME_H
+#define ELISA_VISEME_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** One viseme per window of this length. */
+#define ELISA_VISEME_WINDOW_MS  20
+
+/** Goertzel blocks per window (4 ms each). */
+#define ELISA_VISEME_BLOCKS     5
+
+/** Longest block in analyzed samples (4 ms below 32 kHz). */
+#define ELISA_VISEME_MAX_BLOCK  128
+
+/** Goertzel bins: 250, 500, then 750 .. 2750 Hz every 500 Hz, 5000 and 6500 Hz. */
+#define ELISA_VISEME_BINS       9
+
+/** Lowest supported sample rate (the top bin needs 13 kHz). */
+#define ELISA_VISEME_MIN_RATE   16000
+
+/** Level of a fully open mouth. */
+#define ELISA_VISEME_LEVEL_ONE  0xFFFF
+
+typedef enum {
+    ELISA_VISEME_REST,      /**< Silence: resting mouth */
+    ELISA_VISEME_CLOSED,    /**< m, b, p: lips together, voiced hum */
+    ELISA_VISEME_OPEN,      /**< a: jaw open */
+    ELISA_VISEME_WIDE,      /**< e, i: lips spread */
+    ELISA_VISEME_ROUND,     /**< o, u, w: lips rounded */
+    ELISA_VISEME_TEETH,     /**< s, f, sh: teeth together, hiss */
+    ELISA_VISEME_COUNT,
+} elisa_viseme_t;
+
+/** Result of one window. */
+typedef struct {
+    uint8_t viseme;         /**< elisa_viseme_t */
+    uint16_t level;         /**< Opening, 0 .. ELISA_VISEME_LEVEL_ONE */
+} elisa_viseme_frame_t;
+
+/** Analyzer state; set up with elisa_viseme_init(). */
+typedef struct {
+    uint8_t channels;
+    uint8_t decim;          /* Input frames averaged per analyzed sample */
+    uint16_t block_len;     /* Analyzed samples per Goertzel block */
+    int32_t coeff[ELISA_VISEME_BINS];   /* 2 cos(w), Q14 */
+    int16_t hann[ELISA_VISEME_MAX_BLOCK]; /* Q15 */
+
+    int32_t dec_acc;
+    uint8_t dec_n;
+    uint16_t block_n;
+    uint8_t blocks;
+    int32_t s1[ELISA_VISEME_BINS], s2[ELISA_VISEME_BINS];
+    uint64_t bin_power[ELISA_VISEME_BINS];  /* This window, per block sample^2 */
+    uint64_t energy;        /* Sum of squares this window */
+    uint64_t peak;          /* Decaying peak of the window mean square */
+} elisa_viseme_analyzer_t;
+
+/**
+ * Set up for a stream (interleaved 16-bit PCM).
+ *
+ * @return 0 on success, -1 if the rate is below ELISA_VISEME_MIN_RATE or
+ *         channels is not 1 or 2
+ */
+int elisa_viseme_init(elisa_viseme_analyzer_t *a, uint32_t sample_rate, uint8_t channels);
+
+/** Forget the current window and loudness peak, keeping the stream format. */
+void elisa_viseme_reset(elisa_viseme_analyzer_t *a);
+
+/**
+ * Analyze frames (one sample per channel each). Windows completed by these
+ * frames are stored in out in order; if there are more than max_out, later
+ * ones replace the last.
+ *
+ * @return Windows stored in out
+ */
+size_t elisa_viseme_feed(elisa_viseme_analyzer_t *a, const int16_t *pcm, size_t frames,
+                         elisa_viseme_frame_t *out, size_t max_out);
+
+/** Input frames per window at the analyzer's rate. */
+size_t elisa_viseme_window_frames(const elisa_viseme_analyzer_t *a);
+
+/** Lower-case name of a viseme ("rest", "open", ...). */
+const char *elisa_viseme_name(elisa_viseme_t viseme);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ELISA_VISEME_H */
@@ -12,6 +12,7 @@
 
 #include "elisa_wake_word.h"
 
+#include <atomic>
 #include <cstring>
 #include <cstdlib>
 
@@ -33,6 +34,8 @@ extern "C" {
 /* Embedded model */
 #include "hi_roo_model.h"
 
+#include "elisa_assets.h"
+
 static const char *TAG = "wake_word";
 
 // ── Configuration ───────────────────────────────────────────────────────
@@ -42,9 +45,9 @@ static constexpr int kFeatureCount = 40;          // mel filterbank channels
 static constexpr int kStrideSizeMs = 10;
 static constexpr int kStrideSamples = kSampleRate * kStrideSizeMs / 1000;  // 160
 static constexpr int kModelInputFrames = 3;       // model expects 3 frames per inference
-static constexpr float kProbabilityCutoff = 0.92f; // lowered from 0.94 for better recall
+static constexpr int kProbabilityCutoffPct = 92;   // lowered from 94 for better recall
 static constexpr int kSlidingWindowSize = 7;       // increased from 5 for smoother detection
-static constexpr float kConsecutiveThreshold = 0.85f; // min per-frame prob for consecutive check
+static constexpr int kConsecutiveThresholdPct = 85; // min per-frame prob for consecutive check
 static constexpr int kMinConsecutiveFrames = 3;       // require 3+ frames above threshold
 static constexpr int kMinSlicesBeforeDetect = 74;  // ~740ms minimum before detection
 static constexpr int kTensorArenaSize = 65536;     // bytes for TFLite arena
@@ -76,6 +79,14 @@ static float s_prob_window[kSlidingWindowSize];
 static int s_prob_idx = 0;
 static int s_slices_since_reset = 0;
 
+// Detection thresholds, packed so a live config update swaps all three
+// at once: cutoff % << 16 | per-frame % << 8 | consecutive frames
+static constexpr uint32_t PackThresholds(int cutoff_pct, int frame_pct, int min_frames) {
+    return (uint32_t)cutoff_pct << 16 | (uint32_t)frame_pct << 8 | (uint32_t)min_frames;
+}
+static std::atomic<uint32_t> s_thresholds{
+    PackThresholds(kProbabilityCutoffPct, kConsecutiveThresholdPct, kMinConsecutiveFrames)};
+
 // ── Audio Frontend Init ─────────────────────────────────────────────────
 
 static int init_frontend(void) {
@@ -109,6 +120,26 @@ static int init_frontend(void) {
     return 0;
 }
 
+// ── Model ───────────────────────────────────────────────────────────────
+
+/**
+ * The model to run: wake_word.tflite from the asset image, used in place
+ * from flash, if there is one and it matches its CRC; else the built-in
+ * Hi Roo model. A replacement must be a microWakeWord streaming model
+ * with the same input and ops.
+ */
+static const void *select_model(void) {
+    elisa_asset_t asset;
+    if (elisa_assets_find(ELISA_ASSET_WAKE_MODEL, &asset) == 0) {
+        if (elisa_asset_verify(&asset)) {
+            ESP_LOGI(TAG, "Model: %s (%u bytes)", ELISA_ASSET_WAKE_MODEL, (unsigned)asset.size);
+            return asset.data;
+        }
+        ESP_LOGW(TAG, "%s fails its CRC, using the built-in model", ELISA_ASSET_WAKE_MODEL);
+    }
+    return hi_roo_model;
+}
+
 // ── Public API ──────────────────────────────────────────────────────────
 
 extern "C" int elisa_wake_word_init(void) {
@@ -127,7 +158,7 @@ extern "C" int elisa_wake_word_init(void) {
     }
 
     // Load model
-    const tflite::Model *model = tflite::GetModel(hi_roo_model);
+    const tflite::Model *model = tflite::GetModel(select_model());
     if (model->version() != TFLITE_SCHEMA_VERSION) {
         ESP_LOGE(TAG, "Model schema version mismatch: got %lu, expected %d",
                  model->version(), TFLITE_SCHEMA_VERSION);
@@ -187,8 +218,9 @@ extern "C" int elisa_wake_word_init(void) {
 
     elisa_wake_word_reset();
 
-    ESP_LOGI(TAG, "Wake word detector ready (cutoff=%.2f, window=%d)",
-             kProbabilityCutoff, kSlidingWindowSize);
+    ESP_LOGI(TAG, "Wake word detector ready (cutoff=%lu%%, window=%d)",
+             (unsigned long)(s_thresholds.load(std::memory_order_relaxed) >> 16),
+             kSlidingWindowSize);
     return 0;
 }
 
@@ -261,12 +293,17 @@ extern "C" bool elisa_wake_word_detect(const int16_t *audio, size_t samples) {
 
                 // Check detection: mean threshold + consecutive-frame requirement
                 if (s_slices_since_reset >= kMinSlicesBeforeDetect) {
+                    uint32_t thresholds = s_thresholds.load(std::memory_order_relaxed);
+                    float cutoff = (float)(thresholds >> 16) / 100.0f;
+                    float frame_threshold = (float)((thresholds >> 8) & 0xFF) / 100.0f;
+                    int min_frames = (int)(thresholds & 0xFF);
+
                     float sum = 0.0f;
                     int consecutive = 0;
                     int max_consecutive = 0;
                     for (int w = 0; w < kSlidingWindowSize; w++) {
                         sum += s_prob_window[w];
-                        if (s_prob_window[w] >= kConsecutiveThreshold) {
+                        if (s_prob_window[w] >= frame_threshold) {
                             consecutive++;
                             if (consecutive > max_consecutive) max_consecutive = consecutive;
                         } else {
@@ -275,7 +312,7 @@ extern "C" bool elisa_wake_word_detect(const int16_t *audio, size_t samples) {
                     }
                     float mean_prob = sum / kSlidingWindowSize;
 
-                    if (mean_prob >= kProbabilityCutoff && max_consecutive >= kMinConsecutiveFrames) {
+                    if (mean_prob >= cutoff && max_consecutive >= min_frames) {
                         ESP_LOGI(TAG, "Wake word detected! prob=%.3f consec=%d", mean_prob, max_consecutive);
                         return true;
                     }
@@ -287,6 +324,20 @@ extern "C" bool elisa_wake_word_detect(const int16_t *audio, size_t samples) {
     return false;
 }
 
+extern "C" void elisa_wake_word_set_thresholds(uint8_t cutoff_pct, uint8_t frame_pct,
+                                               uint8_t min_frames) {
+    int cutoff = cutoff_pct ? cutoff_pct : kProbabilityCutoffPct;
+    int frame = frame_pct ? frame_pct : kConsecutiveThresholdPct;
+    int frames = min_frames ? min_frames : kMinConsecutiveFrames;
+    if (cutoff > 100) cutoff = 100;
+    if (frame > 100) frame = 100;
+    if (frames > kSlidingWindowSize) frames = kSlidingWindowSize;
+
+    s_thresholds.store(PackThresholds(cutoff, frame, frames), std::memory_order_relaxed);
+    ESP_LOGI(TAG, "Thresholds: cutoff=%d%% frame=%d%% frames=%d/%d",
+             cutoff, frame, frames, kSlidingWindowSize);
+}
+
 extern "C" void elisa_wake_word_reset(void) {
     memset(s_feature_buffer, 0, sizeof(s_feature_buffer));
     memset(s_prob_window, 0, sizeof(s_prob_window));
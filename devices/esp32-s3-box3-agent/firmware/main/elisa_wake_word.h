@@ -5,6 +5,10 @@
  * Replaces ESP-SR WakeNet with a microWakeWord-trained TFLite model.
  * The model runs streaming inference on 40-channel mel spectrograms
  * extracted from 16kHz mono PCM audio.
+ *
+ * Not in the firmware build yet: the device wakes through ESP-SR WakeNet
+ * in chatgpt_demo's app_sr.c (see elisa_wakenet.h). host/turn_sim runs
+ * this detector as the stand-in behind its simulated WakeNet.
  */
 
 #ifndef ELISA_WAKE_WORD_H
@@ -39,6 +43,17 @@ int elisa_wake_word_init(void);
  */
 bool elisa_wake_word_detect(const int16_t *audio, size_t samples);
 
+/**
+ * Set the detection thresholds. turn_sim's WakeNet sets the cutoff from
+ * the runtime config's wake_cutoff. Takes effect from the next
+ * inference; safe to call from any task.
+ *
+ * @param cutoff_pct Mean probability over the window to fire, % (0 = default 92)
+ * @param frame_pct  Per-frame probability counted as consecutive, % (0 = default 85)
+ * @param min_frames Consecutive frames at frame_pct needed (0 = default 3)
+ */
+void elisa_wake_word_set_thresholds(uint8_t cutoff_pct, uint8_t frame_pct, uint8_t min_frames);
+
 /**
  * Reset the detector state (clear sliding window, feature buffers).
  * Call after detection to prepare for next wake word.
@@ -0,0 +1,112 @@
+/**
+ * @file elisa_wakenet.c
+ * @brief WakeNet fetch hook: wake events, threshold updates and stats.
+ *
+ * elisa_wakenet_fetch() only runs on app_sr.c's detect task, which owns
+ * the AFE. Other tasks hand it a threshold through one atomic and read
+ * the counters under a spinlock.
+ */
+
+#include "elisa_wakenet.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#include "elisa_cancel.h"
+#include "elisa_latency.h"
+
+static const char *TAG = "elisa_wakenet";
+
+/** chatgpt_demo loads a single WakeNet model: wakenet1 */
+#define WAKENET_INDEX 1
+
+/** Range set_wakenet_threshold() accepts */
+#define THRESHOLD_MIN_PCT 40
+#define THRESHOLD_MAX_PCT 99
+
+/** No threshold waiting to be applied */
+#define THRESHOLD_NONE (-1)
+
+// ── Static State ────────────────────────────────────────────────────────
+
+static atomic_int s_threshold_request = THRESHOLD_NONE;
+
+/* Stats (detect task writes, STATS reads) */
+static portMUX_TYPE s_stats_lock = portMUX_INITIALIZER_UNLOCKED;
+static elisa_wakenet_stats_t s_stats;
+static uint32_t s_detections = 0;
+static uint8_t s_threshold_pct = 0;
+static int64_t s_stats_since_us = 0;
+
+// ── Threshold ───────────────────────────────────────────────────────────
+
+static void apply_threshold(const esp_afe_sr_iface_t *afe, esp_afe_sr_data_t *data, int pct) {
+    if (pct == 0) {
+        afe->reset_wakenet_threshold(data, WAKENET_INDEX);
+        ESP_LOGI(TAG, "Threshold: model default");
+    } else {
+        if (pct < THRESHOLD_MIN_PCT) pct = THRESHOLD_MIN_PCT;
+        if (pct > THRESHOLD_MAX_PCT) pct = THRESHOLD_MAX_PCT;
+        afe->set_wakenet_threshold(data, WAKENET_INDEX, (float)pct / 100.0f);
+        ESP_LOGI(TAG, "Threshold: %d%%", pct);
+    }
+
+    portENTER_CRITICAL(&s_stats_lock);
+    s_threshold_pct = (uint8_t)pct;
+    portEXIT_CRITICAL(&s_stats_lock);
+}
+
+void elisa_wakenet_set_threshold(uint8_t threshold_pct) {
+    atomic_store(&s_threshold_request, (int)threshold_pct);
+}
+
+// ── Fetch ───────────────────────────────────────────────────────────────
+
+afe_fetch_result_t *elisa_wakenet_fetch(const esp_afe_sr_iface_t *afe, esp_afe_sr_data_t *data) {
+    int pct = atomic_exchange(&s_threshold_request, THRESHOLD_NONE);
+    if (pct != THRESHOLD_NONE) {
+        apply_threshold(afe, data, pct);
+    }
+
+    int64_t start = esp_timer_get_time();
+    afe_fetch_result_t *res = afe->fetch(data);
+    uint32_t us = (uint32_t)(esp_timer_get_time() - start);
+
+    bool detected = (res != NULL && res->ret_value != ESP_FAIL &&
+                     res->wakeup_state == WAKENET_DETECTED);
+    if (detected) {
+        /* A new wake word supersedes whatever turn is still running */
+        elisa_turn_cancel();
+        elisa_latency_mark_wake();
+    }
+
+    portENTER_CRITICAL(&s_stats_lock);
+    s_stats.frames++;
+    s_stats.fetch_us_total += us;
+    if (us > s_stats.fetch_us_max) s_stats.fetch_us_max = us;
+    if (detected) s_detections++;
+    portEXIT_CRITICAL(&s_stats_lock);
+
+    return res;
+}
+
+// ── Stats ───────────────────────────────────────────────────────────────
+
+void elisa_wakenet_take_stats(elisa_wakenet_stats_t *out) {
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&s_stats_lock);
+    *out = s_stats;
+    out->detections = s_detections;
+    out->threshold_pct = s_threshold_pct;
+    out->interval_us = now - s_stats_since_us;
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_stats_since_us = now;
+    portEXIT_CRITICAL(&s_stats_lock);
+}
@@ -0,0 +1,63 @@
+/**
+ * @file elisa_wakenet.h
+ * @brief Hook on the wake word detector that runs: ESP-SR WakeNet in
+ *        chatgpt_demo's app_sr.c.
+ *
+ * app_sr.c's detect task takes one frame at a time from the AFE (noise
+ * suppression, VAD and WakeNet) with afe_handle->fetch(). build-firmware.sh
+ * routes that call through elisa_wakenet_fetch(), which:
+ *
+ * - on a detection, cancels the turn in progress and marks the wake time
+ *   for the latency histograms (elisa_cancel.h, elisa_latency.h)
+ * - applies a threshold set with elisa_wakenet_set_threshold(). The AFE is
+ *   not thread safe, so a new threshold waits for the detect task's next
+ *   fetch instead of being set from the caller's task.
+ * - counts frames, fetch time and detections for the STATS command
+ */
+
+#ifndef ELISA_WAKENET_H
+#define ELISA_WAKENET_H
+
+#include <stdint.h>
+
+#include "esp_afe_sr_iface.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Drop-in for afe->fetch(data) on the detect task. Same result.
+ */
+afe_fetch_result_t *elisa_wakenet_fetch(const esp_afe_sr_iface_t *afe, esp_afe_sr_data_t *data);
+
+/**
+ * Set the WakeNet detection threshold (runtime config wake_cutoff) from
+ * any task. Takes effect from the detect task's next fetch.
+ *
+ * @param threshold_pct Threshold, %; 0 restores the model's own. WakeNet
+ *                      takes 40-99, so other values are clamped to that.
+ */
+void elisa_wakenet_set_threshold(uint8_t threshold_pct);
+
+/**
+ * WakeNet counters for the interval since the previous
+ * elisa_wakenet_take_stats() call (detections: since boot).
+ */
+typedef struct {
+    uint32_t frames;          /**< AFE frames fetched in the interval */
+    uint64_t fetch_us_total;  /**< Time in fetch(), including waiting for the feed */
+    uint32_t fetch_us_max;    /**< Longest single fetch() */
+    uint32_t detections;      /**< Wake words detected since boot */
+    uint8_t threshold_pct;    /**< Threshold in effect, % (0 = the model's own) */
+    int64_t interval_us;      /**< Length of the interval */
+} elisa_wakenet_stats_t;
+
+/** Read and reset the interval counters. */
+void elisa_wakenet_take_stats(elisa_wakenet_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ELISA_WAKENET_H */
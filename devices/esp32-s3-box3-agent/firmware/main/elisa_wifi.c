@@ -0,0 +1,331 @@
+/**
+ * @file elisa_wifi.c
+ * @brief WiFi station with fast reconnect from an NVS-cached AP.
+ *
+ * Connection is event driven: STA_START and every disconnect call
+ * connect_now(), which picks a directed (cached BSSID + channel) or full
+ * scan config. A failed directed attempt drops the cache for the rest of
+ * the session, so a moved or replaced AP costs one extra attempt.
+ *
+ * Event handlers run on the default event loop task; the cache write after
+ * a new AP is seen happens there too (one small NVS blob).
+ */
+
+#include "elisa_wifi.h"
+
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_event.h"
+#include "esp_netif.h"
+#include "esp_wifi.h"
+#include "nvs.h"
+
+static const char *TAG = "elisa_wifi";
+
+#define NVS_NAMESPACE     "elisa_wifi"
+#define NVS_KEY_AP        "ap"
+#define AP_CACHE_VERSION  1
+
+/** Reconnect back-off after the first immediate retry fails. */
+#define RETRY_DELAY_MS    1000
+
+#define CONNECTED_BIT     BIT0
+
+// ── Static State ────────────────────────────────────────────────────────
+
+/** Last-good AP, persisted in NVS. */
+typedef struct {
+    uint8_t version;
+    uint8_t channel;
+    uint8_t bssid[6];
+    char ssid[33];
+} ap_cache_t;
+
+static esp_netif_t *s_netif = NULL;
+static EventGroupHandle_t s_events = NULL;
+static esp_timer_handle_t s_retry_timer = NULL;
+
+static char s_ssid[33];
+static char s_password[65];
+static bool s_started = false;
+
+static ap_cache_t s_cache;
+static bool s_cache_valid = false;
+/** True when the current attempt targets the cached BSSID/channel. */
+static bool s_directed = false;
+static volatile bool s_connected = false;
+static uint32_t s_failures = 0;
+
+/** Timing: start of the current attempt and of the current outage. */
+static int64_t s_attempt_start_us = 0;
+static int64_t s_dropout_us = 0;
+
+// ── AP Cache ────────────────────────────────────────────────────────────
+
+static void cache_load(void) {
+    nvs_handle_t nvs;
+    if (nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) {
+        return;
+    }
+    size_t len = sizeof(s_cache);
+    if (nvs_get_blob(nvs, NVS_KEY_AP, &s_cache, &len) == ESP_OK &&
+        len == sizeof(s_cache) && s_cache.version == AP_CACHE_VERSION &&
+        s_cache.channel != 0 && strcmp(s_cache.ssid, s_ssid) == 0) {
+        s_cache_valid = true;
+        ESP_LOGI(TAG, "Cached AP %02x:%02x:%02x:%02x:%02x:%02x channel %u",
+                 s_cache.bssid[0], s_cache.bssid[1], s_cache.bssid[2],
+                 s_cache.bssid[3], s_cache.bssid[4], s_cache.bssid[5], s_cache.channel);
+    }
+    nvs_close(nvs);
+}
+
+static void cache_store(const uint8_t bssid[6], uint8_t channel) {
+    if (s_cache_valid && s_cache.channel == channel &&
+        memcmp(s_cache.bssid, bssid, 6) == 0) {
+        return; /* unchanged -- skip the flash write */
+    }
+
+    memset(&s_cache, 0, sizeof(s_cache));
+    s_cache.version = AP_CACHE_VERSION;
+    s_cache.channel = channel;
+    memcpy(s_cache.bssid, bssid, 6);
+    strncpy(s_cache.ssid, s_ssid, sizeof(s_cache.ssid) - 1);
+    s_cache_valid = true;
+
+    nvs_handle_t nvs;
+    if (nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs) != ESP_OK) {
+        ESP_LOGW(TAG, "Cannot open NVS to cache AP");
+        return;
+    }
+    if (nvs_set_blob(nvs, NVS_KEY_AP, &s_cache, sizeof(s_cache)) == ESP_OK) {
+        nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+}
+
+void elisa_wifi_clear_cache(void) {
+    s_cache_valid = false;
+    nvs_handle_t nvs;
+    if (nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs) == ESP_OK) {
+        nvs_erase_key(nvs, NVS_KEY_AP);
+        nvs_commit(nvs);
+        nvs_close(nvs);
+    }
+}
+
+// ── Connect ─────────────────────────────────────────────────────────────
+
+/** Configure the station for a directed or full-scan connect and start it. */
+static void connect_now(void) {
+    wifi_config_t wc;
+    memset(&wc, 0, sizeof(wc));
+    strncpy((char *)wc.sta.ssid, s_ssid, sizeof(wc.sta.ssid));
+    strncpy((char *)wc.sta.password, s_password, sizeof(wc.sta.password));
+    wc.sta.sort_method = WIFI_CONNECT_AP_BY_SIGNAL;
+
+    s_directed = s_cache_valid;
+    if (s_directed) {
+        wc.sta.bssid_set = true;
+        memcpy(wc.sta.bssid, s_cache.bssid, 6);
+        wc.sta.channel = s_cache.channel;
+        wc.sta.scan_method = WIFI_FAST_SCAN;
+    } else {
+        wc.sta.scan_method = WIFI_ALL_CHANNEL_SCAN;
+    }
+
+    esp_wifi_set_config(WIFI_IF_STA, &wc);
+    s_attempt_start_us = esp_timer_get_time();
+    esp_err_t err = esp_wifi_connect();
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "esp_wifi_connect failed: %s", esp_err_to_name(err));
+    }
+}
+
+static void retry_timer_cb(void *arg) {
+    connect_now();
+}
+
+// ── Event Handlers ──────────────────────────────────────────────────────
+
+static void wifi_event_handler(void *arg, esp_event_base_t base, int32_t id, void *data) {
+    switch (id) {
+    case WIFI_EVENT_STA_START:
+        connect_now();
+        break;
+
+    case WIFI_EVENT_STA_CONNECTED: {
+        const wifi_event_sta_connected_t *ev = (const wifi_event_sta_connected_t *)data;
+        ESP_LOGI(TAG, "Associated with %02x:%02x:%02x:%02x:%02x:%02x channel %u in %lld ms (%s)",
+                 ev->bssid[0], ev->bssid[1], ev->bssid[2], ev->bssid[3], ev->bssid[4], ev->bssid[5],
+                 ev->channel, (long long)((esp_timer_get_time() - s_attempt_start_us) / 1000),
+                 s_directed ? "directed" : "full scan");
+        cache_store(ev->bssid, ev->channel);
+        break;
+    }
+
+    case WIFI_EVENT_STA_DISCONNECTED: {
+        const wifi_event_sta_disconnected_t *ev = (const wifi_event_sta_disconnected_t *)data;
+        bool was_connected = s_connected;
+        s_connected = false;
+        xEventGroupClearBits(s_events, CONNECTED_BIT);
+
+        if (was_connected) {
+            /* Dropout: the cached AP is the one we just lost, go straight back */
+            s_dropout_us = esp_timer_get_time();
+            s_failures = 0;
+            ESP_LOGW(TAG, "Disconnected (reason %d) -- reconnecting", ev->reason);
+            connect_now();
+            break;
+        }
+
+        s_failures++;
+        if (s_directed) {
+            /* AP moved channel or was replaced: stop trusting the cache */
+            ESP_LOGW(TAG, "Directed connect failed (reason %d) -- falling back to full scan",
+                     ev->reason);
+            s_cache_valid = false;
+            connect_now();
+        } else if (s_failures <= 1) {
+            connect_now();
+        } else {
+            ESP_LOGW(TAG, "Connect failed (reason %d, attempt %lu) -- retrying in %d ms",
+                     ev->reason, (unsigned long)s_failures, RETRY_DELAY_MS);
+            esp_timer_start_once(s_retry_timer, (uint64_t)RETRY_DELAY_MS * 1000);
+        }
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+static void ip_event_handler(void *arg, esp_event_base_t base, int32_t id, void *data) {
+    if (id != IP_EVENT_STA_GOT_IP) return;
+
+    const ip_event_got_ip_t *ev = (const ip_event_got_ip_t *)data;
+    int64_t now = esp_timer_get_time();
+
+    if (s_dropout_us != 0) {
+        ESP_LOGI(TAG, "Reconnected, IP " IPSTR " -- outage %lld ms",
+                 IP2STR(&ev->ip_info.ip), (long long)((now - s_dropout_us) / 1000));
+        s_dropout_us = 0;
+    } else {
+        ESP_LOGI(TAG, "Got IP " IPSTR " in %lld ms (attempt), %lld ms since boot",
+                 IP2STR(&ev->ip_info.ip), (long long)((now - s_attempt_start_us) / 1000),
+                 (long long)(now / 1000));
+    }
+
+    s_failures = 0;
+    s_connected = true;
+    xEventGroupSetBits(s_events, CONNECTED_BIT);
+}
+
+// ── Static IP ───────────────────────────────────────────────────────────
+
+static void apply_static_ip(const elisa_wifi_static_ip_t *cfg) {
+    esp_netif_ip_info_t info;
+    memset(&info, 0, sizeof(info));
+    info.ip.addr = esp_ip4addr_aton(cfg->ip);
+    info.gw.addr = esp_ip4addr_aton(cfg->gateway);
+    info.netmask.addr = esp_ip4addr_aton(cfg->netmask[0] ? cfg->netmask : "255.255.255.0");
+
+    esp_netif_dhcpc_stop(s_netif);
+    if (esp_netif_set_ip_info(s_netif, &info) != ESP_OK) {
+        ESP_LOGW(TAG, "Invalid static IP %s -- using DHCP", cfg->ip);
+        esp_netif_dhcpc_start(s_netif);
+        return;
+    }
+
+    const char *dns_str = cfg->dns[0] ? cfg->dns : cfg->gateway;
+    esp_netif_dns_info_t dns;
+    memset(&dns, 0, sizeof(dns));
+    dns.ip.type = ESP_IPADDR_TYPE_V4;
+    dns.ip.u_addr.ip4.addr = esp_ip4addr_aton(dns_str);
+    esp_netif_set_dns_info(s_netif, ESP_NETIF_DNS_MAIN, &dns);
+
+    ESP_LOGI(TAG, "Static IP %s gw %s dns %s", cfg->ip, cfg->gateway, dns_str);
+}
+
+// ── Public API ──────────────────────────────────────────────────────────
+
+int elisa_wifi_start(const char *ssid, const char *password,
+                     const elisa_wifi_static_ip_t *static_ip) {
+    if (s_started) return 0;
+    if (ssid == NULL || ssid[0] == '\0') {
+        ESP_LOGE(TAG, "SSID is required");
+        return -1;
+    }
+
+    int64_t t0 = esp_timer_get_time();
+
+    strncpy(s_ssid, ssid, sizeof(s_ssid) - 1);
+    strncpy(s_password, password ? password : "", sizeof(s_password) - 1);
+    s_events = xEventGroupCreate();
+    cache_load();
+
+    esp_timer_create_args_t timer_args = {
+        .callback = retry_timer_cb,
+        .name = "wifi_retry",
+    };
+    if (esp_timer_create(&timer_args, &s_retry_timer) != ESP_OK) {
+        return -1;
+    }
+
+    if (esp_netif_init() != ESP_OK) {
+        return -1;
+    }
+    esp_err_t err = esp_event_loop_create_default();
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        return -1;
+    }
+    s_netif = esp_netif_create_default_wifi_sta();
+
+    wifi_init_config_t init_cfg = WIFI_INIT_CONFIG_DEFAULT();
+    if (esp_wifi_init(&init_cfg) != ESP_OK) {
+        ESP_LOGE(TAG, "esp_wifi_init failed");
+        return -1;
+    }
+    /* Our own cache replaces the driver's NVS copy of the config */
+    esp_wifi_set_storage(WIFI_STORAGE_RAM);
+
+    esp_event_handler_instance_register(WIFI_EVENT, ESP_EVENT_ANY_ID, wifi_event_handler, NULL, NULL);
+    esp_event_handler_instance_register(IP_EVENT, IP_EVENT_STA_GOT_IP, ip_event_handler, NULL, NULL);
+
+    if (static_ip != NULL && static_ip->ip[0] != '\0') {
+        apply_static_ip(static_ip);
+    }
+
+    esp_wifi_set_mode(WIFI_MODE_STA);
+    /* No modem sleep while connecting or streaming audio */
+    esp_wifi_set_ps(WIFI_PS_NONE);
+    if (esp_wifi_start() != ESP_OK) {
+        ESP_LOGE(TAG, "esp_wifi_start failed");
+        return -1;
+    }
+
+    s_started = true;
+    ESP_LOGI(TAG, "WiFi stack started in %lld ms (%s)",
+             (long long)((esp_timer_get_time() - t0) / 1000),
+             s_cache_valid ? "directed connect" : "full scan");
+    return 0;
+}
+
+bool elisa_wifi_is_connected(void) {
+    return s_connected;
+}
+
+bool elisa_wifi_wait_connected(uint32_t timeout_ms) {
+    if (s_events == NULL) return false;
+    TickType_t ticks = (timeout_ms == UINT32_MAX) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    EventBits_t bits = xEventGroupWaitBits(s_events, CONNECTED_BIT, pdFALSE, pdTRUE, ticks);
+    return (bits & CONNECTED_BIT) != 0;
+}
+
+const char *elisa_wifi_get_ssid(void) {
+    return s_ssid;
+}
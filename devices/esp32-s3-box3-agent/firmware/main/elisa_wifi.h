@@ -0,0 +1,79 @@
+/**
+ * @file elisa_wifi.h
+ * @brief WiFi station with fast reconnect from an NVS-cached AP.
+ *
+ * Replaces chatgpt_demo's app_wifi.c (build-firmware.sh installs a shim
+ * that forwards app_network_start() / wifi_connected_already() here).
+ *
+ * After every successful connect the BSSID and channel of the AP are
+ * cached in NVS. The next boot or reconnect after a dropout does a
+ * directed connect to that BSSID on that channel, skipping the all-channel
+ * scan. If the directed connect fails the cache is ignored and a normal
+ * full scan is done.
+ *
+ * Addressing is either a static IP from runtime_config.json or DHCP. For
+ * DHCP, lwIP's CONFIG_LWIP_DHCP_RESTORE_LAST_IP keeps the last lease in
+ * NVS and re-requests it directly (no DISCOVER/OFFER round trip), and
+ * CONFIG_LWIP_DHCP_DOES_ARP_CHECK=n skips the ~1 s duplicate address probe.
+ * build-firmware.sh sets both in sdkconfig.defaults.
+ *
+ * Timing for association, IP and reconnects is logged under "elisa_wifi".
+ */
+
+#ifndef ELISA_WIFI_H
+#define ELISA_WIFI_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Optional static addressing (dotted quad strings). Leave ip empty for DHCP.
+ */
+typedef struct {
+    char ip[16];
+    char gateway[16];
+    char netmask[16];
+    char dns[16];
+} elisa_wifi_static_ip_t;
+
+/**
+ * Start the WiFi station and connect in the background.
+ *
+ * Initializes netif, the default event loop and the WiFi driver, then
+ * returns; connection progress is driven by WiFi/IP events.
+ *
+ * @param ssid      Network SSID
+ * @param password  Network password
+ * @param static_ip Static addressing, or NULL / empty ip for DHCP
+ * @return 0 on success, -1 if the WiFi stack could not be started
+ */
+int elisa_wifi_start(const char *ssid, const char *password,
+                     const elisa_wifi_static_ip_t *static_ip);
+
+/** True while the station is associated and has an IP address. */
+bool elisa_wifi_is_connected(void);
+
+/**
+ * Block until the station has an IP address.
+ *
+ * @param timeout_ms Maximum wait, or UINT32_MAX to wait forever
+ * @return true if connected, false on timeout
+ */
+bool elisa_wifi_wait_connected(uint32_t timeout_ms);
+
+/** SSID the station was started with (empty before elisa_wifi_start()). */
+const char *elisa_wifi_get_ssid(void);
+
+/** Forget the cached AP so the next connect does a full scan. */
+void elisa_wifi_clear_cache(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ELISA_WIFI_H */
@@ -0,0 +1,288 @@
+/**
+ * @file assets_bench.cc
+ * @brief Lookup and read cost of the asset image (elisa_assets_bin.c).
+ *
+ *   assets_bench
+ *       Packs 8 to 4096 synthetic assets into images the way the deploy
+ *       pipeline does (backend utils/runtimeAssetImage.ts), then for each
+ *       size prints the directory check ("mount"), the time per lookup
+ *       and the read throughput, next to the same files opened and read
+ *       with stdio from a temporary directory. Also checks that images
+ *       with an entry outside them are rejected. Exits 1 if any asset is
+ *       not found or does not match its data, or a bad image is accepted.
+ *
+ *   assets_bench elisa_assets.bin
+ *       Checks an image and lists its assets, verifying each CRC.
+ *
+ * Host time is not device time, and a host filesystem is not SPIFFS: on
+ * the BOX-3 compare the `Assets: ... mounted in` and `SPIFFS mounted in`
+ * log lines (elisa_assets.c, elisa_config.c).
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "elisa_assets_bin.h"
+#include "elisa_config_bin.h"
+
+namespace {
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+constexpr int kSizes[] = { 8, 64, 512, 4096 };
+constexpr int kLookupRounds = 200;
+constexpr size_t kAssetBytes = 4096;
+
+struct Asset {
+    std::string name;
+    std::vector<uint8_t> data;
+};
+
+double us_since(Clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+// ── Packing ─────────────────────────────────────────────────────────────
+
+void put32(std::vector<uint8_t> &buf, size_t off, uint32_t v) {
+    for (int i = 0; i < 4; i++) buf[off + i] = (uint8_t)(v >> (8 * i));
+}
+
+void put16(std::vector<uint8_t> &buf, size_t off, uint16_t v) {
+    buf[off] = (uint8_t)v;
+    buf[off + 1] = (uint8_t)(v >> 8);
+}
+
+size_t align_up(size_t n) {
+    return (n + ELISA_ASSETS_ALIGN - 1) / ELISA_ASSETS_ALIGN * ELISA_ASSETS_ALIGN;
+}
+
+/** Same layout as buildAssetImage() in the backend. */
+std::vector<uint8_t> pack(const std::vector<Asset> &assets) {
+    uint32_t buckets = 2;
+    while (buckets < assets.size() * 2) buckets *= 2;
+
+    size_t names_start = sizeof(elisa_assets_header_t) + buckets * sizeof(elisa_asset_entry_t);
+    std::vector<size_t> name_off, data_off;
+    size_t off = names_start;
+    for (const Asset &a : assets) {
+        name_off.push_back(off);
+        off += a.name.size() + 1;
+    }
+    size_t dir_end = align_up(std::max(off, names_start + 1));
+    off = dir_end;
+    for (const Asset &a : assets) {
+        data_off.push_back(off);
+        off = align_up(off + a.data.size());
+    }
+    size_t image_size = assets.empty() ? dir_end : data_off.back() + assets.back().data.size();
+
+    std::vector<uint8_t> buf(image_size);
+    for (size_t i = 0; i < assets.size(); i++) {
+        const Asset &a = assets[i];
+        uint32_t hash = elisa_assets_hash(a.name.c_str());
+        uint32_t b = hash & (buckets - 1);
+        auto entry_at = [&](uint32_t k) { return sizeof(elisa_assets_header_t) + k * sizeof(elisa_asset_entry_t); };
+        while (buf[entry_at(b) + 4] | buf[entry_at(b) + 5] | buf[entry_at(b) + 6] | buf[entry_at(b) + 7]) {
+            b = (b + 1) & (buckets - 1);
+        }
+        size_t e = entry_at(b);
+        put32(buf, e, hash);
+        put32(buf, e + 4, (uint32_t)name_off[i]);
+        put32(buf, e + 8, (uint32_t)data_off[i]);
+        put32(buf, e + 12, (uint32_t)a.data.size());
+        put32(buf, e + 16, elisa_config_crc32(a.data.data(), a.data.size()));
+        memcpy(&buf[name_off[i]], a.name.c_str(), a.name.size());
+        std::copy(a.data.begin(), a.data.end(), buf.begin() + (long)data_off[i]);
+    }
+
+    put32(buf, 0, ELISA_ASSETS_MAGIC);
+    put16(buf, 4, ELISA_ASSETS_VERSION);
+    put16(buf, 6, sizeof(elisa_assets_header_t));
+    put32(buf, 8, (uint32_t)image_size);
+    put16(buf, 12, (uint16_t)buckets);
+    put16(buf, 14, (uint16_t)assets.size());
+    put32(buf, 16, (uint32_t)(dir_end - sizeof(elisa_assets_header_t)));
+    put32(buf, 20, elisa_config_crc32(&buf[sizeof(elisa_assets_header_t)],
+                                      dir_end - sizeof(elisa_assets_header_t)));
+    return buf;
+}
+
+std::vector<Asset> synthesize(int count) {
+    std::vector<Asset> assets;
+    for (int i = 0; i < count; i++) {
+        Asset a;
+        a.name = (i % 2 ? "tts/prompt_" : "earcon/event_") + std::to_string(i) + ".mp3";
+        a.data.resize(kAssetBytes);
+        for (size_t j = 0; j < a.data.size(); j++) a.data[j] = (uint8_t)(i * 31 + j);
+        assets.push_back(std::move(a));
+    }
+    return assets;
+}
+
+// ── Malformed images ────────────────────────────────────────────────────
+
+/**
+ * Rewrite the only entry's data range and re-sign the directory, so only
+ * the bounds checks stand between the image and an out-of-range read.
+ */
+bool accepts_entry(uint32_t data_offset, uint32_t size) {
+    std::vector<uint8_t> image = pack({ Asset{ "a.mp3", std::vector<uint8_t>(16, 0x5A) } });
+    const auto *h = (const elisa_assets_header_t *)image.data();
+    for (uint32_t i = 0; i < h->bucket_count; i++) {
+        size_t e = h->header_size + i * sizeof(elisa_asset_entry_t);
+        if (((const elisa_asset_entry_t *)&image[e])->name_offset == 0) continue;
+        put32(image, e + 8, data_offset);
+        put32(image, e + 12, size);
+    }
+    put32(image, 20, elisa_config_crc32(&image[h->header_size], h->dir_size));
+    return elisa_assets_bin_check(image.data(), image.size()) != nullptr;
+}
+
+int malformed() {
+    struct Case {
+        const char *what;
+        uint32_t data_offset, size;
+    };
+    /* The packed image is 96 bytes, its one asset's data at 80 */
+    const Case cases[] = {
+        { "data past the end of the image", 0x10000000u, 16 },
+        { "data running off the end", 80, 17 },
+    };
+    int accepted = 0;
+    for (const Case &c : cases) {
+        if (accepts_entry(c.data_offset, c.size)) {
+            printf("FAIL: accepted an image with %s\n", c.what);
+            accepted++;
+        }
+    }
+    return accepted;
+}
+
+// ── Benchmark ───────────────────────────────────────────────────────────
+
+int bench() {
+    fs::path dir = fs::temp_directory_path() / "elisa_assets_bench";
+    int failures = 0;
+
+    printf("%6s  %10s  %12s  %12s  %14s  %14s\n", "assets", "check_us", "lookup_ns",
+           "fopen_ns", "image_MB/s", "stdio_MB/s");
+    for (int count : kSizes) {
+        std::vector<Asset> assets = synthesize(count);
+        std::vector<uint8_t> image = pack(assets);
+
+        fs::remove_all(dir);
+        for (const Asset &a : assets) {
+            fs::create_directories((dir / a.name).parent_path());
+            std::ofstream(dir / a.name, std::ios::binary)
+                .write((const char *)a.data.data(), (std::streamsize)a.data.size());
+        }
+
+        auto start = Clock::now();
+        const elisa_assets_header_t *h = elisa_assets_bin_check(image.data(), image.size());
+        double check_us = us_since(start);
+        if (h == nullptr) {
+            printf("%6d  image rejected\n", count);
+            failures++;
+            continue;
+        }
+
+        /* Lookup only; then, after checking every asset, lookup + read every byte */
+        start = Clock::now();
+        for (int r = 0; r < kLookupRounds; r++) {
+            for (const Asset &a : assets) {
+                elisa_asset_t out;
+                if (elisa_assets_bin_find(h, a.name.c_str(), &out) != 0) failures++;
+            }
+        }
+        double lookup_ns = us_since(start) * 1000 / (kLookupRounds * (double)count);
+
+        for (const Asset &a : assets) {
+            elisa_asset_t out;
+            if (elisa_assets_bin_find(h, a.name.c_str(), &out) != 0 || out.size != a.data.size() ||
+                memcmp(out.data, a.data.data(), out.size) != 0 || !elisa_asset_verify(&out)) {
+                failures++;
+            }
+        }
+
+        uint64_t sum = 0;
+        start = Clock::now();
+        for (const Asset &a : assets) {
+            elisa_asset_t out;
+            if (elisa_assets_bin_find(h, a.name.c_str(), &out) != 0) continue;
+            const uint8_t *p = (const uint8_t *)out.data;
+            for (size_t j = 0; j < out.size; j++) sum += p[j];
+        }
+        double image_us = us_since(start);
+
+        start = Clock::now();
+        for (int r = 0; r < kLookupRounds / 10; r++) {
+            for (const Asset &a : assets) {
+                FILE *f = fopen((dir / a.name).string().c_str(), "rb");
+                if (f == nullptr) failures++;
+                else fclose(f);
+            }
+        }
+        double fopen_ns = us_since(start) * 1000 / (kLookupRounds / 10 * (double)count);
+
+        std::vector<uint8_t> buf(kAssetBytes);
+        start = Clock::now();
+        for (const Asset &a : assets) {
+            FILE *f = fopen((dir / a.name).string().c_str(), "rb");
+            if (f == nullptr) continue;
+            size_t n = fread(buf.data(), 1, buf.size(), f);
+            fclose(f);
+            for (size_t j = 0; j < n; j++) sum -= buf[j];
+        }
+        double stdio_us = us_since(start);
+        if (sum != 0) failures++;
+
+        double mb = (double)count * kAssetBytes / 1e6;
+        printf("%6d  %10.1f  %12.1f  %12.1f  %14.1f  %14.1f\n", count, check_us, lookup_ns,
+               fopen_ns, mb / (image_us / 1e6), mb / (stdio_us / 1e6));
+    }
+    fs::remove_all(dir);
+
+    if (failures) printf("FAIL: %d lookups or reads did not match\n", failures);
+    failures += malformed();
+    return failures ? 1 : 0;
+}
+
+int list(const char *path) {
+    std::ifstream in(path, std::ios::binary);
+    std::vector<uint8_t> image((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    const elisa_assets_header_t *h = elisa_assets_bin_check(image.data(), image.size());
+    if (h == nullptr) {
+        printf("%s: not a valid asset image\n", path);
+        return 1;
+    }
+    printf("%s: %u assets, %u buckets, %u bytes\n", path, h->entry_count, h->bucket_count,
+           h->image_size);
+
+    int bad = 0;
+    const auto *entries = (const elisa_asset_entry_t *)(image.data() + h->header_size);
+    for (uint32_t i = 0; i < h->bucket_count; i++) {
+        if (entries[i].name_offset == 0) continue;
+        const char *name = (const char *)image.data() + entries[i].name_offset;
+        elisa_asset_t a;
+        bool ok = elisa_assets_bin_find(h, name, &a) == 0 && elisa_asset_verify(&a);
+        bad += !ok;
+        printf("  %-40s %8u  %s\n", name, entries[i].size, ok ? "ok" : "BAD CRC");
+    }
+    return bad ? 1 : 0;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    return argc > 1 ? list(argv[1]) : bench();
+}
@@ -0,0 +1,233 @@
+/**
+ * @file capture_decode.cc
+ * @brief Decode a recording-mode capture stream into a WAV file.
+ *
+ *   capture_decode capture.bin out.wav
+ *       Reads the raw serial bytes saved during RECORD / STOP (log lines
+ *       and all), decodes PCM16 and RICE frames in order and writes a
+ *       16 kHz mono WAV. Prints frame, loss and compression counts.
+ *
+ *   capture_decode --encode in.wav capture.bin
+ *       Frames a 16 kHz mono 16-bit WAV the way the device does, for
+ *       checking the codec offline (encode, decode, compare).
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "elisa_frame.h"
+#include "elisa_rice.h"
+
+namespace {
+
+constexpr uint32_t kSampleRate = 16000;
+constexpr size_t kBlockSamples = 512;   // ELISA_CAPTURE_FRAME_SAMPLES
+constexpr size_t kMaxBlockSamples = ELISA_FRAME_MAX_PAYLOAD / 2;
+
+bool read_file(const std::string &path, std::vector<uint8_t> &out) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    out.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+bool write_file(const std::string &path, const std::vector<uint8_t> &data) {
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+    return static_cast<bool>(out);
+}
+
+void put_le16(std::vector<uint8_t> &v, uint16_t x) {
+    v.push_back(static_cast<uint8_t>(x));
+    v.push_back(static_cast<uint8_t>(x >> 8));
+}
+
+void put_le32(std::vector<uint8_t> &v, uint32_t x) {
+    put_le16(v, static_cast<uint16_t>(x));
+    put_le16(v, static_cast<uint16_t>(x >> 16));
+}
+
+uint32_t get_le32(const uint8_t *p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+// ── WAV ─────────────────────────────────────────────────────────────────
+
+std::vector<uint8_t> wav_from_pcm(const std::vector<int16_t> &pcm) {
+    uint32_t data_bytes = static_cast<uint32_t>(pcm.size() * 2);
+    std::vector<uint8_t> v;
+    v.reserve(44 + data_bytes);
+    v.insert(v.end(), {'R', 'I', 'F', 'F'});
+    put_le32(v, 36 + data_bytes);
+    v.insert(v.end(), {'W', 'A', 'V', 'E', 'f', 'm', 't', ' '});
+    put_le32(v, 16);
+    put_le16(v, 1);                 // PCM
+    put_le16(v, 1);                 // mono
+    put_le32(v, kSampleRate);
+    put_le32(v, kSampleRate * 2);   // byte rate
+    put_le16(v, 2);                 // block align
+    put_le16(v, 16);                // bits per sample
+    v.insert(v.end(), {'d', 'a', 't', 'a'});
+    put_le32(v, data_bytes);
+    for (int16_t s : pcm) put_le16(v, static_cast<uint16_t>(s));
+    return v;
+}
+
+/** Extract the samples of a 16-bit mono WAV; other formats are rejected. */
+bool pcm_from_wav(const std::vector<uint8_t> &wav, std::vector<int16_t> &pcm) {
+    if (wav.size() < 12 || std::memcmp(wav.data(), "RIFF", 4) != 0 ||
+        std::memcmp(wav.data() + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+    bool format_ok = false;
+    size_t pos = 12;
+    while (pos + 8 <= wav.size()) {
+        const uint8_t *chunk = wav.data() + pos;
+        size_t size = get_le32(chunk + 4);
+        if (pos + 8 + size > wav.size()) size = wav.size() - pos - 8;
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && size >= 16) {
+            uint16_t fmt = static_cast<uint16_t>(chunk[8] | (chunk[9] << 8));
+            uint16_t channels = static_cast<uint16_t>(chunk[10] | (chunk[11] << 8));
+            uint16_t bits = static_cast<uint16_t>(chunk[22] | (chunk[23] << 8));
+            format_ok = (fmt == 1 && channels == 1 && bits == 16);
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            if (!format_ok) return false;
+            pcm.resize(size / 2);
+            for (size_t i = 0; i < pcm.size(); i++) {
+                pcm[i] = static_cast<int16_t>(chunk[8 + 2 * i] | (chunk[9 + 2 * i] << 8));
+            }
+            return true;
+        }
+        pos += 8 + size + (size & 1);
+    }
+    return false;
+}
+
+// ── Commands ────────────────────────────────────────────────────────────
+
+int decode(const std::string &in_path, const std::string &out_path) {
+    std::vector<uint8_t> raw;
+    if (!read_file(in_path, raw)) {
+        std::fprintf(stderr, "cannot read %s\n", in_path.c_str());
+        return 1;
+    }
+
+    std::vector<int16_t> pcm;
+    int16_t block[kMaxBlockSamples];
+    size_t frames = 0, lost = 0, bad_blocks = 0, audio_bytes = 0;
+    size_t status_frames = 0, device_dropped = 0;
+    bool have_seq = false;
+    uint32_t next_seq = 0;
+
+    size_t pos = 0;
+    elisa_frame_t frame;
+    size_t consumed = 0;
+    while (elisa_frame_decode(raw.data() + pos, raw.size() - pos, &frame, &consumed)) {
+        pos += consumed;
+        frames++;
+        if (have_seq && frame.seq != next_seq) {
+            uint32_t gap = frame.seq - next_seq;
+            if (gap < 0x80000000u) lost += gap;  // otherwise a repeat / restart
+        }
+        have_seq = true;
+        next_seq = frame.seq + 1;
+
+        switch (frame.type) {
+        case ELISA_FRAME_PCM16:
+            for (size_t i = 0; i + 1 < frame.len; i += 2) {
+                pcm.push_back(static_cast<int16_t>(frame.payload[i] | (frame.payload[i + 1] << 8)));
+            }
+            audio_bytes += frame.len;
+            break;
+        case ELISA_FRAME_RICE: {
+            int n = elisa_rice_decode(frame.payload, frame.len, block, kMaxBlockSamples);
+            if (n < 0) {
+                bad_blocks++;
+                break;
+            }
+            pcm.insert(pcm.end(), block, block + n);
+            audio_bytes += frame.len;
+            break;
+        }
+        case ELISA_FRAME_STATUS:
+            status_frames++;
+            if (frame.len >= 12) device_dropped = get_le32(frame.payload + 8);
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (!write_file(out_path, wav_from_pcm(pcm))) {
+        std::fprintf(stderr, "cannot write %s\n", out_path.c_str());
+        return 1;
+    }
+
+    double ratio = pcm.empty() ? 0.0 : static_cast<double>(audio_bytes) / (pcm.size() * 2.0);
+    std::printf("frames=%zu status=%zu samples=%zu seconds=%.2f\n", frames, status_frames,
+                pcm.size(), static_cast<double>(pcm.size()) / kSampleRate);
+    std::printf("lost_frames=%zu bad_blocks=%zu device_dropped=%zu\n", lost, bad_blocks,
+                device_dropped);
+    std::printf("audio_bytes=%zu ratio=%.3f\n", audio_bytes, ratio);
+    return (lost || bad_blocks || device_dropped) ? 2 : 0;
+}
+
+int encode(const std::string &in_path, const std::string &out_path) {
+    std::vector<uint8_t> wav;
+    std::vector<int16_t> pcm;
+    if (!read_file(in_path, wav) || !pcm_from_wav(wav, pcm)) {
+        std::fprintf(stderr, "%s is not a readable 16-bit mono WAV\n", in_path.c_str());
+        return 1;
+    }
+
+    std::vector<uint8_t> stream;
+    uint8_t block[ELISA_RICE_MAX_BYTES(kBlockSamples)];
+    uint8_t frame[sizeof(block) + ELISA_FRAME_OVERHEAD];
+    int16_t check[kBlockSamples];
+    size_t audio_bytes = 0;
+    uint32_t seq = 0;
+
+    for (size_t off = 0; off < pcm.size(); off += kBlockSamples) {
+        size_t n = std::min(kBlockSamples, pcm.size() - off);
+        size_t len = elisa_rice_encode(pcm.data() + off, n, block);
+        if (elisa_rice_decode(block, len, check, kBlockSamples) != static_cast<int>(n) ||
+            std::memcmp(check, pcm.data() + off, n * sizeof(int16_t)) != 0) {
+            std::fprintf(stderr, "roundtrip mismatch in block at sample %zu\n", off);
+            return 2;
+        }
+        size_t flen = elisa_frame_encode(frame, ELISA_FRAME_RICE, seq++, block, len);
+        stream.insert(stream.end(), frame, frame + flen);
+        audio_bytes += len;
+    }
+
+    if (!write_file(out_path, stream)) {
+        std::fprintf(stderr, "cannot write %s\n", out_path.c_str());
+        return 1;
+    }
+    double ratio = pcm.empty() ? 0.0 : static_cast<double>(audio_bytes) / (pcm.size() * 2.0);
+    std::printf("samples=%zu audio_bytes=%zu ratio=%.3f\n", pcm.size(), audio_bytes, ratio);
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    if (argc == 4 && std::strcmp(argv[1], "--encode") == 0) {
+        return encode(argv[2], argv[3]);
+    }
+    if (argc == 3) {
+        return decode(argv[1], argv[2]);
+    }
+    std::fprintf(stderr,
+                 "usage: %s capture.bin out.wav\n"
+                 "       %s --encode in.wav capture.bin\n",
+                 argv[0], argv[0]);
+    return 1;
+}
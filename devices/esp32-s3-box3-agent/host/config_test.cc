@@ -0,0 +1,275 @@
+/**
+ * @file config_test.cc
+ * @brief Live config updates (elisa_config_apply_update) against flash
+ *        held in memory.
+ *
+ *   config_test
+ *       Boots elisa_config.c from a runtime_config.json in an asset
+ *       image, applies partial updates the way heartbeat responses carry
+ *       them and checks the config and face that come out. Prints one
+ *       line per failed check and exits 1 if there was any.
+ *
+ * Run by ctest; the ESP-IDF calls elisa_config.c makes are the stand-ins
+ * below, with turn_sim's headers.
+ */
+
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "cJSON.h"
+#include "elisa_assets_bin.h"
+#include "elisa_config.h"
+#include "elisa_config_bin.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_spiffs.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+namespace {
+
+constexpr size_t kAssetsPartitionSize = 64 * 1024;
+constexpr size_t kConfigPartitionSize = 64 * 1024;
+
+const char kConfigJson[] =
+    "{\"agent_id\":\"config-test\",\"api_key\":\"test-key\","
+    "\"runtime_url\":\"http://127.0.0.1:1\",\"wifi_ssid\":\"test\",\"agent_name\":\"Robo\","
+    "\"face_descriptor\":{\"base_shape\":\"square\","
+    "\"eyes\":{\"style\":\"anime\",\"size\":\"large\",\"color\":\"#112233\"},"
+    "\"mouth\":{\"style\":\"cat\"},\"expression\":\"cool\","
+    "\"colors\":{\"face\":\"#abcdef\",\"accent\":\"#010203\"}}}";
+
+int g_failures = 0;
+uint32_t g_changed = 0;
+
+#define CHECK(cond)                                                          \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            fprintf(stderr, "FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);  \
+            g_failures++;                                                    \
+        }                                                                    \
+    } while (0)
+
+// ── Flash ───────────────────────────────────────────────────────────────
+
+struct Partition {
+    esp_partition_t info;
+    std::vector<uint8_t> data;
+};
+
+Partition g_partitions[2];
+
+void put32(std::vector<uint8_t> &buf, size_t off, uint32_t v) {
+    for (int i = 0; i < 4; i++) buf[off + i] = (uint8_t)(v >> (8 * i));
+}
+
+void put16(std::vector<uint8_t> &buf, size_t off, uint16_t v) {
+    buf[off] = (uint8_t)v;
+    buf[off + 1] = (uint8_t)(v >> 8);
+}
+
+/** An asset image holding one file, laid out as buildAssetImage() does. */
+std::vector<uint8_t> pack_one(const char *name, const std::string &data) {
+    const uint32_t buckets = 2;
+    size_t name_off = sizeof(elisa_assets_header_t) + buckets * sizeof(elisa_asset_entry_t);
+    size_t dir_end = (name_off + strlen(name) + 1 + ELISA_ASSETS_ALIGN - 1) /
+                     ELISA_ASSETS_ALIGN * ELISA_ASSETS_ALIGN;
+    std::vector<uint8_t> buf(dir_end + data.size());
+
+    uint32_t hash = elisa_assets_hash(name);
+    size_t e = sizeof(elisa_assets_header_t) + (hash & (buckets - 1)) * sizeof(elisa_asset_entry_t);
+    put32(buf, e, hash);
+    put32(buf, e + 4, (uint32_t)name_off);
+    put32(buf, e + 8, (uint32_t)dir_end);
+    put32(buf, e + 12, (uint32_t)data.size());
+    put32(buf, e + 16, elisa_config_crc32(data.data(), data.size()));
+    memcpy(&buf[name_off], name, strlen(name));
+    memcpy(&buf[dir_end], data.data(), data.size());
+
+    put32(buf, 0, ELISA_ASSETS_MAGIC);
+    put16(buf, 4, ELISA_ASSETS_VERSION);
+    put16(buf, 6, sizeof(elisa_assets_header_t));
+    put32(buf, 8, (uint32_t)buf.size());
+    put16(buf, 12, (uint16_t)buckets);
+    put16(buf, 14, 1);
+    put32(buf, 16, (uint32_t)(dir_end - sizeof(elisa_assets_header_t)));
+    put32(buf, 20, elisa_config_crc32(&buf[sizeof(elisa_assets_header_t)],
+                                      dir_end - sizeof(elisa_assets_header_t)));
+    return buf;
+}
+
+void add_partition(Partition *p, const char *label, int subtype, size_t size,
+                   const std::vector<uint8_t> &contents) {
+    p->info.type = ESP_PARTITION_TYPE_DATA;
+    p->info.subtype = subtype;
+    p->info.size = (uint32_t)size;
+    p->info.erase_size = 4096;
+    snprintf(p->info.label, sizeof(p->info.label), "%s", label);
+    p->data.assign(size, 0xFF);
+    std::copy(contents.begin(), contents.end(), p->data.begin());
+}
+
+Partition *partition_of(const esp_partition_t *part) {
+    for (Partition &p : g_partitions) {
+        if (&p.info == part) return &p;
+    }
+    return nullptr;
+}
+
+// ── Updates ─────────────────────────────────────────────────────────────
+
+void on_change(uint32_t changed, const elisa_runtime_config_t *config, void *arg) {
+    (void)config;
+    (void)arg;
+    g_changed |= changed;
+}
+
+/** Apply a heartbeat's "changes" object; returns the listener's bits. */
+uint32_t apply(const char *changes_json, uint32_t version) {
+    cJSON *changes = cJSON_Parse(changes_json);
+    g_changed = 0;
+    CHECK(elisa_config_apply_update(changes, version) == 0);
+    cJSON_Delete(changes);
+    return g_changed;
+}
+
+}  // namespace
+
+extern "C" {
+
+void sim_log(char level, const char *tag, const char *fmt, ...) {
+    if (level != 'E' && level != 'W') return;
+    va_list ap;
+    va_start(ap, fmt);
+    fprintf(stderr, "%c %s: ", level, tag);
+    vfprintf(stderr, fmt, ap);
+    fputc('\n', stderr);
+    va_end(ap);
+}
+
+void sim_enter_critical(portMUX_TYPE *mux) { (void)mux; }
+void sim_exit_critical(portMUX_TYPE *mux) { (void)mux; }
+
+int64_t esp_timer_get_time(void) { return 0; }
+
+void vTaskDelay(TickType_t ticks) { (void)ticks; }
+
+const char *esp_err_to_name(esp_err_t code) { return code == ESP_OK ? "ESP_OK" : "ESP_FAIL"; }
+
+esp_err_t esp_vfs_spiffs_register(const esp_vfs_spiffs_conf_t *conf) {
+    (void)conf;
+    return ESP_ERR_NOT_FOUND;
+}
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type,
+                                                esp_partition_subtype_t subtype, const char *label) {
+    for (Partition &p : g_partitions) {
+        if (p.info.type == type && p.info.subtype == subtype &&
+            (label == nullptr || strcmp(p.info.label, label) == 0)) {
+            return &p.info;
+        }
+    }
+    return nullptr;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *part, size_t offset, void *dst, size_t size) {
+    Partition *p = partition_of(part);
+    if (p == nullptr || offset + size > p->data.size()) return ESP_ERR_INVALID_ARG;
+    memcpy(dst, &p->data[offset], size);
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t *part, size_t offset, const void *src, size_t size) {
+    Partition *p = partition_of(part);
+    if (p == nullptr || offset + size > p->data.size()) return ESP_ERR_INVALID_ARG;
+    /* NOR flash: a write only clears bits */
+    const uint8_t *in = static_cast<const uint8_t *>(src);
+    for (size_t i = 0; i < size; i++) p->data[offset + i] &= in[i];
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t *part, size_t offset, size_t size) {
+    Partition *p = partition_of(part);
+    if (p == nullptr || offset + size > p->data.size()) return ESP_ERR_INVALID_ARG;
+    memset(&p->data[offset], 0xFF, size);
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_mmap(const esp_partition_t *part, size_t offset, size_t size,
+                             esp_partition_mmap_memory_t memory, const void **out_ptr,
+                             esp_partition_mmap_handle_t *out_handle) {
+    (void)memory;
+    Partition *p = partition_of(part);
+    if (p == nullptr || offset + size > p->data.size()) return ESP_ERR_INVALID_ARG;
+    *out_ptr = &p->data[offset];
+    *out_handle = 0;
+    return ESP_OK;
+}
+
+void esp_partition_munmap(esp_partition_mmap_handle_t handle) { (void)handle; }
+
+}  // extern "C"
+
+int main() {
+    add_partition(&g_partitions[0], ELISA_ASSETS_PARTITION_LABEL, ELISA_ASSETS_PARTITION_SUBTYPE,
+                  kAssetsPartitionSize, pack_one("runtime_config.json", kConfigJson));
+    add_partition(&g_partitions[1], ELISA_CONFIG_PARTITION_LABEL, ELISA_CONFIG_PARTITION_SUBTYPE,
+                  kConfigPartitionSize, {});
+
+    CHECK(elisa_load_config() == 0);
+    CHECK(elisa_config_subscribe(~0u, on_change, nullptr) == 0);
+    const face_descriptor_t *face = elisa_get_face_descriptor();
+    CHECK(face != nullptr);
+    if (face == nullptr) return 1;
+
+    /* One eye key: every other face field stays as deployed */
+    CHECK(apply("{\"face_descriptor\":{\"eyes\":{\"color\":\"#445566\"}}}", 1) ==
+          ELISA_CONFIG_CHANGED_FACE);
+    face = elisa_get_face_descriptor();
+    CHECK(face->eyes.color == 0x445566);
+    CHECK(strcmp(face->eyes.style, "anime") == 0);
+    CHECK(strcmp(face->eyes.size, "large") == 0);
+    CHECK(strcmp(face->base_shape, "square") == 0);
+    CHECK(strcmp(face->mouth.style, "cat") == 0);
+    CHECK(strcmp(face->expression, "cool") == 0);
+    CHECK(face->face_color == 0xabcdef);
+    CHECK(face->accent_color == 0x010203);
+    CHECK(elisa_get_config()->config_version == 1);
+
+    /* The next partial update keeps the previous one */
+    CHECK(apply("{\"face_descriptor\":{\"mouth\":{\"style\":\"line\"}}}", 2) ==
+          ELISA_CONFIG_CHANGED_FACE);
+    face = elisa_get_face_descriptor();
+    CHECK(strcmp(face->mouth.style, "line") == 0);
+    CHECK(face->eyes.color == 0x445566);
+    CHECK(strcmp(face->eyes.style, "anime") == 0);
+
+    /* Keys that are not live are ignored, and leave the face alone */
+    CHECK(apply("{\"agent_name\":\"Dino\",\"display_theme\":\"candy\"}", 3) == 0);
+    face = elisa_get_face_descriptor();
+    CHECK(strcmp(elisa_get_config()->agent_name, "Robo") == 0);
+    CHECK(strcmp(face->mouth.style, "line") == 0);
+    CHECK(strcmp(face->base_shape, "square") == 0);
+
+    /* The same face again changes nothing but the version */
+    CHECK(apply("{\"face_descriptor\":{\"expression\":\"cool\"}}", 4) == 0);
+    CHECK(elisa_get_config()->config_version == 4);
+
+    /* WakeNet's threshold; null puts the model's own back */
+    CHECK(apply("{\"wake_cutoff\":0.8}", 5) == ELISA_CONFIG_CHANGED_WAKE);
+    CHECK(elisa_get_config()->wake_cutoff_pct == 80);
+    CHECK(apply("{\"wake_cutoff\":null}", 6) == ELISA_CONFIG_CHANGED_WAKE);
+    CHECK(elisa_get_config()->wake_cutoff_pct == 0);
+
+    if (g_failures > 0) {
+        fprintf(stderr, "config_test: %d check(s) failed\n", g_failures);
+        return 1;
+    }
+    printf("config_test: ok\n");
+    return 0;
+}
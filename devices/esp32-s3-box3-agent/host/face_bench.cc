@@ -0,0 +1,485 @@
+/**
+ * @file face_bench.cc
+ * @brief Render cost of the face (elisa_face.c) on LVGL without a board.
+ *
+ *   face_bench [--script idle:10000,thinking:3000,...] [--buffer partial|full]
+ *              [--face round,circles,medium,smile,happy] [--png DIR] [-v]
+ *
+ * Builds the firmware's face against LVGL 8.3 with a memory framebuffer
+ * as the panel, and runs LVGL on a simulated 1 ms tick through a script
+ * of face states. SPEAKING posts a synthetic syllable envelope as audio
+ * levels every 20 ms; LIPSYNC posts the same envelope as a rotating
+ * viseme sequence. For every display refresh it records the host time
+ * of the LVGL pass (minus the framebuffer copy standing in for SPI),
+ * the area flushed, and the allocations made by the face or LVGL, then
+ * prints one line per phase:
+ *
+ *   phase=idle ms=10000 frames=<n> render_avg_us=<us> render_p99_us=<us>
+ *     render_max_us=<us> flushes=<n> px_per_frame=<n> allocs=<n>
+ *     alloc_bytes=<bytes> face_ticks=<n> tick_avg_us=<us>
+ *
+ * --png writes every refreshed frame as DIR/frame_<n>_<phase>.png.
+ *
+ * Time is simulated, so a run takes as long as the rendering, and
+ * esp_random() has a fixed seed, so runs of the same revision draw the
+ * same frames. Host time is not device time: compare revisions on the
+ * same machine, and confirm on the BOX-3 with `STATS face_state`.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "lvgl.h"
+
+extern "C" {
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_random.h"
+#include "esp_timer.h"
+#include "elisa_cancel.h"
+#include "elisa_face.h"
+#include "face_bench_hooks.h"
+}
+
+namespace {
+
+constexpr int kScreenW = 320;
+constexpr int kScreenH = 240;
+constexpr int kPartialRows = 100;      // the BSP's default draw buffer height
+constexpr uint32_t kSpeechStepMs = 20; // one lip-sync window
+constexpr double kPi = 3.14159265358979323846;
+
+const char *kDefaultScript =
+    "idle:10000,listening:1000,thinking:3000,speaking:6000,lipsync:6000,error:2000,idle:4000";
+
+// ── Simulated Board ─────────────────────────────────────────────────────
+
+uint32_t g_tick_ms = 0;
+uint32_t g_random = 0x2545F491;
+bool g_verbose = false;
+std::chrono::steady_clock::time_point g_start = std::chrono::steady_clock::now();
+
+/** Allocations by the face (heap_caps) and LVGL (lv_mem), reset per frame. */
+struct Allocs {
+    uint32_t count = 0;
+    uint64_t bytes = 0;
+} g_allocs;
+
+void count_alloc(size_t size) {
+    g_allocs.count++;
+    g_allocs.bytes += size;
+}
+
+// ── Panel ───────────────────────────────────────────────────────────────
+
+std::vector<lv_color_t> g_panel(kScreenW * kScreenH);
+
+/** What the current LVGL pass sent to the panel. */
+struct Pass {
+    uint32_t flushes = 0;
+    uint64_t px = 0;
+    int64_t flush_ns = 0;
+    bool refreshed = false;
+} g_pass;
+
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - g_start).count();
+}
+
+void panel_flush(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *px) {
+    int64_t t0 = now_ns();
+    int w = area->x2 - area->x1 + 1;
+    for (int y = area->y1; y <= area->y2; y++) {
+        std::memcpy(&g_panel[(size_t)y * kScreenW + area->x1], px, w * sizeof(lv_color_t));
+        px += w;
+    }
+    g_pass.flushes++;
+    g_pass.px += (uint64_t)w * (area->y2 - area->y1 + 1);
+    g_pass.flush_ns += now_ns() - t0;
+    lv_disp_flush_ready(drv);
+}
+
+void panel_monitor(lv_disp_drv_t *drv, uint32_t time_ms, uint32_t px) {
+    (void)drv;
+    (void)time_ms;
+    (void)px;
+    g_pass.refreshed = true;
+}
+
+// ── PNG ─────────────────────────────────────────────────────────────────
+
+uint32_t crc32(const uint8_t *p, size_t n, uint32_t crc = 0) {
+    static uint32_t table[256];
+    if (table[1] == 0) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[i] = c;
+        }
+    }
+    crc = ~crc;
+    for (size_t i = 0; i < n; i++) crc = table[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+void put_be32(std::vector<uint8_t> &out, uint32_t v) {
+    for (int s = 24; s >= 0; s -= 8) out.push_back((uint8_t)(v >> s));
+}
+
+void put_chunk(std::vector<uint8_t> &out, const char *type, const std::vector<uint8_t> &data) {
+    put_be32(out, (uint32_t)data.size());
+    size_t start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    put_be32(out, crc32(&out[start], out.size() - start));
+}
+
+/** Write the panel as an RGB PNG (stored deflate blocks: no zlib needed). */
+bool write_png(const std::string &path) {
+    std::vector<uint8_t> raw;
+    raw.reserve((size_t)kScreenH * (1 + kScreenW * 3));
+    for (int y = 0; y < kScreenH; y++) {
+        raw.push_back(0);  // filter: none
+        for (int x = 0; x < kScreenW; x++) {
+            lv_color32_t c;
+            c.full = lv_color_to32(g_panel[(size_t)y * kScreenW + x]);
+            raw.push_back(c.ch.red);
+            raw.push_back(c.ch.green);
+            raw.push_back(c.ch.blue);
+        }
+    }
+
+    std::vector<uint8_t> z = { 0x78, 0x01 };
+    uint32_t a = 1, b = 0;
+    for (uint8_t v : raw) {
+        a = (a + v) % 65521;
+        b = (b + a) % 65521;
+    }
+    for (size_t off = 0; off < raw.size(); off += 65535) {
+        size_t n = std::min<size_t>(65535, raw.size() - off);
+        z.push_back(off + n == raw.size() ? 1 : 0);
+        z.push_back((uint8_t)n);
+        z.push_back((uint8_t)(n >> 8));
+        z.push_back((uint8_t)~n);
+        z.push_back((uint8_t)(~n >> 8));
+        z.insert(z.end(), raw.begin() + off, raw.begin() + off + n);
+    }
+    put_be32(z, (b << 16) | a);
+
+    std::vector<uint8_t> ihdr;
+    put_be32(ihdr, kScreenW);
+    put_be32(ihdr, kScreenH);
+    ihdr.insert(ihdr.end(), { 8, 2, 0, 0, 0 });  // 8-bit RGB
+
+    std::vector<uint8_t> png = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    put_chunk(png, "IHDR", ihdr);
+    put_chunk(png, "IDAT", z);
+    put_chunk(png, "IEND", {});
+
+    FILE *f = std::fopen(path.c_str(), "wb");
+    if (f == nullptr) return false;
+    bool ok = std::fwrite(png.data(), 1, png.size(), f) == png.size();
+    return std::fclose(f) == 0 && ok;
+}
+
+// ── Script ──────────────────────────────────────────────────────────────
+
+enum class Speech { None, Levels, Visemes };
+
+struct Phase {
+    std::string name;
+    face_state_t state;
+    Speech speech;
+    uint32_t ms;
+};
+
+bool parse_script(const std::string &text, std::vector<Phase> &out) {
+    struct Name {
+        const char *name;
+        face_state_t state;
+        Speech speech;
+    };
+    static const Name kNames[] = {
+        { "idle", FACE_STATE_IDLE, Speech::None },
+        { "listening", FACE_STATE_LISTENING, Speech::None },
+        { "thinking", FACE_STATE_THINKING, Speech::None },
+        { "speaking", FACE_STATE_SPEAKING, Speech::Levels },
+        { "lipsync", FACE_STATE_SPEAKING, Speech::Visemes },
+        { "error", FACE_STATE_ERROR, Speech::None },
+    };
+
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t end = text.find(',', pos);
+        if (end == std::string::npos) end = text.size();
+        std::string item = text.substr(pos, end - pos);
+        pos = end + 1;
+
+        size_t colon = item.find(':');
+        if (colon == std::string::npos) return false;
+        std::string name = item.substr(0, colon);
+        long ms = std::strtol(item.c_str() + colon + 1, nullptr, 10);
+        const Name *n = nullptr;
+        for (const Name &k : kNames) {
+            if (name == k.name) n = &k;
+        }
+        if (n == nullptr || ms <= 0) return false;
+        out.push_back({ name, n->state, n->speech, (uint32_t)ms });
+    }
+    return !out.empty();
+}
+
+/**
+ * Synthetic speech loudness at t: 4 syllables a second with a short gap
+ * between them, and a breath pause every 2 s.
+ */
+double speech_level(uint32_t t_ms) {
+    if (t_ms % 2000 >= 1700) return 0.0;
+    double syl = (t_ms % 250) / 180.0;
+    if (syl >= 1.0) return 0.05;
+    double stress = 0.65 + 0.35 * std::sin(2 * kPi * t_ms / 1430.0);
+    return stress * 0.5 * (1 - std::cos(2 * kPi * syl));
+}
+
+void post_speech(Speech speech, uint32_t t_ms) {
+    double level = speech_level(t_ms);
+    if (speech == Speech::Levels) {
+        elisa_face_set_audio_level((float)level);
+        return;
+    }
+    static const elisa_viseme_t kSequence[] = {
+        ELISA_VISEME_OPEN, ELISA_VISEME_WIDE, ELISA_VISEME_CLOSED,
+        ELISA_VISEME_ROUND, ELISA_VISEME_TEETH, ELISA_VISEME_OPEN,
+    };
+    elisa_viseme_t v = (level < 0.02) ? ELISA_VISEME_REST
+                                      : kSequence[(t_ms / 250) % std::size(kSequence)];
+    elisa_face_set_viseme(v, (uint16_t)(level * ELISA_VISEME_LEVEL_ONE));
+}
+
+// ── Report ──────────────────────────────────────────────────────────────
+
+struct PhaseResult {
+    std::vector<uint32_t> render_us;
+    uint32_t flushes = 0;
+    uint64_t px = 0;
+    uint32_t allocs = 0;
+    uint64_t alloc_bytes = 0;
+};
+
+void report(const Phase &phase, PhaseResult &r, const elisa_face_stats_t &fs) {
+    uint64_t total = 0;
+    for (uint32_t us : r.render_us) total += us;
+    size_t n = r.render_us.size();
+    std::sort(r.render_us.begin(), r.render_us.end());
+    uint32_t p99 = n ? r.render_us[std::min(n - 1, n * 99 / 100)] : 0;
+    uint32_t max = n ? r.render_us.back() : 0;
+
+    std::printf("phase=%s ms=%u frames=%zu render_avg_us=%llu render_p99_us=%u "
+                "render_max_us=%u flushes=%u px_per_frame=%llu allocs=%u alloc_bytes=%llu "
+                "face_ticks=%u tick_avg_us=%llu\n",
+                phase.name.c_str(), phase.ms, n,
+                (unsigned long long)(n ? total / n : 0), p99, max, r.flushes,
+                (unsigned long long)(n ? r.px / n : 0), r.allocs,
+                (unsigned long long)r.alloc_bytes, fs.ticks,
+                (unsigned long long)(fs.ticks ? fs.tick_us_total / fs.ticks : 0));
+}
+
+// ── Run ─────────────────────────────────────────────────────────────────
+
+bool parse_face(const std::string &text, face_descriptor_t &d) {
+    char *fields[] = { d.base_shape, d.eyes.style, d.eyes.size, d.mouth.style, d.expression };
+    const size_t sizes[] = { sizeof(d.base_shape), sizeof(d.eyes.style), sizeof(d.eyes.size),
+                             sizeof(d.mouth.style), sizeof(d.expression) };
+    size_t pos = 0;
+    for (int i = 0; i < 5; i++) {
+        size_t end = text.find(',', pos);
+        if ((end == std::string::npos) != (i == 4)) return false;
+        std::string f = text.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+        if (f.empty() || f.size() >= sizes[i]) return false;
+        std::strcpy(fields[i], f.c_str());
+        pos = end + 1;
+    }
+    return true;
+}
+
+int usage(const char *argv0) {
+    std::fprintf(stderr,
+                 "usage: %s [--script name:ms,...] [--buffer partial|full]\n"
+                 "          [--face shape,eyes,size,mouth,expression] [--png DIR] [-v]\n"
+                 "  phases: idle listening thinking speaking lipsync error\n",
+                 argv0);
+    return 2;
+}
+
+}  // namespace
+
+// ── ESP-IDF and Firmware Stand-ins ──────────────────────────────────────
+
+extern "C" {
+
+uint32_t face_bench_tick_ms(void) { return g_tick_ms; }
+
+void *face_bench_lv_malloc(size_t size) {
+    count_alloc(size);
+    return std::malloc(size);
+}
+
+void *face_bench_lv_realloc(void *p, size_t size) {
+    count_alloc(size);
+    return std::realloc(p, size);
+}
+
+void face_bench_lv_free(void *p) { std::free(p); }
+
+void *heap_caps_malloc(size_t size, uint32_t caps) {
+    (void)caps;
+    count_alloc(size);
+    return std::malloc(size);
+}
+
+void *heap_caps_calloc(size_t n, size_t size, uint32_t caps) {
+    (void)caps;
+    count_alloc(n * size);
+    return std::calloc(n, size);
+}
+
+void heap_caps_free(void *p) { std::free(p); }
+
+int64_t esp_timer_get_time(void) { return now_ns() / 1000; }
+
+uint32_t esp_random(void) {
+    g_random ^= g_random << 13;
+    g_random ^= g_random >> 17;
+    g_random ^= g_random << 5;
+    return g_random;
+}
+
+void face_bench_log(char level, const char *tag, const char *fmt, ...) {
+    if (level != 'E' && level != 'W' && !g_verbose) return;
+    std::fprintf(stderr, "%c (%s) ", level, tag);
+    va_list ap;
+    va_start(ap, fmt);
+    std::vfprintf(stderr, fmt, ap);
+    va_end(ap);
+    std::fputc('\n', stderr);
+}
+
+/* The face cancels the turn on a touch; the bench never touches */
+void elisa_turn_cancel(void) {}
+
+}  // extern "C"
+
+int main(int argc, char **argv) {
+    std::string script = kDefaultScript;
+    std::string png_dir;
+    bool full_frame = false;
+    face_descriptor_t face = {};
+    bool custom_face = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--script" && has_value) {
+            script = argv[++i];
+        } else if (arg == "--buffer" && has_value) {
+            std::string v = argv[++i];
+            if (v != "partial" && v != "full") return usage(argv[0]);
+            full_frame = (v == "full");
+        } else if (arg == "--face" && has_value) {
+            if (!parse_face(argv[++i], face)) return usage(argv[0]);
+            face.eyes.color = 0x4361ee;
+            face.face_color = 0xf0f0f0;
+            face.accent_color = 0xffb3ba;
+            custom_face = true;
+        } else if (arg == "--png" && has_value) {
+            png_dir = argv[++i];
+        } else if (arg == "-v") {
+            g_verbose = true;
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    std::vector<Phase> phases;
+    if (!parse_script(script, phases)) return usage(argv[0]);
+
+    /* Display: two draw buffers like the firmware, bands or full frame */
+    lv_init();
+    size_t buf_px = (size_t)kScreenW * (full_frame ? kScreenH : kPartialRows);
+    std::vector<lv_color_t> buf1(buf_px), buf2(buf_px);
+    static lv_disp_draw_buf_t draw_buf;
+    static lv_disp_drv_t drv;
+    lv_disp_draw_buf_init(&draw_buf, buf1.data(), buf2.data(), (uint32_t)buf_px);
+    lv_disp_drv_init(&drv);
+    drv.hor_res = kScreenW;
+    drv.ver_res = kScreenH;
+    drv.draw_buf = &draw_buf;
+    drv.flush_cb = panel_flush;
+    drv.monitor_cb = panel_monitor;
+    lv_disp_drv_register(&drv);
+
+    Allocs before = g_allocs;
+    int64_t t0 = now_ns();
+    if (elisa_face_init(custom_face ? &face : nullptr) != 0) {
+        std::fprintf(stderr, "face init failed\n");
+        return 1;
+    }
+    std::printf("init buffer=%s buffer_px=%zu init_us=%lld allocs=%u alloc_bytes=%llu\n",
+                full_frame ? "full" : "partial", buf_px, (long long)((now_ns() - t0) / 1000),
+                g_allocs.count - before.count,
+                (unsigned long long)(g_allocs.bytes - before.bytes));
+
+    elisa_face_stats_t fs;
+    uint32_t frame = 0;
+    for (const Phase &phase : phases) {
+        PhaseResult r;
+        elisa_face_set_state(phase.state);
+        elisa_face_take_stats(&fs);
+
+        for (uint32_t t = 0; t < phase.ms; t++) {
+            if (phase.speech != Speech::None && t % kSpeechStepMs == 0) {
+                post_speech(phase.speech, t);
+            }
+
+            g_pass = Pass();
+            g_allocs = Allocs();
+            int64_t start = now_ns();
+            lv_timer_handler();
+            int64_t pass_ns = now_ns() - start;
+            g_tick_ms++;
+
+            r.allocs += g_allocs.count;
+            r.alloc_bytes += g_allocs.bytes;
+            if (!g_pass.refreshed) continue;
+
+            r.render_us.push_back((uint32_t)((pass_ns - g_pass.flush_ns) / 1000));
+            r.flushes += g_pass.flushes;
+            r.px += g_pass.px;
+            if (!png_dir.empty()) {
+                char name[64];
+                std::snprintf(name, sizeof(name), "/frame_%05u_%s.png", frame,
+                              phase.name.c_str());
+                if (!write_png(png_dir + name)) {
+                    std::fprintf(stderr, "cannot write %s%s\n", png_dir.c_str(), name);
+                    return 1;
+                }
+            }
+            frame++;
+        }
+
+        elisa_face_take_stats(&fs);
+        report(phase, r, fs);
+    }
+
+    elisa_face_cleanup();
+    return 0;
+}
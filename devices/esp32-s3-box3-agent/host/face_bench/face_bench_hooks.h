@@ -0,0 +1,29 @@
+/**
+ * @file face_bench_hooks.h
+ * @brief face_bench's virtual clock and allocation counters, for lv_conf.h
+ *        and the ESP-IDF shim headers.
+ */
+
+#ifndef FACE_BENCH_HOOKS_H
+#define FACE_BENCH_HOOKS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Simulated milliseconds since start: LVGL's tick (LV_TICK_CUSTOM). */
+uint32_t face_bench_tick_ms(void);
+
+/** LVGL's heap (LV_MEM_CUSTOM), counted per frame. */
+void *face_bench_lv_malloc(size_t size);
+void *face_bench_lv_realloc(void *p, size_t size);
+void face_bench_lv_free(void *p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FACE_BENCH_HOOKS_H */
@@ -0,0 +1,29 @@
+/**
+ * @file esp_heap_caps.h
+ * @brief Host stand-in: one heap, every allocation counted by face_bench.
+ */
+
+#ifndef FACE_BENCH_ESP_HEAP_CAPS_H
+#define FACE_BENCH_ESP_HEAP_CAPS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MALLOC_CAP_DMA       (1 << 3)
+#define MALLOC_CAP_8BIT      (1 << 2)
+#define MALLOC_CAP_SPIRAM    (1 << 10)
+#define MALLOC_CAP_INTERNAL  (1 << 11)
+
+void *heap_caps_malloc(size_t size, uint32_t caps);
+void *heap_caps_calloc(size_t n, size_t size, uint32_t caps);
+void heap_caps_free(void *p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FACE_BENCH_ESP_HEAP_CAPS_H */
@@ -0,0 +1,25 @@
+/**
+ * @file esp_log.h
+ * @brief Host stand-in: errors and warnings to stderr, info with -v.
+ */
+
+#ifndef FACE_BENCH_ESP_LOG_H
+#define FACE_BENCH_ESP_LOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void face_bench_log(char level, const char *tag, const char *fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+
+#define ESP_LOGE(tag, fmt, ...) face_bench_log('E', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) face_bench_log('W', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) face_bench_log('I', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGD(tag, fmt, ...) face_bench_log('D', tag, fmt, ##__VA_ARGS__)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FACE_BENCH_ESP_LOG_H */
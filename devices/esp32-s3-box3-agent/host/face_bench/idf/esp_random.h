@@ -0,0 +1,22 @@
+/**
+ * @file esp_random.h
+ * @brief Host stand-in: a fixed-seed generator, so blink timing and the
+ *        frames it produces repeat from run to run.
+ */
+
+#ifndef FACE_BENCH_ESP_RANDOM_H
+#define FACE_BENCH_ESP_RANDOM_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint32_t esp_random(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FACE_BENCH_ESP_RANDOM_H */
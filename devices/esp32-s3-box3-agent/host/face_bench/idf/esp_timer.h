@@ -0,0 +1,23 @@
+/**
+ * @file esp_timer.h
+ * @brief Host stand-in: real monotonic time, so the face's own tick
+ *        timing (STATS face tick_avg_us) measures host CPU time while
+ *        LVGL runs on the simulated tick.
+ */
+
+#ifndef FACE_BENCH_ESP_TIMER_H
+#define FACE_BENCH_ESP_TIMER_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int64_t esp_timer_get_time(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FACE_BENCH_ESP_TIMER_H */
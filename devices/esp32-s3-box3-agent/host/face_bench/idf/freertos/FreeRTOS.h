@@ -0,0 +1,16 @@
+/**
+ * @file FreeRTOS.h
+ * @brief Host stand-in: the bench runs every task's calls on one thread,
+ *        so critical sections are no-ops.
+ */
+
+#ifndef FACE_BENCH_FREERTOS_H
+#define FACE_BENCH_FREERTOS_H
+
+typedef int portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(mux)      ((void)(mux))
+#define portEXIT_CRITICAL(mux)       ((void)(mux))
+
+#endif /* FACE_BENCH_FREERTOS_H */
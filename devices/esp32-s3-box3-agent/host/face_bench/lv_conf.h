@@ -0,0 +1,33 @@
+/**
+ * @file lv_conf.h
+ * @brief LVGL 8.3 configuration for face_bench.
+ *
+ * Matches the firmware where it changes what the face costs (RGB565 with
+ * swapped bytes, canvas, refresh period); everything else keeps LVGL's
+ * defaults. The tick and the heap go through face_bench so time is
+ * simulated and allocations are counted.
+ */
+
+#ifndef LV_CONF_H
+#define LV_CONF_H
+
+#define LV_COLOR_DEPTH     16
+#define LV_COLOR_16_SWAP   1
+
+#define LV_MEM_CUSTOM              1
+#define LV_MEM_CUSTOM_INCLUDE      "face_bench_hooks.h"
+#define LV_MEM_CUSTOM_ALLOC        face_bench_lv_malloc
+#define LV_MEM_CUSTOM_FREE         face_bench_lv_free
+#define LV_MEM_CUSTOM_REALLOC      face_bench_lv_realloc
+
+#define LV_TICK_CUSTOM                 1
+#define LV_TICK_CUSTOM_INCLUDE         "face_bench_hooks.h"
+#define LV_TICK_CUSTOM_SYS_TIME_EXPR   (face_bench_tick_ms())
+
+#define LV_DISP_DEF_REFR_PERIOD    30
+#define LV_USE_CANVAS              1
+#define LV_USE_LOG                 0
+#define LV_USE_PERF_MONITOR        0
+#define LV_USE_MEM_MONITOR         0
+
+#endif /* LV_CONF_H */
@@ -0,0 +1,448 @@
+/**
+ * @file runtime_stub.cc
+ * @brief Stand-in runtime server and reply fixtures (runtime_stub.h).
+ */
+
+#include "runtime_stub.h"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "cJSON.h"
+
+namespace runtime_stub {
+
+namespace {
+
+constexpr int64_t kIoTimeoutUs = 10 * 1000000;
+constexpr size_t kMaxHeaderBytes = 16 * 1024;
+constexpr size_t kMaxBodyBytes = 4 * 1024 * 1024;
+
+// ── Fixture Helpers ─────────────────────────────────────────────────────
+
+void put_le(std::vector<uint8_t> &out, uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; i++) out.push_back((uint8_t)(v >> (8 * i)));
+}
+
+/** Ogg's CRC-32: polynomial 0x04c11db7, not reflected, zero init. */
+uint32_t ogg_crc(const uint8_t *p, size_t len) {
+    static uint32_t table[256];
+    static bool ready = false;
+    if (!ready) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t r = i << 24;
+            for (int b = 0; b < 8; b++) r = (r & 0x80000000u) ? (r << 1) ^ 0x04c11db7u : r << 1;
+            table[i] = r;
+        }
+        ready = true;
+    }
+    uint32_t crc = 0;
+    for (size_t i = 0; i < len; i++) crc = (crc << 8) ^ table[((crc >> 24) ^ p[i]) & 0xFF];
+    return crc;
+}
+
+void ogg_page(std::vector<uint8_t> &out, uint8_t flags, uint64_t granule, uint32_t sequence,
+              const std::vector<std::vector<uint8_t>> &packets) {
+    constexpr uint32_t kSerial = 0x454C5341;  /* "ELSA" */
+    size_t start = out.size();
+    out.insert(out.end(), { 'O', 'g', 'g', 'S', 0, flags });
+    put_le(out, granule, 8);
+    put_le(out, kSerial, 4);
+    put_le(out, sequence, 4);
+    put_le(out, 0, 4);  /* CRC, filled in below */
+    std::vector<uint8_t> lacing;
+    for (const auto &p : packets) {
+        size_t len = p.size();
+        while (len >= 255) {
+            lacing.push_back(255);
+            len -= 255;
+        }
+        lacing.push_back((uint8_t)len);
+    }
+    out.push_back((uint8_t)lacing.size());
+    out.insert(out.end(), lacing.begin(), lacing.end());
+    for (const auto &p : packets) out.insert(out.end(), p.begin(), p.end());
+    uint32_t crc = ogg_crc(out.data() + start, out.size() - start);
+    for (int i = 0; i < 4; i++) out[start + 22 + i] = (uint8_t)(crc >> (8 * i));
+}
+
+// ── HTTP ────────────────────────────────────────────────────────────────
+
+struct Request {
+    std::string method;
+    std::string path;
+    std::string query;
+    std::string body;
+};
+
+const char *reason(int status) {
+    switch (status) {
+    case 200: return "OK";
+    case 400: return "Bad Request";
+    case 404: return "Not Found";
+    case 413: return "Payload Too Large";
+    default: return "Error";
+    }
+}
+
+bool ends_with(const std::string &s, const char *suffix) {
+    size_t n = strlen(suffix);
+    return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+}  // namespace
+
+// ── Fixtures ────────────────────────────────────────────────────────────
+
+std::vector<uint8_t> ogg_opus(int ms) {
+    constexpr int kPacketMs = 20;
+    constexpr int kPacketsPerPage = 6;
+    constexpr size_t kPacketBytes = 60;
+    constexpr uint16_t kPreSkip = 312;
+
+    std::vector<uint8_t> out;
+    std::vector<uint8_t> head = { 'O', 'p', 'u', 's', 'H', 'e', 'a', 'd', 1, 1 };
+    put_le(head, kPreSkip, 2);
+    put_le(head, 16000, 4);  /* input sample rate */
+    put_le(head, 0, 2);      /* output gain */
+    head.push_back(0);       /* mapping family */
+    ogg_page(out, 0x02, 0, 0, { head });
+
+    static const char kVendor[] = "runtime_stub";
+    std::vector<uint8_t> tags = { 'O', 'p', 'u', 's', 'T', 'a', 'g', 's' };
+    put_le(tags, sizeof(kVendor) - 1, 4);
+    tags.insert(tags.end(), kVendor, kVendor + sizeof(kVendor) - 1);
+    put_le(tags, 0, 4);
+    ogg_page(out, 0x00, 0, 1, { tags });
+
+    int packets = (ms + kPacketMs - 1) / kPacketMs;
+    uint64_t granule = kPreSkip;
+    uint32_t sequence = 2;
+    uint32_t noise = 0x2545F491u;
+    for (int done = 0; done < packets;) {
+        std::vector<std::vector<uint8_t>> page;
+        for (int i = 0; i < kPacketsPerPage && done < packets; i++, done++) {
+            std::vector<uint8_t> packet(kPacketBytes);
+            packet[0] = 0xF8;  /* TOC: CELT fullband 20 ms, mono, one frame */
+            for (size_t b = 1; b < kPacketBytes; b++) {
+                noise ^= noise << 13, noise ^= noise >> 17, noise ^= noise << 5;
+                packet[b] = (uint8_t)noise;
+            }
+            page.push_back(packet);
+            granule += 960;
+        }
+        ogg_page(out, done == packets ? 0x04 : 0x00, granule, sequence++, page);
+    }
+    return out;
+}
+
+std::vector<uint8_t> mp3(int ms) {
+    constexpr size_t kFrameBytes = 96;  /* 144 * 32000 / 48000 */
+    constexpr int kFrameSamples = 1152;
+    int frames = (int)(((int64_t)ms * 48 + kFrameSamples - 1) / kFrameSamples);
+    std::vector<uint8_t> out;
+    out.reserve(frames * kFrameBytes);
+    for (int i = 0; i < frames; i++) {
+        out.insert(out.end(), { 0xFF, 0xFB, 0x14, 0xC0 });
+        out.resize(out.size() + kFrameBytes - 4, 0);
+    }
+    return out;
+}
+
+std::vector<uint8_t> wav(const std::vector<int16_t> &samples) {
+    uint32_t data = (uint32_t)(samples.size() * 2);
+    std::vector<uint8_t> out = { 'R', 'I', 'F', 'F' };
+    put_le(out, 36 + data, 4);
+    out.insert(out.end(), { 'W', 'A', 'V', 'E', 'f', 'm', 't', ' ' });
+    put_le(out, 16, 4);
+    put_le(out, 1, 2);
+    put_le(out, 1, 2);
+    put_le(out, 16000, 4);
+    put_le(out, 32000, 4);
+    put_le(out, 2, 2);
+    put_le(out, 16, 2);
+    out.insert(out.end(), { 'd', 'a', 't', 'a' });
+    put_le(out, data, 4);
+    for (int16_t s : samples) put_le(out, (uint16_t)s, 2);
+    return out;
+}
+
+std::string base64(const std::vector<uint8_t> &data) {
+    static const char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    out.reserve((data.size() + 2) / 3 * 4);
+    for (size_t i = 0; i < data.size(); i += 3) {
+        uint32_t v = (uint32_t)data[i] << 16;
+        if (i + 1 < data.size()) v |= (uint32_t)data[i + 1] << 8;
+        if (i + 2 < data.size()) v |= data[i + 2];
+        out += kAlphabet[v >> 18];
+        out += kAlphabet[(v >> 12) & 63];
+        out += i + 1 < data.size() ? kAlphabet[(v >> 6) & 63] : '=';
+        out += i + 2 < data.size() ? kAlphabet[v & 63] : '=';
+    }
+    return out;
+}
+
+std::string url_encode(const std::string &s) {
+    std::string out;
+    for (unsigned char c : s) {
+        if (isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~') {
+            out += (char)c;
+        } else {
+            char buf[4];
+            snprintf(buf, sizeof(buf), "%%%02X", c);
+            out += buf;
+        }
+    }
+    return out;
+}
+
+// ── Server ──────────────────────────────────────────────────────────────
+
+Server::Server(const Host &host, const Options &options) : host_(host), options_(options) {}
+
+int Server::start(uint16_t port) {
+    listen_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) return -1;
+    int one = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(options_.listen_all ? INADDR_ANY : INADDR_LOOPBACK);
+    socklen_t len = sizeof(addr);
+    if (bind(listen_fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 ||
+        listen(listen_fd_, 256) != 0 ||
+        getsockname(listen_fd_, reinterpret_cast<sockaddr *>(&addr), &len) != 0) {
+        int err = errno;
+        close(listen_fd_);
+        listen_fd_ = -1;
+        errno = err;
+        return -1;
+    }
+    host_.spawn("stub accept", [this] { accept_loop(); });
+    return ntohs(addr.sin_port);
+}
+
+Stats Server::stats() const {
+    std::lock_guard<std::mutex> lk(mutex_);
+    return stats_;
+}
+
+void Server::accept_loop() {
+    while (true) {
+        int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                host_.wait_fd(listen_fd_, POLLIN, INT64_MAX);
+            }
+            continue;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        {
+            std::lock_guard<std::mutex> lk(mutex_);
+            stats_.connections++;
+            stats_.peak_active = std::max(stats_.peak_active, ++stats_.active);
+        }
+        host_.spawn("stub conn", [this, fd] { handle(fd); });
+    }
+}
+
+void Server::handle(int fd) {
+    struct Active {
+        Server *server;
+        ~Active() {
+            std::lock_guard<std::mutex> lk(server->mutex_);
+            server->stats_.active--;
+        }
+    } active{ this };
+
+    auto recv_more = [&](std::string &buf) {
+        char chunk[4096];
+        while (true) {
+            ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+            if (n > 0) {
+                buf.append(chunk, (size_t)n);
+                return true;
+            }
+            if (n == 0) return false;
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) return false;
+            if (host_.wait_fd(fd, POLLIN, host_.now_us() + kIoTimeoutUs) == 0) return false;
+        }
+    };
+    auto send_all = [&](const std::string &data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (n > 0) {
+                sent += (size_t)n;
+            } else if (n < 0 && errno == EINTR) {
+                continue;
+            } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                if (host_.wait_fd(fd, POLLOUT, host_.now_us() + kIoTimeoutUs) == 0) return false;
+            } else {
+                return false;
+            }
+        }
+        return true;
+    };
+    auto respond = [&](int status, const std::string &headers, const std::string &body) {
+        char line[128];
+        snprintf(line, sizeof(line), "HTTP/1.1 %d %s\r\nContent-Length: %zu\r\nConnection: close\r\n",
+                 status, reason(status), body.size());
+        std::string out = line + headers + "\r\n" + body;
+        send_all(out);
+        std::lock_guard<std::mutex> lk(mutex_);
+        stats_.bytes_out += out.size();
+    };
+
+    // Request line, headers, body
+    std::string buf;
+    size_t header_end;
+    while ((header_end = buf.find("\r\n\r\n")) == std::string::npos) {
+        if (buf.size() > kMaxHeaderBytes || !recv_more(buf)) {
+            close(fd);
+            return;
+        }
+    }
+    Request req;
+    size_t content_length = 0;
+    {
+        std::string head = buf.substr(0, header_end);
+        size_t eol = head.find("\r\n");
+        std::string request_line = head.substr(0, eol);
+        size_t sp1 = request_line.find(' ');
+        size_t sp2 = request_line.find(' ', sp1 + 1);
+        req.method = request_line.substr(0, sp1);
+        std::string target = request_line.substr(sp1 + 1, sp2 - sp1 - 1);
+        size_t q = target.find('?');
+        req.path = target.substr(0, q);
+        req.query = q == std::string::npos ? "" : target.substr(q + 1);
+        for (size_t pos = eol; pos != std::string::npos && pos < head.size();) {
+            size_t next = head.find("\r\n", pos + 2);
+            std::string line = head.substr(pos + 2, next == std::string::npos ? std::string::npos
+                                                                             : next - pos - 2);
+            if (strncasecmp(line.c_str(), "Content-Length:", 15) == 0) {
+                content_length = strtoul(line.c_str() + 15, nullptr, 10);
+            }
+            pos = next;
+        }
+    }
+    if (content_length > kMaxBodyBytes) {
+        respond(413, "", "");
+        close(fd);
+        return;
+    }
+    req.body = buf.substr(header_end + 4);
+    while (req.body.size() < content_length) {
+        if (!recv_more(req.body)) {
+            close(fd);
+            return;
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        stats_.bytes_in += header_end + 4 + req.body.size();
+    }
+
+    // Routes
+    if (ends_with(req.path, "/heartbeat")) {
+        if (req.method == "POST") {
+            cJSON *root = cJSON_ParseWithLength(req.body.data(), req.body.size());
+            const cJSON *latency = cJSON_GetObjectItemCaseSensitive(root, "latency");
+            std::lock_guard<std::mutex> lk(mutex_);
+            stats_.heartbeats++;
+            if (cJSON_IsObject(latency)) {
+                stats_.reports_merged++;
+                for (const cJSON *m = latency->child; m != nullptr; m = m->next) {
+                    MergedMetric &merged = stats_.latency[m->string];
+                    const cJSON *count = cJSON_GetObjectItemCaseSensitive(m, "count");
+                    const cJSON *sum = cJSON_GetObjectItemCaseSensitive(m, "sum_ms");
+                    const cJSON *max = cJSON_GetObjectItemCaseSensitive(m, "max_ms");
+                    if (cJSON_IsNumber(count)) merged.count += (uint64_t)count->valuedouble;
+                    if (cJSON_IsNumber(sum)) merged.sum_ms += (uint64_t)sum->valuedouble;
+                    if (cJSON_IsNumber(max) && (uint64_t)max->valuedouble > merged.max_ms) {
+                        merged.max_ms = (uint64_t)max->valuedouble;
+                    }
+                }
+            }
+            cJSON_Delete(root);
+        } else {
+            std::lock_guard<std::mutex> lk(mutex_);
+            stats_.heartbeats++;
+        }
+        respond(200, "Content-Type: application/json\r\n", "{\"status\":\"ok\"}");
+        close(fd);
+        return;
+    }
+
+    if (!ends_with(req.path, "/turn/audio") || req.method != "POST") {
+        respond(404, "", "");
+        close(fd);
+        return;
+    }
+    if (req.body.size() < 44 || req.body.compare(0, 4, "RIFF") != 0 ||
+        req.body.compare(8, 4, "WAVE") != 0) {
+        {
+            std::lock_guard<std::mutex> lk(mutex_);
+            stats_.turn_errors++;
+        }
+        respond(400, "Content-Type: application/json\r\n", "{\"error\":\"expected a WAV body\"}");
+        close(fd);
+        return;
+    }
+
+    // STT + LLM + TTS
+    int think_ms = options_.think_ms;
+    if (options_.think_jitter_ms > 0) {
+        std::lock_guard<std::mutex> lk(mutex_);
+        think_ms += std::uniform_int_distribution<int>(-options_.think_jitter_ms,
+                                                       options_.think_jitter_ms)(rng_);
+    }
+    host_.sleep_until(host_.now_us() + (int64_t)std::max(think_ms, 0) * 1000);
+
+    bool opus = options_.format == Format::kOpus;
+    std::vector<uint8_t> audio = opus ? ogg_opus(options_.reply_ms) : mp3(options_.reply_ms);
+    uint64_t session;
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        session = next_session_++;
+        stats_.turns++;
+    }
+    std::string session_id = "stub-" + std::to_string(session);
+
+    if (req.query.find("response=json") != std::string::npos) {
+        cJSON *root = cJSON_CreateObject();
+        cJSON_AddStringToObject(root, "response_text", options_.reply_text.c_str());
+        cJSON_AddStringToObject(root, "audio_format", opus ? "opus" : "mp3");
+        cJSON_AddStringToObject(root, "audio_base64", base64(audio).c_str());
+        cJSON_AddStringToObject(root, "session_id", session_id.c_str());
+        char *json = cJSON_PrintUnformatted(root);
+        std::string body = json != nullptr ? json : "{}";
+        cJSON_free(json);
+        cJSON_Delete(root);
+        respond(200, "Content-Type: application/json\r\n", body);
+    } else {
+        std::string headers = "Content-Type: application/octet-stream\r\n";
+        headers += std::string("X-Audio-Format: ") + (opus ? "opus" : "mp3") + "\r\n";
+        headers += "X-Response-Text: " + url_encode(options_.reply_text) + "\r\n";
+        headers += "X-Session-Id: " + session_id + "\r\n";
+        respond(200, headers, std::string(audio.begin(), audio.end()));
+    }
+    close(fd);
+}
+
+}  // namespace runtime_stub
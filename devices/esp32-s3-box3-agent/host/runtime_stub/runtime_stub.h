@@ -0,0 +1,122 @@
+/**
+ * @file runtime_stub.h
+ * @brief A stand-in for the Elisa runtime's device endpoints, for host
+ *        tools that need a server to talk to.
+ *
+ * Serves what the firmware calls (elisa_api.c):
+ *
+ *   POST /v1/agents/:id/turn/audio   WAV in; reply audio after think_ms:
+ *                                    binary (Ogg Opus or MP3, metadata in
+ *                                    X-Audio-Format / X-Response-Text /
+ *                                    X-Session-Id) or, with
+ *                                    ?response=json, base64 in JSON
+ *   GET  /v1/agents/:id/heartbeat    {"status":"ok"}
+ *   POST /v1/agents/:id/heartbeat    merges the latency report
+ *
+ * Reply audio is synthetic: valid framing (real Ogg CRCs, MPEG frame
+ * headers) with a placeholder payload, enough for the firmware's parsing
+ * and the stand-in decoders, not for a real codec.
+ *
+ * The server does not own a clock or threads: it runs on a Host, so the
+ * same code serves turn_sim on its simulated clock and the load tools in
+ * real time. One connection, one request (Connection: close).
+ */
+
+#ifndef RUNTIME_STUB_H
+#define RUNTIME_STUB_H
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace runtime_stub {
+
+/** What the server runs on. wait_fd returns 1 when ready, 0 at the deadline. */
+struct Host {
+    std::function<int64_t()> now_us;
+    std::function<void(int64_t deadline_us)> sleep_until;
+    std::function<int(int fd, short events, int64_t deadline_us)> wait_fd;
+    std::function<void(const char *name, std::function<void()> fn)> spawn;
+};
+
+enum class Format { kOpus, kMp3 };
+
+struct Options {
+    int think_ms = 1500;        /**< STT + LLM + TTS time before the reply */
+    int think_jitter_ms = 0;    /**< think_ms varies uniformly by up to this */
+    int reply_ms = 3000;        /**< Length of the reply audio */
+    Format format = Format::kOpus;
+    std::string reply_text = "Hello from the stand-in runtime.";
+    bool listen_all = false;    /**< 0.0.0.0 instead of 127.0.0.1, for a real device */
+};
+
+/** Totals one latency metric across merged heartbeat reports. */
+struct MergedMetric {
+    uint64_t count = 0;
+    uint64_t sum_ms = 0;
+    uint64_t max_ms = 0;
+};
+
+struct Stats {
+    uint64_t connections = 0;
+    uint64_t active = 0;           /**< Connections open now */
+    uint64_t peak_active = 0;
+    uint64_t turns = 0;
+    uint64_t turn_errors = 0;      /**< Rejected turn requests (4xx) */
+    uint64_t heartbeats = 0;       /**< GET and POST */
+    uint64_t reports_merged = 0;
+    uint64_t bytes_in = 0;
+    uint64_t bytes_out = 0;
+    std::map<std::string, MergedMetric> latency;  /**< By metric name */
+};
+
+class Server {
+public:
+    Server(const Host &host, const Options &options);
+
+    /**
+     * Bind @p port on loopback (or every interface with listen_all; 0 =
+     * any free port) and start accepting on a Host task. Returns the bound
+     * port, or -1 with errno set.
+     */
+    int start(uint16_t port);
+
+    Stats stats() const;
+
+private:
+    void accept_loop();
+    void handle(int fd);
+
+    Host host_;
+    Options options_;
+    int listen_fd_ = -1;
+    uint64_t next_session_ = 1;
+    std::mt19937 rng_{ 1 };
+    mutable std::mutex mutex_;
+    Stats stats_;
+};
+
+// ── Fixtures ────────────────────────────────────────────────────────────
+
+/** Mono Ogg Opus of @p ms: OpusHead, OpusTags, 20 ms CELT packets. */
+std::vector<uint8_t> ogg_opus(int ms);
+
+/** MPEG-1 Layer III at 32 kbps / 48 kHz of @p ms (silent frames). */
+std::vector<uint8_t> mp3(int ms);
+
+/** 16 kHz mono 16-bit WAV from @p samples. */
+std::vector<uint8_t> wav(const std::vector<int16_t> &samples);
+
+/** Standard base64 (RFC 4648), padded. */
+std::string base64(const std::vector<uint8_t> &data);
+
+/** Percent-encode everything but unreserved characters. */
+std::string url_encode(const std::string &s);
+
+}  // namespace runtime_stub
+
+#endif /* RUNTIME_STUB_H */
@@ -0,0 +1,643 @@
+/**
+ * @file stub_runtime.cc
+ * @brief The stand-in runtime (runtime_stub/) as a real server, and a load
+ *        generator that plays many BOX-3s against it or a real runtime.
+ *
+ *   stub_runtime serve [options]
+ *       Serves turn/audio and heartbeat for any agent id until killed, and
+ *       prints a STUB line every --report-s seconds: turns and heartbeats
+ *       in the interval, turns per second, connections open and their peak,
+ *       bytes in and out. Point a device's runtime_url at it (with
+ *       --listen-all) to exercise elisa_api.c without the backend.
+ *
+ *       --port N            Port (8787)
+ *       --listen-all        Every interface instead of loopback
+ *       --think-ms N        Time before each reply (1500)
+ *       --jitter-ms N       Vary the think time by up to +-N ms (0)
+ *       --reply-ms N        Reply audio length (3000)
+ *       --format F          Reply format: opus or mp3 (opus)
+ *       --report-s N        STUB line period (10)
+ *
+ *   stub_runtime load [options]
+ *       Runs --devices simulated devices, each doing --turns turns the way
+ *       elisa_api.c does: POST turn/audio?format=wav with a WAV of
+ *       --speech-ms of voiced audio and the 800 ms of quiet that ends a
+ *       recording, read the whole reply, then idle --gap-ms (playback and
+ *       the user's pause) before the next. Every device also POSTs a
+ *       heartbeat with its latency report every --heartbeat-s. Devices
+ *       start evenly spread over one gap. Without --url the stand-in is
+ *       started in-process with the serve options above and its side is
+ *       reported too; with --url (http only) the load goes to that runtime.
+ *
+ *       --url URL           Runtime base URL (in-process stand-in)
+ *       --agent ID          Agent id in the path (load)
+ *       --key KEY           x-api-key (load-key)
+ *       --devices N         Simulated devices (10)
+ *       --turns N           Turns per device (5)
+ *       --speech-ms N       Speech per upload (2000)
+ *       --gap-ms N          Idle between a device's turns (5000)
+ *       --heartbeat-s N     Heartbeat period, 0 for none (60)
+ *       --json              Ask for the JSON reply (&response=json)
+ *       --timeout-s N       Per-request socket timeout (30)
+ *
+ *       Prints client-side percentiles of connect, upload, time to first
+ *       byte (request start to reply headers, so upload + think time),
+ *       download and total, the turns per second achieved, and for the
+ *       in-process stand-in its throughput and peak connections. CPU
+ *       time per turn is split into the simulated devices' threads
+ *       (client) and the rest of the process (server). Exits 1 if any
+ *       turn failed.
+ *
+ * Latency here is host and network latency around a fixed think time;
+ * the stand-in does no STT, LLM or TTS work. What scales with devices is
+ * the server's connection handling and the bytes moved: size a runtime
+ * host from the real backend's per-turn cost plus these numbers.
+ */
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <map>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <random>
+#include <string>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "cJSON.h"
+#include "runtime_stub.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kSampleRate = 16000;
+constexpr int kEndSilenceMs = 800;  /**< app_sr.c stops recording after this much quiet */
+
+int64_t now_us() {
+    static const Clock::time_point start = Clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+}
+
+/** runtime_stub on real threads and the steady clock. */
+runtime_stub::Host real_time_host() {
+    runtime_stub::Host host;
+    host.now_us = now_us;
+    host.sleep_until = [](int64_t deadline_us) {
+        int64_t wait = deadline_us - now_us();
+        if (wait > 0) std::this_thread::sleep_for(std::chrono::microseconds(wait));
+    };
+    host.wait_fd = [](int fd, short events, int64_t deadline_us) {
+        while (true) {
+            int timeout_ms = -1;
+            if (deadline_us != INT64_MAX) {
+                int64_t left = deadline_us - now_us();
+                if (left <= 0) return 0;
+                timeout_ms = (int)std::min<int64_t>((left + 999) / 1000, INT32_MAX);
+            }
+            pollfd p = { fd, events, 0 };
+            int n = poll(&p, 1, timeout_ms);
+            if (n > 0) return 1;
+            if (n < 0 && errno != EINTR) return 1; /* let the caller see the error */
+        }
+    };
+    host.spawn = [](const char *name, std::function<void()> fn) {
+        (void)name;
+        std::thread(std::move(fn)).detach();
+    };
+    return host;
+}
+
+double cpu_seconds() {
+    rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return (double)(ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) +
+           (double)(ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) / 1e6;
+}
+
+/** CPU time of the calling thread: one simulated device's share. */
+double thread_cpu_seconds() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+struct Options {
+    runtime_stub::Options stub;
+    int port = 8787;
+    int report_s = 10;
+
+    std::string url;
+    std::string agent = "load";
+    std::string key = "load-key";
+    int devices = 10;
+    int turns = 5;
+    int speech_ms = 2000;
+    int gap_ms = 5000;
+    int heartbeat_s = 60;
+    bool json = false;
+    int timeout_s = 30;
+};
+
+// ── Serve ───────────────────────────────────────────────────────────────
+
+int serve(const Options &opt) {
+    runtime_stub::Server server(real_time_host(), opt.stub);
+    int port = server.start((uint16_t)opt.port);
+    if (port < 0) {
+        fprintf(stderr, "stub_runtime: port %d: %s\n", opt.port, strerror(errno));
+        return 1;
+    }
+    printf("stub_runtime: listening on %s:%d (think %d ms +-%d, reply %d ms %s)\n",
+           opt.stub.listen_all ? "0.0.0.0" : "127.0.0.1", port, opt.stub.think_ms,
+           opt.stub.think_jitter_ms, opt.stub.reply_ms,
+           opt.stub.format == runtime_stub::Format::kOpus ? "opus" : "mp3");
+    fflush(stdout);
+
+    runtime_stub::Stats last = server.stats();
+    int64_t last_us = now_us();
+    while (true) {
+        std::this_thread::sleep_for(std::chrono::seconds(opt.report_s));
+        runtime_stub::Stats s = server.stats();
+        int64_t t = now_us();
+        double interval_s = (double)(t - last_us) / 1e6;
+        printf("STUB interval_s=%.1f turns=%llu turns_per_s=%.2f turn_errors=%llu heartbeats=%llu "
+               "active=%llu peak_active=%llu in_kB=%.1f out_kB=%.1f\n",
+               interval_s, (unsigned long long)(s.turns - last.turns),
+               (double)(s.turns - last.turns) / interval_s,
+               (unsigned long long)(s.turn_errors - last.turn_errors),
+               (unsigned long long)(s.heartbeats - last.heartbeats), (unsigned long long)s.active,
+               (unsigned long long)s.peak_active, (double)(s.bytes_in - last.bytes_in) / 1024,
+               (double)(s.bytes_out - last.bytes_out) / 1024);
+        fflush(stdout);
+        last = s;
+        last_us = t;
+    }
+}
+
+// ── Load ────────────────────────────────────────────────────────────────
+
+struct Target {
+    sockaddr_in addr = {};
+    std::string host_header;
+    std::string base_path;   /**< /v1/agents/<id>/ */
+};
+
+bool parse_url(const std::string &url, const std::string &agent, Target *out) {
+    const std::string scheme = "http://";
+    if (url.compare(0, scheme.size(), scheme) != 0) return false;
+    std::string rest = url.substr(scheme.size());
+    std::string authority = rest.substr(0, rest.find('/'));
+    std::string prefix = rest.size() > authority.size() ? rest.substr(authority.size()) : "";
+    while (!prefix.empty() && prefix.back() == '/') prefix.pop_back();
+
+    std::string host = authority;
+    int port = 80;
+    size_t colon = authority.rfind(':');
+    if (colon != std::string::npos) {
+        host = authority.substr(0, colon);
+        port = atoi(authority.c_str() + colon + 1);
+    }
+    addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo *res = nullptr;
+    if (getaddrinfo(host.c_str(), nullptr, &hints, &res) != 0 || res == nullptr) return false;
+    out->addr = *reinterpret_cast<sockaddr_in *>(res->ai_addr);
+    out->addr.sin_port = htons((uint16_t)port);
+    freeaddrinfo(res);
+    out->host_header = authority;
+    out->base_path = prefix + "/v1/agents/" + agent + "/";
+    return true;
+}
+
+/** What a device uploads: voiced speech with a syllable envelope, then the quiet tail. */
+std::vector<uint8_t> speech_wav(int speech_ms) {
+    std::mt19937 rng(7);
+    std::normal_distribution<double> noise(0.0, 150.0);
+    std::vector<int16_t> samples;
+    size_t voiced = (size_t)speech_ms * kSampleRate / 1000;
+    size_t quiet = (size_t)kEndSilenceMs * kSampleRate / 1000;
+    for (size_t i = 0; i < voiced + quiet; i++) {
+        double t = (double)i / kSampleRate;
+        double s = noise(rng);
+        if (i < voiced) {
+            double envelope = 0.5 + 0.5 * std::sin(2 * M_PI * 4.0 * t);
+            for (int h = 1; h <= 4; h++) s += envelope * 2500.0 / h * std::sin(2 * M_PI * 140.0 * h * t);
+        }
+        samples.push_back((int16_t)std::max(-32768.0, std::min(32767.0, s)));
+    }
+    return runtime_stub::wav(samples);
+}
+
+enum class Failure { kNone, kConnect, kSend, kReceive, kStatus, kBody };
+
+const char *failure_name(Failure f) {
+    switch (f) {
+    case Failure::kNone: return "none";
+    case Failure::kConnect: return "connect";
+    case Failure::kSend: return "send";
+    case Failure::kReceive: return "receive";
+    case Failure::kStatus: return "status";
+    case Failure::kBody: return "body";
+    }
+    return "?";
+}
+
+struct Exchange {
+    Failure failure = Failure::kNone;
+    int status = 0;
+    double connect_ms = 0;
+    double upload_ms = 0;    /**< Request written */
+    double ttfb_ms = 0;      /**< Request start to reply headers */
+    double download_ms = 0;  /**< Reply headers to last byte */
+    double total_ms = 0;
+    std::map<std::string, std::string> headers;  /**< Lower-case names */
+    std::string body;
+};
+
+double ms_since(int64_t start_us) { return (double)(now_us() - start_us) / 1000.0; }
+
+/** One request on its own connection, as esp_http_client does it. */
+Exchange exchange(const Target &target, int timeout_s, const std::string &head,
+                  const std::vector<uint8_t> &body) {
+    Exchange ex;
+    int64_t start = now_us();
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        ex.failure = Failure::kConnect;
+        return ex;
+    }
+    timeval tv = { timeout_s, 0 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (connect(fd, reinterpret_cast<const sockaddr *>(&target.addr), sizeof(target.addr)) != 0) {
+        ex.failure = Failure::kConnect;
+        close(fd);
+        return ex;
+    }
+    ex.connect_ms = ms_since(start);
+
+    auto send_all = [&](const void *data, size_t len) {
+        const char *p = static_cast<const char *>(data);
+        while (len > 0) {
+            ssize_t n = send(fd, p, len, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            p += n;
+            len -= (size_t)n;
+        }
+        return true;
+    };
+    if (!send_all(head.data(), head.size()) || !send_all(body.data(), body.size())) {
+        ex.failure = Failure::kSend;
+        close(fd);
+        return ex;
+    }
+    ex.upload_ms = ms_since(start);
+
+    std::string buf;
+    char chunk[16384];
+    auto recv_more = [&]() {
+        while (true) {
+            ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            buf.append(chunk, (size_t)n);
+            return true;
+        }
+    };
+    size_t header_end;
+    while ((header_end = buf.find("\r\n\r\n")) == std::string::npos) {
+        if (!recv_more()) {
+            ex.failure = Failure::kReceive;
+            close(fd);
+            return ex;
+        }
+    }
+    ex.ttfb_ms = ms_since(start);
+    int64_t headers_at = now_us();
+
+    std::string head_in = buf.substr(0, header_end);
+    size_t eol = head_in.find("\r\n");
+    sscanf(head_in.c_str(), "HTTP/%*s %d", &ex.status);
+    for (size_t pos = eol; pos != std::string::npos && pos < head_in.size();) {
+        size_t next = head_in.find("\r\n", pos + 2);
+        std::string line = head_in.substr(pos + 2, next == std::string::npos ? std::string::npos
+                                                                             : next - pos - 2);
+        size_t c = line.find(':');
+        if (c != std::string::npos) {
+            std::string name = line.substr(0, c);
+            std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+            size_t v = line.find_first_not_of(' ', c + 1);
+            ex.headers[name] = v == std::string::npos ? "" : line.substr(v);
+        }
+        pos = next;
+    }
+    ex.body = buf.substr(header_end + 4);
+    auto cl = ex.headers.find("content-length");
+    size_t content_length = cl != ex.headers.end() ? strtoul(cl->second.c_str(), nullptr, 10) : SIZE_MAX;
+    while (ex.body.size() < content_length) {
+        buf.clear();
+        if (!recv_more()) break;
+        ex.body += buf;
+    }
+    close(fd);
+    ex.download_ms = ms_since(headers_at);
+    ex.total_ms = ms_since(start);
+    if (content_length != SIZE_MAX && ex.body.size() < content_length) {
+        ex.failure = Failure::kReceive;
+    } else if (ex.status != 200) {
+        ex.failure = Failure::kStatus;
+    }
+    return ex;
+}
+
+/** Reply audio the firmware would accept: Ogg or MPEG framing, either reply variant. */
+bool reply_ok(const Exchange &ex) {
+    std::string format, audio;
+    auto ct = ex.headers.find("content-type");
+    if (ct != ex.headers.end() && ct->second.find("application/octet-stream") != std::string::npos) {
+        auto f = ex.headers.find("x-audio-format");
+        if (f == ex.headers.end()) return false;
+        format = f->second;
+        audio = ex.body;
+    } else {
+        cJSON *root = cJSON_ParseWithLength(ex.body.data(), ex.body.size());
+        const cJSON *f = cJSON_GetObjectItemCaseSensitive(root, "audio_format");
+        const cJSON *b64 = cJSON_GetObjectItemCaseSensitive(root, "audio_base64");
+        bool ok = cJSON_IsString(f) && cJSON_IsString(b64) && b64->valuestring[0] != '\0';
+        if (ok) format = f->valuestring;
+        cJSON_Delete(root);
+        return ok && (format == "opus" || format == "mp3");
+    }
+    if (format == "opus") return audio.compare(0, 4, "OggS") == 0;
+    if (format == "mp3") {
+        return audio.size() >= 3 && (audio.compare(0, 3, "ID3") == 0 || (uint8_t)audio[0] == 0xFF);
+    }
+    return false;
+}
+
+struct DeviceResult {
+    std::vector<Exchange> turns;    /**< Bodies dropped */
+    uint64_t heartbeats = 0;
+    uint64_t heartbeat_failures = 0;
+    double cpu_s = 0;               /**< CPU time of the device's thread */
+};
+
+std::string heartbeat_body(int64_t uptime_us, const std::vector<double> &ttfb_ms) {
+    double sum = 0, max = 0;
+    for (double v : ttfb_ms) {
+        sum += v;
+        max = std::max(max, v);
+    }
+    char buf[256];
+    snprintf(buf, sizeof(buf),
+             "{\"uptime_s\":%lld,\"config_version\":0,\"latency\":{\"ttfb\":{\"count\":%zu,"
+             "\"sum_ms\":%.0f,\"max_ms\":%.0f,\"buckets\":[]}}}",
+             (long long)(uptime_us / 1000000), ttfb_ms.size(), sum, max);
+    return buf;
+}
+
+void run_device(int index, const Options &opt, const Target &target, const std::vector<uint8_t> &wav,
+                int64_t start_us, DeviceResult *out) {
+    std::string turn_path = target.base_path + "turn/audio?format=wav";
+    if (opt.json) turn_path += "&response=json";
+    std::string turn_head = "POST " + turn_path + " HTTP/1.1\r\nHost: " + target.host_header +
+                            "\r\nContent-Type: application/octet-stream\r\nx-api-key: " + opt.key +
+                            "\r\nAccept: audio/opus, application/octet-stream\r\nContent-Length: " +
+                            std::to_string(wav.size()) + "\r\n\r\n";
+    std::string hb_path = target.base_path + "heartbeat";
+
+    auto sleep_until = [](int64_t t) {
+        int64_t wait = t - now_us();
+        if (wait > 0) std::this_thread::sleep_for(std::chrono::microseconds(wait));
+    };
+    int64_t boot = start_us + (int64_t)opt.gap_ms * 1000 * index / std::max(opt.devices, 1);
+    sleep_until(boot);
+    int64_t next_heartbeat = boot + (int64_t)opt.heartbeat_s * 1000000;
+    std::vector<double> unreported_ttfb;
+
+    for (int t = 0; t < opt.turns; t++) {
+        Exchange ex = exchange(target, opt.timeout_s, turn_head, wav);
+        if (ex.failure == Failure::kNone && !reply_ok(ex)) ex.failure = Failure::kBody;
+        if (ex.failure == Failure::kNone) unreported_ttfb.push_back(ex.ttfb_ms);
+        ex.body.clear();
+        ex.headers.clear();
+        out->turns.push_back(std::move(ex));
+
+        int64_t idle_until = now_us() + (int64_t)opt.gap_ms * 1000;
+        while (opt.heartbeat_s > 0 && next_heartbeat <= idle_until) {
+            sleep_until(next_heartbeat);
+            std::string body = heartbeat_body(now_us() - boot, unreported_ttfb);
+            std::string head = "POST " + hb_path + " HTTP/1.1\r\nHost: " + target.host_header +
+                               "\r\nContent-Type: application/json\r\nx-api-key: " + opt.key +
+                               "\r\nContent-Length: " + std::to_string(body.size()) + "\r\n\r\n";
+            Exchange hb = exchange(target, opt.timeout_s, head, std::vector<uint8_t>(body.begin(), body.end()));
+            out->heartbeats++;
+            if (hb.failure != Failure::kNone) out->heartbeat_failures++;
+            unreported_ttfb.clear();
+            next_heartbeat += (int64_t)opt.heartbeat_s * 1000000;
+        }
+        if (t + 1 < opt.turns) sleep_until(idle_until);
+    }
+}
+
+void print_distribution(const char *name, std::vector<double> v) {
+    if (v.empty()) return;
+    std::sort(v.begin(), v.end());
+    auto pct = [&](int p) { return v[std::min(v.size() - 1, (v.size() * p + 99) / 100 - 1)]; };
+    double mean = 0;
+    for (double x : v) mean += x;
+    mean /= (double)v.size();
+    printf("  %-10s p50 %9.1f  p90 %9.1f  p99 %9.1f  max %9.1f  mean %9.1f ms\n", name, pct(50),
+           pct(90), pct(99), v.back(), mean);
+}
+
+int load(const Options &opt) {
+    runtime_stub::Server *server = nullptr;
+    std::string url = opt.url;
+    if (url.empty()) {
+        /* Its accept loop runs until exit: never freed */
+        server = new runtime_stub::Server(real_time_host(), opt.stub);
+        int port = server->start(0);
+        if (port < 0) {
+            fprintf(stderr, "stub_runtime: %s\n", strerror(errno));
+            return 1;
+        }
+        url = "http://127.0.0.1:" + std::to_string(port);
+    }
+    Target target;
+    if (!parse_url(url, opt.agent, &target)) {
+        fprintf(stderr, "stub_runtime: cannot use %s (http://host[:port] only)\n", url.c_str());
+        return 2;
+    }
+    std::vector<uint8_t> wav = speech_wav(opt.speech_ms);
+    printf("stub_runtime: %d devices x %d turns against %s, %zu kB uploads, %s replies\n",
+           opt.devices, opt.turns, url.c_str(), wav.size() / 1024, opt.json ? "JSON" : "binary");
+    fflush(stdout);
+
+    std::vector<DeviceResult> results((size_t)opt.devices);
+    std::vector<std::thread> threads;
+    double cpu_start = cpu_seconds();
+    int64_t start = now_us();
+    for (int i = 0; i < opt.devices; i++) {
+        threads.emplace_back([&, i] {
+            DeviceResult *out = &results[(size_t)i];
+            double thread_start = thread_cpu_seconds();
+            run_device(i, opt, target, wav, start, out);
+            out->cpu_s = thread_cpu_seconds() - thread_start;
+        });
+    }
+    for (std::thread &t : threads) t.join();
+    double wall_s = (double)(now_us() - start) / 1e6;
+    double cpu_s = cpu_seconds() - cpu_start;
+
+    std::vector<double> connect, upload, ttfb, download, total;
+    std::map<std::string, int> failures;
+    uint64_t ok = 0, heartbeats = 0, heartbeat_failures = 0;
+    double client_cpu_s = 0;
+    for (const DeviceResult &d : results) {
+        client_cpu_s += d.cpu_s;
+        heartbeats += d.heartbeats;
+        heartbeat_failures += d.heartbeat_failures;
+        for (const Exchange &ex : d.turns) {
+            if (ex.failure != Failure::kNone) {
+                std::string key = failure_name(ex.failure);
+                if (ex.failure == Failure::kStatus) key += " " + std::to_string(ex.status);
+                failures[key]++;
+                continue;
+            }
+            ok++;
+            connect.push_back(ex.connect_ms);
+            upload.push_back(ex.upload_ms);
+            ttfb.push_back(ex.ttfb_ms);
+            download.push_back(ex.download_ms);
+            total.push_back(ex.total_ms);
+        }
+    }
+
+    uint64_t attempted = (uint64_t)opt.devices * (uint64_t)opt.turns;
+    printf("\n%llu of %llu turns ok in %.1f s (%.2f turns/s), %llu heartbeats (%llu failed)\n",
+           (unsigned long long)ok, (unsigned long long)attempted, wall_s,
+           wall_s > 0 ? (double)ok / wall_s : 0.0, (unsigned long long)heartbeats,
+           (unsigned long long)heartbeat_failures);
+    for (const auto &f : failures) printf("  failed: %-12s %d\n", f.first.c_str(), f.second);
+    if (ok > 0) printf("client latency\n");
+    print_distribution("connect", connect);
+    print_distribution("upload", upload);
+    print_distribution("ttfb", ttfb);
+    print_distribution("download", download);
+    print_distribution("total", total);
+    printf("  client CPU %.3f s, %.2f ms per turn\n", client_cpu_s,
+           ok ? client_cpu_s * 1000 / (double)ok : 0.0);
+
+    if (server != nullptr) {
+        runtime_stub::Stats s = server->stats();
+        printf("stand-in server (think %d ms +-%d, reply %d ms %s)\n", opt.stub.think_ms,
+               opt.stub.think_jitter_ms, opt.stub.reply_ms,
+               opt.stub.format == runtime_stub::Format::kOpus ? "opus" : "mp3");
+        printf("  turns %llu (%.2f/s), rejected %llu, heartbeats %llu, connections %llu, peak open %llu\n",
+               (unsigned long long)s.turns, wall_s > 0 ? (double)s.turns / wall_s : 0.0,
+               (unsigned long long)s.turn_errors, (unsigned long long)s.heartbeats,
+               (unsigned long long)s.connections, (unsigned long long)s.peak_active);
+        printf("  in %.1f kB/s, out %.1f kB/s\n", (double)s.bytes_in / 1024 / wall_s,
+               (double)s.bytes_out / 1024 / wall_s);
+        /* Everything but the device threads: the accept loop and its handlers */
+        double server_cpu_s = std::max(0.0, cpu_s - client_cpu_s);
+        printf("  server CPU %.3f s, %.2f ms per turn\n", server_cpu_s,
+               s.turns ? server_cpu_s * 1000 / (double)s.turns : 0.0);
+    }
+    fflush(stdout);
+    return ok == attempted ? 0 : 1;
+}
+
+// ── Arguments ───────────────────────────────────────────────────────────
+
+bool parse_args(int argc, char **argv, Options *opt) {
+    for (int i = 2; i < argc; i++) {
+        std::string a = argv[i];
+        auto value = [&]() -> const char * { return i + 1 < argc ? argv[++i] : nullptr; };
+        const char *v = nullptr;
+        if (a == "--listen-all") {
+            opt->stub.listen_all = true;
+        } else if (a == "--json") {
+            opt->json = true;
+        } else if (a == "--port" && (v = value())) {
+            opt->port = atoi(v);
+        } else if (a == "--think-ms" && (v = value())) {
+            opt->stub.think_ms = atoi(v);
+        } else if (a == "--jitter-ms" && (v = value())) {
+            opt->stub.think_jitter_ms = atoi(v);
+        } else if (a == "--reply-ms" && (v = value())) {
+            opt->stub.reply_ms = atoi(v);
+        } else if (a == "--format" && (v = value())) {
+            if (strcmp(v, "opus") == 0) {
+                opt->stub.format = runtime_stub::Format::kOpus;
+            } else if (strcmp(v, "mp3") == 0) {
+                opt->stub.format = runtime_stub::Format::kMp3;
+            } else {
+                return false;
+            }
+        } else if (a == "--report-s" && (v = value())) {
+            opt->report_s = atoi(v);
+        } else if (a == "--url" && (v = value())) {
+            opt->url = v;
+        } else if (a == "--agent" && (v = value())) {
+            opt->agent = v;
+        } else if (a == "--key" && (v = value())) {
+            opt->key = v;
+        } else if (a == "--devices" && (v = value())) {
+            opt->devices = atoi(v);
+        } else if (a == "--turns" && (v = value())) {
+            opt->turns = atoi(v);
+        } else if (a == "--speech-ms" && (v = value())) {
+            opt->speech_ms = atoi(v);
+        } else if (a == "--gap-ms" && (v = value())) {
+            opt->gap_ms = atoi(v);
+        } else if (a == "--heartbeat-s" && (v = value())) {
+            opt->heartbeat_s = atoi(v);
+        } else if (a == "--timeout-s" && (v = value())) {
+            opt->timeout_s = atoi(v);
+        } else {
+            return false;
+        }
+    }
+    return opt->port >= 0 && opt->port <= 65535 && opt->report_s > 0 && opt->stub.reply_ms > 0 &&
+           opt->devices > 0 && opt->turns > 0 && opt->speech_ms > 0 && opt->gap_ms >= 0 &&
+           opt->heartbeat_s >= 0 && opt->timeout_s > 0;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    Options opt;
+    std::string mode = argc > 1 ? argv[1] : "";
+    if ((mode != "serve" && mode != "load") || !parse_args(argc, argv, &opt)) {
+        fprintf(stderr,
+                "usage: stub_runtime serve [--port N] [--listen-all] [--think-ms N] [--jitter-ms N]\n"
+                "                          [--reply-ms N] [--format opus|mp3] [--report-s N]\n"
+                "       stub_runtime load [--url URL] [--agent ID] [--key KEY] [--devices N]\n"
+                "                         [--turns N] [--speech-ms N] [--gap-ms N] [--heartbeat-s N]\n"
+                "                         [--json] [--timeout-s N] [serve options]\n");
+        return 2;
+    }
+    signal(SIGPIPE, SIG_IGN);
+    return mode == "serve" ? serve(opt) : load(opt);
+}
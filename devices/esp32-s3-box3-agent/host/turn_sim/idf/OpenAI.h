@@ -0,0 +1,68 @@
+/**
+ * @file OpenAI.h
+ * @brief Host stand-in for the espressif/openai component: enough to
+ *        compile direct API mode. Direct mode is not simulated;
+ *        OpenAICreate() aborts, and turn_sim's config selects runtime mode.
+ */
+
+#ifndef TURN_SIM_OPENAI_H
+#define TURN_SIM_OPENAI_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    OPENAI_AUDIO_RESPONSE_FORMAT_JSON,
+    OPENAI_AUDIO_RESPONSE_FORMAT_TEXT,
+} OpenAI_Audio_Response_Format;
+
+typedef enum {
+    OPENAI_AUDIO_OUTPUT_FORMAT_MP3,
+    OPENAI_AUDIO_OUTPUT_FORMAT_OPUS,
+} OpenAI_Audio_Output_Format;
+
+typedef enum {
+    OPENAI_AUDIO_INPUT_FORMAT_MP3,
+    OPENAI_AUDIO_INPUT_FORMAT_WAV,
+} OpenAI_Audio_Input_Format;
+
+typedef struct OpenAI_SpeechResponse OpenAI_SpeechResponse_t;
+struct OpenAI_SpeechResponse {
+    char *(*getData)(OpenAI_SpeechResponse_t *response);
+    uint32_t (*getLen)(OpenAI_SpeechResponse_t *response);
+    void (*deleteResponse)(OpenAI_SpeechResponse_t *response);
+};
+
+typedef struct OpenAI_AudioTranscription OpenAI_AudioTranscription_t;
+struct OpenAI_AudioTranscription {
+    void (*setResponseFormat)(OpenAI_AudioTranscription_t *stt, OpenAI_Audio_Response_Format format);
+    char *(*file)(OpenAI_AudioTranscription_t *stt, uint8_t *data, size_t len,
+                  OpenAI_Audio_Input_Format format);
+};
+
+typedef struct OpenAI_AudioSpeech OpenAI_AudioSpeech_t;
+struct OpenAI_AudioSpeech {
+    void (*setModel)(OpenAI_AudioSpeech_t *tts, const char *model);
+    void (*setVoice)(OpenAI_AudioSpeech_t *tts, const char *voice);
+    void (*setResponseFormat)(OpenAI_AudioSpeech_t *tts, OpenAI_Audio_Output_Format format);
+    void (*setSpeed)(OpenAI_AudioSpeech_t *tts, float speed);
+    OpenAI_SpeechResponse_t *(*speech)(OpenAI_AudioSpeech_t *tts, const char *text);
+};
+
+typedef struct OpenAI OpenAI_t;
+struct OpenAI {
+    OpenAI_AudioTranscription_t *(*audioTranscriptionCreate)(OpenAI_t *openai);
+    OpenAI_AudioSpeech_t *(*audioSpeechCreate)(OpenAI_t *openai);
+};
+
+OpenAI_t *OpenAICreate(const char *api_key);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TURN_SIM_OPENAI_H */
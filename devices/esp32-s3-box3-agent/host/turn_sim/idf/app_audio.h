@@ -0,0 +1,24 @@
+/**
+ * @file app_audio.h
+ * @brief Host stand-in for chatgpt_demo's audio setup (sim_audio.cc).
+ */
+
+#ifndef TURN_SIM_APP_AUDIO_H
+#define TURN_SIM_APP_AUDIO_H
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*audio_play_finish_cb_t)(void);
+
+esp_err_t audio_record_init(void);
+void audio_register_play_finish_cb(audio_play_finish_cb_t cb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TURN_SIM_APP_AUDIO_H */
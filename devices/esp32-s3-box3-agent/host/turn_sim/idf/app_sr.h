@@ -0,0 +1,30 @@
+/**
+ * @file app_sr.h
+ * @brief Host stand-in for chatgpt_demo's speech pipeline (sim_audio.cc):
+ *        the file-backed mic, elisa_wake_word.cc as the detector, an
+ *        energy VAD for end of speech, and the SR handler that calls
+ *        start_openai().
+ */
+
+#ifndef TURN_SIM_APP_SR_H
+#define TURN_SIM_APP_SR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+esp_err_t app_sr_start(bool record_en);
+
+/** Provided by elisa_main.c, called by the SR handler task. */
+esp_err_t start_openai(uint8_t *audio, int audio_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TURN_SIM_APP_SR_H */
@@ -0,0 +1,27 @@
+/**
+ * @file audio_player.h
+ * @brief Host stand-in for the audio_player component (sim_audio.cc):
+ *        plays WAV or MP3 from a FILE in virtual time on its own task.
+ *        MP3 is not decoded; its length comes from the frame headers.
+ */
+
+#ifndef TURN_SIM_AUDIO_PLAYER_H
+#define TURN_SIM_AUDIO_PLAYER_H
+
+#include <stdio.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Takes ownership of @p fp and closes it when playback ends. */
+esp_err_t audio_player_play(FILE *fp);
+esp_err_t audio_player_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TURN_SIM_AUDIO_PLAYER_H */
@@ -0,0 +1,53 @@
+/**
+ * @file esp-bsp.h
+ * @brief Host stand-in: the BOX-3 display calls app_main makes. There is
+ *        no panel and no LVGL; the face, captions and lip sync are
+ *        stand-ins too (sim_board.cc).
+ */
+
+#ifndef TURN_SIM_BSP_ESP_BSP_H
+#define TURN_SIM_BSP_ESP_BSP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BSP_LCD_H_RES 320
+#define BSP_LCD_V_RES 240
+#define CONFIG_BSP_LCD_DRAW_BUF_HEIGHT 40
+
+typedef struct {
+    int task_priority;
+    int task_stack;
+    int task_affinity;
+    int task_max_sleep_ms;
+    int timer_period_ms;
+} lvgl_port_cfg_t;
+
+#define ESP_LVGL_PORT_INIT_CONFIG() \
+    { .task_priority = 4, .task_stack = 4096, .task_affinity = -1, .task_max_sleep_ms = 500, .timer_period_ms = 5 }
+
+typedef struct {
+    lvgl_port_cfg_t lvgl_port_cfg;
+    uint32_t buffer_size;
+    bool double_buffer;
+    struct {
+        unsigned int buff_dma : 1;
+        unsigned int buff_spiram : 1;
+    } flags;
+} bsp_display_cfg_t;
+
+void *bsp_display_start_with_config(const bsp_display_cfg_t *cfg);
+esp_err_t bsp_display_backlight_on(void);
+esp_err_t bsp_i2c_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TURN_SIM_BSP_ESP_BSP_H */
@@ -0,0 +1,27 @@
+/**
+ * @file bsp_board.h
+ * @brief Host stand-in: chatgpt_demo's board init and the I2S slot type
+ *        elisa_lipsync.h names.
+ */
+
+#ifndef TURN_SIM_BSP_BOARD_H
+#define TURN_SIM_BSP_BOARD_H
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    I2S_SLOT_MODE_MONO = 1,
+    I2S_SLOT_MODE_STEREO = 2,
+} i2s_slot_mode_t;
+
+esp_err_t bsp_board_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TURN_SIM_BSP_BOARD_H */
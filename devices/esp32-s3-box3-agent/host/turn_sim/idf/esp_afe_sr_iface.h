@@ -0,0 +1,45 @@
+/**
+ * @file esp_afe_sr_iface.h
+ * @brief Host stand-in for the ESP-SR AFE interface, as far as
+ *        elisa_wakenet.c and the simulated app_sr (sim_audio.cc) use it.
+ *        The "WakeNet" behind it is elisa_wake_word.cc.
+ */
+
+#ifndef TURN_SIM_ESP_AFE_SR_IFACE_H
+#define TURN_SIM_ESP_AFE_SR_IFACE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    WAKENET_NO_DETECT = 0,
+    WAKENET_CHANNEL_VERIFIED = -1,
+    WAKENET_DETECTED = 1,
+} wakenet_state_t;
+
+typedef struct esp_afe_sr_data_t esp_afe_sr_data_t;
+
+typedef struct {
+    int16_t *data;
+    int data_size;
+    wakenet_state_t wakeup_state;
+    int wake_word_index;
+    int ret_value;
+} afe_fetch_result_t;
+
+typedef struct {
+    afe_fetch_result_t *(*fetch)(esp_afe_sr_data_t *afe);
+    int (*set_wakenet_threshold)(esp_afe_sr_data_t *afe, int index, float threshold);
+    int (*reset_wakenet_threshold)(esp_afe_sr_data_t *afe, int index);
+    int (*disable_wakenet)(esp_afe_sr_data_t *afe);
+    int (*enable_wakenet)(esp_afe_sr_data_t *afe);
+} esp_afe_sr_iface_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TURN_SIM_ESP_AFE_SR_IFACE_H */
@@ -0,0 +1,21 @@
+/**
+ * @file esp_crt_bundle.h
+ * @brief Host stand-in: there is no TLS; https URLs fail to open.
+ */
+
+#ifndef TURN_SIM_ESP_CRT_BUNDLE_H
+#define TURN_SIM_ESP_CRT_BUNDLE_H
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+esp_err_t esp_crt_bundle_attach(void *conf);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TURN_SIM_ESP_CRT_BUNDLE_H */
@@ -0,0 +1,46 @@
+/**
+ * @file esp_err.h
+ * @brief Host stand-in: the error codes the firmware compares against.
+ */
+
+#ifndef TURN_SIM_ESP_ERR_H
+#define TURN_SIM_ESP_ERR_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef int esp_err_t;
+
+#define ESP_OK                     0
+#define ESP_FAIL                   -1
+#define ESP_ERR_NO_MEM             0x101
+#define ESP_ERR_INVALID_ARG        0x102
+#define ESP_ERR_INVALID_STATE      0x103
+#define ESP_ERR_INVALID_SIZE       0x104
+#define ESP_ERR_NOT_FOUND          0x105
+#define ESP_ERR_NOT_SUPPORTED      0x106
+#define ESP_ERR_TIMEOUT            0x107
+#define ESP_ERR_NVS_BASE           0x1100
+#define ESP_ERR_NVS_NO_FREE_PAGES  (ESP_ERR_NVS_BASE + 0x0d)
+#define ESP_ERR_NVS_NEW_VERSION_FOUND (ESP_ERR_NVS_BASE + 0x10)
+
+const char *esp_err_to_name(esp_err_t code);
+
+/** Abort with the failing expression, as ESP-IDF does. */
+void sim_error_check_failed(esp_err_t rc, const char *file, int line, const char *expr);
+
+#define ESP_ERROR_CHECK(x) do {                                          \
+        esp_err_t err_rc_ = (x);                                         \
+        if (err_rc_ != ESP_OK) {                                         \
+            sim_error_check_failed(err_rc_, __FILE__, __LINE__, #x);     \
+        }                                                                \
+    } while (0)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TURN_SIM_ESP_ERR_H */
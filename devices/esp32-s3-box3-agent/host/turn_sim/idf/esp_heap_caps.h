@@ -0,0 +1,46 @@
+/**
+ * @file esp_heap_caps.h
+ * @brief Host stand-in: two capped pools, internal RAM and PSRAM, with
+ *        per-pool use and watermarks (sim_heap.cc). No fragmentation:
+ *        the largest free block is all that is free.
+ */
+
+#ifndef TURN_SIM_ESP_HEAP_CAPS_H
+#define TURN_SIM_ESP_HEAP_CAPS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MALLOC_CAP_EXEC      (1 << 0)
+#define MALLOC_CAP_32BIT     (1 << 1)
+#define MALLOC_CAP_8BIT      (1 << 2)
+#define MALLOC_CAP_DMA       (1 << 3)
+#define MALLOC_CAP_SPIRAM    (1 << 10)
+#define MALLOC_CAP_INTERNAL  (1 << 11)
+#define MALLOC_CAP_DEFAULT   (1 << 12)
+
+typedef void (*esp_alloc_failed_hook_t)(size_t size, uint32_t caps, const char *function_name);
+
+void *heap_caps_malloc(size_t size, uint32_t caps);
+void *heap_caps_calloc(size_t n, size_t size, uint32_t caps);
+void *heap_caps_realloc(void *p, size_t size, uint32_t caps);
+void heap_caps_free(void *p);
+
+size_t heap_caps_get_total_size(uint32_t caps);
+size_t heap_caps_get_free_size(uint32_t caps);
+size_t heap_caps_get_largest_free_block(uint32_t caps);
+size_t heap_caps_get_minimum_free_size(uint32_t caps);
+
+esp_err_t heap_caps_register_failed_alloc_callback(esp_alloc_failed_hook_t callback);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TURN_SIM_ESP_HEAP_CAPS_H */
@@ -0,0 +1,28 @@
+/**
+ * @file esp_log.h
+ * @brief Host stand-in: lines to stderr stamped with the virtual time,
+ *        warnings and errors only unless turn_sim runs with -v.
+ */
+
+#ifndef TURN_SIM_ESP_LOG_H
+#define TURN_SIM_ESP_LOG_H
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void sim_log(char level, const char *tag, const char *fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+
+#define ESP_LOGE(tag, fmt, ...) sim_log('E', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) sim_log('W', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) sim_log('I', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGD(tag, fmt, ...) sim_log('D', tag, fmt, ##__VA_ARGS__)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TURN_SIM_ESP_LOG_H */
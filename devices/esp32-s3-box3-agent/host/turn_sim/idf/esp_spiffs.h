@@ -0,0 +1,33 @@
+/**
+ * @file esp_spiffs.h
+ * @brief Host stand-in: there is no SPIFFS partition, so the config
+ *        comes from the config image or the asset image.
+ */
+
+#ifndef TURN_SIM_ESP_SPIFFS_H
+#define TURN_SIM_ESP_SPIFFS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    const char *base_path;
+    const char *partition_label;
+    size_t max_files;
+    bool format_if_mount_failed;
+} esp_vfs_spiffs_conf_t;
+
+/** Always ESP_ERR_NOT_FOUND. */
+esp_err_t esp_vfs_spiffs_register(const esp_vfs_spiffs_conf_t *conf);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TURN_SIM_ESP_SPIFFS_H */
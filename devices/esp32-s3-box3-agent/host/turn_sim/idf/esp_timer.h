@@ -0,0 +1,21 @@
+/**
+ * @file esp_timer.h
+ * @brief Host stand-in: microseconds on the simulated clock (sim.h).
+ */
+
+#ifndef TURN_SIM_ESP_TIMER_H
+#define TURN_SIM_ESP_TIMER_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int64_t esp_timer_get_time(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TURN_SIM_ESP_TIMER_H */
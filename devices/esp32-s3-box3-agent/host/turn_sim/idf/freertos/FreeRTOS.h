@@ -0,0 +1,69 @@
+/**
+ * @file FreeRTOS.h
+ * @brief Host stand-in: the FreeRTOS types and macros the firmware uses,
+ *        over host threads on the simulated clock (sim_freertos.cc).
+ *
+ * Tick rate is 1 kHz as on the BOX-3 build. Every critical section takes
+ * one global recursive lock, the host equivalent of masking interrupts on
+ * both cores: short, never blocking, never nested in another lock.
+ */
+
+#ifndef TURN_SIM_FREERTOS_H
+#define TURN_SIM_FREERTOS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uint8_t StackType_t;
+
+#define pdFALSE 0
+#define pdTRUE  1
+#define pdPASS  pdTRUE
+#define pdFAIL  pdFALSE
+
+#define configTICK_RATE_HZ               1000
+#define configMAX_TASK_NAME_LEN          16
+#define configUSE_TRACE_FACILITY         0
+#define configGENERATE_RUN_TIME_STATS    0
+
+#define portMAX_DELAY      ((TickType_t)0xffffffffUL)
+#define portTICK_PERIOD_MS (1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(ms)  ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) / 1000))
+
+#define BIT0 (1u << 0)
+#define BIT1 (1u << 1)
+#define BIT2 (1u << 2)
+#define BIT3 (1u << 3)
+
+typedef struct {
+    int unused;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED { 0 }
+
+void sim_enter_critical(portMUX_TYPE *mux);
+void sim_exit_critical(portMUX_TYPE *mux);
+
+#define portENTER_CRITICAL(mux)       sim_enter_critical(mux)
+#define portEXIT_CRITICAL(mux)        sim_exit_critical(mux)
+#define portENTER_CRITICAL_SAFE(mux)  sim_enter_critical(mux)
+#define portEXIT_CRITICAL_SAFE(mux)   sim_exit_critical(mux)
+#define portENTER_CRITICAL_ISR(mux)   sim_enter_critical(mux)
+#define portEXIT_CRITICAL_ISR(mux)    sim_exit_critical(mux)
+#define taskENTER_CRITICAL(mux)       sim_enter_critical(mux)
+#define taskEXIT_CRITICAL(mux)        sim_exit_critical(mux)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TURN_SIM_FREERTOS_H */
@@ -0,0 +1,43 @@
+/**
+ * @file task.h
+ * @brief Host stand-in: tasks are host threads; delays and notification
+ *        waits block on the simulated clock. Priorities and cores are
+ *        recorded for reports but do not schedule anything.
+ */
+
+#ifndef TURN_SIM_FREERTOS_TASK_H
+#define TURN_SIM_FREERTOS_TASK_H
+
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define tskNO_AFFINITY ((BaseType_t)0x7FFFFFFF)
+
+typedef struct tskTaskControlBlock *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *arg);
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack_bytes,
+                                   void *arg, UBaseType_t priority, TaskHandle_t *handle,
+                                   BaseType_t core);
+
+#define xTaskCreate(fn, name, stack, arg, prio, handle) \
+    xTaskCreatePinnedToCore((fn), (name), (stack), (arg), (prio), (handle), tskNO_AFFINITY)
+
+/** Only vTaskDelete(NULL): a task ending itself. */
+void vTaskDelete(TaskHandle_t task);
+
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount(void);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TURN_SIM_FREERTOS_TASK_H */
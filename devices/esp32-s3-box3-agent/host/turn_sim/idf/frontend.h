@@ -0,0 +1,41 @@
+/**
+ * @file frontend.h
+ * @brief Host stand-in for the microfrontend feature extractor
+ *        (sim_models.cc). Each 10 ms stride gives one feature vector,
+ *        every channel the same value: the stride's level in dB, scaled
+ *        so that after elisa_wake_word.cc's quantization a loud call
+ *        (RMS ~20000) is positive and speech (RMS ~4000) is negative.
+ */
+
+#ifndef TURN_SIM_FRONTEND_H
+#define TURN_SIM_FRONTEND_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SIM_FRONTEND_MAX_CHANNELS 64
+
+struct FrontendState {
+    int num_channels;
+    size_t step_samples;
+    uint16_t values[SIM_FRONTEND_MAX_CHANNELS];
+};
+
+struct FrontendOutput {
+    const uint16_t *values;
+    size_t size;
+};
+
+struct FrontendOutput FrontendProcessSamples(struct FrontendState *state, const int16_t *samples,
+                                             size_t num_samples, size_t *num_samples_read);
+void FrontendReset(struct FrontendState *state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TURN_SIM_FRONTEND_H */
@@ -0,0 +1,37 @@
+/**
+ * @file frontend_util.h
+ * @brief Host stand-in: the microfrontend configuration. Only the window
+ *        step and channel count are used (see frontend.h).
+ */
+
+#ifndef TURN_SIM_FRONTEND_UTIL_H
+#define TURN_SIM_FRONTEND_UTIL_H
+
+#include "frontend.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct FrontendConfig {
+    struct { int size_ms; int step_size_ms; } window;
+    struct { int num_channels; float lower_band_limit; float upper_band_limit; } filterbank;
+    struct {
+        int smoothing_bits;
+        float even_smoothing;
+        float odd_smoothing;
+        float min_signal_remaining;
+    } noise_reduction;
+    struct { int enable_pcan; float strength; float offset; int gain_bits; } pcan_gain_control;
+    struct { int enable_log; int scale_shift; } log_scale;
+};
+
+int FrontendPopulateState(const struct FrontendConfig *config, struct FrontendState *state,
+                          int sample_rate);
+void FrontendFreeStateContents(struct FrontendState *state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TURN_SIM_FRONTEND_UTIL_H */
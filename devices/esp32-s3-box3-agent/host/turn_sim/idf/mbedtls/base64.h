@@ -0,0 +1,25 @@
+/**
+ * @file base64.h
+ * @brief Host stand-in: mbedTLS's base64 decoder, same contract.
+ */
+
+#ifndef TURN_SIM_MBEDTLS_BASE64_H
+#define TURN_SIM_MBEDTLS_BASE64_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MBEDTLS_ERR_BASE64_BUFFER_TOO_SMALL   -0x002A
+#define MBEDTLS_ERR_BASE64_INVALID_CHARACTER  -0x002C
+
+int mbedtls_base64_decode(unsigned char *dst, size_t dlen, size_t *olen,
+                          const unsigned char *src, size_t slen);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TURN_SIM_MBEDTLS_BASE64_H */
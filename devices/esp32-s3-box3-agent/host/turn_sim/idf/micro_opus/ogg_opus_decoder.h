@@ -0,0 +1,60 @@
+/**
+ * @file ogg_opus_decoder.h
+ * @brief Host stand-in for micro_opus's Ogg Opus decoder (sim_models.cc).
+ *
+ * The Ogg layer is real: pages are parsed and split into packets, one
+ * page consumed per call as the real decoder does. The Opus layer is
+ * not: each audio packet's length comes from its TOC byte (frame size
+ * and count, RFC 6716 section 3.1) and the samples are a tone, so the
+ * PCM buffer sizes and playback time match the real stream. Page CRCs
+ * are not checked.
+ */
+
+#ifndef TURN_SIM_OGG_OPUS_DECODER_H
+#define TURN_SIM_OGG_OPUS_DECODER_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace micro_opus {
+
+enum OggOpusResult {
+    OGG_OPUS_OK = 0,
+    OGG_OPUS_INPUT_INVALID = -1,
+    OGG_OPUS_OUTPUT_BUFFER_TOO_SMALL = -2,
+    OGG_OPUS_NOT_OPUS = -3,
+};
+
+class OggOpusDecoder {
+public:
+    OggOpusDecoder(bool enable_crc, uint32_t sample_rate, uint8_t channels);
+
+    /**
+     * Decode from @p input: parses the next page if no packet is pending,
+     * then decodes one packet into @p output (int16 LE). Input is consumed
+     * a packet at a time (the page header with the first), so a caller
+     * that stops at the end of its input has every packet decoded.
+     */
+    OggOpusResult decode(const uint8_t *input, size_t input_len, uint8_t *output,
+                         size_t output_bytes, size_t &bytes_consumed, size_t &samples_decoded);
+
+    uint32_t get_sample_rate() const { return sample_rate_; }
+
+private:
+    static constexpr int kMaxPending = 255;
+
+    uint32_t sample_rate_;
+    uint8_t channels_;
+    bool head_seen_ = false;
+    /** Samples per packet of the current page; -1 = header packet */
+    int pending_[kMaxPending];
+    /** Input bytes each packet accounts for */
+    size_t pending_bytes_[kMaxPending];
+    int pending_count_ = 0;
+    int pending_next_ = 0;
+    uint32_t phase_ = 0;
+};
+
+}  // namespace micro_opus
+
+#endif /* TURN_SIM_OGG_OPUS_DECODER_H */
@@ -0,0 +1,23 @@
+/**
+ * @file nvs_flash.h
+ * @brief Host stand-in: NVS is only initialized for WiFi, which is
+ *        simulated, so both calls succeed.
+ */
+
+#ifndef TURN_SIM_NVS_FLASH_H
+#define TURN_SIM_NVS_FLASH_H
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+esp_err_t nvs_flash_init(void);
+esp_err_t nvs_flash_erase(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TURN_SIM_NVS_FLASH_H */
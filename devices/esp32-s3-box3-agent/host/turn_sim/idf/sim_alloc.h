@@ -0,0 +1,53 @@
+/**
+ * @file sim_alloc.h
+ * @brief Host stand-in: force-included into the firmware sources and
+ *        cJSON (-include), so their malloc family is counted against the
+ *        simulated internal RAM and PSRAM (sim_heap.cc).
+ *
+ * The C library headers come first; the macros only rename calls made
+ * after them.
+ */
+
+#ifndef TURN_SIM_ALLOC_H
+#define TURN_SIM_ALLOC_H
+
+#ifdef __cplusplus
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#else
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void *sim_malloc(size_t size);
+void *sim_calloc(size_t n, size_t size);
+void *sim_realloc(void *p, size_t size);
+void sim_free(void *p);
+char *sim_strdup(const char *s);
+
+#ifdef __cplusplus
+}
+
+/* For headers included later that say std::malloc */
+namespace std {
+using ::sim_calloc;
+using ::sim_free;
+using ::sim_malloc;
+using ::sim_realloc;
+using ::sim_strdup;
+}
+#endif
+
+#define malloc  sim_malloc
+#define calloc  sim_calloc
+#define realloc sim_realloc
+#define free    sim_free
+#define strdup  sim_strdup
+
+#endif /* TURN_SIM_ALLOC_H */
@@ -0,0 +1,11 @@
+/**
+ * @file micro_resource_variable.h
+ * @brief Host stand-in: see sim_tflite.h.
+ */
+
+#ifndef TURN_SIM_TFLITE_MICRO_RESOURCE_VARIABLE_H
+#define TURN_SIM_TFLITE_MICRO_RESOURCE_VARIABLE_H
+
+#include "tensorflow/lite/micro/sim_tflite.h"
+
+#endif /* TURN_SIM_TFLITE_MICRO_RESOURCE_VARIABLE_H */
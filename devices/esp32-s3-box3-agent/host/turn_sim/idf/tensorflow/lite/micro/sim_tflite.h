@@ -0,0 +1,108 @@
+/**
+ * @file sim_tflite.h
+ * @brief Host stand-in for the slice of TFLite Micro elisa_wake_word.cc
+ *        uses (sim_models.cc). There is no inference: the "model" emits
+ *        255 when the mean of its input features is positive and 0
+ *        otherwise, which with the stand-in frontend (frontend.h) means
+ *        "loud". The tensors live in the arena the caller passes, as in
+ *        TFLite Micro, so the wake word's memory use is unchanged.
+ */
+
+#ifndef TURN_SIM_TFLITE_H
+#define TURN_SIM_TFLITE_H
+
+#include <cstddef>
+#include <cstdint>
+
+#define TFLITE_SCHEMA_VERSION 3
+
+typedef enum {
+    kTfLiteOk = 0,
+    kTfLiteError = 1,
+} TfLiteStatus;
+
+typedef struct {
+    int size;
+    int data[4];
+} TfLiteIntArray;
+
+typedef struct {
+    union {
+        int8_t *int8;
+        uint8_t *uint8;
+        void *raw;
+    } data;
+    TfLiteIntArray *dims;
+    size_t bytes;
+} TfLiteTensor;
+
+namespace tflite {
+
+/** A flatbuffer whose identifier ("TFL3") is checked; nothing else is read. */
+class Model {
+public:
+    unsigned long version() const;
+};
+
+const Model *GetModel(const void *buf);
+
+class MicroOpResolver {
+public:
+    virtual ~MicroOpResolver() = default;
+};
+
+template <unsigned int kOpCount>
+class MicroMutableOpResolver : public MicroOpResolver {
+public:
+    TfLiteStatus AddConv2D() { return Add(); }
+    TfLiteStatus AddDepthwiseConv2D() { return Add(); }
+    TfLiteStatus AddFullyConnected() { return Add(); }
+    TfLiteStatus AddReshape() { return Add(); }
+    TfLiteStatus AddLogistic() { return Add(); }
+    TfLiteStatus AddQuantize() { return Add(); }
+    TfLiteStatus AddStridedSlice() { return Add(); }
+    TfLiteStatus AddConcatenation() { return Add(); }
+    TfLiteStatus AddSplitV() { return Add(); }
+    TfLiteStatus AddVarHandle() { return Add(); }
+    TfLiteStatus AddReadVariable() { return Add(); }
+    TfLiteStatus AddAssignVariable() { return Add(); }
+    TfLiteStatus AddCallOnce() { return Add(); }
+
+private:
+    TfLiteStatus Add() { return ops_ < kOpCount ? (ops_++, kTfLiteOk) : kTfLiteError; }
+    unsigned int ops_ = 0;
+};
+
+class MicroAllocator {
+public:
+    static MicroAllocator *Create(uint8_t *arena, size_t size);
+};
+
+class MicroResourceVariables {
+public:
+    static MicroResourceVariables *Create(MicroAllocator *allocator, int count);
+};
+
+class MicroInterpreter {
+public:
+    MicroInterpreter(const Model *model, const MicroOpResolver &resolver, uint8_t *arena,
+                     size_t arena_size, MicroResourceVariables *resource_variables = nullptr);
+
+    TfLiteStatus AllocateTensors();
+    TfLiteStatus Invoke();
+    TfLiteTensor *input(size_t index);
+    TfLiteTensor *output(size_t index);
+
+private:
+    const Model *model_;
+    uint8_t *arena_;
+    size_t arena_size_;
+    TfLiteTensor input_ = {};
+    TfLiteTensor output_ = {};
+    TfLiteIntArray input_dims_ = {};
+    TfLiteIntArray output_dims_ = {};
+};
+
+}  // namespace tflite
+
+#endif /* TURN_SIM_TFLITE_H */
@@ -0,0 +1,11 @@
+/**
+ * @file schema_generated.h
+ * @brief Host stand-in: see sim_tflite.h.
+ */
+
+#ifndef TURN_SIM_TFLITE_SCHEMA_GENERATED_H
+#define TURN_SIM_TFLITE_SCHEMA_GENERATED_H
+
+#include "tensorflow/lite/micro/sim_tflite.h"
+
+#endif /* TURN_SIM_TFLITE_SCHEMA_GENERATED_H */
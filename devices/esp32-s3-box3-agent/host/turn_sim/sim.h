@@ -0,0 +1,165 @@
+/**
+ * @file sim.h
+ * @brief Internals shared by the turn simulator's stand-ins (turn_sim.cc).
+ *
+ * Every firmware task runs on its own host thread, but time is virtual:
+ * esp_timer_get_time() and every FreeRTOS timeout read one simulated
+ * clock, and the clock only moves when every task is blocked. It then
+ * jumps straight to the earliest deadline. Computation takes no virtual
+ * time, so a turn costs as much host time as its code takes to run, and
+ * the latencies the firmware measures are the modelled ones: recording,
+ * upload over a real localhost socket, server think time, playback.
+ *
+ * A task blocked on a socket counts as blocked only while nothing is
+ * waiting to be read: before the clock moves, every socket a task waits
+ * on is polled, so a reply already in the kernel is never skipped over.
+ */
+
+#ifndef TURN_SIM_SIM_H
+#define TURN_SIM_SIM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace sim {
+
+constexpr int64_t kForever = INT64_MAX;
+
+// ── Clock and Tasks (sim_clock.cc) ──────────────────────────────────────
+
+struct Task;
+
+/** Virtual microseconds since boot. */
+int64_t now_us();
+
+/**
+ * Start @p fn on a new thread as a simulated task. It is registered as
+ * running before spawn() returns, so the clock cannot move past its
+ * first instruction. @p firmware tasks have their allocations counted
+ * (sim_heap.cc); the stand-in runtime's are not.
+ */
+Task *spawn(const char *name, std::function<void()> fn, bool firmware, int priority = 0,
+            int core = -1);
+
+/** The calling task, or nullptr on a thread the clock does not know. */
+Task *current();
+
+/** End the calling task (vTaskDelete(NULL)). Does not return. */
+[[noreturn]] void exit_task();
+
+const char *task_name(const Task *task);
+int task_priority(const Task *task);
+int task_core(const Task *task);
+bool task_is_firmware(const Task *task);
+
+/** Number of live tasks. */
+int task_count();
+
+/** The scheduler lock: guards every wait condition below. */
+std::unique_lock<std::mutex> lock();
+
+/**
+ * With lock() held, block until @p ready() or virtual time reaches
+ * @p deadline_us. Returns ready(). Any thread may wait; only tasks hold
+ * the clock back.
+ */
+bool wait(std::unique_lock<std::mutex> &lk, int64_t deadline_us, const std::function<bool()> &ready);
+
+/** With lock() held: a wait condition may have changed, re-check them. */
+void wake_all();
+
+/** Block until virtual time reaches @p deadline_us. */
+void sleep_until(int64_t deadline_us);
+
+/**
+ * Block until @p fd is ready for @p events (POLLIN / POLLOUT) or virtual
+ * time reaches @p deadline_us. Returns 1 if ready, 0 on timeout.
+ */
+int wait_fd(int fd, short events, int64_t deadline_us);
+
+/** Per-task notification count (xTaskNotifyGive / ulTaskNotifyTake). */
+uint32_t *task_notify_value(Task *task);
+
+/** With lock() held: true while every task is blocked with no deadline. */
+bool stalled();
+
+/**
+ * Stop the clock for good and return once every task is blocked, so the
+ * caller can read firmware state without racing it. From the driver
+ * thread only; the simulation cannot be resumed.
+ */
+void halt();
+
+// ── Heap (sim_heap.cc) ──────────────────────────────────────────────────
+
+enum Pool { kInternal, kSpiram, kPoolCount };
+
+struct PoolStats {
+    size_t capacity;
+    size_t in_use;
+    size_t peak;         /**< Since the last mark_heap() */
+    size_t peak_ever;
+};
+
+struct HeapStats {
+    PoolStats pool[kPoolCount];
+    uint64_t allocs;     /**< Counted allocations since start */
+    uint64_t alloc_bytes;
+    uint64_t failed;
+};
+
+void configure_heap(size_t internal_bytes, size_t spiram_bytes);
+HeapStats heap_stats();
+
+/** Restart both pools' peak tracking from the current use. */
+void mark_heap();
+
+/**
+ * Count this thread's allocations (firmware tasks) or not. Only calls
+ * routed through sim_alloc.h are seen: the firmware sources and cJSON.
+ */
+void set_thread_counted(bool counted);
+
+// ── Board (sim_board.cc) ────────────────────────────────────────────────
+
+/** Register a flash partition (data type) backed by memory, erased to 0xFF. */
+void add_partition(const char *label, int subtype, size_t size, const std::vector<uint8_t> &contents);
+
+/** Log lines at this level and above reach stderr ('E', 'W', 'I', 'D'). */
+void set_log_level(char level);
+
+// ── Audio (sim_audio.cc) ────────────────────────────────────────────────
+
+struct AudioConfig {
+    std::string mic_path;       /**< 16 kHz mono 16-bit WAV, looped */
+    std::string speaker_path;   /**< Optional WAV sink, 16 kHz mono */
+    int end_silence_ms = 800;   /**< Recording stops after this much quiet */
+    int max_record_ms = 10000;
+};
+
+/** Load the microphone WAV and open the speaker sink. False (reported) on error. */
+bool configure_audio(const AudioConfig &config);
+
+/** Flush and close the speaker WAV. */
+void close_audio();
+
+// ── Turn Accounting (turn_sim.cc) ───────────────────────────────────────
+//
+// Hooks called by the audio stand-ins at the points the firmware cannot
+// see from inside: the wake word, the end of the user's speech, the
+// SR handler's start_openai() call, and the player.
+
+void on_wake();
+void on_speech_end(int64_t at_us);
+void on_turn_start();
+void on_turn_returned(int err);
+void on_playback_start();
+void on_playback_end(bool stopped);
+
+}  // namespace sim
+
+#endif /* TURN_SIM_SIM_H */
@@ -0,0 +1,555 @@
+/**
+ * @file sim_audio.cc
+ * @brief The audio side of the board for turn_sim: microphone, the
+ *        chatgpt_demo app_sr pipeline (feed, wake word, record, SR
+ *        handler) and audio_player, paced on the simulated clock.
+ *
+ * The microphone is a 16 kHz mono WAV, looped, delivered in 20 ms frames
+ * at the rate the I2S driver would. The detect task fetches every frame
+ * from a stand-in AFE through the firmware's elisa_wakenet_fetch(), as
+ * the patched app_sr.c does on the device; the AFE's "WakeNet" is the
+ * firmware's own elisa_wake_word_detect(). After a wake it records into
+ * one of two PSRAM buffers until an energy VAD hears end_silence_ms of
+ * quiet, then hands the WAV to the SR handler task, which calls
+ * start_openai() as app_sr.c does on the device.
+ *
+ * The player does not decode: it reads the WAV header or walks the MP3
+ * frame headers for the duration and holds the audio task for that long,
+ * unless audio_player_stop() cuts it short.
+ */
+
+#include "sim.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+
+#include "app_audio.h"
+#include "app_sr.h"
+#include "audio_player.h"
+#include "elisa_capture.h"
+#include "elisa_face.h"
+#include "elisa_latency.h"
+#include "elisa_tasks.h"
+#include "elisa_wake_word.h"
+#include "elisa_wakenet.h"
+#include "esp_afe_sr_iface.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+
+/** The stand-in AFE's state: the frame last fetched. */
+struct esp_afe_sr_data_t {
+    afe_fetch_result_t result;
+    int16_t samples[320];  /**< One 20 ms frame at 16 kHz */
+    int64_t at_us;         /**< When its last sample arrived */
+    bool wakenet_enabled;
+};
+
+namespace sim {
+
+namespace {
+
+const char *TAG = "sim_audio";
+
+constexpr int kSampleRate = 16000;
+constexpr int kFrameMs = 20;
+constexpr int kFrameSamples = kSampleRate * kFrameMs / 1000;
+constexpr int64_t kFrameUs = kFrameMs * 1000;
+constexpr size_t kWavHeaderBytes = 44;
+constexpr double kVoiceRms = 1000.0;  /**< Frames louder than this are speech */
+static_assert(sizeof(esp_afe_sr_data_t::samples) == kFrameSamples * sizeof(int16_t),
+              "AFE frame is one mic frame");
+
+AudioConfig g_config;
+std::vector<int16_t> g_mic;
+size_t g_mic_pos = 0;
+FILE *g_speaker = nullptr;
+uint64_t g_speaker_samples = 0;
+
+// ── WAV ─────────────────────────────────────────────────────────────────
+
+uint16_t le16(const uint8_t *p) { return (uint16_t)(p[0] | p[1] << 8); }
+uint32_t le32(const uint8_t *p) { return (uint32_t)(p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24); }
+
+struct WavInfo {
+    uint32_t sample_rate;
+    uint16_t channels;
+    uint16_t bits;
+    size_t data_offset;
+    size_t data_bytes;
+};
+
+/** Find the fmt and data chunks of a RIFF/WAVE image. */
+bool parse_wav(const uint8_t *p, size_t len, WavInfo *out) {
+    if (len < 12 || memcmp(p, "RIFF", 4) != 0 || memcmp(p + 8, "WAVE", 4) != 0) return false;
+    bool have_fmt = false;
+    size_t pos = 12;
+    while (pos + 8 <= len) {
+        uint32_t size = le32(p + pos + 4);
+        const uint8_t *body = p + pos + 8;
+        if (memcmp(p + pos, "fmt ", 4) == 0 && size >= 16 && pos + 8 + 16 <= len) {
+            out->channels = le16(body + 2);
+            out->sample_rate = le32(body + 4);
+            out->bits = le16(body + 14);
+            have_fmt = true;
+        } else if (memcmp(p + pos, "data", 4) == 0) {
+            out->data_offset = pos + 8;
+            out->data_bytes = std::min<size_t>(size, len - out->data_offset);
+            return have_fmt;
+        }
+        pos += 8 + size + (size & 1);
+    }
+    return false;
+}
+
+void put_wav_header(uint8_t *p, uint32_t sample_rate, uint32_t data_bytes) {
+    auto put16 = [](uint8_t *q, uint16_t v) { q[0] = (uint8_t)v; q[1] = (uint8_t)(v >> 8); };
+    auto put32 = [](uint8_t *q, uint32_t v) {
+        for (int i = 0; i < 4; i++) q[i] = (uint8_t)(v >> (8 * i));
+    };
+    memcpy(p, "RIFF", 4);
+    put32(p + 4, 36 + data_bytes);
+    memcpy(p + 8, "WAVEfmt ", 8);
+    put32(p + 16, 16);
+    put16(p + 20, 1);
+    put16(p + 22, 1);
+    put32(p + 24, sample_rate);
+    put32(p + 28, sample_rate * 2);
+    put16(p + 32, 2);
+    put16(p + 34, 16);
+    memcpy(p + 36, "data", 4);
+    put32(p + 40, data_bytes);
+}
+
+/** Duration of an MPEG audio stream from its frame headers, or -1. */
+int64_t mp3_duration_us(const uint8_t *p, size_t len) {
+    static const int kBitrateV1[] = { 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320 };
+    static const int kBitrateV2[] = { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160 };
+    static const int kRateV1[] = { 44100, 48000, 32000 };
+
+    size_t pos = 0;
+    if (len >= 10 && memcmp(p, "ID3", 3) == 0) {
+        pos = 10 + ((size_t)(p[6] & 0x7F) << 21 | (p[7] & 0x7F) << 14 | (p[8] & 0x7F) << 7 | (p[9] & 0x7F));
+    }
+    int64_t us = 0;
+    int frames = 0;
+    while (pos + 4 <= len) {
+        const uint8_t *h = p + pos;
+        if (h[0] != 0xFF || (h[1] & 0xE0) != 0xE0) {
+            pos++;
+            continue;
+        }
+        int version = (h[1] >> 3) & 3;  /* 3 = MPEG-1, 2 = MPEG-2, 0 = MPEG-2.5 */
+        int layer = (h[1] >> 1) & 3;    /* 1 = Layer III */
+        int bitrate_idx = h[2] >> 4;
+        int rate_idx = (h[2] >> 2) & 3;
+        if (version == 1 || layer != 1 || bitrate_idx == 0 || bitrate_idx == 15 || rate_idx == 3) {
+            pos++;
+            continue;
+        }
+        bool v1 = version == 3;
+        int rate = kRateV1[rate_idx] >> (v1 ? 0 : version == 2 ? 1 : 2);
+        int bitrate = (v1 ? kBitrateV1 : kBitrateV2)[bitrate_idx] * 1000;
+        int samples = v1 ? 1152 : 576;
+        size_t size = (size_t)(samples / 8 * bitrate / rate) + ((h[2] >> 1) & 1);
+        us += (int64_t)samples * 1000000 / rate;
+        frames++;
+        pos += size;
+    }
+    return frames > 0 ? us : -1;
+}
+
+// ── Microphone ──────────────────────────────────────────────────────────
+
+void read_mic_frame(int16_t *out) {
+    for (int i = 0; i < kFrameSamples; i++) {
+        out[i] = g_mic[g_mic_pos];
+        g_mic_pos = (g_mic_pos + 1) % g_mic.size();
+    }
+}
+
+double frame_rms(const int16_t *frame) {
+    double energy = 0;
+    for (int i = 0; i < kFrameSamples; i++) energy += (double)frame[i] * frame[i];
+    return std::sqrt(energy / kFrameSamples);
+}
+
+// ── app_sr ──────────────────────────────────────────────────────────────
+
+struct Frame {
+    int16_t samples[kFrameSamples];
+    int64_t at_us;  /**< When its last sample arrived */
+};
+
+enum BufferState { kFree, kRecording, kQueued, kHandling };
+
+struct RecordBuffer {
+    uint8_t *data;
+    size_t len;
+    BufferState state;
+};
+
+std::deque<Frame> g_frames;       /* feed -> detect, under lock() */
+RecordBuffer g_record[2];
+std::deque<int> g_handler_queue;  /* detect -> handler, under lock() */
+size_t g_record_capacity = 0;
+
+void feed_task(void *arg) {
+    (void)arg;
+    int64_t next = now_us() + kFrameUs;
+    while (true) {
+        sleep_until(next);
+        Frame frame;
+        read_mic_frame(frame.samples);
+        frame.at_us = next;
+        if (elisa_capture_is_active()) elisa_recording_feed(frame.samples, kFrameSamples);
+        {
+            auto lk = lock();
+            g_frames.push_back(frame);
+            wake_all();
+        }
+        next += kFrameUs;
+    }
+}
+
+/** A free buffer for the next recording, or -1 if both are still in use. */
+int claim_buffer() {
+    auto lk = lock();
+    for (int i = 0; i < 2; i++) {
+        if (g_record[i].state == kFree) {
+            g_record[i].state = kRecording;
+            g_record[i].len = kWavHeaderBytes;
+            return i;
+        }
+    }
+    return -1;
+}
+
+// The AFE: hands out mic frames, with elisa_wake_word.cc as WakeNet and
+// its thresholds as WakeNet's.
+
+afe_fetch_result_t *afe_fetch(esp_afe_sr_data_t *afe) {
+    Frame frame;
+    {
+        auto lk = lock();
+        wait(lk, kForever, [] { return !g_frames.empty(); });
+        frame = g_frames.front();
+        g_frames.pop_front();
+    }
+    memcpy(afe->samples, frame.samples, sizeof(afe->samples));
+    afe->at_us = frame.at_us;
+    afe->result.data = afe->samples;
+    afe->result.data_size = (int)sizeof(afe->samples);
+    afe->result.ret_value = ESP_OK;
+    afe->result.wakeup_state =
+        (afe->wakenet_enabled && elisa_wake_word_detect(afe->samples, kFrameSamples))
+            ? WAKENET_DETECTED : WAKENET_NO_DETECT;
+    return &afe->result;
+}
+
+int afe_set_wakenet_threshold(esp_afe_sr_data_t *afe, int index, float threshold) {
+    (void)afe;
+    (void)index;
+    elisa_wake_word_set_thresholds((uint8_t)(threshold * 100.0f + 0.5f), 0, 0);
+    return 1;
+}
+
+int afe_reset_wakenet_threshold(esp_afe_sr_data_t *afe, int index) {
+    (void)afe;
+    (void)index;
+    elisa_wake_word_set_thresholds(0, 0, 0);
+    return 1;
+}
+
+int afe_disable_wakenet(esp_afe_sr_data_t *afe) {
+    afe->wakenet_enabled = false;
+    return 1;
+}
+
+/** Listening again starts from a clean detector window. */
+int afe_enable_wakenet(esp_afe_sr_data_t *afe) {
+    elisa_wake_word_reset();
+    afe->wakenet_enabled = true;
+    return 1;
+}
+
+const esp_afe_sr_iface_t kAfe = {
+    afe_fetch, afe_set_wakenet_threshold, afe_reset_wakenet_threshold,
+    afe_disable_wakenet, afe_enable_wakenet,
+};
+esp_afe_sr_data_t g_afe;
+
+void detect_task(void *arg) {
+    esp_afe_sr_data_t *afe = static_cast<esp_afe_sr_data_t *>(arg);
+    constexpr size_t kFrameBytes = sizeof(afe->samples);
+    int recording = -1;
+    bool voiced = false;
+    int quiet_ms = 0;
+    int64_t voice_end_us = 0;
+
+    while (true) {
+        afe_fetch_result_t *res = elisa_wakenet_fetch(&kAfe, afe);
+
+        if (recording < 0) {
+            if (res->wakeup_state != WAKENET_DETECTED) continue;
+            kAfe.disable_wakenet(afe);
+            on_wake();
+            elisa_face_set_state(FACE_STATE_LISTENING);
+            recording = claim_buffer();
+            if (recording < 0) {
+                ESP_LOGW(TAG, "Wake word while both record buffers are busy -- ignored");
+                kAfe.enable_wakenet(afe);
+                continue;
+            }
+            voiced = false;
+            quiet_ms = 0;
+            continue;
+        }
+
+        RecordBuffer &buf = g_record[recording];
+        if (buf.len + kFrameBytes <= g_record_capacity) {
+            memcpy(buf.data + buf.len, res->data, kFrameBytes);
+            buf.len += kFrameBytes;
+        }
+        if (frame_rms(res->data) > kVoiceRms) {
+            voiced = true;
+            quiet_ms = 0;
+            voice_end_us = afe->at_us;
+        } else {
+            quiet_ms += kFrameMs;
+        }
+        bool full = buf.len + kFrameBytes > g_record_capacity;
+        if (!(voiced && quiet_ms >= g_config.end_silence_ms) && !full) continue;
+
+        put_wav_header(buf.data, kSampleRate, (uint32_t)(buf.len - kWavHeaderBytes));
+        on_speech_end(voiced ? voice_end_us : afe->at_us);
+        kAfe.enable_wakenet(afe);
+        {
+            auto lk = lock();
+            buf.state = kQueued;
+            g_handler_queue.push_back(recording);
+            wake_all();
+        }
+        recording = -1;
+    }
+}
+
+void sr_handler_task(void *arg) {
+    (void)arg;
+    while (true) {
+        int idx;
+        {
+            auto lk = lock();
+            wait(lk, kForever, [] { return !g_handler_queue.empty(); });
+            idx = g_handler_queue.front();
+            g_handler_queue.pop_front();
+            g_record[idx].state = kHandling;
+        }
+        on_turn_start();
+        esp_err_t ret = start_openai(g_record[idx].data, (int)g_record[idx].len);
+        on_turn_returned(ret);
+        auto lk = lock();
+        g_record[idx].state = kFree;
+    }
+}
+
+// ── audio_player ────────────────────────────────────────────────────────
+
+audio_play_finish_cb_t g_finish_cb = nullptr;
+std::deque<FILE *> g_play_queue;  /* under lock() */
+bool g_playing = false;
+bool g_stop = false;
+
+/** Pad the speaker WAV with silence up to @p until_us. */
+void speaker_catch_up(int64_t until_us) {
+    if (g_speaker == nullptr) return;
+    uint64_t target = (uint64_t)until_us * kSampleRate / 1000000;
+    static const int16_t kZeros[kFrameSamples] = {};
+    while (g_speaker_samples < target) {
+        size_t n = (size_t)std::min<uint64_t>(kFrameSamples, target - g_speaker_samples);
+        fwrite(kZeros, sizeof(int16_t), n, g_speaker);
+        g_speaker_samples += n;
+    }
+}
+
+/** Write the first @p played_us of a PCM WAV to the speaker, resampled to 16 kHz. */
+void speaker_write(const std::vector<uint8_t> &file, const WavInfo &wav, int64_t played_us) {
+    if (g_speaker == nullptr || wav.bits != 16 || wav.channels == 0) return;
+    const uint8_t *pcm = file.data() + wav.data_offset;
+    size_t frames = wav.data_bytes / (2u * wav.channels);
+    uint64_t out = (uint64_t)played_us * kSampleRate / 1000000;
+    for (uint64_t i = 0; i < out; i++) {
+        size_t src = (size_t)(i * wav.sample_rate / kSampleRate);
+        if (src >= frames) break;
+        int16_t s = (int16_t)le16(pcm + src * 2u * wav.channels);
+        fwrite(&s, sizeof(s), 1, g_speaker);
+        g_speaker_samples++;
+    }
+}
+
+void player_task(void *arg) {
+    (void)arg;
+    while (true) {
+        FILE *fp;
+        {
+            auto lk = lock();
+            wait(lk, kForever, [] { return !g_play_queue.empty(); });
+            fp = g_play_queue.front();
+            g_play_queue.pop_front();
+            g_playing = true;
+            g_stop = false;
+        }
+
+        std::vector<uint8_t> file;
+        uint8_t chunk[4096];
+        size_t n;
+        while ((n = fread(chunk, 1, sizeof(chunk), fp)) > 0) file.insert(file.end(), chunk, chunk + n);
+        fclose(fp);
+
+        WavInfo wav = {};
+        int64_t duration_us;
+        bool is_wav = parse_wav(file.data(), file.size(), &wav);
+        if (is_wav && wav.sample_rate > 0 && wav.channels > 0 && wav.bits > 0) {
+            duration_us = (int64_t)wav.data_bytes * 8 * 1000000 /
+                          ((int64_t)wav.sample_rate * wav.channels * wav.bits);
+        } else {
+            is_wav = false;
+            duration_us = mp3_duration_us(file.data(), file.size());
+            if (duration_us < 0) {
+                ESP_LOGE(TAG, "Unplayable audio (%zu bytes)", file.size());
+                duration_us = 0;
+            }
+        }
+
+        int64_t start = now_us();
+        speaker_catch_up(start);
+        /* The first write to I2S, where elisa_lipsync_i2s_write() records it */
+        elisa_latency_record_since_wake(LAT_FIRST_AUDIO);
+        on_playback_start();
+        bool stopped;
+        {
+            auto lk = lock();
+            stopped = wait(lk, start + duration_us, [] { return g_stop; });
+        }
+        int64_t played = now_us() - start;
+        if (is_wav) speaker_write(file, wav, played);
+
+        if (g_finish_cb != nullptr) g_finish_cb();
+        {
+            auto lk = lock();
+            g_playing = false;
+        }
+        on_playback_end(stopped);
+    }
+}
+
+}  // namespace
+
+bool configure_audio(const AudioConfig &config) {
+    g_config = config;
+
+    FILE *f = fopen(config.mic_path.c_str(), "rb");
+    if (f == nullptr) {
+        fprintf(stderr, "turn_sim: cannot open %s\n", config.mic_path.c_str());
+        return false;
+    }
+    std::vector<uint8_t> file;
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) file.insert(file.end(), chunk, chunk + n);
+    fclose(f);
+
+    WavInfo wav = {};
+    if (!parse_wav(file.data(), file.size(), &wav) || wav.sample_rate != kSampleRate ||
+        wav.channels != 1 || wav.bits != 16 || wav.data_bytes < 2 * kFrameSamples) {
+        fprintf(stderr, "turn_sim: %s is not a 16 kHz mono 16-bit WAV\n", config.mic_path.c_str());
+        return false;
+    }
+    g_mic.resize(wav.data_bytes / 2);
+    memcpy(g_mic.data(), file.data() + wav.data_offset, g_mic.size() * 2);
+    g_mic_pos = 0;
+
+    if (!config.speaker_path.empty()) {
+        g_speaker = fopen(config.speaker_path.c_str(), "wb");
+        if (g_speaker == nullptr) {
+            fprintf(stderr, "turn_sim: cannot create %s\n", config.speaker_path.c_str());
+            return false;
+        }
+        uint8_t header[kWavHeaderBytes];
+        put_wav_header(header, kSampleRate, 0);
+        fwrite(header, 1, sizeof(header), g_speaker);
+        g_speaker_samples = 0;
+    }
+    return true;
+}
+
+void close_audio() {
+    if (g_speaker == nullptr) return;
+    uint8_t header[kWavHeaderBytes];
+    put_wav_header(header, kSampleRate, (uint32_t)(g_speaker_samples * 2));
+    fseek(g_speaker, 0, SEEK_SET);
+    fwrite(header, 1, sizeof(header), g_speaker);
+    fclose(g_speaker);
+    g_speaker = nullptr;
+}
+
+}  // namespace sim
+
+// ── C Entry Points ──────────────────────────────────────────────────────
+
+extern "C" {
+
+esp_err_t audio_record_init(void) {
+    if (elisa_task_create(ELISA_TASK_AUDIO_PLAYER, sim::player_task, nullptr, nullptr) != 0) {
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+void audio_register_play_finish_cb(audio_play_finish_cb_t cb) { sim::g_finish_cb = cb; }
+
+esp_err_t audio_player_play(FILE *fp) {
+    if (fp == nullptr) return ESP_ERR_INVALID_ARG;
+    auto lk = sim::lock();
+    if (sim::g_playing) sim::g_stop = true; /* a new file replaces the current one */
+    sim::g_play_queue.push_back(fp);
+    sim::wake_all();
+    return ESP_OK;
+}
+
+esp_err_t audio_player_stop(void) {
+    auto lk = sim::lock();
+    if (sim::g_playing) {
+        sim::g_stop = true;
+        sim::wake_all();
+    }
+    return ESP_OK;
+}
+
+esp_err_t app_sr_start(bool record_en) {
+    (void)record_en;
+    sim::g_record_capacity = sim::kWavHeaderBytes +
+        (size_t)sim::g_config.max_record_ms * sim::kSampleRate / 1000 * sizeof(int16_t);
+    for (sim::RecordBuffer &buf : sim::g_record) {
+        buf.data = static_cast<uint8_t *>(heap_caps_malloc(sim::g_record_capacity, MALLOC_CAP_SPIRAM));
+        if (buf.data == nullptr) {
+            ESP_LOGE(sim::TAG, "No PSRAM for the record buffers");
+            return ESP_ERR_NO_MEM;
+        }
+        buf.state = sim::kFree;
+    }
+    if (elisa_wake_word_init() != 0) {
+        ESP_LOGE(sim::TAG, "Wake word init failed");
+        return ESP_FAIL;
+    }
+    sim::g_afe.wakenet_enabled = true;
+    if (elisa_task_create(ELISA_TASK_AUDIO_FEED, sim::feed_task, nullptr, nullptr) != 0 ||
+        elisa_task_create(ELISA_TASK_AUDIO_DETECT, sim::detect_task, &sim::g_afe, nullptr) != 0 ||
+        elisa_task_create(ELISA_TASK_SR_HANDLER, sim::sr_handler_task, nullptr, nullptr) != 0) {
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+}  // extern "C"
@@ -0,0 +1,363 @@
+/**
+ * @file sim_board.cc
+ * @brief Board stand-ins for turn_sim: flash partitions, logging, NVS,
+ *        WiFi, the display-side modules (face, captions, lip sync) and
+ *        the odds and ends of ESP-IDF the turn code links against.
+ *
+ * The display modules only record what they are told: their rendering
+ * cost is face_bench's subject, not this tool's.
+ */
+
+#include "sim.h"
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+
+#include "OpenAI.h"
+#include "bsp/esp-bsp.h"
+#include "bsp_board.h"
+#include "elisa_caption.h"
+#include "elisa_face.h"
+#include "elisa_lipsync.h"
+#include "elisa_wifi.h"
+#include "esp_crt_bundle.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_spiffs.h"
+#include "esp_timer.h"
+#include "mbedtls/base64.h"
+#include "nvs_flash.h"
+
+namespace sim {
+
+namespace {
+
+constexpr uint32_t kSectorSize = 4096;
+
+struct Partition {
+    esp_partition_t info;
+    std::vector<uint8_t> data;
+};
+
+std::deque<Partition> g_partitions;
+std::mutex g_log_mutex;
+char g_log_level = 'W';
+
+int level_rank(char level) {
+    switch (level) {
+    case 'E': return 0;
+    case 'W': return 1;
+    case 'I': return 2;
+    default: return 3;
+    }
+}
+
+const Partition *partition_of(const esp_partition_t *part) {
+    for (const Partition &p : g_partitions) {
+        if (&p.info == part) return &p;
+    }
+    return nullptr;
+}
+
+}  // namespace
+
+void add_partition(const char *label, int subtype, size_t size, const std::vector<uint8_t> &contents) {
+    Partition p = {};
+    p.info.type = ESP_PARTITION_TYPE_DATA;
+    p.info.subtype = subtype;
+    p.info.address = 0x900000 + 0x100000 * (uint32_t)g_partitions.size();
+    p.info.size = (uint32_t)size;
+    p.info.erase_size = kSectorSize;
+    snprintf(p.info.label, sizeof(p.info.label), "%s", label);
+    p.data.assign(size, 0xFF);
+    std::copy(contents.begin(), contents.begin() + (long)std::min(size, contents.size()), p.data.begin());
+    g_partitions.push_back(std::move(p));
+}
+
+void set_log_level(char level) { g_log_level = level; }
+
+}  // namespace sim
+
+extern "C" {
+
+// ── Logging and Errors ──────────────────────────────────────────────────
+
+void sim_log(char level, const char *tag, const char *fmt, ...) {
+    if (sim::level_rank(level) > sim::level_rank(sim::g_log_level)) return;
+    char line[512];
+    int n = snprintf(line, sizeof(line), "%c (%lld) %s: ", level,
+                     (long long)(esp_timer_get_time() / 1000), tag);
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(line + n, sizeof(line) - (size_t)n, fmt, ap);
+    va_end(ap);
+    std::lock_guard<std::mutex> lk(sim::g_log_mutex);
+    fprintf(stderr, "%s\n", line);
+}
+
+const char *esp_err_to_name(esp_err_t code) {
+    switch (code) {
+    case ESP_OK: return "ESP_OK";
+    case ESP_FAIL: return "ESP_FAIL";
+    case ESP_ERR_NO_MEM: return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG: return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+    case ESP_ERR_INVALID_SIZE: return "ESP_ERR_INVALID_SIZE";
+    case ESP_ERR_NOT_FOUND: return "ESP_ERR_NOT_FOUND";
+    case ESP_ERR_NOT_SUPPORTED: return "ESP_ERR_NOT_SUPPORTED";
+    case ESP_ERR_TIMEOUT: return "ESP_ERR_TIMEOUT";
+    case 0x7002: return "ESP_ERR_HTTP_CONNECT";
+    case 0x7003: return "ESP_ERR_HTTP_WRITE_DATA";
+    case 0x7004: return "ESP_ERR_HTTP_FETCH_HEADER";
+    case 0x7005: return "ESP_ERR_HTTP_INVALID_TRANSPORT";
+    case 0x7007: return "ESP_ERR_HTTP_EAGAIN";
+    case 0x7008: return "ESP_ERR_HTTP_CONNECTION_CLOSED";
+    }
+    return "UNKNOWN ERROR";
+}
+
+void sim_error_check_failed(esp_err_t rc, const char *file, int line, const char *expr) {
+    fprintf(stderr, "ESP_ERROR_CHECK failed: esp_err_t 0x%x (%s) at %s:%d\nexpression: %s\n", rc,
+            esp_err_to_name(rc), file, line, expr);
+    abort();
+}
+
+// ── Flash ───────────────────────────────────────────────────────────────
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type,
+                                                esp_partition_subtype_t subtype, const char *label) {
+    for (const sim::Partition &p : sim::g_partitions) {
+        if (p.info.type == type && p.info.subtype == subtype &&
+            (label == nullptr || strcmp(p.info.label, label) == 0)) {
+            return &p.info;
+        }
+    }
+    return nullptr;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *part, size_t offset, void *dst, size_t size) {
+    const sim::Partition *p = sim::partition_of(part);
+    if (p == nullptr) return ESP_ERR_INVALID_ARG;
+    if (offset > part->size || size > part->size - offset) return ESP_ERR_INVALID_SIZE;
+    memcpy(dst, p->data.data() + offset, size);
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t *part, size_t offset, const void *src, size_t size) {
+    sim::Partition *p = const_cast<sim::Partition *>(sim::partition_of(part));
+    if (p == nullptr) return ESP_ERR_INVALID_ARG;
+    if (offset > part->size || size > part->size - offset) return ESP_ERR_INVALID_SIZE;
+    const uint8_t *in = static_cast<const uint8_t *>(src);
+    for (size_t i = 0; i < size; i++) p->data[offset + i] &= in[i]; /* NOR: clears bits only */
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t *part, size_t offset, size_t size) {
+    sim::Partition *p = const_cast<sim::Partition *>(sim::partition_of(part));
+    if (p == nullptr) return ESP_ERR_INVALID_ARG;
+    if (offset % sim::kSectorSize || size % sim::kSectorSize) return ESP_ERR_INVALID_ARG;
+    if (offset > part->size || size > part->size - offset) return ESP_ERR_INVALID_SIZE;
+    memset(p->data.data() + offset, 0xFF, size);
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_mmap(const esp_partition_t *part, size_t offset, size_t size,
+                             esp_partition_mmap_memory_t memory, const void **out_ptr,
+                             esp_partition_mmap_handle_t *out_handle) {
+    (void)memory;
+    const sim::Partition *p = sim::partition_of(part);
+    if (p == nullptr) return ESP_ERR_INVALID_ARG;
+    if (offset > part->size || size > part->size - offset) return ESP_ERR_INVALID_SIZE;
+    *out_ptr = p->data.data() + offset;
+    *out_handle = 1;
+    return ESP_OK;
+}
+
+void esp_partition_munmap(esp_partition_mmap_handle_t handle) { (void)handle; }
+
+esp_err_t esp_vfs_spiffs_register(const esp_vfs_spiffs_conf_t *conf) {
+    (void)conf;
+    return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t nvs_flash_init(void) { return ESP_OK; }
+esp_err_t nvs_flash_erase(void) { return ESP_OK; }
+
+// ── Network ─────────────────────────────────────────────────────────────
+//
+// The station is up as soon as it is started; the runtime is reached over
+// loopback (sim_http.cc).
+
+int elisa_wifi_start(const char *ssid, const char *password, const elisa_wifi_static_ip_t *static_ip) {
+    (void)ssid;
+    (void)password;
+    (void)static_ip;
+    return 0;
+}
+
+bool elisa_wifi_is_connected(void) { return true; }
+
+bool elisa_wifi_wait_connected(uint32_t timeout_ms) {
+    (void)timeout_ms;
+    return true;
+}
+
+const char *elisa_wifi_get_ssid(void) { return "turn_sim"; }
+void elisa_wifi_clear_cache(void) {}
+
+esp_err_t esp_crt_bundle_attach(void *conf) {
+    (void)conf;
+    return ESP_OK;
+}
+
+int mbedtls_base64_decode(unsigned char *dst, size_t dlen, size_t *olen, const unsigned char *src,
+                          size_t slen) {
+    auto value = [](unsigned char c) -> int {
+        if (c >= 'A' && c <= 'Z') return c - 'A';
+        if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+        if (c >= '0' && c <= '9') return c - '0' + 52;
+        if (c == '+') return 62;
+        if (c == '/') return 63;
+        return -1;
+    };
+
+    size_t n = 0, pad = 0;
+    for (size_t i = 0; i < slen; i++) {
+        unsigned char c = src[i];
+        if (c == '\r' || c == '\n' || c == ' ') continue;
+        if (c == '=') {
+            pad++;
+        } else if (pad > 0 || value(c) < 0) {
+            return MBEDTLS_ERR_BASE64_INVALID_CHARACTER;
+        }
+        n++;
+    }
+    if (n % 4 != 0 || pad > 2) return MBEDTLS_ERR_BASE64_INVALID_CHARACTER;
+
+    size_t need = n / 4 * 3 - pad;
+    *olen = need;
+    if (dst == nullptr || dlen < need) return MBEDTLS_ERR_BASE64_BUFFER_TOO_SMALL;
+
+    uint32_t acc = 0;
+    int bits = 0;
+    size_t out = 0;
+    for (size_t i = 0; i < slen; i++) {
+        int v = value(src[i]);
+        if (v < 0) continue;
+        acc = acc << 6 | (uint32_t)v;
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            if (out < need) dst[out++] = (unsigned char)(acc >> bits);
+        }
+    }
+    return 0;
+}
+
+// ── Display ─────────────────────────────────────────────────────────────
+
+void *bsp_display_start_with_config(const bsp_display_cfg_t *cfg) {
+    (void)cfg;
+    return nullptr;
+}
+
+esp_err_t bsp_display_backlight_on(void) { return ESP_OK; }
+esp_err_t bsp_i2c_init(void) { return ESP_OK; }
+esp_err_t bsp_board_init(void) { return ESP_OK; }
+
+/* Read by the heartbeat task, set by every other */
+static std::mutex s_face_mutex;
+static face_state_t s_face_state = FACE_STATE_IDLE;
+static int64_t s_face_state_since_us = 0;
+static int64_t s_face_state_us[ELISA_FACE_STATE_COUNT];
+static uint32_t s_face_commands = 0;
+static int64_t s_face_stats_since_us = 0;
+
+int elisa_face_init(const face_descriptor_t *desc) {
+    (void)desc;
+    return 0;
+}
+
+int elisa_face_set_descriptor(const face_descriptor_t *desc) {
+    (void)desc;
+    return 0;
+}
+
+void elisa_face_set_state(face_state_t state) {
+    int64_t now = esp_timer_get_time();
+    std::lock_guard<std::mutex> guard(s_face_mutex);
+    s_face_state_us[s_face_state] += now - s_face_state_since_us;
+    s_face_state_since_us = now;
+    s_face_state = state;
+    s_face_commands++;
+}
+
+face_state_t elisa_face_get_state(void) { return s_face_state; }
+
+const char *elisa_face_state_name(face_state_t state) {
+    switch (state) {
+    case FACE_STATE_IDLE:      return "idle";
+    case FACE_STATE_LISTENING: return "listening";
+    case FACE_STATE_THINKING:  return "thinking";
+    case FACE_STATE_SPEAKING:  return "speaking";
+    case FACE_STATE_ERROR:     return "error";
+    }
+    return "unknown";
+}
+
+void elisa_face_set_audio_level(float level) { (void)level; }
+
+void elisa_face_set_viseme(elisa_viseme_t viseme, uint16_t level) {
+    (void)viseme;
+    (void)level;
+}
+
+void elisa_face_take_stats(elisa_face_stats_t *out) {
+    int64_t now = esp_timer_get_time();
+    memset(out, 0, sizeof(*out));
+    std::lock_guard<std::mutex> guard(s_face_mutex);
+    s_face_state_us[s_face_state] += now - s_face_state_since_us;
+    s_face_state_since_us = now;
+    for (int i = 0; i < ELISA_FACE_STATE_COUNT; i++) {
+        out->state[i].time_us = s_face_state_us[i];
+        s_face_state_us[i] = 0;
+    }
+    out->commands = s_face_commands;
+    s_face_commands = 0;
+    out->interval_us = now - s_face_stats_since_us;
+    s_face_stats_since_us = now;
+}
+
+void elisa_face_cleanup(void) {}
+
+int elisa_caption_init(void) { return 0; }
+void elisa_caption_set_text(const char *text) { (void)text; }
+void elisa_caption_play(uint32_t duration_ms) { (void)duration_ms; }
+void elisa_caption_finish(void) {}
+void elisa_caption_clear(void) {}
+void elisa_caption_cleanup(void) {}
+
+void elisa_caption_take_stats(elisa_caption_stats_t *out) { memset(out, 0, sizeof(*out)); }
+
+void elisa_lipsync_finish(void) {}
+
+void elisa_lipsync_take_stats(elisa_lipsync_stats_t *out) {
+    static int64_t since_us = 0;
+    int64_t now = esp_timer_get_time();
+    memset(out, 0, sizeof(*out));
+    out->interval_us = now - since_us;
+    since_us = now;
+}
+
+// ── Direct API Mode ─────────────────────────────────────────────────────
+
+OpenAI_t *OpenAICreate(const char *api_key) {
+    (void)api_key;
+    fprintf(stderr, "turn_sim: direct API mode is not simulated; use a runtime config\n");
+    abort();
+}
+
+}  // extern "C"
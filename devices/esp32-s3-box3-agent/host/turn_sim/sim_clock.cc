@@ -0,0 +1,255 @@
+/**
+ * @file sim_clock.cc
+ * @brief Virtual clock and simulated tasks for turn_sim.
+ *
+ * Each task is a host thread with a scheduling record. A task is either
+ * running or blocked until a deadline (a timed wait, or a socket wait
+ * with a timeout). Whenever a task blocks, advance() checks whether any
+ * task is still running or has a ready socket; if none has, the clock
+ * jumps to the earliest deadline and those tasks are released. Waiters
+ * on a condition are released by wake_all() and re-check it themselves.
+ */
+
+#include "sim.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+
+namespace sim {
+
+struct Task {
+    std::string name;
+    std::function<void()> fn;
+    bool firmware = false;
+    int priority = 0;
+    int core = -1;
+
+    bool blocked = false;          /**< Waiting; does not hold the clock back */
+    int64_t deadline = kForever;   /**< While blocked */
+    int fd = -1;                   /**< While blocked on a socket */
+    short events = 0;
+    int wake_pipe[2] = { -1, -1 }; /**< Interrupts a socket wait */
+    uint32_t notify = 0;
+};
+
+namespace {
+
+std::mutex g_mutex;
+std::condition_variable g_cv;
+int64_t g_now_us = 0;
+std::vector<Task *> g_tasks;
+bool g_stalled = false;
+bool g_halted = false;
+thread_local Task *t_self = nullptr;
+
+/**
+ * After halt(): block the calling task for good. A task still finishing
+ * may wake_all() the parked ones, so each wakeup blocks again.
+ */
+[[noreturn]] void park(std::unique_lock<std::mutex> &lk, Task *t) {
+    for (;;) {
+        t->blocked = true;
+        g_cv.notify_all();
+        g_cv.wait(lk);
+    }
+}
+
+/** Release a blocked task: it holds the clock again until it blocks. */
+void release(Task *t) {
+    t->blocked = false;
+    g_stalled = false;
+    if (t->fd >= 0) {
+        char b = 1;
+        (void)!write(t->wake_pipe[1], &b, 1);
+    }
+}
+
+/**
+ * Called with the lock held whenever a task blocks or leaves. Moves the
+ * clock if, and only if, nothing else can happen first.
+ */
+void advance() {
+    if (g_halted) {
+        g_cv.notify_all(); /* halt() counts blocked tasks */
+        return;
+    }
+    std::vector<pollfd> fds;
+    int64_t next = kForever;
+    for (Task *t : g_tasks) {
+        if (!t->blocked) return;
+        if (t->fd >= 0) fds.push_back({ t->fd, t->events, 0 });
+        next = std::min(next, t->deadline);
+    }
+    if (g_tasks.empty()) return;
+    if (!fds.empty() && poll(fds.data(), fds.size(), 0) > 0) {
+        return; /* a socket is ready: its task wakes on its own */
+    }
+    if (next == kForever) {
+        g_stalled = true;
+        g_cv.notify_all();
+        return;
+    }
+
+    g_now_us = std::max(g_now_us, next);
+    for (Task *t : g_tasks) {
+        if (t->deadline <= g_now_us) release(t);
+    }
+    g_cv.notify_all();
+}
+
+void *thread_main(void *arg) {
+    Task *t = static_cast<Task *>(arg);
+    t_self = t;
+    set_thread_counted(t->firmware);
+    t->fn();
+    exit_task();
+}
+
+}  // namespace
+
+int64_t now_us() {
+    std::lock_guard<std::mutex> lk(g_mutex);
+    return g_now_us;
+}
+
+Task *spawn(const char *name, std::function<void()> fn, bool firmware, int priority, int core) {
+    Task *t = new Task;
+    t->name = name ? name : "task";
+    t->fn = std::move(fn);
+    if (pipe(t->wake_pipe) != 0) {
+        std::perror("turn_sim: pipe");
+        std::abort();
+    }
+    fcntl(t->wake_pipe[0], F_SETFL, O_NONBLOCK);
+    t->firmware = firmware;
+    t->priority = priority;
+    t->core = core;
+    {
+        std::lock_guard<std::mutex> lk(g_mutex);
+        g_tasks.push_back(t);
+        g_stalled = false;
+    }
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    pthread_attr_setstacksize(&attr, 1024 * 1024);
+    pthread_t thread;
+    int rc = pthread_create(&thread, &attr, thread_main, t);
+    pthread_attr_destroy(&attr);
+    if (rc != 0) {
+        std::lock_guard<std::mutex> lk(g_mutex);
+        g_tasks.erase(std::find(g_tasks.begin(), g_tasks.end(), t));
+        return nullptr;
+    }
+    return t;
+}
+
+Task *current() { return t_self; }
+
+void exit_task() {
+    Task *t = t_self;
+    if (t != nullptr) {
+        std::lock_guard<std::mutex> lk(g_mutex);
+        g_tasks.erase(std::find(g_tasks.begin(), g_tasks.end(), t));
+        advance();
+    }
+    /* The record stays: handles to a deleted task must not dangle */
+    pthread_exit(nullptr);
+}
+
+const char *task_name(const Task *task) { return task ? task->name.c_str() : "main"; }
+int task_priority(const Task *task) { return task ? task->priority : 0; }
+int task_core(const Task *task) { return task ? task->core : -1; }
+bool task_is_firmware(const Task *task) { return task && task->firmware; }
+
+int task_count() {
+    std::lock_guard<std::mutex> lk(g_mutex);
+    return (int)g_tasks.size();
+}
+
+std::unique_lock<std::mutex> lock() { return std::unique_lock<std::mutex>(g_mutex); }
+
+bool wait(std::unique_lock<std::mutex> &lk, int64_t deadline_us, const std::function<bool()> &ready) {
+    Task *t = t_self;
+    while (!ready()) {
+        if (g_now_us >= deadline_us) return false;
+        if (t == nullptr) {
+            g_cv.wait(lk); /* outside the clock: just watch */
+            continue;
+        }
+        if (g_halted) park(lk, t);
+        t->blocked = true;
+        t->deadline = deadline_us;
+        advance();
+        g_cv.wait(lk, [t] { return !t->blocked; });
+    }
+    return true;
+}
+
+void wake_all() {
+    for (Task *t : g_tasks) {
+        if (t->blocked && t->fd < 0) release(t);
+    }
+    g_cv.notify_all();
+}
+
+void sleep_until(int64_t deadline_us) {
+    auto lk = lock();
+    wait(lk, deadline_us, [] { return false; });
+}
+
+int wait_fd(int fd, short events, int64_t deadline_us) {
+    Task *t = t_self;
+    if (t == nullptr) {
+        pollfd p = { fd, events, 0 };
+        return poll(&p, 1, -1) > 0 ? 1 : 0;
+    }
+
+    std::unique_lock<std::mutex> lk(g_mutex);
+    t->fd = fd;
+    t->events = events;
+    t->deadline = deadline_us;
+    t->blocked = true;
+    advance();
+
+    for (;;) {
+        bool released = !t->blocked;
+        lk.unlock();
+        pollfd p[2] = { { fd, events, 0 }, { t->wake_pipe[0], POLLIN, 0 } };
+        int n = poll(p, 2, released ? 0 : -1);
+        char drain[16];
+        while (read(t->wake_pipe[0], drain, sizeof(drain)) > 0) {
+        }
+        lk.lock();
+        if (g_halted) park(lk, t);
+
+        bool ready = n > 0 && (p[0].revents != 0);
+        if (ready || !t->blocked || g_now_us >= deadline_us) {
+            t->fd = -1;
+            t->blocked = false;
+            return ready ? 1 : 0;
+        }
+    }
+}
+
+uint32_t *task_notify_value(Task *task) { return &task->notify; }
+
+bool stalled() { return g_stalled; }
+
+void halt() {
+    std::unique_lock<std::mutex> lk(g_mutex);
+    g_halted = true;
+    g_cv.wait(lk, [] {
+        return std::all_of(g_tasks.begin(), g_tasks.end(), [](const Task *t) { return t->blocked; });
+    });
+}
+
+}  // namespace sim
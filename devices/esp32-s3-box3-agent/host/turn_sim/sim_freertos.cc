@@ -0,0 +1,134 @@
+/**
+ * @file sim_freertos.cc
+ * @brief FreeRTOS, esp_timer and critical sections for turn_sim, on the
+ *        simulated clock (sim_clock.cc).
+ */
+
+#include "sim.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "freertos/task.h"
+
+struct EventGroupDef_t {
+    EventBits_t bits = 0;
+};
+
+namespace {
+
+std::recursive_mutex g_critical;
+
+sim::Task *task_of(TaskHandle_t handle) { return reinterpret_cast<sim::Task *>(handle); }
+
+/** Call without the scheduler lock: now_us() takes it. */
+int64_t deadline_after(TickType_t ticks) {
+    if (ticks == portMAX_DELAY) return sim::kForever;
+    return sim::now_us() + (int64_t)ticks * (1000000 / configTICK_RATE_HZ);
+}
+
+}  // namespace
+
+extern "C" {
+
+int64_t esp_timer_get_time(void) { return sim::now_us(); }
+
+void sim_enter_critical(portMUX_TYPE *mux) {
+    (void)mux;
+    g_critical.lock();
+}
+
+void sim_exit_critical(portMUX_TYPE *mux) {
+    (void)mux;
+    g_critical.unlock();
+}
+
+// ── Tasks ───────────────────────────────────────────────────────────────
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack_bytes,
+                                   void *arg, UBaseType_t priority, TaskHandle_t *handle,
+                                   BaseType_t core) {
+    (void)stack_bytes;
+    sim::Task *t = sim::spawn(name, [fn, arg] { fn(arg); }, true, (int)priority,
+                              core == tskNO_AFFINITY ? -1 : (int)core);
+    if (t == nullptr) return pdFAIL;
+    if (handle != nullptr) *handle = reinterpret_cast<TaskHandle_t>(t);
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    if (task != nullptr && task_of(task) != sim::current()) {
+        fprintf(stderr, "turn_sim: vTaskDelete() of another task is not simulated\n");
+        abort();
+    }
+    sim::exit_task();
+}
+
+void vTaskDelay(TickType_t ticks) { sim::sleep_until(deadline_after(ticks)); }
+
+TickType_t xTaskGetTickCount(void) {
+    return (TickType_t)(sim::now_us() / (1000000 / configTICK_RATE_HZ));
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+    return reinterpret_cast<TaskHandle_t>(sim::current());
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    auto lk = sim::lock();
+    (*sim::task_notify_value(task_of(task)))++;
+    sim::wake_all();
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks) {
+    uint32_t *value = sim::task_notify_value(sim::current());
+    int64_t deadline = deadline_after(ticks);
+    auto lk = sim::lock();
+    sim::wait(lk, deadline, [value] { return *value > 0; });
+    uint32_t taken = *value;
+    if (taken > 0) *value = clear_on_exit ? 0 : taken - 1;
+    return taken;
+}
+
+// ── Event Groups ────────────────────────────────────────────────────────
+
+EventGroupHandle_t xEventGroupCreate(void) { return new EventGroupDef_t; }
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits) {
+    auto lk = sim::lock();
+    group->bits |= bits;
+    sim::wake_all();
+    return group->bits;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits) {
+    auto lk = sim::lock();
+    EventBits_t before = group->bits;
+    group->bits &= ~bits;
+    return before;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group) {
+    auto lk = sim::lock();
+    return group->bits;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clear_on_exit,
+                                BaseType_t wait_for_all, TickType_t ticks) {
+    int64_t deadline = deadline_after(ticks);
+    auto lk = sim::lock();
+    auto satisfied = [&] {
+        EventBits_t set = group->bits & bits;
+        return wait_for_all ? set == bits : set != 0;
+    };
+    bool ok = sim::wait(lk, deadline, satisfied);
+    EventBits_t value = group->bits;
+    if (ok && clear_on_exit) group->bits &= ~bits;
+    return value;
+}
+
+}  // extern "C"
@@ -0,0 +1,236 @@
+/**
+ * @file sim_heap.cc
+ * @brief Simulated internal RAM and PSRAM for turn_sim.
+ *
+ * Every allocation routed here (sim_alloc.h, heap_caps_*) carries a
+ * small header naming the pool it was charged to, so a block freed on
+ * another task is returned to the right pool. Only allocations made on
+ * firmware tasks are charged; the stand-in runtime's use the same
+ * functions but cost nothing.
+ *
+ * Placement follows ESP-IDF with CONFIG_SPIRAM_USE_MALLOC: malloc() keeps
+ * blocks up to CONFIG_SPIRAM_MALLOC_ALWAYSINTERNAL (16 KB, the default)
+ * in internal RAM and tries PSRAM first for larger ones; heap_caps_*()
+ * with MALLOC_CAP_SPIRAM or MALLOC_CAP_INTERNAL is held to that pool.
+ * A pool over its capacity fails the allocation and calls the hook
+ * registered with heap_caps_register_failed_alloc_callback().
+ */
+
+#include "sim.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "esp_heap_caps.h"
+
+namespace sim {
+
+namespace {
+
+constexpr uint32_t kMagic = 0x5348454Du;      /* "MEHS" */
+constexpr uint8_t kUncharged = 0xFF;
+constexpr size_t kAlwaysInternal = 16 * 1024;
+
+struct alignas(16) Header {
+    uint32_t magic;
+    uint8_t pool;
+    uint8_t pad[3];
+    uint64_t size;
+};
+static_assert(sizeof(Header) == 16, "keeps blocks 16-byte aligned");
+
+std::mutex g_mutex;
+HeapStats g_stats = { { { 320 * 1024, 0, 0, 0 }, { 8 * 1024 * 1024, 0, 0, 0 } }, 0, 0, 0 };
+esp_alloc_failed_hook_t g_failed_hook = nullptr;
+thread_local bool t_counted = false;
+
+Header *header_of(void *p) {
+    Header *h = static_cast<Header *>(p) - 1;
+    if (h->magic != kMagic) {
+        fprintf(stderr, "turn_sim: free of a block not from sim_heap (%p)\n", p);
+        abort();
+    }
+    return h;
+}
+
+/** Charge @p size to the first pool in @p order with room. Lock held. */
+int charge(size_t size, const int *order, int count) {
+    for (int i = 0; i < count; i++) {
+        PoolStats &p = g_stats.pool[order[i]];
+        if (p.in_use + size <= p.capacity) {
+            p.in_use += size;
+            p.peak = std::max(p.peak, p.in_use);
+            p.peak_ever = std::max(p.peak_ever, p.in_use);
+            g_stats.allocs++;
+            g_stats.alloc_bytes += size;
+            return order[i];
+        }
+    }
+    g_stats.failed++;
+    return -1;
+}
+
+/**
+ * Allocate @p size bytes charged per @p caps (0 = plain malloc). Returns
+ * nullptr, after calling the failed-alloc hook, if no allowed pool has room.
+ */
+void *allocate(size_t size, uint32_t caps, const char *function) {
+    uint8_t pool = kUncharged;
+    if (t_counted) {
+        static const int kInternalFirst[] = { kInternal, kSpiram };
+        static const int kSpiramFirst[] = { kSpiram, kInternal };
+        const int *order;
+        int count;
+        if (caps & MALLOC_CAP_SPIRAM) {
+            order = kSpiramFirst, count = 1;
+        } else if (caps & (MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA)) {
+            order = kInternalFirst, count = 1;
+        } else if (caps == 0 && size > kAlwaysInternal) {
+            order = kSpiramFirst, count = 2;
+        } else {
+            order = kInternalFirst, count = 2;
+        }
+
+        int charged;
+        esp_alloc_failed_hook_t hook;
+        {
+            std::lock_guard<std::mutex> lk(g_mutex);
+            charged = charge(size, order, count);
+            hook = g_failed_hook;
+        }
+        if (charged < 0) {
+            if (hook != nullptr) hook(size, caps ? caps : MALLOC_CAP_DEFAULT, function);
+            return nullptr;
+        }
+        pool = (uint8_t)charged;
+    }
+
+    size_t rounded = (size + 15) & ~(size_t)15;
+    Header *h = static_cast<Header *>(::aligned_alloc(alignof(Header), sizeof(Header) + rounded));
+    if (h == nullptr) abort();
+    h->magic = kMagic;
+    h->pool = pool;
+    h->size = size;
+    return h + 1;
+}
+
+void release(void *p) {
+    if (p == nullptr) return;
+    Header *h = header_of(p);
+    if (h->pool != kUncharged) {
+        std::lock_guard<std::mutex> lk(g_mutex);
+        g_stats.pool[h->pool].in_use -= h->size;
+    }
+    h->magic = 0;
+    ::free(h);
+}
+
+void *reallocate(void *p, size_t size, uint32_t caps, const char *function) {
+    if (p == nullptr) return allocate(size, caps, function);
+    if (size == 0) {
+        release(p);
+        return nullptr;
+    }
+    size_t old = header_of(p)->size;
+    void *q = allocate(size, caps, function);
+    if (q == nullptr) return nullptr; /* p stays valid, as with realloc() */
+    memcpy(q, p, std::min(old, size));
+    release(p);
+    return q;
+}
+
+const PoolStats &pool_for(uint32_t caps) {
+    return g_stats.pool[(caps & MALLOC_CAP_SPIRAM) ? kSpiram : kInternal];
+}
+
+}  // namespace
+
+void configure_heap(size_t internal_bytes, size_t spiram_bytes) {
+    std::lock_guard<std::mutex> lk(g_mutex);
+    g_stats.pool[kInternal].capacity = internal_bytes;
+    g_stats.pool[kSpiram].capacity = spiram_bytes;
+}
+
+HeapStats heap_stats() {
+    std::lock_guard<std::mutex> lk(g_mutex);
+    return g_stats;
+}
+
+void mark_heap() {
+    std::lock_guard<std::mutex> lk(g_mutex);
+    for (PoolStats &p : g_stats.pool) p.peak = p.in_use;
+}
+
+void set_thread_counted(bool counted) { t_counted = counted; }
+
+}  // namespace sim
+
+// ── C Entry Points ──────────────────────────────────────────────────────
+
+extern "C" {
+
+void *sim_malloc(size_t size) { return sim::allocate(size, 0, "malloc"); }
+
+void *sim_calloc(size_t n, size_t size) {
+    if (size != 0 && n > SIZE_MAX / size) return nullptr;
+    void *p = sim::allocate(n * size, 0, "calloc");
+    if (p != nullptr) memset(p, 0, n * size);
+    return p;
+}
+
+void *sim_realloc(void *p, size_t size) { return sim::reallocate(p, size, 0, "realloc"); }
+
+void sim_free(void *p) { sim::release(p); }
+
+char *sim_strdup(const char *s) {
+    size_t n = strlen(s) + 1;
+    char *p = static_cast<char *>(sim::allocate(n, 0, "strdup"));
+    if (p != nullptr) memcpy(p, s, n);
+    return p;
+}
+
+void *heap_caps_malloc(size_t size, uint32_t caps) {
+    return sim::allocate(size, caps, "heap_caps_malloc");
+}
+
+void *heap_caps_calloc(size_t n, size_t size, uint32_t caps) {
+    if (size != 0 && n > SIZE_MAX / size) return nullptr;
+    void *p = sim::allocate(n * size, caps, "heap_caps_calloc");
+    if (p != nullptr) memset(p, 0, n * size);
+    return p;
+}
+
+void *heap_caps_realloc(void *p, size_t size, uint32_t caps) {
+    return sim::reallocate(p, size, caps, "heap_caps_realloc");
+}
+
+void heap_caps_free(void *p) { sim::release(p); }
+
+size_t heap_caps_get_total_size(uint32_t caps) {
+    std::lock_guard<std::mutex> lk(sim::g_mutex);
+    return sim::pool_for(caps).capacity;
+}
+
+size_t heap_caps_get_free_size(uint32_t caps) {
+    std::lock_guard<std::mutex> lk(sim::g_mutex);
+    const sim::PoolStats &p = sim::pool_for(caps);
+    return p.capacity - p.in_use;
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps) { return heap_caps_get_free_size(caps); }
+
+size_t heap_caps_get_minimum_free_size(uint32_t caps) {
+    std::lock_guard<std::mutex> lk(sim::g_mutex);
+    const sim::PoolStats &p = sim::pool_for(caps);
+    return p.capacity - p.peak_ever;
+}
+
+esp_err_t heap_caps_register_failed_alloc_callback(esp_alloc_failed_hook_t callback) {
+    std::lock_guard<std::mutex> lk(sim::g_mutex);
+    sim::g_failed_hook = callback;
+    return ESP_OK;
+}
+
+}  // extern "C"
@@ -0,0 +1,399 @@
+/**
+ * @file sim_http.cc
+ * @brief esp_http_client for turn_sim: plain HTTP/1.1 over a real
+ *        loopback TCP socket, every wait on the simulated clock.
+ *
+ * Covers what elisa_api.c uses: perform() with a POST field, and the
+ * open / write / fetch_headers / read / close steps with a per-call
+ * timeout, where a timed-out read or header fetch returns
+ * -ESP_ERR_HTTP_EAGAIN. Bodies are framed by Content-Length or by the
+ * server closing the connection; chunked encoding, redirects, keep-alive
+ * and TLS are not simulated.
+ *
+ * The client and its receive/transmit buffers are allocated through
+ * sim_malloc() as the real client allocates them, so a turn is charged
+ * for them.
+ */
+
+#include "sim.h"
+
+#include <arpa/inet.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <new>
+#include <poll.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "esp_http_client.h"
+#include "esp_log.h"
+#include "sim_alloc.h"
+
+namespace {
+
+const char *TAG = "sim_http";
+
+constexpr int kDefaultTimeoutMs = 5000;
+constexpr int kDefaultBufferSize = 512;
+
+}  // namespace
+
+struct esp_http_client {
+    std::string host;
+    uint16_t port;
+    std::string path;
+    bool https;
+    esp_http_client_method_t method;
+    int timeout_ms;
+    http_event_handle_cb handler;
+    void *user_data;
+
+    std::vector<std::pair<std::string, std::string>> headers;
+    const char *post_data;
+    int post_len;
+
+    char *rx_buffer;  /**< buffer_size bytes */
+    int rx_size;
+    char *tx_buffer;  /**< buffer_size_tx bytes */
+    int tx_size;
+
+    int fd;
+    std::string pending;      /**< Received past the header block, not yet read */
+    int status;
+    int64_t content_length;   /**< -1: delimited by close */
+    int64_t received;
+    bool closed_by_peer;
+};
+
+namespace {
+
+void dispatch(esp_http_client_handle_t c, esp_http_client_event_id_t id, void *data = nullptr,
+              int len = 0, char *key = nullptr, char *value = nullptr) {
+    if (c->handler == nullptr) return;
+    esp_http_client_event_t evt = {};
+    evt.event_id = id;
+    evt.client = c;
+    evt.data = data;
+    evt.data_len = len;
+    evt.user_data = c->user_data;
+    evt.header_key = key;
+    evt.header_value = value;
+    c->handler(&evt);
+}
+
+int64_t deadline_of(esp_http_client_handle_t c) {
+    return sim::now_us() + (int64_t)c->timeout_ms * 1000;
+}
+
+bool parse_url(esp_http_client_handle_t c, const char *url) {
+    std::string u = url;
+    size_t scheme = u.find("://");
+    if (scheme == std::string::npos) return false;
+    c->https = u.compare(0, scheme, "https") == 0;
+    size_t host_start = scheme + 3;
+    size_t path_start = u.find('/', host_start);
+    std::string authority = u.substr(host_start, path_start == std::string::npos
+                                                     ? std::string::npos : path_start - host_start);
+    c->path = path_start == std::string::npos ? "/" : u.substr(path_start);
+    size_t colon = authority.rfind(':');
+    c->port = c->https ? 443 : 80;
+    if (colon != std::string::npos) {
+        c->port = (uint16_t)atoi(authority.c_str() + colon + 1);
+        authority.resize(colon);
+    }
+    c->host = authority;
+    return !c->host.empty();
+}
+
+/** Send all of @p data before the client's timeout. */
+bool send_all(esp_http_client_handle_t c, const char *data, size_t len) {
+    int64_t deadline = deadline_of(c);
+    while (len > 0) {
+        ssize_t n = send(c->fd, data, len, MSG_NOSIGNAL);
+        if (n > 0) {
+            data += n;
+            len -= (size_t)n;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            if (sim::wait_fd(c->fd, POLLOUT, deadline) == 0) return false;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+esp_err_t connect_and_send_headers(esp_http_client_handle_t c, int write_len) {
+    if (c->https) {
+        ESP_LOGE(TAG, "https is not simulated: %s", c->host.c_str());
+        return ESP_ERR_HTTP_INVALID_TRANSPORT;
+    }
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(c->port);
+    const char *host = c->host == "localhost" ? "127.0.0.1" : c->host.c_str();
+    if (inet_pton(AF_INET, host, &addr.sin_addr) != 1) {
+        ESP_LOGE(TAG, "Only IPv4 literals resolve here: %s", c->host.c_str());
+        return ESP_ERR_HTTP_CONNECT;
+    }
+
+    c->fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (c->fd < 0) return ESP_ERR_HTTP_CONNECT;
+    int one = 1;
+    setsockopt(c->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (connect(c->fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+        int err = 0;
+        socklen_t len = sizeof(err);
+        if (errno != EINPROGRESS || sim::wait_fd(c->fd, POLLOUT, deadline_of(c)) == 0 ||
+            getsockopt(c->fd, SOL_SOCKET, SO_ERROR, &err, &len) != 0 || err != 0) {
+            ESP_LOGE(TAG, "Connect to %s:%u failed", c->host.c_str(), (unsigned)c->port);
+            close(c->fd);
+            c->fd = -1;
+            return ESP_ERR_HTTP_CONNECT;
+        }
+    }
+    dispatch(c, HTTP_EVENT_ON_CONNECTED);
+
+    static const char *kMethods[] = { "GET", "POST", "PUT", "DELETE" };
+    int n = snprintf(c->tx_buffer, (size_t)c->tx_size, "%s %s HTTP/1.1\r\nHost: %s:%u\r\n",
+                     kMethods[c->method], c->path.c_str(), c->host.c_str(), (unsigned)c->port);
+    std::string request(c->tx_buffer, (size_t)std::min(n, c->tx_size - 1));
+    for (const auto &h : c->headers) request += h.first + ": " + h.second + "\r\n";
+    if (write_len > 0 || c->method == HTTP_METHOD_POST || c->method == HTTP_METHOD_PUT) {
+        request += "Content-Length: " + std::to_string(write_len) + "\r\n";
+    }
+    request += "\r\n";
+    if (!send_all(c, request.data(), request.size())) return ESP_ERR_HTTP_WRITE_DATA;
+    dispatch(c, HTTP_EVENT_HEADERS_SENT);
+    return ESP_OK;
+}
+
+/** Receive once into pending. 1: got data, 0: timed out, -1: closed or failed. */
+int receive_some(esp_http_client_handle_t c, int64_t deadline) {
+    while (true) {
+        ssize_t n = recv(c->fd, c->rx_buffer, (size_t)c->rx_size, 0);
+        if (n > 0) {
+            c->pending.append(c->rx_buffer, (size_t)n);
+            return 1;
+        }
+        if (n == 0) {
+            c->closed_by_peer = true;
+            return -1;
+        }
+        if (errno == EINTR) continue;
+        if (errno != EAGAIN && errno != EWOULDBLOCK) return -1;
+        if (sim::wait_fd(c->fd, POLLIN, deadline) == 0) return 0;
+    }
+}
+
+/** Parse and dispatch the header block at the start of pending. */
+bool parse_headers(esp_http_client_handle_t c, size_t end) {
+    std::string block = c->pending.substr(0, end);
+    c->pending.erase(0, end + 4);
+
+    size_t line_end = block.find("\r\n");
+    std::string status_line = block.substr(0, line_end);
+    if (sscanf(status_line.c_str(), "HTTP/%*d.%*d %d", &c->status) != 1) return false;
+
+    c->content_length = -1;
+    size_t pos = line_end == std::string::npos ? block.size() : line_end + 2;
+    while (pos < block.size()) {
+        size_t next = block.find("\r\n", pos);
+        if (next == std::string::npos) next = block.size();
+        std::string line = block.substr(pos, next - pos);
+        pos = next + 2;
+        size_t colon = line.find(':');
+        if (colon == std::string::npos) continue;
+        std::string key = line.substr(0, colon);
+        size_t v = line.find_first_not_of(' ', colon + 1);
+        std::string value = v == std::string::npos ? "" : line.substr(v);
+        if (strcasecmp(key.c_str(), "Content-Length") == 0) c->content_length = atoll(value.c_str());
+        dispatch(c, HTTP_EVENT_ON_HEADER, nullptr, 0, &key[0], &value[0]);
+    }
+    return true;
+}
+
+void disconnect(esp_http_client_handle_t c) {
+    if (c->fd < 0) return;
+    close(c->fd);
+    c->fd = -1;
+    dispatch(c, HTTP_EVENT_DISCONNECTED);
+}
+
+}  // namespace
+
+extern "C" {
+
+esp_http_client_handle_t esp_http_client_init(const esp_http_client_config_t *config) {
+    void *mem = sim_malloc(sizeof(esp_http_client));
+    if (mem == nullptr) return nullptr;
+    esp_http_client_handle_t c = new (mem) esp_http_client();
+    c->method = config->method;
+    c->timeout_ms = config->timeout_ms > 0 ? config->timeout_ms : kDefaultTimeoutMs;
+    c->handler = config->event_handler;
+    c->user_data = config->user_data;
+    c->rx_size = config->buffer_size > 0 ? config->buffer_size : kDefaultBufferSize;
+    c->tx_size = config->buffer_size_tx > 0 ? config->buffer_size_tx : kDefaultBufferSize;
+    c->rx_buffer = static_cast<char *>(sim_malloc((size_t)c->rx_size));
+    c->tx_buffer = static_cast<char *>(sim_malloc((size_t)c->tx_size));
+    c->fd = -1;
+    c->content_length = -1;
+    if (c->rx_buffer == nullptr || c->tx_buffer == nullptr || config->url == nullptr ||
+        !parse_url(c, config->url)) {
+        esp_http_client_cleanup(c);
+        return nullptr;
+    }
+    return c;
+}
+
+esp_err_t esp_http_client_cleanup(esp_http_client_handle_t client) {
+    if (client == nullptr) return ESP_FAIL;
+    disconnect(client);
+    sim_free(client->rx_buffer);
+    sim_free(client->tx_buffer);
+    client->~esp_http_client();
+    sim_free(client);
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_header(esp_http_client_handle_t client, const char *key, const char *value) {
+    for (auto &h : client->headers) {
+        if (strcasecmp(h.first.c_str(), key) == 0) {
+            h.second = value;
+            return ESP_OK;
+        }
+    }
+    client->headers.emplace_back(key, value);
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_post_field(esp_http_client_handle_t client, const char *data, int len) {
+    client->post_data = data;
+    client->post_len = len;
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_timeout_ms(esp_http_client_handle_t client, int timeout_ms) {
+    client->timeout_ms = timeout_ms;
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_open(esp_http_client_handle_t client, int write_len) {
+    disconnect(client);
+    client->pending.clear();
+    client->status = 0;
+    client->content_length = -1;
+    client->received = 0;
+    client->closed_by_peer = false;
+    esp_err_t err = connect_and_send_headers(client, write_len);
+    if (err != ESP_OK) disconnect(client);
+    return err;
+}
+
+int esp_http_client_write(esp_http_client_handle_t client, const char *buffer, int len) {
+    if (client->fd < 0) return -1;
+    while (true) {
+        ssize_t n = send(client->fd, buffer, (size_t)len, MSG_NOSIGNAL);
+        if (n >= 0) return (int)n;
+        if (errno == EINTR) continue;
+        if (errno != EAGAIN && errno != EWOULDBLOCK) return -1;
+        if (sim::wait_fd(client->fd, POLLOUT, deadline_of(client)) == 0) return 0;
+    }
+}
+
+int64_t esp_http_client_fetch_headers(esp_http_client_handle_t client) {
+    if (client->fd < 0) return ESP_FAIL;
+    int64_t deadline = deadline_of(client);
+    size_t end;
+    while ((end = client->pending.find("\r\n\r\n")) == std::string::npos) {
+        int got = receive_some(client, deadline);
+        if (got == 0) return -ESP_ERR_HTTP_EAGAIN;
+        if (got < 0) return ESP_FAIL;
+    }
+    if (!parse_headers(client, end)) return ESP_FAIL;
+    return client->content_length > 0 ? client->content_length : 0;
+}
+
+int esp_http_client_read(esp_http_client_handle_t client, char *buffer, int len) {
+    if (esp_http_client_is_complete_data_received(client)) return 0;
+    if (client->pending.empty()) {
+        if (client->fd < 0 || client->closed_by_peer) return 0;
+        int got = receive_some(client, deadline_of(client));
+        if (got == 0) return -ESP_ERR_HTTP_EAGAIN;
+        if (got < 0) return client->closed_by_peer ? 0 : -1;
+    }
+    size_t n = std::min(client->pending.size(), (size_t)len);
+    if (client->content_length >= 0) {
+        n = std::min(n, (size_t)(client->content_length - client->received));
+    }
+    memcpy(buffer, client->pending.data(), n);
+    client->pending.erase(0, n);
+    client->received += (int64_t)n;
+    dispatch(client, HTTP_EVENT_ON_DATA, buffer, (int)n);
+    return (int)n;
+}
+
+esp_err_t esp_http_client_close(esp_http_client_handle_t client) {
+    disconnect(client);
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_perform(esp_http_client_handle_t client) {
+    int post_len = client->post_data != nullptr ? client->post_len : 0;
+    esp_err_t err = esp_http_client_open(client, post_len);
+    if (err != ESP_OK) {
+        dispatch(client, HTTP_EVENT_ERROR);
+        return err;
+    }
+    if (post_len > 0 && !send_all(client, client->post_data, (size_t)post_len)) {
+        disconnect(client);
+        return ESP_ERR_HTTP_WRITE_DATA;
+    }
+    if (esp_http_client_fetch_headers(client) < 0) {
+        dispatch(client, HTTP_EVENT_ERROR);
+        disconnect(client);
+        return ESP_ERR_HTTP_FETCH_HEADER;
+    }
+    while (!esp_http_client_is_complete_data_received(client)) {
+        int n = esp_http_client_read(client, client->rx_buffer, client->rx_size);
+        if (n == 0) break;
+        if (n < 0) {
+            dispatch(client, HTTP_EVENT_ERROR);
+            disconnect(client);
+            return n == -ESP_ERR_HTTP_EAGAIN ? ESP_ERR_TIMEOUT : ESP_FAIL;
+        }
+    }
+    dispatch(client, HTTP_EVENT_ON_FINISH);
+    disconnect(client);
+    return ESP_OK;
+}
+
+int esp_http_client_get_status_code(esp_http_client_handle_t client) { return client->status; }
+
+int64_t esp_http_client_get_content_length(esp_http_client_handle_t client) {
+    return client->content_length;
+}
+
+bool esp_http_client_is_chunked_response(esp_http_client_handle_t client) {
+    (void)client;
+    return false;
+}
+
+bool esp_http_client_is_complete_data_received(esp_http_client_handle_t client) {
+    if (client->content_length >= 0) return client->received >= client->content_length;
+    return client->closed_by_peer && client->pending.empty();
+}
+
+}  // extern "C"
@@ -0,0 +1,253 @@
+/**
+ * @file sim_models.cc
+ * @brief Stand-ins for the wake word model, its feature frontend and the
+ *        Opus decoder (see their headers in idf/). Each keeps its real
+ *        counterpart's interface, memory and timing shape, not its output.
+ */
+
+#include <cmath>
+#include <cstring>
+
+#include "frontend.h"
+#include "frontend_util.h"
+#include "micro_opus/ogg_opus_decoder.h"
+#include "tensorflow/lite/micro/sim_tflite.h"
+
+// ── Frontend ────────────────────────────────────────────────────────────
+
+namespace {
+
+/** dB of full scale at which a feature is 0; 20 counts per dB above it. */
+constexpr double kFloorDb = 60.0;
+constexpr double kCountsPerDb = 20.0;
+
+}  // namespace
+
+extern "C" int FrontendPopulateState(const struct FrontendConfig *config, struct FrontendState *state,
+                                     int sample_rate) {
+    if (config->filterbank.num_channels <= 0 ||
+        config->filterbank.num_channels > SIM_FRONTEND_MAX_CHANNELS) {
+        return 0;
+    }
+    state->num_channels = config->filterbank.num_channels;
+    state->step_samples = (size_t)(sample_rate * config->window.step_size_ms / 1000);
+    FrontendReset(state);
+    return 1;
+}
+
+extern "C" void FrontendReset(struct FrontendState *state) {
+    memset(state->values, 0, sizeof(state->values));
+}
+
+extern "C" void FrontendFreeStateContents(struct FrontendState *state) {
+    (void)state;
+}
+
+extern "C" struct FrontendOutput FrontendProcessSamples(struct FrontendState *state,
+                                                        const int16_t *samples, size_t num_samples,
+                                                        size_t *num_samples_read) {
+    struct FrontendOutput out = { nullptr, 0 };
+    if (num_samples < state->step_samples) {
+        *num_samples_read = num_samples;
+        return out;
+    }
+    size_t n = state->step_samples;
+    double energy = 0;
+    for (size_t i = 0; i < n; i++) energy += (double)samples[i] * samples[i];
+    double rms = std::sqrt(energy / (double)n);
+    double db = rms > 1 ? 20.0 * std::log10(rms) : 0;
+    double v = (db - kFloorDb) * kCountsPerDb;
+    uint16_t value = (uint16_t)(v < 0 ? 0 : v > 1023 ? 1023 : v);
+    for (int c = 0; c < state->num_channels; c++) state->values[c] = value;
+
+    *num_samples_read = n;
+    out.values = state->values;
+    out.size = (size_t)state->num_channels;
+    return out;
+}
+
+// ── Wake Word Model ─────────────────────────────────────────────────────
+
+namespace tflite {
+
+namespace {
+
+constexpr int kInputFrames = 3;
+constexpr int kInputFeatures = 40;
+
+/** Stand-ins for objects TFLite Micro places in the arena it is given. */
+MicroAllocator s_allocator;
+MicroResourceVariables s_resource_variables;
+
+}  // namespace
+
+unsigned long Model::version() const {
+    const uint8_t *p = reinterpret_cast<const uint8_t *>(this);
+    return memcmp(p + 4, "TFL3", 4) == 0 ? TFLITE_SCHEMA_VERSION : 0;
+}
+
+const Model *GetModel(const void *buf) { return static_cast<const Model *>(buf); }
+
+MicroAllocator *MicroAllocator::Create(uint8_t *arena, size_t size) {
+    return (arena != nullptr && size > 0) ? &s_allocator : nullptr;
+}
+
+MicroResourceVariables *MicroResourceVariables::Create(MicroAllocator *allocator, int count) {
+    return (allocator != nullptr && count > 0) ? &s_resource_variables : nullptr;
+}
+
+MicroInterpreter::MicroInterpreter(const Model *model, const MicroOpResolver &resolver,
+                                   uint8_t *arena, size_t arena_size,
+                                   MicroResourceVariables *resource_variables)
+    : model_(model), arena_(arena), arena_size_(arena_size) {
+    (void)resolver;
+    (void)resource_variables;
+}
+
+TfLiteStatus MicroInterpreter::AllocateTensors() {
+    size_t need = kInputFrames * kInputFeatures + 1;
+    if (model_ == nullptr || arena_ == nullptr || arena_size_ < need) return kTfLiteError;
+
+    input_dims_ = { 3, { 1, kInputFrames, kInputFeatures, 0 } };
+    input_.data.int8 = reinterpret_cast<int8_t *>(arena_);
+    input_.dims = &input_dims_;
+    input_.bytes = kInputFrames * kInputFeatures;
+
+    output_dims_ = { 2, { 1, 1, 0, 0 } };
+    output_.data.uint8 = arena_ + input_.bytes;
+    output_.dims = &output_dims_;
+    output_.bytes = 1;
+    return kTfLiteOk;
+}
+
+TfLiteStatus MicroInterpreter::Invoke() {
+    if (input_.data.raw == nullptr) return kTfLiteError;
+    int sum = 0;
+    for (size_t i = 0; i < input_.bytes; i++) sum += input_.data.int8[i];
+    output_.data.uint8[0] = sum > 0 ? 255 : 0;
+    return kTfLiteOk;
+}
+
+TfLiteTensor *MicroInterpreter::input(size_t index) { return index == 0 ? &input_ : nullptr; }
+TfLiteTensor *MicroInterpreter::output(size_t index) { return index == 0 ? &output_ : nullptr; }
+
+}  // namespace tflite
+
+// ── Ogg Opus ────────────────────────────────────────────────────────────
+
+namespace micro_opus {
+
+namespace {
+
+constexpr size_t kPageHeaderBytes = 27;
+constexpr double kToneHz = 220.0;
+constexpr double kToneAmplitude = 6000.0;
+
+/** Samples at 48 kHz in one Opus packet, from its TOC (RFC 6716 3.1). */
+int packet_samples(const uint8_t *packet, size_t len) {
+    if (len == 0) return 0;
+    int config = packet[0] >> 3;
+    int frame_samples;
+    if (config < 12) {
+        static const int kSilk[] = { 480, 960, 1920, 2880 };
+        frame_samples = kSilk[config & 3];
+    } else if (config < 16) {
+        frame_samples = (config & 1) ? 960 : 480;
+    } else {
+        static const int kCelt[] = { 120, 240, 480, 960 };
+        frame_samples = kCelt[config & 3];
+    }
+    int frames;
+    switch (packet[0] & 3) {
+    case 0: frames = 1; break;
+    case 1:
+    case 2: frames = 2; break;
+    default: frames = len > 1 ? (packet[1] & 0x3F) : 0; break;
+    }
+    return frame_samples * frames;
+}
+
+}  // namespace
+
+OggOpusDecoder::OggOpusDecoder(bool enable_crc, uint32_t sample_rate, uint8_t channels)
+    : sample_rate_(sample_rate), channels_(channels) {
+    (void)enable_crc;
+}
+
+OggOpusResult OggOpusDecoder::decode(const uint8_t *input, size_t input_len, uint8_t *output,
+                                     size_t output_bytes, size_t &bytes_consumed,
+                                     size_t &samples_decoded) {
+    bytes_consumed = 0;
+    samples_decoded = 0;
+
+    if (pending_next_ >= pending_count_) {
+        /* Next page: header, lacing table, packets */
+        if (input_len < kPageHeaderBytes) return OGG_OPUS_OK; /* end of stream */
+        if (memcmp(input, "OggS", 4) != 0 || input[4] != 0) return OGG_OPUS_INPUT_INVALID;
+        size_t segments = input[26];
+        if (input_len < kPageHeaderBytes + segments) return OGG_OPUS_INPUT_INVALID;
+        const uint8_t *lacing = input + kPageHeaderBytes;
+        const uint8_t *data = lacing + segments;
+        size_t body = 0;
+        for (size_t i = 0; i < segments; i++) body += lacing[i];
+        if (input_len < kPageHeaderBytes + segments + body) return OGG_OPUS_INPUT_INVALID;
+
+        pending_count_ = 0;
+        pending_next_ = 0;
+        size_t start = 0, len = 0;
+        for (size_t i = 0; i < segments; i++) {
+            len += lacing[i];
+            if (lacing[i] == 255 && i + 1 < segments) continue; /* packet continues */
+            const uint8_t *packet = data + start;
+            int samples;
+            if (len >= 8 && memcmp(packet, "OpusHead", 8) == 0) {
+                head_seen_ = true;
+                samples = -1;
+            } else if (len >= 8 && memcmp(packet, "OpusTags", 8) == 0) {
+                samples = -1;
+            } else if (!head_seen_) {
+                return OGG_OPUS_NOT_OPUS;
+            } else {
+                samples = packet_samples(packet, len);
+            }
+            if (pending_count_ < kMaxPending) {
+                pending_[pending_count_] = samples;
+                pending_bytes_[pending_count_] = len;
+                pending_count_++;
+            }
+            start += len;
+            len = 0;
+        }
+        if (pending_count_ == 0) {
+            bytes_consumed = kPageHeaderBytes + segments + body;
+            return OGG_OPUS_OK;
+        }
+        pending_bytes_[0] += kPageHeaderBytes + segments;
+    }
+
+    /* One audio packet per call, with any header packets before it */
+    size_t consumed = 0;
+    while (pending_next_ < pending_count_ && pending_[pending_next_] < 0) {
+        consumed += pending_bytes_[pending_next_++];
+    }
+    if (pending_next_ >= pending_count_) {
+        bytes_consumed = consumed;
+        return OGG_OPUS_OK;
+    }
+
+    size_t samples = (size_t)pending_[pending_next_] * sample_rate_ / 48000;
+    if (samples * channels_ * sizeof(int16_t) > output_bytes) return OGG_OPUS_OUTPUT_BUFFER_TOO_SMALL;
+    bytes_consumed = consumed + pending_bytes_[pending_next_++];
+
+    int16_t *pcm = reinterpret_cast<int16_t *>(output);
+    double step = 2.0 * M_PI * kToneHz / sample_rate_;
+    for (size_t i = 0; i < samples; i++) {
+        int16_t s = (int16_t)(kToneAmplitude * std::sin(step * phase_++));
+        for (int c = 0; c < channels_; c++) pcm[i * channels_ + c] = s;
+    }
+    phase_ %= sample_rate_;
+    samples_decoded = samples;
+    return OGG_OPUS_OK;
+}
+
+}  // namespace micro_opus
@@ -0,0 +1,526 @@
+/**
+ * @file turn_sim.cc
+ * @brief Runs the firmware's conversation turns on the host against a
+ *        stand-in runtime, on a simulated clock.
+ *
+ *   turn_sim [options] [out_dir]
+ *       Boots app_main() from elisa_main.c with the real config, API,
+ *       Opus, wake word, cancellation, trace, telemetry, latency and task
+ *       plan code, feeds it a scripted microphone, and answers its turns
+ *       from runtime_stub on a loopback socket. After --turns turns it
+ *       prints each turn's latency and heap use, the firmware's own
+ *       histograms and memory report, and host CPU time against the
+ *       simulated time it covered; out_dir gets turns.csv, the Chrome
+ *       trace (trace.json) and the microphone script (mic.wav).
+ *
+ *       --turns N         Turns to run (10)
+ *       --mic PATH        16 kHz mono WAV to loop instead of the script
+ *       --speaker PATH    Write what the speaker plays, as a 16 kHz WAV
+ *       --server-ms N     Runtime think time per turn (1500)
+ *       --reply-ms N      Reply audio length (3000)
+ *       --format F        Reply format: opus or mp3 (opus)
+ *       --internal-kb N   Internal RAM heap (320)
+ *       --psram-kb N      PSRAM heap (8192)
+ *       -v, -vv           Firmware logs at info / debug (default: warnings)
+ *
+ * Exits 1 if fewer than --turns turns completed or an allocation failed.
+ *
+ * Latencies are modelled, not measured: recording, the runtime's think
+ * time and playback take their simulated length, code takes none, and
+ * the loopback socket has no bandwidth limit. They show how the turn is
+ * sequenced (what waits on what) and move when that changes; compare
+ * the firmware's own timing on the device (LATENCY report, elisa_trace).
+ * The firmware's upload and decode histograms would always read 0 here,
+ * so the summary leaves them out.
+ * Allocation counts and peaks are the firmware's own: every malloc and
+ * heap_caps_malloc it makes goes through the simulated heap (sim_heap.cc).
+ */
+
+#include "sim.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <vector>
+
+#include "elisa_assets.h"
+#include "elisa_assets_bin.h"
+#include "elisa_config_bin.h"
+#include "elisa_latency.h"
+#include "elisa_telemetry.h"
+#include "elisa_trace.h"
+#include "runtime_stub.h"
+
+extern "C" void app_main(void);
+
+namespace {
+
+namespace fs = std::filesystem;
+
+constexpr int kSampleRate = 16000;
+constexpr size_t kAssetsPartitionSize = 1024 * 1024;
+constexpr size_t kConfigPartitionSize = 64 * 1024;
+
+struct Options {
+    int turns = 10;
+    std::string mic;
+    std::string speaker;
+    int server_ms = 1500;
+    int reply_ms = 3000;
+    runtime_stub::Format format = runtime_stub::Format::kOpus;
+    size_t internal_kb = 320;
+    size_t psram_kb = 8192;
+    char log_level = 'W';
+    std::string out_dir = "turn_sim_out";
+};
+
+// ── Turn Accounting ─────────────────────────────────────────────────────
+
+enum class Outcome { kOpen, kOk, kFailed, kCancelled };
+
+const char *outcome_name(Outcome o) {
+    switch (o) {
+    case Outcome::kOpen: return "open";
+    case Outcome::kOk: return "ok";
+    case Outcome::kFailed: return "failed";
+    case Outcome::kCancelled: return "cancelled";
+    }
+    return "?";
+}
+
+struct Turn {
+    Outcome outcome = Outcome::kOpen;
+    int64_t wake_us = -1;
+    int64_t speech_end_us = -1;
+    int64_t start_us = -1;        /**< start_openai() called */
+    int64_t first_audio_us = -1;
+    int64_t end_us = -1;
+    sim::HeapStats heap_start = {};
+    uint64_t allocs = 0;
+    uint64_t alloc_bytes = 0;
+    size_t peak[sim::kPoolCount] = {};       /**< Highest use during the turn */
+    int64_t retained[sim::kPoolCount] = {};  /**< Use at end minus use at wake */
+};
+
+/* Under sim::lock(): the driver waits on g_closed */
+std::vector<Turn> g_turns;
+int g_open = -1;      /**< Turn recording or waiting for the handler */
+int g_handling = -1;  /**< Turn inside start_openai() or playing */
+int g_closed = 0;
+
+void close_turn(int idx, Outcome outcome, int64_t now) {
+    Turn &t = g_turns[idx];
+    if (t.outcome != Outcome::kOpen) return;
+    sim::HeapStats h = sim::heap_stats();
+    t.outcome = outcome;
+    t.end_us = now;
+    t.allocs = h.allocs - t.heap_start.allocs;
+    t.alloc_bytes = h.alloc_bytes - t.heap_start.alloc_bytes;
+    for (int p = 0; p < sim::kPoolCount; p++) {
+        t.peak[p] = h.pool[p].peak;
+        t.retained[p] = (int64_t)h.pool[p].in_use - (int64_t)t.heap_start.pool[p].in_use;
+    }
+    g_closed++;
+    sim::wake_all();
+}
+
+// ── Fixtures ────────────────────────────────────────────────────────────
+
+void put32(std::vector<uint8_t> &buf, size_t off, uint32_t v) {
+    for (int i = 0; i < 4; i++) buf[off + i] = (uint8_t)(v >> (8 * i));
+}
+
+void put16(std::vector<uint8_t> &buf, size_t off, uint16_t v) {
+    buf[off] = (uint8_t)v;
+    buf[off + 1] = (uint8_t)(v >> 8);
+}
+
+size_t align_up(size_t n) {
+    return (n + ELISA_ASSETS_ALIGN - 1) / ELISA_ASSETS_ALIGN * ELISA_ASSETS_ALIGN;
+}
+
+struct Asset {
+    std::string name;
+    std::vector<uint8_t> data;
+};
+
+/** Same layout as buildAssetImage() in the backend (and assets_bench). */
+std::vector<uint8_t> pack(const std::vector<Asset> &assets) {
+    uint32_t buckets = 2;
+    while (buckets < assets.size() * 2) buckets *= 2;
+
+    size_t names_start = sizeof(elisa_assets_header_t) + buckets * sizeof(elisa_asset_entry_t);
+    std::vector<size_t> name_off, data_off;
+    size_t off = names_start;
+    for (const Asset &a : assets) {
+        name_off.push_back(off);
+        off += a.name.size() + 1;
+    }
+    size_t dir_end = align_up(std::max(off, names_start + 1));
+    off = dir_end;
+    for (const Asset &a : assets) {
+        data_off.push_back(off);
+        off = align_up(off + a.data.size());
+    }
+    size_t image_size = assets.empty() ? dir_end : data_off.back() + assets.back().data.size();
+
+    std::vector<uint8_t> buf(image_size);
+    for (size_t i = 0; i < assets.size(); i++) {
+        const Asset &a = assets[i];
+        uint32_t hash = elisa_assets_hash(a.name.c_str());
+        uint32_t b = hash & (buckets - 1);
+        auto entry_at = [&](uint32_t k) { return sizeof(elisa_assets_header_t) + k * sizeof(elisa_asset_entry_t); };
+        while (buf[entry_at(b) + 4] | buf[entry_at(b) + 5] | buf[entry_at(b) + 6] | buf[entry_at(b) + 7]) {
+            b = (b + 1) & (buckets - 1);
+        }
+        size_t e = entry_at(b);
+        put32(buf, e, hash);
+        put32(buf, e + 4, (uint32_t)name_off[i]);
+        put32(buf, e + 8, (uint32_t)data_off[i]);
+        put32(buf, e + 12, (uint32_t)a.data.size());
+        put32(buf, e + 16, elisa_config_crc32(a.data.data(), a.data.size()));
+        memcpy(&buf[name_off[i]], a.name.c_str(), a.name.size());
+        std::copy(a.data.begin(), a.data.end(), buf.begin() + (long)data_off[i]);
+    }
+
+    put32(buf, 0, ELISA_ASSETS_MAGIC);
+    put16(buf, 4, ELISA_ASSETS_VERSION);
+    put16(buf, 6, sizeof(elisa_assets_header_t));
+    put32(buf, 8, (uint32_t)image_size);
+    put16(buf, 12, (uint16_t)buckets);
+    put16(buf, 14, (uint16_t)assets.size());
+    put32(buf, 16, (uint32_t)(dir_end - sizeof(elisa_assets_header_t)));
+    put32(buf, 20, elisa_config_crc32(&buf[sizeof(elisa_assets_header_t)],
+                                      dir_end - sizeof(elisa_assets_header_t)));
+    return buf;
+}
+
+/** Runtime-mode config in the asset image; the config image slots start erased. */
+void add_partitions(int port) {
+    std::string json = "{\"agent_id\":\"turn-sim\",\"api_key\":\"sim-key\","
+                       "\"runtime_url\":\"http://127.0.0.1:" + std::to_string(port) + "\","
+                       "\"wifi_ssid\":\"turn_sim\",\"wifi_password\":\"\","
+                       "\"agent_name\":\"Turn Sim\",\"wake_word\":\"Hi Roo\"}";
+    std::vector<Asset> assets;
+    assets.push_back({ "runtime_config.json", std::vector<uint8_t>(json.begin(), json.end()) });
+    assets.push_back({ ELISA_ASSET_TTS_TURN_FAILED, runtime_stub::mp3(1200) });
+    sim::add_partition(ELISA_ASSETS_PARTITION_LABEL, ELISA_ASSETS_PARTITION_SUBTYPE,
+                       kAssetsPartitionSize, pack(assets));
+    sim::add_partition(ELISA_CONFIG_PARTITION_LABEL, ELISA_CONFIG_PARTITION_SUBTYPE,
+                       kConfigPartitionSize, {});
+}
+
+/**
+ * One turn of microphone script: quiet, a loud burst the stand-in wake
+ * word model fires on, a pause, speech, then quiet long enough for the
+ * reply to play out before the next burst.
+ */
+std::vector<int16_t> mic_script(const Options &opt) {
+    std::vector<int16_t> out;
+    auto tone = [&](int ms, double hz, double rms) {
+        double amplitude = rms * std::sqrt(2.0);
+        size_t n = (size_t)ms * kSampleRate / 1000;
+        for (size_t i = 0; i < n; i++) {
+            out.push_back((int16_t)(amplitude * std::sin(2 * M_PI * hz * (double)i / kSampleRate)));
+        }
+    };
+    tone(1200, 0, 0);          /* > 740 ms: the detector's warm-up after a reset */
+    tone(300, 440, 20000);     /* wake burst */
+    tone(400, 0, 0);
+    tone(2000, 180, 4000);     /* the user's request */
+    int tail_ms = sim::AudioConfig().end_silence_ms + opt.server_ms + opt.reply_ms + 3000;
+    tone(tail_ms, 0, 0);
+    return out;
+}
+
+bool write_file(const fs::path &path, const std::vector<uint8_t> &data) {
+    FILE *f = fopen(path.c_str(), "wb");
+    if (f == nullptr) return false;
+    bool ok = fwrite(data.data(), 1, data.size(), f) == data.size();
+    return fclose(f) == 0 && ok;
+}
+
+// ── Report ──────────────────────────────────────────────────────────────
+
+double cpu_seconds() {
+    rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return (double)(ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) +
+           (double)(ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) / 1e6;
+}
+
+double ms_between(int64_t from, int64_t to) {
+    return (from < 0 || to < 0) ? -1 : (double)(to - from) / 1000.0;
+}
+
+void print_percentiles(const char *name, std::vector<double> v) {
+    if (v.empty()) return;
+    std::sort(v.begin(), v.end());
+    auto pct = [&](int p) { return v[std::min(v.size() - 1, (v.size() * p + 99) / 100 - 1)]; };
+    printf("  %-26s p50 %8.1f  p90 %8.1f  max %8.1f ms\n", name, pct(50), pct(90), v.back());
+}
+
+void write_csv(const fs::path &path) {
+    FILE *f = fopen(path.c_str(), "w");
+    if (f == nullptr) return;
+    fprintf(f, "turn,outcome,wake_to_audio_ms,speech_end_to_audio_ms,total_ms,allocs,alloc_bytes,"
+               "internal_peak,spiram_peak,internal_retained,spiram_retained\n");
+    for (size_t i = 0; i < g_turns.size(); i++) {
+        const Turn &t = g_turns[i];
+        fprintf(f, "%zu,%s,%.1f,%.1f,%.1f,%llu,%llu,%zu,%zu,%lld,%lld\n", i + 1,
+                outcome_name(t.outcome), ms_between(t.wake_us, t.first_audio_us),
+                ms_between(t.speech_end_us, t.first_audio_us), ms_between(t.wake_us, t.end_us),
+                (unsigned long long)t.allocs, (unsigned long long)t.alloc_bytes,
+                t.peak[sim::kInternal], t.peak[sim::kSpiram],
+                (long long)t.retained[sim::kInternal], (long long)t.retained[sim::kSpiram]);
+    }
+    fclose(f);
+}
+
+void report(const Options &opt, const runtime_stub::Server &server, double cpu_s) {
+    int64_t virtual_us = sim::now_us();
+    sim::HeapStats heap = sim::heap_stats();
+
+    printf("%4s  %-9s  %14s  %16s  %9s  %7s  %9s  %11s  %11s  %12s\n", "turn", "outcome",
+           "wake_audio_ms", "speech_audio_ms", "total_ms", "allocs", "alloc_kB", "int_peak_kB",
+           "psram_kB", "int_retain_B");
+    std::vector<double> wake_audio, speech_audio, total;
+    uint64_t allocs = 0;
+    int ok = 0;
+    for (size_t i = 0; i < g_turns.size(); i++) {
+        const Turn &t = g_turns[i];
+        double wa = ms_between(t.wake_us, t.first_audio_us);
+        double sa = ms_between(t.speech_end_us, t.first_audio_us);
+        double tt = ms_between(t.wake_us, t.end_us);
+        printf("%4zu  %-9s  %14.1f  %16.1f  %9.1f  %7llu  %9.1f  %11.1f  %11.1f  %12lld\n", i + 1,
+               outcome_name(t.outcome), wa, sa, tt, (unsigned long long)t.allocs,
+               (double)t.alloc_bytes / 1024, (double)t.peak[sim::kInternal] / 1024,
+               (double)t.peak[sim::kSpiram] / 1024, (long long)t.retained[sim::kInternal]);
+        if (t.outcome != Outcome::kOk) continue;
+        ok++;
+        wake_audio.push_back(wa);
+        speech_audio.push_back(sa);
+        total.push_back(tt);
+        allocs += t.allocs;
+    }
+
+    printf("\n%d of %zu turns ok (%s reply %d ms, server %d ms)\n", ok, g_turns.size(),
+           opt.format == runtime_stub::Format::kOpus ? "opus" : "mp3", opt.reply_ms, opt.server_ms);
+    print_percentiles("wake -> first audio", wake_audio);
+    print_percentiles("speech end -> first audio", speech_audio);
+    print_percentiles("wake -> playback end", total);
+    if (ok > 0) printf("  allocations per turn       %.1f\n", (double)allocs / ok);
+    printf("  heap peak                  internal %.1f / %zu kB, PSRAM %.1f / %zu kB, %llu failed\n",
+           (double)heap.pool[sim::kInternal].peak_ever / 1024, opt.internal_kb,
+           (double)heap.pool[sim::kSpiram].peak_ever / 1024, opt.psram_kb,
+           (unsigned long long)heap.failed);
+    printf("  host CPU                   %.3f s for %.1f s simulated (%.0fx)\n", cpu_s,
+           (double)virtual_us / 1e6, cpu_s > 0 ? (double)virtual_us / 1e6 / cpu_s : 0.0);
+
+    /* The firmware's histograms: what heartbeats already reported plus the rest */
+    runtime_stub::Stats stats = server.stats();
+    static elisa_latency_hist_t hists[LAT_METRIC_COUNT];
+    elisa_latency_take(hists);
+    printf("\nfirmware latency histograms (%llu heartbeat reports merged)\n",
+           (unsigned long long)stats.reports_merged);
+    for (int m = 0; m < LAT_METRIC_COUNT; m++) {
+        /* Not modelled: no link bandwidth, and decoding takes no time */
+        if (m == LAT_UPLOAD || m == LAT_DECODE) continue;
+        const char *name = elisa_latency_metric_name((elisa_latency_metric_t)m);
+        runtime_stub::MergedMetric merged = stats.latency[name];
+        uint64_t count = merged.count + hists[m].total;
+        uint64_t sum = merged.sum_ms + hists[m].sum_ms;
+        uint64_t max = std::max<uint64_t>(merged.max_ms, hists[m].max_ms);
+        printf("  %-16s count %4llu  mean %8.1f  max %6llu ms\n", name, (unsigned long long)count,
+               count ? (double)sum / (double)count : 0.0, (unsigned long long)max);
+    }
+    printf("\n");
+    elisa_mem_print_report(stdout);
+}
+
+bool parse_args(int argc, char **argv, Options *opt) {
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        auto value = [&]() -> const char * { return i + 1 < argc ? argv[++i] : nullptr; };
+        const char *v = nullptr;
+        if (a == "-v") {
+            opt->log_level = 'I';
+        } else if (a == "-vv") {
+            opt->log_level = 'D';
+        } else if (a == "--turns" && (v = value())) {
+            opt->turns = atoi(v);
+        } else if (a == "--mic" && (v = value())) {
+            opt->mic = v;
+        } else if (a == "--speaker" && (v = value())) {
+            opt->speaker = v;
+        } else if (a == "--server-ms" && (v = value())) {
+            opt->server_ms = atoi(v);
+        } else if (a == "--reply-ms" && (v = value())) {
+            opt->reply_ms = atoi(v);
+        } else if (a == "--format" && (v = value())) {
+            if (strcmp(v, "opus") == 0) {
+                opt->format = runtime_stub::Format::kOpus;
+            } else if (strcmp(v, "mp3") == 0) {
+                opt->format = runtime_stub::Format::kMp3;
+            } else {
+                return false;
+            }
+        } else if (a == "--internal-kb" && (v = value())) {
+            opt->internal_kb = (size_t)atol(v);
+        } else if (a == "--psram-kb" && (v = value())) {
+            opt->psram_kb = (size_t)atol(v);
+        } else if (!a.empty() && a[0] != '-') {
+            opt->out_dir = a;
+        } else {
+            return false;
+        }
+    }
+    return opt->turns > 0 && opt->server_ms >= 0 && opt->reply_ms > 0;
+}
+
+}  // namespace
+
+// ── Hooks (sim.h) ───────────────────────────────────────────────────────
+
+namespace sim {
+
+void on_wake() {
+    int64_t now = now_us();
+    auto lk = lock();
+    if (g_open >= 0) close_turn(g_open, Outcome::kCancelled, now);
+    if (g_handling >= 0) close_turn(g_handling, Outcome::kCancelled, now);
+    Turn t;
+    t.wake_us = now;
+    t.heap_start = heap_stats();
+    mark_heap();
+    g_turns.push_back(t);
+    g_open = (int)g_turns.size() - 1;
+}
+
+void on_speech_end(int64_t at_us) {
+    auto lk = lock();
+    if (g_open >= 0) g_turns[g_open].speech_end_us = at_us;
+}
+
+void on_turn_start() {
+    int64_t now = now_us();
+    auto lk = lock();
+    g_handling = g_open;
+    g_open = -1;
+    if (g_handling >= 0) g_turns[g_handling].start_us = now;
+}
+
+void on_turn_returned(int err) {
+    int64_t now = now_us();
+    auto lk = lock();
+    if (err != 0 && g_handling >= 0) {
+        close_turn(g_handling, Outcome::kFailed, now);
+        g_handling = -1;
+    }
+}
+
+void on_playback_start() {
+    int64_t now = now_us();
+    auto lk = lock();
+    if (g_handling >= 0 && g_turns[g_handling].first_audio_us < 0) {
+        g_turns[g_handling].first_audio_us = now;
+    }
+}
+
+void on_playback_end(bool stopped) {
+    int64_t now = now_us();
+    auto lk = lock();
+    if (g_handling >= 0 && g_turns[g_handling].first_audio_us >= 0) {
+        close_turn(g_handling, stopped ? Outcome::kCancelled : Outcome::kOk, now);
+        g_handling = -1;
+    }
+}
+
+}  // namespace sim
+
+int main(int argc, char **argv) {
+    Options opt;
+    if (!parse_args(argc, argv, &opt)) {
+        fprintf(stderr, "usage: turn_sim [--turns N] [--mic WAV] [--speaker WAV] [--server-ms N] "
+                        "[--reply-ms N] [--format opus|mp3] [--internal-kb N] [--psram-kb N] "
+                        "[-v|-vv] [out_dir]\n");
+        return 2;
+    }
+    std::error_code ec;
+    fs::create_directories(opt.out_dir, ec);
+    fs::path out = opt.out_dir;
+
+    sim::configure_heap(opt.internal_kb * 1024, opt.psram_kb * 1024);
+    sim::set_log_level(opt.log_level);
+
+    sim::AudioConfig audio;
+    audio.mic_path = opt.mic;
+    audio.speaker_path = opt.speaker;
+    if (audio.mic_path.empty()) {
+        audio.mic_path = (out / "mic.wav").string();
+        if (!write_file(audio.mic_path, runtime_stub::wav(mic_script(opt)))) {
+            fprintf(stderr, "turn_sim: cannot write %s\n", audio.mic_path.c_str());
+            return 2;
+        }
+    }
+    if (!sim::configure_audio(audio)) return 2;
+
+    runtime_stub::Host host;
+    host.now_us = sim::now_us;
+    host.sleep_until = sim::sleep_until;
+    host.wait_fd = sim::wait_fd;
+    host.spawn = [](const char *name, std::function<void()> fn) { sim::spawn(name, std::move(fn), false); };
+    runtime_stub::Options stub_opt;
+    stub_opt.think_ms = opt.server_ms;
+    stub_opt.reply_ms = opt.reply_ms;
+    stub_opt.format = opt.format;
+    runtime_stub::Server server(host, stub_opt);
+    int port = server.start(0);
+    if (port < 0) {
+        perror("turn_sim: runtime_stub");
+        return 2;
+    }
+    add_partitions(port);
+
+    /* The UART console reads stdin: give it nothing */
+    if (freopen("/dev/null", "r", stdin) == nullptr) return 2;
+
+    double cpu_start = cpu_seconds();
+    sim::spawn("main", [] { app_main(); }, true, 1, 0);
+
+    /* Each scripted turn takes well under a minute of simulated time */
+    int64_t limit_us = (int64_t)opt.turns * 60 * 1000000 + 60 * 1000000;
+    {
+        auto lk = sim::lock();
+        sim::wait(lk, limit_us, [&] { return g_closed >= opt.turns || sim::stalled(); });
+    }
+    sim::halt();
+    double cpu_s = cpu_seconds() - cpu_start;
+
+    report(opt, server, cpu_s);
+    write_csv(out / "turns.csv");
+    FILE *trace = fopen((out / "trace.json").c_str(), "w");
+    if (trace != nullptr) {
+        elisa_trace_dump(trace);
+        fclose(trace);
+    }
+    sim::close_audio();
+
+    bool ok = g_closed >= opt.turns && sim::heap_stats().failed == 0 &&
+              std::all_of(g_turns.begin(), g_turns.begin() + std::min<size_t>(g_turns.size(), opt.turns),
+                          [](const Turn &t) { return t.outcome == Outcome::kOk; });
+    if (g_closed < opt.turns) {
+        fprintf(stderr, "turn_sim: %d of %d turns completed%s\n", g_closed, opt.turns,
+                sim::stalled() ? " (every task blocked with nothing to wait for)" : "");
+    }
+    fflush(stdout);
+    fflush(stderr);
+    /* Firmware tasks are parked, not joined: skip static destructors */
+    _exit(ok ? 0 : 1);
+}
@@ -0,0 +1,287 @@
+/**
+ * @file viseme_bench.cc
+ * @brief Accuracy and cost of the lip-sync analyzer (elisa_viseme.c).
+ *
+ *   viseme_bench
+ *       Synthesizes vowels (formant resonators on a 120 Hz pulse train),
+ *       a nasal, a fricative and silence at the rates the player uses,
+ *       prints how often each is classified as its expected viseme and
+ *       the analyzer time per 20 ms window. Exits 1 if a phone is
+ *       recognized in fewer than 80% of its windows.
+ *
+ *   viseme_bench speech.wav
+ *       Prints one viseme and level per window of a 16-bit PCM WAV
+ *       (mono or stereo, e.g. a TTS reply), then the analyzer time.
+ *
+ * Host time is not device time: the budget on the BOX-3 is the
+ * `STATS lipsync` line (analyze_avg_us, analyze_max_us) while speaking.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "elisa_viseme.h"
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kPhoneSeconds = 0.3;
+constexpr double kGapSeconds = 0.1;
+constexpr double kPassRatio = 0.8;
+constexpr int kTimingRepeats = 20;
+
+// ── Synthesis ───────────────────────────────────────────────────────────
+
+/** Two-pole resonator (Klatt), unity gain at DC. */
+struct Resonator {
+    double a, b, c, y1 = 0, y2 = 0;
+    Resonator(double freq, double bw, double rate) {
+        double r = std::exp(-kPi * bw / rate);
+        c = -r * r;
+        b = 2 * r * std::cos(2 * kPi * freq / rate);
+        a = 1 - b - c;
+    }
+    double step(double x) {
+        double y = a * x + b * y1 + c * y2;
+        y2 = y1;
+        y1 = y;
+        return y;
+    }
+};
+
+struct Phone {
+    const char *name;
+    elisa_viseme_t expect;
+    double f[3], bw[3];     // formants; f[0] == 0: noise source
+    double peak;            // relative to full scale
+};
+
+// Formants of American English vowels (Peterson & Barney averages),
+// and a nasal murmur 12 dB under the vowels, as in running speech
+const Phone kPhones[] = {
+    { "a (father)", ELISA_VISEME_OPEN,   { 730, 1090, 2440 }, { 80, 90, 120 }, 0.5 },
+    { "ae (cat)",   ELISA_VISEME_OPEN,   { 660, 1720, 2410 }, { 80, 90, 120 }, 0.5 },
+    { "e (bed)",    ELISA_VISEME_WIDE,   { 530, 1840, 2480 }, { 60, 90, 120 }, 0.5 },
+    { "i (see)",    ELISA_VISEME_WIDE,   { 270, 2290, 3010 }, { 60, 90, 120 }, 0.5 },
+    { "o (law)",    ELISA_VISEME_ROUND,  { 570, 840, 2410 },  { 60, 90, 120 }, 0.5 },
+    { "u (blue)",   ELISA_VISEME_ROUND,  { 300, 870, 2240 },  { 60, 90, 120 }, 0.5 },
+    { "m",          ELISA_VISEME_CLOSED, { 250, 1200, 2300 }, { 60, 500, 500 }, 0.125 },
+    { "s",          ELISA_VISEME_TEETH,  { 0, 6000, 0 },      { 0, 2500, 0 },    0.25 },
+    { "silence",    ELISA_VISEME_REST,   { 0, 0, 0 },         { 0, 0, 0 },       0 },
+};
+constexpr size_t kPhoneCount = sizeof(kPhones) / sizeof(kPhones[0]);
+
+/** Scale samples from `from` on to a peak of `peak` (full scale = 1). */
+void normalize(std::vector<double> &x, size_t from, double peak) {
+    double max = 1e-12;
+    for (size_t i = from; i < x.size(); i++) max = std::max(max, std::fabs(x[i]));
+    for (size_t i = from; i < x.size(); i++) x[i] *= peak / max;
+}
+
+/** Append one phone at its peak level, or a -80 dBFS noise gap when phone is null. */
+void synth(std::vector<double> &out, const Phone *phone, double seconds, double rate,
+           std::mt19937 &rng) {
+    size_t n = static_cast<size_t>(seconds * rate);
+    size_t from = out.size();
+    std::normal_distribution<double> noise(0.0, 1.0);
+    if (phone == nullptr || (phone->f[0] == 0 && phone->f[1] == 0)) {
+        for (size_t i = 0; i < n; i++) out.push_back(noise(rng) * 1e-4);
+        return;
+    }
+    if (phone->f[0] == 0) {
+        // Fricative: noise through one resonator, high-passed by a difference
+        Resonator r(phone->f[1], phone->bw[1], rate);
+        double prev = 0;
+        for (size_t i = 0; i < n; i++) {
+            double x = noise(rng);
+            out.push_back(r.step(x - prev));
+            prev = x;
+        }
+    } else {
+        Resonator r1(phone->f[0], phone->bw[0], rate), r2(phone->f[1], phone->bw[1], rate),
+            r3(phone->f[2], phone->bw[2], rate);
+        // -12 dB/octave glottal pulses, +6 dB/octave lip radiation
+        Resonator tilt(0, 100, rate);
+        size_t period = static_cast<size_t>(rate / 120.0);
+        double prev = 0;
+        for (size_t i = 0; i < n; i++) {
+            double g = tilt.step((i % period == 0) ? 1.0 : 0.0);
+            out.push_back(r3.step(r2.step(r1.step(g - prev))));
+            prev = g;
+        }
+    }
+    normalize(out, from, phone->peak);
+}
+
+/** Convert to 16-bit PCM and interleave channels. */
+std::vector<int16_t> to_pcm(const std::vector<double> &x, int channels) {
+    std::vector<int16_t> pcm;
+    pcm.reserve(x.size() * channels);
+    for (double v : x) {
+        int16_t s = static_cast<int16_t>(std::lround(std::clamp(v, -1.0, 1.0) * 32767));
+        for (int c = 0; c < channels; c++) pcm.push_back(s);
+    }
+    return pcm;
+}
+
+// ── Analysis ────────────────────────────────────────────────────────────
+
+std::vector<elisa_viseme_frame_t> analyze(const std::vector<int16_t> &pcm, uint32_t rate,
+                                          int channels, double *ns_per_window) {
+    std::vector<elisa_viseme_frame_t> frames;
+    elisa_viseme_analyzer_t a;
+    if (elisa_viseme_init(&a, rate, static_cast<uint8_t>(channels)) != 0) return frames;
+
+    size_t total = pcm.size() / channels;
+    frames.resize(total / elisa_viseme_window_frames(&a) + 1);
+    size_t n = elisa_viseme_feed(&a, pcm.data(), total, frames.data(), frames.size());
+    frames.resize(n);
+
+    // Timing: the same stream again, fed in player-sized chunks
+    constexpr size_t kChunk = 1152;
+    auto t0 = std::chrono::steady_clock::now();
+    size_t windows = 0;
+    for (int rep = 0; rep < kTimingRepeats; rep++) {
+        elisa_viseme_reset(&a);
+        elisa_viseme_frame_t out[4];
+        for (size_t off = 0; off < total; off += kChunk) {
+            size_t len = std::min(kChunk, total - off);
+            windows += elisa_viseme_feed(&a, pcm.data() + off * channels, len, out, 4);
+        }
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+    *ns_per_window = windows ? ns / windows : 0;
+    return frames;
+}
+
+void print_timing(double ns_per_window) {
+    double share = ns_per_window / (ELISA_VISEME_WINDOW_MS * 1e6) * 100;
+    std::printf("  analyzer: %.0f ns per %d ms window, %.3f%% of one host core in real time\n",
+                ns_per_window, ELISA_VISEME_WINDOW_MS, share);
+}
+
+// ── Commands ────────────────────────────────────────────────────────────
+
+int bench_synthetic() {
+    struct Format { uint32_t rate; int channels; };
+    const Format formats[] = { { 48000, 1 }, { 24000, 1 }, { 44100, 2 }, { 16000, 1 } };
+    bool pass = true;
+
+    for (const Format &fmt : formats) {
+        std::mt19937 rng(1);
+        std::vector<double> x;
+        std::vector<size_t> start(kPhoneCount);
+        for (size_t p = 0; p < kPhoneCount; p++) {
+            synth(x, nullptr, kGapSeconds, fmt.rate, rng);
+            start[p] = x.size();
+            synth(x, &kPhones[p], kPhoneSeconds, fmt.rate, rng);
+        }
+        std::vector<int16_t> pcm = to_pcm(x, fmt.channels);
+
+        double ns = 0;
+        std::vector<elisa_viseme_frame_t> frames = analyze(pcm, fmt.rate, fmt.channels, &ns);
+        size_t window = static_cast<size_t>(fmt.rate) * ELISA_VISEME_WINDOW_MS / 1000;
+
+        std::printf("%u Hz, %d ch\n", static_cast<unsigned>(fmt.rate), fmt.channels);
+        for (size_t p = 0; p < kPhoneCount; p++) {
+            // Windows entirely inside the phone
+            size_t first = (start[p] + window - 1) / window;
+            size_t last = (start[p] + static_cast<size_t>(kPhoneSeconds * fmt.rate)) / window;
+            size_t hits = 0, total = 0;
+            int seen[ELISA_VISEME_COUNT] = {};
+            for (size_t w = first; w < last && w < frames.size(); w++, total++) {
+                seen[frames[w].viseme]++;
+                if (frames[w].viseme == kPhones[p].expect) hits++;
+            }
+            double ratio = total ? static_cast<double>(hits) / total : 0;
+            if (ratio < kPassRatio) pass = false;
+            std::printf("  %-11s expect %-6s %3zu/%-3zu", kPhones[p].name,
+                        elisa_viseme_name(kPhones[p].expect), hits, total);
+            for (int v = 0; v < ELISA_VISEME_COUNT; v++) {
+                if (seen[v] && v != kPhones[p].expect) {
+                    std::printf("  %s=%d", elisa_viseme_name(static_cast<elisa_viseme_t>(v)), seen[v]);
+                }
+            }
+            std::printf("%s\n", ratio < kPassRatio ? "  FAIL" : "");
+        }
+        print_timing(ns);
+    }
+    return pass ? 0 : 1;
+}
+
+uint32_t get_le32(const uint8_t *p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+int bench_wav(const std::string &path) {
+    std::ifstream in(path, std::ios::binary);
+    std::vector<uint8_t> wav((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (wav.size() < 12 || std::memcmp(wav.data(), "RIFF", 4) != 0 ||
+        std::memcmp(wav.data() + 8, "WAVE", 4) != 0) {
+        std::fprintf(stderr, "%s is not a WAV file\n", path.c_str());
+        return 1;
+    }
+
+    uint32_t rate = 0;
+    int channels = 0;
+    std::vector<int16_t> pcm;
+    size_t pos = 12;
+    while (pos + 8 <= wav.size()) {
+        const uint8_t *chunk = wav.data() + pos;
+        size_t size = get_le32(chunk + 4);
+        if (pos + 8 + size > wav.size()) size = wav.size() - pos - 8;
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && size >= 16) {
+            uint16_t fmt = static_cast<uint16_t>(chunk[8] | (chunk[9] << 8));
+            uint16_t bits = static_cast<uint16_t>(chunk[22] | (chunk[23] << 8));
+            channels = chunk[10] | (chunk[11] << 8);
+            rate = get_le32(chunk + 12);
+            if (fmt != 1 || bits != 16) channels = 0;
+        } else if (std::memcmp(chunk, "data", 4) == 0 && channels > 0) {
+            pcm.resize(size / 2);
+            std::memcpy(pcm.data(), chunk + 8, pcm.size() * 2);   // little-endian host
+        }
+        pos += 8 + size + (size & 1);
+    }
+    if (pcm.empty() || channels > 2 || rate < ELISA_VISEME_MIN_RATE) {
+        std::fprintf(stderr, "%s: need 16-bit PCM, 1-2 channels, >= %d Hz\n", path.c_str(),
+                     ELISA_VISEME_MIN_RATE);
+        return 1;
+    }
+
+    double ns = 0;
+    std::vector<elisa_viseme_frame_t> frames = analyze(pcm, rate, channels, &ns);
+    int count[ELISA_VISEME_COUNT] = {};
+    for (size_t w = 0; w < frames.size(); w++) {
+        const elisa_viseme_frame_t &f = frames[w];
+        count[f.viseme]++;
+        std::printf("%7.2f s  %-6s %5.2f\n", w * ELISA_VISEME_WINDOW_MS / 1000.0,
+                    elisa_viseme_name(static_cast<elisa_viseme_t>(f.viseme)),
+                    f.level / static_cast<double>(ELISA_VISEME_LEVEL_ONE));
+    }
+    std::printf("windows=%zu", frames.size());
+    for (int v = 0; v < ELISA_VISEME_COUNT; v++) {
+        std::printf(" %s=%d", elisa_viseme_name(static_cast<elisa_viseme_t>(v)), count[v]);
+    }
+    std::printf("\n");
+    print_timing(ns);
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    if (argc == 1) return bench_synthetic();
+    if (argc == 2) return bench_wav(argv[1]);
+    std::fprintf(stderr, "usage: %s [speech.wav]\n", argv[0]);
+    return 2;
+}
@@ -25,6 +25,7 @@ import struct
 import sys
 import time
 import wave
+import zlib
 
 SAMPLE_RATE = 16000
 CHANNELS = 1
@@ -34,6 +35,17 @@ SAMPLES_PER_RECORD = int(SAMPLE_RATE * RECORD_DURATION)
 
 DATA_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'data')
 
+# Serial framing (firmware/main/elisa_frame.h)
+FRAME_SYNC = b'\xa5\x5a'
+FRAME_HEADER_SIZE = 10
+FRAME_CRC_SIZE = 4
+FRAME_MAX_PAYLOAD = 4096
+FRAME_PCM16 = 0x01
+FRAME_STATUS = 0x02
+FRAME_RICE = 0x03
+RICE_VERBATIM = 0xFF
+DEFAULT_BAUD = 115200  # ignored by the BOX-3's USB-Serial-JTAG console
+
 # Prompts for guided recording sessions
 POSITIVE_PROMPTS = [
     "Say 'Hi Roo' in your normal voice",
@@ -80,18 +92,101 @@ def find_box3_port():
     return None
 
 
-def record_from_box3(port, duration=RECORD_DURATION):
+class FrameReader:
+    """Extracts CRC-checked frames from the serial byte stream.
+
+    Anything between frames (ESP_LOG lines, partial frames from before
+    RECORD) is skipped. Tracks sequence gaps and CRC failures.
+    """
+
+    def __init__(self):
+        self.buf = bytearray()
+        self.next_seq = None
+        self.lost_frames = 0
+        self.bad_frames = 0
+
+    def feed(self, data):
+        """Add bytes; yield (type, seq, payload) for each valid frame."""
+        self.buf += data
+        while True:
+            start = self.buf.find(FRAME_SYNC)
+            if start < 0:
+                del self.buf[:-1]  # keep a trailing sync byte
+                return
+            del self.buf[:start]
+            if len(self.buf) < FRAME_HEADER_SIZE:
+                return
+            ftype, _flags, seq, length = struct.unpack_from('<BBIH', self.buf, 2)
+            if length > FRAME_MAX_PAYLOAD:
+                del self.buf[:1]
+                continue
+            end = FRAME_HEADER_SIZE + length + FRAME_CRC_SIZE
+            if len(self.buf) < end:
+                return
+            (crc,) = struct.unpack_from('<I', self.buf, FRAME_HEADER_SIZE + length)
+            if zlib.crc32(bytes(self.buf[2:FRAME_HEADER_SIZE + length])) != crc:
+                self.bad_frames += 1
+                del self.buf[:1]
+                continue
+            payload = bytes(self.buf[FRAME_HEADER_SIZE:FRAME_HEADER_SIZE + length])
+            del self.buf[:end]
+            if self.next_seq is not None and seq != self.next_seq:
+                gap = (seq - self.next_seq) & 0xFFFFFFFF
+                if gap < 0x80000000:  # otherwise a repeat / device restart
+                    self.lost_frames += gap
+            self.next_seq = (seq + 1) & 0xFFFFFFFF
+            yield ftype, seq, payload
+
+
+def parse_status(payload):
+    """Decode an ELISA_FRAME_STATUS payload."""
+    frames, samples, dropped, high_water, audio_bytes, final = struct.unpack_from('<IIIIIB', payload)
+    return {'frames_sent': frames, 'samples_sent': samples, 'samples_dropped': dropped,
+            'ring_high_water': high_water, 'audio_bytes_sent': audio_bytes, 'final': bool(final)}
+
+
+def rice_decode(block):
+    """Decode an ELISA_FRAME_RICE payload (firmware/main/elisa_rice.h) to PCM bytes."""
+    n, order, k = struct.unpack_from('<HBB', block)
+    if k == RICE_VERBATIM:
+        return bytes(block[4:4 + 2 * n])
+
+    x = list(struct.unpack_from(f'<{order}h', block, 4))
+    bits = int.from_bytes(block[4 + 2 * order:], 'big')
+    pos = (len(block) - 4 - 2 * order) * 8  # bits left to read, MSB first
+    for _ in range(n - order):
+        q = 0
+        while (bits >> (pos - 1)) & 1:
+            q += 1
+            pos -= 1
+        pos -= 1 + k
+        u = (q << k) | ((bits >> pos) & ((1 << k) - 1))
+        r = (u >> 1) ^ -(u & 1)
+        if order == 0:
+            v = r
+        elif order == 1:
+            v = r + x[-1]
+        elif order == 2:
+            v = r + 2 * x[-1] - x[-2]
+        else:
+            v = r + 3 * x[-1] - 3 * x[-2] + x[-3]
+        x.append(v)
+    return struct.pack(f'<{n}h', *x)
+
+
+def record_from_box3(port, duration=RECORD_DURATION, baud=DEFAULT_BAUD):
     """Record audio from BOX-3 via serial RECORD command.
 
-    Sends 'RECORD\\n' to put the device in recording mode.
-    Device streams raw 16-bit LE PCM at 16kHz over serial.
-    Sends 'STOP\\n' when done.
+    Sends 'RECORD\\n' to put the device in recording mode. The device
+    streams 16kHz audio in framed, CRC-checked, losslessly compressed
+    chunks plus periodic status frames with its drop counters. Sends
+    'STOP\\n' when done and waits for the final status frame.
 
     Returns: bytes of raw PCM data
     """
     import serial
 
-    ser = serial.Serial(port, 115200, timeout=1)
+    ser = serial.Serial(port, baud, timeout=0.2)
     time.sleep(0.1)  # let serial settle
 
     # Flush any pending data
@@ -99,26 +194,40 @@ def record_from_box3(port, duration=RECORD_DURATION):
 
     # Enter recording mode
     ser.write(b'RECORD\n')
-    time.sleep(0.05)
 
-    # Read PCM samples
+    reader = FrameReader()
     total_bytes = int(SAMPLE_RATE * duration * SAMPLE_WIDTH)
-    audio_data = b''
+    audio_data = bytearray()
+    status = None
+    stop_sent = False
     deadline = time.time() + duration + 2.0  # extra 2s timeout buffer
 
-    while len(audio_data) < total_bytes and time.time() < deadline:
-        chunk = ser.read(min(4096, total_bytes - len(audio_data)))
-        if chunk:
-            audio_data += chunk
-
-    # Stop recording
-    ser.write(b'STOP\n')
+    while time.time() < deadline:
+        if not stop_sent and len(audio_data) >= total_bytes:
+            ser.write(b'STOP\n')
+            stop_sent = True
+            deadline = time.time() + 1.0  # wait for the final status frame
+        for ftype, _seq, payload in reader.feed(ser.read(4096)):
+            if ftype == FRAME_RICE:
+                audio_data += rice_decode(payload)
+            elif ftype == FRAME_PCM16:
+                audio_data += payload
+            elif ftype == FRAME_STATUS:
+                status = parse_status(payload)
+        if status and status['final']:
+            break
+
+    if not stop_sent:
+        ser.write(b'STOP\n')
     ser.close()
 
-    # Truncate to exact duration
-    audio_data = audio_data[:total_bytes]
+    dropped = status['samples_dropped'] if status else 0
+    if dropped or reader.lost_frames or reader.bad_frames:
+        print(f"  WARNING: device dropped {dropped} samples, "
+              f"{reader.lost_frames} frames lost, {reader.bad_frames} bad CRCs")
 
-    return audio_data
+    # Truncate to exact duration
+    return bytes(audio_data[:total_bytes])
 
 
 def record_from_laptop(duration=RECORD_DURATION):
@@ -259,6 +368,8 @@ def main():
                         help='Use laptop microphone instead of BOX-3')
     parser.add_argument('--duration', type=float, default=RECORD_DURATION,
                         help=f'Recording duration in seconds (default: {RECORD_DURATION})')
+    parser.add_argument('--baud', type=int, default=DEFAULT_BAUD,
+                        help='Baud rate for a UART console (USB-Serial-JTAG ignores it)')
     args = parser.parse_args()
 
     duration = args.duration
@@ -272,7 +383,7 @@ def main():
             print("ERROR: No BOX-3 found. Connect via USB-C or use --port or --laptop")
             sys.exit(1)
         print(f"Using BOX-3 on {port}")
-        record_fn = lambda: record_from_box3(port, duration)
+        record_fn = lambda: record_from_box3(port, duration, args.baud)
 
     print(f"Sample rate: {SAMPLE_RATE} Hz, Duration: {RECORD_DURATION}s")
     print(f"Data directory: {DATA_DIR}")